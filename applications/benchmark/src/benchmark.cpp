@@ -0,0 +1,172 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct benchmark_suite_t
+{
+	const char* name;
+	void (*run)();
+};
+
+/**
+ * All suites in the order they run when no selection is given.
+ */
+static benchmark_suite_t benchmarkSuites[] = {
+		{"syscall", benchmarkSyscall},
+		{"ipc", benchmarkIpc},
+		{"pipe", benchmarkPipe},
+		{"fs-read", benchmarkFilesystemRead},
+		{"spawn", benchmarkSpawn},
+		{"spawn-parallel", benchmarkSpawnParallel},
+		{"font-load", benchmarkFontLoad},
+		{"fs-io", benchmarkFilesystemIo},
+		{"fs-walk", benchmarkFilesystemWalk},
+		{"io-ring", benchmarkIoRing},
+		{"fs-delegate", benchmarkFilesystemDelegate},
+		{"tmpfs", benchmarkTmpfs},
+		{"trace", benchmarkTrace},
+		{"log", benchmarkLog},
+		{"stdio-char", benchmarkStdioChar},
+		{"malloc", benchmarkMalloc},
+		{"ui-dialog", benchmarkUiDialog},
+		{"boot", benchmarkBoot}};
+
+static uint64_t ticksPerMillisecond = 1;
+
+void benchmarkCalibrate()
+{
+	uint64_t startMillis = g_millis();
+	uint64_t startTicks = benchmarkTimestamp();
+	g_sleep(200);
+	uint64_t elapsedMillis = g_millis() - startMillis;
+	uint64_t elapsedTicks = benchmarkTimestamp() - startTicks;
+
+	if(elapsedMillis > 0)
+		ticksPerMillisecond = elapsedTicks / elapsedMillis;
+	if(ticksPerMillisecond == 0)
+		ticksPerMillisecond = 1;
+}
+
+uint64_t benchmarkMicros(uint64_t ticks)
+{
+	return (ticks * 1000) / ticksPerMillisecond;
+}
+
+uint64_t benchmarkThroughput(uint64_t bytes, uint64_t ticks)
+{
+	uint64_t micros = benchmarkMicros(ticks);
+	if(micros == 0)
+		micros = 1;
+	return (bytes * 1000000 / 1024) / micros;
+}
+
+void benchmarkReport(const char* suite, const char* name, uint64_t value, const char* unit)
+{
+	println("%s.%s %llu %s", suite, name, value, unit);
+	klog("benchmark: %s.%s %llu %s", suite, name, value, unit);
+}
+
+uint32_t benchmarkSyscallCount()
+{
+	g_kernquery_task_get_data data;
+	data.id = g_get_tid();
+	if(g_kernquery(G_KERNQUERY_TASK_GET_BY_ID, (uint8_t*) &data) != G_KERNQUERY_STATUS_SUCCESSFUL)
+		return 0;
+	return data.syscall_count;
+}
+
+uint32_t benchmarkResidentMemory()
+{
+	g_kernquery_task_get_data data;
+	data.id = g_get_tid();
+	if(g_kernquery(G_KERNQUERY_TASK_GET_BY_ID, (uint8_t*) &data) != G_KERNQUERY_STATUS_SUCCESSFUL)
+		return 0;
+	return data.memory_used;
+}
+
+/**
+ * Checks whether the suite is contained in the comma-separated selection.
+ */
+static bool benchmarkSelected(const char* selection, const char* suite)
+{
+	if(strcmp(selection, "all") == 0)
+		return true;
+
+	size_t length = strlen(suite);
+	const char* pos = selection;
+	while(*pos)
+	{
+		const char* end = strchr(pos, ',');
+		size_t entryLength = end ? (size_t) (end - pos) : strlen(pos);
+		if(entryLength == length && strncmp(pos, suite, length) == 0)
+			return true;
+		if(!end)
+			break;
+		pos = end + 1;
+	}
+	return false;
+}
+
+/**
+ * Usage: benchmark [--repeat <count>] [<suite>[,<suite>...]|all]
+ *
+ * Each run is framed by "benchmark-begin" and "benchmark-end" lines in the
+ * kernel log and the whole invocation ends with "benchmark-done", so that the
+ * host harness can collect the results from the serial output.
+ */
+int main(int argc, char** argv)
+{
+	// Target process for the spawn benchmark
+	if(argc > 1 && strcmp(argv[1], "--noop") == 0)
+		return 0;
+
+	const char* selection = "all";
+	int repeat = 1;
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+			repeat = atoi(argv[++i]);
+		else
+			selection = argv[i];
+	}
+	if(repeat < 1)
+		repeat = 1;
+
+	benchmarkCalibrate();
+
+	for(int run = 1; run <= repeat; run++)
+	{
+		klog("benchmark-begin run=%i", run);
+		for(auto& suite: benchmarkSuites)
+		{
+			if(benchmarkSelected(selection, suite.name))
+				suite.run();
+		}
+		klog("benchmark-end run=%i", run);
+	}
+	klog("benchmark-done");
+
+	return 0;
+}
@@ -0,0 +1,97 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BENCHMARK__
+#define __BENCHMARK__
+
+#include <ghost.h>
+#include <stdint.h>
+
+/**
+ * Path of this executable, used by benchmarks that spawn processes.
+ */
+#define BENCHMARK_EXECUTABLE "/applications/benchmark.bin"
+
+/**
+ * Reads the timestamp counter.
+ */
+static inline uint64_t benchmarkTimestamp()
+{
+	uint32_t low;
+	uint32_t high;
+	asm volatile("rdtsc"
+				 : "=a"(low), "=d"(high));
+	return ((uint64_t) high << 32) | low;
+}
+
+/**
+ * Measures the timestamp counter frequency against the system clock.
+ * Must be called once before converting timestamps.
+ */
+void benchmarkCalibrate();
+
+/**
+ * Converts a timestamp difference to microseconds.
+ */
+uint64_t benchmarkMicros(uint64_t ticks);
+
+/**
+ * Calculates a throughput in KiB per second.
+ */
+uint64_t benchmarkThroughput(uint64_t bytes, uint64_t ticks);
+
+/**
+ * Prints a single result line in the format "<suite>.<name> <value> <unit>".
+ */
+void benchmarkReport(const char* suite, const char* name, uint64_t value, const char* unit);
+
+/**
+ * Returns the number of system calls the current task has performed so far.
+ */
+uint32_t benchmarkSyscallCount();
+
+/**
+ * Returns the resident memory of the current process in bytes.
+ */
+uint32_t benchmarkResidentMemory();
+
+/**
+ * Benchmark suites.
+ */
+void benchmarkFilesystemRead();
+void benchmarkSpawn();
+void benchmarkFontLoad();
+void benchmarkFilesystemIo();
+void benchmarkIoRing();
+void benchmarkFilesystemDelegate();
+void benchmarkTmpfs();
+void benchmarkTrace();
+void benchmarkLog();
+void benchmarkBoot();
+void benchmarkSyscall();
+void benchmarkIpc();
+void benchmarkPipe();
+void benchmarkFilesystemWalk();
+void benchmarkSpawnParallel();
+void benchmarkStdioChar();
+void benchmarkMalloc();
+void benchmarkUiDialog();
+
+#endif
@@ -0,0 +1,58 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Reports the boot phases that the kernel has recorded. Phases that ran on
+ * several processors are suffixed with the processor.
+ */
+void benchmarkBoot()
+{
+	g_kernquery_boot_count_data count;
+	if(g_kernquery(G_KERNQUERY_BOOT_COUNT, (uint8_t*) &count) != G_KERNQUERY_STATUS_SUCCESSFUL)
+	{
+		klog("benchmark: boot phases not available");
+		return;
+	}
+	if(!count.finished)
+		klog("benchmark: boot is not finished yet, phases are incomplete");
+
+	benchmarkReport("boot", "firmware", count.kernel_entry, "us");
+	benchmarkReport("boot", "total", count.total, "us");
+
+	for(uint32_t i = 0; i < count.count; i++)
+	{
+		g_kernquery_boot_get_data phase;
+		phase.position = i;
+		if(g_kernquery(G_KERNQUERY_BOOT_GET, (uint8_t*) &phase) != G_KERNQUERY_STATUS_SUCCESSFUL || !phase.finished)
+			continue;
+
+		char name[G_KERNQUERY_BOOT_PHASE_NAME_MAX + 16];
+		if(strcmp(phase.name, "ap") == 0)
+			snprintf(name, sizeof(name), "%s%u", phase.name, phase.processor);
+		else
+			snprintf(name, sizeof(name), "%s", phase.name);
+		benchmarkReport("boot", name, phase.duration, "us");
+	}
+}
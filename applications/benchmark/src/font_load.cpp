@@ -0,0 +1,132 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define FONT_LOAD_PATH "/system/graphics/fonts/default.ttf"
+#define FONT_LOAD_ITERATIONS 50
+
+/**
+ * Touches the font data the way a parser would. With "full" every byte is read,
+ * otherwise only the table directory and one byte per page, similar to what
+ * freetype accesses when creating a face.
+ */
+static uint32_t fontLoadTouch(uint8_t* data, uint32_t length, bool full)
+{
+	uint32_t sum = 0;
+	if(full)
+	{
+		for(uint32_t i = 0; i < length; i++)
+			sum += data[i];
+	}
+	else
+	{
+		for(uint32_t i = 0; i < length && i < 512; i++)
+			sum += data[i];
+		for(uint32_t i = 0; i < length; i += 4096)
+			sum += data[i];
+	}
+	return sum;
+}
+
+/**
+ * Loads the font like libfont did before: read into a buffer, then copy.
+ */
+static uint64_t fontLoadRead(bool full)
+{
+	uint64_t start = benchmarkTimestamp();
+
+	FILE* file = fopen(FONT_LOAD_PATH, "r");
+	if(!file)
+		return 0;
+
+	int64_t length = g_length(fileno(file));
+	uint8_t* content = (uint8_t*) malloc(length);
+	uint32_t remain = length;
+	while(remain)
+	{
+		size_t read = fread(&content[length - remain], 1, remain, file);
+		if(read <= 0)
+			break;
+		remain -= read;
+	}
+	fclose(file);
+
+	uint8_t* data = (uint8_t*) malloc(length);
+	memcpy(data, content, length);
+	free(content);
+
+	fontLoadTouch(data, length, full);
+	free(data);
+
+	return benchmarkTimestamp() - start;
+}
+
+/**
+ * Loads the font through a private read-only mapping.
+ */
+static uint64_t fontLoadMapped(bool full)
+{
+	uint64_t start = benchmarkTimestamp();
+
+	g_fd fd = g_open(FONT_LOAD_PATH);
+	if(fd == G_FD_NONE)
+		return 0;
+
+	int64_t length = g_length(fd);
+	uint8_t* data = (uint8_t*) mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	g_close(fd);
+	if(data == MAP_FAILED)
+		return 0;
+
+	fontLoadTouch(data, length, full);
+	munmap(data, length);
+
+	return benchmarkTimestamp() - start;
+}
+
+static void fontLoadRun(const char* name, uint64_t (*load)(bool), bool full)
+{
+	uint64_t total = 0;
+	for(int i = 0; i < FONT_LOAD_ITERATIONS; i++)
+	{
+		uint64_t ticks = load(full);
+		if(ticks == 0)
+		{
+			fprintf(stderr, "failed to load %s\n", FONT_LOAD_PATH);
+			return;
+		}
+		total += ticks;
+	}
+	benchmarkReport("font-load", name, benchmarkMicros(total / FONT_LOAD_ITERATIONS), "us");
+}
+
+void benchmarkFontLoad()
+{
+	fontLoadRun("fread-full", fontLoadRead, true);
+	fontLoadRun("mmap-full", fontLoadMapped, true);
+	fontLoadRun("fread-sparse", fontLoadRead, false);
+	fontLoadRun("mmap-sparse", fontLoadMapped, false);
+}
@@ -0,0 +1,139 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FS_DELEGATE_SERVER "/applications/memfs.bin"
+#define FS_DELEGATE_SERVER_ARGS "benchmark 1 65536"
+#define FS_DELEGATE_MEMFS_FILE "/mount/benchmark/file-0"
+#define FS_DELEGATE_RAMDISK_FILE "/benchmark-delegate.tmp"
+#define FS_DELEGATE_FILE_SIZE 65536
+#define FS_DELEGATE_SMALL_SIZE 64
+#define FS_DELEGATE_OPEN_COUNT 500
+#define FS_DELEGATE_SMALL_COUNT 2000
+#define FS_DELEGATE_LARGE_COUNT 50
+#define FS_DELEGATE_STARTUP_TIMEOUT 2000
+
+static void fsDelegateReport(const char* backend, const char* operation, uint64_t ticks, uint32_t count)
+{
+	char key[64];
+	snprintf(key, sizeof(key), "%s-%s", backend, operation);
+	benchmarkReport("fs-delegate", key, benchmarkMicros(ticks * 1000 / count), "ns/op");
+}
+
+/**
+ * Measures the same operations on a file of either backend.
+ */
+static void fsDelegateMeasure(const char* backend, const char* path, uint8_t* buffer)
+{
+	uint64_t start = benchmarkTimestamp();
+	for(int i = 0; i < FS_DELEGATE_OPEN_COUNT; i++)
+		g_close(g_open_f(path, G_FILE_FLAG_MODE_READ));
+	fsDelegateReport(backend, "open-close", benchmarkTimestamp() - start, FS_DELEGATE_OPEN_COUNT);
+
+	g_fd fd = g_open_f(path, G_FILE_FLAG_MODE_READ | G_FILE_FLAG_MODE_WRITE);
+	if(fd == G_FD_NONE)
+	{
+		fprintf(stderr, "failed to open %s\n", path);
+		return;
+	}
+
+	start = benchmarkTimestamp();
+	for(int i = 0; i < FS_DELEGATE_SMALL_COUNT; i++)
+		g_read_at(fd, buffer, FS_DELEGATE_SMALL_SIZE, (i * FS_DELEGATE_SMALL_SIZE) % FS_DELEGATE_FILE_SIZE);
+	fsDelegateReport(backend, "read-64", benchmarkTimestamp() - start, FS_DELEGATE_SMALL_COUNT);
+
+	start = benchmarkTimestamp();
+	for(int i = 0; i < FS_DELEGATE_SMALL_COUNT; i++)
+		g_write_at(fd, buffer, FS_DELEGATE_SMALL_SIZE, (i * FS_DELEGATE_SMALL_SIZE) % FS_DELEGATE_FILE_SIZE);
+	fsDelegateReport(backend, "write-64", benchmarkTimestamp() - start, FS_DELEGATE_SMALL_COUNT);
+
+	start = benchmarkTimestamp();
+	for(int i = 0; i < FS_DELEGATE_LARGE_COUNT; i++)
+		g_read_at(fd, buffer, FS_DELEGATE_FILE_SIZE, 0);
+	uint64_t ticks = benchmarkTimestamp() - start;
+	fsDelegateReport(backend, "read-64k", ticks, FS_DELEGATE_LARGE_COUNT);
+
+	char key[64];
+	snprintf(key, sizeof(key), "%s-read-64k-throughput", backend);
+	benchmarkReport("fs-delegate", key, benchmarkThroughput((uint64_t) FS_DELEGATE_FILE_SIZE * FS_DELEGATE_LARGE_COUNT, ticks), "KiB/s");
+
+	g_close(fd);
+}
+
+/**
+ * Starts the in-memory file system server and waits until its file is available.
+ */
+static bool fsDelegateStartServer(g_pid* outPid)
+{
+	g_spawn_status status = g_spawn_p(FS_DELEGATE_SERVER, FS_DELEGATE_SERVER_ARGS, "/", G_SECURITY_LEVEL_DRIVER, outPid);
+	if(status != G_SPAWN_STATUS_SUCCESSFUL)
+	{
+		fprintf(stderr, "failed to spawn %s (status %i)\n", FS_DELEGATE_SERVER, status);
+		return false;
+	}
+
+	uint64_t deadline = g_millis() + FS_DELEGATE_STARTUP_TIMEOUT;
+	while(g_millis() < deadline)
+	{
+		g_fd fd = g_open(FS_DELEGATE_MEMFS_FILE);
+		if(fd != G_FD_NONE)
+		{
+			g_close(fd);
+			return true;
+		}
+		g_sleep(10);
+	}
+
+	fprintf(stderr, "%s did not mount in time\n", FS_DELEGATE_SERVER);
+	g_kill(*outPid);
+	return false;
+}
+
+void benchmarkFilesystemDelegate()
+{
+	uint8_t* buffer = (uint8_t*) malloc(FS_DELEGATE_FILE_SIZE);
+	memset(buffer, 'x', FS_DELEGATE_FILE_SIZE);
+
+	g_fd fd = g_open_f(FS_DELEGATE_RAMDISK_FILE, G_FILE_FLAG_MODE_WRITE | G_FILE_FLAG_MODE_CREATE | G_FILE_FLAG_MODE_TRUNCATE);
+	if(fd == G_FD_NONE)
+	{
+		fprintf(stderr, "failed to create %s\n", FS_DELEGATE_RAMDISK_FILE);
+		free(buffer);
+		return;
+	}
+	g_write(fd, buffer, FS_DELEGATE_FILE_SIZE);
+	g_close(fd);
+
+	g_pid server;
+	if(fsDelegateStartServer(&server))
+	{
+		fsDelegateMeasure("ramdisk", FS_DELEGATE_RAMDISK_FILE, buffer);
+		fsDelegateMeasure("memfs", FS_DELEGATE_MEMFS_FILE, buffer);
+		g_kill(server);
+	}
+
+	g_unlink(FS_DELEGATE_RAMDISK_FILE);
+	free(buffer);
+}
@@ -0,0 +1,202 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FS_IO_FILE "/benchmark-io.tmp"
+#define FS_IO_FILE_SIZE (1024 * 1024)
+#define FS_IO_RANDOM_COUNT 4096
+#define FS_IO_RECORD_SEGMENTS 8
+#define FS_IO_SEGMENT_SIZE 512
+#define FS_IO_RECORD_SIZE (FS_IO_RECORD_SEGMENTS * FS_IO_SEGMENT_SIZE)
+#define FS_IO_RECORD_COUNT (FS_IO_FILE_SIZE / FS_IO_RECORD_SIZE)
+
+/**
+ * Counts system calls and ticks of a measured section. The query for the
+ * syscall counter itself is subtracted.
+ */
+struct fs_io_measurement
+{
+	uint32_t syscalls;
+	uint64_t start;
+	uint64_t ticks;
+};
+
+static void fsIoBegin(fs_io_measurement* m)
+{
+	m->syscalls = benchmarkSyscallCount();
+	m->start = benchmarkTimestamp();
+}
+
+static void fsIoEnd(fs_io_measurement* m)
+{
+	m->ticks = benchmarkTimestamp() - m->start;
+	m->syscalls = benchmarkSyscallCount() - m->syscalls - 1;
+}
+
+static void fsIoReport(const char* name, fs_io_measurement* m, uint32_t operations, uint64_t bytes)
+{
+	char key[64];
+
+	snprintf(key, sizeof(key), "%s-time", name);
+	benchmarkReport("fs-io", key, benchmarkMicros(m->ticks * 1000 / operations), "ns/op");
+
+	snprintf(key, sizeof(key), "%s-syscalls", name);
+	benchmarkReport("fs-io", key, m->syscalls / operations, "calls/op");
+
+	if(bytes)
+	{
+		snprintf(key, sizeof(key), "%s-throughput", name);
+		benchmarkReport("fs-io", key, benchmarkThroughput(bytes, m->ticks), "KiB/s");
+	}
+}
+
+/**
+ * Writes each record with one call per segment.
+ */
+static void fsIoWriteSegments(g_fd fd, uint8_t* segments)
+{
+	g_seek(fd, 0, G_FS_SEEK_SET);
+	for(int r = 0; r < FS_IO_RECORD_COUNT; r++)
+	{
+		for(int s = 0; s < FS_IO_RECORD_SEGMENTS; s++)
+			g_write(fd, &segments[s * FS_IO_SEGMENT_SIZE], FS_IO_SEGMENT_SIZE);
+	}
+}
+
+/**
+ * Writes each record with a single vectored call.
+ */
+static void fsIoWriteVector(g_fd fd, g_fs_iovec* vector)
+{
+	g_seek(fd, 0, G_FS_SEEK_SET);
+	for(int r = 0; r < FS_IO_RECORD_COUNT; r++)
+		g_write_vector(fd, vector, FS_IO_RECORD_SEGMENTS);
+}
+
+/**
+ * Reads each record into its segments with one call per segment.
+ */
+static void fsIoReadSegments(g_fd fd, uint8_t* segments)
+{
+	g_seek(fd, 0, G_FS_SEEK_SET);
+	for(int r = 0; r < FS_IO_RECORD_COUNT; r++)
+	{
+		for(int s = 0; s < FS_IO_RECORD_SEGMENTS; s++)
+			g_read(fd, &segments[s * FS_IO_SEGMENT_SIZE], FS_IO_SEGMENT_SIZE);
+	}
+}
+
+/**
+ * Reads each record into its segments with a single vectored call.
+ */
+static void fsIoReadVector(g_fd fd, g_fs_iovec* vector)
+{
+	g_seek(fd, 0, G_FS_SEEK_SET);
+	for(int r = 0; r < FS_IO_RECORD_COUNT; r++)
+		g_read_vector(fd, vector, FS_IO_RECORD_SEGMENTS);
+}
+
+/**
+ * Reads segments at pseudo-random offsets, either by seeking before each read
+ * or with a single positional read.
+ */
+static void fsIoReadRandom(g_fd fd, uint8_t* buffer, bool positional)
+{
+	srand(1);
+	for(int i = 0; i < FS_IO_RANDOM_COUNT; i++)
+	{
+		int64_t offset = (rand() % (FS_IO_FILE_SIZE / FS_IO_SEGMENT_SIZE)) * FS_IO_SEGMENT_SIZE;
+		if(positional)
+		{
+			g_read_at(fd, buffer, FS_IO_SEGMENT_SIZE, offset);
+		}
+		else
+		{
+			g_seek(fd, offset, G_FS_SEEK_SET);
+			g_read(fd, buffer, FS_IO_SEGMENT_SIZE);
+		}
+	}
+}
+
+void benchmarkFilesystemIo()
+{
+	uint8_t* segments = (uint8_t*) malloc(FS_IO_RECORD_SIZE);
+	for(uint32_t i = 0; i < FS_IO_RECORD_SIZE; i++)
+		segments[i] = i;
+
+	g_fs_iovec vector[FS_IO_RECORD_SEGMENTS];
+	for(int s = 0; s < FS_IO_RECORD_SEGMENTS; s++)
+	{
+		vector[s].base = &segments[s * FS_IO_SEGMENT_SIZE];
+		vector[s].length = FS_IO_SEGMENT_SIZE;
+	}
+
+	g_fd fd = g_open_f(FS_IO_FILE, G_FILE_FLAG_MODE_READ | G_FILE_FLAG_MODE_WRITE | G_FILE_FLAG_MODE_CREATE | G_FILE_FLAG_MODE_TRUNCATE);
+	if(fd == G_FD_NONE)
+	{
+		fprintf(stderr, "failed to create %s\n", FS_IO_FILE);
+		free(segments);
+		return;
+	}
+
+	fs_io_measurement m;
+
+	// the first pass allocates the file content, measure on the second
+	fsIoWriteSegments(fd, segments);
+
+	fsIoBegin(&m);
+	fsIoWriteSegments(fd, segments);
+	fsIoEnd(&m);
+	fsIoReport("write-segments", &m, FS_IO_RECORD_COUNT, FS_IO_FILE_SIZE);
+
+	fsIoBegin(&m);
+	fsIoWriteVector(fd, vector);
+	fsIoEnd(&m);
+	fsIoReport("writev", &m, FS_IO_RECORD_COUNT, FS_IO_FILE_SIZE);
+
+	fsIoBegin(&m);
+	fsIoReadSegments(fd, segments);
+	fsIoEnd(&m);
+	fsIoReport("read-segments", &m, FS_IO_RECORD_COUNT, FS_IO_FILE_SIZE);
+
+	fsIoBegin(&m);
+	fsIoReadVector(fd, vector);
+	fsIoEnd(&m);
+	fsIoReport("readv", &m, FS_IO_RECORD_COUNT, FS_IO_FILE_SIZE);
+
+	fsIoBegin(&m);
+	fsIoReadRandom(fd, segments, false);
+	fsIoEnd(&m);
+	fsIoReport("seek-read", &m, FS_IO_RANDOM_COUNT, 0);
+
+	fsIoBegin(&m);
+	fsIoReadRandom(fd, segments, true);
+	fsIoEnd(&m);
+	fsIoReport("pread", &m, FS_IO_RANDOM_COUNT, 0);
+
+	g_close(fd);
+	g_unlink(FS_IO_FILE);
+	free(segments);
+}
@@ -0,0 +1,138 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FS_READ_FILE "/benchmark-read.tmp"
+#define FS_READ_FILE_SIZE (4 * 1024 * 1024)
+#define FS_READ_RANDOM_COUNT 1024
+
+/**
+ * Writes the benchmark file. Writing drops cached pages of the file, so the
+ * first read afterwards is served from the underlying file system.
+ */
+static bool fsReadPrepare(uint8_t* buffer, uint32_t bufferSize)
+{
+	g_fd fd = g_open_f(FS_READ_FILE, G_FILE_FLAG_MODE_WRITE | G_FILE_FLAG_MODE_CREATE | G_FILE_FLAG_MODE_TRUNCATE);
+	if(fd == G_FD_NONE)
+	{
+		fprintf(stderr, "failed to create %s\n", FS_READ_FILE);
+		return false;
+	}
+
+	for(uint32_t i = 0; i < bufferSize; i++)
+		buffer[i] = i;
+
+	for(uint32_t written = 0; written < FS_READ_FILE_SIZE;)
+	{
+		int32_t wrote = g_write(fd, buffer, bufferSize);
+		if(wrote <= 0)
+		{
+			fprintf(stderr, "failed to write %s\n", FS_READ_FILE);
+			g_close(fd);
+			return false;
+		}
+		written += wrote;
+	}
+
+	g_close(fd);
+	return true;
+}
+
+/**
+ * Reads the whole file sequentially in chunks of the given size.
+ *
+ * @return the elapsed ticks
+ */
+static uint64_t fsReadSequential(uint8_t* buffer, uint32_t chunkSize)
+{
+	g_fd fd = g_open(FS_READ_FILE);
+	if(fd == G_FD_NONE)
+		return 0;
+
+	uint64_t start = benchmarkTimestamp();
+	while(g_read(fd, buffer, chunkSize) > 0)
+		;
+	uint64_t ticks = benchmarkTimestamp() - start;
+
+	g_close(fd);
+	return ticks;
+}
+
+/**
+ * Reads pages at pseudo-random offsets in the file.
+ *
+ * @return the elapsed ticks
+ */
+static uint64_t fsReadRandom(uint8_t* buffer)
+{
+	g_fd fd = g_open(FS_READ_FILE);
+	if(fd == G_FD_NONE)
+		return 0;
+
+	srand(1);
+	uint64_t start = benchmarkTimestamp();
+	for(int i = 0; i < FS_READ_RANDOM_COUNT; i++)
+	{
+		int64_t offset = (rand() % (FS_READ_FILE_SIZE / 4096)) * 4096;
+		g_seek(fd, offset, G_FS_SEEK_SET);
+		g_read(fd, buffer, 4096);
+	}
+	uint64_t ticks = benchmarkTimestamp() - start;
+
+	g_close(fd);
+	return ticks;
+}
+
+void benchmarkFilesystemRead()
+{
+	const uint32_t bufferSize = 64 * 1024;
+	uint8_t* buffer = (uint8_t*) malloc(bufferSize);
+
+	if(fsReadPrepare(buffer, bufferSize))
+	{
+		uint64_t cold = fsReadSequential(buffer, 4096);
+		benchmarkReport("fs-read", "sequential-4k-cold", benchmarkThroughput(FS_READ_FILE_SIZE, cold), "KiB/s");
+
+		uint64_t warm = fsReadSequential(buffer, 4096);
+		benchmarkReport("fs-read", "sequential-4k-warm", benchmarkThroughput(FS_READ_FILE_SIZE, warm), "KiB/s");
+
+		uint64_t small = fsReadSequential(buffer, 128);
+		benchmarkReport("fs-read", "sequential-128-warm", benchmarkThroughput(FS_READ_FILE_SIZE, small), "KiB/s");
+
+		uint64_t large = fsReadSequential(buffer, bufferSize);
+		benchmarkReport("fs-read", "sequential-64k-warm", benchmarkThroughput(FS_READ_FILE_SIZE, large), "KiB/s");
+
+		uint64_t random = fsReadRandom(buffer);
+		benchmarkReport("fs-read", "random-4k-warm", benchmarkMicros(random) / FS_READ_RANDOM_COUNT, "us/op");
+
+		// Rewriting invalidates, random access does not trigger readahead
+		fsReadPrepare(buffer, bufferSize);
+		uint64_t randomCold = fsReadRandom(buffer);
+		benchmarkReport("fs-read", "random-4k-cold", benchmarkMicros(randomCold) / FS_READ_RANDOM_COUNT, "us/op");
+	}
+
+	g_unlink(FS_READ_FILE);
+	free(buffer);
+}
@@ -0,0 +1,84 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.hpp"
+
+#include <stdio.h>
+
+#define FS_WALK_PATH_MAX 512
+
+static uint32_t fsWalkDirectories;
+static uint32_t fsWalkFiles;
+
+/**
+ * Recursively lists the directory and opens each file in it.
+ */
+static void fsWalk(const char* path)
+{
+	g_fs_directory_iterator* iterator = g_open_directory(path);
+	if(!iterator)
+		return;
+	fsWalkDirectories++;
+
+	g_fs_directory_entry* entry;
+	while((entry = g_read_directory(iterator)) != 0)
+	{
+		char child[FS_WALK_PATH_MAX];
+		snprintf(child, sizeof(child), "%s/%s", path, entry->name);
+
+		if(entry->type == G_FS_NODE_TYPE_FOLDER)
+		{
+			fsWalk(child);
+		}
+		else if(entry->type == G_FS_NODE_TYPE_FILE)
+		{
+			g_fd fd = g_open(child);
+			if(fd >= 0)
+			{
+				g_close(fd);
+				fsWalkFiles++;
+			}
+		}
+	}
+	g_close_directory(iterator);
+}
+
+/**
+ * Walks the system and application trees the way a file browser or a shell
+ * completion would. The first walk populates the virtual filesystem, the
+ * second one only hits nodes that are already known.
+ */
+void benchmarkFilesystemWalk()
+{
+	for(int pass = 0; pass < 2; pass++)
+	{
+		fsWalkDirectories = 0;
+		fsWalkFiles = 0;
+
+		uint64_t start = benchmarkTimestamp();
+		fsWalk("/system");
+		fsWalk("/applications");
+		uint64_t elapsed = benchmarkTimestamp() - start;
+
+		benchmarkReport("fs-walk", pass == 0 ? "cold" : "warm", benchmarkMicros(elapsed), "us");
+	}
+	benchmarkReport("fs-walk", "directories", fsWalkDirectories, "nodes");
+	benchmarkReport("fs-walk", "files", fsWalkFiles, "nodes");
+}
@@ -0,0 +1,194 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define IO_RING_FILE_COUNT 64
+#define IO_RING_FILE_SIZE 2048
+#define IO_RING_THREAD_COUNT 4
+#define IO_RING_ROUNDS 8
+
+/**
+ * Path and read buffer of each file.
+ */
+struct io_ring_file
+{
+	char path[64];
+	uint8_t buffer[IO_RING_FILE_SIZE];
+	g_fd fd;
+};
+
+static io_ring_file* ioRingFiles;
+
+static void ioRingReadBlocking(int first, int count)
+{
+	for(int i = first; i < first + count; i++)
+	{
+		g_fd fd = g_open(ioRingFiles[i].path);
+		g_read(fd, ioRingFiles[i].buffer, IO_RING_FILE_SIZE);
+		g_close(fd);
+	}
+}
+
+static void ioRingReadThread(void* userData)
+{
+	int part = (int) (g_address) userData;
+	int count = IO_RING_FILE_COUNT / IO_RING_THREAD_COUNT;
+	ioRingReadBlocking(part * count, count);
+}
+
+static void ioRingReadThreaded()
+{
+	g_tid threads[IO_RING_THREAD_COUNT];
+	for(int t = 0; t < IO_RING_THREAD_COUNT; t++)
+		threads[t] = g_create_thread_d((void*) &ioRingReadThread, (void*) (g_address) t);
+	for(int t = 0; t < IO_RING_THREAD_COUNT; t++)
+		g_join(threads[t]);
+}
+
+/**
+ * Submits one operation per file and waits for all of them. The user data of
+ * each submission is the index of its file.
+ */
+static bool ioRingBatch(g_io_ring* ring, uint8_t opcode)
+{
+	for(int i = 0; i < IO_RING_FILE_COUNT; i++)
+	{
+		g_io_submission* submission = g_io_ring_get_submission(ring);
+		submission->opcode = opcode;
+		submission->user_data = i;
+		if(opcode == G_IO_OP_OPEN)
+		{
+			submission->buffer = ioRingFiles[i].path;
+			submission->flags = G_FILE_FLAG_MODE_READ;
+		}
+		else
+		{
+			submission->fd = ioRingFiles[i].fd;
+			submission->buffer = ioRingFiles[i].buffer;
+			submission->length = IO_RING_FILE_SIZE;
+			submission->offset = 0;
+		}
+	}
+
+	if(g_io_ring_submit(ring, IO_RING_FILE_COUNT) < IO_RING_FILE_COUNT)
+		return false;
+
+	bool successful = true;
+	g_io_completion* completion;
+	while((completion = g_io_ring_peek_completion(ring)))
+	{
+		if(completion->status != G_IO_STATUS_SUCCESSFUL)
+			successful = false;
+		else if(opcode == G_IO_OP_OPEN)
+			ioRingFiles[completion->user_data].fd = completion->result;
+		g_io_ring_advance_completion(ring);
+	}
+	return successful;
+}
+
+static bool ioRingReadAsync(g_io_ring* ring)
+{
+	return ioRingBatch(ring, G_IO_OP_OPEN) && ioRingBatch(ring, G_IO_OP_READ) && ioRingBatch(ring, G_IO_OP_CLOSE);
+}
+
+static void ioRingReport(const char* name, uint64_t ticks, uint32_t syscalls)
+{
+	char key[64];
+	uint32_t files = IO_RING_FILE_COUNT * IO_RING_ROUNDS;
+
+	snprintf(key, sizeof(key), "%s-time", name);
+	benchmarkReport("io-ring", key, benchmarkMicros(ticks * 1000 / files), "ns/file");
+
+	snprintf(key, sizeof(key), "%s-throughput", name);
+	benchmarkReport("io-ring", key, benchmarkThroughput((uint64_t) files * IO_RING_FILE_SIZE, ticks), "KiB/s");
+
+	if(syscalls)
+	{
+		snprintf(key, sizeof(key), "%s-syscalls", name);
+		benchmarkReport("io-ring", key, syscalls * 100 / files, "calls/100 files");
+	}
+}
+
+void benchmarkIoRing()
+{
+	ioRingFiles = (io_ring_file*) malloc(sizeof(io_ring_file) * IO_RING_FILE_COUNT);
+	memset(ioRingFiles[0].buffer, 0xAB, IO_RING_FILE_SIZE);
+
+	for(int i = 0; i < IO_RING_FILE_COUNT; i++)
+	{
+		snprintf(ioRingFiles[i].path, sizeof(ioRingFiles[i].path), "/benchmark-ring-%i.tmp", i);
+		g_fd fd = g_open_f(ioRingFiles[i].path, G_FILE_FLAG_MODE_WRITE | G_FILE_FLAG_MODE_CREATE | G_FILE_FLAG_MODE_TRUNCATE);
+		if(fd == G_FD_NONE)
+		{
+			fprintf(stderr, "failed to create %s\n", ioRingFiles[i].path);
+			free(ioRingFiles);
+			return;
+		}
+		g_write(fd, ioRingFiles[0].buffer, IO_RING_FILE_SIZE);
+		g_close(fd);
+	}
+
+	g_io_ring ring;
+	if(g_io_ring_create(IO_RING_FILE_COUNT, &ring) != G_IO_RING_STATUS_SUCCESSFUL)
+	{
+		fprintf(stderr, "failed to create io ring\n");
+		free(ioRingFiles);
+		return;
+	}
+
+	// warm up the page cache so that all variants read the same way
+	ioRingReadBlocking(0, IO_RING_FILE_COUNT);
+
+	uint32_t syscalls = benchmarkSyscallCount();
+	uint64_t start = benchmarkTimestamp();
+	for(int r = 0; r < IO_RING_ROUNDS; r++)
+		ioRingReadBlocking(0, IO_RING_FILE_COUNT);
+	uint64_t ticks = benchmarkTimestamp() - start;
+	ioRingReport("blocking", ticks, benchmarkSyscallCount() - syscalls - 1);
+
+	// syscalls of the helper threads are not counted here
+	start = benchmarkTimestamp();
+	for(int r = 0; r < IO_RING_ROUNDS; r++)
+		ioRingReadThreaded();
+	ticks = benchmarkTimestamp() - start;
+	ioRingReport("threads", ticks, 0);
+
+	bool successful = true;
+	syscalls = benchmarkSyscallCount();
+	start = benchmarkTimestamp();
+	for(int r = 0; r < IO_RING_ROUNDS && successful; r++)
+		successful = ioRingReadAsync(&ring);
+	ticks = benchmarkTimestamp() - start;
+	if(successful)
+		ioRingReport("async", ticks, benchmarkSyscallCount() - syscalls - 1);
+	else
+		fprintf(stderr, "io ring operations failed\n");
+
+	g_io_ring_destroy(&ring);
+
+	for(int i = 0; i < IO_RING_FILE_COUNT; i++)
+		g_unlink(ioRingFiles[i].path);
+	free(ioRingFiles);
+}
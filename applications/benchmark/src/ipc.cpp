@@ -0,0 +1,87 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.hpp"
+
+#define IPC_ITERATIONS 10000
+
+static g_tid ipcPartner = G_TID_NONE;
+
+/**
+ * Echoes each message back to its sender, a message starting with zero stops it.
+ */
+static void ipcPartnerThread()
+{
+	uint8_t buffer[sizeof(g_message_header) + 64];
+	for(;;)
+	{
+		if(g_receive_message(buffer, sizeof(buffer)) != G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL)
+			continue;
+
+		g_message_header* header = (g_message_header*) buffer;
+		g_send_message(header->sender, G_MESSAGE_CONTENT(buffer), header->length);
+		if(*G_MESSAGE_CONTENT(buffer) == 0)
+			break;
+	}
+}
+
+/**
+ * Sends messages of the given size to the partner and waits for the echo.
+ *
+ * @return the elapsed ticks for all round trips
+ */
+static uint64_t ipcRoundTrips(uint32_t size)
+{
+	uint8_t message[64] = {1};
+	uint8_t buffer[sizeof(g_message_header) + 64];
+
+	uint64_t start = benchmarkTimestamp();
+	for(int i = 0; i < IPC_ITERATIONS; i++)
+	{
+		g_send_message(ipcPartner, message, size);
+		g_receive_message(buffer, sizeof(buffer));
+	}
+	return benchmarkTimestamp() - start;
+}
+
+/**
+ * Measures message round trips between two threads. Each round trip blocks
+ * both sides once, so it also yields the rate of context switches.
+ */
+void benchmarkIpc()
+{
+	ipcPartner = g_create_thread((void*) ipcPartnerThread);
+
+	uint64_t small = ipcRoundTrips(1);
+	uint64_t large = ipcRoundTrips(64);
+	benchmarkReport("ipc", "round-trip-1", benchmarkMicros(small * 1000 / IPC_ITERATIONS), "ns/op");
+	benchmarkReport("ipc", "round-trip-64", benchmarkMicros(large * 1000 / IPC_ITERATIONS), "ns/op");
+
+	uint64_t micros = benchmarkMicros(small);
+	if(micros == 0)
+		micros = 1;
+	benchmarkReport("ipc", "context-switches", (uint64_t) IPC_ITERATIONS * 2 * 1000000 / micros, "ops/s");
+
+	uint8_t stop = 0;
+	uint8_t buffer[sizeof(g_message_header) + 64];
+	g_send_message(ipcPartner, &stop, sizeof(stop));
+	g_receive_message(buffer, sizeof(buffer));
+	g_join(ipcPartner);
+}
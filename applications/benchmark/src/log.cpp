@@ -0,0 +1,149 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+#define LOG_MESSAGE_ITERATIONS 20000
+#define LOG_SWITCH_ITERATIONS 2000
+
+static volatile bool logSpamming = false;
+static g_tid logPartner = G_TID_NONE;
+
+/**
+ * Measures the cost of a single kernel log call from userspace.
+ */
+static uint64_t logMeasureMessage()
+{
+	uint64_t start = benchmarkTimestamp();
+	for(int i = 0; i < LOG_MESSAGE_ITERATIONS; i++)
+		g_log("benchmark log message");
+	return benchmarkMicros((benchmarkTimestamp() - start) * 1000 / LOG_MESSAGE_ITERATIONS);
+}
+
+/**
+ * Keeps the logger busy to simulate verbose logging.
+ */
+static void logSpamThread()
+{
+	while(logSpamming)
+		g_log("benchmark verbose logging");
+}
+
+/**
+ * Answers each message, a message with the content zero stops it.
+ */
+static void logPartnerThread()
+{
+	uint8_t buffer[sizeof(g_message_header) + 16];
+	for(;;)
+	{
+		if(g_receive_message(buffer, sizeof(buffer)) != G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL)
+			continue;
+
+		g_message_header* header = (g_message_header*) buffer;
+		uint8_t content = *G_MESSAGE_CONTENT(buffer);
+		g_send_message(header->sender, &content, sizeof(content));
+		if(content == 0)
+			break;
+	}
+}
+
+/**
+ * Measures message round trips to the partner thread, each of which requires
+ * two context switches. Reports the average and the worst case.
+ */
+static void logMeasureSwitch(const char* name)
+{
+	uint8_t message = 1;
+	uint8_t buffer[sizeof(g_message_header) + 16];
+	uint64_t total = 0;
+	uint64_t worst = 0;
+
+	for(int i = 0; i < LOG_SWITCH_ITERATIONS; i++)
+	{
+		uint64_t start = benchmarkTimestamp();
+		g_send_message(logPartner, &message, sizeof(message));
+		g_receive_message(buffer, sizeof(buffer));
+		uint64_t elapsed = benchmarkTimestamp() - start;
+
+		total += elapsed;
+		if(elapsed > worst)
+			worst = elapsed;
+	}
+
+	char key[64];
+	snprintf(key, sizeof(key), "switch-%s-avg", name);
+	benchmarkReport("log", key, benchmarkMicros(total * 1000 / LOG_SWITCH_ITERATIONS), "ns/op");
+	snprintf(key, sizeof(key), "switch-%s-max", name);
+	benchmarkReport("log", key, benchmarkMicros(worst), "us");
+}
+
+static void logMeasureSwitchVerbose(const char* name, bool async)
+{
+	g_set_log_async(async);
+	logSpamming = true;
+	g_tid spammer = g_create_thread((void*) logSpamThread);
+
+	logMeasureSwitch(name);
+
+	logSpamming = false;
+	g_join(spammer);
+}
+
+static uint32_t logDroppedCount()
+{
+	g_kernquery_statistics_get_data data;
+	if(g_kernquery(G_KERNQUERY_STATISTICS_GET, (uint8_t*) &data) != G_KERNQUERY_STATUS_SUCCESSFUL)
+		return 0;
+	return data.log_dropped;
+}
+
+void benchmarkLog()
+{
+	uint8_t wasAsync = g_set_log_async(G_LOG_CONFIGURE_KEEP);
+	g_log_level level = g_set_log_level(G_LOG_CONFIGURE_KEEP);
+
+	// Throughput of log calls, printing directly versus queueing
+	g_set_log_async(false);
+	benchmarkReport("log", "message-sync", logMeasureMessage(), "ns/op");
+	g_set_log_async(true);
+	uint32_t dropped = logDroppedCount();
+	benchmarkReport("log", "message-async", logMeasureMessage(), "ns/op");
+	benchmarkReport("log", "message-async-dropped", logDroppedCount() - dropped, "messages");
+
+	// Context switch latency while another thread logs verbosely
+	g_set_log_level(G_LOG_LEVEL_DEBUG);
+	logPartner = g_create_thread((void*) logPartnerThread);
+	logMeasureSwitch("quiet");
+	logMeasureSwitchVerbose("verbose-sync", false);
+	logMeasureSwitchVerbose("verbose-async", true);
+
+	uint8_t stop = 0;
+	uint8_t buffer[sizeof(g_message_header) + 16];
+	g_send_message(logPartner, &stop, sizeof(stop));
+	g_receive_message(buffer, sizeof(buffer));
+	g_join(logPartner);
+
+	g_set_log_level(level);
+	g_set_log_async(wasAsync);
+}
@@ -0,0 +1,201 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define MALLOC_OPERATIONS 200000
+#define MALLOC_SLOTS 256
+#define MALLOC_MAX_THREADS 4
+#define MALLOC_LARGE_SIZE (4 * 1024 * 1024)
+#define MALLOC_FRAGMENT_COUNT 8192
+
+static volatile uint32_t mallocFinished = 0;
+
+/**
+ * Allocates and frees small blocks of random sizes in random order, like
+ * typical UI code does.
+ */
+static void mallocWorker(void* seedPointer)
+{
+	uint32_t seed = (uint32_t) seedPointer;
+	void* slots[MALLOC_SLOTS] = {0};
+
+	for(int i = 0; i < MALLOC_OPERATIONS; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		uint32_t slot = (seed >> 16) % MALLOC_SLOTS;
+		if(slots[slot])
+		{
+			free(slots[slot]);
+			slots[slot] = nullptr;
+		}
+		else
+		{
+			size_t size = 16 + (seed >> 8) % 1024;
+			slots[slot] = malloc(size);
+			*((uint8_t*) slots[slot]) = 1;
+		}
+	}
+
+	for(int i = 0; i < MALLOC_SLOTS; i++)
+		free(slots[i]);
+	__sync_fetch_and_add(&mallocFinished, 1);
+}
+
+/**
+ * Runs the worker on the given number of threads at the same time and reports
+ * the total number of operations per second.
+ */
+static void mallocMeasureThreads(const char* name, uint32_t threads)
+{
+	mallocFinished = 0;
+	g_tid tids[MALLOC_MAX_THREADS];
+
+	uint64_t start = benchmarkTimestamp();
+	for(uint32_t i = 0; i < threads; i++)
+		tids[i] = g_create_thread_d((void*) mallocWorker, (void*) (i + 1));
+	for(uint32_t i = 0; i < threads; i++)
+		g_join(tids[i]);
+	uint64_t elapsed = benchmarkMicros(benchmarkTimestamp() - start);
+
+	if(elapsed == 0)
+		elapsed = 1;
+	benchmarkReport("malloc", name, (uint64_t) threads * MALLOC_OPERATIONS * 1000000 / elapsed, "ops/s");
+}
+
+static void* mallocHandover[MALLOC_SLOTS];
+static volatile uint32_t mallocHandoverCount = 0;
+static volatile uint32_t mallocConsumed = 0;
+
+/**
+ * Frees the blocks that the main thread allocates.
+ */
+static void mallocConsumer()
+{
+	while(mallocConsumed < MALLOC_OPERATIONS)
+	{
+		while(mallocConsumed == mallocHandoverCount)
+			g_yield();
+
+		free(mallocHandover[mallocConsumed % MALLOC_SLOTS]);
+		mallocConsumed++;
+	}
+}
+
+/**
+ * Allocates on one thread and frees on another, so that every free goes to
+ * the arena of another thread.
+ */
+static void mallocMeasureCrossThread()
+{
+	mallocHandoverCount = 0;
+	mallocConsumed = 0;
+	g_tid consumer = g_create_thread((void*) mallocConsumer);
+
+	uint64_t start = benchmarkTimestamp();
+	for(uint32_t i = 0; i < MALLOC_OPERATIONS; i++)
+	{
+		while(i - mallocConsumed >= MALLOC_SLOTS)
+			g_yield();
+		mallocHandover[i % MALLOC_SLOTS] = malloc(64);
+		__sync_synchronize();
+		mallocHandoverCount = i + 1;
+	}
+	g_join(consumer);
+	uint64_t elapsed = benchmarkMicros(benchmarkTimestamp() - start);
+
+	if(elapsed == 0)
+		elapsed = 1;
+	benchmarkReport("malloc", "cross-thread-free", (uint64_t) MALLOC_OPERATIONS * 1000000 / elapsed, "ops/s");
+}
+
+/**
+ * Large blocks must be returned to the system when they are freed.
+ */
+static void mallocMeasureLarge()
+{
+	uint32_t before = benchmarkResidentMemory();
+
+	uint64_t start = benchmarkTimestamp();
+	for(int i = 0; i < 16; i++)
+	{
+		uint8_t* block = (uint8_t*) malloc(MALLOC_LARGE_SIZE);
+		memset(block, i, MALLOC_LARGE_SIZE);
+		free(block);
+	}
+	uint64_t elapsed = benchmarkTimestamp() - start;
+
+	uint32_t after = benchmarkResidentMemory();
+	benchmarkReport("malloc", "large-cycle", benchmarkMicros(elapsed / 16), "us");
+	benchmarkReport("malloc", "large-retained", after > before ? (after - before) / 1024 : 0, "KiB");
+}
+
+/**
+ * Frees every other block of many small allocations and then allocates
+ * blocks that don't fit into the holes. Reports how much more memory is
+ * resident than the live blocks need.
+ */
+static void mallocMeasureFragmentation()
+{
+	static void* blocks[MALLOC_FRAGMENT_COUNT];
+	uint32_t before = benchmarkResidentMemory();
+	uint32_t live = 0;
+
+	for(int i = 0; i < MALLOC_FRAGMENT_COUNT; i++)
+	{
+		size_t size = 32 + (i % 7) * 48;
+		blocks[i] = malloc(size);
+		memset(blocks[i], 0, size);
+		live += size;
+	}
+	for(int i = 0; i < MALLOC_FRAGMENT_COUNT; i += 2)
+	{
+		live -= 32 + (i % 7) * 48;
+		free(blocks[i]);
+		blocks[i] = malloc(512);
+		memset(blocks[i], 0, 512);
+		live += 512;
+	}
+
+	uint32_t after = benchmarkResidentMemory();
+	uint32_t used = after > before ? after - before : 0;
+	benchmarkReport("malloc", "fragmentation-overhead", used > live ? (used - live) / 1024 : 0, "KiB");
+
+	for(int i = 0; i < MALLOC_FRAGMENT_COUNT; i++)
+		free(blocks[i]);
+}
+
+/**
+ * Measures allocation throughput with multiple threads, frees across
+ * threads, whether large blocks are returned to the system and how much
+ * memory fragmentation costs.
+ */
+void benchmarkMalloc()
+{
+	mallocMeasureThreads("threads-1", 1);
+	mallocMeasureThreads("threads-2", 2);
+	mallocMeasureThreads("threads-4", 4);
+	mallocMeasureCrossThread();
+	mallocMeasureLarge();
+	mallocMeasureFragmentation();
+}
@@ -0,0 +1,84 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.hpp"
+
+#include <stdio.h>
+
+#define PIPE_TOTAL (8 * 1024 * 1024)
+#define PIPE_CHUNK_SMALL 64
+#define PIPE_CHUNK_LARGE 4096
+
+static g_fd pipeRead = -1;
+static volatile uint32_t pipeReceived = 0;
+
+/**
+ * Drains the pipe until the writer closes it.
+ */
+static void pipeReaderThread()
+{
+	uint8_t buffer[PIPE_CHUNK_LARGE];
+	for(;;)
+	{
+		int32_t length = g_read(pipeRead, buffer, sizeof(buffer));
+		if(length <= 0)
+			break;
+		pipeReceived += length;
+	}
+}
+
+/**
+ * Writes the total amount through a fresh pipe in chunks of the given size
+ * while a second thread reads it.
+ */
+static void pipeMeasure(const char* name, uint32_t chunk)
+{
+	g_fd pipeWrite;
+	if(g_pipe(&pipeWrite, &pipeRead) != G_FS_PIPE_SUCCESSFUL)
+	{
+		fprintf(stderr, "failed to create pipe\n");
+		return;
+	}
+
+	pipeReceived = 0;
+	g_tid reader = g_create_thread((void*) pipeReaderThread);
+
+	uint8_t buffer[PIPE_CHUNK_LARGE] = {0};
+	uint64_t start = benchmarkTimestamp();
+	for(uint32_t written = 0; written < PIPE_TOTAL;)
+	{
+		int32_t length = g_write(pipeWrite, buffer, chunk);
+		if(length <= 0)
+			break;
+		written += length;
+	}
+	g_close(pipeWrite);
+	g_join(reader);
+	uint64_t elapsed = benchmarkTimestamp() - start;
+	g_close(pipeRead);
+
+	benchmarkReport("pipe", name, benchmarkThroughput(pipeReceived, elapsed), "KiB/s");
+}
+
+void benchmarkPipe()
+{
+	pipeMeasure("throughput-64", PIPE_CHUNK_SMALL);
+	pipeMeasure("throughput-4096", PIPE_CHUNK_LARGE);
+}
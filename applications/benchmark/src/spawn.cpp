@@ -0,0 +1,104 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.hpp"
+
+#include <stdio.h>
+
+#define SPAWN_ITERATIONS 20
+#define SPAWN_PARALLEL 8
+
+/**
+ * Spawns this executable in no-op mode and waits for it to exit.
+ *
+ * @return the elapsed ticks or 0 on failure
+ */
+static uint64_t spawnOnce()
+{
+	uint64_t start = benchmarkTimestamp();
+
+	g_pid pid;
+	g_spawn_status status = g_spawn_p(BENCHMARK_EXECUTABLE, "--noop", "/", G_SECURITY_LEVEL_APPLICATION, &pid);
+	if(status != G_SPAWN_STATUS_SUCCESSFUL)
+	{
+		fprintf(stderr, "failed to spawn %s (status %i)\n", BENCHMARK_EXECUTABLE, status);
+		return 0;
+	}
+	g_join(pid);
+
+	return benchmarkTimestamp() - start;
+}
+
+void benchmarkSpawn()
+{
+	// The first spawn also pays for one-time setup, so it is reported separately
+	uint64_t first = spawnOnce();
+	if(first == 0)
+		return;
+	benchmarkReport("spawn", "first", benchmarkMicros(first), "us");
+
+	uint64_t total = 0;
+	uint64_t minimum = UINT64_MAX;
+	uint64_t maximum = 0;
+	for(int i = 0; i < SPAWN_ITERATIONS; i++)
+	{
+		uint64_t ticks = spawnOnce();
+		if(ticks == 0)
+			return;
+
+		total += ticks;
+		if(ticks < minimum)
+			minimum = ticks;
+		if(ticks > maximum)
+			maximum = ticks;
+	}
+
+	benchmarkReport("spawn", "average", benchmarkMicros(total / SPAWN_ITERATIONS), "us");
+	benchmarkReport("spawn", "minimum", benchmarkMicros(minimum), "us");
+	benchmarkReport("spawn", "maximum", benchmarkMicros(maximum), "us");
+}
+
+/**
+ * Spawns several processes at once before joining any of them, which is what
+ * happens when a shell pipeline or the boot sequence starts programs.
+ */
+void benchmarkSpawnParallel()
+{
+	g_pid pids[SPAWN_PARALLEL];
+	int spawned = 0;
+
+	uint64_t start = benchmarkTimestamp();
+	for(int i = 0; i < SPAWN_PARALLEL; i++)
+	{
+		g_spawn_status status = g_spawn_p(BENCHMARK_EXECUTABLE, "--noop", "/", G_SECURITY_LEVEL_APPLICATION, &pids[spawned]);
+		if(status != G_SPAWN_STATUS_SUCCESSFUL)
+		{
+			fprintf(stderr, "failed to spawn %s (status %i)\n", BENCHMARK_EXECUTABLE, status);
+			break;
+		}
+		spawned++;
+	}
+	for(int i = 0; i < spawned; i++)
+		g_join(pids[i]);
+	uint64_t elapsed = benchmarkTimestamp() - start;
+
+	if(spawned == SPAWN_PARALLEL)
+		benchmarkReport("spawn-parallel", "total", benchmarkMicros(elapsed), "us");
+}
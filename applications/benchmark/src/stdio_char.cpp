@@ -0,0 +1,120 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.hpp"
+
+#include <stdio.h>
+
+#define STDIO_CHAR_FILE "/tmp/benchmark-stdio"
+#define STDIO_CHAR_COUNT (256 * 1024)
+#define STDIO_CHAR_CONTENDED_COUNT (16 * 1024)
+
+static FILE* stdioCharFile = nullptr;
+
+/**
+ * Runs one character loop over the file and reports the time and the number
+ * of system calls per character.
+ */
+static void stdioCharMeasure(const char* name, bool write, bool unlocked)
+{
+	rewind(stdioCharFile);
+	uint32_t syscalls = benchmarkSyscallCount();
+	uint64_t start = benchmarkTimestamp();
+
+	if(unlocked)
+		flockfile(stdioCharFile);
+	for(int i = 0; i < STDIO_CHAR_COUNT; i++)
+	{
+		if(write)
+		{
+			if(unlocked)
+				putc_unlocked('a' + (i % 26), stdioCharFile);
+			else
+				putc('a' + (i % 26), stdioCharFile);
+		}
+		else
+		{
+			if(unlocked)
+				getc_unlocked(stdioCharFile);
+			else
+				getc(stdioCharFile);
+		}
+	}
+	if(unlocked)
+		funlockfile(stdioCharFile);
+	fflush(stdioCharFile);
+
+	uint64_t elapsed = benchmarkTimestamp() - start;
+	syscalls = benchmarkSyscallCount() - syscalls;
+
+	char metric[64];
+	benchmarkReport("stdio-char", name, benchmarkMicros(elapsed * 1000 / STDIO_CHAR_COUNT), "ns/op");
+	snprintf(metric, sizeof(metric), "%s-syscalls", name);
+	benchmarkReport("stdio-char", metric, (uint64_t) syscalls * 1000 / STDIO_CHAR_COUNT, "calls/1000");
+}
+
+/**
+ * Writes characters from a second thread at the same time, so that the lock
+ * is actually contended.
+ */
+static void stdioCharContendedThread()
+{
+	for(int i = 0; i < STDIO_CHAR_CONTENDED_COUNT; i++)
+		putc('b', stdioCharFile);
+}
+
+static void stdioCharMeasureContended()
+{
+	rewind(stdioCharFile);
+	uint64_t start = benchmarkTimestamp();
+
+	g_tid other = g_create_thread((void*) stdioCharContendedThread);
+	for(int i = 0; i < STDIO_CHAR_CONTENDED_COUNT; i++)
+		putc('a', stdioCharFile);
+	g_join(other);
+	fflush(stdioCharFile);
+
+	uint64_t elapsed = benchmarkTimestamp() - start;
+	benchmarkReport("stdio-char", "putc-contended", benchmarkMicros(elapsed * 1000 / (2 * STDIO_CHAR_CONTENDED_COUNT)), "ns/op");
+}
+
+/**
+ * Measures character-at-a-time stdio on a buffered file, where the cost is
+ * dominated by locking the stream for each call.
+ */
+void benchmarkStdioChar()
+{
+	stdioCharFile = fopen(STDIO_CHAR_FILE, "w+");
+	if(!stdioCharFile)
+	{
+		fprintf(stderr, "failed to create %s\n", STDIO_CHAR_FILE);
+		return;
+	}
+
+	stdioCharMeasure("putc", true, false);
+	stdioCharMeasure("putc-unlocked", true, true);
+	stdioCharMeasure("getc", false, false);
+	stdioCharMeasure("getc-unlocked", false, true);
+	stdioCharMeasureContended();
+
+	fclose(stdioCharFile);
+	stdioCharFile = nullptr;
+	g_unlink(STDIO_CHAR_FILE);
+}
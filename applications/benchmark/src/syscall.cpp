@@ -0,0 +1,42 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.hpp"
+
+#define SYSCALL_ITERATIONS 100000
+#define SYSCALL_YIELD_ITERATIONS 10000
+
+/**
+ * Measures the cost of system calls. Querying the task id does the least
+ * possible work in the kernel and is close to the pure entry and exit cost,
+ * yielding additionally passes through the scheduler.
+ */
+void benchmarkSyscall()
+{
+	uint64_t start = benchmarkTimestamp();
+	for(int i = 0; i < SYSCALL_ITERATIONS; i++)
+		g_get_tid();
+	benchmarkReport("syscall", "get-tid", benchmarkMicros((benchmarkTimestamp() - start) * 1000 / SYSCALL_ITERATIONS), "ns/op");
+
+	start = benchmarkTimestamp();
+	for(int i = 0; i < SYSCALL_YIELD_ITERATIONS; i++)
+		g_yield();
+	benchmarkReport("syscall", "yield", benchmarkMicros((benchmarkTimestamp() - start) * 1000 / SYSCALL_YIELD_ITERATIONS), "ns/op");
+}
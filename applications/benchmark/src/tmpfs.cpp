@@ -0,0 +1,116 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TMPFS_FILE "/tmp/benchmark-large"
+#define TMPFS_RAMDISK_FILE "/benchmark-large.tmp"
+#define TMPFS_SMALL_FORMAT "/tmp/benchmark-small-%i"
+#define TMPFS_LARGE_SIZE (8 * 1024 * 1024)
+#define TMPFS_CHUNK_SIZE 4096
+#define TMPFS_REWRITE_CHUNK_SIZE 65536
+#define TMPFS_SMALL_COUNT 1000
+#define TMPFS_SMALL_SIZE 512
+
+static void tmpfsReport(const char* backend, const char* operation, uint64_t ticks, uint32_t count, uint64_t bytes)
+{
+	char key[64];
+	snprintf(key, sizeof(key), "%s-%s", backend, operation);
+	benchmarkReport("tmpfs", key, benchmarkMicros(ticks * 1000 / count), "ns/op");
+
+	if(bytes)
+	{
+		snprintf(key, sizeof(key), "%s-%s-throughput", backend, operation);
+		benchmarkReport("tmpfs", key, benchmarkThroughput(bytes, ticks), "KiB/s");
+	}
+}
+
+/**
+ * Grows a file by appending small chunks, then rewrites it in place with larger chunks.
+ */
+static void tmpfsMeasureLarge(const char* backend, const char* path, uint8_t* buffer)
+{
+	g_fd fd = g_open_f(path, G_FILE_FLAG_MODE_WRITE | G_FILE_FLAG_MODE_CREATE | G_FILE_FLAG_MODE_TRUNCATE | G_FILE_FLAG_MODE_APPEND);
+	if(fd == G_FD_NONE)
+	{
+		fprintf(stderr, "failed to create %s\n", path);
+		return;
+	}
+
+	uint32_t appends = TMPFS_LARGE_SIZE / TMPFS_CHUNK_SIZE;
+	uint64_t start = benchmarkTimestamp();
+	for(uint32_t i = 0; i < appends; i++)
+		g_write(fd, buffer, TMPFS_CHUNK_SIZE);
+	tmpfsReport(backend, "append", benchmarkTimestamp() - start, appends, TMPFS_LARGE_SIZE);
+	g_close(fd);
+
+	fd = g_open_f(path, G_FILE_FLAG_MODE_WRITE);
+	uint32_t rewrites = TMPFS_LARGE_SIZE / TMPFS_REWRITE_CHUNK_SIZE;
+	start = benchmarkTimestamp();
+	for(uint32_t i = 0; i < rewrites; i++)
+		g_write(fd, buffer, TMPFS_REWRITE_CHUNK_SIZE);
+	tmpfsReport(backend, "rewrite", benchmarkTimestamp() - start, rewrites, TMPFS_LARGE_SIZE);
+	g_close(fd);
+}
+
+/**
+ * Creates many small files and deletes them again.
+ */
+static void tmpfsMeasureSmall(uint8_t* buffer)
+{
+	char path[64];
+
+	uint64_t start = benchmarkTimestamp();
+	for(int i = 0; i < TMPFS_SMALL_COUNT; i++)
+	{
+		snprintf(path, sizeof(path), TMPFS_SMALL_FORMAT, i);
+		g_fd fd = g_open_f(path, G_FILE_FLAG_MODE_WRITE | G_FILE_FLAG_MODE_CREATE);
+		g_write(fd, buffer, TMPFS_SMALL_SIZE);
+		g_close(fd);
+	}
+	tmpfsReport("tmpfs", "create-small", benchmarkTimestamp() - start, TMPFS_SMALL_COUNT, 0);
+
+	start = benchmarkTimestamp();
+	for(int i = 0; i < TMPFS_SMALL_COUNT; i++)
+	{
+		snprintf(path, sizeof(path), TMPFS_SMALL_FORMAT, i);
+		g_unlink(path);
+	}
+	tmpfsReport("tmpfs", "unlink-small", benchmarkTimestamp() - start, TMPFS_SMALL_COUNT, 0);
+}
+
+void benchmarkTmpfs()
+{
+	uint8_t* buffer = (uint8_t*) malloc(TMPFS_REWRITE_CHUNK_SIZE);
+	memset(buffer, 'x', TMPFS_REWRITE_CHUNK_SIZE);
+
+	tmpfsMeasureLarge("ramdisk", TMPFS_RAMDISK_FILE, buffer);
+	tmpfsMeasureLarge("tmpfs", TMPFS_FILE, buffer);
+	tmpfsMeasureSmall(buffer);
+
+	// The ramdisk can not unlink, at least release the file content
+	g_close(g_open_f(TMPFS_RAMDISK_FILE, G_FILE_FLAG_MODE_WRITE | G_FILE_FLAG_MODE_TRUNCATE));
+	g_unlink(TMPFS_FILE);
+	free(buffer);
+}
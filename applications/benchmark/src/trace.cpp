@@ -0,0 +1,92 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+#define TRACE_SYSCALL_ITERATIONS 100000
+#define TRACE_MESSAGE_ITERATIONS 20000
+#define TRACE_MESSAGE_SIZE 64
+
+/**
+ * Performs the cheapest system call in a loop, this records a syscall enter
+ * and exit event per iteration when tracing is enabled.
+ */
+static uint64_t traceMeasureSyscall()
+{
+	uint64_t start = benchmarkTimestamp();
+	for(int i = 0; i < TRACE_SYSCALL_ITERATIONS; i++)
+		g_get_tid();
+	return benchmarkMicros((benchmarkTimestamp() - start) * 1000 / TRACE_SYSCALL_ITERATIONS);
+}
+
+/**
+ * Sends a message to the own task and receives it again.
+ */
+static uint64_t traceMeasureMessage()
+{
+	uint8_t message[TRACE_MESSAGE_SIZE];
+	uint8_t buffer[sizeof(g_message_header) + TRACE_MESSAGE_SIZE];
+	memset(message, 0, sizeof(message));
+	g_tid self = g_get_tid();
+
+	uint64_t start = benchmarkTimestamp();
+	for(int i = 0; i < TRACE_MESSAGE_ITERATIONS; i++)
+	{
+		g_send_message(self, message, sizeof(message));
+		g_receive_message(buffer, sizeof(buffer));
+	}
+	return benchmarkMicros((benchmarkTimestamp() - start) * 1000 / TRACE_MESSAGE_ITERATIONS);
+}
+
+static void traceMeasure(const char* name, uint64_t (*measure)())
+{
+	char key[64];
+
+	g_trace_control(G_TRACE_COMMAND_STOP);
+	uint64_t disabled = measure();
+	snprintf(key, sizeof(key), "%s-disabled", name);
+	benchmarkReport("trace", key, disabled, "ns/op");
+
+	g_trace_control(G_TRACE_COMMAND_RESET);
+	g_trace_control(G_TRACE_COMMAND_START);
+	uint64_t enabled = measure();
+	g_trace_control(G_TRACE_COMMAND_STOP);
+	snprintf(key, sizeof(key), "%s-enabled", name);
+	benchmarkReport("trace", key, enabled, "ns/op");
+
+	snprintf(key, sizeof(key), "%s-overhead", name);
+	benchmarkReport("trace", key, enabled > disabled ? enabled - disabled : 0, "ns/op");
+}
+
+void benchmarkTrace()
+{
+	if(g_trace_info(nullptr, nullptr) != G_TRACE_STATUS_SUCCESSFUL)
+	{
+		fprintf(stderr, "kernel was built without tracing\n");
+		return;
+	}
+
+	traceMeasure("syscall", traceMeasureSyscall);
+	traceMeasure("message", traceMeasureMessage);
+	g_trace_control(G_TRACE_COMMAND_RESET);
+}
@@ -0,0 +1,135 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.hpp"
+
+#include <libwindow/button.hpp>
+#include <libwindow/label.hpp>
+#include <libwindow/listener/action_listener.hpp>
+#include <libwindow/textfield.hpp>
+#include <libwindow/ui.hpp>
+#include <libwindow/window.hpp>
+#include <stdio.h>
+
+#define UI_DIALOG_ROWS 30
+#define UI_DIALOG_ITERATIONS 5
+
+class ui_dialog_listener_t : public g_action_listener
+{
+  public:
+	virtual void handle_action()
+	{
+	}
+};
+
+/**
+ * Builds a dialog with a label and a text field per row and two buttons,
+ * the way an application sets up a settings window. The window is never
+ * shown, so only the communication with the window server is measured.
+ *
+ * @return the elapsed ticks, or 0 if a command failed
+ */
+static uint64_t uiDialogBuild(bool batched, uint32_t* syscalls)
+{
+	uint32_t syscallsBefore = benchmarkSyscallCount();
+	uint64_t start = benchmarkTimestamp();
+	bool success = true;
+
+	if(batched)
+		g_ui::begin_batch();
+
+	g_window* window = g_window::create();
+	if(!window)
+	{
+		if(batched)
+			g_ui::end_batch();
+		return 0;
+	}
+	success &= window->setTitle("Benchmark dialog");
+	success &= window->setBounds(g_rectangle(40, 40, 420, 80 + UI_DIALOG_ROWS * 30));
+
+	for(int row = 0; row < UI_DIALOG_ROWS; row++)
+	{
+		g_label* label = g_label::create();
+		success &= label->setTitle("Setting");
+		success &= label->setBounds(g_rectangle(10, 10 + row * 30, 150, 25));
+		success &= window->addChild(label);
+
+		g_textfield* field = g_textfield::create();
+		success &= field->setTitle("Value");
+		success &= field->setBounds(g_rectangle(170, 10 + row * 30, 230, 25));
+		success &= window->addChild(field);
+	}
+
+	const char* buttons[] = {"OK", "Cancel"};
+	for(int i = 0; i < 2; i++)
+	{
+		g_button* button = g_button::create();
+		success &= button->setTitle(buttons[i]);
+		success &= button->setBounds(g_rectangle(200 + i * 100, 20 + UI_DIALOG_ROWS * 30, 90, 30));
+		success &= button->setActionListener(new ui_dialog_listener_t());
+		success &= window->addChild(button);
+	}
+
+	if(batched)
+		success &= g_ui::end_batch();
+
+	uint64_t ticks = benchmarkTimestamp() - start;
+	*syscalls = benchmarkSyscallCount() - syscallsBefore;
+	return success ? ticks : 0;
+}
+
+static void uiDialogRun(const char* name, bool batched)
+{
+	uint64_t total = 0;
+	uint32_t syscalls = 0;
+	for(int i = 0; i < UI_DIALOG_ITERATIONS; i++)
+	{
+		uint64_t ticks = uiDialogBuild(batched, &syscalls);
+		if(ticks == 0)
+		{
+			fprintf(stderr, "failed to build the %s dialog\n", name);
+			return;
+		}
+		total += ticks;
+	}
+
+	char metric[32];
+	snprintf(metric, sizeof(metric), "%s-syscalls", name);
+	benchmarkReport("ui-dialog", name, benchmarkMicros(total / UI_DIALOG_ITERATIONS), "us");
+	benchmarkReport("ui-dialog", metric, syscalls, "calls");
+}
+
+/**
+ * Measures how long it takes to construct a large dialog, with each command
+ * sent on its own and with the commands batched.
+ */
+void benchmarkUiDialog()
+{
+	g_ui_open_status status = g_ui::open();
+	if(status != G_UI_OPEN_STATUS_SUCCESSFUL && status != G_UI_OPEN_STATUS_EXISTING)
+	{
+		fprintf(stderr, "failed to open the UI\n");
+		return;
+	}
+
+	uiDialogRun("single", false);
+	uiDialogRun("batched", true);
+}
@@ -39,6 +39,8 @@ class g_font
 {
   private:
     uint8_t* data;
+    uint32_t dataLength = 0;
+    bool mapped = false;
     std::string name;
     g_font_style style = g_font_style::NORMAL;
     bool hint = true;
@@ -48,6 +50,21 @@ class g_font
 
     static bool readAllBytes(FILE* file, uint32_t offset, uint8_t* buffer, uint32_t len);
 
+    /**
+     * Creates an empty font, data must be set before initializing.
+     */
+    g_font(std::string name);
+
+    /**
+     * Creates the freetype and cairo faces from the font data.
+     */
+    void initialize();
+
+    /**
+     * Frees or unmaps the font data.
+     */
+    void releaseData();
+
   public:
     /**
      * Creates an empty font with the "name". The "source" data
@@ -60,7 +77,8 @@ class g_font
     g_font(std::string name, uint8_t* source, uint32_t sourceLength);
 
     /**
-     * Loads the font from the given path.
+     * Loads the font from the given path. The file is mapped into memory if
+     * possible, otherwise its content is read into a buffer.
      *
      * @param path the file path
      * @param name the font name
@@ -21,6 +21,7 @@
 #include "libfont/font.hpp"
 #include "libfont/font_manager.hpp"
 #include <string.h>
+#include <sys/mman.h>
 
 g_font::g_font(std::string name, uint8_t* source, uint32_t sourceLength) : name(name)
 {
@@ -31,12 +32,22 @@ g_font::g_font(std::string name, uint8_t* source, uint32_t sourceLength) : name(
 		return;
 	}
 	memcpy(data, source, sourceLength);
+	dataLength = sourceLength;
 
-	FT_Error error = FT_New_Memory_Face(g_font_manager::getInstance()->getLibraryHandle(), data, sourceLength, 0, &face);
+	initialize();
+}
+
+g_font::g_font(std::string name) : data(nullptr), name(name)
+{
+}
+
+void g_font::initialize()
+{
+	FT_Error error = FT_New_Memory_Face(g_font_manager::getInstance()->getLibraryHandle(), data, dataLength, 0, &face);
 	if(error)
 	{
 		klog("freetype2 failed at FT_New_Memory_Face with error code %i", error);
-		delete data;
+		releaseData();
 		return;
 	}
 
@@ -47,18 +58,27 @@ g_font::g_font(std::string name, uint8_t* source, uint32_t sourceLength) : name(
         FT_Done_Face(face);
 		klog("cairo failed at cairo_ft_font_face_create_for_ft_face with error %i", status);
 		cairo_face = 0;
-		delete data;
+		releaseData();
 		return;
 	}
 }
 
+void g_font::releaseData()
+{
+	if(mapped)
+		munmap(data, dataLength);
+	else
+		delete data;
+	data = nullptr;
+}
+
 g_font::~g_font()
 {
 	if(cairo_face)
 	{
 		cairo_font_face_destroy(cairo_face);
 		FT_Done_Face(face);
-		delete data;
+		releaseData();
 	}
 }
 
@@ -91,6 +111,25 @@ g_font* g_font::load(std::string path, std::string name)
 		return nullptr;
 	}
 
+	// Map the file, freetype then only loads the pages it actually reads
+	void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+	if(mapping != MAP_FAILED)
+	{
+		fclose(file);
+
+		g_font* font = new g_font(name);
+		font->data = (uint8_t*) mapping;
+		font->dataLength = length;
+		font->mapped = true;
+		font->initialize();
+		if(!font->isValid())
+		{
+			delete font;
+			return nullptr;
+		}
+		return font;
+	}
+
 	uint8_t* content = new uint8_t[length];
 	if(!readAllBytes(file, 0, content, length))
 	{
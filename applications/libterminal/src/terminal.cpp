@@ -56,24 +56,23 @@ void g_terminal::setMode(g_terminal_mode mode)
  */
 int g_terminal::readUnbuffered()
 {
-	int c = getc(stdin);
+	flockfile(stdin);
+	int c = getc_unlocked(stdin);
 
 	// Escaped sequences
 	if(c == G_TERMKEY_SUB)
 	{
-		int b1 = getc(stdin);
-		if(b1 == -1)
-		{
-			return -1;
-		}
-		int b2 = getc(stdin);
-		if(b2 == -1)
+		int b1 = getc_unlocked(stdin);
+		int b2 = b1 == -1 ? -1 : getc_unlocked(stdin);
+		funlockfile(stdin);
+		if(b1 == -1 || b2 == -1)
 		{
 			return -1;
 		}
 		return ((b2 << 8) | b1);
 	}
 
+	funlockfile(stdin);
 	return c;
 }
 
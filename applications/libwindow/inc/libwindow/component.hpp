@@ -24,6 +24,7 @@
 #include <cstdint>
 #include <map>
 
+#include "libwindow/batch.hpp"
 #include "libwindow/bounds_event_component.hpp"
 #include "libwindow/component_registry.hpp"
 #include "libwindow/interface.hpp"
@@ -61,6 +62,8 @@ class g_component : public g_bounds_event_component
 			return 0;
 		}
 
+		g_ui_batch_flush();
+
 		// send initialization request
 		g_message_transaction tx = g_get_message_tx_id();
 
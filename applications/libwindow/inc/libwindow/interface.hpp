@@ -74,6 +74,7 @@ const g_ui_protocol_command_id G_UI_PROTOCOL_GET_BOUNDS = 12;
 const g_ui_protocol_command_id G_UI_PROTOCOL_CANVAS_BLIT = 13;
 const g_ui_protocol_command_id G_UI_PROTOCOL_REGISTER_DESKTOP_CANVAS = 14;
 const g_ui_protocol_command_id G_UI_PROTOCOL_GET_SCREEN_DIMENSION = 15;
+const g_ui_protocol_command_id G_UI_PROTOCOL_BATCH = 16;
 
 /**
  * Common status for requests
@@ -354,6 +355,51 @@ typedef struct
 	g_dimension size;
 } __attribute__((packed)) g_ui_get_screen_dimension_response;
 
+/**
+ * A batch carries several commands in one message. Each command is preceded by
+ * a <g_ui_batch_entry> with its length and is processed as if it was sent on
+ * its own, but without a response. Only commands that answer with nothing but
+ * a status can be batched: adding children, setting the title, bounds,
+ * visibility, listeners and numeric properties, and the canvas requests.
+ *
+ * If the batch has the <G_UI_BATCH_FLAG_RESPOND> flag, the window server
+ * answers with a single <g_ui_batch_response> for all commands.
+ */
+#define G_UI_BATCH_MAXIMUM_SIZE G_MESSAGE_MAXIMUM_LENGTH
+
+typedef uint8_t g_ui_batch_flags;
+#define G_UI_BATCH_FLAG_RESPOND ((g_ui_batch_flags) 0x1)
+
+typedef struct
+{
+	g_ui_message_header header;
+	uint16_t count;
+	g_ui_batch_flags flags;
+} __attribute__((packed)) g_ui_batch_request;
+
+typedef struct
+{
+	uint16_t length;
+} __attribute__((packed)) g_ui_batch_entry;
+
+/**
+ * Response for a batch.
+ *
+ * @field status
+ * 		success if all commands succeeded
+ * @field count
+ * 		number of commands in the batch
+ * @field failed
+ * 		number of commands that failed
+ */
+typedef struct
+{
+	g_ui_message_header header;
+	g_ui_protocol_status status;
+	uint16_t count;
+	uint16_t failed;
+} __attribute__((packed)) g_ui_batch_response;
+
 /**
  * Event structures
  */
@@ -68,6 +68,28 @@ class g_ui
 	static bool register_desktop_canvas(g_canvas *c);
 
 	static bool get_screen_dimension(g_dimension *out);
+
+	/**
+	 * Starts collecting the commands that the calling thread sends to the
+	 * window server, like adding children or setting titles and bounds, so
+	 * they are sent together in as few messages as possible. Until the batch
+	 * ends these calls return true without waiting for the window server.
+	 * Requests that return a result, like creating a component, first send
+	 * what was collected. Batches may be nested; only the outermost one is
+	 * sent when it ends. Other threads that start a batch wait until then.
+	 *
+	 * @param respond
+	 * 		whether the window server should report the result of the batch
+	 */
+	static void begin_batch(bool respond = true);
+
+	/**
+	 * Sends the remaining commands of the batch and waits for its result.
+	 *
+	 * @return whether all batched commands succeeded, or true if no response
+	 * 		was requested and sending worked
+	 */
+	static bool end_batch();
 };
 
 #endif
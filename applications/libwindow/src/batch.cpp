@@ -0,0 +1,184 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <ghost.h>
+#include <string.h>
+#include <vector>
+
+#include "libwindow/batch.hpp"
+#include "libwindow/ui.hpp"
+
+static g_atom batch_lock = g_atomic_initialize();
+static g_tid batch_owner = G_TID_NONE;
+static int batch_depth = 0;
+static bool batch_respond;
+static bool batch_failed;
+
+static uint8_t batch_buffer[G_UI_BATCH_MAXIMUM_SIZE];
+static size_t batch_length;
+static uint16_t batch_count;
+
+/**
+ * Transactions of the sent parts of the batch that are still to be answered.
+ */
+static std::vector<g_message_transaction> batch_pending;
+
+/**
+ *
+ */
+static void batch_reset()
+{
+	g_ui_batch_request* request = (g_ui_batch_request*) batch_buffer;
+	request->header.id = G_UI_PROTOCOL_BATCH;
+	request->flags = batch_respond ? G_UI_BATCH_FLAG_RESPOND : 0;
+	batch_length = sizeof(g_ui_batch_request);
+	batch_count = 0;
+}
+
+/**
+ *
+ */
+static void batch_send()
+{
+	if(batch_count == 0)
+	{
+		return;
+	}
+
+	g_ui_batch_request* request = (g_ui_batch_request*) batch_buffer;
+	request->count = batch_count;
+
+	g_message_transaction tx = g_get_message_tx_id();
+	if(g_send_message_t(g_ui_delegate_tid, batch_buffer, batch_length, tx) != G_MESSAGE_SEND_STATUS_SUCCESSFUL)
+	{
+		klog("failed to send a batch of %i UI commands", batch_count);
+		batch_failed = true;
+	}
+	else if(batch_respond)
+	{
+		batch_pending.push_back(tx);
+	}
+
+	batch_reset();
+}
+
+/**
+ *
+ */
+bool g_ui_batch_add(const void* command, size_t length)
+{
+	if(batch_owner != g_get_tid())
+	{
+		return false;
+	}
+
+	size_t required = sizeof(g_ui_batch_entry) + length;
+	if(sizeof(g_ui_batch_request) + required > G_UI_BATCH_MAXIMUM_SIZE)
+	{
+		return false;
+	}
+
+	if(batch_length + required > G_UI_BATCH_MAXIMUM_SIZE)
+	{
+		batch_send();
+	}
+
+	g_ui_batch_entry* entry = (g_ui_batch_entry*) &batch_buffer[batch_length];
+	entry->length = length;
+	memcpy(&batch_buffer[batch_length + sizeof(g_ui_batch_entry)], command, length);
+	batch_length += required;
+	batch_count++;
+	return true;
+}
+
+/**
+ *
+ */
+void g_ui_batch_flush()
+{
+	if(batch_owner == g_get_tid())
+	{
+		batch_send();
+	}
+}
+
+/**
+ *
+ */
+void g_ui::begin_batch(bool respond)
+{
+	g_tid tid = g_get_tid();
+	if(batch_owner == tid)
+	{
+		++batch_depth;
+		return;
+	}
+
+	g_atomic_lock(batch_lock);
+	batch_owner = tid;
+	batch_depth = 1;
+	batch_respond = respond;
+	batch_failed = false;
+	batch_reset();
+}
+
+/**
+ *
+ */
+bool g_ui::end_batch()
+{
+	if(batch_owner != g_get_tid())
+	{
+		return false;
+	}
+
+	if(--batch_depth > 0)
+	{
+		return true;
+	}
+
+	batch_send();
+
+	// collect the responses of all parts
+	bool success = !batch_failed;
+	size_t bufferSize = sizeof(g_message_header) + sizeof(g_ui_batch_response);
+	uint8_t buffer[bufferSize];
+	for(g_message_transaction tx : batch_pending)
+	{
+		if(g_receive_message_t(buffer, bufferSize, tx) == G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL)
+		{
+			g_ui_batch_response* response = (g_ui_batch_response*) G_MESSAGE_CONTENT(buffer);
+			if(response->status != G_UI_PROTOCOL_SUCCESS)
+			{
+				klog("%i of %i batched UI commands failed", response->failed, response->count);
+				success = false;
+			}
+		}
+		else
+		{
+			success = false;
+		}
+	}
+	batch_pending.clear();
+
+	batch_owner = G_TID_NONE;
+	g_atomic_unlock(batch_lock);
+	return success;
+}
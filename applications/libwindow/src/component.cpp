@@ -19,6 +19,7 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "libwindow/component.hpp"
+#include "libwindow/batch.hpp"
 #include "libwindow/properties.hpp"
 
 bool g_component::addChild(g_component* child)
@@ -28,13 +29,18 @@ bool g_component::addChild(g_component* child)
 		return 0;
 	}
 
-	// send initialization request
-	g_message_transaction tx = g_get_message_tx_id();
-
 	g_ui_component_add_child_request request;
 	request.header.id = G_UI_PROTOCOL_ADD_COMPONENT;
 	request.parent = this->id;
 	request.child = child->id;
+
+	if(g_ui_batch_add(&request, sizeof(g_ui_component_add_child_request)))
+	{
+		return true;
+	}
+
+	// send initialization request
+	g_message_transaction tx = g_get_message_tx_id();
 	g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_component_add_child_request), tx);
 
 	// read response
@@ -60,13 +66,18 @@ bool g_component::setBounds(g_rectangle rect)
 		return 0;
 	}
 
-	// send initialization request
-	g_message_transaction tx = g_get_message_tx_id();
-
 	g_ui_component_set_bounds_request request;
 	request.header.id = G_UI_PROTOCOL_SET_BOUNDS;
 	request.id = this->id;
 	request.bounds = rect;
+
+	if(g_ui_batch_add(&request, sizeof(g_ui_component_set_bounds_request)))
+	{
+		return true;
+	}
+
+	// send initialization request
+	g_message_transaction tx = g_get_message_tx_id();
 	g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_component_set_bounds_request), tx);
 
 	// read response
@@ -92,6 +103,8 @@ g_rectangle g_component::getBounds()
 		return g_rectangle();
 	}
 
+	g_ui_batch_flush();
+
 	// send initialization request
 	g_message_transaction tx = g_get_message_tx_id();
 
@@ -124,13 +137,18 @@ bool g_component::setVisible(bool visible)
 		return 0;
 	}
 
-	// send initialization request
-	g_message_transaction tx = g_get_message_tx_id();
-
 	g_ui_component_set_visible_request request;
 	request.header.id = G_UI_PROTOCOL_SET_VISIBLE;
 	request.id = this->id;
 	request.visible = visible;
+
+	if(g_ui_batch_add(&request, sizeof(g_ui_component_set_visible_request)))
+	{
+		return true;
+	}
+
+	// send initialization request
+	g_message_transaction tx = g_get_message_tx_id();
 	g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_component_set_visible_request), tx);
 
 	// read response
@@ -157,14 +175,19 @@ bool g_component::setNumericProperty(int property, uint32_t value)
 		return false;
 	}
 
-	// send initialization request
-	g_message_transaction tx = g_get_message_tx_id();
-
 	g_ui_component_set_numeric_property_request request;
 	request.header.id = G_UI_PROTOCOL_SET_NUMERIC_PROPERTY;
 	request.id = this->id;
 	request.property = property;
 	request.value = value;
+
+	if(g_ui_batch_add(&request, sizeof(g_ui_component_set_numeric_property_request)))
+	{
+		return true;
+	}
+
+	// send initialization request
+	g_message_transaction tx = g_get_message_tx_id();
 	g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_component_set_numeric_property_request), tx);
 
 	// read response
@@ -190,6 +213,8 @@ bool g_component::getNumericProperty(int property, uint32_t* out)
 		return false;
 	}
 
+	g_ui_batch_flush();
+
 	// send initialization request
 	g_message_transaction tx = g_get_message_tx_id();
 
@@ -236,14 +261,19 @@ bool g_component::setListener(g_ui_component_event_type eventType, g_listener* n
 		return false;
 	}
 
-	// send request
-	g_message_transaction tx = g_get_message_tx_id();
-
 	g_ui_component_set_listener_request request;
 	request.header.id = G_UI_PROTOCOL_SET_LISTENER;
 	request.id = this->id;
 	request.target_thread = g_ui_event_dispatcher_tid;
 	request.event_type = eventType;
+
+	if(g_ui_batch_add(&request, sizeof(g_ui_component_set_listener_request)))
+	{
+		return true;
+	}
+
+	// send request
+	g_message_transaction tx = g_get_message_tx_id();
 	g_send_message_t(g_ui_delegate_tid, &request, sizeof(g_ui_component_set_listener_request), tx);
 
 	// read response
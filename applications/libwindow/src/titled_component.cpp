@@ -18,8 +18,10 @@
  *                                                                           *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+#include <cstddef>
 #include <cstring>
 
+#include "libwindow/batch.hpp"
 #include "libwindow/titled_component.hpp"
 #include "libwindow/ui.hpp"
 
@@ -31,9 +33,6 @@ bool g_titled_component::setTitle(std::string title)
 		return 0;
 	}
 
-	// send initialization request
-	g_message_transaction tx = g_get_message_tx_id();
-
 	g_ui_component_set_title_request* request = new g_ui_component_set_title_request();
 	request->header.id = G_UI_PROTOCOL_SET_TITLE;
 	request->id = this->id;
@@ -52,6 +51,15 @@ bool g_titled_component::setTitle(std::string title)
 	memcpy(request->title, title.c_str(), title_len);
 	request->title[title_len] = 0;
 
+	// within a batch the title is only sent up to its terminator
+	if(g_ui_batch_add(request, offsetof(g_ui_component_set_title_request, title) + title_len + 1))
+	{
+		delete request;
+		return true;
+	}
+
+	// send initialization request
+	g_message_transaction tx = g_get_message_tx_id();
 	g_send_message_t(g_ui_delegate_tid, request, sizeof(g_ui_component_set_title_request), tx);
 
 	// read response
@@ -77,6 +85,8 @@ std::string g_titled_component::getTitle()
 		return 0;
 	}
 
+	g_ui_batch_flush();
+
 	// send initialization request
 	g_message_transaction tx = g_get_message_tx_id();
 
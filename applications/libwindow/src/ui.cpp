@@ -21,6 +21,7 @@
 #include <ghost.h>
 #include <stdio.h>
 
+#include "libwindow/batch.hpp"
 #include "libwindow/canvas.hpp"
 #include "libwindow/component.hpp"
 #include "libwindow/ui.hpp"
@@ -138,6 +139,8 @@ bool g_ui::register_desktop_canvas(g_canvas* c)
 		return false;
 	}
 
+	g_ui_batch_flush();
+
 	g_message_transaction tx = g_get_message_tx_id();
 
 	// send registration request
@@ -173,6 +176,8 @@ bool g_ui::get_screen_dimension(g_dimension* out)
 		return false;
 	}
 
+	g_ui_batch_flush();
+
 	g_message_transaction tx = g_get_message_tx_id();
 
 	// send request
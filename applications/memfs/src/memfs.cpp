@@ -0,0 +1,243 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "memfs.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static memfs_file* files;
+static int fileCount;
+static g_fs_tasked_delegate_transaction_storage* storage;
+
+/**
+ * Physical id 0 is the mountpoint, files are numbered from 1.
+ */
+static memfs_file* memfsGetFile(g_fs_phys_id id)
+{
+	if(id < 1 || id > (g_fs_phys_id) fileCount)
+		return nullptr;
+	return &files[id - 1];
+}
+
+static void memfsCreateFiles(int count, uint32_t size)
+{
+	fileCount = count;
+	files = (memfs_file*) calloc(count, sizeof(memfs_file));
+	for(int i = 0; i < count; i++)
+	{
+		snprintf(files[i].name, sizeof(files[i].name), "file-%i", i);
+		files[i].length = size;
+		files[i].capacity = size;
+		files[i].data = (uint8_t*) malloc(size ? size : 1);
+		memset(files[i].data, 'a' + (i % 26), size);
+	}
+}
+
+static void memfsDiscover(g_fs_tasked_delegate_transaction_storage_discovery* discovery)
+{
+	discovery->result_status = G_FS_DISCOVERY_NOT_FOUND;
+	if(discovery->parent_phys_fs_id != MEMFS_ROOT_ID)
+		return;
+
+	for(int i = 0; i < fileCount; i++)
+	{
+		if(strcmp(files[i].name, discovery->name) == 0)
+		{
+			uint32_t created;
+			g_fs_create_node(discovery->parent_virt_fs_id, files[i].name, G_FS_NODE_TYPE_FILE, i + 1, &created);
+			discovery->result_status = G_FS_DISCOVERY_SUCCESSFUL;
+			return;
+		}
+	}
+}
+
+static void memfsRefresh(g_fs_tasked_delegate_transaction_storage_directory_refresh* refresh)
+{
+	if(refresh->parent_phys_fs_id != MEMFS_ROOT_ID)
+	{
+		refresh->result_status = G_FS_DIRECTORY_REFRESH_ERROR;
+		return;
+	}
+
+	for(int i = 0; i < fileCount; i++)
+	{
+		uint32_t created;
+		g_fs_create_node(refresh->parent_virt_fs_id, files[i].name, G_FS_NODE_TYPE_FILE, i + 1, &created);
+	}
+	refresh->result_status = G_FS_DIRECTORY_REFRESH_SUCCESSFUL;
+}
+
+static void memfsOpen(g_fs_tasked_delegate_transaction_storage_open* open)
+{
+	if(open->phys_fs_id == MEMFS_ROOT_ID)
+	{
+		open->result_status = G_FS_OPEN_SUCCESSFUL;
+		return;
+	}
+
+	memfs_file* file = memfsGetFile(open->phys_fs_id);
+	if(!file)
+	{
+		open->result_status = G_FS_OPEN_NOT_FOUND;
+		return;
+	}
+
+	if(open->flags & G_FILE_FLAG_MODE_TRUNCATE)
+		file->length = 0;
+	open->result_status = G_FS_OPEN_SUCCESSFUL;
+}
+
+static void memfsRead(g_fs_tasked_delegate_transaction_storage_read* read)
+{
+	memfs_file* file = memfsGetFile(read->phys_fs_id);
+	if(!file || read->offset < 0)
+	{
+		read->result_status = G_FS_READ_ERROR;
+		return;
+	}
+
+	int64_t length = 0;
+	if(read->offset < file->length)
+	{
+		length = file->length - read->offset;
+		if(length > read->length)
+			length = read->length;
+		memcpy(read->mapped_buffer, file->data + read->offset, length);
+	}
+	read->result_read = length;
+	read->result_status = G_FS_READ_SUCCESSFUL;
+}
+
+static void memfsWrite(g_fs_tasked_delegate_transaction_storage_write* write)
+{
+	memfs_file* file = memfsGetFile(write->phys_fs_id);
+	if(!file || write->offset < 0)
+	{
+		write->result_status = G_FS_WRITE_ERROR;
+		return;
+	}
+
+	int64_t end = write->offset + write->length;
+	if(end > file->capacity)
+	{
+		int64_t capacity = file->capacity ? file->capacity : 64;
+		while(capacity < end)
+			capacity *= 2;
+
+		uint8_t* data = (uint8_t*) realloc(file->data, capacity);
+		if(!data)
+		{
+			write->result_status = G_FS_WRITE_ERROR;
+			return;
+		}
+		file->data = data;
+		file->capacity = capacity;
+	}
+
+	if(write->offset > file->length)
+		memset(file->data + file->length, 0, write->offset - file->length);
+	memcpy(file->data + write->offset, write->mapped_buffer, write->length);
+	if(end > file->length)
+		file->length = end;
+
+	write->result_write = write->length;
+	write->result_status = G_FS_WRITE_SUCCESSFUL;
+}
+
+static void memfsGetLength(g_fs_tasked_delegate_transaction_storage_get_length* getLength)
+{
+	memfs_file* file = memfsGetFile(getLength->phys_fs_id);
+	if(!file)
+	{
+		getLength->result_status = getLength->phys_fs_id == MEMFS_ROOT_ID ? G_FS_LENGTH_SUCCESSFUL : G_FS_LENGTH_NOT_FOUND;
+		getLength->result_length = 0;
+		return;
+	}
+
+	getLength->result_length = file->length;
+	getLength->result_status = G_FS_LENGTH_SUCCESSFUL;
+}
+
+static void memfsHandle(g_fs_tasked_delegate_request* request)
+{
+	switch(request->type)
+	{
+		case G_FS_TASKED_DELEGATE_REQUEST_TYPE_DISCOVER:
+			memfsDiscover(&storage->discovery);
+			break;
+		case G_FS_TASKED_DELEGATE_REQUEST_TYPE_READ_DIRECTORY:
+			memfsRefresh(&storage->directory_refresh);
+			break;
+		case G_FS_TASKED_DELEGATE_REQUEST_TYPE_OPEN:
+			memfsOpen(&storage->open);
+			break;
+		case G_FS_TASKED_DELEGATE_REQUEST_TYPE_READ:
+			memfsRead(&storage->read);
+			break;
+		case G_FS_TASKED_DELEGATE_REQUEST_TYPE_WRITE:
+			memfsWrite(&storage->write);
+			break;
+		case G_FS_TASKED_DELEGATE_REQUEST_TYPE_GET_LENGTH:
+			memfsGetLength(&storage->get_length);
+			break;
+		case G_FS_TASKED_DELEGATE_REQUEST_TYPE_CLOSE:
+			storage->close.result_status = G_FS_CLOSE_SUCCESSFUL;
+			break;
+	}
+	g_fs_set_transaction_status(request->transaction, G_FS_TRANSACTION_FINISHED);
+}
+
+/**
+ * Usage: memfs.bin [<name> [<file count> [<file size>]]]
+ *
+ * Mounts a flat in-memory file system at /mount/<name> that contains the given
+ * number of files. File content can be overwritten and extended, but files can
+ * not be created.
+ */
+int main(int argc, char** argv)
+{
+	const char* name = argc > 1 ? argv[1] : MEMFS_DEFAULT_NAME;
+	int count = argc > 2 ? atoi(argv[2]) : MEMFS_DEFAULT_FILE_COUNT;
+	uint32_t size = argc > 3 ? atoi(argv[3]) : MEMFS_DEFAULT_FILE_SIZE;
+	memfsCreateFiles(count, size);
+
+	g_fs_virt_id mountpoint;
+	g_address storageAddress;
+	g_fs_register_as_delegate_status status = g_fs_register_as_delegate(name, MEMFS_ROOT_ID, &mountpoint, &storageAddress);
+	if(status != G_FS_REGISTER_AS_DELEGATE_SUCCESSFUL)
+	{
+		klog("memfs: failed to register as delegate for /mount/%s with status %i", name, status);
+		return -1;
+	}
+	storage = (g_fs_tasked_delegate_transaction_storage*) storageAddress;
+	klog("memfs: mounted %i files at /mount/%s", count, name);
+
+	size_t bufferSize = sizeof(g_message_header) + sizeof(g_fs_tasked_delegate_request);
+	uint8_t* buffer = (uint8_t*) malloc(bufferSize);
+	for(;;)
+	{
+		if(g_receive_message(buffer, bufferSize) != G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL)
+			continue;
+
+		memfsHandle((g_fs_tasked_delegate_request*) G_MESSAGE_CONTENT(buffer));
+	}
+}
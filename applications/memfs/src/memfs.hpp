@@ -0,0 +1,44 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __MEMFS__
+#define __MEMFS__
+
+#include <ghost.h>
+#include <stdint.h>
+
+#define MEMFS_DEFAULT_NAME "memfs"
+#define MEMFS_DEFAULT_FILE_COUNT 16
+#define MEMFS_DEFAULT_FILE_SIZE 4096
+
+#define MEMFS_ROOT_ID 0
+
+/**
+ * A file held in memory.
+ */
+struct memfs_file
+{
+	char name[32];
+	uint8_t* data;
+	int64_t length;
+	int64_t capacity;
+};
+
+#endif
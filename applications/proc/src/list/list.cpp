@@ -81,15 +81,40 @@ int procList(int argc, char** argv)
 			threads = true;
 	}
 
+	g_kernquery_task_get_data* taskData;
+	uint32_t taskCount;
+	if(!procQueryTasks(&taskData, &taskCount))
+		return -1;
+
+	qsort(taskData, taskCount, sizeof(g_kernquery_task_get_data), procListCompareByParent);
+
+	// print information
+	println("%5s %5s %6s %-20s %-38s", "pid", "tid", "mem", "id", "path");
+	for(uint32_t pos = 0; pos < taskCount; pos++)
+	{
+		g_kernquery_task_get_data* entry = &taskData[pos];
+
+		if(entry->id != -1 && (entry->type == G_TASK_TYPE_DEFAULT || entry->type == G_TASK_TYPE_VM86) && (threads || entry->id == entry->parent))
+		{
+			println("%5i %5i %6i %-20s %-38s", entry->parent, entry->id, entry->memory_used / 1024, entry->identifier, entry->source_path);
+		}
+	}
+
+	delete[] taskData;
+	return 0;
+}
+
+bool procQueryTasks(g_kernquery_task_get_data** outTasks, uint32_t* outCount)
+{
 	int numTasks = countTasks();
 	if(numTasks == -1)
-		return -1;
+		return false;
 
 	// get list of task ids
 	g_tid* ids;
 	uint32_t taskCount;
 	if(!getTaskIds(numTasks + 16, &ids, &taskCount))
-		return -1;
+		return false;
 
 	// get detail information for each task
 	g_kernquery_task_get_data* taskData = new g_kernquery_task_get_data[taskCount];
@@ -103,20 +128,9 @@ int procList(int argc, char** argv)
 			continue;
 		}
 	}
+	delete[] ids;
 
-	qsort(taskData, taskCount, sizeof(g_kernquery_task_get_data), procListCompareByParent);
-
-	// print information
-	println("%5s %5s %6s %-20s %-38s", "pid", "tid", "mem", "id", "path");
-	for(uint32_t pos = 0; pos < taskCount; pos++)
-	{
-		g_kernquery_task_get_data* entry = &taskData[pos];
-
-		if(entry->id != -1 && (entry->type == G_TASK_TYPE_DEFAULT || entry->type == G_TASK_TYPE_VM86) && (threads || entry->id == entry->parent))
-		{
-			println("%5i %5i %6i %-20s %-38s", entry->parent, entry->id, entry->memory_used / 1024, entry->identifier, entry->source_path);
-		}
-	}
-
-	return 0;
+	*outTasks = taskData;
+	*outCount = taskCount;
+	return true;
 }
@@ -18,6 +18,7 @@
  *                                                                           *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+#include <ghost/kernquery.h>
 #include <stdio.h>
 
 #ifndef __PROC_LIST__
@@ -28,4 +29,9 @@
  */
 int procList(int argc, char** argv);
 
+/**
+ * Queries the details of all existing tasks. The returned array must be deleted.
+ */
+bool procQueryTasks(g_kernquery_task_get_data** outTasks, uint32_t* outCount);
+
 #endif
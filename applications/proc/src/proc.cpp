@@ -23,10 +23,11 @@
 #include <string.h>
 
 #define MAJOR 0
-#define MINOR 2
-#define PATCH 1
+#define MINOR 3
+#define PATCH 0
 
 #include "list/list.hpp"
+#include "top/top.hpp"
 
 /**
  *
@@ -42,6 +43,10 @@ int main(int argc, char** argv)
 		{
 			return procList(argc, argv);
 		}
+		else if(strcmp(command, "-s") == 0 || strcmp(command, "--stats") == 0)
+		{
+			return procTop(argc, argv);
+		}
 		else if(strcmp(command, "-k") == 0 || strcmp(command, "--kill") == 0)
 		{
 			if(argc > 2)
@@ -83,6 +88,10 @@ int main(int argc, char** argv)
 			println("The following commands are available:");
 			println("");
 			println("\t-l\t\tlists running tasks");
+			println("\t-s\t\tshows processor, memory and IPC statistics and");
+			println("\t\t\tthe processes sorted by CPU usage");
+			println("\t\t\t-i <ms> sampling interval, -w keep refreshing,");
+			println("\t\t\t-t show threads instead of processes");
 			println("\t-k <id>\tkills a process");
 			println("");
 		}
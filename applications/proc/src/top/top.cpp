@@ -0,0 +1,238 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "top.hpp"
+#include "list/list.hpp"
+
+#include <ghost/kernquery.h>
+#include <ghost/user.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PROC_TOP_DEFAULT_INTERVAL 1000
+
+struct proc_top_cpu
+{
+	uint64_t idle;
+	uint64_t busy;
+	uint32_t tasks;
+};
+
+struct proc_top_entry
+{
+	g_kernquery_task_get_data* task;
+	uint64_t time;
+	uint32_t usage;
+};
+
+/**
+ * Queries the times of all processors. The returned array must be deleted.
+ */
+bool procTopQueryCpus(proc_top_cpu** outCpus, uint32_t* outCount)
+{
+	g_kernquery_cpu_count_data countData;
+	g_kernquery_status status = g_kernquery(G_KERNQUERY_CPU_COUNT, (uint8_t*) &countData);
+	if(status != G_KERNQUERY_STATUS_SUCCESSFUL)
+	{
+		fprintf(stderr, "failed to query the kernel for the number of processors (code %i)\n", status);
+		return false;
+	}
+
+	proc_top_cpu* cpus = new proc_top_cpu[countData.count];
+	for(uint32_t i = 0; i < countData.count; i++)
+	{
+		g_kernquery_cpu_get_data data;
+		data.position = i;
+		if(g_kernquery(G_KERNQUERY_CPU_GET, (uint8_t*) &data) != G_KERNQUERY_STATUS_SUCCESSFUL)
+		{
+			memset(&cpus[i], 0, sizeof(proc_top_cpu));
+			continue;
+		}
+		cpus[i].idle = data.idle_time;
+		cpus[i].busy = data.busy_time;
+		cpus[i].tasks = data.task_count;
+	}
+
+	*outCpus = cpus;
+	*outCount = countData.count;
+	return true;
+}
+
+/**
+ * Returns the part of the total as tenths of a percent.
+ */
+uint32_t procTopPermille(uint64_t part, uint64_t total)
+{
+	if(total == 0)
+		return 0;
+	return (uint32_t) ((part * 1000) / total);
+}
+
+uint64_t procTopTime(g_kernquery_task_get_data* task, bool threads)
+{
+	if(threads)
+		return task->cpu_time_user + task->cpu_time_kernel;
+	return task->process_cpu_time_user + task->process_cpu_time_kernel;
+}
+
+int procTopCompareByUsage(const void* a, const void* b)
+{
+	proc_top_entry* entryA = (proc_top_entry*) a;
+	proc_top_entry* entryB = (proc_top_entry*) b;
+
+	if(entryA->usage == entryB->usage)
+		return entryA->task->id - entryB->task->id;
+	return entryA->usage > entryB->usage ? -1 : 1;
+}
+
+void procTopPrintSummary(proc_top_cpu* before, proc_top_cpu* after, uint32_t cpuCount)
+{
+	for(uint32_t i = 0; i < cpuCount; i++)
+	{
+		uint64_t busy = after[i].busy - before[i].busy;
+		uint64_t idle = after[i].idle - before[i].idle;
+		uint32_t usage = procTopPermille(busy, busy + idle);
+		println("cpu %i: %3i.%i%% busy, %i tasks, %i s idle, %i s busy", i, usage / 10, usage % 10, after[i].tasks,
+				(uint32_t) (after[i].idle / 1000000), (uint32_t) (after[i].busy / 1000000));
+	}
+
+	g_kernquery_memory_get_data memory;
+	if(g_kernquery(G_KERNQUERY_MEMORY_GET, (uint8_t*) &memory) == G_KERNQUERY_STATUS_SUCCESSFUL)
+	{
+		println("mem: %i KiB total, %i KiB free, heap %i/%i KiB, page cache %i KiB (%i hits, %i misses), tmpfs %i/%i KiB",
+				memory.physical_total_pages * 4, memory.physical_free_pages * 4, memory.heap_used / 1024, memory.heap_size / 1024,
+				memory.page_cache_pages * 4, memory.page_cache_hits, memory.page_cache_misses, memory.tmpfs_used / 1024, memory.tmpfs_limit / 1024);
+	}
+
+	g_kernquery_statistics_get_data statistics;
+	if(g_kernquery(G_KERNQUERY_STATISTICS_GET, (uint8_t*) &statistics) == G_KERNQUERY_STATUS_SUCCESSFUL)
+	{
+		println("msg: %i sent, %i received, %i KiB", statistics.messages_sent, statistics.messages_received,
+				(uint32_t) (statistics.message_bytes / 1024));
+		println("pipe: %i reads, %i writes, %i KiB read, %i KiB written", statistics.pipe_reads, statistics.pipe_writes,
+				(uint32_t) (statistics.pipe_bytes_read / 1024), (uint32_t) (statistics.pipe_bytes_written / 1024));
+		println("fs: %i opens, %i closes, %i reads, %i writes, %i KiB read, %i KiB written", statistics.fs_opens, statistics.fs_closes,
+				statistics.fs_reads, statistics.fs_writes, (uint32_t) (statistics.fs_bytes_read / 1024), (uint32_t) (statistics.fs_bytes_written / 1024));
+	}
+}
+
+void procTopPrintTasks(g_kernquery_task_get_data* before, uint32_t beforeCount,
+					   g_kernquery_task_get_data* after, uint32_t afterCount,
+					   uint64_t elapsed, bool threads)
+{
+	proc_top_entry* entries = new proc_top_entry[afterCount];
+	uint32_t entryCount = 0;
+
+	for(uint32_t i = 0; i < afterCount; i++)
+	{
+		g_kernquery_task_get_data* task = &after[i];
+		if(task->id == -1 || (task->type != G_TASK_TYPE_DEFAULT && task->type != G_TASK_TYPE_VM86) || (!threads && task->id != task->parent))
+			continue;
+
+		uint64_t previous = 0;
+		for(uint32_t j = 0; j < beforeCount; j++)
+		{
+			if(before[j].id == task->id)
+			{
+				previous = procTopTime(&before[j], threads);
+				break;
+			}
+		}
+
+		proc_top_entry* entry = &entries[entryCount++];
+		entry->task = task;
+		entry->time = procTopTime(task, threads);
+		entry->usage = procTopPermille(entry->time - previous, elapsed);
+	}
+
+	qsort(entries, entryCount, sizeof(proc_top_entry), procTopCompareByUsage);
+
+	println("");
+	println("%5s %5s %3s %6s %8s %8s %7s %7s %-20s", "pid", "tid", "cpu", "%cpu", "user ms", "kern ms", "res KiB", "virt KiB", "id");
+	for(uint32_t i = 0; i < entryCount; i++)
+	{
+		g_kernquery_task_get_data* task = entries[i].task;
+		uint64_t user = threads ? task->cpu_time_user : task->process_cpu_time_user;
+		uint64_t kernel = threads ? task->cpu_time_kernel : task->process_cpu_time_kernel;
+		println("%5i %5i %3i %4i.%i %8i %8i %7i %7i %-20s", task->parent, task->id, task->processor, entries[i].usage / 10, entries[i].usage % 10,
+				(uint32_t) (user / 1000), (uint32_t) (kernel / 1000), task->memory_used / 1024, task->memory_virtual / 1024,
+				task->identifier[0] ? task->identifier : task->source_path);
+	}
+
+	delete[] entries;
+}
+
+/**
+ *
+ */
+int procTop(int argc, char** argv)
+{
+	bool threads = false;
+	bool watch = false;
+	uint32_t interval = PROC_TOP_DEFAULT_INTERVAL;
+	for(int i = 0; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--threads") == 0)
+			threads = true;
+		else if(strcmp(argv[i], "-w") == 0 || strcmp(argv[i], "--watch") == 0)
+			watch = true;
+		else if((strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--interval") == 0) && i + 1 < argc)
+			interval = atoi(argv[++i]);
+	}
+	if(interval == 0)
+		interval = PROC_TOP_DEFAULT_INTERVAL;
+
+	g_kernquery_task_get_data* tasksBefore;
+	uint32_t tasksBeforeCount;
+	proc_top_cpu* cpusBefore;
+	uint32_t cpuCount;
+	if(!procQueryTasks(&tasksBefore, &tasksBeforeCount) || !procTopQueryCpus(&cpusBefore, &cpuCount))
+		return -1;
+
+	do
+	{
+		g_sleep(interval);
+
+		g_kernquery_task_get_data* tasksAfter;
+		uint32_t tasksAfterCount;
+		proc_top_cpu* cpusAfter;
+		if(!procQueryTasks(&tasksAfter, &tasksAfterCount) || !procTopQueryCpus(&cpusAfter, &cpuCount))
+			return -1;
+
+		// The elapsed time is taken from the processors so that the usage adds up
+		uint64_t elapsed = (cpusAfter[0].busy + cpusAfter[0].idle) - (cpusBefore[0].busy + cpusBefore[0].idle);
+
+		if(watch)
+			printf("\x1b[2J\x1b[0;0f");
+		procTopPrintSummary(cpusBefore, cpusAfter, cpuCount);
+		procTopPrintTasks(tasksBefore, tasksBeforeCount, tasksAfter, tasksAfterCount, elapsed, threads);
+
+		delete[] tasksBefore;
+		delete[] cpusBefore;
+		tasksBefore = tasksAfter;
+		tasksBeforeCount = tasksAfterCount;
+		cpusBefore = cpusAfter;
+	} while(watch);
+
+	delete[] tasksBefore;
+	delete[] cpusBefore;
+	return 0;
+}
@@ -0,0 +1,261 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <ghost.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAJOR 0
+#define MINOR 1
+#define PATCH 0
+
+/**
+ * Prefixes of the lines written to the kernel log by the "serial" command,
+ * recognized by the host-side symbolizer.
+ */
+#define PROFILE_SERIAL_HEADER_PREFIX "gprofile-header:"
+#define PROFILE_SERIAL_MODULE_PREFIX "gprofile-module:"
+#define PROFILE_SERIAL_SAMPLE_PREFIX "gprofile:"
+
+/**
+ * Maximum number of samples read per processor and modules read per process.
+ */
+#define PROFILE_READ_CAPACITY 4096
+#define PROFILE_MODULE_CAPACITY 64
+
+/**
+ * Default number of timer ticks between two samples.
+ */
+#define PROFILE_DEFAULT_INTERVAL 1
+
+enum profile_record_t
+{
+	PROFILE_RECORD_HEADER,
+	PROFILE_RECORD_MODULE,
+	PROFILE_RECORD_SAMPLE
+};
+
+typedef void (*profile_output_t)(void* context, const void* data, uint32_t length, profile_record_t type);
+
+static uint32_t profileInterval = PROFILE_DEFAULT_INTERVAL;
+
+bool profileCheck(g_profiler_status status)
+{
+	if(status == G_PROFILER_STATUS_NOT_AVAILABLE)
+	{
+		fprintf(stderr, "the kernel was built without the profiler\n");
+		return false;
+	}
+	if(status != G_PROFILER_STATUS_SUCCESSFUL)
+	{
+		fprintf(stderr, "profiler call failed with status %i\n", status);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Collects the loaded objects of each process that was sampled in userspace. Processes
+ * that have exited since can not be resolved anymore and are skipped.
+ */
+uint32_t profileCollectModules(g_profiler_sample* samples, uint32_t sampleCount, g_profiler_module** outModules)
+{
+	uint32_t capacity = PROFILE_MODULE_CAPACITY;
+	uint32_t total = 0;
+	g_profiler_module* modules = (g_profiler_module*) malloc(sizeof(g_profiler_module) * capacity);
+
+	for(uint32_t i = 0; i < sampleCount; i++)
+	{
+		if(samples[i].kernel)
+			continue;
+
+		int32_t process = samples[i].process;
+		bool known = false;
+		for(uint32_t j = 0; j < i && !known; j++)
+			known = !samples[j].kernel && samples[j].process == process;
+		if(known)
+			continue;
+
+		if(total + PROFILE_MODULE_CAPACITY > capacity)
+		{
+			capacity *= 2;
+			modules = (g_profiler_module*) realloc(modules, sizeof(g_profiler_module) * capacity);
+		}
+
+		uint32_t count;
+		if(g_profiler_modules(process, &modules[total], PROFILE_MODULE_CAPACITY, &count) == G_PROFILER_STATUS_SUCCESSFUL)
+			total += count;
+		else
+			fprintf(stderr, "process %i has exited, its samples can not be symbolized\n", process);
+	}
+
+	*outModules = modules;
+	return total;
+}
+
+/**
+ * Stops the profiler and passes the header, the modules and the samples of all processors to the output.
+ */
+int profileDump(profile_output_t output, void* context)
+{
+	uint32_t processors;
+	uint32_t ticksPerMicrosecond;
+	if(!profileCheck(g_profiler_control(G_PROFILER_COMMAND_STOP)) || !profileCheck(g_profiler_info(&processors, &ticksPerMicrosecond)))
+		return -1;
+
+	g_profiler_sample* samples = new g_profiler_sample[PROFILE_READ_CAPACITY * processors];
+	uint32_t total = 0;
+	for(uint32_t processor = 0; processor < processors; processor++)
+	{
+		uint32_t count;
+		uint32_t dropped;
+		if(!profileCheck(g_profiler_read(processor, &samples[total], PROFILE_READ_CAPACITY, &count, &dropped)))
+		{
+			delete[] samples;
+			return -1;
+		}
+		if(dropped)
+			fprintf(stderr, "processor %i: %i samples were overwritten\n", processor, dropped);
+		total += count;
+	}
+
+	g_profiler_module* modules;
+	uint32_t moduleCount = profileCollectModules(samples, total, &modules);
+
+	g_profiler_dump_header header;
+	header.magic = G_PROFILER_DUMP_MAGIC;
+	header.version = G_PROFILER_DUMP_VERSION;
+	header.interval = profileInterval;
+	header.ticks_per_microsecond = ticksPerMicrosecond;
+	header.module_count = moduleCount;
+	header.sample_count = total;
+	output(context, &header, sizeof(header), PROFILE_RECORD_HEADER);
+	for(uint32_t i = 0; i < moduleCount; i++)
+		output(context, &modules[i], sizeof(g_profiler_module), PROFILE_RECORD_MODULE);
+	for(uint32_t i = 0; i < total; i++)
+		output(context, &samples[i], sizeof(g_profiler_sample), PROFILE_RECORD_SAMPLE);
+
+	println("dumped %i samples of %i processors and %i modules", total, processors, moduleCount);
+	free(modules);
+	delete[] samples;
+	return 0;
+}
+
+void profileOutputFile(void* context, const void* data, uint32_t length, profile_record_t type)
+{
+	fwrite(data, 1, length, (FILE*) context);
+}
+
+void profileOutputSerial(void* context, const void* data, uint32_t length, profile_record_t type)
+{
+	static const char* digits = "0123456789abcdef";
+
+	char line[64 + sizeof(g_profiler_module) * 2];
+	const char* prefix = type == PROFILE_RECORD_HEADER ? PROFILE_SERIAL_HEADER_PREFIX : (type == PROFILE_RECORD_MODULE ? PROFILE_SERIAL_MODULE_PREFIX : PROFILE_SERIAL_SAMPLE_PREFIX);
+	uint32_t pos = strlen(prefix);
+	memcpy(line, prefix, pos);
+
+	const uint8_t* bytes = (const uint8_t*) data;
+	for(uint32_t i = 0; i < length; i++)
+	{
+		line[pos++] = digits[bytes[i] >> 4];
+		line[pos++] = digits[bytes[i] & 0xF];
+	}
+	line[pos] = 0;
+	g_log(line);
+}
+
+/**
+ *
+ */
+int main(int argc, char** argv)
+{
+	const char* command = argc > 1 ? argv[1] : "--help";
+
+	if(strcmp(command, "start") == 0)
+	{
+		uint32_t interval = argc > 2 ? atoi(argv[2]) : PROFILE_DEFAULT_INTERVAL;
+		return profileCheck(g_profiler_start(interval)) ? 0 : -1;
+	}
+	else if(strcmp(command, "stop") == 0)
+	{
+		return profileCheck(g_profiler_control(G_PROFILER_COMMAND_STOP)) ? 0 : -1;
+	}
+	else if(strcmp(command, "reset") == 0)
+	{
+		return profileCheck(g_profiler_control(G_PROFILER_COMMAND_RESET)) ? 0 : -1;
+	}
+	else if(strcmp(command, "record") == 0 && argc > 3)
+	{
+		// Dumps right away, so that the sampled processes are still alive for symbolization
+		if(argc > 4)
+			profileInterval = atoi(argv[4]);
+		if(!profileCheck(g_profiler_control(G_PROFILER_COMMAND_RESET)) || !profileCheck(g_profiler_start(profileInterval)))
+			return -1;
+		g_sleep(atoi(argv[2]));
+
+		if(strcmp(argv[3], "serial") == 0)
+			return profileDump(profileOutputSerial, nullptr);
+
+		FILE* file = fopen(argv[3], "w");
+		if(!file)
+		{
+			g_profiler_control(G_PROFILER_COMMAND_STOP);
+			fprintf(stderr, "failed to open %s\n", argv[3]);
+			return -1;
+		}
+		int result = profileDump(profileOutputFile, file);
+		fclose(file);
+		return result;
+	}
+	else if(strcmp(command, "dump") == 0 && argc > 2)
+	{
+		FILE* file = fopen(argv[2], "w");
+		if(!file)
+		{
+			fprintf(stderr, "failed to open %s\n", argv[2]);
+			return -1;
+		}
+		int result = profileDump(profileOutputFile, file);
+		fclose(file);
+		return result;
+	}
+	else if(strcmp(command, "serial") == 0)
+	{
+		return profileDump(profileOutputSerial, nullptr);
+	}
+
+	println("profile, v%i.%i.%i", MAJOR, MINOR, PATCH);
+	println("Sampling profiler for kernel and userspace code");
+	println("");
+	println("The following commands are available:");
+	println("");
+	println("\tstart [ticks]\t\tstarts sampling every given number of timer ticks");
+	println("\tstop\t\t\tstops sampling");
+	println("\treset\t\t\tclears the recorded samples");
+	println("\trecord <ms> <file> [ticks]\tsamples for the given time and dumps to a file,");
+	println("\t\t\t\tor to the kernel log if the file is 'serial'");
+	println("\tdump <file>\t\tstops sampling and writes the samples to a file");
+	println("\tserial\t\t\tstops sampling and writes the samples to the kernel log");
+	println("");
+	println("Dumps are turned into folded stacks with the host tool 'profile-symbolize'.");
+	return 0;
+}
@@ -0,0 +1,117 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "tester.hpp"
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#define FILE_IO_TEST_FILE "/file-io-test.tmp"
+
+static g_fd fileIoTestCreateFile()
+{
+	g_fd fd = g_open_f(FILE_IO_TEST_FILE, G_FILE_FLAG_MODE_READ | G_FILE_FLAG_MODE_WRITE | G_FILE_FLAG_MODE_CREATE | G_FILE_FLAG_MODE_TRUNCATE);
+	if(fd != G_FD_NONE)
+		g_write(fd, "0123456789", 10);
+	return fd;
+}
+
+test_result_t fileIoTestPositional()
+{
+	g_fd fd = fileIoTestCreateFile();
+	ASSERT(fd != G_FD_NONE);
+
+	// Descriptor offset stays at the end of the previous write
+	char buffer[8];
+	ASSERT(pread(fd, buffer, 4, 3) == 4);
+	ASSERT(memcmp(buffer, "3456", 4) == 0);
+	ASSERT(g_tell(fd) == 10);
+
+	ASSERT(pwrite(fd, "ab", 2, 1) == 2);
+	ASSERT(g_tell(fd) == 10);
+	ASSERT(pread(fd, buffer, 4, 0) == 4);
+	ASSERT(memcmp(buffer, "0ab3", 4) == 0);
+
+	// Reading past the end returns EOF, writing past the end fills the gap
+	ASSERT(pread(fd, buffer, 4, 100) == 0);
+	ASSERT(pwrite(fd, "x", 1, 12) == 1);
+	ASSERT(pread(fd, buffer, 3, 10) == 3);
+	ASSERT(buffer[0] == 0 && buffer[1] == 0 && buffer[2] == 'x');
+
+	ASSERT(pread(fd, buffer, 1, -1) == -1);
+	g_close(fd);
+	TEST_SUCCESSFUL;
+}
+
+test_result_t fileIoTestVector()
+{
+	g_fd fd = fileIoTestCreateFile();
+	ASSERT(fd != G_FD_NONE);
+
+	char first[3] = {'a', 'b', 'c'};
+	char second[2] = {'d', 'e'};
+	struct iovec vector[3];
+	vector[0].iov_base = first;
+	vector[0].iov_len = 3;
+	vector[1].iov_base = nullptr;
+	vector[1].iov_len = 0;
+	vector[2].iov_base = second;
+	vector[2].iov_len = 2;
+	ASSERT(writev(fd, vector, 3) == 5);
+	ASSERT(g_tell(fd) == 15);
+
+	char a[4];
+	char b[20];
+	vector[0].iov_base = a;
+	vector[0].iov_len = 4;
+	vector[1].iov_base = b;
+	vector[1].iov_len = 20;
+	g_seek(fd, 8, G_FS_SEEK_SET);
+
+	// Stops at the end of the file within the second segment
+	ASSERT(readv(fd, vector, 2) == 7);
+	ASSERT(memcmp(a, "89ab", 4) == 0);
+	ASSERT(memcmp(b, "cde", 3) == 0);
+	ASSERT(g_tell(fd) == 15);
+
+	// Positional vectors leave the descriptor offset untouched
+	g_fs_iovec segment;
+	segment.base = a;
+	segment.length = 2;
+	ASSERT(g_read_vector_s(fd, &segment, 1, 0, nullptr) == 2);
+	ASSERT(memcmp(a, "01", 2) == 0);
+	ASSERT(g_tell(fd) == 15);
+
+	ASSERT(readv(fd, vector, 0) == -1);
+	ASSERT(g_read_vector(fd, &segment, G_FS_IOVEC_MAX + 1) == -1);
+	g_close(fd);
+	TEST_SUCCESSFUL;
+}
+
+test_result_t runFileIoTests()
+{
+	test_result_t result;
+	result += fileIoTestPositional();
+	result += fileIoTestVector();
+
+	g_unlink(FILE_IO_TEST_FILE);
+	return result;
+}
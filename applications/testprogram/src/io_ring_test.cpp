@@ -0,0 +1,149 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "tester.hpp"
+
+#include <string.h>
+
+static g_io_submission* ioRingTestSubmission(g_io_ring* ring, uint8_t opcode, uint64_t userData)
+{
+	g_io_submission* submission = g_io_ring_get_submission(ring);
+	if(submission)
+	{
+		submission->opcode = opcode;
+		submission->user_data = userData;
+	}
+	return submission;
+}
+
+test_result_t ioRingTestFile()
+{
+	g_io_ring ring;
+	ASSERT(g_io_ring_create(8, &ring) == G_IO_RING_STATUS_SUCCESSFUL);
+
+	g_io_submission* open = ioRingTestSubmission(&ring, G_IO_OP_OPEN, 1);
+	open->buffer = (void*) "/io-ring-test.tmp";
+	open->flags = G_FILE_FLAG_MODE_READ | G_FILE_FLAG_MODE_WRITE | G_FILE_FLAG_MODE_CREATE | G_FILE_FLAG_MODE_TRUNCATE;
+	ASSERT(g_io_ring_submit(&ring, 1) == 1);
+
+	g_io_completion* completion = g_io_ring_peek_completion(&ring);
+	ASSERT(completion->user_data == 1 && completion->status == G_IO_STATUS_SUCCESSFUL);
+	g_fd fd = completion->result;
+	g_io_ring_advance_completion(&ring);
+
+	// Operations are executed in submission order
+	g_io_submission* write = ioRingTestSubmission(&ring, G_IO_OP_WRITE, 2);
+	write->fd = fd;
+	write->buffer = (void*) "0123456789";
+	write->length = 10;
+	write->offset = G_IO_OFFSET_CURRENT;
+
+	char buffer[4];
+	g_io_submission* read = ioRingTestSubmission(&ring, G_IO_OP_READ, 3);
+	read->fd = fd;
+	read->buffer = buffer;
+	read->length = 4;
+	read->offset = 3;
+
+	g_io_submission* invalid = ioRingTestSubmission(&ring, G_IO_OP_READ, 4);
+	invalid->fd = -1;
+	invalid->buffer = buffer;
+	invalid->length = 4;
+
+	ASSERT(g_io_ring_submit(&ring, 3) == 3);
+	for(uint64_t expected = 2; expected <= 4; expected++)
+	{
+		completion = g_io_ring_peek_completion(&ring);
+		ASSERT(completion->user_data == expected);
+		if(expected == 4)
+		{
+			ASSERT(completion->status == G_IO_STATUS_INVALID_FD);
+		}
+		else
+		{
+			ASSERT(completion->status == G_IO_STATUS_SUCCESSFUL);
+			ASSERT(completion->result == (expected == 2 ? 10 : 4));
+		}
+		g_io_ring_advance_completion(&ring);
+	}
+	ASSERT(memcmp(buffer, "3456", 4) == 0);
+	ASSERT(g_tell(fd) == 10);
+
+	ioRingTestSubmission(&ring, G_IO_OP_CLOSE, 5)->fd = fd;
+	ASSERT(g_io_ring_submit(&ring, 1) == 1);
+	ASSERT(g_io_ring_peek_completion(&ring)->status == G_IO_STATUS_SUCCESSFUL);
+	g_io_ring_advance_completion(&ring);
+
+	ASSERT(g_io_ring_destroy(&ring) == G_IO_RING_STATUS_SUCCESSFUL);
+	TEST_SUCCESSFUL;
+}
+
+test_result_t ioRingTestPipeAndTimeout()
+{
+	g_io_ring ring;
+	ASSERT(g_io_ring_create(4, &ring) == G_IO_RING_STATUS_SUCCESSFUL);
+
+	g_fd pipeWrite;
+	g_fd pipeRead;
+	ASSERT(g_pipe(&pipeWrite, &pipeRead) == G_FS_PIPE_SUCCESSFUL);
+
+	// The read waits for data without blocking the submitting task
+	char buffer[3];
+	g_io_submission* read = ioRingTestSubmission(&ring, G_IO_OP_READ, 1);
+	read->fd = pipeRead;
+	read->buffer = buffer;
+	read->length = 3;
+	read->offset = G_IO_OFFSET_CURRENT;
+	ASSERT(g_io_ring_submit(&ring, 0) == 0);
+
+	g_io_ring_status status;
+	ASSERT(g_io_ring_submit_s(&ring, 1, 20, &status) == 0);
+	ASSERT(status == G_IO_RING_STATUS_TIMED_OUT);
+
+	ASSERT(g_write(pipeWrite, "abc", 3) == 3);
+	ASSERT(g_io_ring_submit(&ring, 1) == 1);
+	g_io_completion* completion = g_io_ring_peek_completion(&ring);
+	ASSERT(completion->user_data == 1 && completion->result == 3);
+	ASSERT(memcmp(buffer, "abc", 3) == 0);
+	g_io_ring_advance_completion(&ring);
+
+	ioRingTestSubmission(&ring, G_IO_OP_TIMEOUT, 2)->offset = 10;
+	uint64_t start = g_millis();
+	ASSERT(g_io_ring_submit(&ring, 1) == 1);
+	ASSERT(g_millis() - start >= 10);
+	ASSERT(g_io_ring_peek_completion(&ring)->status == G_IO_STATUS_TIMED_OUT);
+	g_io_ring_advance_completion(&ring);
+
+	g_close(pipeWrite);
+	g_close(pipeRead);
+	ASSERT(g_io_ring_destroy(&ring) == G_IO_RING_STATUS_SUCCESSFUL);
+	ASSERT(g_io_ring_destroy(&ring) == G_IO_RING_STATUS_INVALID_RING);
+	TEST_SUCCESSFUL;
+}
+
+test_result_t runIoRingTests()
+{
+	test_result_t result;
+	result += ioRingTestFile();
+	result += ioRingTestPipeAndTimeout();
+
+	g_unlink("/io-ring-test.tmp");
+	return result;
+}
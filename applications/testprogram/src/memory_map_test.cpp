@@ -0,0 +1,198 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "tester.hpp"
+
+#include <string.h>
+#include <sys/mman.h>
+
+#define MEMORY_MAP_TEST_FILE "/memory-map-test.tmp"
+#define MEMORY_MAP_TEST_SIZE (3 * G_PAGE_SIZE + 100)
+
+static uint8_t memoryMapTestPattern(uint32_t position)
+{
+	return (position * 7 + position / G_PAGE_SIZE) & 0xFF;
+}
+
+static bool memoryMapTestCreateFile()
+{
+	g_fd fd = g_open_f(MEMORY_MAP_TEST_FILE, G_FILE_FLAG_MODE_WRITE | G_FILE_FLAG_MODE_CREATE | G_FILE_FLAG_MODE_TRUNCATE);
+	if(fd == G_FD_NONE)
+		return false;
+
+	uint8_t buffer[MEMORY_MAP_TEST_SIZE];
+	for(uint32_t i = 0; i < MEMORY_MAP_TEST_SIZE; i++)
+		buffer[i] = memoryMapTestPattern(i);
+
+	bool written = g_write(fd, buffer, MEMORY_MAP_TEST_SIZE) == MEMORY_MAP_TEST_SIZE;
+	g_close(fd);
+	return written;
+}
+
+static uint8_t memoryMapTestReadByte(uint32_t position)
+{
+	g_fd fd = g_open(MEMORY_MAP_TEST_FILE);
+	g_seek(fd, position, G_FS_SEEK_SET);
+	uint8_t value = 0;
+	g_read(fd, &value, 1);
+	g_close(fd);
+	return value;
+}
+
+test_result_t memoryMapTestAnonymous()
+{
+	uint8_t* memory = (uint8_t*) mmap(nullptr, 2 * G_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	ASSERT(memory != MAP_FAILED);
+
+	for(uint32_t i = 0; i < 2 * G_PAGE_SIZE; i++)
+		ASSERT(memory[i] == 0);
+
+	memory[0] = 1;
+	memory[2 * G_PAGE_SIZE - 1] = 2;
+	ASSERT(memory[0] == 1 && memory[2 * G_PAGE_SIZE - 1] == 2);
+
+	ASSERT(munmap(memory, 2 * G_PAGE_SIZE) == 0);
+	ASSERT(munmap(memory, 2 * G_PAGE_SIZE) == -1);
+	TEST_SUCCESSFUL;
+}
+
+test_result_t memoryMapTestReadIntoMapping()
+{
+	ASSERT(memoryMapTestCreateFile());
+
+	// The pages are first touched by the kernel while it executes the read
+	uint8_t* memory = (uint8_t*) mmap(nullptr, MEMORY_MAP_TEST_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	ASSERT(memory != MAP_FAILED);
+
+	g_fd fd = g_open(MEMORY_MAP_TEST_FILE);
+	int32_t read = g_read(fd, memory, MEMORY_MAP_TEST_SIZE);
+	g_close(fd);
+	ASSERT(read == MEMORY_MAP_TEST_SIZE);
+
+	for(uint32_t i = 0; i < MEMORY_MAP_TEST_SIZE; i++)
+		ASSERT(memory[i] == memoryMapTestPattern(i));
+
+	ASSERT(munmap(memory, MEMORY_MAP_TEST_SIZE) == 0);
+	TEST_SUCCESSFUL;
+}
+
+test_result_t memoryMapTestPrivateFile()
+{
+	ASSERT(memoryMapTestCreateFile());
+
+	g_fd fd = g_open(MEMORY_MAP_TEST_FILE);
+	uint8_t* memory = (uint8_t*) mmap(nullptr, MEMORY_MAP_TEST_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	g_close(fd);
+	ASSERT(memory != MAP_FAILED);
+
+	// Content matches, the rest of the last page is zero
+	for(uint32_t i = 0; i < MEMORY_MAP_TEST_SIZE; i++)
+		ASSERT(memory[i] == memoryMapTestPattern(i));
+	for(uint32_t i = MEMORY_MAP_TEST_SIZE; i < G_PAGE_ALIGN_UP(MEMORY_MAP_TEST_SIZE); i++)
+		ASSERT(memory[i] == 0);
+
+	// Writes stay private
+	uint8_t original = memory[10];
+	memory[10] = original + 1;
+	ASSERT(munmap(memory, MEMORY_MAP_TEST_SIZE) == 0);
+	ASSERT(memoryMapTestReadByte(10) == original);
+	TEST_SUCCESSFUL;
+}
+
+test_result_t memoryMapTestSharedFile()
+{
+	ASSERT(memoryMapTestCreateFile());
+
+	g_fd fd = g_open_f(MEMORY_MAP_TEST_FILE, G_FILE_FLAG_MODE_READ | G_FILE_FLAG_MODE_WRITE);
+	uint8_t* memory = (uint8_t*) mmap(nullptr, MEMORY_MAP_TEST_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	g_close(fd);
+	ASSERT(memory != MAP_FAILED);
+
+	uint8_t original = memory[G_PAGE_SIZE + 5];
+	memory[G_PAGE_SIZE + 5] = original + 1;
+
+	// Modified pages are written back when unmapping
+	ASSERT(munmap(memory, MEMORY_MAP_TEST_SIZE) == 0);
+	ASSERT(memoryMapTestReadByte(G_PAGE_SIZE + 5) == (uint8_t) (original + 1));
+	ASSERT(memoryMapTestReadByte(G_PAGE_SIZE + 6) == memoryMapTestPattern(G_PAGE_SIZE + 6));
+	TEST_SUCCESSFUL;
+}
+
+test_result_t memoryMapTestOffset()
+{
+	ASSERT(memoryMapTestCreateFile());
+
+	g_fd fd = g_open(MEMORY_MAP_TEST_FILE);
+	uint8_t* memory = (uint8_t*) mmap(nullptr, G_PAGE_SIZE, PROT_READ, MAP_PRIVATE, fd, 2 * G_PAGE_SIZE);
+	g_close(fd);
+	ASSERT(memory != MAP_FAILED);
+
+	for(uint32_t i = 0; i < G_PAGE_SIZE; i++)
+		ASSERT(memory[i] == memoryMapTestPattern(2 * G_PAGE_SIZE + i));
+
+	ASSERT(munmap(memory, G_PAGE_SIZE) == 0);
+	TEST_SUCCESSFUL;
+}
+
+test_result_t memoryMapTestInvalid()
+{
+	ASSERT(memoryMapTestCreateFile());
+
+	g_fd fd = g_open(MEMORY_MAP_TEST_FILE);
+	g_memory_map_status status;
+
+	g_memory_map_s(G_PAGE_SIZE, PROT_READ, MAP_PRIVATE, fd, 100, &status);
+	ASSERT(status == G_MEMORY_MAP_STATUS_INVALID_ARGUMENTS);
+
+	g_memory_map_s(G_PAGE_SIZE, PROT_READ, MAP_PRIVATE | MAP_SHARED, fd, 0, &status);
+	ASSERT(status == G_MEMORY_MAP_STATUS_INVALID_ARGUMENTS);
+
+	g_memory_map_s(0, PROT_READ, MAP_PRIVATE, fd, 0, &status);
+	ASSERT(status == G_MEMORY_MAP_STATUS_INVALID_ARGUMENTS);
+
+	g_memory_map_s(G_PAGE_SIZE, PROT_READ, MAP_PRIVATE, 12345, 0, &status);
+	ASSERT(status == G_MEMORY_MAP_STATUS_INVALID_FD);
+
+	// File is not open for writing
+	g_memory_map_s(G_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0, &status);
+	ASSERT(status == G_MEMORY_MAP_STATUS_ACCESS_DENIED);
+
+	g_close(fd);
+
+	void* memory = mmap(nullptr, G_PAGE_SIZE, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	ASSERT(memory != MAP_FAILED);
+	ASSERT(g_memory_unmap(memory, 2 * G_PAGE_SIZE) == G_MEMORY_MAP_STATUS_INVALID_ARGUMENTS);
+	ASSERT(munmap(memory, G_PAGE_SIZE) == 0);
+	TEST_SUCCESSFUL;
+}
+
+test_result_t runMemoryMapTests()
+{
+	test_result_t result;
+	result += memoryMapTestAnonymous();
+	result += memoryMapTestReadIntoMapping();
+	result += memoryMapTestPrivateFile();
+	result += memoryMapTestSharedFile();
+	result += memoryMapTestOffset();
+	result += memoryMapTestInvalid();
+
+	g_unlink(MEMORY_MAP_TEST_FILE);
+	return result;
+}
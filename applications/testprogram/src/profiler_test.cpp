@@ -0,0 +1,116 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+#include "tester.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define PROFILER_TEST_DURATION 300
+#define PROFILER_TEST_READ_CAPACITY 4096
+#define PROFILER_TEST_MODULE_CAPACITY 64
+
+static volatile uint32_t profilerTestValue;
+static void* volatile profilerTestSpinReturn;
+
+/**
+ * Busy function that samples should mostly land in; remembers where it returns
+ * to so the walked frames of the samples can be checked.
+ */
+__attribute__((noinline)) static void profilerTestSpin()
+{
+	profilerTestSpinReturn = __builtin_return_address(0);
+	for(uint32_t i = 0; i < 100000; i++)
+		profilerTestValue = profilerTestValue * 31 + i;
+}
+
+void profilerTestHotLoop(uint32_t milliseconds)
+{
+	uint64_t end = g_millis() + milliseconds;
+	while(g_millis() < end)
+		profilerTestSpin();
+}
+
+test_result_t profilerTestSampling()
+{
+	g_profiler_status status = g_profiler_control(G_PROFILER_COMMAND_RESET);
+	if(status == G_PROFILER_STATUS_NOT_AVAILABLE)
+	{
+		klog("profiler not available, skipping test");
+		TEST_SUCCESSFUL;
+	}
+	ASSERT(status == G_PROFILER_STATUS_SUCCESSFUL);
+
+	ASSERT(g_profiler_start(1) == G_PROFILER_STATUS_SUCCESSFUL);
+	profilerTestHotLoop(PROFILER_TEST_DURATION);
+	ASSERT(g_profiler_control(G_PROFILER_COMMAND_STOP) == G_PROFILER_STATUS_SUCCESSFUL);
+
+	uint32_t processors;
+	ASSERT(g_profiler_info(&processors, nullptr) == G_PROFILER_STATUS_SUCCESSFUL);
+	ASSERT(processors > 0);
+
+	// Count the samples of this thread and those taken within the hot loop
+	g_tid self = g_get_tid();
+	uint32_t own = 0;
+	uint32_t inHotLoop = 0;
+	g_profiler_sample* samples = (g_profiler_sample*) malloc(sizeof(g_profiler_sample) * PROFILER_TEST_READ_CAPACITY);
+	for(uint32_t processor = 0; processor < processors; processor++)
+	{
+		uint32_t count;
+		ASSERT(g_profiler_read(processor, samples, PROFILER_TEST_READ_CAPACITY, &count, nullptr) == G_PROFILER_STATUS_SUCCESSFUL);
+		for(uint32_t i = 0; i < count; i++)
+		{
+			if(samples[i].task != self)
+				continue;
+			own++;
+			ASSERT(samples[i].depth >= 1 && samples[i].depth <= G_PROFILER_MAX_FRAMES);
+			if(!samples[i].kernel && samples[i].depth >= 2 && samples[i].frames[1] == (uint32_t) profilerTestSpinReturn)
+				inHotLoop++;
+		}
+	}
+	free(samples);
+	klog("profiler sampled the test %i times, %i in the hot loop", own, inHotLoop);
+	ASSERT(own > 0);
+	ASSERT(inHotLoop * 2 >= own);
+
+	// The executable must be listed with the range containing the hot loop
+	g_profiler_module modules[PROFILER_TEST_MODULE_CAPACITY];
+	uint32_t moduleCount;
+	ASSERT(g_profiler_modules(g_get_pid(), modules, PROFILER_TEST_MODULE_CAPACITY, &moduleCount) == G_PROFILER_STATUS_SUCCESSFUL);
+	bool found = false;
+	for(uint32_t i = 0; i < moduleCount; i++)
+	{
+		uint32_t address = (uint32_t) profilerTestSpinReturn;
+		if(address >= modules[i].start && address < modules[i].end)
+			found = strstr(modules[i].name, "tester") != nullptr;
+	}
+	ASSERT(found);
+
+	ASSERT(g_profiler_control(G_PROFILER_COMMAND_RESET) == G_PROFILER_STATUS_SUCCESSFUL);
+	TEST_SUCCESSFUL;
+}
+
+test_result_t runProfilerTests()
+{
+	test_result_t result;
+	result += profilerTestSampling();
+	return result;
+}
@@ -25,6 +25,7 @@
 #include <libgen.h>
 #include <malloc.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <libps2driver/ps2driver.hpp>
@@ -144,8 +145,29 @@ void mouseReceiverThread()
 	}
 }
 
+int runTests()
+{
+	test_result_t result;
+	result += runMemoryMapTests();
+	result += runFileIoTests();
+	result += runIoRingTests();
+	result += runTmpfsTests();
+	result += runProfilerTests();
+
+	klog("tests finished: %i successful, %i failed", result.successful, result.failed);
+	return result.failed == 0 ? 0 : -1;
+}
+
 int main(int argc, char** argv)
 {
+	if(argc > 1 && strcmp(argv[1], "--tests") == 0)
+		return runTests();
+	if(argc > 2 && strcmp(argv[1], "--hotloop") == 0)
+	{
+		profilerTestHotLoop(atoi(argv[2]));
+		return 0;
+	}
+
 	// Init VBE
 	klog("calling video driver to set mode");
 	vbeDriverSetMode(1024, 768, 32, video_mode_information);
@@ -62,3 +62,18 @@ test_result_t runMessageTest();
 test_result_t runStdioTest();
 
 test_result_t runThreadTests();
+
+test_result_t runMemoryMapTests();
+
+test_result_t runFileIoTests();
+
+test_result_t runIoRingTests();
+
+test_result_t runTmpfsTests();
+
+test_result_t runProfilerTests();
+
+/**
+ * Spins in a known function for the given time, used to validate the profiler.
+ */
+void profilerTestHotLoop(uint32_t milliseconds);
@@ -0,0 +1,131 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "tester.hpp"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TMPFS_TEST_FILE "/tmp/tmpfs-test"
+#define TMPFS_TEST_HOLE (1024 * 1024 + 10)
+#define TMPFS_TEST_CHUNK_SIZE 65536
+
+static g_fd tmpfsTestCreateFile()
+{
+	return g_open_f(TMPFS_TEST_FILE, G_FILE_FLAG_MODE_READ | G_FILE_FLAG_MODE_WRITE | G_FILE_FLAG_MODE_CREATE | G_FILE_FLAG_MODE_TRUNCATE);
+}
+
+test_result_t tmpfsTestSparse()
+{
+	g_fd fd = tmpfsTestCreateFile();
+	ASSERT(fd != G_FD_NONE);
+
+	ASSERT(write(fd, "abc", 3) == 3);
+	ASSERT(pwrite(fd, "x", 1, TMPFS_TEST_HOLE) == 1);
+	ASSERT(g_length(fd) == TMPFS_TEST_HOLE + 1);
+
+	// Holes within and across pages read as zeroes
+	char buffer[8];
+	ASSERT(pread(fd, buffer, 4, 0) == 4);
+	ASSERT(memcmp(buffer, "abc", 4) == 0);
+	memset(buffer, 1, sizeof(buffer));
+	ASSERT(pread(fd, buffer, 8, 512 * 1024) == 8);
+	for(int i = 0; i < 8; i++)
+		ASSERT(buffer[i] == 0);
+	ASSERT(pread(fd, buffer, 8, TMPFS_TEST_HOLE - 1) == 2);
+	ASSERT(buffer[0] == 0 && buffer[1] == 'x');
+
+	// Truncating drops the content
+	g_close(fd);
+	fd = tmpfsTestCreateFile();
+	ASSERT(g_length(fd) == 0);
+	g_close(fd);
+	TEST_SUCCESSFUL;
+}
+
+test_result_t tmpfsTestUnlink()
+{
+	g_fd fd = tmpfsTestCreateFile();
+	ASSERT(fd != G_FD_NONE);
+	ASSERT(write(fd, "content", 7) == 7);
+
+	// The content stays readable through open descriptors
+	ASSERT(unlink(TMPFS_TEST_FILE) == 0);
+	g_fs_open_status status;
+	g_open_fs(TMPFS_TEST_FILE, G_FILE_FLAG_MODE_READ, &status);
+	ASSERT(status == G_FS_OPEN_NOT_FOUND);
+
+	char buffer[8];
+	ASSERT(pread(fd, buffer, 7, 0) == 7);
+	ASSERT(memcmp(buffer, "content", 7) == 0);
+
+	// A new file with the same name is independent
+	g_fd other = tmpfsTestCreateFile();
+	ASSERT(other != G_FD_NONE);
+	ASSERT(g_length(other) == 0);
+	g_close(other);
+	g_close(fd);
+
+	ASSERT(unlink(TMPFS_TEST_FILE) == 0);
+	ASSERT(unlink(TMPFS_TEST_FILE) == -1 && errno == ENOENT);
+	ASSERT(g_unlink("/tmp") == G_FS_UNLINK_NOT_SUPPORTED);
+	ASSERT(remove("/applications/tester.bin") == -1 && errno == EPERM);
+	TEST_SUCCESSFUL;
+}
+
+test_result_t tmpfsTestLimit()
+{
+	g_fd fd = tmpfsTestCreateFile();
+	ASSERT(fd != G_FD_NONE);
+
+	uint8_t* buffer = (uint8_t*) malloc(TMPFS_TEST_CHUNK_SIZE);
+	memset(buffer, 'x', TMPFS_TEST_CHUNK_SIZE);
+
+	// Fill the tmpfs until the limit is reached
+	uint64_t total = 0;
+	ssize_t wrote;
+	while((wrote = write(fd, buffer, TMPFS_TEST_CHUNK_SIZE)) > 0)
+		total += wrote;
+	ASSERT(wrote == -1 && errno == ENOSPC);
+	ASSERT(total > 0 && g_length(fd) == (int64_t) total);
+	g_close(fd);
+
+	// Unlinking the closed file frees its memory
+	ASSERT(unlink(TMPFS_TEST_FILE) == 0);
+	fd = tmpfsTestCreateFile();
+	ASSERT(write(fd, buffer, TMPFS_TEST_CHUNK_SIZE) == TMPFS_TEST_CHUNK_SIZE);
+	g_close(fd);
+
+	free(buffer);
+	TEST_SUCCESSFUL;
+}
+
+test_result_t runTmpfsTests()
+{
+	test_result_t result;
+	result += tmpfsTestSparse();
+	result += tmpfsTestUnlink();
+	result += tmpfsTestLimit();
+
+	g_unlink(TMPFS_TEST_FILE);
+	return result;
+}
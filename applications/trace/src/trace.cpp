@@ -0,0 +1,180 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <ghost.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAJOR 0
+#define MINOR 1
+#define PATCH 0
+
+/**
+ * Prefixes of the lines written to the kernel log by the "serial" command,
+ * recognized by the host-side trace converter.
+ */
+#define TRACE_SERIAL_HEADER_PREFIX "gtrace-header:"
+#define TRACE_SERIAL_EVENT_PREFIX "gtrace:"
+
+/**
+ * Maximum number of events read per processor.
+ */
+#define TRACE_READ_CAPACITY 8192
+
+typedef void (*trace_output_t)(void* context, const void* data, uint32_t length, bool header);
+
+bool traceCheck(g_trace_status status)
+{
+	if(status == G_TRACE_STATUS_NOT_AVAILABLE)
+	{
+		fprintf(stderr, "the kernel was built without tracing\n");
+		return false;
+	}
+	if(status != G_TRACE_STATUS_SUCCESSFUL)
+	{
+		fprintf(stderr, "trace call failed with status %i\n", status);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Stops tracing and passes the header and the events of all processors to the output.
+ */
+int traceDump(trace_output_t output, void* context)
+{
+	uint32_t processors;
+	uint32_t ticksPerMicrosecond;
+	if(!traceCheck(g_trace_control(G_TRACE_COMMAND_STOP)) || !traceCheck(g_trace_info(&processors, &ticksPerMicrosecond)))
+		return -1;
+
+	g_trace_event* events = new g_trace_event[TRACE_READ_CAPACITY * processors];
+	uint32_t total = 0;
+	for(uint32_t processor = 0; processor < processors; processor++)
+	{
+		uint32_t count;
+		uint32_t dropped;
+		if(!traceCheck(g_trace_read(processor, &events[total], TRACE_READ_CAPACITY, &count, &dropped)))
+		{
+			delete[] events;
+			return -1;
+		}
+		if(dropped)
+			fprintf(stderr, "processor %i: %i events were overwritten\n", processor, dropped);
+		total += count;
+	}
+
+	g_trace_dump_header header;
+	header.magic = G_TRACE_DUMP_MAGIC;
+	header.version = G_TRACE_DUMP_VERSION;
+	header.ticks_per_microsecond = ticksPerMicrosecond;
+	header.event_count = total;
+	output(context, &header, sizeof(header), true);
+	for(uint32_t i = 0; i < total; i++)
+		output(context, &events[i], sizeof(g_trace_event), false);
+
+	println("dumped %i events of %i processors", total, processors);
+	delete[] events;
+	return 0;
+}
+
+void traceOutputFile(void* context, const void* data, uint32_t length, bool header)
+{
+	fwrite(data, 1, length, (FILE*) context);
+}
+
+void traceOutputSerial(void* context, const void* data, uint32_t length, bool header)
+{
+	static const char* digits = "0123456789abcdef";
+
+	char line[64 + sizeof(g_trace_event) * 2];
+	const char* prefix = header ? TRACE_SERIAL_HEADER_PREFIX : TRACE_SERIAL_EVENT_PREFIX;
+	uint32_t pos = strlen(prefix);
+	memcpy(line, prefix, pos);
+
+	const uint8_t* bytes = (const uint8_t*) data;
+	for(uint32_t i = 0; i < length; i++)
+	{
+		line[pos++] = digits[bytes[i] >> 4];
+		line[pos++] = digits[bytes[i] & 0xF];
+	}
+	line[pos] = 0;
+	g_log(line);
+}
+
+/**
+ *
+ */
+int main(int argc, char** argv)
+{
+	const char* command = argc > 1 ? argv[1] : "--help";
+
+	if(strcmp(command, "start") == 0)
+	{
+		return traceCheck(g_trace_control(G_TRACE_COMMAND_START)) ? 0 : -1;
+	}
+	else if(strcmp(command, "stop") == 0)
+	{
+		return traceCheck(g_trace_control(G_TRACE_COMMAND_STOP)) ? 0 : -1;
+	}
+	else if(strcmp(command, "reset") == 0)
+	{
+		return traceCheck(g_trace_control(G_TRACE_COMMAND_RESET)) ? 0 : -1;
+	}
+	else if(strcmp(command, "record") == 0 && argc > 2)
+	{
+		if(!traceCheck(g_trace_control(G_TRACE_COMMAND_RESET)) || !traceCheck(g_trace_control(G_TRACE_COMMAND_START)))
+			return -1;
+		g_sleep(atoi(argv[2]));
+		return traceCheck(g_trace_control(G_TRACE_COMMAND_STOP)) ? 0 : -1;
+	}
+	else if(strcmp(command, "dump") == 0 && argc > 2)
+	{
+		FILE* file = fopen(argv[2], "w");
+		if(!file)
+		{
+			fprintf(stderr, "failed to open %s\n", argv[2]);
+			return -1;
+		}
+		int result = traceDump(traceOutputFile, file);
+		fclose(file);
+		return result;
+	}
+	else if(strcmp(command, "serial") == 0)
+	{
+		return traceDump(traceOutputSerial, nullptr);
+	}
+
+	println("trace, v%i.%i.%i", MAJOR, MINOR, PATCH);
+	println("Kernel event tracing utility");
+	println("");
+	println("The following commands are available:");
+	println("");
+	println("\tstart\t\tstarts recording kernel events");
+	println("\tstop\t\tstops recording");
+	println("\treset\t\tclears the recorded events");
+	println("\trecord <ms>\trecords events for the given time");
+	println("\tdump <file>\tstops recording and writes the events to a file");
+	println("\tserial\t\tstops recording and writes the events to the kernel log");
+	println("");
+	println("Dumps are converted to a timeline with the host tool 'trace-convert'.");
+	return 0;
+}
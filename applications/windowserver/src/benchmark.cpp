@@ -0,0 +1,336 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "benchmark.hpp"
+#include "components/button.hpp"
+#include "components/cursor.hpp"
+#include "components/desktop/background.hpp"
+#include "components/window.hpp"
+#include "layout/grid_layout_manager.hpp"
+#include "video/memory_video_output.hpp"
+
+#include <functional>
+#include <math.h>
+#include <sstream>
+#include <stdio.h>
+
+#define BENCHMARK_WIDTH 1024
+#define BENCHMARK_HEIGHT 768
+#define BENCHMARK_FRAMES 300
+
+static void benchmarkReport(const char* name, uint64_t value, const char* unit)
+{
+	printf("windowserver.%s %llu %s\n", name, value, unit);
+	klog("benchmark: windowserver.%s %llu %s", name, value, unit);
+}
+
+static window_t* benchmarkCreateWindow(screen_t* screen, g_rectangle bounds, std::string title)
+{
+	window_t* window = new window_t();
+	window->setTitle(title);
+	window->setBounds(bounds);
+	window->setVisible(true);
+	screen->addChild(window);
+	return window;
+}
+
+/**
+ * Creates a window that is filled with a grid of buttons, so painting it
+ * involves a deeper component tree.
+ */
+static window_t* benchmarkCreateFilledWindow(screen_t* screen, g_rectangle bounds, std::string title)
+{
+	window_t* window = benchmarkCreateWindow(screen, bounds, title);
+	window->setLayoutManager(new grid_layout_manager_t(4, 0, 5, 5));
+	for(int i = 0; i < 24; i++)
+	{
+		std::stringstream buttonTitle;
+		buttonTitle << "Button " << i;
+		button_t* button = new button_t();
+		button->setTitle(buttonTitle.str());
+		window->addChild(button);
+	}
+	return window;
+}
+
+static void benchmarkFocus(window_t* window)
+{
+	focus_event_t focus;
+	focus.type = FOCUS_EVENT_GAINED;
+	focus.newFocusedComponent = window;
+	window->handleFocusEvent(focus);
+}
+
+/**
+ * Renders all outstanding work so the measured frames start from a clean state.
+ */
+static void benchmarkSettle(windowserver_t* server, g_graphics* global, g_rectangle screenBounds)
+{
+	frame_statistics_t statistics;
+	server->renderFrame(global, screenBounds, statistics);
+}
+
+/**
+ * Renders the given number of frames, calling the step function before each
+ * one, and reports the averages under the given name.
+ */
+static void benchmarkFrames(windowserver_t* server, g_graphics* global, g_rectangle screenBounds,
+							std::string name, int frames, std::function<void(int)> step)
+{
+	benchmarkSettle(server, global, screenBounds);
+
+	uint64_t painted = 0;
+	uint64_t copied = 0;
+	uint64_t damageBounds = 0;
+	render_statistics_t collected;
+	for(int frame = 0; frame < frames; frame++)
+	{
+		step(frame);
+
+		frame_statistics_t statistics;
+		server->renderFrame(global, screenBounds, statistics);
+		collected.record(statistics);
+		painted += statistics.painted;
+		copied += statistics.copied;
+		damageBounds += statistics.damageBounds;
+	}
+
+	benchmarkReport((name + ".frame-time").c_str(), collected.frameTime.average(), "us");
+	benchmarkReport((name + ".frame-time-max").c_str(), collected.frameTime.maximum, "us");
+	benchmarkReport((name + ".layout-time").c_str(), collected.layoutTime.average(), "us");
+	benchmarkReport((name + ".paint-time").c_str(), collected.paintTime.average(), "us");
+	benchmarkReport((name + ".blit-time").c_str(), collected.blitTime.average(), "us");
+	benchmarkReport((name + ".output-time").c_str(), collected.outputTime.average(), "us");
+	benchmarkReport((name + ".painted").c_str(), painted / frames, "px/frame");
+	benchmarkReport((name + ".copied").c_str(), copied / frames, "px/frame");
+	benchmarkReport((name + ".damage-bounds").c_str(), damageBounds / frames, "px/frame");
+}
+
+static void benchmarkRemoveWindows(screen_t* screen, std::vector<window_t*>& windows)
+{
+	for(window_t* window : windows)
+		screen->removeChild(window);
+	windows.clear();
+}
+
+/**
+ * Small windows in the corners move around while windows that are hidden
+ * behind a focused window repaint their title on every frame. Only the moving
+ * windows should end up being painted and copied.
+ */
+static void benchmarkAnimatedWindows(windowserver_t* server, g_graphics* global, g_rectangle screenBounds)
+{
+	screen_t* screen = server->screen;
+	std::vector<window_t*> windows;
+
+	std::vector<window_t*> hidden;
+	for(int i = 0; i < 3; i++)
+		hidden.push_back(benchmarkCreateWindow(screen, g_rectangle(260 + i * 40, 220 + i * 30, 300, 200), "Hidden"));
+
+	window_t* front = benchmarkCreateWindow(screen, g_rectangle(212, 184, 600, 400), "Front");
+	benchmarkFocus(front);
+
+	std::vector<window_t*> moving;
+	std::vector<g_point> origins;
+	int cornerX[] = {40, BENCHMARK_WIDTH - 240, 40, BENCHMARK_WIDTH - 240};
+	int cornerY[] = {40, 40, BENCHMARK_HEIGHT - 190, BENCHMARK_HEIGHT - 190};
+	for(int i = 0; i < 4; i++)
+	{
+		moving.push_back(benchmarkCreateWindow(screen, g_rectangle(cornerX[i], cornerY[i], 200, 150), "Moving"));
+		origins.push_back(g_point(cornerX[i], cornerY[i]));
+	}
+
+	benchmarkFrames(server, global, screenBounds, "animated-windows", BENCHMARK_FRAMES, [&](int frame)
+					{
+						for(uint32_t i = 0; i < moving.size(); i++)
+						{
+							double angle = (frame * 4 + i * 90) * M_PI / 180.0;
+							g_rectangle bounds = moving[i]->getBounds();
+							bounds.x = origins[i].x + (int) (cos(angle) * 20);
+							bounds.y = origins[i].y + (int) (sin(angle) * 20);
+							moving[i]->setBounds(bounds);
+						}
+
+						std::stringstream title;
+						title << "Frame " << frame;
+						for(window_t* window : hidden)
+							window->setTitle(title.str());
+					});
+
+	windows.insert(windows.end(), hidden.begin(), hidden.end());
+	windows.push_back(front);
+	windows.insert(windows.end(), moving.begin(), moving.end());
+	benchmarkRemoveWindows(screen, windows);
+}
+
+/**
+ * A focused window full of buttons is dragged back and forth across other
+ * windows, like a user moving it with the mouse.
+ */
+static void benchmarkDrag(windowserver_t* server, g_graphics* global, g_rectangle screenBounds)
+{
+	screen_t* screen = server->screen;
+	std::vector<window_t*> windows;
+	for(int i = 0; i < 6; i++)
+		windows.push_back(benchmarkCreateFilledWindow(screen, g_rectangle(40 + (i % 3) * 320, 60 + (i / 3) * 340, 300, 300), "Background"));
+
+	window_t* dragged = benchmarkCreateFilledWindow(screen, g_rectangle(0, 200, 400, 320), "Dragged");
+	benchmarkFocus(dragged);
+	windows.push_back(dragged);
+
+	int range = BENCHMARK_WIDTH - 400;
+	benchmarkFrames(server, global, screenBounds, "drag", BENCHMARK_FRAMES, [&](int frame)
+					{
+						int offset = (frame * 8) % (2 * range);
+						if(offset > range)
+							offset = 2 * range - offset;
+
+						g_rectangle bounds = dragged->getBounds();
+						bounds.x = offset;
+						bounds.y = 200 + (offset / 8) % 40;
+						dragged->setBounds(bounds);
+					});
+
+	benchmarkRemoveWindows(screen, windows);
+}
+
+/**
+ * Overlapping windows full of buttons are raised one after the other.
+ */
+static void benchmarkRestack(windowserver_t* server, g_graphics* global, g_rectangle screenBounds)
+{
+	screen_t* screen = server->screen;
+	std::vector<window_t*> windows;
+	for(int i = 0; i < 6; i++)
+		windows.push_back(benchmarkCreateFilledWindow(screen, g_rectangle(100 + i * 60, 80 + i * 50, 400, 320), "Stacked"));
+
+	benchmarkFrames(server, global, screenBounds, "restack", BENCHMARK_FRAMES, [&](int frame)
+					{ windows[frame % windows.size()]->bringToFront(); });
+
+	benchmarkRemoveWindows(screen, windows);
+}
+
+static volatile bool benchmarkInputRunning;
+static volatile bool benchmarkInputStopped;
+static volatile uint32_t benchmarkInputEvents;
+
+/**
+ * Feeds mouse movement in bursts, like a mouse reporting at a high rate.
+ */
+static void benchmarkInputGenerator(windowserver_t* server)
+{
+	int step = 0;
+	while(benchmarkInputRunning)
+	{
+		for(int i = 0; i < 4; i++)
+		{
+			cursor_t::nextPosition.x = 100 + (step % 800);
+			cursor_t::nextPosition.y = 100 + (step % 500);
+			step++;
+
+			if(server->event_processor->input.pushMouse(cursor_t::nextPosition, G_MOUSE_BUTTON_NONE))
+			{
+				server->inputReceived();
+				server->triggerRender();
+			}
+			benchmarkInputEvents++;
+		}
+		g_sleep(2);
+	}
+	benchmarkInputStopped = true;
+}
+
+/**
+ * Runs the render loop for a while with the given frame rate while input is
+ * arriving, to see how many frames are rendered and how long the input takes
+ * until it is on the screen.
+ */
+static void benchmarkPacing(windowserver_t* server, g_graphics* global, g_rectangle screenBounds, uint32_t frameRate)
+{
+	std::stringstream name;
+	name << "pacing-" << frameRate;
+
+	benchmarkSettle(server, global, screenBounds);
+
+	benchmarkInputEvents = 0;
+	benchmarkInputRunning = true;
+	benchmarkInputStopped = false;
+	g_create_thread_d((void*) &benchmarkInputGenerator, server);
+
+	frame_scheduler_t scheduler(frameRate);
+	render_statistics_t collected;
+	uint64_t start = g_millis();
+	uint64_t end = start + 2000;
+	while(g_millis() < end)
+	{
+		scheduler.frameStarted();
+		frame_statistics_t statistics;
+		server->renderFrame(global, screenBounds, statistics);
+		collected.record(statistics);
+
+		scheduler.waitForFrame(server->render_atom);
+	}
+	uint64_t elapsed = g_millis() - start;
+
+	benchmarkInputRunning = false;
+	while(!benchmarkInputStopped)
+		g_sleep(1);
+
+	benchmarkReport((name.str() + ".frames-per-second").c_str(), collected.getFrames() * 1000 / elapsed, "frames/s");
+	benchmarkReport((name.str() + ".input-events").c_str(), benchmarkInputEvents, "events");
+	benchmarkReport((name.str() + ".frame-time").c_str(), collected.frameTime.average(), "us");
+	benchmarkReport((name.str() + ".frame-time-max").c_str(), collected.frameTime.maximum, "us");
+	benchmarkReport((name.str() + ".latency").c_str(), collected.inputLatency.average(), "us");
+	benchmarkReport((name.str() + ".latency-max").c_str(), collected.inputLatency.maximum, "us");
+}
+
+void benchmark_t::run(windowserver_t* server)
+{
+	g_task_register_id("windowserver/benchmark");
+	frameClockCalibrate();
+
+	server->event_processor = new event_processor_t();
+	server->video_output = new g_memory_video_output(g_dimension(BENCHMARK_WIDTH, BENCHMARK_HEIGHT));
+	if(!server->video_output->initialize())
+	{
+		klog("failed to initialize benchmark video output");
+		return;
+	}
+
+	g_rectangle screenBounds(0, 0, BENCHMARK_WIDTH, BENCHMARK_HEIGHT);
+	server->screen = new screen_t();
+	server->screen->setBounds(screenBounds);
+	server->background = new background_t();
+	server->background->setBounds(screenBounds);
+	server->screen->addChild(server->background);
+	cursor_t::focusedComponent = server->screen;
+
+	g_graphics global;
+	global.resize(screenBounds.width, screenBounds.height, false);
+	benchmarkSettle(server, &global, screenBounds);
+
+	benchmarkAnimatedWindows(server, &global, screenBounds);
+	benchmarkDrag(server, &global, screenBounds);
+	benchmarkRestack(server, &global, screenBounds);
+
+	g_atomic_lock(server->render_atom);
+	benchmarkPacing(server, &global, screenBounds, 0);
+	benchmarkPacing(server, &global, screenBounds, server->frameRate);
+}
@@ -41,19 +41,21 @@ component_t::~component_t()
 void component_t::setBounds(const g_rectangle& newBounds)
 {
 	g_rectangle oldBounds = bounds;
-	markDirty();
+	markBoundsDirty();
 
 	bounds = newBounds;
 	if(bounds.width < minimumSize.width)
 		bounds.width = minimumSize.width;
 	if(bounds.height < minimumSize.height)
 		bounds.height = minimumSize.height;
-	markDirty();
+	markBoundsDirty();
 
 	if(oldBounds.width != bounds.width || oldBounds.height != bounds.height)
 	{
 		if(needsGraphics)
 			graphics.resize(bounds.width, bounds.height);
+		if(cached)
+			cache.resize(bounds.width, bounds.height);
 		markFor(COMPONENT_REQUIREMENT_ALL);
 
 		handleBoundChange(oldBounds);
@@ -74,7 +76,7 @@ bool component_t::canHandleEvents() const
 void component_t::setVisible(bool visible)
 {
 	this->visible = visible;
-	markDirty();
+	markBoundsDirty();
 
 	if(visible)
 	{
@@ -88,39 +90,104 @@ void component_t::setVisible(bool visible)
 
 void component_t::markDirty(g_rectangle rect)
 {
+	if(cached)
+	{
+		g_atomic_lock(cache_lock);
+		cacheInvalid.add(rect);
+		g_atomic_unlock(cache_lock);
+	}
+
 	if(parent)
 	{
 		rect.x += bounds.x;
 		rect.y += bounds.y;
-		parent->markDirty(rect);
+		parent->markChildDirty(this, rect);
 	}
 }
 
-void component_t::blit(g_graphics* out, g_rectangle clip, g_point position)
+void component_t::markBoundsDirty()
+{
+	if(parent)
+		parent->markChildDirty(this, g_rectangle(bounds.x, bounds.y, bounds.width + 1, bounds.height + 1));
+}
+
+uint32_t component_t::blit(g_graphics* out, const region_t& clip, g_point position)
 {
 	if(!this->visible)
-		return;
+		return 0;
+
+	region_t thisClip = clip;
+	thisClip.intersect(g_rectangle(position.x, position.y, bounds.width, bounds.height));
+	if(thisClip.isEmpty())
+		return 0;
 
-	if(graphics.getContext())
-		graphics.blitTo(out, clip, position);
+	if(cached && cache.getContext())
+	{
+		uint32_t blitted = refreshCache();
+		cache.blitTo(out, thisClip, position);
+		return blitted + thisClip.getArea();
+	}
+
+	return blitContent(out, thisClip, position);
+}
 
-	g_rectangle abs = getBounds();
-	abs.x = position.x;
-	abs.y = position.y;
+uint32_t component_t::refreshCache()
+{
+	region_t invalid;
+	g_atomic_lock(cache_lock);
+	cacheInvalid.swap(invalid);
+	g_atomic_unlock(cache_lock);
+
+	invalid.intersect(g_rectangle(0, 0, bounds.width, bounds.height));
+	if(invalid.isEmpty())
+		return 0;
 
-	int newTop = clip.getTop() > abs.getTop() ? clip.getTop() : abs.getTop();
-	int newBottom = clip.getBottom() < abs.getBottom() ? clip.getBottom() : abs.getBottom();
-	int newLeft = clip.getLeft() > abs.getLeft() ? clip.getLeft() : abs.getLeft();
-	int newRight = clip.getRight() < abs.getRight() ? clip.getRight() : abs.getRight();
-	g_rectangle thisClip = g_rectangle(newLeft, newTop, newRight - newLeft, newBottom - newTop);
+	cache.clear(invalid);
+	return blitContent(&cache, invalid, g_point(0, 0));
+}
 
+uint32_t component_t::blitContent(g_graphics* out, region_t& thisClip, g_point position)
+{
 	g_atomic_lock(children_lock);
-	for(auto& c : children)
+
+	// Walk the children front to back, each one only gets the area that is not
+	// covered by an opaque sibling above it. What is left afterwards is the part
+	// of this component that is actually visible.
+	std::vector<region_t> childClips(children.size());
+	for(int index = children.size() - 1; index >= 0 && !thisClip.isEmpty(); index--)
+	{
+		component_t* child = children[index].component;
+		if(!child->visible)
+			continue;
+
+		childClips[index] = thisClip;
+
+		region_t opaque;
+		child->getOpaqueRegion(opaque);
+		opaque.intersect(g_rectangle(0, 0, child->bounds.width, child->bounds.height));
+		opaque.translate(position.x + child->bounds.x, position.y + child->bounds.y);
+		for(auto& rect : opaque.getRectangles())
+			thisClip.subtract(rect);
+	}
+
+	uint32_t blitted = 0;
+	if(graphics.getContext() && !thisClip.isEmpty())
 	{
-		if(c.component->visible)
-			c.component->blit(out, thisClip, g_point(position.x + c.component->bounds.x, position.y + c.component->bounds.y));
+		graphics.blitTo(out, thisClip, position);
+		blitted += thisClip.getArea();
+	}
+
+	for(uint32_t index = 0; index < children.size(); index++)
+	{
+		if(childClips[index].isEmpty())
+			continue;
+
+		component_t* child = children[index].component;
+		blitted += child->blit(out, childClips[index], g_point(position.x + child->bounds.x, position.y + child->bounds.y));
 	}
 	g_atomic_unlock(children_lock);
+
+	return blitted;
 }
 
 void component_t::addChild(component_t* comp, component_child_reference_type_t type)
@@ -145,6 +212,7 @@ void component_t::addChild(component_t* comp, component_child_reference_type_t t
 
 void component_t::removeChild(component_t* comp)
 {
+	markDirty(comp->bounds);
 	comp->parent = 0;
 
 	g_atomic_lock(children_lock);
@@ -29,6 +29,7 @@
 #include "events/mouse_event.hpp"
 #include "layout/layout_manager.hpp"
 #include "video/graphics.hpp"
+#include "video/region.hpp"
 
 #include <libwindow/interface.hpp>
 #include <libwindow/metrics/rectangle.hpp>
@@ -102,6 +103,19 @@ class component_t : public bounds_event_component_t
 
 	int z_index = 1000;
 
+	region_t cacheInvalid;
+	g_atom cache_lock = g_atomic_initialize();
+
+	/**
+	 * Blits the own surface and the children to the out buffer.
+	 */
+	uint32_t blitContent(g_graphics* out, region_t& clip, g_point position);
+
+	/**
+	 * Brings the invalid parts of the cache up to date.
+	 */
+	uint32_t refreshCache();
+
   protected:
 	layout_manager_t* layoutManager;
 	g_graphics graphics;
@@ -113,6 +127,14 @@ class component_t : public bounds_event_component_t
 	 */
 	bool needsGraphics = true;
 
+	/**
+	 * If set, the component and its children are blitted into the cache, which
+	 * is only updated where the content was marked dirty. Moving or restacking
+	 * the component then only costs a copy of the cache.
+	 */
+	bool cached = false;
+	g_graphics cache;
+
   public:
 	g_ui_component_id id;
 
@@ -168,6 +190,11 @@ class component_t : public bounds_event_component_t
 
 	void setVisible(bool visible);
 
+	bool isVisible() const
+	{
+		return visible;
+	}
+
 	/**
 	 * Sets the bounds of the component and recreates its graphics buffer.
 	 *
@@ -208,12 +235,23 @@ class component_t : public bounds_event_component_t
 
 	/**
 	 * This method is used to blit the component and all of its children
-	 * to the out buffer
+	 * to the out buffer. Areas that are covered by opaque children are
+	 * not blitted from this component.
 	 *
-	 * @param absClip	absolute bounds that may not be exceeded
+	 * @param absClip	absolute region that may not be exceeded
 	 * @param position	absolute screen position to blit to
+	 * @return the number of pixels that were blitted
 	 */
-	void blit(g_graphics* out, g_rectangle absClip, g_point position);
+	uint32_t blit(g_graphics* out, const region_t& absClip, g_point position);
+
+	/**
+	 * Adds the area in which this component paints fully opaque pixels to the
+	 * given region, relative to the component. Everything below that area is
+	 * skipped when blitting.
+	 */
+	virtual void getOpaqueRegion(region_t& out)
+	{
+	}
 
 	/**
 	 * Adds the given component as a child to this component
@@ -293,6 +331,21 @@ class component_t : public bounds_event_component_t
 	 */
 	virtual void markDirty(g_rectangle rect);
 
+	/**
+	 * Called when the given child marks an area as dirty. The area is relative
+	 * to this component.
+	 */
+	virtual void markChildDirty(component_t* child, g_rectangle rect)
+	{
+		markDirty(rect);
+	}
+
+	/**
+	 * Marks the area the component occupies within its parent as dirty, without
+	 * touching its content.
+	 */
+	void markBoundsDirty();
+
 	/**
 	 * Marks the entire component as dirty
 	 */
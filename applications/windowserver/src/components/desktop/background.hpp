@@ -44,6 +44,12 @@ class background_t : public component_t
 
 	virtual void paint();
 
+	virtual void getOpaqueRegion(region_t& out)
+	{
+		g_rectangle bounds = getBounds();
+		out.add(g_rectangle(0, 0, bounds.width, bounds.height));
+	}
+
 	virtual void load(const char* path);
 
 	void showSelection(g_rectangle& selection);
@@ -24,41 +24,86 @@
 
 void screen_t::markDirty(g_rectangle rect)
 {
+	// Only keep the part that is on the screen
+	g_rectangle bounds = getBounds();
+	if(!region_t::intersection(rect, g_rectangle(0, 0, bounds.width, bounds.height), rect))
+		return;
 
-	// Mark area as invalid
-	if(invalid.x == 0 && invalid.y == 0 && invalid.width == 0 && invalid.height == 0)
-	{
-		invalid = rect;
-	}
-	else
-	{
-		int top = rect.getTop() < invalid.getTop() ? rect.getTop() : invalid.getTop();
-		int left = rect.getLeft() < invalid.getLeft() ? rect.getLeft() : invalid.getLeft();
-		int bottom = rect.getBottom() > invalid.getBottom() ? rect.getBottom() : invalid.getBottom();
-		int right = rect.getRight() > invalid.getRight() ? rect.getRight() : invalid.getRight();
+	g_atomic_lock(invalid_lock);
+	invalid.add(rect);
+	g_atomic_unlock(invalid_lock);
+}
 
-		invalid = g_rectangle(left, top, right - left + 1, bottom - top + 1);
-	}
+void screen_t::markChildDirty(component_t* child, g_rectangle rect)
+{
+	g_rectangle bounds = getBounds();
+	if(!region_t::intersection(rect, g_rectangle(0, 0, bounds.width, bounds.height), rect))
+		return;
 
-	// Fix invalid area
-	if(invalid.x < 0)
+	g_atomic_lock(invalid_lock);
+	bool found = false;
+	for(auto& entry : childInvalid)
 	{
-		invalid.width += invalid.x;
-		invalid.x = 0;
-	}
-	if(invalid.y < 0)
-	{
-		invalid.height += invalid.y;
-		invalid.y = 0;
-	}
-	if(invalid.x + invalid.width > getBounds().width)
-	{
-		invalid.width = getBounds().width - invalid.x;
+		if(entry.first == child)
+		{
+			entry.second.add(rect);
+			found = true;
+			break;
+		}
 	}
-	if(invalid.y + invalid.height > getBounds().height)
+	if(!found)
+		childInvalid.push_back(std::make_pair(child, region_t(rect)));
+	g_atomic_unlock(invalid_lock);
+}
+
+region_t screen_t::grabInvalid()
+{
+	region_t ret;
+	std::vector<std::pair<component_t*, region_t>> marked;
+	g_atomic_lock(invalid_lock);
+	invalid.swap(ret);
+	childInvalid.swap(marked);
+	g_atomic_unlock(invalid_lock);
+
+	if(marked.empty())
+		return ret;
+
+	// Walk the children front to back and remove everything from their damage
+	// that is covered by the opaque area of a child above them
+	std::vector<g_rectangle> covered;
+	g_atomic_lock(getChildrenLock());
+	auto& children = getChildren();
+	for(int index = children.size() - 1; index >= 0; index--)
 	{
-		invalid.height = getBounds().height - invalid.y;
+		component_t* child = children[index].component;
+		for(auto& entry : marked)
+		{
+			if(entry.first != child)
+				continue;
+
+			for(auto& rect : covered)
+				entry.second.subtract(rect);
+			ret.add(entry.second);
+			entry.first = nullptr;
+			entry.second.clear();
+		}
+
+		if(!child->isVisible())
+			continue;
+
+		region_t opaque;
+		child->getOpaqueRegion(opaque);
+		g_rectangle childBounds = child->getBounds();
+		opaque.intersect(g_rectangle(0, 0, childBounds.width, childBounds.height));
+		opaque.translate(childBounds.x, childBounds.y);
+		covered.insert(covered.end(), opaque.getRectangles().begin(), opaque.getRectangles().end());
 	}
+	g_atomic_unlock(getChildrenLock());
+
+	// damage of components that are no longer on the screen is kept
+	for(auto& entry : marked)
+		ret.add(entry.second);
+	return ret;
 }
 
 component_t* screen_t::handleMouseEvent(mouse_event_t& e)
@@ -97,4 +142,4 @@ component_t* screen_t::handleMouseEvent(mouse_event_t& e)
 
 	cursor_t::set("default");
 	return this;
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -22,6 +22,7 @@
 #define __WINDOWSERVER_COMPONENTS_SCREEN__
 
 #include "components/component.hpp"
+#include "video/region.hpp"
 
 #include <libwindow/metrics/rectangle.hpp>
 
@@ -31,7 +32,14 @@ class screen_t : public component_t
     /**
      * Area that is invalid and needs to be copied to the video output.
      */
-    g_rectangle invalid;
+    region_t invalid;
+    g_atom invalid_lock = g_atomic_initialize();
+
+    /**
+     * Invalid areas that were marked by a child of the screen (or anything
+     * within it), kept apart so damage below opaque windows can be dropped.
+     */
+    std::vector<std::pair<component_t*, region_t>> childInvalid;
 
     bool pressing;
     g_point pressPoint;
@@ -47,14 +55,16 @@ class screen_t : public component_t
      */
     virtual void markDirty(g_rectangle rect);
 
+    virtual void markChildDirty(component_t* child, g_rectangle rect);
+
     virtual component_t* handleMouseEvent(mouse_event_t& e);
 
-    g_rectangle grabInvalid()
-    {
-        g_rectangle ret = invalid;
-        invalid = g_rectangle();
-        return ret;
-    }
+    /**
+     * Takes the invalid region, leaving an empty one behind. Areas that were
+     * marked by a window but are covered by opaque windows above it are not
+     * part of the result, as nothing visible changed there.
+     */
+    region_t grabInvalid();
 };
 
 #endif
@@ -43,6 +43,8 @@ window_t::window_t() : backgroundColor(RGB(240, 240, 240)), borderWidth(DEFAULT_
 	padding = 5;
 
 	graphics.setAverageFactor(250);
+	cached = true;
+	cache.setAverageFactor(250);
 
 	component_t::addChild(&label, COMPONENT_CHILD_REFERENCE_TYPE_INTERNAL);
 	component_t::addChild(&panel, COMPONENT_CHILD_REFERENCE_TYPE_INTERNAL);
@@ -143,6 +145,20 @@ void window_t::paint()
 	cairo_stroke(cr);
 }
 
+void window_t::getOpaqueRegion(region_t& out)
+{
+	// unfocused windows are slightly translucent
+	if(!focused || ARGB_A_FROM(backgroundColor) != 255)
+		return;
+
+	// the body is a rounded rectangle within the shadow, leave out the
+	// corners and the anti-aliased edge
+	g_rectangle bounds = getBounds();
+	int inset = shadowSize + 1;
+	out.add(g_rectangle(shadowSize + shadowSize, inset, bounds.width - 4 * shadowSize, bounds.height - 2 * inset));
+	out.add(g_rectangle(inset, shadowSize + shadowSize, bounds.width - 2 * inset, bounds.height - 4 * shadowSize));
+}
+
 component_t* window_t::handleFocusEvent(focus_event_t& fe)
 {
 	if(fe.newFocusedComponent)
@@ -104,6 +104,8 @@ class window_t : public component_t, public titled_component_t
 
     virtual void paint();
 
+    virtual void getOpaqueRegion(region_t& out);
+
     virtual component_t* handleFocusEvent(focus_event_t& e);
     virtual component_t* handleMouseEvent(mouse_event_t& e);
 
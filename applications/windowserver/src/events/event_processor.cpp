@@ -36,13 +36,6 @@ event_processor_t::event_processor_t()
 	multiclickTimespan = DEFAULT_MULTICLICK_TIMESPAN;
 }
 
-void event_processor_t::bufferKeyEvent(g_key_info keyInfo)
-{
-	g_atomic_lock(key_info_buffer_lock);
-	key_info_buffer.push_back(keyInfo);
-	g_atomic_unlock(key_info_buffer_lock);
-}
-
 void event_processor_t::bufferCommandMessage(void* commandMessage)
 {
 	g_atomic_lock(command_message_buffer_lock);
@@ -52,19 +45,16 @@ void event_processor_t::bufferCommandMessage(void* commandMessage)
 
 void event_processor_t::process()
 {
-	processMouseState();
-	processKeyState();
-}
+	std::deque<input_event_t> events;
+	input.take(events);
 
-void event_processor_t::processKeyState()
-{
-	g_atomic_lock(key_info_buffer_lock);
-	while(key_info_buffer.size() > 0)
+	for(auto& event : events)
 	{
-		translateKeyEvent(key_info_buffer.back());
-		key_info_buffer.pop_back();
+		if(event.type == INPUT_EVENT_MOUSE)
+			processMouseState(event.position, event.buttons);
+		else
+			translateKeyEvent(event.key);
 	}
-	g_atomic_unlock(key_info_buffer_lock);
 }
 
 void event_processor_t::translateKeyEvent(g_key_info& info)
@@ -78,7 +68,7 @@ void event_processor_t::translateKeyEvent(g_key_info& info)
 	}
 }
 
-void event_processor_t::processMouseState()
+void event_processor_t::processMouseState(g_point nextPosition, g_mouse_button nextPressedButtons)
 {
 	g_point previousPosition = cursor_t::position;
 	g_mouse_button previousPressedButtons = cursor_t::pressedButtons;
@@ -87,15 +77,15 @@ void event_processor_t::processMouseState()
 	windowserver_t* instance = windowserver_t::instance();
 	screen_t* screen = instance->screen;
 
-	if(cursor_t::position != cursor_t::nextPosition)
+	if(cursor_t::position != nextPosition)
 	{
 		screen->markDirty(cursor_t::getArea());
-		cursor_t::position = cursor_t::nextPosition;
+		cursor_t::position = nextPosition;
 		screen->markDirty(cursor_t::getArea());
 	}
 
 	// set pressed buttons
-	cursor_t::pressedButtons = cursor_t::nextPressedButtons;
+	cursor_t::pressedButtons = nextPressedButtons;
 
 	mouse_event_t baseEvent;
 	baseEvent.screenPosition = cursor_t::position;
@@ -21,6 +21,8 @@
 #ifndef __WINDOWSERVER_EVENTS_EVENTPROCESSOR__
 #define __WINDOWSERVER_EVENTS_EVENTPROCESSOR__
 
+#include "input/input_queue.hpp"
+
 #include <deque>
 #include <libinput/keyboard/keyboard.hpp>
 #include <libinput/mouse/mouse.hpp>
@@ -38,9 +40,7 @@ class event_processor_t
 
 	event_processor_t();
 
-	std::deque<g_key_info> key_info_buffer;
-	g_atom key_info_buffer_lock = g_atomic_initialize();
-	void bufferKeyEvent(g_key_info keyInfo);
+	input_queue_t input;
 
 	std::deque<void*> command_message_buffer;
 	g_atom command_message_buffer_lock = g_atomic_initialize();
@@ -49,8 +49,7 @@ class event_processor_t
 	void process();
 
 	void translateKeyEvent(g_key_info& info);
-	void processKeyState();
-	void processMouseState();
+	void processMouseState(g_point nextPosition, g_mouse_button nextPressedButtons);
 };
 
 #endif
@@ -0,0 +1,77 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "input/input_queue.hpp"
+
+bool input_queue_t::push(const input_event_t& event)
+{
+	g_atomic_lock(lock);
+	bool wasEmpty = events.empty();
+	received++;
+
+	bool isMove = false;
+	if(event.type == INPUT_EVENT_MOUSE)
+	{
+		isMove = event.buttons == lastButtons;
+		lastButtons = event.buttons;
+
+		if(isMove && lastIsMove && !wasEmpty)
+		{
+			events.back().position = event.position;
+			g_atomic_unlock(lock);
+			return false;
+		}
+	}
+
+	events.push_back(event);
+	lastIsMove = isMove;
+	g_atomic_unlock(lock);
+	return wasEmpty;
+}
+
+bool input_queue_t::pushMouse(g_point position, g_mouse_button buttons)
+{
+	input_event_t event;
+	event.type = INPUT_EVENT_MOUSE;
+	event.position = position;
+	event.buttons = buttons;
+	return push(event);
+}
+
+bool input_queue_t::pushKey(const g_key_info& key)
+{
+	input_event_t event;
+	event.type = INPUT_EVENT_KEY;
+	event.key = key;
+	return push(event);
+}
+
+uint32_t input_queue_t::take(std::deque<input_event_t>& out)
+{
+	g_atomic_lock(lock);
+	for(auto& event : events)
+		out.push_back(event);
+	events.clear();
+
+	uint32_t count = received;
+	received = 0;
+	g_atomic_unlock(lock);
+	return count;
+}
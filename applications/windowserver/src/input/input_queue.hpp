@@ -0,0 +1,99 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __WINDOWSERVER_INPUT_INPUTQUEUE__
+#define __WINDOWSERVER_INPUT_INPUTQUEUE__
+
+#include <deque>
+#include <ghost.h>
+#include <libinput/keyboard/keyboard.hpp>
+#include <libwindow/interface.hpp>
+#include <libwindow/metrics/point.hpp>
+
+enum input_event_type_t
+{
+	INPUT_EVENT_MOUSE,
+	INPUT_EVENT_KEY
+};
+
+/**
+ * A single input event as delivered by an input receiver. Mouse events carry
+ * the absolute cursor position and the buttons held at that point.
+ */
+struct input_event_t
+{
+	input_event_type_t type;
+	g_key_info key;
+	g_point position;
+	g_mouse_button buttons = G_MOUSE_BUTTON_NONE;
+};
+
+/**
+ * The input queue keeps the events of all input receivers in the order in which
+ * they arrived, until the renderer processes them in the next frame.
+ *
+ * Consecutive mouse events that only move the cursor are merged into one, as
+ * only the last position matters. Events that change the buttons are never
+ * merged, so a click keeps the position where it happened, and key events in
+ * between end the merging so keys keep their order relative to the mouse.
+ */
+class input_queue_t
+{
+  private:
+	std::deque<input_event_t> events;
+	g_atom lock = g_atomic_initialize();
+
+	uint32_t received = 0;
+
+	/**
+	 * Buttons of the last mouse event, and whether the event at the end of the
+	 * queue is a move that later moves may be merged into.
+	 */
+	g_mouse_button lastButtons = G_MOUSE_BUTTON_NONE;
+	bool lastIsMove = false;
+
+	bool push(const input_event_t& event);
+
+  public:
+	/**
+	 * Adds a mouse event.
+	 *
+	 * @return whether the queue was empty before, in which case the caller
+	 * must trigger a render; otherwise one is already pending
+	 */
+	bool pushMouse(g_point position, g_mouse_button buttons);
+
+	/**
+	 * Adds a key event.
+	 *
+	 * @return see pushMouse
+	 */
+	bool pushKey(const g_key_info& key);
+
+	/**
+	 * Moves all queued events to the end of the given queue.
+	 *
+	 * @return the number of events that were received for them, including the
+	 * ones that were merged
+	 */
+	uint32_t take(std::deque<input_event_t>& out);
+};
+
+#endif
@@ -45,9 +45,11 @@ void input_receiver_t::startReceiveKeyEvents()
 	while(true)
 	{
 		g_key_info key = g_keyboard::readKey(keyboardIn);
-		event_queue->bufferKeyEvent(key);
-
-		windowserver_t::instance()->triggerRender();
+		if(event_queue->input.pushKey(key))
+		{
+			windowserver_t::instance()->inputReceived();
+			windowserver_t::instance()->triggerRender();
+		}
 	}
 }
 
@@ -97,6 +99,10 @@ void input_receiver_t::startReceiveMouseEvents()
 			cursor_t::nextPressedButtons |= G_MOUSE_BUTTON_3;
 		}
 
-		windowserver_t::instance()->triggerRender();
+		if(event_queue->input.pushMouse(cursor_t::nextPosition, cursor_t::nextPressedButtons))
+		{
+			instance->inputReceived();
+			instance->triggerRender();
+		}
 	}
 }
@@ -19,6 +19,7 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include <libwindow/interface.hpp>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 #include <windowserver.hpp>
@@ -56,8 +57,14 @@ void interface_receiver_t::run()
 			response.target = message->sender;
 			response.transaction = message->transaction;
 			response.message = 0;
+			response.buffer = 0;
+			response.bufferLength = 0;
 
-			processCommand(message->sender, (g_ui_message_header*) G_MESSAGE_CONTENT(message), response);
+			g_ui_message_header* request = (g_ui_message_header*) G_MESSAGE_CONTENT(message);
+			if(request->id == G_UI_PROTOCOL_BATCH)
+				processBatch(message->sender, (g_ui_batch_request*) request, message->length, response);
+			else
+				processCommand(message->sender, request, response);
 
 			if(response.message)
 				interfaceResponderSend(response);
@@ -75,6 +82,106 @@ void interface_receiver_t::run()
 	delete buffer;
 }
 
+/**
+ * Response of all commands that may be part of a batch.
+ */
+typedef struct
+{
+	g_ui_message_header header;
+	g_ui_protocol_status status;
+} __attribute__((packed)) interface_status_response_t;
+
+/**
+ * Returns the minimum length of a command that may be part of a batch, or 0 if the
+ * command is not allowed in a batch. Titles are only sent up to their terminator.
+ */
+static size_t interfaceBatchMinimumLength(g_ui_protocol_command_id id)
+{
+	switch(id)
+	{
+	case G_UI_PROTOCOL_ADD_COMPONENT:
+		return sizeof(g_ui_component_add_child_request);
+	case G_UI_PROTOCOL_SET_TITLE:
+		return offsetof(g_ui_component_set_title_request, title) + 1;
+	case G_UI_PROTOCOL_SET_BOUNDS:
+		return sizeof(g_ui_component_set_bounds_request);
+	case G_UI_PROTOCOL_SET_VISIBLE:
+		return sizeof(g_ui_component_set_visible_request);
+	case G_UI_PROTOCOL_SET_LISTENER:
+		return sizeof(g_ui_component_set_listener_request);
+	case G_UI_PROTOCOL_SET_NUMERIC_PROPERTY:
+		return sizeof(g_ui_component_set_numeric_property_request);
+	case G_UI_PROTOCOL_CANVAS_ACK_BUFFER_REQUEST:
+		return sizeof(g_ui_component_canvas_ack_buffer_request);
+	case G_UI_PROTOCOL_CANVAS_BLIT:
+		return sizeof(g_ui_component_canvas_blit_request);
+	default:
+		return 0;
+	}
+}
+
+void interface_receiver_t::processBatch(g_tid senderTid, g_ui_batch_request* request, size_t length, command_message_response_t& responseOut)
+{
+	if(length < sizeof(g_ui_batch_request))
+	{
+		klog("batch from %i is shorter than its header", senderTid);
+		return;
+	}
+
+	uint8_t* position = (uint8_t*) request + sizeof(g_ui_batch_request);
+	uint8_t* end = (uint8_t*) request + length;
+
+	// responses of the commands are only needed for their status
+	uint8_t commandResponseBuffer[sizeof(interface_status_response_t)];
+	uint16_t failed = 0;
+
+	for(uint16_t i = 0; i < request->count; i++)
+	{
+		g_ui_batch_entry* entry = (g_ui_batch_entry*) position;
+		if(position + sizeof(g_ui_batch_entry) > end || entry->length < sizeof(g_ui_message_header) ||
+		   position + sizeof(g_ui_batch_entry) + entry->length > end)
+		{
+			klog("batch from %i is truncated after %i of %i commands", senderTid, i, request->count);
+			failed += request->count - i;
+			break;
+		}
+
+		g_ui_message_header* command = (g_ui_message_header*) (position + sizeof(g_ui_batch_entry));
+		position += sizeof(g_ui_batch_entry) + entry->length;
+
+		size_t minimumLength = interfaceBatchMinimumLength(command->id);
+		if(minimumLength == 0 || entry->length < minimumLength ||
+		   (command->id == G_UI_PROTOCOL_SET_TITLE &&
+			(entry->length > sizeof(g_ui_component_set_title_request) || ((char*) command)[entry->length - 1] != 0)))
+		{
+			klog("command %i in a batch from %i was rejected", command->id, senderTid);
+			failed++;
+			continue;
+		}
+
+		command_message_response_t commandResponse;
+		commandResponse.message = 0;
+		commandResponse.buffer = commandResponseBuffer;
+		commandResponse.bufferLength = sizeof(commandResponseBuffer);
+		processCommand(senderTid, command, commandResponse);
+
+		if(commandResponse.message && ((interface_status_response_t*) commandResponse.message)->status != G_UI_PROTOCOL_SUCCESS)
+			failed++;
+
+		if(commandResponse.message != commandResponseBuffer)
+			delete(g_message_header*) commandResponse.message;
+	}
+
+	if(request->flags & G_UI_BATCH_FLAG_RESPOND)
+	{
+		g_ui_batch_response* response = interfaceResponseCreate<g_ui_batch_response>(responseOut);
+		response->header.id = G_UI_PROTOCOL_BATCH;
+		response->status = (failed == 0 ? G_UI_PROTOCOL_SUCCESS : G_UI_PROTOCOL_FAIL);
+		response->count = request->count;
+		response->failed = failed;
+	}
+}
+
 void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header* requestIn, command_message_response_t& responseOut)
 {
 	if(requestIn->id == G_UI_PROTOCOL_CREATE_COMPONENT)
@@ -117,13 +224,10 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 			component_id = component_registry_t::add(g_get_pid_for_tid(senderTid), component);
 
 		// create response message
-		g_ui_create_component_response* response = new g_ui_create_component_response;
+		g_ui_create_component_response* response = interfaceResponseCreate<g_ui_create_component_response>(responseOut);
 		response->header.id = G_UI_PROTOCOL_CREATE_COMPONENT;
 		response->id = component_id;
 		response->status = (component != 0 ? G_UI_PROTOCOL_SUCCESS : G_UI_PROTOCOL_FAIL);
-
-		responseOut.message = response;
-		responseOut.length = sizeof(g_ui_create_component_response);
 	}
 	else if(requestIn->id == G_UI_PROTOCOL_ADD_COMPONENT)
 	{
@@ -132,7 +236,7 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 		component_t* child = component_registry_t::get(request->child);
 
 		// create response message
-		g_ui_component_add_child_response* response = new g_ui_component_add_child_response;
+		g_ui_component_add_child_response* response = interfaceResponseCreate<g_ui_component_add_child_response>(responseOut);
 		if(parent == 0 || child == 0)
 		{
 			response->status = G_UI_PROTOCOL_FAIL;
@@ -143,9 +247,6 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 			parent->addChild(child);
 			response->status = G_UI_PROTOCOL_SUCCESS;
 		}
-
-		responseOut.message = response;
-		responseOut.length = sizeof(g_ui_component_add_child_response);
 	}
 	else if(requestIn->id == G_UI_PROTOCOL_SET_BOUNDS)
 	{
@@ -153,7 +254,7 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 		component_t* component = component_registry_t::get(request->id);
 
 		// create response message
-		g_ui_component_set_bounds_response* response = new g_ui_component_set_bounds_response;
+		g_ui_component_set_bounds_response* response = interfaceResponseCreate<g_ui_component_set_bounds_response>(responseOut);
 		if(component == 0)
 		{
 			response->status = G_UI_PROTOCOL_FAIL;
@@ -163,9 +264,6 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 			component->setBounds(request->bounds);
 			response->status = G_UI_PROTOCOL_SUCCESS;
 		}
-
-		responseOut.message = response;
-		responseOut.length = sizeof(g_ui_component_set_bounds_response);
 	}
 	else if(requestIn->id == G_UI_PROTOCOL_GET_BOUNDS)
 	{
@@ -173,7 +271,7 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 		component_t* component = component_registry_t::get(request->id);
 
 		// create response message
-		g_ui_component_get_bounds_response* response = new g_ui_component_get_bounds_response;
+		g_ui_component_get_bounds_response* response = interfaceResponseCreate<g_ui_component_get_bounds_response>(responseOut);
 		if(component == 0)
 		{
 			response->status = G_UI_PROTOCOL_FAIL;
@@ -183,9 +281,6 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 			response->bounds = component->getBounds();
 			response->status = G_UI_PROTOCOL_SUCCESS;
 		}
-
-		responseOut.message = response;
-		responseOut.length = sizeof(g_ui_component_get_bounds_response);
 	}
 	else if(requestIn->id == G_UI_PROTOCOL_SET_VISIBLE)
 	{
@@ -193,7 +288,7 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 		component_t* component = component_registry_t::get(request->id);
 
 		// create response message
-		g_ui_component_set_visible_response* response = new g_ui_component_set_visible_response;
+		g_ui_component_set_visible_response* response = interfaceResponseCreate<g_ui_component_set_visible_response>(responseOut);
 		if(component == 0)
 		{
 			response->status = G_UI_PROTOCOL_FAIL;
@@ -203,9 +298,6 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 			component->setVisible(request->visible);
 			response->status = G_UI_PROTOCOL_SUCCESS;
 		}
-
-		responseOut.message = response;
-		responseOut.length = sizeof(g_ui_component_set_visible_response);
 	}
 	else if(requestIn->id == G_UI_PROTOCOL_SET_LISTENER)
 	{
@@ -213,7 +305,7 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 		component_t* component = component_registry_t::get(request->id);
 
 		// create response message
-		g_ui_component_set_listener_response* response = new g_ui_component_set_listener_response;
+		g_ui_component_set_listener_response* response = interfaceResponseCreate<g_ui_component_set_listener_response>(responseOut);
 		if(component == 0)
 		{
 			response->status = G_UI_PROTOCOL_FAIL;
@@ -223,9 +315,6 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 			component->setListener(request->event_type, request->target_thread, request->id);
 			response->status = G_UI_PROTOCOL_SUCCESS;
 		}
-
-		responseOut.message = response;
-		responseOut.length = sizeof(g_ui_component_set_listener_response);
 	}
 	else if(requestIn->id == G_UI_PROTOCOL_SET_NUMERIC_PROPERTY)
 	{
@@ -233,7 +322,7 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 		component_t* component = component_registry_t::get(request->id);
 
 		// create response message
-		g_ui_component_set_numeric_property_response* response = new g_ui_component_set_numeric_property_response;
+		g_ui_component_set_numeric_property_response* response = interfaceResponseCreate<g_ui_component_set_numeric_property_response>(responseOut);
 		if(component == 0)
 		{
 			response->status = G_UI_PROTOCOL_FAIL;
@@ -249,9 +338,6 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 				response->status = G_UI_PROTOCOL_FAIL;
 			}
 		}
-
-		responseOut.message = response;
-		responseOut.length = sizeof(g_ui_component_set_numeric_property_response);
 	}
 	else if(requestIn->id == G_UI_PROTOCOL_GET_NUMERIC_PROPERTY)
 	{
@@ -259,7 +345,7 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 		component_t* component = component_registry_t::get(request->id);
 
 		// create response message
-		g_ui_component_get_numeric_property_response* response = new g_ui_component_get_numeric_property_response;
+		g_ui_component_get_numeric_property_response* response = interfaceResponseCreate<g_ui_component_get_numeric_property_response>(responseOut);
 		if(component == 0)
 		{
 			response->status = G_UI_PROTOCOL_FAIL;
@@ -277,9 +363,6 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 				response->status = G_UI_PROTOCOL_FAIL;
 			}
 		}
-
-		responseOut.message = response;
-		responseOut.length = sizeof(g_ui_component_get_numeric_property_response);
 	}
 	else if(requestIn->id == G_UI_PROTOCOL_SET_TITLE)
 	{
@@ -287,7 +370,7 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 		component_t* component = component_registry_t::get(request->id);
 
 		// create response message
-		g_ui_component_set_title_response* response = new g_ui_component_set_title_response;
+		g_ui_component_set_title_response* response = interfaceResponseCreate<g_ui_component_set_title_response>(responseOut);
 		if(component == 0)
 		{
 			response->status = G_UI_PROTOCOL_FAIL;
@@ -305,9 +388,6 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 				response->status = G_UI_PROTOCOL_SUCCESS;
 			}
 		}
-
-		responseOut.message = response;
-		responseOut.length = sizeof(g_ui_component_set_title_response);
 	}
 	else if(requestIn->id == G_UI_PROTOCOL_GET_TITLE)
 	{
@@ -315,7 +395,7 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 		component_t* component = component_registry_t::get(request->id);
 
 		// create response message
-		g_ui_component_get_title_response* response = new g_ui_component_get_title_response;
+		g_ui_component_get_title_response* response = interfaceResponseCreate<g_ui_component_get_title_response>(responseOut);
 		if(component == 0)
 		{
 			response->status = G_UI_PROTOCOL_FAIL;
@@ -348,9 +428,6 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 				response->status = G_UI_PROTOCOL_SUCCESS;
 			}
 		}
-
-		responseOut.message = response;
-		responseOut.length = sizeof(g_ui_component_get_title_response);
 	}
 	else if(requestIn->id == G_UI_PROTOCOL_CANVAS_ACK_BUFFER_REQUEST)
 	{
@@ -374,7 +451,7 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 		component_t* component = component_registry_t::get(request->canvas_id);
 
 		// create response message
-		g_ui_register_desktop_canvas_response* response = new g_ui_register_desktop_canvas_response;
+		g_ui_register_desktop_canvas_response* response = interfaceResponseCreate<g_ui_register_desktop_canvas_response>(responseOut);
 		if(component == 0)
 		{
 			response->status = G_UI_PROTOCOL_FAIL;
@@ -390,18 +467,12 @@ void interface_receiver_t::processCommand(g_tid senderTid, g_ui_message_header*
 			screen->addChild(canvas);
 			canvas->setBounds(screen->getBounds());
 		}
-
-		responseOut.message = response;
-		responseOut.length = sizeof(g_ui_register_desktop_canvas_response);
 	}
 	else if(requestIn->id == G_UI_PROTOCOL_GET_SCREEN_DIMENSION)
 	{
 		g_ui_get_screen_dimension_request* request = (g_ui_get_screen_dimension_request*) requestIn;
 
-		g_ui_get_screen_dimension_response* response = new g_ui_get_screen_dimension_response;
+		g_ui_get_screen_dimension_response* response = interfaceResponseCreate<g_ui_get_screen_dimension_response>(responseOut);
 		response->size = windowserver_t::instance()->screen->getBounds().getSize();
-
-		responseOut.message = response;
-		responseOut.length = sizeof(g_ui_get_screen_dimension_response);
 	}
 }
\ No newline at end of file
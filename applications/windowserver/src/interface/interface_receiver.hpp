@@ -34,6 +34,7 @@ class interface_receiver_t
 	virtual void run();
 
 	void processCommand(g_tid senderTid, g_ui_message_header* request, command_message_response_t& response);
+	void processBatch(g_tid senderTid, g_ui_batch_request* request, size_t length, command_message_response_t& response);
 };
 
 void interfaceReceiverThread(interface_receiver_t* receiver);
@@ -22,6 +22,7 @@
 #define __WINDOWSERVER_INTERFACE_COMMANDMESSAGERESPONDERTHREAD__
 
 #include <deque>
+#include <new>
 
 typedef struct
 {
@@ -29,8 +30,33 @@ typedef struct
 	uint32_t transaction;
 	void* message;
 	size_t length;
+
+	/**
+	 * Optional memory for a response that is not sent, like the ones of the
+	 * commands within a batch.
+	 */
+	void* buffer;
+	size_t bufferLength;
 } command_message_response_t;
 
+/**
+ * Creates the response message, within the buffer of the response if there
+ * is one that is large enough.
+ */
+template <typename T>
+T* interfaceResponseCreate(command_message_response_t& response)
+{
+	T* message;
+	if(response.buffer && sizeof(T) <= response.bufferLength)
+		message = new(response.buffer) T;
+	else
+		message = new T;
+
+	response.message = message;
+	response.length = sizeof(T);
+	return message;
+}
+
 void interfaceResponderSend(command_message_response_t& response);
 void interfaceResponderThread();
 
@@ -0,0 +1,85 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "render/frame_scheduler.hpp"
+
+static uint64_t ticksPerMillisecond = 1;
+
+static inline uint64_t frameClockTicks()
+{
+	uint32_t low;
+	uint32_t high;
+	asm volatile("rdtsc"
+				 : "=a"(low), "=d"(high));
+	return ((uint64_t) high << 32) | low;
+}
+
+void frameClockCalibrate()
+{
+	// measure from one tick of the system clock to another
+	uint64_t startMillis = g_millis();
+	while(g_millis() == startMillis)
+		;
+	startMillis = g_millis();
+	uint64_t startTicks = frameClockTicks();
+
+	g_sleep(20);
+	uint64_t endMillis = g_millis();
+	while(g_millis() == endMillis)
+		;
+	endMillis = g_millis();
+	uint64_t elapsedTicks = frameClockTicks() - startTicks;
+
+	if(endMillis > startMillis)
+		ticksPerMillisecond = elapsedTicks / (endMillis - startMillis);
+	if(ticksPerMillisecond == 0)
+		ticksPerMillisecond = 1;
+}
+
+uint64_t frameClockMicros()
+{
+	// split into whole and partial milliseconds so the ticks are not multiplied
+	uint64_t ticks = frameClockTicks();
+	return ticks / ticksPerMillisecond * 1000 + (ticks % ticksPerMillisecond) * 1000 / ticksPerMillisecond;
+}
+
+frame_scheduler_t::frame_scheduler_t(uint32_t frameRate)
+{
+	interval = frameRate > 0 ? 1000000 / frameRate : 0;
+}
+
+void frame_scheduler_t::waitForFrame(g_atom trigger)
+{
+	g_atomic_lock_to(trigger, FRAME_SCHEDULER_IDLE_TIMEOUT);
+
+	// Triggers that arrive while waiting here are merged into the same frame
+	if(interval > 0)
+	{
+		uint64_t next = lastFrameStart + interval;
+		uint64_t now = frameClockMicros();
+		if(now < next && (next - now) >= 1000)
+			g_sleep((next - now) / 1000);
+	}
+}
+
+void frame_scheduler_t::frameStarted()
+{
+	lastFrameStart = frameClockMicros();
+}
@@ -0,0 +1,80 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __WINDOWSERVER_RENDER_FRAMESCHEDULER__
+#define __WINDOWSERVER_RENDER_FRAMESCHEDULER__
+
+#include <ghost.h>
+#include <stdint.h>
+
+/**
+ * Default number of frames per second the renderer is limited to.
+ */
+#define FRAME_SCHEDULER_DEFAULT_RATE 60
+
+/**
+ * Longest time in milliseconds the renderer sleeps without being triggered.
+ */
+#define FRAME_SCHEDULER_IDLE_TIMEOUT 100
+
+/**
+ * Measures the time stamp counter against the system clock, so that
+ * frameClockMicros can be used. Takes a few milliseconds.
+ */
+void frameClockCalibrate();
+
+/**
+ * @return a timestamp in microseconds with a resolution well below the
+ * millisecond of g_millis
+ */
+uint64_t frameClockMicros();
+
+/**
+ * The frame scheduler decides when the renderer starts the next frame. Frames
+ * are only rendered when something requested one, and never at a higher rate
+ * than configured, so a burst of events results in a single frame instead of
+ * one frame per event.
+ */
+class frame_scheduler_t
+{
+  private:
+	uint64_t interval;
+	uint64_t lastFrameStart = 0;
+
+  public:
+	/**
+	 * @param frameRate
+	 * 		maximum frames per second, 0 to render as often as requested
+	 */
+	frame_scheduler_t(uint32_t frameRate);
+
+	/**
+	 * Blocks until a frame is requested through the trigger (or the idle
+	 * timeout passed) and the minimum distance to the last frame is reached.
+	 */
+	void waitForFrame(g_atom trigger);
+
+	/**
+	 * Must be called when the renderer starts working on a frame.
+	 */
+	void frameStarted();
+};
+
+#endif
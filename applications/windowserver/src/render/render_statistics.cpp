@@ -0,0 +1,77 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "render/render_statistics.hpp"
+
+#include <sstream>
+
+void render_statistics_t::record(const frame_statistics_t& frame)
+{
+	g_atomic_lock(lock);
+	eventTime.add(frame.eventTime);
+	layoutTime.add(frame.layoutTime);
+	paintTime.add(frame.paintTime);
+	blitTime.add(frame.blitTime);
+	outputTime.add(frame.outputTime);
+	frameTime.add(frame.getFrameTime());
+	if(frame.inputLatency > 0)
+		inputLatency.add(frame.inputLatency);
+	g_atomic_unlock(lock);
+}
+
+void render_statistics_t::take(render_statistics_t& out)
+{
+	g_atomic_lock(lock);
+	out.eventTime = eventTime;
+	out.layoutTime = layoutTime;
+	out.paintTime = paintTime;
+	out.blitTime = blitTime;
+	out.outputTime = outputTime;
+	out.frameTime = frameTime;
+	out.inputLatency = inputLatency;
+
+	eventTime = render_statistics_value_t();
+	layoutTime = render_statistics_value_t();
+	paintTime = render_statistics_value_t();
+	blitTime = render_statistics_value_t();
+	outputTime = render_statistics_value_t();
+	frameTime = render_statistics_value_t();
+	inputLatency = render_statistics_value_t();
+	g_atomic_unlock(lock);
+}
+
+static void formatValue(std::stringstream& out, const char* name, const render_statistics_value_t& value)
+{
+	out << " " << name << "=" << value.average() << "/" << value.maximum;
+}
+
+std::string render_statistics_t::format() const
+{
+	std::stringstream out;
+	out << "frames=" << getFrames();
+	formatValue(out, "event", eventTime);
+	formatValue(out, "layout", layoutTime);
+	formatValue(out, "paint", paintTime);
+	formatValue(out, "blit", blitTime);
+	formatValue(out, "output", outputTime);
+	formatValue(out, "frame", frameTime);
+	formatValue(out, "latency", inputLatency);
+	return out.str();
+}
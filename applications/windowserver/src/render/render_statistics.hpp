@@ -0,0 +1,137 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __WINDOWSERVER_RENDER_RENDERSTATISTICS__
+#define __WINDOWSERVER_RENDER_RENDERSTATISTICS__
+
+#include <ghost.h>
+#include <stdint.h>
+#include <string>
+
+/**
+ * Measurements of a single rendered frame. Times are in microseconds.
+ */
+struct frame_statistics_t
+{
+	/**
+	 * Time spent in each phase of the frame.
+	 */
+	uint32_t eventTime = 0;
+	uint32_t layoutTime = 0;
+	uint32_t paintTime = 0;
+	uint32_t blitTime = 0;
+	uint32_t outputTime = 0;
+
+	/**
+	 * Time from the first input that went into this frame until the frame was
+	 * on the video output, or 0 if there was no input.
+	 */
+	uint32_t inputLatency = 0;
+
+	/**
+	 * Pixels blitted from component surfaces to the global buffer.
+	 */
+	uint32_t painted = 0;
+
+	/**
+	 * Pixels copied to the video output.
+	 */
+	uint32_t copied = 0;
+
+	/**
+	 * Pixels within the bounding box of the damage, which is what a single
+	 * invalid rectangle would have covered.
+	 */
+	uint32_t damageBounds = 0;
+
+	uint32_t getFrameTime() const
+	{
+		return eventTime + layoutTime + paintTime + blitTime + outputTime;
+	}
+};
+
+/**
+ * Average and maximum of a measured value.
+ */
+struct render_statistics_value_t
+{
+	uint64_t total = 0;
+	uint32_t maximum = 0;
+	uint32_t count = 0;
+
+	void add(uint32_t value)
+	{
+		total += value;
+		count++;
+		if(value > maximum)
+			maximum = value;
+	}
+
+	uint32_t average() const
+	{
+		return count > 0 ? total / count : 0;
+	}
+};
+
+/**
+ * Collects the statistics of all frames rendered within a period, for example
+ * the last second. Frames are recorded by the renderer while the values are
+ * taken by another thread.
+ */
+class render_statistics_t
+{
+  private:
+	g_atom lock = g_atomic_initialize();
+
+  public:
+	render_statistics_value_t eventTime;
+	render_statistics_value_t layoutTime;
+	render_statistics_value_t paintTime;
+	render_statistics_value_t blitTime;
+	render_statistics_value_t outputTime;
+	render_statistics_value_t frameTime;
+	render_statistics_value_t inputLatency;
+
+	/**
+	 * Adds the values of a frame.
+	 */
+	void record(const frame_statistics_t& frame);
+
+	/**
+	 * Copies the collected values to the given object and starts a new period.
+	 */
+	void take(render_statistics_t& out);
+
+	/**
+	 * @return the number of frames within the period
+	 */
+	uint32_t getFrames() const
+	{
+		return frameTime.count;
+	}
+
+	/**
+	 * Formats the values as a single line of "key=value" pairs, averages and
+	 * maximums in microseconds.
+	 */
+	std::string format() const;
+};
+
+#endif
@@ -65,3 +65,25 @@ void g_graphics::blitTo(g_graphics* graphics, g_rectangle absoluteClip, g_point
 	cairo_paint(cr);
 	cairo_restore(cr);
 }
+
+void g_graphics::clear(const region_t& region)
+{
+	cairo_save(context);
+	cairo_set_operator(context, CAIRO_OPERATOR_CLEAR);
+	for(auto& rect : region.getRectangles())
+		cairo_rectangle(context, rect.x, rect.y, rect.width, rect.height);
+	cairo_fill(context);
+	cairo_restore(context);
+}
+
+void g_graphics::blitTo(g_graphics* graphics, const region_t& absoluteClip, g_point position)
+{
+	auto cr = graphics->context;
+	cairo_save(cr);
+	cairo_set_source_surface(cr, this->surface, position.x, position.y);
+	for(auto& rect : absoluteClip.getRectangles())
+		cairo_rectangle(cr, rect.x, rect.y, rect.width, rect.height);
+	cairo_clip(cr);
+	cairo_paint(cr);
+	cairo_restore(cr);
+}
@@ -21,6 +21,8 @@
 #ifndef __WINDOWSERVER_VIDEO_GRAPHICS__
 #define __WINDOWSERVER_VIDEO_GRAPHICS__
 
+#include "video/region.hpp"
+
 #include <cairo/cairo.h>
 #include <libwindow/color_argb.hpp>
 #include <libwindow/metrics/dimension.hpp>
@@ -75,6 +77,16 @@ class g_graphics
 	}
 
 	void blitTo(g_graphics* graphics, g_rectangle absoluteClip, g_point position);
+
+	/**
+	 * Makes the given region of the surface fully transparent.
+	 */
+	void clear(const region_t& region);
+
+	/**
+	 * Blits the surface to the given graphics, painting only inside the region.
+	 */
+	void blitTo(g_graphics* graphics, const region_t& absoluteClip, g_point position);
 };
 
 #endif
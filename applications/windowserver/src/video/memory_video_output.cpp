@@ -0,0 +1,48 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "memory_video_output.hpp"
+#include <string.h>
+
+g_memory_video_output::~g_memory_video_output()
+{
+    if(buffer)
+        delete[] buffer;
+}
+
+bool g_memory_video_output::initialize()
+{
+    buffer = new g_color_argb[resolution.width * resolution.height];
+    return buffer != 0;
+}
+
+void g_memory_video_output::blit(g_rectangle invalid, g_rectangle sourceSize, g_color_argb* source)
+{
+    for(int y = invalid.y; y < invalid.y + invalid.height; y++)
+    {
+        memcpy(&buffer[y * resolution.width + invalid.x], &source[y * sourceSize.width + invalid.x],
+               invalid.width * sizeof(g_color_argb));
+    }
+}
+
+g_dimension g_memory_video_output::getResolution()
+{
+    return resolution;
+}
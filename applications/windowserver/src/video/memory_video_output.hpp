@@ -0,0 +1,49 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __MEMORY_VIDEO_OUTPUT__
+#define __MEMORY_VIDEO_OUTPUT__
+
+#include "video_output.hpp"
+
+/**
+ * A video output that copies into a buffer in memory instead of a real
+ * framebuffer. Used to run the window server headless, for example when
+ * benchmarking the render path.
+ */
+class g_memory_video_output : public g_video_output
+{
+  private:
+    g_dimension resolution;
+    g_color_argb* buffer = 0;
+
+  public:
+    g_memory_video_output(g_dimension resolution) : resolution(resolution)
+    {
+    }
+
+    virtual ~g_memory_video_output();
+
+    virtual bool initialize();
+    virtual void blit(g_rectangle invalid, g_rectangle sourceSize, g_color_argb* source);
+    virtual g_dimension getResolution();
+};
+
+#endif
@@ -0,0 +1,155 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "video/pixel_conversion.hpp"
+
+#include <cpuid.h>
+#include <emmintrin.h>
+#include <string.h>
+
+static int sse2State = -1;
+
+bool pixelConversionHasSse2()
+{
+	if(sse2State == -1)
+	{
+		uint32_t eax, ebx, ecx, edx;
+		if(__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+			sse2State = (edx & bit_SSE2) ? 1 : 0;
+		else
+			sse2State = 0;
+	}
+	return sse2State == 1;
+}
+
+pixel_converter_t pixelConverterFor(int bpp)
+{
+	bool sse2 = pixelConversionHasSse2();
+	if(bpp == 32)
+		return pixelConvertRow32;
+	if(bpp == 24)
+		return sse2 ? pixelConvertRow24Sse2 : pixelConvertRow24;
+	if(bpp == 16)
+		return sse2 ? pixelConvertRow16Sse2 : pixelConvertRow16;
+	return 0;
+}
+
+void pixelConvertRow32(void* target, const g_color_argb* source, int count)
+{
+	memcpy(target, source, count * sizeof(g_color_argb));
+}
+
+void pixelConvertRow24(void* target, const g_color_argb* source, int count)
+{
+	uint8_t* out = (uint8_t*) target;
+	for(int i = 0; i < count; i++)
+	{
+		g_color_argb color = source[i];
+		out[0] = color & 0xFF;
+		out[1] = (color >> 8) & 0xFF;
+		out[2] = (color >> 16) & 0xFF;
+		out += 3;
+	}
+}
+
+/**
+ * Packs four pixels into their lowest three bytes each, giving twelve bytes
+ * at the bottom of the register and zeroes above.
+ */
+__attribute__((target("sse2"))) static inline __m128i pixelPack24(__m128i pixels)
+{
+	const __m128i colorMask = _mm_set1_epi32(0x00FFFFFF);
+	const __m128i lowDwords = _mm_set_epi32(0, -1, 0, -1);
+	const __m128i lowQword = _mm_set_epi32(0, 0, -1, -1);
+
+	// join the pixels of each quadword to six bytes
+	pixels = _mm_and_si128(pixels, colorMask);
+	__m128i even = _mm_and_si128(pixels, lowDwords);
+	__m128i odd = _mm_srli_epi64(_mm_andnot_si128(lowDwords, pixels), 8);
+	__m128i pairs = _mm_or_si128(even, odd);
+
+	// move the upper six bytes right behind the lower ones
+	return _mm_or_si128(_mm_and_si128(pairs, lowQword), _mm_srli_si128(_mm_andnot_si128(lowQword, pairs), 2));
+}
+
+__attribute__((target("sse2"))) void pixelConvertRow24Sse2(void* target, const g_color_argb* source, int count)
+{
+	uint8_t* out = (uint8_t*) target;
+
+	// sixteen pixels become three full registers
+	while(count >= 16)
+	{
+		__m128i a = pixelPack24(_mm_loadu_si128((const __m128i*) source));
+		__m128i b = pixelPack24(_mm_loadu_si128((const __m128i*) (source + 4)));
+		__m128i c = pixelPack24(_mm_loadu_si128((const __m128i*) (source + 8)));
+		__m128i d = pixelPack24(_mm_loadu_si128((const __m128i*) (source + 12)));
+
+		_mm_storeu_si128((__m128i*) out, _mm_or_si128(a, _mm_slli_si128(b, 12)));
+		_mm_storeu_si128((__m128i*) (out + 16), _mm_or_si128(_mm_srli_si128(b, 4), _mm_slli_si128(c, 8)));
+		_mm_storeu_si128((__m128i*) (out + 32), _mm_or_si128(_mm_srli_si128(c, 8), _mm_slli_si128(d, 4)));
+
+		source += 16;
+		out += 48;
+		count -= 16;
+	}
+
+	pixelConvertRow24(out, source, count);
+}
+
+void pixelConvertRow16(void* target, const g_color_argb* source, int count)
+{
+	uint16_t* out = (uint16_t*) target;
+	for(int i = 0; i < count; i++)
+	{
+		g_color_argb color = source[i];
+		out[i] = ((color >> 8) & 0xF800) | ((color >> 5) & 0x07E0) | ((color >> 3) & 0x001F);
+	}
+}
+
+/**
+ * Converts four pixels to 5-6-5, leaving each result sign-extended in its
+ * doubleword so that the signed pack keeps all bits.
+ */
+__attribute__((target("sse2"))) static inline __m128i pixelPack16(__m128i pixels)
+{
+	__m128i red = _mm_and_si128(_mm_srli_epi32(pixels, 8), _mm_set1_epi32(0xF800));
+	__m128i green = _mm_and_si128(_mm_srli_epi32(pixels, 5), _mm_set1_epi32(0x07E0));
+	__m128i blue = _mm_and_si128(_mm_srli_epi32(pixels, 3), _mm_set1_epi32(0x001F));
+	__m128i result = _mm_or_si128(red, _mm_or_si128(green, blue));
+	return _mm_srai_epi32(_mm_slli_epi32(result, 16), 16);
+}
+
+__attribute__((target("sse2"))) void pixelConvertRow16Sse2(void* target, const g_color_argb* source, int count)
+{
+	uint16_t* out = (uint16_t*) target;
+
+	while(count >= 8)
+	{
+		__m128i low = pixelPack16(_mm_loadu_si128((const __m128i*) source));
+		__m128i high = pixelPack16(_mm_loadu_si128((const __m128i*) (source + 4)));
+		_mm_storeu_si128((__m128i*) out, _mm_packs_epi32(low, high));
+
+		source += 8;
+		out += 8;
+		count -= 8;
+	}
+
+	pixelConvertRow16(out, source, count);
+}
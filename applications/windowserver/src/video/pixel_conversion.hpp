@@ -0,0 +1,62 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __WINDOWSERVER_VIDEO_PIXELCONVERSION__
+#define __WINDOWSERVER_VIDEO_PIXELCONVERSION__
+
+#include <libwindow/color_argb.hpp>
+#include <stdint.h>
+
+/**
+ * Converts a row of ARGB32 source pixels into the pixel format of the
+ * framebuffer. The target does not need to be aligned.
+ */
+typedef void (*pixel_converter_t)(void* target, const g_color_argb* source, int count);
+
+/**
+ * Copies 32 bit pixels as they are.
+ */
+void pixelConvertRow32(void* target, const g_color_argb* source, int count);
+
+/**
+ * Converts to 24 bit pixels, stored as blue, green and red bytes.
+ */
+void pixelConvertRow24(void* target, const g_color_argb* source, int count);
+void pixelConvertRow24Sse2(void* target, const g_color_argb* source, int count);
+
+/**
+ * Converts to 16 bit pixels in 5-6-5 layout.
+ */
+void pixelConvertRow16(void* target, const g_color_argb* source, int count);
+void pixelConvertRow16Sse2(void* target, const g_color_argb* source, int count);
+
+/**
+ * @return whether the processor supports SSE2
+ */
+bool pixelConversionHasSse2();
+
+/**
+ * Returns the fastest converter for the given bit depth on this processor.
+ *
+ * @return the converter or 0 if the depth is not supported
+ */
+pixel_converter_t pixelConverterFor(int bpp);
+
+#endif
@@ -0,0 +1,186 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "video/region.hpp"
+
+bool region_t::intersection(const g_rectangle& a, const g_rectangle& b, g_rectangle& out)
+{
+	int left = a.getLeft() > b.getLeft() ? a.getLeft() : b.getLeft();
+	int top = a.getTop() > b.getTop() ? a.getTop() : b.getTop();
+	int right = a.getRight() < b.getRight() ? a.getRight() : b.getRight();
+	int bottom = a.getBottom() < b.getBottom() ? a.getBottom() : b.getBottom();
+
+	if(left >= right || top >= bottom)
+		return false;
+
+	out = g_rectangle(left, top, right - left, bottom - top);
+	return true;
+}
+
+void region_t::subtract(const g_rectangle& source, const g_rectangle& cut, std::vector<g_rectangle>& out)
+{
+	g_rectangle overlap;
+	if(!intersection(source, cut, overlap))
+	{
+		out.push_back(source);
+		return;
+	}
+
+	// band above and below the overlap span the full width
+	if(overlap.getTop() > source.getTop())
+		out.push_back(g_rectangle(source.x, source.y, source.width, overlap.getTop() - source.getTop()));
+	if(overlap.getBottom() < source.getBottom())
+		out.push_back(g_rectangle(source.x, overlap.getBottom(), source.width, source.getBottom() - overlap.getBottom()));
+
+	// left and right of the overlap only within its rows
+	if(overlap.getLeft() > source.getLeft())
+		out.push_back(g_rectangle(source.x, overlap.y, overlap.getLeft() - source.getLeft(), overlap.height));
+	if(overlap.getRight() < source.getRight())
+		out.push_back(g_rectangle(overlap.getRight(), overlap.y, source.getRight() - overlap.getRight(), overlap.height));
+}
+
+void region_t::add(const g_rectangle& rect)
+{
+	if(rect.width <= 0 || rect.height <= 0)
+		return;
+
+	// drop rectangles that are covered entirely by the new one
+	for(auto it = rectangles.begin(); it != rectangles.end();)
+	{
+		if(it->getLeft() >= rect.getLeft() && it->getTop() >= rect.getTop() &&
+		   it->getRight() <= rect.getRight() && it->getBottom() <= rect.getBottom())
+		{
+			it = rectangles.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	// cut away everything that is already part of the region
+	std::vector<g_rectangle> pieces;
+	pieces.push_back(rect);
+	std::vector<g_rectangle> remaining;
+	for(auto& existing : rectangles)
+	{
+		remaining.clear();
+		for(auto& piece : pieces)
+			subtract(piece, existing, remaining);
+		pieces.swap(remaining);
+
+		if(pieces.empty())
+			return;
+	}
+
+	rectangles.insert(rectangles.end(), pieces.begin(), pieces.end());
+
+	if(rectangles.size() > REGION_MAXIMUM_RECTANGLES)
+	{
+		g_rectangle bounds = getBounds();
+		rectangles.clear();
+		rectangles.push_back(bounds);
+	}
+}
+
+void region_t::add(const region_t& other)
+{
+	for(auto& rect : other.rectangles)
+		add(rect);
+}
+
+void region_t::subtract(const g_rectangle& rect)
+{
+	if(rect.width <= 0 || rect.height <= 0 || !intersects(rect))
+		return;
+
+	std::vector<g_rectangle> remaining;
+	for(auto& existing : rectangles)
+		subtract(existing, rect, remaining);
+	rectangles.swap(remaining);
+}
+
+void region_t::intersect(const g_rectangle& rect)
+{
+	g_rectangle overlap;
+	for(auto it = rectangles.begin(); it != rectangles.end();)
+	{
+		if(intersection(*it, rect, overlap))
+		{
+			*it = overlap;
+			++it;
+		}
+		else
+		{
+			it = rectangles.erase(it);
+		}
+	}
+}
+
+bool region_t::intersects(const g_rectangle& rect) const
+{
+	g_rectangle overlap;
+	for(auto& existing : rectangles)
+	{
+		if(intersection(existing, rect, overlap))
+			return true;
+	}
+	return false;
+}
+
+g_rectangle region_t::getBounds() const
+{
+	if(rectangles.empty())
+		return g_rectangle();
+
+	int left = rectangles[0].getLeft();
+	int top = rectangles[0].getTop();
+	int right = rectangles[0].getRight();
+	int bottom = rectangles[0].getBottom();
+	for(auto& rect : rectangles)
+	{
+		if(rect.getLeft() < left)
+			left = rect.getLeft();
+		if(rect.getTop() < top)
+			top = rect.getTop();
+		if(rect.getRight() > right)
+			right = rect.getRight();
+		if(rect.getBottom() > bottom)
+			bottom = rect.getBottom();
+	}
+	return g_rectangle(left, top, right - left, bottom - top);
+}
+
+uint32_t region_t::getArea() const
+{
+	uint32_t area = 0;
+	for(auto& rect : rectangles)
+		area += rect.width * rect.height;
+	return area;
+}
+
+void region_t::translate(int dx, int dy)
+{
+	for(auto& rect : rectangles)
+	{
+		rect.x += dx;
+		rect.y += dy;
+	}
+}
@@ -0,0 +1,130 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __WINDOWSERVER_VIDEO_REGION__
+#define __WINDOWSERVER_VIDEO_REGION__
+
+#include <libwindow/metrics/rectangle.hpp>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Maximum number of rectangles a region holds before it is collapsed into its
+ * bounding box. This keeps the cost of adding damage bounded when many small
+ * areas are invalidated within one frame. As collapsing only grows a region,
+ * opaque areas must be described with few rectangles.
+ */
+#define REGION_MAXIMUM_RECTANGLES 32
+
+/**
+ * A region is an area on the screen that is described by a list of disjoint
+ * rectangles. It is used to track damage and to remove occluded areas before
+ * anything is painted, so no pixel is drawn or copied twice.
+ */
+class region_t
+{
+  private:
+	std::vector<g_rectangle> rectangles;
+
+	/**
+	 * Writes the parts of the source that are not covered by the cut to the output.
+	 */
+	static void subtract(const g_rectangle& source, const g_rectangle& cut, std::vector<g_rectangle>& out);
+
+  public:
+	region_t()
+	{
+	}
+
+	region_t(const g_rectangle& rect)
+	{
+		add(rect);
+	}
+
+	const std::vector<g_rectangle>& getRectangles() const
+	{
+		return rectangles;
+	}
+
+	bool isEmpty() const
+	{
+		return rectangles.empty();
+	}
+
+	void clear()
+	{
+		rectangles.clear();
+	}
+
+	void swap(region_t& other)
+	{
+		rectangles.swap(other.rectangles);
+	}
+
+	/**
+	 * Adds the given rectangle to the region. Only the parts that are not yet
+	 * covered are added, so the rectangles stay disjoint.
+	 */
+	void add(const g_rectangle& rect);
+
+	/**
+	 * Adds all rectangles of the given region.
+	 */
+	void add(const region_t& other);
+
+	/**
+	 * Removes the given rectangle from the region.
+	 */
+	void subtract(const g_rectangle& rect);
+
+	/**
+	 * Clips the region to the given rectangle.
+	 */
+	void intersect(const g_rectangle& rect);
+
+	/**
+	 * @return whether any part of the region overlaps the given rectangle
+	 */
+	bool intersects(const g_rectangle& rect) const;
+
+	/**
+	 * @return the smallest rectangle that contains the whole region
+	 */
+	g_rectangle getBounds() const;
+
+	/**
+	 * @return the number of pixels covered by the region
+	 */
+	uint32_t getArea() const;
+
+	/**
+	 * Moves the region by the given offset.
+	 */
+	void translate(int dx, int dy);
+
+	/**
+	 * Calculates the intersection of two rectangles.
+	 *
+	 * @return whether the rectangles overlap
+	 */
+	static bool intersection(const g_rectangle& a, const g_rectangle& b, g_rectangle& out);
+};
+
+#endif
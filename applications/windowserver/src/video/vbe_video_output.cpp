@@ -29,43 +29,31 @@ bool g_vbe_video_output::initializeWithSettings(uint32_t width, uint32_t height,
         klog("failed to initialize video... retrying in 3 seconds");
         g_sleep(3000);
     }
+
+    converter = pixelConverterFor(video_mode_information.bpp);
+    if(!converter)
+    {
+        klog("video mode with %i bits per pixel is not supported", video_mode_information.bpp);
+        return false;
+    }
     return true;
 }
 
 void g_vbe_video_output::blit(g_rectangle invalid, g_rectangle sourceSize, g_color_argb* source)
 {
+    if(!converter || invalid.width <= 0)
+        return;
 
-    uint16_t bpp = video_mode_information.bpp;
-    uint8_t* position = ((uint8_t*) video_mode_information.lfb) + (invalid.y * video_mode_information.bpsl);
+    uint32_t bytesPerPixel = (video_mode_information.bpp + 7) / 8;
+    uint8_t* position = ((uint8_t*) video_mode_information.lfb) + (invalid.y * video_mode_information.bpsl) +
+                        invalid.x * bytesPerPixel;
+    const g_color_argb* row = source + invalid.y * sourceSize.width + invalid.x;
 
-    uint32_t right = invalid.x + invalid.width;
-    uint32_t bottom = invalid.y + invalid.height;
-
-    if(bpp == 32)
-    {
-        for(int y = invalid.y; y < bottom; y++)
-        {
-            uint32_t* position4 = (uint32_t*) position;
-            for(int x = invalid.x; x < right; x++)
-            {
-                position4[x] = source[y * sourceSize.width + x];
-            }
-            position += video_mode_information.bpsl;
-        }
-    }
-    else if(bpp == 24)
+    for(int y = 0; y < invalid.height; y++)
     {
-        for(int y = invalid.y; y < bottom; y++)
-        {
-            for(int x = invalid.x; x < right; x++)
-            {
-                g_color_argb color = source[y * sourceSize.width + x];
-                position[x * 3] = color & 0xFF;
-                position[x * 3 + 1] = (color >> 8) & 0xFF;
-                position[x * 3 + 2] = (color >> 16) & 0xFF;
-            }
-            position += video_mode_information.bpsl;
-        }
+        converter(position, row, invalid.width);
+        position += video_mode_information.bpsl;
+        row += sourceSize.width;
     }
 }
 
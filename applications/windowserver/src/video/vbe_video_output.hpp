@@ -22,6 +22,7 @@
 #define __VBE_VIDEO_OUTPUT__
 
 #include "configuration_based_video_output.hpp"
+#include "pixel_conversion.hpp"
 #include <libvbedriver/vbedriver.hpp>
 
 /**
@@ -31,6 +32,7 @@ class g_vbe_video_output : public g_configuration_based_video_output
 {
   private:
     g_vbe_mode_info video_mode_information;
+    pixel_converter_t converter = 0;
 
   public:
     virtual bool initializeWithSettings(uint32_t width, uint32_t height, uint32_t bits);
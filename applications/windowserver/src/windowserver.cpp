@@ -19,6 +19,7 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "windowserver.hpp"
+#include "benchmark.hpp"
 #include "components/button.hpp"
 #include "components/cursor.hpp"
 #include "components/desktop/background.hpp"
@@ -36,15 +37,36 @@
 #include <iostream>
 #include <libproperties/parser.hpp>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <typeinfo>
 
 static windowserver_t* server;
 static g_atom dispatch_lock = g_atomic_initialize();
-static int framesTotal = 0;
 
 int main(int argc, char** argv)
 {
 	server = new windowserver_t();
+
+	bool benchmark = false;
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--benchmark") == 0)
+			benchmark = true;
+		else if(strcmp(argv[i], "--statistics") == 0)
+			server->logStatistics = true;
+		else if(strncmp(argv[i], "--frame-rate=", 13) == 0)
+			server->frameRate = atoi(argv[i] + 13);
+		else
+			klog("unknown argument '%s'", argv[i]);
+	}
+
+	if(benchmark)
+	{
+		benchmark_t::run(server);
+		return 0;
+	}
+
 	server->launch();
 	return 0;
 }
@@ -73,6 +95,7 @@ void windowserver_t::launch()
 	event_processor = new event_processor_t();
 
 	g_task_register_id("windowserver");
+	frameClockCalibrate();
 	initializeGraphics();
 	g_create_thread((void*) &windowserver_t::initializeInput);
 
@@ -102,7 +125,7 @@ void windowserver_t::createVitalComponents(g_rectangle screenBounds)
 	stateLabel = new label_t();
 	stateLabel->setTitle("");
 	stateLabel->setAlignment(g_text_alignment::RIGHT);
-	stateLabel->setBounds(g_rectangle(screenBounds.width - 200, screenBounds.height - 30, 200, 30));
+	stateLabel->setBounds(g_rectangle(screenBounds.width - 400, screenBounds.height - 30, 400, 30));
 	background->addChild(stateLabel);
 
 	// background.load("/system/graphics/wallpaper.png");
@@ -130,24 +153,77 @@ void windowserver_t::renderLoop(g_rectangle screenBounds)
 	global.resize(screenBounds.width, screenBounds.height, false);
 
 	cursor_t::nextPosition = g_point(screenBounds.width / 2, screenBounds.height / 2);
+	event_processor->input.pushMouse(cursor_t::nextPosition, cursor_t::nextPressedButtons);
 
+	frame_scheduler_t scheduler(frameRate);
+	frame_statistics_t frame;
 	g_atomic_lock(render_atom);
 	while(true)
 	{
-		event_processor->process();
+		scheduler.frameStarted();
+		renderFrame(&global, screenBounds, frame);
+		statistics.record(frame);
+
+		scheduler.waitForFrame(render_atom);
+	}
+}
+
+void windowserver_t::renderFrame(g_graphics* global, g_rectangle screenBounds, frame_statistics_t& statistics)
+{
+	statistics = frame_statistics_t();
+
+	g_atomic_lock(pending_input_lock);
+	uint64_t inputTime = pendingInput;
+	pendingInput = 0;
+	g_atomic_unlock(pending_input_lock);
+
+	uint64_t start = frameClockMicros();
+	event_processor->process();
+	uint64_t eventsDone = frameClockMicros();
 
-		screen->resolveRequirement(COMPONENT_REQUIREMENT_UPDATE);
-		screen->resolveRequirement(COMPONENT_REQUIREMENT_LAYOUT);
-		screen->resolveRequirement(COMPONENT_REQUIREMENT_PAINT);
+	screen->resolveRequirement(COMPONENT_REQUIREMENT_UPDATE);
+	screen->resolveRequirement(COMPONENT_REQUIREMENT_LAYOUT);
+	uint64_t layoutDone = frameClockMicros();
 
-		screen->blit(&global, screenBounds, g_point(0, 0));
-		cursor_t::paint(&global);
+	screen->resolveRequirement(COMPONENT_REQUIREMENT_PAINT);
+	uint64_t paintDone = frameClockMicros();
 
-		blit(&global);
+	statistics.eventTime = eventsDone - start;
+	statistics.layoutTime = layoutDone - eventsDone;
+	statistics.paintTime = paintDone - layoutDone;
 
-		framesTotal++;
-		g_atomic_lock_to(render_atom, 100);
+	region_t invalid = screen->grabInvalid();
+	if(invalid.isEmpty())
+	{
+		if(inputTime)
+			statistics.inputLatency = paintDone - inputTime;
+		return;
 	}
+
+	// The cursor is painted over the global buffer, so if the damage touches it
+	// the whole area below must be restored before painting it again
+	g_rectangle cursorArea = cursor_t::getArea();
+	bool paintCursor = invalid.intersects(cursorArea);
+	if(paintCursor)
+	{
+		invalid.add(cursorArea);
+		invalid.intersect(screenBounds);
+	}
+
+	statistics.painted = screen->blit(global, invalid, g_point(0, 0));
+	if(paintCursor)
+		cursor_t::paint(global);
+	uint64_t blitDone = frameClockMicros();
+
+	statistics.copied = blit(global, invalid);
+	g_rectangle bounds = invalid.getBounds();
+	statistics.damageBounds = bounds.width * bounds.height;
+	uint64_t outputDone = frameClockMicros();
+
+	statistics.blitTime = blitDone - paintDone;
+	statistics.outputTime = outputDone - blitDone;
+	if(inputTime)
+		statistics.inputLatency = outputDone - inputTime;
 }
 
 void windowserver_t::triggerRender()
@@ -155,16 +231,24 @@ void windowserver_t::triggerRender()
 	g_atomic_unlock(render_atom);
 }
 
-void windowserver_t::blit(g_graphics* graphics)
+void windowserver_t::inputReceived()
 {
-	g_rectangle invalid = screen->grabInvalid();
-	if(invalid.width == 0 && invalid.height == 0)
-		return;
+	uint64_t now = frameClockMicros();
+	g_atomic_lock(pending_input_lock);
+	if(pendingInput == 0)
+		pendingInput = now;
+	g_atomic_unlock(pending_input_lock);
+}
 
+uint32_t windowserver_t::blit(g_graphics* graphics, const region_t& invalid)
+{
 	g_dimension resolution = video_output->getResolution();
 	g_rectangle screenBounds(0, 0, resolution.width, resolution.height);
 	g_color_argb* buffer = (g_color_argb*) cairo_image_surface_get_data(graphics->getSurface());
-	video_output->blit(invalid, screenBounds, buffer);
+
+	for(auto& rect : invalid.getRectangles())
+		video_output->blit(rect, screenBounds, buffer);
+	return invalid.getArea();
 }
 
 void windowserver_t::loadCursor()
@@ -235,15 +319,23 @@ void windowserver_t::fpsCounter()
 	int seconds = 0;
 
 	int renders = 0;
+	windowserver_t* instance = windowserver_t::instance();
+	render_statistics_t second;
 	for(;;)
 	{
 		g_sleep(1000);
 		seconds++;
+		instance->statistics.take(second);
+		if(instance->logStatistics)
+			klog("frame statistics: %s", second.format().c_str());
+
 		std::stringstream s;
-		s << "FPS: " << framesTotal << ", Time: " << renders++ << "s";
-		windowserver_t::instance()->stateLabel->setTitle(s.str());
-		windowserver_t::instance()->triggerRender();
-		framesTotal = 0;
+		s << "FPS: " << second.getFrames() << ", Frame: " << second.frameTime.average() << "us";
+		if(second.inputLatency.count > 0)
+			s << ", Latency: " << second.inputLatency.average() << "us";
+		s << ", Time: " << renders++ << "s";
+		instance->stateLabel->setTitle(s.str());
+		instance->triggerRender();
 	}
 }
 
@@ -26,6 +26,9 @@
 #include "components/desktop/screen.hpp"
 #include "components/label.hpp"
 #include "events/event_processor.hpp"
+#include "render/frame_scheduler.hpp"
+#include "render/render_statistics.hpp"
+#include "video/region.hpp"
 #include "video/video_output.hpp"
 
 /**
@@ -41,6 +44,24 @@ class windowserver_t
 	label_t* stateLabel;
 	g_atom render_atom = g_atomic_initialize();
 
+	/**
+	 * Maximum frames per second, 0 for no limit.
+	 */
+	uint32_t frameRate = FRAME_SCHEDULER_DEFAULT_RATE;
+
+	/**
+	 * Statistics of the frames rendered since they were last taken. If enabled,
+	 * a summary is written to the log every second.
+	 */
+	render_statistics_t statistics;
+	bool logStatistics = false;
+
+	/**
+	 * Time of the oldest input that was not yet processed by a frame.
+	 */
+	uint64_t pendingInput = 0;
+	g_atom pending_input_lock = g_atomic_initialize();
+
 	/**
 	 * Sets up the windowing system by configuring a video output, setting up the
 	 * event processor and running the main loop. Each step of the main loop includes
@@ -53,14 +74,28 @@ class windowserver_t
 	void loadCursor();
 
 	void renderLoop(g_rectangle screenBounds);
+
+	/**
+	 * Processes events, resolves all component requirements and puts the
+	 * damaged area on the video output.
+	 */
+	void renderFrame(g_graphics* global, g_rectangle screenBounds, frame_statistics_t& statistics);
 	void triggerRender();
+
+	/**
+	 * Must be called by input receivers before triggering a render, so that the
+	 * latency until the input is visible can be measured.
+	 */
+	void inputReceived();
 	static void initializeInput();
 	static void fpsCounter();
 
 	/**
-	 * Blits the component state.
+	 * Copies the invalid region of the global buffer to the video output.
+	 *
+	 * @return the number of pixels that were copied
 	 */
-	void blit(g_graphics* graphics);
+	uint32_t blit(g_graphics* graphics, const region_t& invalid);
 
 	/**
 	 * Dispatches the given event to the component.
@@ -0,0 +1,10 @@
+
+if [ -e $1-test.cpp ]; then
+	g++ -O2 -I../src -I../../libwindow/inc -I../../libinput/inc -I../../../libapi/inc -idirafter ../../../libc/inc $1-test.cpp -o $1-test -pthread
+	if [ $? -ne 0 ]; then
+		exit 1
+	fi
+	./$1-test "${@:2}"
+else
+	echo "test $1 does not exist"
+fi
@@ -0,0 +1,307 @@
+#include <iostream>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "../src/input/input_queue.hpp"
+
+// Atoms are simulated with binary semaphores
+static sem_t atoms[16];
+static int atom_count = 0;
+
+g_atom g_atomic_initialize() {
+	sem_init(&atoms[atom_count], 0, 1);
+	return ++atom_count;
+}
+
+void g_atomic_lock(g_atom atom) {
+	sem_wait(&atoms[atom - 1]);
+}
+
+void g_atomic_unlock(g_atom atom) {
+	sem_post(&atoms[atom - 1]);
+}
+
+#include "../src/input/input_queue.cpp"
+
+#define TEST(name) \
+	std::cout << #name << ": "; \
+	if(test_##name()) { \
+		std::cout << "success" << std::endl; \
+	} else { \
+		std::cout << "fail" << std::endl; \
+		failed = true; \
+	}
+
+static g_key_info key(int scancode, bool pressed = true) {
+	g_key_info info;
+	info.scancode = scancode;
+	info.pressed = pressed;
+	return info;
+}
+
+/**
+ * Replays a script where each character is one input event and "|" is a frame
+ * in which the renderer takes all queued events:
+ *
+ *   m  mouse move by one pixel to the right
+ *   +  press of the first button at the current position
+ *   -  release of all buttons at the current position
+ *   0-9, a-z  key with that character as scancode
+ *
+ * The processed events are written to the given string with keys as they are,
+ * mouse events as M, or P while the button is held, followed by the x
+ * coordinate. Returns the number of
+ * renders the producers would have triggered.
+ */
+static int replay(const char* script, std::string& processed, uint32_t* received = nullptr) {
+	input_queue_t queue;
+	std::deque<input_event_t> events;
+	g_point position(0, 0);
+	g_mouse_button buttons = G_MOUSE_BUTTON_NONE;
+	int renders = 0;
+	uint32_t total = 0;
+
+	for (const char* c = script;; c++) {
+		if (*c == '|' || *c == 0) {
+			events.clear();
+			total += queue.take(events);
+			for (auto& event : events) {
+				if (event.type == INPUT_EVENT_KEY) {
+					processed += (char) event.key.scancode;
+				} else {
+					processed += event.buttons ? 'P' : 'M';
+					processed += std::to_string(event.position.x);
+				}
+			}
+			processed += '|';
+			if (*c == 0) break;
+			continue;
+		}
+
+		bool first;
+		if (*c == 'm') {
+			position.x++;
+			first = queue.pushMouse(position, buttons);
+		} else if (*c == '+') {
+			buttons = G_MOUSE_BUTTON_1;
+			first = queue.pushMouse(position, buttons);
+		} else if (*c == '-') {
+			buttons = G_MOUSE_BUTTON_NONE;
+			first = queue.pushMouse(position, buttons);
+		} else {
+			first = queue.pushKey(key(*c));
+		}
+		if (first) renders++;
+	}
+
+	if (received) *received = total;
+	return renders;
+}
+
+static bool expect(const char* script, const char* expected, int expectedRenders) {
+	std::string processed;
+	int renders = replay(script, processed);
+	if (processed != expected || renders != expectedRenders) {
+		std::cout << std::endl << "\t" << script << " gave " << processed << " with " << renders << " renders, expected "
+				<< expected << " with " << expectedRenders;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Keys in a burst come out in the order they were typed.
+ */
+bool test_key_order() {
+	return expect("hello0world", "hello0world|", 1) && expect("abc|def|ghi", "abc|def|ghi|", 3);
+}
+
+/**
+ * A burst of moves ends up as one event with the last position.
+ */
+bool test_mouse_coalescing() {
+	return expect("mmmmmmmmmm", "M10|", 1) && expect("mmm|mmmm||m", "M3|M7||M8|", 3);
+}
+
+/**
+ * Moves are not merged across keys, so each key sees the cursor where it was
+ * when the key was typed.
+ */
+bool test_keys_split_moves() {
+	return expect("mmmammbmmmc", "M3aM5bM8c|", 1);
+}
+
+/**
+ * Press and release are kept at the position where they happened, even without
+ * a move between them, and moves while a button is held become a single drag.
+ */
+bool test_buttons_kept() {
+	return expect("mm+-mm", "M2P2M2M4|", 1) && expect("+mmmm-", "P0P4M4|", 1) && expect("+-|+-", "P0M0|P0M0|", 2)
+			&& expect("+mm|mm-", "P0P2|P4M4|", 2);
+}
+
+struct burst_t {
+	const char* name;
+	std::string script;
+	int maximumEvents;
+	int maximumRenders;
+};
+
+static std::string repeat(const std::string& part, int times) {
+	std::string result;
+	for (int i = 0; i < times; i++) result += part;
+	return result;
+}
+
+/**
+ * Bursts like they come from the devices between two frames. The cost of a
+ * frame is the number of events the renderer has to process, which must not
+ * grow with the mouse rate, and there must be a single render per frame.
+ */
+bool test_processing_cost() {
+	std::vector<burst_t> bursts = {
+		// a 1000 Hz mouse during 60 frames
+		{"fast mouse", repeat(repeat("m", 16) + "|", 60), 60, 60},
+		// typing while the mouse moves
+		{"typing", repeat("mmmamm|mmbmmm|mmmmcd|", 20), 200, 60},
+		// dragging: press, move a lot, release
+		{"drag", repeat("+" + repeat("m", 200) + "-|", 10), 30, 10},
+	};
+
+	for (auto& burst : bursts) {
+		std::string processed;
+		uint32_t received;
+		int renders = replay(burst.script.c_str(), processed, &received);
+
+		int events = 0;
+		for (char c : processed) {
+			if (c == 'M' || c == 'P' || (c >= 'a' && c <= 'z')) events++;
+		}
+
+		printf("\n\t%-10s received %5u, processed %4i, renders %3i", burst.name, received, events, renders);
+		if (events > burst.maximumEvents || renders > burst.maximumRenders) return false;
+	}
+	return true;
+}
+
+#define PRODUCER_KEYS 20000
+#define PRODUCER_MOVES 100000
+
+static input_queue_t sharedQueue;
+static volatile int renderRequests = 0;
+
+static void* keyProducer(void*) {
+	for (int i = 0; i < PRODUCER_KEYS; i++) {
+		if (sharedQueue.pushKey(key(i))) __sync_fetch_and_add(&renderRequests, 1);
+	}
+	return nullptr;
+}
+
+static void* mouseProducer(void*) {
+	for (int i = 1; i <= PRODUCER_MOVES; i++) {
+		if (sharedQueue.pushMouse(g_point(i, 0), G_MOUSE_BUTTON_NONE)) __sync_fetch_and_add(&renderRequests, 1);
+	}
+	return nullptr;
+}
+
+/**
+ * Both receivers push concurrently while the renderer drains. Keys must arrive
+ * complete and in order, the cursor must never move backwards, and there must
+ * not be more render requests than batches taken.
+ */
+bool test_concurrent_receivers() {
+	pthread_t keys, mouse;
+	pthread_create(&keys, nullptr, keyProducer, nullptr);
+	pthread_create(&mouse, nullptr, mouseProducer, nullptr);
+
+	int nextKey = 0;
+	int lastX = 0;
+	int batches = 0;
+	uint32_t received = 0;
+	std::deque<input_event_t> events;
+	while (nextKey < PRODUCER_KEYS || lastX < PRODUCER_MOVES) {
+		events.clear();
+		received += sharedQueue.take(events);
+		if (events.empty()) continue;
+		batches++;
+
+		for (auto& event : events) {
+			if (event.type == INPUT_EVENT_KEY) {
+				if (event.key.scancode != nextKey) {
+					std::cout << std::endl << "\tkey " << event.key.scancode << " where " << nextKey << " was expected";
+					return false;
+				}
+				nextKey++;
+			} else {
+				if (event.position.x < lastX) {
+					std::cout << std::endl << "\tcursor moved back from " << lastX << " to " << event.position.x;
+					return false;
+				}
+				lastX = event.position.x;
+			}
+		}
+	}
+
+	pthread_join(keys, nullptr);
+	pthread_join(mouse, nullptr);
+	return received == PRODUCER_KEYS + PRODUCER_MOVES && renderRequests <= batches;
+}
+
+static double now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+/**
+ * Prints the time per pushed event for bursts of different sizes, including
+ * taking them out again.
+ */
+void benchmark() {
+	static const int sizes[] = {1, 16, 256};
+	input_queue_t queue;
+	std::deque<input_event_t> events;
+
+	printf("%-6s %14s %14s\n", "burst", "mouse", "mixed");
+	for (int size : sizes) {
+		double results[2];
+		for (int mixed = 0; mixed < 2; mixed++) {
+			int rounds = 4000000 / size;
+			double start = now();
+			for (int round = 0; round < rounds; round++) {
+				for (int i = 0; i < size; i++) {
+					if (mixed && i % 4 == 3) queue.pushKey(key(i));
+					else queue.pushMouse(g_point(i, round), G_MOUSE_BUTTON_NONE);
+				}
+				events.clear();
+				queue.take(events);
+			}
+			results[mixed] = (now() - start) * 1000000000 / ((double) rounds * size);
+		}
+		printf("%-6i %11.1f ns %11.1f ns\n", size, results[0], results[1]);
+	}
+}
+
+/**
+ * Runs the correctness tests, or the throughput benchmark with "--bench".
+ */
+int main(int argc, char** argv) {
+	if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+		benchmark();
+		return 0;
+	}
+
+	bool failed = false;
+	TEST(key_order);
+	TEST(mouse_coalescing);
+	TEST(keys_split_moves);
+	TEST(buttons_kept);
+	TEST(processing_cost);
+	TEST(concurrent_receivers);
+	return failed ? 1 : 0;
+}
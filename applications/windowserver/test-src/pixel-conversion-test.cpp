@@ -0,0 +1,244 @@
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/video/pixel_conversion.cpp"
+
+#define TEST(name) \
+	std::cout << #name << ": "; \
+	if(test_##name()) { \
+		std::cout << "success" << std::endl; \
+	} else { \
+		std::cout << "fail" << std::endl; \
+		failed = true; \
+	}
+
+#define MAXIMUM_COUNT 100
+#define GUARD 0xAB
+
+static g_color_argb source[MAXIMUM_COUNT + 4];
+static uint8_t target[MAXIMUM_COUNT * 4 + 64];
+static uint8_t expected[MAXIMUM_COUNT * 4 + 64];
+
+static void fill_random(g_color_argb* buffer, int count) {
+	for (int i = 0; i < count; i++) {
+		buffer[i] = ((uint32_t) rand() << 16) ^ (uint32_t) rand();
+	}
+}
+
+/**
+ * Reference conversion of a single pixel, written out channel by channel.
+ */
+static void convert_reference(uint8_t* out, g_color_argb color, int bpp) {
+	uint32_t r = ARGB_R_FROM(color);
+	uint32_t g = ARGB_G_FROM(color);
+	uint32_t b = ARGB_B_FROM(color);
+	if (bpp == 32) {
+		memcpy(out, &color, 4);
+	} else if (bpp == 24) {
+		out[0] = b;
+		out[1] = g;
+		out[2] = r;
+	} else {
+		uint16_t value = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+		memcpy(out, &value, 2);
+	}
+}
+
+/**
+ * Every count up to the maximum at every source and target alignment, checking
+ * that the bytes around the target are untouched.
+ */
+static bool check_converter(pixel_converter_t converter, int bpp, const char* name) {
+	int bytes = bpp / 8;
+	for (int round = 0; round < 4; round++) {
+		fill_random(source, MAXIMUM_COUNT + 4);
+		for (int source_align = 0; source_align < 4; source_align++) {
+			for (int target_align = 0; target_align < 16; target_align++) {
+				for (int count = 0; count <= MAXIMUM_COUNT; count++) {
+					memset(target, GUARD, sizeof(target));
+					memset(expected, GUARD, sizeof(expected));
+					for (int i = 0; i < count; i++) {
+						convert_reference(expected + 16 + target_align + i * bytes, source[source_align + i], bpp);
+					}
+
+					converter(target + 16 + target_align, source + source_align, count);
+					if (memcmp(target, expected, sizeof(target)) != 0) {
+						std::cout << std::endl << "\t" << name << " failed for source alignment " << source_align
+								<< ", target alignment " << target_align << ", count " << count;
+						return false;
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
+
+bool test_row32() {
+	return check_converter(pixelConvertRow32, 32, "pixelConvertRow32");
+}
+
+bool test_row24() {
+	return check_converter(pixelConvertRow24, 24, "pixelConvertRow24");
+}
+
+bool test_row24_sse2() {
+	return !pixelConversionHasSse2() || check_converter(pixelConvertRow24Sse2, 24, "pixelConvertRow24Sse2");
+}
+
+bool test_row16() {
+	return check_converter(pixelConvertRow16, 16, "pixelConvertRow16");
+}
+
+bool test_row16_sse2() {
+	return !pixelConversionHasSse2() || check_converter(pixelConvertRow16Sse2, 16, "pixelConvertRow16Sse2");
+}
+
+/**
+ * Every channel value must end up in the right place, including the ones
+ * where the 16 bit result has its highest bit set.
+ */
+bool test_channels() {
+	for (int bpp = 16; bpp <= 32; bpp += 8) {
+		pixel_converter_t converter = pixelConverterFor(bpp);
+		for (uint32_t value = 0; value < 256; value++) {
+			for (int channel = 0; channel < 4; channel++) {
+				for (int i = 0; i < 16; i++) {
+					source[i] = value << (channel * 8);
+				}
+				memset(expected, 0, sizeof(expected));
+				for (int i = 0; i < 16; i++) {
+					convert_reference(expected + i * bpp / 8, source[i], bpp);
+				}
+				memset(target, 0, sizeof(target));
+				converter(target, source, 16);
+				if (memcmp(target, expected, 16 * bpp / 8) != 0) {
+					std::cout << std::endl << "\t" << bpp << " bpp failed for value " << value << " in channel " << channel;
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * The loop that the VBE output used before, converting pixel by pixel with
+ * the index calculated for each one.
+ */
+static void blit_legacy(uint8_t* lfb, uint32_t bpsl, int bpp, g_color_argb* buffer, int width, int x0, int y0, int w, int h) {
+	uint8_t* position = lfb + y0 * bpsl;
+	for (int y = y0; y < y0 + h; y++) {
+		for (int x = x0; x < x0 + w; x++) {
+			g_color_argb color = buffer[y * width + x];
+			if (bpp == 32) {
+				((uint32_t*) position)[x] = color;
+			} else if (bpp == 24) {
+				position[x * 3] = color & 0xFF;
+				position[x * 3 + 1] = (color >> 8) & 0xFF;
+				position[x * 3 + 2] = (color >> 16) & 0xFF;
+			} else {
+				((uint16_t*) position)[x] = ((color >> 8) & 0xF800) | ((color >> 5) & 0x07E0) | ((color >> 3) & 0x001F);
+			}
+		}
+		position += bpsl;
+	}
+}
+
+/**
+ * Same as the VBE output does now, one converter call per row.
+ */
+static void blit_rows(uint8_t* lfb, uint32_t bpsl, pixel_converter_t converter, int bpp, g_color_argb* buffer, int width,
+		int x0, int y0, int w, int h) {
+	uint8_t* position = lfb + y0 * bpsl + x0 * (bpp / 8);
+	g_color_argb* row = buffer + y0 * width + x0;
+	for (int y = 0; y < h; y++) {
+		converter(position, row, w);
+		position += bpsl;
+		row += width;
+	}
+}
+
+static double now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+/**
+ * Prints the throughput in source megapixels per second of the old per-pixel
+ * loop, the scalar row converters and the selected converters for several
+ * resolutions, depths and shapes of the dirty rectangle.
+ */
+void benchmark() {
+	static const int resolutions[][2] = {{800, 600}, {1024, 768}, {1920, 1080}};
+	static const int depths[] = {32, 24, 16};
+	static const char* shapes[] = {"full", "wide", "tall", "small"};
+
+	printf("sse2: %s\n", pixelConversionHasSse2() ? "yes" : "no");
+	printf("%-10s %4s %-6s %12s %12s %12s\n", "resolution", "bpp", "shape", "legacy", "scalar", "selected");
+
+	for (int r = 0; r < 3; r++) {
+		int width = resolutions[r][0];
+		int height = resolutions[r][1];
+		g_color_argb* buffer = (g_color_argb*) malloc(width * height * sizeof(g_color_argb));
+		fill_random(buffer, width * height);
+
+		for (int d = 0; d < 3; d++) {
+			int bpp = depths[d];
+			uint32_t bpsl = width * bpp / 8;
+			uint8_t* lfb = (uint8_t*) malloc(bpsl * height);
+			pixel_converter_t scalar = bpp == 32 ? pixelConvertRow32 : (bpp == 24 ? pixelConvertRow24 : pixelConvertRow16);
+			pixel_converter_t selected = pixelConverterFor(bpp);
+
+			for (int s = 0; s < 4; s++) {
+				// full screen, a wide strip like a title bar, a tall strip like a scrollbar and a cursor-sized rectangle
+				int x = 0, y = 0, w = width, h = height;
+				if (s == 1) { x = 10; y = height / 3; w = width - 20; h = 32; }
+				if (s == 2) { x = width / 2 + 1; y = 0; w = 17; h = height; }
+				if (s == 3) { x = width / 3 + 3; y = height / 3; w = 24; h = 24; }
+
+				uint64_t pixels = 0;
+				uint64_t target_pixels = 64 * 1024 * 1024;
+				int rounds = target_pixels / (w * h) + 1;
+				double results[3];
+				for (int impl = 0; impl < 3; impl++) {
+					double start = now();
+					for (int round = 0; round < rounds; round++) {
+						if (impl == 0) blit_legacy(lfb, bpsl, bpp, buffer, width, x, y, w, h);
+						else blit_rows(lfb, bpsl, impl == 1 ? scalar : selected, bpp, buffer, width, x, y, w, h);
+					}
+					pixels = (uint64_t) rounds * w * h;
+					results[impl] = pixels / (now() - start) / 1000000;
+				}
+
+				printf("%4ix%-5i %4i %-6s %9.0f Mp/s %7.0f Mp/s %7.0f Mp/s\n", width, height, bpp, shapes[s],
+						results[0], results[1], results[2]);
+			}
+			free(lfb);
+		}
+		free(buffer);
+	}
+}
+
+/**
+ * Runs the correctness tests, or the throughput benchmark with "--bench".
+ */
+int main(int argc, char** argv) {
+	if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+		benchmark();
+		return 0;
+	}
+
+	bool failed = false;
+	TEST(row32);
+	TEST(row24);
+	TEST(row24_sse2);
+	TEST(row16);
+	TEST(row16_sse2);
+	TEST(channels);
+	return failed ? 1 : 0;
+}
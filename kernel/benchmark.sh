@@ -0,0 +1,156 @@
+#!/bin/bash
+ROOT=".."
+if [ -f "$ROOT/variables.sh" ]; then
+	. "$ROOT/variables.sh"
+fi
+. "$ROOT/ghost.sh"
+
+#
+# System benchmark harness
+#
+# Builds a copy of the image whose command line asks the kernel to start the
+# benchmark runner once the desktop is up, boots it headless in QEMU and
+# collects the "benchmark:" result lines from the serial output. Each metric
+# is the median over all repetitions and boots; it is compared against a
+# baseline file and the harness fails if anything got worse than the
+# threshold allows. Units ending in "/s" are better when higher, counts of
+# "nodes" are informational and everything else is better when lower.
+#
+#   ./benchmark.sh                        run all suites, compare with baseline
+#   ./benchmark.sh syscall,ipc,pipe       run only the given suites
+#   ./benchmark.sh --update-baseline      store the medians as new baseline
+#
+with QEMU						qemu-system-i386
+with QEMU_FLAGS					"-m 1024 -smp 4 -display none"
+with GRUB_MKRESCUE				grub-mkrescue
+with BENCHMARK_ISO_SRC			"iso"
+with BENCHMARK_BOOTS			1
+with BENCHMARK_REPEAT			3
+with BENCHMARK_TIMEOUT			600
+with BENCHMARK_THRESHOLD		10
+with BENCHMARK_BASELINE			"benchmark.baseline"
+OUTDIR="bin/benchmark"
+
+UPDATE_BASELINE=0
+SUITES="all"
+for arg in "$@"; do
+	if [[ "$arg" == "--update-baseline" ]]; then
+		UPDATE_BASELINE=1
+	elif [[ "$arg" == -* ]]; then
+		echo "unknown argument: '$arg'"
+		exit 1
+	else
+		SUITES="$arg"
+	fi
+done
+
+requireTool $QEMU
+requireTool $GRUB_MKRESCUE
+if [ ! -f "$BENCHMARK_ISO_SRC/boot/kernel" ] || [ ! -f "$BENCHMARK_ISO_SRC/boot/ramdisk" ]; then
+	>&2 echo "error: kernel or ramdisk missing in $BENCHMARK_ISO_SRC, build them first"
+	exit 1
+fi
+
+rm -rf $OUTDIR
+mkdir -p $OUTDIR
+
+headline "building benchmark image"
+ISO="$OUTDIR/benchmark.iso"
+cp -r $BENCHMARK_ISO_SRC $OUTDIR/iso
+sed -i "s|multiboot /boot/loader.*|multiboot /boot/loader benchmark=$SUITES benchmark-repeat=$BENCHMARK_REPEAT|" $OUTDIR/iso/boot/grub/grub.cfg
+$GRUB_MKRESCUE --output=$ISO $OUTDIR/iso > $OUTDIR/grub-mkrescue.log 2>&1
+failOnError
+list "suites: $SUITES, $BENCHMARK_REPEAT repetitions per boot"
+
+#
+# Boots once and writes "<metric> <value> <unit>" lines for each repetition
+#
+#	bootOnce 1
+#
+bootOnce() {
+	local log="$OUTDIR/serial-$1.log"
+	local result="$OUTDIR/run-$1.txt"
+
+	$QEMU -cdrom $ISO $QEMU_FLAGS -serial file:$log &
+	local pid=$!
+
+	local deadline=$((SECONDS + BENCHMARK_TIMEOUT))
+	while ! grep -q "benchmark-done" $log 2>/dev/null; do
+		if [ $SECONDS -ge $deadline ] || ! kill -0 $pid 2>/dev/null; then
+			kill $pid 2>/dev/null
+			>&2 echo "error: boot $1 did not finish the benchmarks, see $log"
+			exit 1
+		fi
+		sleep 0.2
+	done
+
+	kill $pid 2>/dev/null
+	wait $pid 2>/dev/null
+
+	tr -d '\r' < $log | awk '{
+		for(i = 1; i + 3 <= NF; i++) {
+			if($i == "benchmark:" && $(i + 2) ~ /^[0-9]+$/) {
+				print $(i + 1), $(i + 2), $(i + 3)
+				break
+			}
+		}
+	}' > $result
+}
+
+#
+# Prints the median of a metric over all boots and repetitions
+#
+#	median "syscall.get-tid"
+#
+median() {
+	local values=$(cat $OUTDIR/run-*.txt | awk -v metric="$1" '$1 == metric { print $2 }' | sort -n)
+	local count=$(echo "$values" | grep -c .)
+	if [ $count -eq 0 ]; then
+		return
+	fi
+	echo "$values" | sed -n "$(((count + 1) / 2))p"
+}
+
+headline "booting $BENCHMARK_BOOTS times"
+for boot in $(seq 1 $BENCHMARK_BOOTS); do
+	bootOnce $boot
+	list "boot $boot: $(wc -l < $OUTDIR/run-$boot.txt) results"
+done
+
+RESULT="$OUTDIR/median.txt"
+for metric in $(cat $OUTDIR/run-*.txt | awk '{ print $1 }' | sort -u); do
+	unit=$(cat $OUTDIR/run-*.txt | awk -v metric="$metric" '$1 == metric { print $3; exit }')
+	echo "$metric $(median $metric) $unit"
+done > $RESULT
+
+headline "median results"
+awk '{ printf " - %-40s %12d %s\n", $1, $2, $3 }' $RESULT
+
+if [ $UPDATE_BASELINE -eq 1 ]; then
+	cp $RESULT $BENCHMARK_BASELINE
+	headline "baseline written to $BENCHMARK_BASELINE"
+	exit 0
+fi
+
+if [ ! -f "$BENCHMARK_BASELINE" ]; then
+	headline "no baseline at $BENCHMARK_BASELINE, run with --update-baseline to create one"
+	exit 0
+fi
+
+headline "comparing against $BENCHMARK_BASELINE (threshold $BENCHMARK_THRESHOLD percent)"
+awk -v threshold=$BENCHMARK_THRESHOLD '
+	NR == FNR { baseline[$1] = $2; next }
+	$1 in baseline && $3 != "nodes" {
+		base = baseline[$1]
+		change = base > 0 ? ($2 - base) * 100 / base : 0
+		higherIsBetter = $3 ~ /\/s$/
+		status = "ok"
+		if((higherIsBetter && $2 < base * (100 - threshold) / 100) ||
+			(!higherIsBetter && $2 > base * (100 + threshold) / 100)) {
+			status = "REGRESSION"
+			failed = 1
+		}
+		printf " - %-40s %12d %12d %+7.1f%% %s\n", $1, base, $2, change, status
+	}
+	END { exit failed }' $BENCHMARK_BASELINE $RESULT
+failOnError
@@ -0,0 +1,142 @@
+#!/bin/bash
+ROOT=".."
+if [ -f "$ROOT/variables.sh" ]; then
+	. "$ROOT/variables.sh"
+fi
+. "$ROOT/ghost.sh"
+
+#
+# Boot timing harness
+#
+# Boots the image headless in QEMU several times and waits for the kernel to
+# print its boot phase summary, which happens once the window server renders.
+# The median of each phase is compared against a baseline file; the harness
+# fails if any phase got slower than the threshold allows.
+#
+#   ./boot-timing.sh                    compare against the baseline
+#   ./boot-timing.sh --update-baseline  store the medians as new baseline
+#
+with QEMU					qemu-system-i386
+with QEMU_FLAGS				"-m 1024 -smp 4 -display none"
+with BOOT_TIMING_ISO		"../ghost.iso"
+with BOOT_TIMING_RUNS		5
+with BOOT_TIMING_TIMEOUT	120
+with BOOT_TIMING_THRESHOLD	10
+with BOOT_TIMING_SLACK		5000
+with BOOT_TIMING_BASELINE	"boot-timing.baseline"
+OUTDIR="bin/boot-timing"
+
+UPDATE_BASELINE=0
+for arg in "$@"; do
+	if [[ "$arg" == "--update-baseline" ]]; then
+		UPDATE_BASELINE=1
+	else
+		echo "unknown argument: '$arg'"
+		exit 1
+	fi
+done
+
+requireTool $QEMU
+if [ ! -f "$BOOT_TIMING_ISO" ]; then
+	>&2 echo "error: image $BOOT_TIMING_ISO not found, build it first"
+	exit 1
+fi
+
+rm -rf $OUTDIR
+mkdir -p $OUTDIR
+
+#
+# Boots once and writes "<metric> <microseconds>" lines for the run
+#
+#	bootOnce 1
+#
+bootOnce() {
+	local log="$OUTDIR/serial-$1.log"
+	local result="$OUTDIR/run-$1.txt"
+
+	local start=$(date +%s%N)
+	$QEMU -cdrom $BOOT_TIMING_ISO $QEMU_FLAGS -serial file:$log &
+	local pid=$!
+
+	local deadline=$((SECONDS + BOOT_TIMING_TIMEOUT))
+	while ! grep -q "boot desktop ready" $log 2>/dev/null; do
+		if [ $SECONDS -ge $deadline ] || ! kill -0 $pid 2>/dev/null; then
+			kill $pid 2>/dev/null
+			>&2 echo "error: run $1 did not reach the desktop, see $log"
+			exit 1
+		fi
+		sleep 0.05
+	done
+	local wall=$((($(date +%s%N) - start) / 1000))
+
+	kill $pid 2>/dev/null
+	wait $pid 2>/dev/null
+
+	echo "wall $wall" > $result
+	tr -d '\r' < $log | awk '
+		$1 == "boot" && $2 ~ /^phase=/ {
+			for(i = 2; i <= NF; i++) { split($i, kv, "="); field[kv[1]] = kv[2] }
+			name = field["phase"]
+			if(name == "ap")
+				name = name field["cpu"]
+			print name, field["duration"]
+		}
+		$1 == "boot" && $2 ~ /^firmware=/ {
+			for(i = 2; i <= NF; i++) { split($i, kv, "="); print kv[1], kv[2] }
+		}' >> $result
+}
+
+#
+# Prints the median of a metric over all runs
+#
+#	median "total"
+#
+median() {
+	local values=$(cat $OUTDIR/run-*.txt | awk -v metric="$1" '$1 == metric { print $2 }' | sort -n)
+	local count=$(echo "$values" | grep -c .)
+	if [ $count -eq 0 ]; then
+		return
+	fi
+	echo "$values" | sed -n "$(((count + 1) / 2))p"
+}
+
+headline "booting $BOOT_TIMING_RUNS times"
+for run in $(seq 1 $BOOT_TIMING_RUNS); do
+	bootOnce $run
+	list "run $run: $(awk '$1 == "wall" { print $2 / 1000 " ms" }' $OUTDIR/run-$run.txt) to desktop"
+done
+
+RESULT="$OUTDIR/median.txt"
+for metric in $(cat $OUTDIR/run-*.txt | awk '{ print $1 }' | sort -u); do
+	echo "$metric $(median $metric)"
+done > $RESULT
+
+headline "median phase durations (us)"
+awk '{ printf " - %-20s %10d\n", $1, $2 }' $RESULT
+
+if [ $UPDATE_BASELINE -eq 1 ]; then
+	cp $RESULT $BOOT_TIMING_BASELINE
+	headline "baseline written to $BOOT_TIMING_BASELINE"
+	exit 0
+fi
+
+if [ ! -f "$BOOT_TIMING_BASELINE" ]; then
+	headline "no baseline at $BOOT_TIMING_BASELINE, run with --update-baseline to create one"
+	exit 0
+fi
+
+headline "comparing against $BOOT_TIMING_BASELINE (threshold $BOOT_TIMING_THRESHOLD percent, slack $BOOT_TIMING_SLACK us)"
+awk -v threshold=$BOOT_TIMING_THRESHOLD -v slack=$BOOT_TIMING_SLACK '
+	NR == FNR { baseline[$1] = $2; next }
+	$1 in baseline {
+		base = baseline[$1]
+		change = base > 0 ? ($2 - base) * 100 / base : 0
+		status = "ok"
+		if($2 > base * (100 + threshold) / 100 && $2 - base > slack) {
+			status = "REGRESSION"
+			failed = 1
+		}
+		printf " - %-20s %10d %10d %+7.1f%% %s\n", $1, base, $2, change, status
+	}
+	END { exit failed }' $BOOT_TIMING_BASELINE $RESULT
+failOnError
@@ -35,14 +35,22 @@
 #define G_PRETTY_BOOT true
 #define G_VIDEO_LOG_BOOT false
 
-// logging settings
-#define G_LOG_LEVEL G_LOG_LEVEL_INFO
+// logging settings, messages below G_LOG_LEVEL are not compiled in and
+// the level logged at runtime starts at G_LOG_LEVEL_DEFAULT
+#define G_LOG_LEVEL G_LOG_LEVEL_DEBUG
+#define G_LOG_LEVEL_DEFAULT G_LOG_LEVEL_INFO
 
 // fine-grained debugging options
 #define G_DEBUG_WHOS_WAITING false
 #define G_DEBUG_MUTEXES false
 #define G_DEBUG_THREAD_DUMPING false
 
+// compile the kernel tracepoints, recording is started at runtime
+#define G_TRACING true
+
+// compile the sampling profiler, sampling is started at runtime
+#define G_PROFILING true
+
 // mode for the debug interface
 #define G_DEBUG_INTERFACE_MODE G_DEBUG_INTERFACE_MODE_PLAIN_LOG
 
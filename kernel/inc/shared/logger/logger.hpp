@@ -38,6 +38,11 @@ void loggerEnableSerial(bool enable);
 
 void loggerEnableVideo(bool video);
 
+/**
+ * Sets the minimum level of messages that are logged.
+ */
+void loggerSetLevel(g_log_level level);
+
 void loggerPrintPlain(const char *message);
 
 void loggerPrintCharacter(char c);
@@ -65,6 +70,14 @@ void loggerPrintCharacter(char c);
  */
 void loggerPrintFormatted(const char *message, va_list va);
 
+/**
+ * Formats the message like <loggerPrintFormatted> into the buffer instead of
+ * printing it. Output that does not fit is cut off, colors are ignored.
+ *
+ * @return the length of the null-terminated result
+ */
+uint32_t loggerFormat(char* buffer, uint32_t capacity, const char* message, va_list va);
+
 /**
  * Prints a number with a base.
  *
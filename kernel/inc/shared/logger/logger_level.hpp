@@ -21,9 +21,7 @@
 #ifndef __LOGGER_LEVEL__
 #define __LOGGER_LEVEL__
 
-#define G_LOG_LEVEL_NONE	3
-#define G_LOG_LEVEL_WARN	2
-#define G_LOG_LEVEL_INFO	1
-#define G_LOG_LEVEL_DEBUG	0
+// The levels are shared with userspace to allow changing them at runtime
+#include "ghost/kernel.h"
 
 #endif
@@ -23,9 +23,17 @@
 
 #include "build_config.hpp"
 
+/**
+ * Current minimum level of messages that are logged. Only messages that are
+ * compiled in with <G_LOG_LEVEL> can be enabled at runtime.
+ */
+extern volatile g_log_level loggerLevel;
+
+#define G_LOG_AT(level, print, msg...)	((loggerLevel <= level) ? print(msg) : (void) 0)
+
 #if G_LOG_LEVEL <= G_LOG_LEVEL_INFO
-#define logInfo(msg...)			loggerPrintlnLocked(msg)
-#define logInfon(msg...)		loggerPrintLocked(msg)
+#define logInfo(msg...)			G_LOG_AT(G_LOG_LEVEL_INFO, loggerPrintlnLocked, msg)
+#define logInfon(msg...)		G_LOG_AT(G_LOG_LEVEL_INFO, loggerPrintLocked, msg)
 #define G_LOGGING_INFO			true
 #define G_IF_LOG_INFO(s)		s
 #else
@@ -36,8 +44,8 @@
 #endif
 
 #if G_LOG_LEVEL <= G_LOG_LEVEL_WARN
-#define logWarn(msg...)			loggerPrintlnLocked(msg)
-#define logWarnn(msg...)		loggerPrintLocked(msg)
+#define logWarn(msg...)			G_LOG_AT(G_LOG_LEVEL_WARN, loggerPrintlnLocked, msg)
+#define logWarnn(msg...)		G_LOG_AT(G_LOG_LEVEL_WARN, loggerPrintLocked, msg)
 #define G_LOGGING_WARN			true
 #define G_IF_LOG_WARN(s)		s
 #else
@@ -48,8 +56,8 @@
 #endif
 
 #if G_LOG_LEVEL <= G_LOG_LEVEL_DEBUG
-#define logDebug(msg...)		loggerPrintlnLocked(msg)
-#define logDebugn(msg...)		loggerPrintLocked(msg)
+#define logDebug(msg...)		G_LOG_AT(G_LOG_LEVEL_DEBUG, loggerPrintlnLocked, msg)
+#define logDebugn(msg...)		G_LOG_AT(G_LOG_LEVEL_DEBUG, loggerPrintLocked, msg)
 #define G_LOGGING_DEBUG			true
 #define G_IF_LOG_DEBUG(s)		s
 #else
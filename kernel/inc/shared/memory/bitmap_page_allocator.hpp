@@ -27,12 +27,14 @@
 
 struct g_bitmap_page_allocator
 {
+	uint32_t totalPageCount;
 	uint32_t freePageCount;
 	g_bitmap_header* bitmapArray;
 };
 
 /**
- * Initializes the allocator in-place; the bitmap array is used as it is.
+ * Initializes the allocator in-place; the bitmap array is used as it is. Pages that
+ * are already marked as used in the bitmaps are not counted as free.
  */
 void bitmapPageAllocatorInitialize(g_bitmap_page_allocator* allocator, g_bitmap_header* bitmapArray);
 
@@ -26,6 +26,7 @@
 #include "kernel/calls/syscall_messaging.hpp"
 #include "kernel/calls/syscall_tasking.hpp"
 #include "kernel/calls/syscall_vm86.hpp"
+#include "kernel/debug/trace.hpp"
 #include "kernel/memory/memory.hpp"
 #include "kernel/system/interrupts/interrupts.hpp"
 #include "kernel/tasking/tasking.hpp"
@@ -57,6 +58,9 @@ void syscall(uint32_t callId, void* syscallData)
 		return;
 	}
 
+	task->statistics.syscalls++;
+	G_TRACE(G_TRACE_EVENT_SYSCALL_ENTER, callId, 0);
+
 	volatile g_processor_state* state;
 	if(reg->reentrant)
 	{
@@ -71,6 +75,8 @@ void syscall(uint32_t callId, void* syscallData)
 		interruptsDisable();
 		task->state = state;
 	}
+
+	G_TRACE(G_TRACE_EVENT_SYSCALL_EXIT, callId, 0);
 }
 
 void _syscallRegister(int callId, g_syscall_handler handler, bool reentrant)
@@ -109,6 +115,9 @@ void syscallRegisterAll()
 	_syscallRegister(G_SYSCALL_KILL, (g_syscall_handler) syscallKill, false);
 	_syscallRegister(G_SYSCALL_OPEN_IRQ_DEVICE, (g_syscall_handler) syscallOpenIrqDevice, false);
 	_syscallRegister(G_SYSCALL_KERNQUERY, (g_syscall_handler) syscallKernQuery, true);
+	_syscallRegister(G_SYSCALL_TRACE, (g_syscall_handler) syscallTrace, true);
+	_syscallRegister(G_SYSCALL_PROFILER, (g_syscall_handler) syscallProfiler, true);
+	_syscallRegister(G_SYSCALL_CONFIGURE_LOG, (g_syscall_handler) syscallConfigureLog, true);
 	_syscallRegister(G_SYSCALL_GET_EXECUTABLE_PATH, (g_syscall_handler) syscallGetExecutablePath, false);
 	_syscallRegister(G_SYSCALL_GET_PARENT_PROCESS_ID, (g_syscall_handler) syscallGetParentProcessId, false);
 	_syscallRegister(G_SYSCALL_TASK_GET_TLS, (g_syscall_handler) syscallTaskGetTls, false);
@@ -122,6 +131,8 @@ void syscallRegisterAll()
 	_syscallRegister(G_SYSCALL_SHARE_MEMORY, (g_syscall_handler) syscallShareMemory, true);
 	_syscallRegister(G_SYSCALL_MAP_MMIO_AREA, (g_syscall_handler) syscallMapMmioArea, true);
 	_syscallRegister(G_SYSCALL_SBRK, (g_syscall_handler) syscallSbrk, true);
+	_syscallRegister(G_SYSCALL_MEMORY_MAP, (g_syscall_handler) syscallMemoryMap, true);
+	_syscallRegister(G_SYSCALL_MEMORY_UNMAP, (g_syscall_handler) syscallMemoryUnmap, false);
 
 	_syscallRegister(G_SYSCALL_SPAWN, (g_syscall_handler) syscallSpawn, true);
 	_syscallRegister(G_SYSCALL_CREATE_THREAD, (g_syscall_handler) syscallCreateThread, false);
@@ -138,6 +149,14 @@ void syscallRegisterAll()
 	_syscallRegister(G_SYSCALL_FS_SEEK, (g_syscall_handler) syscallFsSeek, false);
 	_syscallRegister(G_SYSCALL_FS_READ, (g_syscall_handler) syscallFsRead, false);
 	_syscallRegister(G_SYSCALL_FS_WRITE, (g_syscall_handler) syscallFsWrite, false);
+	_syscallRegister(G_SYSCALL_FS_READ_AT, (g_syscall_handler) syscallFsReadAt, false);
+	_syscallRegister(G_SYSCALL_FS_WRITE_AT, (g_syscall_handler) syscallFsWriteAt, false);
+	_syscallRegister(G_SYSCALL_FS_READ_VECTOR, (g_syscall_handler) syscallFsReadVector, false);
+	_syscallRegister(G_SYSCALL_FS_WRITE_VECTOR, (g_syscall_handler) syscallFsWriteVector, false);
+	_syscallRegister(G_SYSCALL_IO_RING_CREATE, (g_syscall_handler) syscallIoRingCreate, false);
+	_syscallRegister(G_SYSCALL_IO_RING_ENTER, (g_syscall_handler) syscallIoRingEnter, false);
+	_syscallRegister(G_SYSCALL_IO_RING_DESTROY, (g_syscall_handler) syscallIoRingDestroy, false);
+	_syscallRegister(G_SYSCALL_FS_UNLINK, (g_syscall_handler) syscallFsUnlink, false);
 	_syscallRegister(G_SYSCALL_FS_CLOSE, (g_syscall_handler) syscallFsClose, false);
 	_syscallRegister(G_SYSCALL_FS_CLONEFD, (g_syscall_handler) syscallFsCloneFd, false);
 	_syscallRegister(G_SYSCALL_FS_LENGTH, (g_syscall_handler) syscallFsLength, false);
@@ -148,4 +167,7 @@ void syscallRegisterAll()
 	_syscallRegister(G_SYSCALL_FS_OPEN_DIRECTORY, (g_syscall_handler) syscallFsOpenDirectory, false);
 	_syscallRegister(G_SYSCALL_FS_READ_DIRECTORY, (g_syscall_handler) syscallFsReadDirectory, false);
 	_syscallRegister(G_SYSCALL_FS_CLOSE_DIRECTORY, (g_syscall_handler) syscallFsCloseDirectory, false);
+	_syscallRegister(G_SYSCALL_FS_REGISTER_AS_DELEGATE, (g_syscall_handler) syscallFsRegisterAsDelegate, false);
+	_syscallRegister(G_SYSCALL_FS_SET_TRANSACTION_STATUS, (g_syscall_handler) syscallFsSetTransactionStatus, false);
+	_syscallRegister(G_SYSCALL_FS_CREATE_NODE, (g_syscall_handler) syscallFsCreateNode, false);
 }
@@ -20,7 +20,9 @@
 
 #include "kernel/calls/syscall_filesystem.hpp"
 #include "kernel/filesystem/filesystem.hpp"
+#include "kernel/filesystem/filesystem_ioring.hpp"
 #include "kernel/filesystem/filesystem_process.hpp"
+#include "kernel/filesystem/filesystem_taskeddelegate.hpp"
 #include "kernel/system/interrupts/requests.hpp"
 #include "shared/logger/logger.hpp"
 #include "shared/utils/string.hpp"
@@ -39,6 +41,11 @@ void syscallFsOpen(g_task* task, g_syscall_fs_open* data)
 	}
 }
 
+void syscallFsUnlink(g_task* task, g_syscall_fs_unlink* data)
+{
+	data->status = filesystemUnlink(data->path, task->process);
+}
+
 void syscallFsSeek(g_task* task, g_syscall_fs_seek* data)
 {
 	data->status = filesystemSeek(task, data->fd, data->mode, data->amount, &data->result);
@@ -62,6 +69,78 @@ void syscallFsWrite(g_task* task, g_syscall_fs_write* data)
 	}
 }
 
+void syscallFsReadAt(g_task* task, g_syscall_fs_read_at* data)
+{
+	if((int64_t) data->offset < 0)
+	{
+		data->status = G_FS_READ_ERROR;
+		data->result = G_FD_NONE;
+		return;
+	}
+
+	g_fs_iovec segment;
+	segment.base = data->buffer;
+	segment.length = data->length;
+
+	data->status = filesystemReadVector(task, data->fd, &segment, 1, data->offset, &data->result);
+	if(data->status != G_FS_READ_SUCCESSFUL)
+	{
+		data->result = G_FD_NONE;
+	}
+}
+
+void syscallFsWriteAt(g_task* task, g_syscall_fs_write_at* data)
+{
+	if((int64_t) data->offset < 0)
+	{
+		data->status = G_FS_WRITE_ERROR;
+		data->result = G_FD_NONE;
+		return;
+	}
+
+	g_fs_iovec segment;
+	segment.base = data->buffer;
+	segment.length = data->length;
+
+	data->status = filesystemWriteVector(task, data->fd, &segment, 1, data->offset, &data->result);
+	if(data->status != G_FS_WRITE_SUCCESSFUL)
+	{
+		data->result = G_FD_NONE;
+	}
+}
+
+void syscallFsReadVector(g_task* task, g_syscall_fs_read_vector* data)
+{
+	if(data->count <= 0 || data->count > G_FS_IOVEC_MAX || !data->vector)
+	{
+		data->status = G_FS_READ_ERROR;
+		data->result = G_FD_NONE;
+		return;
+	}
+
+	data->status = filesystemReadVector(task, data->fd, (g_fs_iovec*) data->vector, data->count, data->offset, &data->result);
+	if(data->status != G_FS_READ_SUCCESSFUL)
+	{
+		data->result = G_FD_NONE;
+	}
+}
+
+void syscallFsWriteVector(g_task* task, g_syscall_fs_write_vector* data)
+{
+	if(data->count <= 0 || data->count > G_FS_IOVEC_MAX || !data->vector)
+	{
+		data->status = G_FS_WRITE_ERROR;
+		data->result = G_FD_NONE;
+		return;
+	}
+
+	data->status = filesystemWriteVector(task, data->fd, (g_fs_iovec*) data->vector, data->count, data->offset, &data->result);
+	if(data->status != G_FS_WRITE_SUCCESSFUL)
+	{
+		data->result = G_FD_NONE;
+	}
+}
+
 void syscallFsClose(g_task* task, g_syscall_fs_close* data)
 {
 	data->status = filesystemClose(task->process->id, data->fd, true);
@@ -220,3 +299,50 @@ void syscallFsCloseDirectory(g_task* task, g_syscall_fs_close_directory* data)
 {
 	// TODO: Is this needed?
 }
+
+void syscallFsRegisterAsDelegate(g_task* task, g_syscall_fs_register_as_delegate* data)
+{
+	if(task->securityLevel > G_SECURITY_LEVEL_DRIVER)
+	{
+		logInfo("%! task %i tried to register as delegate without permission", "filesystem", task->id);
+		data->result = G_FS_REGISTER_AS_DELEGATE_FAILED_DELEGATE_CREATION;
+		return;
+	}
+
+	g_fs_virt_id mountpointId;
+	g_address transactionStorage;
+	data->result = filesystemTaskedDelegateRegister(task, data->name, data->phys_mountpoint_id, &mountpointId, &transactionStorage);
+	if(data->result == G_FS_REGISTER_AS_DELEGATE_SUCCESSFUL)
+	{
+		data->mountpoint_id = mountpointId;
+		data->transaction_storage = transactionStorage;
+	}
+}
+
+void syscallFsSetTransactionStatus(g_task* task, g_syscall_fs_set_transaction_status* data)
+{
+	filesystemTaskedDelegateSetTransactionStatus(task, data->transaction, data->status);
+}
+
+void syscallFsCreateNode(g_task* task, g_syscall_fs_create_node* data)
+{
+	g_fs_virt_id createdId;
+	data->result = filesystemTaskedDelegateCreateNode(task, data->parent_id, data->name, data->type, data->phys_fs_id, &createdId);
+	if(data->result != G_FS_CREATE_NODE_STATUS_FAILED_NO_PARENT)
+		data->created_id = createdId;
+}
+
+void syscallIoRingCreate(g_task* task, g_syscall_io_ring_create* data)
+{
+	data->status = filesystemIoRingCreate(task, data->entries, &data->id, &data->header);
+}
+
+void syscallIoRingEnter(g_task* task, g_syscall_io_ring_enter* data)
+{
+	data->status = filesystemIoRingEnter(task, data->id, data->wait_for, data->timeout, &data->completions);
+}
+
+void syscallIoRingDestroy(g_task* task, g_syscall_io_ring_destroy* data)
+{
+	data->status = filesystemIoRingDestroy(task, data->id);
+}
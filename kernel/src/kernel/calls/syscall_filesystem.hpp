@@ -32,6 +32,14 @@ void syscallFsRead(g_task* task, g_syscall_fs_read* data);
 
 void syscallFsWrite(g_task* task, g_syscall_fs_write* data);
 
+void syscallFsReadAt(g_task* task, g_syscall_fs_read_at* data);
+
+void syscallFsWriteAt(g_task* task, g_syscall_fs_write_at* data);
+
+void syscallFsReadVector(g_task* task, g_syscall_fs_read_vector* data);
+
+void syscallFsWriteVector(g_task* task, g_syscall_fs_write_vector* data);
+
 void syscallFsClose(g_task* task, g_syscall_fs_close* data);
 
 void syscallFsLength(g_task* task, g_syscall_fs_length* data);
@@ -54,4 +62,18 @@ void syscallFsReadDirectory(g_task* task, g_syscall_fs_read_directory* data);
 
 void syscallFsCloseDirectory(g_task* task, g_syscall_fs_close_directory* data);
 
+void syscallFsRegisterAsDelegate(g_task* task, g_syscall_fs_register_as_delegate* data);
+
+void syscallFsSetTransactionStatus(g_task* task, g_syscall_fs_set_transaction_status* data);
+
+void syscallFsCreateNode(g_task* task, g_syscall_fs_create_node* data);
+
+void syscallFsUnlink(g_task* task, g_syscall_fs_unlink* data);
+
+void syscallIoRingCreate(g_task* task, g_syscall_io_ring_create* data);
+
+void syscallIoRingEnter(g_task* task, g_syscall_io_ring_enter* data);
+
+void syscallIoRingDestroy(g_task* task, g_syscall_io_ring_destroy* data);
+
 #endif
@@ -19,10 +19,22 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "kernel/calls/syscall_general.hpp"
+#include "kernel/debug/boot_phases.hpp"
+#include "kernel/debug/profiler.hpp"
+#include "kernel/debug/trace.hpp"
+#include "kernel/logger/logger_ring.hpp"
 #include "kernel/filesystem/filesystem.hpp"
+#include "kernel/filesystem/filesystem_pagecache.hpp"
+#include "kernel/filesystem/filesystem_tmpfsdelegate.hpp"
+#include "kernel/ipc/message.hpp"
+#include "kernel/ipc/pipes.hpp"
 #include "kernel/memory/heap.hpp"
+#include "kernel/memory/memory.hpp"
+#include "kernel/system/processor/processor.hpp"
+#include "kernel/system/timing/tsc.hpp"
 #include "kernel/tasking/clock.hpp"
 #include "kernel/tasking/tasking_directory.hpp"
+#include "kernel/tasking/tasking_memory.hpp"
 #include "kernel/utils/hashmap.hpp"
 #include "shared/logger/logger.hpp"
 #include "shared/utils/string.hpp"
@@ -37,6 +49,19 @@ void syscallSetVideoLog(g_task* task, g_syscall_set_video_log* data)
 	loggerEnableVideo(data->enabled);
 }
 
+void syscallConfigureLog(g_task* task, g_syscall_configure_log* data)
+{
+	data->previousLevel = loggerLevel;
+	data->previousAsync = loggerRingIsEnabled();
+	if(task->securityLevel > G_SECURITY_LEVEL_DRIVER)
+		return;
+
+	if(data->level != G_LOG_CONFIGURE_KEEP)
+		loggerSetLevel(data->level);
+	if(data->async != G_LOG_CONFIGURE_KEEP)
+		loggerRingSetEnabled(data->async);
+}
+
 void syscallTest(g_task* task, g_syscall_test* data)
 {
 	data->result = data->test;
@@ -128,28 +153,31 @@ void syscallKernQuery(g_task* task, g_syscall_kernquery* data)
 
 		uint32_t rem = kdata->id_buffer_size;
 		kdata->filled_ids = 0;
-		auto iter = hashmapIteratorStart(taskGlobalMap);
-		while(rem-- && hashmapIteratorHasNext(&iter))
+		auto iter = concurrentHashmapIteratorStart(taskGlobalMap);
+		while(rem-- && concurrentHashmapIteratorHasNext(&iter))
 		{
-			auto next = hashmapIteratorNext(&iter)->value;
+			auto next = concurrentHashmapIteratorNext(&iter)->value;
 			kdata->id_buffer[kdata->filled_ids++] = next->id;
 		}
 		data->status = G_KERNQUERY_STATUS_SUCCESSFUL;
-		hashmapIteratorEnd(&iter);
+		concurrentHashmapIteratorEnd(&iter);
 	}
 	else if(data->command == G_KERNQUERY_TASK_COUNT)
 	{
 		g_kernquery_task_count_data* kdata = (g_kernquery_task_count_data*) data->buffer;
 
 		data->status = G_KERNQUERY_STATUS_SUCCESSFUL;
-		kdata->count = hashmapSize(taskGlobalMap);
+		kdata->count = concurrentHashmapSize(taskGlobalMap);
 	}
 	else if(data->command == G_KERNQUERY_TASK_GET_BY_ID)
 	{
 		g_kernquery_task_get_data* kdata = (g_kernquery_task_get_data*) data->buffer;
 
-		g_task* ktask = taskingGetById(kdata->id);
-		if(!ktask || ktask->status == G_THREAD_STATUS_DEAD)
+		// Collected in a kernel buffer, user memory is not touched while the task is inspected
+		g_kernquery_task_get_data* info = (g_kernquery_task_get_data*) heapAllocateClear(sizeof(g_kernquery_task_get_data));
+
+		g_task* ktask = taskingInspectById(kdata->id);
+		if(!ktask)
 		{
 			data->status = G_KERNQUERY_STATUS_UNKNOWN_ID;
 			kdata->id = -1;
@@ -157,27 +185,305 @@ void syscallKernQuery(g_task* task, g_syscall_kernquery* data)
 		else
 		{
 			data->status = G_KERNQUERY_STATUS_SUCCESSFUL;
-			kdata->found = true;
-			kdata->id = ktask->id;
-			kdata->parent = ktask->process->id;
-			kdata->type = ktask->type;
+			info->found = true;
+			info->id = ktask->id;
+			info->parent = ktask->process->id;
+			info->type = ktask->type;
 
 			if(ktask->process->environment.executablePath)
-				stringCopy(kdata->source_path, ktask->process->environment.executablePath);
+				stringCopy(info->source_path, ktask->process->environment.executablePath);
 			else
-				kdata->source_path[0] = 0;
+				info->source_path[0] = 0;
 
 			const char* identifier = taskingDirectoryGetIdentifier(ktask->id);
 			if(identifier)
-				stringCopy(kdata->identifier, identifier);
+				stringCopy(info->identifier, identifier);
 			else
-				kdata->identifier[0] = 0;
+				info->identifier[0] = 0;
+
+			g_process* process = ktask->process;
+			uint32_t resident;
+			uint32_t virt;
+			taskingMemoryGetUsage(process, &resident, &virt);
+			info->memory_used = resident;
+			info->memory_virtual = virt;
+			info->syscall_count = ktask->statistics.syscalls;
+
+			info->cpu_time_user = tscToMicros(ktask->statistics.userTime);
+			info->cpu_time_kernel = tscToMicros(ktask->statistics.kernelTime);
+
+			mutexAcquire(&process->lock);
+			uint64_t processUser = process->statistics.userTime;
+			uint64_t processKernel = process->statistics.kernelTime;
+			g_task_entry* entry = process->tasks;
+			while(entry)
+			{
+				processUser += entry->task->statistics.userTime;
+				processKernel += entry->task->statistics.kernelTime;
+				entry = entry->next;
+			}
+			mutexRelease(&process->lock);
+			info->process_cpu_time_user = tscToMicros(processUser);
+			info->process_cpu_time_kernel = tscToMicros(processKernel);
+
+			info->processor = ktask->assignment ? ktask->assignment->processor : 0;
+			info->status = ktask->status;
+			taskingInspectEnd(ktask);
+
+			memoryCopy(kdata, info, sizeof(g_kernquery_task_get_data));
+		}
+		heapFree(info);
+	}
+	else if(data->command == G_KERNQUERY_CPU_COUNT)
+	{
+		g_kernquery_cpu_count_data* kdata = (g_kernquery_cpu_count_data*) data->buffer;
+
+		data->status = G_KERNQUERY_STATUS_SUCCESSFUL;
+		kdata->count = processorGetNumberOfProcessors();
+	}
+	else if(data->command == G_KERNQUERY_CPU_GET)
+	{
+		g_kernquery_cpu_get_data* kdata = (g_kernquery_cpu_get_data*) data->buffer;
+
+		if(kdata->position >= processorGetNumberOfProcessors())
+		{
+			data->status = G_KERNQUERY_STATUS_UNKNOWN_ID;
+			kdata->found = false;
+		}
+		else
+		{
+			g_tasking_local* local = taskingGetLocalByProcessor(kdata->position);
+			mutexAcquire(&local->lock);
+			uint64_t idle = local->statistics.idleTime;
+			uint64_t busy = local->statistics.busyTime;
+			uint32_t taskCount = 0;
+			auto entry = local->scheduling.list;
+			while(entry)
+			{
+				if(entry->task->status != G_THREAD_STATUS_DEAD)
+					++taskCount;
+				entry = entry->next;
+			}
+			mutexRelease(&local->lock);
+
+			data->status = G_KERNQUERY_STATUS_SUCCESSFUL;
+			kdata->found = true;
+			kdata->idle_time = tscToMicros(idle);
+			kdata->busy_time = tscToMicros(busy);
+			kdata->task_count = taskCount;
+		}
+	}
+	else if(data->command == G_KERNQUERY_MEMORY_GET)
+	{
+		g_kernquery_memory_get_data* kdata = (g_kernquery_memory_get_data*) data->buffer;
+
+		kdata->physical_total_pages = memoryPhysicalAllocator.totalPageCount;
+		kdata->physical_free_pages = memoryPhysicalAllocator.freePageCount;
+		kdata->heap_used = heapGetUsedAmount();
+		kdata->heap_size = heapGetSize();
+
+		g_fs_page_cache_statistics pageCache = filesystemPageCacheGetStatistics();
+		kdata->page_cache_pages = pageCache.cachedPages;
+		kdata->page_cache_hits = pageCache.hits;
+		kdata->page_cache_misses = pageCache.misses;
+
+		uint32_t tmpfsUsed;
+		uint32_t tmpfsLimit;
+		filesystemTmpfsDelegateGetUsage(&tmpfsUsed, &tmpfsLimit);
+		kdata->tmpfs_used = tmpfsUsed;
+		kdata->tmpfs_limit = tmpfsLimit;
+
+		data->status = G_KERNQUERY_STATUS_SUCCESSFUL;
+	}
+	else if(data->command == G_KERNQUERY_STATISTICS_GET)
+	{
+		g_kernquery_statistics_get_data* kdata = (g_kernquery_statistics_get_data*) data->buffer;
+
+		g_message_statistics messages = messageGetStatistics();
+		kdata->messages_sent = messages.sent;
+		kdata->messages_received = messages.received;
+		kdata->message_bytes = messages.bytes;
+
+		g_pipe_statistics pipes = pipeGetStatistics();
+		kdata->pipe_reads = pipes.reads;
+		kdata->pipe_writes = pipes.writes;
+		kdata->pipe_bytes_read = pipes.bytesRead;
+		kdata->pipe_bytes_written = pipes.bytesWritten;
+
+		g_fs_statistics fs = filesystemGetStatistics();
+		kdata->fs_opens = fs.opens;
+		kdata->fs_closes = fs.closes;
+		kdata->fs_reads = fs.reads;
+		kdata->fs_writes = fs.writes;
+		kdata->fs_bytes_read = fs.bytesRead;
+		kdata->fs_bytes_written = fs.bytesWritten;
+
+		g_logger_ring_statistics log = loggerRingGetStatistics();
+		kdata->log_messages = log.messages;
+		kdata->log_dropped = log.dropped;
+
+		data->status = G_KERNQUERY_STATUS_SUCCESSFUL;
+	}
+	else if(data->command == G_KERNQUERY_BOOT_COUNT)
+	{
+		g_kernquery_boot_count_data* kdata = (g_kernquery_boot_count_data*) data->buffer;
+
+		uint64_t entry = bootPhasesGetKernelEntry();
+		kdata->count = bootPhasesGetCount();
+		kdata->finished = bootPhasesIsFinished();
+		kdata->kernel_entry = tscToMicros(entry);
+		kdata->total = kdata->finished ? tscToMicros(bootPhasesGetFinish() - entry) : 0;
+
+		data->status = G_KERNQUERY_STATUS_SUCCESSFUL;
+	}
+	else if(data->command == G_KERNQUERY_BOOT_GET)
+	{
+		g_kernquery_boot_get_data* kdata = (g_kernquery_boot_get_data*) data->buffer;
+
+		g_boot_phase phase;
+		if(!bootPhasesGet(kdata->position, &phase))
+		{
+			data->status = G_KERNQUERY_STATUS_UNKNOWN_ID;
+			kdata->found = false;
+		}
+		else
+		{
+			const char* name = phase.name ? phase.name : "";
+			int length = 0;
+			for(; name[length] && length < G_KERNQUERY_BOOT_PHASE_NAME_MAX - 1; length++)
+				kdata->name[length] = name[length];
+			kdata->name[length] = 0;
+
+			kdata->found = true;
+			kdata->processor = phase.processor;
+			kdata->finished = phase.end != 0;
+			kdata->start = tscToMicros(phase.start - bootPhasesGetKernelEntry());
+			kdata->duration = phase.end ? tscToMicros(phase.end - phase.start) : 0;
 
-			kdata->memory_used = 0; // TODO
+			data->status = G_KERNQUERY_STATUS_SUCCESSFUL;
 		}
 	}
 	else
 	{
 		data->status = G_KERNQUERY_STATUS_ERROR;
 	}
-}
\ No newline at end of file
+}
+
+/**
+ * Checks that a buffer for the given number of entries lies completely below the
+ * kernel area, so that a task can not make the kernel write to kernel memory.
+ */
+bool _syscallIsUserBuffer(void* buffer, uint32_t count, uint32_t entrySize)
+{
+	uint64_t start = (g_address) buffer;
+	uint64_t end = start + (uint64_t) count * entrySize;
+	return end <= G_KERNEL_AREA_START;
+}
+
+void syscallTrace(g_task* task, g_syscall_trace* data)
+{
+	data->processors = traceGetProcessorCount();
+	data->ticksPerMicrosecond = tscGetTicksPerMicrosecond();
+	data->count = 0;
+	data->dropped = 0;
+
+	if(task->securityLevel > G_SECURITY_LEVEL_DRIVER)
+	{
+		data->status = G_TRACE_STATUS_ERROR;
+		return;
+	}
+
+	if(data->processors == 0)
+	{
+		data->status = G_TRACE_STATUS_NOT_AVAILABLE;
+		return;
+	}
+
+	data->status = G_TRACE_STATUS_SUCCESSFUL;
+	if(data->command == G_TRACE_COMMAND_START)
+	{
+		traceSetEnabled(true);
+	}
+	else if(data->command == G_TRACE_COMMAND_STOP)
+	{
+		traceSetEnabled(false);
+	}
+	else if(data->command == G_TRACE_COMMAND_RESET)
+	{
+		traceReset();
+	}
+	else if(data->command == G_TRACE_COMMAND_READ)
+	{
+		if(data->processor >= data->processors || !_syscallIsUserBuffer(data->buffer, data->capacity, sizeof(g_trace_event)))
+			data->status = G_TRACE_STATUS_ERROR;
+		else
+		{
+			uint32_t dropped;
+			data->count = traceRead(data->processor, data->buffer, data->capacity, &dropped);
+			data->dropped = dropped;
+		}
+	}
+	else if(data->command != G_TRACE_COMMAND_INFO)
+	{
+		data->status = G_TRACE_STATUS_ERROR;
+	}
+}
+
+void syscallProfiler(g_task* task, g_syscall_profiler* data)
+{
+	data->processors = profilerGetProcessorCount();
+	data->ticksPerMicrosecond = tscGetTicksPerMicrosecond();
+	data->count = 0;
+	data->dropped = 0;
+
+	if(task->securityLevel > G_SECURITY_LEVEL_DRIVER)
+	{
+		data->status = G_PROFILER_STATUS_ERROR;
+		return;
+	}
+
+	if(data->processors == 0)
+	{
+		data->status = G_PROFILER_STATUS_NOT_AVAILABLE;
+		return;
+	}
+
+	data->status = G_PROFILER_STATUS_SUCCESSFUL;
+	if(data->command == G_PROFILER_COMMAND_START)
+	{
+		profilerStart(data->interval);
+	}
+	else if(data->command == G_PROFILER_COMMAND_STOP)
+	{
+		profilerStop();
+	}
+	else if(data->command == G_PROFILER_COMMAND_RESET)
+	{
+		profilerReset();
+	}
+	else if(data->command == G_PROFILER_COMMAND_READ)
+	{
+		if(data->processor >= data->processors || !_syscallIsUserBuffer(data->buffer, data->capacity, sizeof(g_profiler_sample)))
+			data->status = G_PROFILER_STATUS_ERROR;
+		else
+		{
+			uint32_t dropped;
+			data->count = profilerRead(data->processor, (g_profiler_sample*) data->buffer, data->capacity, &dropped);
+			data->dropped = dropped;
+		}
+	}
+	else if(data->command == G_PROFILER_COMMAND_MODULES)
+	{
+		uint32_t count;
+		if(!_syscallIsUserBuffer(data->buffer, data->capacity, sizeof(g_profiler_module)))
+			data->status = G_PROFILER_STATUS_ERROR;
+		else if(!profilerGetModules(data->process, (g_profiler_module*) data->buffer, data->capacity, &count))
+			data->status = G_PROFILER_STATUS_ERROR;
+		else
+			data->count = count;
+	}
+	else if(data->command != G_PROFILER_COMMAND_INFO)
+	{
+		data->status = G_PROFILER_STATUS_ERROR;
+	}
+}
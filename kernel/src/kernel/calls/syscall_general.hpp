@@ -28,6 +28,8 @@ void syscallLog(g_task* task, g_syscall_log* data);
 
 void syscallSetVideoLog(g_task* task, g_syscall_set_video_log* data);
 
+void syscallConfigureLog(g_task* task, g_syscall_configure_log* data);
+
 void syscallTest(g_task* task, g_syscall_test* data);
 
 void syscallReleaseCliArguments(g_task* task, g_syscall_cli_args_release* data);
@@ -42,4 +44,8 @@ void syscallSetWorkingDirectory(g_task* task, g_syscall_fs_set_working_directory
 
 void syscallKernQuery(g_task* task, g_syscall_kernquery* data);
 
+void syscallTrace(g_task* task, g_syscall_trace* data);
+
+void syscallProfiler(g_task* task, g_syscall_profiler* data);
+
 #endif
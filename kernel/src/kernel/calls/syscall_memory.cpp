@@ -19,6 +19,7 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "kernel/calls/syscall_memory.hpp"
+#include "kernel/filesystem/filesystem_process.hpp"
 #include "kernel/memory/lower_heap.hpp"
 #include "kernel/memory/memory.hpp"
 #include "kernel/memory/page_reference_tracker.hpp"
@@ -95,6 +96,9 @@ void syscallAllocateMemory(g_task* task, g_syscall_alloc_mem* data)
 
 void syscallUnmap(g_task* task, g_syscall_unmap* data)
 {
+	if(memoryMappingRemove(task->process, data->virtualBase, 0) == G_MEMORY_MAP_STATUS_SUCCESSFUL)
+		return;
+
 	g_address_range* range = addressRangePoolFind(task->process->virtualRangePool, data->virtualBase);
 	if(!range)
 		return;
@@ -188,3 +192,48 @@ void syscallMapMmioArea(g_task* task, g_syscall_map_mmio* data)
 
 	data->virtualAddress = (void*) virtualRangeBase;
 }
+
+void syscallMemoryMap(g_task* task, g_syscall_memory_map* data)
+{
+	data->address = 0;
+
+	bool shared = data->flags & G_MEMORY_MAP_SHARED;
+	bool priv = data->flags & G_MEMORY_MAP_PRIVATE;
+	// the length is rounded up to whole pages and must not wrap around
+	if(data->length == 0 || data->length > G_PAGE_ALIGN_DOWN(UINT32_MAX) || shared == priv || (data->offset & G_PAGE_ALIGN_MASK))
+	{
+		data->status = G_MEMORY_MAP_STATUS_INVALID_ARGUMENTS;
+		return;
+	}
+
+	g_fs_node* node = nullptr;
+	if(!(data->flags & G_MEMORY_MAP_ANONYMOUS))
+	{
+		g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process->id, data->fd);
+		if(descriptor)
+			node = filesystemGetNode(descriptor->nodeId);
+
+		if(!node)
+		{
+			data->status = G_MEMORY_MAP_STATUS_INVALID_FD;
+			return;
+		}
+
+		if(node->type != G_FS_NODE_TYPE_FILE ||
+		   (shared && (data->protection & G_MEMORY_PROTECTION_WRITE) && !(descriptor->openFlags & G_FILE_FLAG_MODE_WRITE)))
+		{
+			data->status = G_MEMORY_MAP_STATUS_ACCESS_DENIED;
+			return;
+		}
+	}
+
+	g_address address;
+	data->status = memoryMappingCreate(task->process, data->length, data->protection, data->flags, node, data->offset, &address);
+	if(data->status == G_MEMORY_MAP_STATUS_SUCCESSFUL)
+		data->address = (void*) address;
+}
+
+void syscallMemoryUnmap(g_task* task, g_syscall_memory_unmap* data)
+{
+	data->status = memoryMappingRemove(task->process, (g_address) data->address, data->length);
+}
@@ -38,4 +38,8 @@ void syscallShareMemory(g_task* task, g_syscall_share_mem* data);
 
 void syscallMapMmioArea(g_task* task, g_syscall_map_mmio* data);
 
+void syscallMemoryMap(g_task* task, g_syscall_memory_map* data);
+
+void syscallMemoryUnmap(g_task* task, g_syscall_memory_unmap* data);
+
 #endif
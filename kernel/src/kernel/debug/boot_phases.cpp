@@ -0,0 +1,107 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/debug/boot_phases.hpp"
+#include "kernel/system/processor/processor.hpp"
+#include "kernel/system/timing/tsc.hpp"
+#include "shared/logger/logger.hpp"
+
+static g_boot_phase bootPhases[G_BOOT_PHASES_MAX];
+static volatile uint32_t bootPhaseCount = 0;
+
+static uint64_t bootKernelEntry = 0;
+static volatile uint64_t bootFinish = 0;
+
+void bootPhasesInitialize()
+{
+	tscDetect();
+	bootKernelEntry = tscRead();
+}
+
+int bootPhaseBegin(const char* name)
+{
+	uint32_t position = __sync_fetch_and_add(&bootPhaseCount, 1);
+	if(position >= G_BOOT_PHASES_MAX)
+		return -1;
+
+	g_boot_phase* phase = &bootPhases[position];
+	phase->name = name;
+	phase->processor = processorGetCurrentId();
+	phase->end = 0;
+	phase->start = tscRead();
+	return position;
+}
+
+void bootPhaseEnd(int phase)
+{
+	if(phase < 0)
+		return;
+
+	bootPhases[phase].end = tscRead();
+}
+
+void bootPhasesFinish()
+{
+	bootFinish = tscRead();
+
+	uint32_t count = bootPhasesGetCount();
+	for(uint32_t i = 0; i < count; i++)
+	{
+		g_boot_phase* phase = &bootPhases[i];
+		uint32_t start = tscToMicros(phase->start - bootKernelEntry);
+		uint32_t duration = phase->end ? tscToMicros(phase->end - phase->start) : 0;
+		logInfo("%! phase=%s cpu=%i start=%i duration=%i", "boot", phase->name ? phase->name : "?", phase->processor, start, duration);
+	}
+
+	uint32_t firmware = tscToMicros(bootKernelEntry);
+	uint32_t total = tscToMicros(bootFinish - bootKernelEntry);
+	logInfo("%! firmware=%i total=%i", "boot", firmware, total);
+	logInfo("%! desktop ready after %ims", "boot", total / 1000);
+}
+
+bool bootPhasesIsFinished()
+{
+	return bootFinish != 0;
+}
+
+uint32_t bootPhasesGetCount()
+{
+	uint32_t count = bootPhaseCount;
+	return count < G_BOOT_PHASES_MAX ? count : G_BOOT_PHASES_MAX;
+}
+
+bool bootPhasesGet(uint32_t position, g_boot_phase* out)
+{
+	if(position >= bootPhasesGetCount())
+		return false;
+
+	*out = bootPhases[position];
+	return true;
+}
+
+uint64_t bootPhasesGetKernelEntry()
+{
+	return bootKernelEntry;
+}
+
+uint64_t bootPhasesGetFinish()
+{
+	return bootFinish;
+}
@@ -0,0 +1,94 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_BOOT_PHASES__
+#define __KERNEL_BOOT_PHASES__
+
+#include "ghost/stdint.h"
+
+/**
+ * Maximum number of phases that are recorded during boot.
+ */
+#define G_BOOT_PHASES_MAX 48
+
+/**
+ * A single phase of the boot. Timestamps are raw time stamp counter values,
+ * an end of 0 means that the phase is still running.
+ */
+struct g_boot_phase
+{
+	const char* name;
+	uint32_t processor;
+	uint64_t start;
+	volatile uint64_t end;
+};
+
+/**
+ * Remembers the time of kernel entry. Must be called first thing in the kernel,
+ * all phase times are relative to this.
+ */
+void bootPhasesInitialize();
+
+/**
+ * Starts a new phase on the current processor. The name must be a constant
+ * string, it is not copied.
+ *
+ * @return the phase handle to pass to {bootPhaseEnd} or -1 if full
+ */
+int bootPhaseBegin(const char* name);
+
+/**
+ * Ends a phase that was started with {bootPhaseBegin}.
+ */
+void bootPhaseEnd(int phase);
+
+/**
+ * Marks the boot as finished and prints the summary of all phases.
+ */
+void bootPhasesFinish();
+
+/**
+ * @return whether the boot is finished
+ */
+bool bootPhasesIsFinished();
+
+/**
+ * @return the number of recorded phases
+ */
+uint32_t bootPhasesGetCount();
+
+/**
+ * Copies the phase at the given position.
+ *
+ * @return whether there is such a phase
+ */
+bool bootPhasesGet(uint32_t position, g_boot_phase* out);
+
+/**
+ * @return the time stamp counter value at kernel entry
+ */
+uint64_t bootPhasesGetKernelEntry();
+
+/**
+ * @return the time stamp counter value at which the boot was finished
+ */
+uint64_t bootPhasesGetFinish();
+
+#endif
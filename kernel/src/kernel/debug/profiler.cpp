@@ -0,0 +1,268 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/debug/profiler.hpp"
+#include "kernel/memory/heap.hpp"
+#include "kernel/memory/memory.hpp"
+#include "kernel/memory/paging.hpp"
+#include "kernel/system/processor/processor.hpp"
+#include "kernel/system/timing/tsc.hpp"
+#include "kernel/tasking/elf/elf_object.hpp"
+#include "shared/logger/logger.hpp"
+
+volatile bool profilerEnabled = false;
+static uint32_t profilerInterval = 1;
+static g_profiler_ring* profilerRings = nullptr;
+static uint32_t profilerRingCount = 0;
+
+/**
+ * Checks that a frame pointer of the interrupted code can be dereferenced:
+ * it must be aligned, lie within the stack area of the respective privilege
+ * level and both the saved frame pointer and the return address must be mapped.
+ */
+static bool _profilerIsValidFrame(g_address ebp, bool kernel);
+
+/**
+ * Walks the frame pointer chain starting at "ebp" and appends the return addresses
+ * to the frames of the sample.
+ */
+static void _profilerWalkFrames(g_profiler_sample* sample, g_address ebp);
+
+void profilerInitialize()
+{
+#if G_PROFILING
+	profilerRingCount = processorGetNumberOfProcessors();
+	profilerRings = (g_profiler_ring*) heapAllocateClear(sizeof(g_profiler_ring) * profilerRingCount);
+
+	uint32_t pages = G_PAGE_ALIGN_UP(sizeof(g_profiler_sample) * G_PROFILER_RING_SAMPLES) / G_PAGE_SIZE;
+	for(uint32_t i = 0; i < profilerRingCount; i++)
+	{
+		profilerRings[i].head = 0;
+		profilerRings[i].ticks = 0;
+		profilerRings[i].samples = (g_profiler_sample*) memoryAllocateKernelRange(pages);
+		if(!profilerRings[i].samples)
+		{
+			logWarn("%! failed to allocate buffer for processor %i", "profiler", i);
+			profilerRingCount = i;
+			break;
+		}
+	}
+	logDebug("%! %i buffers with %i samples each", "profiler", profilerRingCount, G_PROFILER_RING_SAMPLES);
+#endif
+}
+
+void profilerTick(g_task* task, volatile g_processor_state* state)
+{
+	uint32_t processor = processorGetCurrentId();
+	if(!task || processor >= profilerRingCount)
+		return;
+
+	g_profiler_ring* ring = &profilerRings[processor];
+	if(++ring->ticks < profilerInterval)
+		return;
+	ring->ticks = 0;
+
+	// Idle time is not interesting, VM86 tasks have no usable frame chain
+	if(task == taskingGetLocal()->scheduling.idleTask || (state->eflags & 0x20000))
+		return;
+
+	bool kernel = (state->cs & 3) == 0;
+
+	g_profiler_sample* sample = &ring->samples[ring->head & (G_PROFILER_RING_SAMPLES - 1)];
+	sample->timestamp = tscRead();
+	sample->task = task->id;
+	sample->process = task->process->id;
+	sample->processor = processor;
+	sample->kernel = kernel;
+	sample->frames[0] = state->eip;
+	sample->depth = 1;
+	_profilerWalkFrames(sample, state->ebp);
+	ring->head++;
+}
+
+void _profilerWalkFrames(g_profiler_sample* sample, g_address ebp)
+{
+	while(sample->depth < G_PROFILER_MAX_FRAMES && _profilerIsValidFrame(ebp, sample->kernel))
+	{
+		g_address* frame = (g_address*) ebp;
+		g_address returnAddress = frame[1];
+		if(returnAddress == 0)
+			break;
+		sample->frames[sample->depth++] = returnAddress;
+
+		// Stacks grow downwards, so a caller frame is always above the callee
+		g_address next = frame[0];
+		if(next <= ebp)
+			break;
+		ebp = next;
+	}
+}
+
+bool _profilerIsValidFrame(g_address ebp, bool kernel)
+{
+	if(ebp & 3)
+		return false;
+
+	if(kernel)
+	{
+		if(ebp < G_KERNEL_AREA_START || ebp >= G_KERNEL_VIRTUAL_RANGES_END - 2 * sizeof(g_address))
+			return false;
+	}
+	else
+	{
+		if(ebp < G_LOWER_MEMORY_END || ebp >= G_USER_VIRTUAL_RANGES_END - 2 * sizeof(g_address))
+			return false;
+	}
+
+	// Both words may be on different pages
+	return (pagingGetPageFlags(ebp) & G_PAGE_PRESENT) &&
+		   (pagingGetPageFlags(ebp + sizeof(g_address)) & G_PAGE_PRESENT);
+}
+
+void profilerStart(uint32_t interval)
+{
+	if(profilerRingCount == 0)
+		return;
+
+	profilerInterval = interval > 0 ? interval : 1;
+	profilerEnabled = true;
+}
+
+void profilerStop()
+{
+	profilerEnabled = false;
+}
+
+void profilerReset()
+{
+	for(uint32_t i = 0; i < profilerRingCount; i++)
+	{
+		profilerRings[i].head = 0;
+		profilerRings[i].ticks = 0;
+	}
+}
+
+uint32_t profilerGetProcessorCount()
+{
+	return profilerRingCount;
+}
+
+uint32_t profilerRead(uint32_t processor, g_profiler_sample* buffer, uint32_t capacity, uint32_t* outDropped)
+{
+	*outDropped = 0;
+	if(processor >= profilerRingCount)
+		return 0;
+
+	g_profiler_ring* ring = &profilerRings[processor];
+	uint32_t head = ring->head;
+
+	uint32_t available = head;
+	if(available > G_PROFILER_RING_SAMPLES)
+	{
+		*outDropped = available - G_PROFILER_RING_SAMPLES;
+		available = G_PROFILER_RING_SAMPLES;
+	}
+
+	uint32_t count = available < capacity ? available : capacity;
+	uint32_t start = head - count;
+	for(uint32_t i = 0; i < count; i++)
+		buffer[i] = ring->samples[(start + i) & (G_PROFILER_RING_SAMPLES - 1)];
+
+	return count;
+}
+
+/**
+ * Collects the modules of a process while it is inspected. Only counts them if no buffer
+ * is given.
+ */
+bool _profilerCollectModules(g_pid pid, g_profiler_module* buffer, uint32_t capacity, uint32_t* outCount)
+{
+	*outCount = 0;
+
+	g_task* task = taskingInspectById(pid);
+	if(!task)
+		return false;
+
+	g_process* process = task->process;
+	mutexAcquire(&process->lock);
+	if(process->object)
+	{
+		auto iter = hashmapIteratorStart(process->object->loadedObjects);
+		while(hashmapIteratorHasNext(&iter) && (!buffer || *outCount < capacity))
+		{
+			g_elf_object* object = hashmapIteratorNext(&iter)->value;
+			if(!buffer)
+			{
+				(*outCount)++;
+				continue;
+			}
+
+			g_profiler_module* module = &buffer[(*outCount)++];
+			module->process = process->id;
+			module->start = object->startAddress;
+			module->end = object->endAddress;
+			module->base = object->baseAddress;
+
+			// The executable is loaded as "root", its path is more useful for symbolization
+			const char* name = object->name;
+			if(object == process->object && process->environment.executablePath)
+				name = process->environment.executablePath;
+
+			uint32_t length = 0;
+			while(name[length] && length < G_PROFILER_MODULE_NAME_MAX - 1)
+			{
+				module->name[length] = name[length];
+				length++;
+			}
+			module->name[length] = 0;
+		}
+		hashmapIteratorEnd(&iter);
+	}
+	mutexRelease(&process->lock);
+	taskingInspectEnd(task);
+	return true;
+}
+
+bool profilerGetModules(g_pid pid, g_profiler_module* buffer, uint32_t capacity, uint32_t* outCount)
+{
+	*outCount = 0;
+
+	uint32_t available;
+	if(!_profilerCollectModules(pid, nullptr, 0, &available))
+		return false;
+
+	uint32_t count = available < capacity ? available : capacity;
+	if(count == 0)
+		return true;
+
+	// The user buffer may fault, so it is only written after the locks are released
+	auto modules = (g_profiler_module*) heapAllocate(sizeof(g_profiler_module) * count);
+	if(!modules)
+		return false;
+
+	bool found = _profilerCollectModules(pid, modules, count, &count);
+	if(found)
+	{
+		memoryCopy(buffer, modules, sizeof(g_profiler_module) * count);
+		*outCount = count;
+	}
+	heapFree(modules);
+	return found;
+}
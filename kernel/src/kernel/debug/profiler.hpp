@@ -0,0 +1,92 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+#ifndef __KERNEL_PROFILER__
+#define __KERNEL_PROFILER__
+
+#include "build_config.hpp"
+#include "kernel/tasking/tasking.hpp"
+#include <ghost/profiler.h>
+
+/**
+ * Number of samples in the buffer of each processor, must be a power of two.
+ */
+#define G_PROFILER_RING_SAMPLES 4096
+
+/**
+ * Sample buffer of a single processor. It is only written by the timer
+ * interrupt of its processor; the head only ever increases.
+ */
+struct g_profiler_ring
+{
+	volatile uint32_t head;
+	uint32_t ticks;
+	g_profiler_sample* samples;
+};
+
+extern volatile bool profilerEnabled;
+
+/**
+ * Allocates the sample buffers for all processors.
+ */
+void profilerInitialize();
+
+/**
+ * Called by the timer interrupt with the state of the interrupted task. Takes
+ * a sample if the sampling interval of the current processor has elapsed.
+ */
+void profilerTick(g_task* task, volatile g_processor_state* state);
+
+/**
+ * Starts sampling every "interval" timer ticks.
+ */
+void profilerStart(uint32_t interval);
+
+/**
+ * Stops sampling.
+ */
+void profilerStop();
+
+/**
+ * Clears the buffers of all processors.
+ */
+void profilerReset();
+
+/**
+ * @return the number of processors that have a sample buffer
+ */
+uint32_t profilerGetProcessorCount();
+
+/**
+ * Copies the most recent samples of a processor to the buffer, oldest first.
+ *
+ * @return the number of copied samples
+ */
+uint32_t profilerRead(uint32_t processor, g_profiler_sample* buffer, uint32_t capacity, uint32_t* outDropped);
+
+/**
+ * Copies the address ranges of the ELF objects loaded into a process.
+ *
+ * @return whether the process exists
+ */
+bool profilerGetModules(g_pid pid, g_profiler_module* buffer, uint32_t capacity, uint32_t* outCount);
+
+#endif
@@ -0,0 +1,116 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/debug/trace.hpp"
+#include "kernel/memory/heap.hpp"
+#include "kernel/memory/memory.hpp"
+#include "kernel/system/processor/processor.hpp"
+#include "kernel/system/timing/tsc.hpp"
+#include "kernel/tasking/tasking.hpp"
+#include "shared/logger/logger.hpp"
+
+volatile bool traceEnabled = false;
+static g_trace_ring* traceRings = nullptr;
+static uint32_t traceRingCount = 0;
+
+void traceInitialize()
+{
+#if G_TRACING
+	traceRingCount = processorGetNumberOfProcessors();
+	traceRings = (g_trace_ring*) heapAllocateClear(sizeof(g_trace_ring) * traceRingCount);
+
+	uint32_t pages = G_PAGE_ALIGN_UP(sizeof(g_trace_event) * G_TRACE_RING_EVENTS) / G_PAGE_SIZE;
+	for(uint32_t i = 0; i < traceRingCount; i++)
+	{
+		traceRings[i].head = 0;
+		traceRings[i].events = (g_trace_event*) memoryAllocateKernelRange(pages);
+		if(!traceRings[i].events)
+		{
+			logWarn("%! failed to allocate ring for processor %i", "trace", i);
+			traceRingCount = i;
+			break;
+		}
+	}
+	logDebug("%! %i rings with %i events each", "trace", traceRingCount, G_TRACE_RING_EVENTS);
+#endif
+}
+
+void traceRecord(g_trace_event_type type, uint32_t arg1, uint32_t arg2)
+{
+	uint32_t processor = processorGetCurrentId();
+	if(processor >= traceRingCount)
+		return;
+
+	// Interrupts may record events while this one is written, so the slot is reserved atomically
+	g_trace_ring* ring = &traceRings[processor];
+	uint32_t index = __sync_fetch_and_add(&ring->head, 1) & (G_TRACE_RING_EVENTS - 1);
+
+	g_task* task = taskingGetLocalByProcessor(processor)->scheduling.current;
+
+	g_trace_event* event = &ring->events[index];
+	event->timestamp = tscRead();
+	event->task = task ? task->id : -1;
+	event->type = type;
+	event->processor = processor;
+	event->arg1 = arg1;
+	event->arg2 = arg2;
+}
+
+void traceSetEnabled(bool enabled)
+{
+	if(traceRingCount == 0)
+		return;
+	traceEnabled = enabled;
+}
+
+void traceReset()
+{
+	for(uint32_t i = 0; i < traceRingCount; i++)
+		traceRings[i].head = 0;
+}
+
+uint32_t traceGetProcessorCount()
+{
+	return traceRingCount;
+}
+
+uint32_t traceRead(uint32_t processor, g_trace_event* buffer, uint32_t capacity, uint32_t* outDropped)
+{
+	*outDropped = 0;
+	if(processor >= traceRingCount)
+		return 0;
+
+	g_trace_ring* ring = &traceRings[processor];
+	uint32_t head = ring->head;
+
+	uint32_t available = head;
+	if(available > G_TRACE_RING_EVENTS)
+	{
+		*outDropped = available - G_TRACE_RING_EVENTS;
+		available = G_TRACE_RING_EVENTS;
+	}
+
+	uint32_t count = available < capacity ? available : capacity;
+	uint32_t start = head - count;
+	for(uint32_t i = 0; i < count; i++)
+		buffer[i] = ring->events[(start + i) & (G_TRACE_RING_EVENTS - 1)];
+
+	return count;
+}
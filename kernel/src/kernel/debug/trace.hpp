@@ -0,0 +1,93 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_TRACE__
+#define __KERNEL_TRACE__
+
+#include "build_config.hpp"
+#include <ghost/trace.h>
+
+/**
+ * Number of events in the ring of each processor, must be a power of two.
+ */
+#define G_TRACE_RING_EVENTS 8192
+
+/**
+ * Ring of trace events of a single processor. The head only ever increases,
+ * the slot of an event is its index modulo the ring size.
+ */
+struct g_trace_ring
+{
+	volatile uint32_t head;
+	g_trace_event* events;
+};
+
+#if G_TRACING
+
+extern volatile bool traceEnabled;
+
+#define G_TRACE(type, arg1, arg2)                                    \
+	do                                                               \
+	{                                                                \
+		if(traceEnabled)                                             \
+			traceRecord(type, (uint32_t) (arg1), (uint32_t) (arg2)); \
+	} while(0)
+
+#else
+#define G_TRACE(type, arg1, arg2) \
+	do                            \
+	{                             \
+	} while(0)
+#endif
+
+/**
+ * Allocates the trace rings for all processors.
+ */
+void traceInitialize();
+
+/**
+ * Records an event in the ring of the current processor. Should only be
+ * used through the <G_TRACE> macro.
+ */
+void traceRecord(g_trace_event_type type, uint32_t arg1, uint32_t arg2);
+
+/**
+ * Starts or stops recording.
+ */
+void traceSetEnabled(bool enabled);
+
+/**
+ * Clears the rings of all processors.
+ */
+void traceReset();
+
+/**
+ * @return the number of processors that have a trace ring
+ */
+uint32_t traceGetProcessorCount();
+
+/**
+ * Copies the most recent events of a processor to the buffer, oldest first.
+ *
+ * @return the number of copied events
+ */
+uint32_t traceRead(uint32_t processor, g_trace_event* buffer, uint32_t capacity, uint32_t* outDropped);
+
+#endif
@@ -19,12 +19,17 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "kernel/filesystem/filesystem.hpp"
+#include "kernel/filesystem/filesystem_ioring.hpp"
+#include "kernel/filesystem/filesystem_pagecache.hpp"
 #include "kernel/filesystem/filesystem_pipedelegate.hpp"
 #include "kernel/filesystem/filesystem_process.hpp"
 #include "kernel/filesystem/filesystem_ramdiskdelegate.hpp"
+#include "kernel/filesystem/filesystem_taskeddelegate.hpp"
+#include "kernel/filesystem/filesystem_tmpfsdelegate.hpp"
 #include "kernel/ipc/pipes.hpp"
 #include "kernel/memory/memory.hpp"
 #include "kernel/tasking/tasking.hpp"
+#include "kernel/utils/hashmap.hpp"
 #include "shared/panic.hpp"
 #include "shared/system/mutex.hpp"
 #include "shared/utils/string.hpp"
@@ -37,6 +42,7 @@ static g_fs_virt_id filesystemNextNodeId;
 static g_mutex filesystemNextNodeIdLock;
 
 static g_hashmap<g_fs_virt_id, g_fs_node*>* filesystemNodes;
+static g_fs_statistics filesystemStatistics;
 
 void filesystemInitialize()
 {
@@ -46,6 +52,10 @@ void filesystemInitialize()
 	filesystemNodes = hashmapCreateNumeric<g_fs_virt_id, g_fs_node*>(1024);
 
 	filesystemProcessInitialize();
+	filesystemPageCacheInitialize();
+	filesystemIoRingInitialize();
+	filesystemTaskedDelegateInitialize();
+	filesystemTmpfsDelegateInitialize(filesystemTmpfsDelegateGetConfiguredLimit());
 	filesystemCreateRoot();
 }
 
@@ -57,11 +67,15 @@ void filesystemCreateRoot()
 	ramdiskDelegate->discover = filesystemRamdiskDelegateDiscover;
 	ramdiskDelegate->read = filesystemRamdiskDelegateRead;
 	ramdiskDelegate->write = filesystemRamdiskDelegateWrite;
+	ramdiskDelegate->writeVector = filesystemRamdiskDelegateWriteVector;
 	ramdiskDelegate->truncate = filesystemRamdiskDelegateTruncate;
 	ramdiskDelegate->create = filesystemRamdiskDelegateCreate;
 	ramdiskDelegate->getLength = filesystemRamdiskDelegateGetLength;
 	ramdiskDelegate->close = filesystemRamdiskDelegateClose;
 	ramdiskDelegate->refreshDir = filesystemRamdiskDelegateRefreshDir;
+	ramdiskDelegate->unlink = filesystemRamdiskDelegateUnlink;
+	ramdiskDelegate->remove = filesystemRamdiskDelegateRemove;
+	ramdiskDelegate->cacheable = true;
 
 	filesystemRoot = filesystemCreateNode(G_FS_NODE_TYPE_ROOT, "root");
 	filesystemRoot->delegate = ramdiskDelegate;
@@ -89,6 +103,23 @@ void filesystemCreateRoot()
 	pipesFolder = filesystemCreateNode(G_FS_NODE_TYPE_MOUNTPOINT, "pipes");
 	pipesFolder->delegate = pipeDelegate;
 	filesystemAddChild(mountFolder, pipesFolder);
+
+	// Mount tmpfs
+	g_fs_delegate* tmpfsDelegate = filesystemCreateDelegate();
+	tmpfsDelegate->open = filesystemTmpfsDelegateOpen;
+	tmpfsDelegate->discover = filesystemTmpfsDelegateDiscover;
+	tmpfsDelegate->read = filesystemTmpfsDelegateRead;
+	tmpfsDelegate->write = filesystemTmpfsDelegateWrite;
+	tmpfsDelegate->truncate = filesystemTmpfsDelegateTruncate;
+	tmpfsDelegate->create = filesystemTmpfsDelegateCreate;
+	tmpfsDelegate->getLength = filesystemTmpfsDelegateGetLength;
+	tmpfsDelegate->close = filesystemTmpfsDelegateClose;
+	tmpfsDelegate->refreshDir = filesystemTmpfsDelegateRefreshDir;
+	tmpfsDelegate->remove = filesystemTmpfsDelegateRemove;
+
+	g_fs_node* tmpfsMountpoint = filesystemCreateNode(G_FS_NODE_TYPE_MOUNTPOINT, "tmp");
+	tmpfsMountpoint->delegate = tmpfsDelegate;
+	filesystemAddChild(filesystemRoot, tmpfsMountpoint);
 }
 
 g_fs_node* filesystemCreateNode(g_fs_node_type type, const char* name)
@@ -98,16 +129,51 @@ g_fs_node* filesystemCreateNode(g_fs_node_type type, const char* name)
 	node->type = type;
 	node->name = stringDuplicate(name);
 	node->parent = 0;
-	node->children = 0;
 	node->delegate = 0;
 	node->blocking = false;
 	node->upToDate = false;
+	node->openCount = 0;
+	node->unlinked = false;
 	mutexInitialize(&node->lock);
 
 	hashmapPut<g_fs_virt_id, g_fs_node*>(filesystemNodes, node->id, node);
 	return node;
 }
 
+/**
+ * Destroys a node that was unlinked and is no longer open.
+ */
+void _filesystemDestroyNode(g_fs_node* node)
+{
+	g_fs_delegate* delegate = filesystemFindDelegate(node);
+	if(delegate->cacheable)
+		filesystemPageCacheInvalidate(node);
+	if(delegate->remove)
+		delegate->remove(node);
+
+	hashmapRemove(filesystemNodes, node->id);
+	heapFree(node->name);
+	heapFree(node);
+}
+
+void filesystemRetainNode(g_fs_node* node)
+{
+	mutexAcquire(&node->lock);
+	node->openCount++;
+	mutexRelease(&node->lock);
+}
+
+void filesystemReleaseNode(g_fs_node* node)
+{
+	mutexAcquire(&node->lock);
+	node->openCount--;
+	bool destroy = node->unlinked && node->openCount == 0;
+	mutexRelease(&node->lock);
+
+	if(destroy)
+		_filesystemDestroyNode(node);
+}
+
 void filesystemAddChild(g_fs_node* parent, g_fs_node* child)
 {
 	mutexAcquire(&parent->lock);
@@ -116,10 +182,7 @@ void filesystemAddChild(g_fs_node* parent, g_fs_node* child)
 	if(!child->delegate)
 		child->delegate = parent->delegate;
 
-	g_fs_node_entry* entry = (g_fs_node_entry*) heapAllocate(sizeof(g_fs_node_entry));
-	entry->node = child;
-	entry->next = parent->children;
-	parent->children = entry;
+	filesystemChildrenAdd(&parent->children, child, child->name);
 
 	mutexRelease(&parent->lock);
 }
@@ -142,6 +205,11 @@ g_fs_node* filesystemGetRoot()
 	return filesystemRoot;
 }
 
+g_fs_node* filesystemGetMountFolder()
+{
+	return mountFolder;
+}
+
 g_fs_delegate* filesystemCreateDelegate()
 {
 	g_fs_delegate* delegate = (g_fs_delegate*) heapAllocateClear(sizeof(g_fs_delegate));
@@ -163,15 +231,17 @@ g_fs_delegate* filesystemFindDelegate(g_fs_node* node)
 	return delegate;
 }
 
-bool filesystemFindExistingChild(g_fs_node* parent, const char* name, g_fs_node** outChild)
+bool filesystemFindExistingChild(g_fs_node* parent, const char* name, g_fs_node** outChild, bool reference)
 {
 	mutexAcquire(&parent->lock);
 
 	g_fs_node* child = nullptr;
+	bool ancestor = false;
 
 	if(stringEquals(name, ".."))
 	{
 		child = parent->parent;
+		ancestor = true;
 	}
 	else if(stringEquals(name, "."))
 	{
@@ -179,28 +249,26 @@ bool filesystemFindExistingChild(g_fs_node* parent, const char* name, g_fs_node*
 	}
 	else
 	{
-		g_fs_node_entry* childEntry = parent->children;
-		while(childEntry)
-		{
-			if(stringEquals(name, childEntry->node->name))
-			{
-				child = childEntry->node;
-				break;
-			}
-			childEntry = childEntry->next;
-		}
+		child = filesystemChildrenFind(&parent->children, name);
 	}
 
+	// Children are locked after their parent, so a parent node is retained after unlocking
+	if(child && reference && !ancestor)
+		filesystemRetainNode(child);
+
 	mutexRelease(&parent->lock);
 
+	if(child && reference && ancestor)
+		filesystemRetainNode(child);
+
 	if(outChild)
 		*outChild = child;
 	return child != nullptr;
 }
 
-g_fs_open_status filesystemFindChild(g_fs_node* parent, const char* name, g_fs_node** outChild)
+g_fs_open_status filesystemFindChild(g_fs_node* parent, const char* name, g_fs_node** outChild, bool reference)
 {
-	if(filesystemFindExistingChild(parent, name, outChild))
+	if(filesystemFindExistingChild(parent, name, outChild, reference))
 		return G_FS_OPEN_SUCCESSFUL;
 
 	g_fs_delegate* delegate = filesystemFindDelegate(parent);
@@ -209,15 +277,25 @@ g_fs_open_status filesystemFindChild(g_fs_node* parent, const char* name, g_fs_n
 		*outChild = 0;
 		return G_FS_OPEN_ERROR;
 	}
-	return delegate->discover(parent, name, outChild);
+
+	g_fs_open_status status = delegate->discover(parent, name, outChild);
+	if(status != G_FS_OPEN_SUCCESSFUL || !reference)
+		return status;
+
+	// Discovered children are added to the parent, take the reference from there
+	if(!filesystemFindExistingChild(parent, name, outChild, true))
+		return G_FS_OPEN_NOT_FOUND;
+	return G_FS_OPEN_SUCCESSFUL;
 }
 
-g_filesystem_find_result filesystemFind(g_fs_node* parent, const char* path)
+g_filesystem_find_result filesystemFind(g_fs_node* parent, const char* path, bool reference)
 {
 	if(parent == nullptr)
 		parent = filesystemRoot;
 
 	g_fs_node* node = parent;
+	if(reference)
+		filesystemRetainNode(node);
 	g_fs_node* lastFoundParent = node;
 	g_fs_open_status status = G_FS_OPEN_SUCCESSFUL;
 
@@ -242,6 +320,7 @@ g_filesystem_find_result filesystemFind(g_fs_node* parent, const char* path)
 		if(remaining > G_FILENAME_MAX)
 		{
 			status = G_FS_OPEN_ERROR;
+			lastFoundParent = node;
 			logInfo("%! tried to resolve path with filename (%i) longer than max (%i): %s", "fs", remaining, G_FILENAME_MAX, path);
 			break;
 		}
@@ -252,7 +331,8 @@ g_filesystem_find_result filesystemFind(g_fs_node* parent, const char* path)
 
 		// Find child with this name
 		lastFoundParent = node;
-		status = filesystemFindChild(node, nameStart, &node);
+		g_fs_node* child;
+		status = filesystemFindChild(node, nameStart, &child, reference);
 
 		// Unclobber
 		nameStart[remaining] = clobberedChar;
@@ -260,12 +340,17 @@ g_filesystem_find_result filesystemFind(g_fs_node* parent, const char* path)
 		if(status != G_FS_OPEN_SUCCESSFUL)
 			break;
 
+		// Only the reference on the node that is returned is kept
+		if(reference)
+			filesystemReleaseNode(node);
+		node = child;
+
 		nameStart = nameEnd;
 	}
 
 	return {
 		status : status,
-		file : node,
+		file : status == G_FS_OPEN_SUCCESSFUL ? node : nullptr,
 		foundAllButLast : ((nameEnd - nameStart) > 0),
 		lastFoundNode : lastFoundParent,
 		fileNameStart : nameStart
@@ -274,72 +359,104 @@ g_filesystem_find_result filesystemFind(g_fs_node* parent, const char* path)
 
 g_fs_open_status filesystemOpen(const char* path, g_file_flag_mode flags, g_task* task, g_fd* outFd)
 {
-	// Decide for relative path origin
-	g_fs_node* origin = nullptr;
+	return filesystemOpen(path, flags, task->process, outFd);
+}
+
+/**
+ * Decides the node from which the path is resolved for the process. A reference
+ * is taken on the origin that the caller must release.
+ */
+g_fs_open_status _filesystemGetOrigin(const char* path, g_process* process, g_fs_node** outOrigin)
+{
 	if(path[0] != '/')
 	{
-		const char* cwd = task->process->environment.workingDirectory;
+		const char* cwd = process->environment.workingDirectory;
 		if(cwd == nullptr)
 			cwd = "/";
 
-		auto findCwdRes = filesystemFind(0, cwd);
-		if(findCwdRes.status == G_FS_OPEN_SUCCESSFUL)
-			origin = findCwdRes.file;
-		else
+		auto findCwdRes = filesystemFind(0, cwd, true);
+		if(findCwdRes.status != G_FS_OPEN_SUCCESSFUL)
+		{
+			filesystemReleaseNode(findCwdRes.lastFoundNode);
 			return findCwdRes.status;
+		}
+
+		*outOrigin = findCwdRes.file;
+		return G_FS_OPEN_SUCCESSFUL;
 	}
 
-	if(!origin)
-		origin = filesystemGetRoot();
+	*outOrigin = filesystemGetRoot();
+	filesystemRetainNode(*outOrigin);
+	return G_FS_OPEN_SUCCESSFUL;
+}
+
+g_fs_open_status filesystemOpen(const char* path, g_file_flag_mode flags, g_process* process, g_fd* outFd)
+{
+	g_fs_node* origin;
+	g_fs_open_status originStatus = _filesystemGetOrigin(path, process, &origin);
+	if(originStatus != G_FS_OPEN_SUCCESSFUL)
+		return originStatus;
 
-	// Try to find existing node
-	auto findRes = filesystemFind(origin, path);
+	// Try to find existing node, holding a reference until it is opened
+	auto findRes = filesystemFind(origin, path, true);
+	g_fs_node* file = nullptr;
+	g_fs_open_status status = G_FS_OPEN_ERROR;
 
 	// Handle different open cases
 	if(findRes.status == G_FS_OPEN_SUCCESSFUL)
 	{
-		if(findRes.file->type == G_FS_NODE_TYPE_FOLDER)
+		file = findRes.file;
+
+		if(file->type == G_FS_NODE_TYPE_FOLDER)
 		{
 			logInfo("%! tried to open folder", "fs");
-			return G_FS_OPEN_ERROR;
 		}
-
-		if(flags & G_FILE_FLAG_MODE_TRUNCATE)
+		else if((flags & G_FILE_FLAG_MODE_TRUNCATE) && filesystemTruncate(file) != G_FS_OPEN_SUCCESSFUL)
 		{
-			if(filesystemTruncate(findRes.file) != G_FS_OPEN_SUCCESSFUL)
-			{
-				logInfo("%! failed to truncate file %i", "fs", findRes.file->id);
-				return G_FS_OPEN_ERROR;
-			}
+			logInfo("%! failed to truncate file %i", "fs", file->id);
 		}
+		else
+		{
+			status = filesystemOpenNodeFd(file, flags, process->id, outFd);
+		}
+		filesystemReleaseNode(file);
 	}
 	else if(findRes.status == G_FS_OPEN_NOT_FOUND)
 	{
-		if(flags & G_FILE_FLAG_MODE_CREATE)
+		g_fs_node* parent = findRes.lastFoundNode;
+
+		if(!(flags & G_FILE_FLAG_MODE_CREATE))
 		{
-			if(!findRes.foundAllButLast)
-			{
-				logInfo("%! failed to create file '%s' in parent %i because folders do not exist", "fs", path, origin->id);
-				return G_FS_OPEN_ERROR;
-			}
-			else if(filesystemCreateFile(findRes.lastFoundNode, findRes.fileNameStart, &findRes.file) != G_FS_OPEN_SUCCESSFUL)
-			{
-				logInfo("%! failed to create file '%s' in parent %i", "fs", path, origin->id);
-				return G_FS_OPEN_ERROR;
-			}
+			status = G_FS_OPEN_NOT_FOUND;
+		}
+		else if(!findRes.foundAllButLast)
+		{
+			logInfo("%! failed to create file '%s' in parent %i because folders do not exist", "fs", path, origin->id);
+		}
+		else if(filesystemCreateFile(parent, findRes.fileNameStart, &file) != G_FS_OPEN_SUCCESSFUL)
+		{
+			logInfo("%! failed to create file '%s' in parent %i", "fs", path, origin->id);
+		}
+		else if(!filesystemFindExistingChild(parent, findRes.fileNameStart, &file, true))
+		{
+			// Unlinked before it could be opened
+			status = G_FS_OPEN_NOT_FOUND;
 		}
 		else
 		{
-			return G_FS_OPEN_NOT_FOUND;
+			status = filesystemOpenNodeFd(file, flags, process->id, outFd);
+			filesystemReleaseNode(file);
 		}
+		filesystemReleaseNode(parent);
 	}
 	else
 	{
-		return findRes.status;
+		status = findRes.status;
+		filesystemReleaseNode(findRes.lastFoundNode);
 	}
 
-	// Actually open the file
-	return filesystemOpenNodeFd(findRes.file, flags, task->process->id, outFd);
+	filesystemReleaseNode(origin);
+	return status;
 }
 
 g_fs_open_status filesystemOpenNode(g_fs_node* file, g_file_flag_mode flags, g_pid process, g_file_descriptor** outDescriptor, g_fd optionalTargetFd)
@@ -351,11 +468,28 @@ g_fs_open_status filesystemOpenNode(g_fs_node* file, g_file_flag_mode flags, g_p
 		return G_FS_OPEN_ERROR;
 	}
 
+	// an unlinked node can only be opened again while it is still open
+	mutexAcquire(&file->lock);
+	if(file->unlinked && file->openCount == 0)
+	{
+		mutexRelease(&file->lock);
+		return G_FS_OPEN_NOT_FOUND;
+	}
+	file->openCount++;
+	mutexRelease(&file->lock);
+
 	g_fs_open_status status = delegate->open(file, flags);
 	if(status == G_FS_OPEN_SUCCESSFUL)
 	{
 		status = filesystemProcessCreateDescriptor(process, file->id, flags, outDescriptor, optionalTargetFd);
+		if(status != G_FS_OPEN_SUCCESSFUL)
+			delegate->close(file, flags);
 	}
+
+	if(status != G_FS_OPEN_SUCCESSFUL)
+		filesystemReleaseNode(file);
+	else
+		__sync_fetch_and_add(&filesystemStatistics.opens, 1);
 	return status;
 }
 
@@ -369,6 +503,14 @@ g_fs_open_status filesystemOpenNodeFd(g_fs_node* file, g_file_flag_mode flags, g
 }
 
 g_fs_read_status filesystemRead(g_task* task, g_fd fd, uint8_t* buffer, uint64_t length, int64_t* outRead)
+{
+	g_fs_iovec segment;
+	segment.base = buffer;
+	segment.length = length;
+	return filesystemReadVector(task, fd, &segment, 1, -1, outRead);
+}
+
+g_fs_read_status filesystemReadVector(g_task* task, g_fd fd, g_fs_iovec* vector, int count, int64_t offset, int64_t* outRead)
 {
 	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process->id, fd);
 	if(!descriptor)
@@ -382,9 +524,16 @@ g_fs_read_status filesystemRead(g_task* task, g_fd fd, uint8_t* buffer, uint64_t
 		return G_FS_READ_INVALID_FD;
 	}
 
-	int64_t read;
+	bool positional = offset >= 0;
+	if(positional && node->type == G_FS_NODE_TYPE_PIPE)
+	{
+		return G_FS_READ_ERROR;
+	}
+	uint64_t position = positional ? offset : descriptor->offset;
+
+	int64_t read = 0;
 	g_fs_read_status status;
-	while((status = filesystemRead(node, buffer, descriptor->offset, length, &read)) == G_FS_READ_BUSY && node->blocking)
+	while((status = filesystemReadVector(node, vector, count, position, &read)) == G_FS_READ_BUSY && node->blocking)
 	{
 		g_fs_delegate* delegate = filesystemFindDelegate(node);
 		if(!delegate->waitForRead)
@@ -394,10 +543,14 @@ g_fs_read_status filesystemRead(g_task* task, g_fd fd, uint8_t* buffer, uint64_t
 		task->status = G_THREAD_STATUS_WAITING;
 		taskingYield();
 	}
-	if(read > 0)
+	if(read > 0 && !positional)
 	{
 		descriptor->offset += read;
 	}
+	if(read > 0)
+		__sync_fetch_and_add(&filesystemStatistics.bytesRead, read);
+	__sync_fetch_and_add(&filesystemStatistics.reads, 1);
+
 	*outRead = read;
 	return status;
 }
@@ -408,9 +561,52 @@ g_fs_read_status filesystemRead(g_fs_node* node, uint8_t* buffer, uint64_t offse
 	if(!delegate->read)
 		return G_FS_READ_ERROR;
 
+	if(delegate->cacheable && node->type == G_FS_NODE_TYPE_FILE && !node->blocking)
+		return filesystemPageCacheRead(node, delegate, buffer, offset, length, outRead);
+
 	return delegate->read(node, buffer, offset, length, outRead);
 }
 
+g_fs_read_status filesystemReadVector(g_fs_node* node, g_fs_iovec* vector, int count, uint64_t offset, int64_t* outRead)
+{
+	g_fs_delegate* delegate = filesystemFindDelegate(node);
+	if(!delegate->read)
+		return G_FS_READ_ERROR;
+
+	bool cached = delegate->cacheable && node->type == G_FS_NODE_TYPE_FILE && !node->blocking;
+	if(delegate->readVector && !cached)
+		return delegate->readVector(node, vector, count, offset, outRead);
+
+	int64_t total = 0;
+	for(int i = 0; i < count; i++)
+	{
+		if(vector[i].length == 0)
+			continue;
+
+		int64_t read = 0;
+		g_fs_read_status status;
+		if(cached)
+			status = filesystemPageCacheRead(node, delegate, (uint8_t*) vector[i].base, offset + total, vector[i].length, &read);
+		else
+			status = delegate->read(node, (uint8_t*) vector[i].base, offset + total, vector[i].length, &read);
+
+		// errors after a partial transfer are reported on the next call
+		if(status != G_FS_READ_SUCCESSFUL)
+		{
+			if(total > 0)
+				break;
+			return status;
+		}
+
+		total += read;
+		if((uint64_t) read < vector[i].length)
+			break;
+	}
+
+	*outRead = total;
+	return G_FS_READ_SUCCESSFUL;
+}
+
 g_fs_length_status filesystemGetLength(g_task* task, g_fd fd, uint64_t* outLength)
 {
 	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process->id, fd);
@@ -438,6 +634,14 @@ g_fs_length_status filesystemGetLength(g_fs_node* node, uint64_t* outLength)
 }
 
 g_fs_write_status filesystemWrite(g_task* task, g_fd fd, uint8_t* buffer, uint64_t length, int64_t* outWrote)
+{
+	g_fs_iovec segment;
+	segment.base = buffer;
+	segment.length = length;
+	return filesystemWriteVector(task, fd, &segment, 1, -1, outWrote);
+}
+
+g_fs_write_status filesystemWriteVector(g_task* task, g_fd fd, g_fs_iovec* vector, int count, int64_t offset, int64_t* outWrote)
 {
 	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process->id, fd);
 	if(!descriptor)
@@ -451,8 +655,14 @@ g_fs_write_status filesystemWrite(g_task* task, g_fd fd, uint8_t* buffer, uint64
 		return G_FS_WRITE_INVALID_FD;
 	}
 
-	uint64_t startOffset = descriptor->offset;
-	if(descriptor->openFlags & G_FILE_FLAG_MODE_APPEND)
+	bool positional = offset >= 0;
+	if(positional && node->type == G_FS_NODE_TYPE_PIPE)
+	{
+		return G_FS_WRITE_ERROR;
+	}
+
+	uint64_t startOffset = positional ? offset : descriptor->offset;
+	if(!positional && (descriptor->openFlags & G_FILE_FLAG_MODE_APPEND))
 	{
 		if(filesystemGetLength(node, &startOffset) != G_FS_LENGTH_SUCCESSFUL)
 		{
@@ -461,10 +671,10 @@ g_fs_write_status filesystemWrite(g_task* task, g_fd fd, uint8_t* buffer, uint64
 		}
 	}
 
-	int64_t wrote;
+	int64_t wrote = 0;
 	g_fs_write_status status;
 
-	while((status = filesystemWrite(node, buffer, startOffset, length, &wrote)) == G_FS_WRITE_BUSY && node->blocking)
+	while((status = filesystemWriteVector(node, vector, count, startOffset, &wrote)) == G_FS_WRITE_BUSY && node->blocking)
 	{
 		g_fs_delegate* delegate = filesystemFindDelegate(node);
 		if(!delegate->waitForWrite)
@@ -474,10 +684,14 @@ g_fs_write_status filesystemWrite(g_task* task, g_fd fd, uint8_t* buffer, uint64
 		task->status = G_THREAD_STATUS_WAITING;
 		taskingYield();
 	}
-	if(wrote > 0)
+	if(wrote > 0 && !positional)
 	{
 		descriptor->offset = startOffset + wrote;
 	}
+	if(wrote > 0)
+		__sync_fetch_and_add(&filesystemStatistics.bytesWritten, wrote);
+	__sync_fetch_and_add(&filesystemStatistics.writes, 1);
+
 	*outWrote = wrote;
 	return status;
 }
@@ -488,7 +702,50 @@ g_fs_write_status filesystemWrite(g_fs_node* node, uint8_t* buffer, uint64_t off
 	if(!delegate->write)
 		return G_FS_WRITE_ERROR;
 
-	return delegate->write(node, buffer, offset, length, outWrote);
+	g_fs_write_status status = delegate->write(node, buffer, offset, length, outWrote);
+	if(delegate->cacheable)
+		filesystemPageCacheInvalidate(node, offset);
+	return status;
+}
+
+g_fs_write_status filesystemWriteVector(g_fs_node* node, g_fs_iovec* vector, int count, uint64_t offset, int64_t* outWrote)
+{
+	g_fs_delegate* delegate = filesystemFindDelegate(node);
+	if(!delegate->write)
+		return G_FS_WRITE_ERROR;
+
+	g_fs_write_status status = G_FS_WRITE_SUCCESSFUL;
+	int64_t total = 0;
+	if(delegate->writeVector)
+	{
+		status = delegate->writeVector(node, vector, count, offset, &total);
+	}
+	else
+	{
+		for(int i = 0; i < count; i++)
+		{
+			if(vector[i].length == 0)
+				continue;
+
+			int64_t wrote = 0;
+			g_fs_write_status segmentStatus = delegate->write(node, (uint8_t*) vector[i].base, offset + total, vector[i].length, &wrote);
+			if(segmentStatus != G_FS_WRITE_SUCCESSFUL)
+			{
+				if(total == 0)
+					status = segmentStatus;
+				break;
+			}
+
+			total += wrote;
+			if((uint64_t) wrote < vector[i].length)
+				break;
+		}
+	}
+
+	if(delegate->cacheable)
+		filesystemPageCacheInvalidate(node, offset);
+	*outWrote = total;
+	return status;
 }
 
 g_fs_open_status filesystemCreateFile(g_fs_node* parent, const char* name, g_fs_node** outFile)
@@ -506,7 +763,10 @@ g_fs_open_status filesystemTruncate(g_fs_node* file)
 	if(!delegate->truncate)
 		return G_FS_OPEN_ERROR;
 
-	return delegate->truncate(file);
+	g_fs_open_status status = delegate->truncate(file);
+	if(delegate->cacheable)
+		filesystemPageCacheInvalidate(file);
+	return status;
 }
 
 g_fs_pipe_status filesystemCreatePipe(g_bool blocking, g_fs_node** outPipeNode)
@@ -571,9 +831,63 @@ g_fs_close_status filesystemClose(g_pid pid, g_fd fd, g_bool removeDescriptor)
 	if(removeDescriptor)
 		filesystemProcessRemoveDescriptor(pid, fd);
 
+	__sync_fetch_and_add(&filesystemStatistics.closes, 1);
+	filesystemReleaseNode(file);
+	return status;
+}
+
+g_fs_unlink_status filesystemUnlink(const char* path, g_process* process)
+{
+	g_fs_node* origin;
+	if(_filesystemGetOrigin(path, process, &origin) != G_FS_OPEN_SUCCESSFUL)
+		return G_FS_UNLINK_NOT_FOUND;
+
+	auto findRes = filesystemFind(origin, path, true);
+	filesystemReleaseNode(origin);
+
+	if(findRes.status != G_FS_OPEN_SUCCESSFUL)
+	{
+		filesystemReleaseNode(findRes.lastFoundNode);
+		return findRes.status == G_FS_OPEN_NOT_FOUND ? G_FS_UNLINK_NOT_FOUND : G_FS_UNLINK_ERROR;
+	}
+
+	// The reference keeps the node alive, it is destroyed once released
+	g_fs_unlink_status status = filesystemUnlink(findRes.file);
+	filesystemReleaseNode(findRes.file);
 	return status;
 }
 
+g_fs_unlink_status filesystemUnlink(g_fs_node* file)
+{
+	if(file->type != G_FS_NODE_TYPE_FILE || !file->parent)
+		return G_FS_UNLINK_NOT_SUPPORTED;
+
+	g_fs_delegate* delegate = filesystemFindDelegate(file);
+	if(!delegate->remove)
+		return G_FS_UNLINK_NOT_SUPPORTED;
+
+	g_fs_node* parent = file->parent;
+	mutexAcquire(&parent->lock);
+	bool removed = filesystemChildrenRemove(&parent->children, file, file->name);
+	mutexRelease(&parent->lock);
+
+	// unlinked concurrently
+	if(!removed)
+		return G_FS_UNLINK_NOT_FOUND;
+
+	if(delegate->unlink)
+		delegate->unlink(file);
+
+	mutexAcquire(&file->lock);
+	file->unlinked = true;
+	bool destroy = file->openCount == 0;
+	mutexRelease(&file->lock);
+
+	if(destroy)
+		_filesystemDestroyNode(file);
+	return G_FS_UNLINK_SUCCESSFUL;
+}
+
 g_fs_seek_status filesystemSeek(g_task* task, g_fd fd, g_fs_seek_mode mode, int64_t amount, int64_t* outResult)
 {
 	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process->id, fd);
@@ -702,34 +1016,31 @@ g_fs_open_directory_status filesystemOpenDirectory(g_fs_node* dir)
 
 g_fs_read_directory_status filesystemReadDirectory(g_fs_node* dir, uint32_t index, g_fs_node** outChild)
 {
-	auto entry = dir->children;
-	while(entry)
-	{
-		if(!index)
-		{
-			*outChild = entry->node;
-			return G_FS_READ_DIRECTORY_SUCCESSFUL;
-		}
+	mutexAcquire(&dir->lock);
+	g_fs_node* child = filesystemChildrenGet(&dir->children, index);
+	mutexRelease(&dir->lock);
 
-		--index;
-		entry = entry->next;
-	}
-	return G_FS_READ_DIRECTORY_EOD;
+	if(!child)
+		return G_FS_READ_DIRECTORY_EOD;
+
+	*outChild = child;
+	return G_FS_READ_DIRECTORY_SUCCESSFUL;
 }
 
 bool filesystemReadToMemory(g_fd fd, size_t offset, uint8_t* buffer, uint64_t len)
 {
-	int64_t seeked;
-	g_fs_seek_status seekStatus = filesystemSeek(taskingGetCurrentTask(), fd, G_FS_SEEK_SET, offset, &seeked);
-	if(seekStatus != G_FS_SEEK_SUCCESSFUL)
+	g_task* task = taskingGetCurrentTask();
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process->id, fd);
+	if(!descriptor)
 	{
-		logInfo("%! failed to seek to %i in file %i (status %i)", "fs", offset, fd, seekStatus);
+		logInfo("%! failed to read file, invalid fd %i", "fs", fd);
 		return false;
 	}
 
-	if(seeked != offset)
+	g_fs_node* node = filesystemGetNode(descriptor->nodeId);
+	if(!node)
 	{
-		logInfo("%! tried to seek in file to position %i but highest offset is %i", "fs", (uint32_t) offset, (uint32_t) seeked);
+		logInfo("%! failed to read file, no node for fd %i", "fs", fd);
 		return false;
 	}
 
@@ -737,9 +1048,9 @@ bool filesystemReadToMemory(g_fd fd, size_t offset, uint8_t* buffer, uint64_t le
 	while(remain)
 	{
 		int64_t read;
-		auto stat = filesystemRead(taskingGetCurrentTask(), fd, &buffer[len - remain], remain, &read);
+		auto stat = filesystemRead(node, &buffer[len - remain], offset + (len - remain), remain, &read);
 		if(stat != G_FS_READ_SUCCESSFUL ||
-		   read == 0)
+		   read <= 0)
 		{
 			logInfo("%! failed to read file from fd %i (status %i), remaining: %i", "fs", fd, stat, (uint32_t) remain);
 			return false;
@@ -748,3 +1059,8 @@ bool filesystemReadToMemory(g_fd fd, size_t offset, uint8_t* buffer, uint64_t le
 	}
 	return true;
 }
+
+g_fs_statistics filesystemGetStatistics()
+{
+	return filesystemStatistics;
+}
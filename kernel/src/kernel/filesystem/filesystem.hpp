@@ -22,11 +22,11 @@
 #define __KERNEL_FILESYSTEM__
 
 #include "ghost/fs.h"
+#include "kernel/filesystem/filesystem_children.hpp"
 #include "kernel/tasking/tasking.hpp"
 #include "shared/system/mutex.hpp"
 
 struct g_fs_node;
-struct g_fs_node_entry;
 struct g_fs_delegate;
 struct g_file_descriptor;
 
@@ -42,21 +42,20 @@ struct g_fs_node
 
 	char* name;
 	g_fs_node* parent;
-	g_fs_node_entry* children;
+	g_fs_node_children children;
 
 	g_fs_delegate* delegate;
 
 	bool blocking;
 	bool upToDate;
-};
 
-/**
- * An entry in the node tree.
- */
-struct g_fs_node_entry
-{
-	g_fs_node* node;
-	g_fs_node_entry* next;
+	/**
+	 * Number of references from open file descriptors, memory mappings and
+	 * lookups in progress. A node that was unlinked is destroyed once this
+	 * drops to zero.
+	 */
+	uint32_t openCount;
+	bool unlinked;
 };
 
 /**
@@ -66,16 +65,46 @@ struct g_fs_delegate
 {
 	g_mutex lock;
 
+	/**
+	 * Whether reads of file nodes may be served from the page cache. Delegates that set
+	 * this must pass all modifications of file content through the file system.
+	 */
+	bool cacheable;
+
+	/**
+	 * Data of the delegate implementation, for delegates that exist multiple times.
+	 */
+	void* data;
+
 	g_fs_open_status (*open)(g_fs_node* node, g_file_flag_mode flags);
 	g_fs_open_status (*discover)(g_fs_node* parent, const char* name, g_fs_node** outNode);
 	g_fs_read_status (*read)(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead);
 	g_fs_write_status (*write)(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote);
+
+	/**
+	 * Optional handlers that process a whole vector at once. If not provided, the
+	 * file system calls the read/write handler once per segment.
+	 */
+	g_fs_read_status (*readVector)(g_fs_node* node, g_fs_iovec* vector, int count, uint64_t offset, int64_t* outRead);
+	g_fs_write_status (*writeVector)(g_fs_node* node, g_fs_iovec* vector, int count, uint64_t offset, int64_t* outWrote);
 	g_fs_length_status (*getLength)(g_fs_node* node, uint64_t* outLength);
 	g_fs_open_status (*create)(g_fs_node* parent, const char* name, g_fs_node** outFile);
 	g_fs_open_status (*truncate)(g_fs_node* file);
 	g_fs_close_status (*close)(g_fs_node* node, g_file_flag_mode openFlags);
 	g_fs_directory_refresh_status (*refreshDir)(g_fs_node* node);
 
+	/**
+	 * Optional handler that deletes the content of a file. It is called once the file was
+	 * unlinked and is no longer open. Files can only be unlinked if this is provided.
+	 */
+	void (*remove)(g_fs_node* node);
+
+	/**
+	 * Optional handler that is called when a file is unlinked. Delegates that discover
+	 * their nodes from a backing store use it to hide the file while it is still open.
+	 */
+	void (*unlink)(g_fs_node* node);
+
 	void (*waitForRead)(g_tid task, g_fs_node* node);
 	void (*waitForWrite)(g_tid task, g_fs_node* node);
 };
@@ -90,6 +119,19 @@ struct g_filesystem_find_result
 	const char* fileNameStart;
 };
 
+/**
+ * Counters of file operations.
+ */
+struct g_fs_statistics
+{
+	uint32_t opens;
+	uint32_t closes;
+	uint32_t reads;
+	uint32_t writes;
+	uint64_t bytesRead;
+	uint64_t bytesWritten;
+};
+
 /**
  * Initializes the basic file system structures.
  */
@@ -110,22 +152,36 @@ g_fs_virt_id filesystemGetNextNodeId();
  */
 g_fs_node* filesystemCreateNode(g_fs_node_type type, const char* name);
 
+/**
+ * Takes a reference on the node, see <g_fs_node::openCount>.
+ */
+void filesystemRetainNode(g_fs_node* node);
+
+/**
+ * Releases a reference on the node and destroys it if it was unlinked and this was
+ * the last reference.
+ */
+void filesystemReleaseNode(g_fs_node* node);
+
 /**
  * Searches for an existing node in the parent, otherwise asks the delegate of the
- * parent for this child.
+ * parent for this child. With reference, a reference is taken on the found child
+ * that the caller must release.
  */
-g_fs_open_status filesystemFindChild(g_fs_node* parent, const char* name, g_fs_node** outChild);
+g_fs_open_status filesystemFindChild(g_fs_node* parent, const char* name, g_fs_node** outChild, bool reference = false);
 
 /**
- * Searches for an existing node in the parent.
+ * Searches for an existing node in the parent. With reference, a reference is taken
+ * on the child while the parent is locked, so it can not be destroyed in between.
  */
-bool filesystemFindExistingChild(g_fs_node* parent, const char* name, g_fs_node** outChild = nullptr);
+bool filesystemFindExistingChild(g_fs_node* parent, const char* name, g_fs_node** outChild = nullptr, bool reference = false);
 
 /**
  * Searches for a node by a path relative to the parent node. Uses <filesystemFindChild>
- * to search for a child.
+ * to search for a child. With reference, the caller must release the found file if
+ * the status is successful, otherwise the last found node.
  */
-g_filesystem_find_result filesystemFind(g_fs_node* parent, const char* path);
+g_filesystem_find_result filesystemFind(g_fs_node* parent, const char* path, bool reference = false);
 
 /**
  * Retrieves a node by its virtual id.
@@ -149,6 +205,11 @@ g_fs_delegate* filesystemCreateDelegate();
  */
 g_fs_node* filesystemGetRoot();
 
+/**
+ * Returns the folder that contains the mountpoints.
+ */
+g_fs_node* filesystemGetMountFolder();
+
 /**
  * Searches for the delegate responsible for this node.
  */
@@ -158,6 +219,7 @@ g_fs_delegate* filesystemFindDelegate(g_fs_node* node);
  * Opens a file, creating a file descriptor.
  */
 g_fs_open_status filesystemOpen(const char* path, g_file_flag_mode flags, g_task* task, g_fd* outFd);
+g_fs_open_status filesystemOpen(const char* path, g_file_flag_mode flags, g_process* process, g_fd* outFd);
 g_fs_open_status filesystemOpenNode(g_fs_node* file, g_file_flag_mode flags, g_pid process, g_file_descriptor** outDescriptor, g_fd optionalTargetFd = G_FD_NONE);
 g_fs_open_status filesystemOpenNodeFd(g_fs_node* file, g_file_flag_mode flags, g_pid process, g_fd* outFd, g_fd optionalTargetFd = G_FD_NONE);
 
@@ -167,12 +229,26 @@ g_fs_open_status filesystemOpenNodeFd(g_fs_node* file, g_file_flag_mode flags, g
 g_fs_read_status filesystemRead(g_task* task, g_fd fd, uint8_t* buffer, uint64_t length, int64_t* outRead);
 g_fs_read_status filesystemRead(g_fs_node* file, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead);
 
+/**
+ * Reads bytes from a file into multiple buffers. If the offset is negative, the offset of
+ * the descriptor is used and advanced, otherwise the descriptor offset stays untouched.
+ */
+g_fs_read_status filesystemReadVector(g_task* task, g_fd fd, g_fs_iovec* vector, int count, int64_t offset, int64_t* outRead);
+g_fs_read_status filesystemReadVector(g_fs_node* file, g_fs_iovec* vector, int count, uint64_t offset, int64_t* outRead);
+
 /**
  * Writes bytes to a file.
  */
 g_fs_write_status filesystemWrite(g_task* task, g_fd fd, uint8_t* buffer, uint64_t length, int64_t* outWrote);
 g_fs_write_status filesystemWrite(g_fs_node* file, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote);
 
+/**
+ * Writes multiple buffers to a file. The offset is handled like in <filesystemReadVector>,
+ * append mode only applies to writes at the descriptor offset.
+ */
+g_fs_write_status filesystemWriteVector(g_task* task, g_fd fd, g_fs_iovec* vector, int count, int64_t offset, int64_t* outWrote);
+g_fs_write_status filesystemWriteVector(g_fs_node* file, g_fs_iovec* vector, int count, uint64_t offset, int64_t* outWrote);
+
 /**
  * Closes a file descriptor.
  */
@@ -199,6 +275,13 @@ g_fs_open_status filesystemCreateFile(g_fs_node* parent, const char* name, g_fs_
  */
 g_fs_open_status filesystemTruncate(g_fs_node* file);
 
+/**
+ * Removes a file from its parent folder. The node stays valid for descriptors that
+ * still refer to it and is destroyed when the last of them is closed.
+ */
+g_fs_unlink_status filesystemUnlink(const char* path, g_process* process);
+g_fs_unlink_status filesystemUnlink(g_fs_node* file);
+
 /**
  * Creates a new pipe on the filesystem.
  */
@@ -224,13 +307,20 @@ int filesystemGetAbsolutePathLength(g_fs_node* node);
 g_fs_open_directory_status filesystemOpenDirectory(g_fs_node* parent);
 
 /**
- * Reads a directory.
+ * Reads the child at the given index of a directory. Reading the children
+ * in order takes constant time per entry.
  */
 g_fs_read_directory_status filesystemReadDirectory(g_fs_node* parent, uint32_t index, g_fs_node** outChild);
 
 /**
- * Reads bytes from a file to a buffer in memory.
+ * Reads bytes from a file to a buffer in memory. Reads at the given offset without
+ * modifying the offset of the file descriptor.
  */
 bool filesystemReadToMemory(g_fd fd, size_t offset, uint8_t* buffer, uint64_t len);
 
+/**
+ * Returns a snapshot of the counters of file operations done through descriptors.
+ */
+g_fs_statistics filesystemGetStatistics();
+
 #endif
@@ -0,0 +1,168 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/filesystem/filesystem_children.hpp"
+#include "kernel/memory/heap.hpp"
+#include "shared/utils/string.hpp"
+
+void _filesystemChildrenResize(g_fs_node_children* children, uint32_t bucketCount)
+{
+	g_fs_node_entry** buckets = (g_fs_node_entry**) heapAllocateClear(sizeof(g_fs_node_entry*) * bucketCount);
+
+	for(g_fs_node_entry* entry = children->first; entry; entry = entry->next)
+	{
+		uint32_t bucket = entry->hash & (bucketCount - 1);
+		entry->nextInBucket = buckets[bucket];
+		buckets[bucket] = entry;
+	}
+
+	if(children->buckets)
+		heapFree(children->buckets);
+	children->buckets = buckets;
+	children->bucketCount = bucketCount;
+}
+
+void filesystemChildrenAdd(g_fs_node_children* children, g_fs_node* child, const char* name)
+{
+	g_fs_node_entry* entry = (g_fs_node_entry*) heapAllocate(sizeof(g_fs_node_entry));
+	entry->node = child;
+	entry->name = name;
+	entry->hash = stringHash(name);
+	entry->previous = children->last;
+	entry->next = nullptr;
+	entry->nextInBucket = nullptr;
+
+	if(children->last)
+		children->last->next = entry;
+	else
+		children->first = entry;
+	children->last = entry;
+	children->count++;
+
+	if(children->buckets)
+	{
+		if(children->count > children->bucketCount)
+		{
+			_filesystemChildrenResize(children, children->bucketCount * 2);
+		}
+		else
+		{
+			uint32_t bucket = entry->hash & (children->bucketCount - 1);
+			entry->nextInBucket = children->buckets[bucket];
+			children->buckets[bucket] = entry;
+		}
+	}
+	else if(children->count >= G_FS_CHILDREN_INDEX_THRESHOLD)
+	{
+		_filesystemChildrenResize(children, G_FS_CHILDREN_INDEX_INITIAL_BUCKETS);
+	}
+}
+
+g_fs_node* filesystemChildrenFind(g_fs_node_children* children, const char* name)
+{
+	if(!children->buckets)
+	{
+		for(g_fs_node_entry* entry = children->first; entry; entry = entry->next)
+		{
+			if(stringEquals(name, entry->name))
+				return entry->node;
+		}
+		return nullptr;
+	}
+
+	uint32_t hash = stringHash(name);
+	for(g_fs_node_entry* entry = children->buckets[hash & (children->bucketCount - 1)]; entry; entry = entry->nextInBucket)
+	{
+		if(entry->hash == hash && stringEquals(name, entry->name))
+			return entry->node;
+	}
+	return nullptr;
+}
+
+bool filesystemChildrenRemove(g_fs_node_children* children, g_fs_node* child, const char* name)
+{
+	g_fs_node_entry* entry = nullptr;
+	if(children->buckets)
+	{
+		uint32_t hash = stringHash(name);
+		g_fs_node_entry** link = &children->buckets[hash & (children->bucketCount - 1)];
+		while(*link && (*link)->node != child)
+			link = &(*link)->nextInBucket;
+
+		entry = *link;
+		if(entry)
+			*link = entry->nextInBucket;
+	}
+	else
+	{
+		entry = children->first;
+		while(entry && entry->node != child)
+			entry = entry->next;
+	}
+
+	if(!entry)
+		return false;
+
+	if(entry->previous)
+		entry->previous->next = entry->next;
+	else
+		children->first = entry->next;
+
+	if(entry->next)
+		entry->next->previous = entry->previous;
+	else
+		children->last = entry->previous;
+
+	children->count--;
+	children->cursor = nullptr;
+	children->cursorIndex = 0;
+
+	heapFree(entry);
+	return true;
+}
+
+g_fs_node* filesystemChildrenGet(g_fs_node_children* children, uint32_t index)
+{
+	g_fs_node_entry* entry;
+	uint32_t position;
+	if(children->cursor && index >= children->cursorIndex)
+	{
+		entry = children->cursor;
+		position = children->cursorIndex;
+	}
+	else
+	{
+		entry = children->first;
+		position = 0;
+	}
+
+	while(entry && position < index)
+	{
+		entry = entry->next;
+		position++;
+	}
+
+	if(!entry)
+		return nullptr;
+
+	children->cursor = entry;
+	children->cursorIndex = position;
+	return entry->node;
+}
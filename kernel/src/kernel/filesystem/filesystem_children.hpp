@@ -0,0 +1,94 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_FILESYSTEM_CHILDREN__
+#define __KERNEL_FILESYSTEM_CHILDREN__
+
+#include "ghost/stdint.h"
+
+struct g_fs_node;
+
+/**
+ * Number of children from which on a directory keeps a hash index of its children.
+ */
+#define G_FS_CHILDREN_INDEX_THRESHOLD 8
+
+/**
+ * Initial number of buckets of the index. The index doubles once it holds more
+ * children than buckets.
+ */
+#define G_FS_CHILDREN_INDEX_INITIAL_BUCKETS 16
+
+/**
+ * An entry in the node tree.
+ */
+struct g_fs_node_entry
+{
+	g_fs_node* node;
+	const char* name;
+	uint32_t hash;
+
+	g_fs_node_entry* previous;
+	g_fs_node_entry* next;
+	g_fs_node_entry* nextInBucket;
+};
+
+/**
+ * Children of a node. Entries are kept in the order they were added.
+ */
+struct g_fs_node_children
+{
+	g_fs_node_entry* first;
+	g_fs_node_entry* last;
+	uint32_t count;
+
+	g_fs_node_entry** buckets;
+	uint32_t bucketCount;
+
+	/**
+	 * Last entry returned by <filesystemChildrenGet>, so that reading a directory
+	 * in order does not walk the list from the start for each entry. Removing a
+	 * child resets it.
+	 */
+	g_fs_node_entry* cursor;
+	uint32_t cursorIndex;
+};
+
+/**
+ * Adds a child with the given name. The name must stay valid as long as the entry.
+ */
+void filesystemChildrenAdd(g_fs_node_children* children, g_fs_node* child, const char* name);
+
+/**
+ * Searches for the child with the given name.
+ */
+g_fs_node* filesystemChildrenFind(g_fs_node_children* children, const char* name);
+
+/**
+ * Removes the given child. Returns false if it is not a child.
+ */
+bool filesystemChildrenRemove(g_fs_node_children* children, g_fs_node* child, const char* name);
+
+/**
+ * Returns the child at the given position in the order the children were added.
+ */
+g_fs_node* filesystemChildrenGet(g_fs_node_children* children, uint32_t index);
+
+#endif
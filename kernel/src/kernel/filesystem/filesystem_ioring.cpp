@@ -0,0 +1,604 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/filesystem/filesystem_ioring.hpp"
+#include "kernel/filesystem/filesystem.hpp"
+#include "kernel/filesystem/filesystem_process.hpp"
+#include "kernel/memory/heap.hpp"
+#include "kernel/memory/memory.hpp"
+#include "kernel/tasking/clock.hpp"
+#include "shared/logger/logger.hpp"
+#include "shared/memory/constants.hpp"
+
+static g_mutex ioRingIdLock;
+static g_io_ring_id ioRingNextId;
+
+void filesystemIoRingInitialize()
+{
+	mutexInitialize(&ioRingIdLock);
+	ioRingNextId = 1;
+}
+
+uint32_t _filesystemIoRingCompletionCount(g_fs_io_ring* ring)
+{
+	uint32_t count = ring->completionTail - ring->header->completion.head;
+	return count > ring->completionEntries ? ring->completionEntries : count;
+}
+
+g_fs_io_ring* _filesystemIoRingAcquire(g_process* process, g_io_ring_id id)
+{
+	mutexAcquire(&process->lock);
+	g_fs_io_ring* ring = process->ioRings;
+	while(ring && (ring->id != id || ring->destroyed))
+		ring = ring->next;
+	if(ring)
+		ring->references++;
+	mutexRelease(&process->lock);
+	return ring;
+}
+
+void _filesystemIoRingFree(g_fs_io_ring* ring, bool unmapUserMemory)
+{
+	// Only possible from within the process, otherwise the address space is destroyed anyway
+	if(unmapUserMemory)
+		memoryUnshareKernelRange(ring->process, ring->userBase, ring->pages);
+	memoryFreeKernelRange(ring->kernelBase);
+
+	while(ring->parked)
+	{
+		g_fs_io_ring_operation* next = ring->parked->next;
+		heapFree(ring->parked);
+		ring->parked = next;
+	}
+	waitQueueWake(&ring->waiters);
+	heapFree(ring);
+}
+
+void _filesystemIoRingRelease(g_fs_io_ring* ring)
+{
+	g_process* process = ring->process;
+
+	mutexAcquire(&process->lock);
+	bool last = (--ring->references == 0);
+	if(last)
+	{
+		g_fs_io_ring** link = &process->ioRings;
+		while(*link && *link != ring)
+			link = &(*link)->next;
+		if(*link)
+			*link = ring->next;
+	}
+	mutexRelease(&process->lock);
+
+	if(last)
+		_filesystemIoRingFree(ring, true);
+}
+
+void _filesystemIoRingWakeWorker(g_fs_io_ring* ring)
+{
+	g_task* worker = taskingGetById(ring->worker);
+	if(worker && worker->status == G_THREAD_STATUS_WAITING)
+		worker->status = G_THREAD_STATUS_RUNNING;
+}
+
+g_io_ring_status filesystemIoRingCreate(g_task* task, uint32_t entries, g_io_ring_id* outId, g_io_ring_header** outHeader)
+{
+	if(entries == 0 || entries > G_IO_RING_MAXIMUM_ENTRIES)
+		return G_IO_RING_STATUS_INVALID_ARGUMENTS;
+
+	uint32_t submissionEntries = 1;
+	while(submissionEntries < entries)
+		submissionEntries <<= 1;
+	uint32_t completionEntries = submissionEntries * 2;
+
+	uint32_t submissionsOffset = G_IO_RING_HEADER_SIZE;
+	uint32_t completionsOffset = submissionsOffset + ((submissionEntries * sizeof(g_io_submission) + 63) & ~63);
+	uint32_t size = completionsOffset + completionEntries * sizeof(g_io_completion);
+	uint32_t pages = G_PAGE_ALIGN_UP(size) / G_PAGE_SIZE;
+
+	g_virtual_address kernelBase = memoryAllocateKernelRange(pages);
+	if(!kernelBase)
+		return G_IO_RING_STATUS_NO_MEMORY;
+	memorySetBytes((void*) kernelBase, 0, pages * G_PAGE_SIZE);
+
+	// The kernel keeps using its own mapping of the pages
+	g_process* process = task->process;
+	g_virtual_address userBase = memoryShareKernelRange(process, kernelBase, pages);
+	if(!userBase)
+	{
+		memoryFreeKernelRange(kernelBase);
+		return G_IO_RING_STATUS_NO_MEMORY;
+	}
+
+	g_fs_io_ring* ring = (g_fs_io_ring*) heapAllocateClear(sizeof(g_fs_io_ring));
+	mutexInitialize(&ring->lock);
+	ring->process = process;
+	ring->references = 1;
+	ring->kernelBase = kernelBase;
+	ring->userBase = userBase;
+	ring->pages = pages;
+	ring->header = (g_io_ring_header*) kernelBase;
+	ring->submissions = (g_io_submission*) (kernelBase + submissionsOffset);
+	ring->completions = (g_io_completion*) (kernelBase + completionsOffset);
+	ring->submissionEntries = submissionEntries;
+	ring->completionEntries = completionEntries;
+
+	ring->header->submission.mask = submissionEntries - 1;
+	ring->header->submission.entries = submissionEntries;
+	ring->header->completion.mask = completionEntries - 1;
+	ring->header->completion.entries = completionEntries;
+	ring->header->submissions_offset = submissionsOffset;
+	ring->header->completions_offset = completionsOffset;
+
+	mutexAcquire(&ioRingIdLock);
+	ring->id = ioRingNextId++;
+	mutexRelease(&ioRingIdLock);
+
+	// The worker lives in the process so that it can access the buffers of the submissions
+	g_task* worker = taskingCreateTask((g_virtual_address) filesystemIoRingWorker, process, G_SECURITY_LEVEL_KERNEL);
+	ring->worker = worker->id;
+
+	mutexAcquire(&process->lock);
+	ring->next = process->ioRings;
+	process->ioRings = ring;
+	mutexRelease(&process->lock);
+
+	taskingAssignBalanced(worker);
+
+	*outId = ring->id;
+	*outHeader = (g_io_ring_header*) userBase;
+	return G_IO_RING_STATUS_SUCCESSFUL;
+}
+
+g_io_ring_status filesystemIoRingEnter(g_task* task, g_io_ring_id id, uint32_t waitFor, uint32_t timeout, uint32_t* outCompletions)
+{
+	*outCompletions = 0;
+
+	g_fs_io_ring* ring = _filesystemIoRingAcquire(task->process, id);
+	if(!ring)
+		return G_IO_RING_STATUS_INVALID_RING;
+
+	mutexAcquire(&ring->lock);
+	ring->submitted = true;
+	_filesystemIoRingWakeWorker(ring);
+	mutexRelease(&ring->lock);
+
+	if(waitFor > ring->completionEntries)
+		waitFor = ring->completionEntries;
+
+	bool useTimeout = waitFor > 0 && timeout > 0;
+	if(useTimeout)
+		clockWaitForTime(task->id, clockGetLocal()->time + timeout);
+
+	g_io_ring_status status = G_IO_RING_STATUS_SUCCESSFUL;
+	for(;;)
+	{
+		mutexAcquire(&ring->lock);
+
+		*outCompletions = _filesystemIoRingCompletionCount(ring);
+		if(ring->destroyed)
+		{
+			status = G_IO_RING_STATUS_INVALID_RING;
+		}
+		else if(*outCompletions < waitFor)
+		{
+			if(!useTimeout || !clockHasTimedOut(task->id))
+			{
+				waitQueueAdd(&ring->waiters, task->id);
+				if(ring->wakeThreshold == 0 || waitFor < ring->wakeThreshold)
+					ring->wakeThreshold = waitFor;
+
+				task->status = G_THREAD_STATUS_WAITING;
+				mutexRelease(&ring->lock);
+				taskingYield();
+				continue;
+			}
+			status = G_IO_RING_STATUS_TIMED_OUT;
+		}
+
+		waitQueueRemove(&ring->waiters, task->id);
+		mutexRelease(&ring->lock);
+		break;
+	}
+
+	if(useTimeout)
+		clockUnwaitForTime(task->id);
+
+	_filesystemIoRingRelease(ring);
+	return status;
+}
+
+g_io_ring_status filesystemIoRingDestroy(g_task* task, g_io_ring_id id)
+{
+	g_fs_io_ring* ring = _filesystemIoRingAcquire(task->process, id);
+	if(!ring)
+		return G_IO_RING_STATUS_INVALID_RING;
+
+	mutexAcquire(&task->process->lock);
+	ring->destroyed = true;
+	mutexRelease(&task->process->lock);
+
+	mutexAcquire(&ring->lock);
+	_filesystemIoRingWakeWorker(ring);
+	waitQueueWake(&ring->waiters);
+	mutexRelease(&ring->lock);
+
+	_filesystemIoRingRelease(ring);
+	return G_IO_RING_STATUS_SUCCESSFUL;
+}
+
+void filesystemIoRingDestroyAll(g_process* process)
+{
+	g_fs_io_ring* ring = process->ioRings;
+	while(ring)
+	{
+		g_fs_io_ring* next = ring->next;
+		_filesystemIoRingFree(ring, false);
+		ring = next;
+	}
+	process->ioRings = nullptr;
+}
+
+/**
+ * Takes the next submission from the queue. Only takes it if the completion queue is
+ * guaranteed to have space for its result, counting operations that are parked.
+ */
+bool _filesystemIoRingTake(g_fs_io_ring* ring, g_io_submission* outSubmission)
+{
+	uint32_t tail = ring->header->submission.tail;
+	uint32_t available = tail - ring->submissionHead;
+	if(available == 0)
+		return false;
+
+	if(available > ring->submissionEntries)
+	{
+		logInfo("%! process %i corrupted the submission queue of ring %i", "ioring", ring->process->id, ring->id);
+		ring->submissionHead = tail;
+		ring->header->submission.head = tail;
+		return false;
+	}
+
+	if(ring->parkedCount + _filesystemIoRingCompletionCount(ring) >= ring->completionEntries)
+		return false;
+
+	asm volatile("" ::: "memory");
+	*outSubmission = ring->submissions[ring->submissionHead & (ring->submissionEntries - 1)];
+	ring->submissionHead++;
+	ring->header->submission.head = ring->submissionHead;
+	return true;
+}
+
+void _filesystemIoRingComplete(g_fs_io_ring* ring, g_io_submission* submission, g_io_status status, int64_t result)
+{
+	mutexAcquire(&ring->lock);
+
+	g_io_completion* completion = &ring->completions[ring->completionTail & (ring->completionEntries - 1)];
+	completion->user_data = submission->user_data;
+	completion->result = result;
+	completion->status = status;
+	completion->opcode = submission->opcode;
+
+	// The entry must be written before the process sees the new tail
+	asm volatile("" ::: "memory");
+	ring->completionTail++;
+	ring->header->completion.tail = ring->completionTail;
+
+	if(ring->wakeThreshold && _filesystemIoRingCompletionCount(ring) >= ring->wakeThreshold)
+	{
+		ring->wakeThreshold = 0;
+		waitQueueWake(&ring->waiters);
+	}
+
+	mutexRelease(&ring->lock);
+}
+
+void _filesystemIoRingPark(g_fs_io_ring* ring, g_io_submission* submission, uint64_t wakeTime)
+{
+	g_fs_io_ring_operation* operation = (g_fs_io_ring_operation*) heapAllocate(sizeof(g_fs_io_ring_operation));
+	operation->submission = *submission;
+	operation->wakeTime = wakeTime;
+	operation->next = nullptr;
+
+	// Append to keep the order of operations on the same node
+	g_fs_io_ring_operation** link = &ring->parked;
+	while(*link)
+		link = &(*link)->next;
+	*link = operation;
+	ring->parkedCount++;
+}
+
+/**
+ * Executes a read or write. Returns false if the node is blocking and not ready, in
+ * which case the worker was registered to wait for the node.
+ */
+bool _filesystemIoRingTransfer(g_fs_io_ring* ring, g_task* task, g_io_submission* submission, g_io_status* outStatus, int64_t* outResult)
+{
+	g_address buffer = (g_address) submission->buffer;
+	if(buffer + submission->length < buffer || buffer + submission->length > G_KERNEL_AREA_START)
+	{
+		*outStatus = G_IO_STATUS_ERROR;
+		return true;
+	}
+
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(ring->process->id, submission->fd);
+	g_fs_node* node = descriptor ? filesystemGetNode(descriptor->nodeId) : nullptr;
+	if(!node)
+	{
+		*outStatus = G_IO_STATUS_INVALID_FD;
+		return true;
+	}
+
+	bool positional = submission->offset != G_IO_OFFSET_CURRENT;
+	if(positional && node->type == G_FS_NODE_TYPE_PIPE)
+	{
+		*outStatus = G_IO_STATUS_ERROR;
+		return true;
+	}
+
+	g_fs_iovec segment;
+	segment.base = submission->buffer;
+	segment.length = submission->length;
+
+	uint64_t position = positional ? submission->offset : descriptor->offset;
+	int64_t transferred = 0;
+	bool busy;
+	bool successful;
+	if(submission->opcode == G_IO_OP_READ)
+	{
+		g_fs_read_status status = filesystemReadVector(node, &segment, 1, position, &transferred);
+		busy = status == G_FS_READ_BUSY;
+		successful = status == G_FS_READ_SUCCESSFUL;
+	}
+	else
+	{
+		if(!positional && (descriptor->openFlags & G_FILE_FLAG_MODE_APPEND) &&
+		   filesystemGetLength(node, &position) != G_FS_LENGTH_SUCCESSFUL)
+		{
+			*outStatus = G_IO_STATUS_ERROR;
+			return true;
+		}
+
+		g_fs_write_status status = filesystemWriteVector(node, &segment, 1, position, &transferred);
+		busy = status == G_FS_WRITE_BUSY;
+		successful = status == G_FS_WRITE_SUCCESSFUL;
+	}
+
+	if(busy)
+	{
+		if(!node->blocking)
+		{
+			*outStatus = G_IO_STATUS_BUSY;
+			return true;
+		}
+
+		g_fs_delegate* delegate = filesystemFindDelegate(node);
+		if(submission->opcode == G_IO_OP_READ && delegate->waitForRead)
+			delegate->waitForRead(task->id, node);
+		else if(submission->opcode == G_IO_OP_WRITE && delegate->waitForWrite)
+			delegate->waitForWrite(task->id, node);
+		return false;
+	}
+
+	if(!successful)
+	{
+		*outStatus = G_IO_STATUS_ERROR;
+		return true;
+	}
+
+	if(!positional)
+		descriptor->offset = position + transferred;
+
+	*outStatus = G_IO_STATUS_SUCCESSFUL;
+	*outResult = transferred;
+	return true;
+}
+
+/**
+ * Executes an operation. Returns false if it can not complete yet.
+ */
+bool _filesystemIoRingExecute(g_fs_io_ring* ring, g_task* task, g_io_submission* submission, g_io_status* outStatus, int64_t* outResult)
+{
+	*outResult = 0;
+
+	if(submission->opcode == G_IO_OP_NOP)
+	{
+		*outStatus = G_IO_STATUS_SUCCESSFUL;
+	}
+	else if(submission->opcode == G_IO_OP_READ || submission->opcode == G_IO_OP_WRITE)
+	{
+		return _filesystemIoRingTransfer(ring, task, submission, outStatus, outResult);
+	}
+	else if(submission->opcode == G_IO_OP_OPEN)
+	{
+		g_address path = (g_address) submission->buffer;
+		if(!path || path >= G_KERNEL_AREA_START)
+		{
+			*outStatus = G_IO_STATUS_ERROR;
+			return true;
+		}
+
+		g_fd fd;
+		g_fs_open_status open = filesystemOpen((const char*) path, submission->flags, ring->process, &fd);
+		if(open == G_FS_OPEN_SUCCESSFUL)
+		{
+			*outStatus = G_IO_STATUS_SUCCESSFUL;
+			*outResult = fd;
+		}
+		else if(open == G_FS_OPEN_NOT_FOUND)
+		{
+			*outStatus = G_IO_STATUS_NOT_FOUND;
+		}
+		else
+		{
+			*outStatus = G_IO_STATUS_ERROR;
+		}
+	}
+	else if(submission->opcode == G_IO_OP_CLOSE)
+	{
+		g_fs_close_status close = filesystemClose(ring->process->id, submission->fd, true);
+		if(close == G_FS_CLOSE_SUCCESSFUL)
+			*outStatus = G_IO_STATUS_SUCCESSFUL;
+		else if(close == G_FS_CLOSE_INVALID_FD)
+			*outStatus = G_IO_STATUS_INVALID_FD;
+		else
+			*outStatus = G_IO_STATUS_ERROR;
+	}
+	else
+	{
+		*outStatus = G_IO_STATUS_INVALID_OP;
+	}
+	return true;
+}
+
+void _filesystemIoRingStart(g_fs_io_ring* ring, g_task* task, g_io_submission* submission)
+{
+	if(submission->opcode == G_IO_OP_TIMEOUT)
+	{
+		_filesystemIoRingPark(ring, submission, clockGetLocal()->time + submission->offset);
+		return;
+	}
+
+	g_io_status status;
+	int64_t result;
+	if(_filesystemIoRingExecute(ring, task, submission, &status, &result))
+		_filesystemIoRingComplete(ring, submission, status, result);
+	else
+		_filesystemIoRingPark(ring, submission, 0);
+}
+
+void _filesystemIoRingRetryParked(g_fs_io_ring* ring, g_task* task)
+{
+	uint64_t now = clockGetLocal()->time;
+
+	g_fs_io_ring_operation* previous = nullptr;
+	g_fs_io_ring_operation* operation = ring->parked;
+	while(operation)
+	{
+		g_fs_io_ring_operation* next = operation->next;
+
+		bool done;
+		g_io_status status = G_IO_STATUS_TIMED_OUT;
+		int64_t result = 0;
+		if(operation->submission.opcode == G_IO_OP_TIMEOUT)
+			done = now >= operation->wakeTime;
+		else
+			done = _filesystemIoRingExecute(ring, task, &operation->submission, &status, &result);
+
+		if(done)
+		{
+			_filesystemIoRingComplete(ring, &operation->submission, status, result);
+			if(previous)
+				previous->next = next;
+			else
+				ring->parked = next;
+			ring->parkedCount--;
+			heapFree(operation);
+		}
+		else
+		{
+			previous = operation;
+		}
+		operation = next;
+	}
+}
+
+/**
+ * Returns the time at which the worker must look at its parked operations again,
+ * or 0 if there are none.
+ */
+uint64_t _filesystemIoRingNextWakeTime(g_fs_io_ring* ring)
+{
+	uint64_t wakeTime = 0;
+	for(g_fs_io_ring_operation* operation = ring->parked; operation; operation = operation->next)
+	{
+		uint64_t operationWakeTime = operation->submission.opcode == G_IO_OP_TIMEOUT
+										 ? operation->wakeTime
+										 : clockGetLocal()->time + G_IO_RING_PARKED_POLL_INTERVAL;
+		if(wakeTime == 0 || operationWakeTime < wakeTime)
+			wakeTime = operationWakeTime;
+	}
+	return wakeTime;
+}
+
+void filesystemIoRingWorker()
+{
+	g_task* task = taskingGetCurrentTask();
+
+	g_fs_io_ring* ring = nullptr;
+	mutexAcquire(&task->process->lock);
+	for(g_fs_io_ring* candidate = task->process->ioRings; candidate; candidate = candidate->next)
+	{
+		if(candidate->worker == task->id)
+		{
+			ring = candidate;
+			break;
+		}
+	}
+	mutexRelease(&task->process->lock);
+
+	if(!ring)
+	{
+		logInfo("%! worker %i found no ring", "ioring", task->id);
+		taskingExit();
+	}
+
+	for(;;)
+	{
+		mutexAcquire(&ring->lock);
+		if(ring->destroyed)
+		{
+			mutexRelease(&ring->lock);
+			break;
+		}
+		ring->submitted = false;
+		mutexRelease(&ring->lock);
+
+		// Operations are executed without holding the lock, as they may block or fault on user buffers
+		_filesystemIoRingRetryParked(ring, task);
+		for(;;)
+		{
+			mutexAcquire(&ring->lock);
+			g_io_submission submission;
+			bool taken = !ring->destroyed && _filesystemIoRingTake(ring, &submission);
+			mutexRelease(&ring->lock);
+
+			if(!taken)
+				break;
+			_filesystemIoRingStart(ring, task, &submission);
+		}
+
+		// Sleep until new submissions arrive, a blocking node is ready or a timeout elapses
+		mutexAcquire(&ring->lock);
+		if(!ring->submitted && !ring->destroyed)
+		{
+			uint64_t wakeTime = _filesystemIoRingNextWakeTime(ring);
+			if(wakeTime)
+				clockWaitForTime(task->id, wakeTime);
+			task->status = G_THREAD_STATUS_WAITING;
+		}
+		mutexRelease(&ring->lock);
+
+		taskingYield();
+		clockUnwaitForTime(task->id);
+	}
+
+	_filesystemIoRingRelease(ring);
+	taskingExit();
+}
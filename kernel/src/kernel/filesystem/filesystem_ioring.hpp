@@ -0,0 +1,134 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_FILESYSTEM_IORING__
+#define __KERNEL_FILESYSTEM_IORING__
+
+#include "ghost/ioring.h"
+#include "kernel/tasking/tasking.hpp"
+#include "kernel/utils/wait_queue.hpp"
+#include "shared/system/mutex.hpp"
+
+/**
+ * Size reserved for the header at the start of the ring memory.
+ */
+#define G_IO_RING_HEADER_SIZE 64
+
+/**
+ * Interval in milliseconds in which operations that wait for a blocking node are
+ * retried, in case their wake-up was missed.
+ */
+#define G_IO_RING_PARKED_POLL_INTERVAL 50
+
+/**
+ * An operation that could not complete immediately, either because it waits
+ * for a blocking node or for its timeout to elapse.
+ */
+struct g_fs_io_ring_operation
+{
+	g_io_submission submission;
+	uint64_t wakeTime;
+	g_fs_io_ring_operation* next;
+};
+
+/**
+ * Kernel side of an asynchronous I/O ring. The queue indices that the kernel owns
+ * are kept here so that the process can not corrupt them.
+ */
+struct g_fs_io_ring
+{
+	g_io_ring_id id;
+	g_mutex lock;
+
+	g_process* process;
+	g_tid worker;
+
+	/**
+	 * References are held by the worker and by tasks that are inside a ring call.
+	 * Guarded by the process lock, like the destroyed flag and the list link.
+	 */
+	int references;
+	bool destroyed;
+	g_fs_io_ring* next;
+
+	/**
+	 * Set when new submissions were announced, cleared once the worker looked at them.
+	 */
+	bool submitted;
+
+	g_virtual_address kernelBase;
+	g_virtual_address userBase;
+	uint32_t pages;
+
+	g_io_ring_header* header;
+	g_io_submission* submissions;
+	g_io_completion* completions;
+	uint32_t submissionEntries;
+	uint32_t submissionHead;
+	uint32_t completionEntries;
+	uint32_t completionTail;
+
+	/**
+	 * Operations that can not complete yet. Only accessed by the worker.
+	 */
+	g_fs_io_ring_operation* parked;
+	uint32_t parkedCount;
+
+	/**
+	 * Tasks waiting for completions are woken together once the smallest number
+	 * of completions any of them waits for is available.
+	 */
+	g_wait_queue_entry* waiters;
+	uint32_t wakeThreshold;
+};
+
+/**
+ * Initializes the ring id counter.
+ */
+void filesystemIoRingInitialize();
+
+/**
+ * Creates a ring for the process of the task, maps the shared memory into the process
+ * and starts the kernel worker that executes the submissions.
+ */
+g_io_ring_status filesystemIoRingCreate(g_task* task, uint32_t entries, g_io_ring_id* outId, g_io_ring_header** outHeader);
+
+/**
+ * Notifies the worker about new submissions and optionally waits until the given number
+ * of completions is available.
+ */
+g_io_ring_status filesystemIoRingEnter(g_task* task, g_io_ring_id id, uint32_t waitFor, uint32_t timeout, uint32_t* outCompletions);
+
+/**
+ * Marks the ring as destroyed. It is freed once the worker and all waiting tasks left it.
+ */
+g_io_ring_status filesystemIoRingDestroy(g_task* task, g_io_ring_id id);
+
+/**
+ * Frees all rings of a process that is being destroyed.
+ */
+void filesystemIoRingDestroyAll(g_process* process);
+
+/**
+ * Entry of the kernel worker task of a ring.
+ */
+void filesystemIoRingWorker();
+
+#endif
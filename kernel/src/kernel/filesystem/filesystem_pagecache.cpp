@@ -0,0 +1,475 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/filesystem/filesystem_pagecache.hpp"
+#include "kernel/memory/heap.hpp"
+#include "kernel/memory/memory.hpp"
+#include "kernel/system/system.hpp"
+#include "kernel/tasking/tasking.hpp"
+#include "kernel/utils/hashmap.hpp"
+#include "shared/system/mutex.hpp"
+
+#define G_PAGE_CACHE_KEY(nodeId, index) ((((uint64_t) (nodeId)) << 32) | (index))
+
+static bool pageCacheInitialized = false;
+static g_mutex pageCacheLock;
+
+static g_hashmap<uint64_t, g_fs_cached_page*>* pageCachePages;
+static g_hashmap<g_fs_virt_id, g_fs_cached_node*>* pageCacheNodes;
+
+/**
+ * Least recently used list, head is the most recently used page.
+ */
+static g_fs_cached_page* pageCacheLruHead;
+static g_fs_cached_page* pageCacheLruTail;
+
+static g_fs_page_cache_statistics pageCacheStatistics;
+
+/**
+ * Generations are unique across nodes, so a page that was filled before the tracking
+ * of its node was dropped is not accepted by newly created tracking.
+ */
+static uint32_t pageCacheNextGeneration = 0;
+
+int _filesystemPageCacheKeyHash(uint64_t key)
+{
+	uint32_t hash = ((uint32_t) (key >> 32)) * 0x9E3779B1 ^ ((uint32_t) key);
+	return hash & 0x7FFFFFFF;
+}
+
+void filesystemPageCacheInitialize()
+{
+	mutexInitialize(&pageCacheLock);
+
+	pageCachePages = hashmapCreateNumeric<uint64_t, g_fs_cached_page*>(1024);
+	pageCachePages->keyHash = _filesystemPageCacheKeyHash;
+	pageCacheNodes = hashmapCreateNumeric<g_fs_virt_id, g_fs_cached_node*>(128);
+
+	pageCacheLruHead = nullptr;
+	pageCacheLruTail = nullptr;
+	memorySetBytes(&pageCacheStatistics, 0, sizeof(g_fs_page_cache_statistics));
+
+	pageCacheInitialized = true;
+}
+
+void _filesystemPageCacheLruUnlink(g_fs_cached_page* page)
+{
+	if(page->lruPrevious)
+		page->lruPrevious->lruNext = page->lruNext;
+	else
+		pageCacheLruHead = page->lruNext;
+
+	if(page->lruNext)
+		page->lruNext->lruPrevious = page->lruPrevious;
+	else
+		pageCacheLruTail = page->lruPrevious;
+
+	page->lruPrevious = nullptr;
+	page->lruNext = nullptr;
+}
+
+void _filesystemPageCacheLruPushFront(g_fs_cached_page* page)
+{
+	page->lruPrevious = nullptr;
+	page->lruNext = pageCacheLruHead;
+	if(pageCacheLruHead)
+		pageCacheLruHead->lruPrevious = page;
+	pageCacheLruHead = page;
+	if(!pageCacheLruTail)
+		pageCacheLruTail = page;
+}
+
+g_fs_cached_node* _filesystemPageCacheGetNode(g_fs_virt_id nodeId)
+{
+	g_fs_cached_node* cachedNode = hashmapGet<g_fs_virt_id, g_fs_cached_node*>(pageCacheNodes, nodeId, nullptr);
+	if(!cachedNode)
+	{
+		cachedNode = (g_fs_cached_node*) heapAllocateClear(sizeof(g_fs_cached_node));
+		cachedNode->generation = pageCacheNextGeneration++;
+		hashmapPut<g_fs_virt_id, g_fs_cached_node*>(pageCacheNodes, nodeId, cachedNode);
+	}
+	return cachedNode;
+}
+
+void _filesystemPageCacheFreePage(g_fs_cached_page* page)
+{
+	memoryFreeKernelRange(page->data);
+	heapFree(page);
+}
+
+/**
+ * Takes a page out of the cache. If it is still in use by a reader, it is only
+ * marked and freed once the last reference is released.
+ */
+void _filesystemPageCacheRemove(g_fs_cached_page* page)
+{
+	_filesystemPageCacheLruUnlink(page);
+	hashmapRemove<uint64_t, g_fs_cached_page*>(pageCachePages, G_PAGE_CACHE_KEY(page->nodeId, page->index));
+	pageCacheStatistics.cachedPages--;
+
+	if(page->references > 0)
+		page->invalidated = true;
+	else
+		_filesystemPageCacheFreePage(page);
+}
+
+bool _filesystemPageCacheEvictOne()
+{
+	g_fs_cached_page* page = pageCacheLruTail;
+	while(page && page->references > 0)
+		page = page->lruPrevious;
+
+	if(!page)
+		return false;
+
+	_filesystemPageCacheRemove(page);
+	pageCacheStatistics.evictions++;
+	return true;
+}
+
+bool _filesystemPageCacheIsFull()
+{
+	return pageCacheStatistics.cachedPages >= G_PAGE_CACHE_MAXIMUM_PAGES ||
+		   memoryPhysicalAllocator.freePageCount < G_PAGE_CACHE_MINIMUM_FREE_PAGES;
+}
+
+/**
+ * Allocates a new page for the cache, evicting old pages first if the cache has
+ * reached its limit. Returns null if no memory can be spared for caching.
+ */
+g_fs_cached_page* _filesystemPageCacheAllocatePage()
+{
+	mutexAcquire(&pageCacheLock);
+	while(_filesystemPageCacheIsFull() && _filesystemPageCacheEvictOne())
+		;
+	bool full = _filesystemPageCacheIsFull();
+	mutexRelease(&pageCacheLock);
+
+	if(full)
+		return nullptr;
+
+	g_physical_address physical = memoryPhysicalAllocate();
+	if(!physical)
+		return nullptr;
+
+	g_virtual_address virt = addressRangePoolAllocate(memoryVirtualRangePool, 1);
+	if(!virt)
+	{
+		memoryPhysicalFree(physical);
+		return nullptr;
+	}
+	pagingMapPage(virt, physical, DEFAULT_KERNEL_TABLE_FLAGS, DEFAULT_KERNEL_PAGE_FLAGS);
+
+	g_fs_cached_page* page = (g_fs_cached_page*) heapAllocateClear(sizeof(g_fs_cached_page));
+	page->data = virt;
+	return page;
+}
+
+/**
+ * Reads a page of the node from its delegate into a new cache page. The lock may not
+ * be held while calling this, as the delegate might take a while to respond.
+ */
+g_fs_cached_page* _filesystemPageCacheFill(g_fs_node* node, g_fs_delegate* delegate, uint32_t index, uint64_t fileLength)
+{
+	uint64_t pageStart = (uint64_t) index * G_PAGE_SIZE;
+	if(pageStart >= fileLength)
+		return nullptr;
+
+	g_fs_cached_page* page = _filesystemPageCacheAllocatePage();
+	if(!page)
+		return nullptr;
+
+	uint64_t length = fileLength - pageStart;
+	if(length > G_PAGE_SIZE)
+		length = G_PAGE_SIZE;
+
+	int64_t read;
+	if(delegate->read(node, (uint8_t*) page->data, pageStart, length, &read) != G_FS_READ_SUCCESSFUL || read <= 0)
+	{
+		_filesystemPageCacheFreePage(page);
+		return nullptr;
+	}
+
+	page->nodeId = node->id;
+	page->index = index;
+	page->validBytes = read;
+	return page;
+}
+
+/**
+ * Inserts a filled page into the cache. If another reader was faster or the node was
+ * invalidated while filling, the given page is dropped. Must be called with the lock held.
+ *
+ * @return the page that is now in the cache or null
+ */
+g_fs_cached_page* _filesystemPageCacheInsert(g_fs_cached_page* page, uint32_t generation)
+{
+	g_fs_cached_node* cachedNode = _filesystemPageCacheGetNode(page->nodeId);
+	if(cachedNode->generation != generation)
+	{
+		_filesystemPageCacheFreePage(page);
+		return nullptr;
+	}
+
+	uint64_t key = G_PAGE_CACHE_KEY(page->nodeId, page->index);
+	g_fs_cached_page* existing = hashmapGet<uint64_t, g_fs_cached_page*>(pageCachePages, key, nullptr);
+	if(existing)
+	{
+		_filesystemPageCacheFreePage(page);
+		return existing;
+	}
+
+	hashmapPut<uint64_t, g_fs_cached_page*>(pageCachePages, key, page);
+	_filesystemPageCacheLruPushFront(page);
+	pageCacheStatistics.cachedPages++;
+
+	if(page->index > cachedNode->highestIndex)
+		cachedNode->highestIndex = page->index;
+	return page;
+}
+
+/**
+ * Returns the requested page with an added reference, filling it if necessary.
+ */
+g_fs_cached_page* _filesystemPageCacheAcquire(g_fs_node* node, g_fs_delegate* delegate, uint32_t index, uint64_t fileLength)
+{
+	uint64_t expectedBytes = fileLength - (uint64_t) index * G_PAGE_SIZE;
+	if(expectedBytes > G_PAGE_SIZE)
+		expectedBytes = G_PAGE_SIZE;
+
+	mutexAcquire(&pageCacheLock);
+	g_fs_cached_page* page = hashmapGet<uint64_t, g_fs_cached_page*>(pageCachePages, G_PAGE_CACHE_KEY(node->id, index), nullptr);
+	if(page && page->validBytes != expectedBytes)
+	{
+		// File has grown behind the previously last page
+		_filesystemPageCacheRemove(page);
+		page = nullptr;
+	}
+	if(page)
+	{
+		page->references++;
+		_filesystemPageCacheLruUnlink(page);
+		_filesystemPageCacheLruPushFront(page);
+		pageCacheStatistics.hits++;
+		mutexRelease(&pageCacheLock);
+		return page;
+	}
+	pageCacheStatistics.misses++;
+	uint32_t generation = _filesystemPageCacheGetNode(node->id)->generation;
+	mutexRelease(&pageCacheLock);
+
+	page = _filesystemPageCacheFill(node, delegate, index, fileLength);
+	if(!page)
+		return nullptr;
+
+	mutexAcquire(&pageCacheLock);
+	page = _filesystemPageCacheInsert(page, generation);
+	if(page)
+		page->references++;
+	mutexRelease(&pageCacheLock);
+	return page;
+}
+
+void _filesystemPageCacheRelease(g_fs_cached_page* page)
+{
+	mutexAcquire(&pageCacheLock);
+	if(--page->references == 0 && page->invalidated)
+		_filesystemPageCacheFreePage(page);
+	mutexRelease(&pageCacheLock);
+}
+
+void _filesystemPageCachePrefetch(g_fs_node* node, g_fs_delegate* delegate, uint32_t start, uint32_t end, uint64_t fileLength)
+{
+	for(uint32_t index = start; index < end; index++)
+	{
+		mutexAcquire(&pageCacheLock);
+		bool present = hashmapGet<uint64_t, g_fs_cached_page*>(pageCachePages, G_PAGE_CACHE_KEY(node->id, index), nullptr) != nullptr;
+		uint32_t generation = _filesystemPageCacheGetNode(node->id)->generation;
+		mutexRelease(&pageCacheLock);
+
+		if(present)
+			continue;
+
+		g_fs_cached_page* page = _filesystemPageCacheFill(node, delegate, index, fileLength);
+		if(!page)
+			break;
+
+		mutexAcquire(&pageCacheLock);
+		if(_filesystemPageCacheInsert(page, generation))
+			pageCacheStatistics.readaheadPages++;
+		mutexRelease(&pageCacheLock);
+	}
+}
+
+g_fs_read_status filesystemPageCacheRead(g_fs_node* node, g_fs_delegate* delegate, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead)
+{
+	uint64_t fileLength;
+	if(!delegate->getLength || delegate->getLength(node, &fileLength) != G_FS_LENGTH_SUCCESSFUL)
+		return delegate->read(node, buffer, offset, length, outRead);
+
+	if(offset >= fileLength || length == 0)
+	{
+		*outRead = 0;
+		return G_FS_READ_SUCCESSFUL;
+	}
+	if(length > fileLength - offset)
+		length = fileLength - offset;
+
+	uint32_t firstIndex = offset / G_PAGE_SIZE;
+	uint32_t lastIndex = (offset + length - 1) / G_PAGE_SIZE;
+
+	// Detect sequential access and decide on the area to prefetch
+	uint32_t prefetchStart = 0;
+	uint32_t prefetchEnd = 0;
+
+	mutexAcquire(&pageCacheLock);
+	g_fs_cached_node* cachedNode = _filesystemPageCacheGetNode(node->id);
+	bool sequential = cachedNode->accessed ? (firstIndex == cachedNode->lastIndex || firstIndex == cachedNode->lastIndex + 1) : firstIndex == 0;
+	if(sequential)
+	{
+		if(lastIndex + 1 + cachedNode->window / 2 >= cachedNode->readaheadEnd)
+		{
+			if(cachedNode->window == 0)
+				cachedNode->window = G_PAGE_CACHE_READAHEAD_MINIMUM;
+			else if(cachedNode->window * 2 <= G_PAGE_CACHE_READAHEAD_MAXIMUM)
+				cachedNode->window *= 2;
+
+			uint32_t filePages = (fileLength + G_PAGE_SIZE - 1) / G_PAGE_SIZE;
+			prefetchStart = cachedNode->readaheadEnd > lastIndex + 1 ? cachedNode->readaheadEnd : lastIndex + 1;
+			prefetchEnd = lastIndex + 1 + cachedNode->window;
+			if(prefetchEnd > filePages)
+				prefetchEnd = filePages;
+			cachedNode->readaheadEnd = prefetchEnd;
+		}
+	}
+	else
+	{
+		cachedNode->window = 0;
+		cachedNode->readaheadEnd = 0;
+	}
+	cachedNode->accessed = true;
+	cachedNode->lastIndex = lastIndex;
+	mutexRelease(&pageCacheLock);
+
+	// Copy from the cached pages
+	uint64_t total = 0;
+	for(uint32_t index = firstIndex; index <= lastIndex && total < length; index++)
+	{
+		g_fs_cached_page* page = _filesystemPageCacheAcquire(node, delegate, index, fileLength);
+		if(!page)
+		{
+			// Not enough memory to cache, read the rest directly
+			int64_t read;
+			g_fs_read_status status = delegate->read(node, &buffer[total], offset + total, length - total, &read);
+			if(status != G_FS_READ_SUCCESSFUL && total == 0)
+				return status;
+			if(status == G_FS_READ_SUCCESSFUL && read > 0)
+				total += read;
+			break;
+		}
+
+		uint32_t pageOffset = (offset + total) % G_PAGE_SIZE;
+		if(pageOffset >= page->validBytes)
+		{
+			_filesystemPageCacheRelease(page);
+			break;
+		}
+
+		uint64_t copy = page->validBytes - pageOffset;
+		if(copy > length - total)
+			copy = length - total;
+
+		memoryCopy(&buffer[total], (uint8_t*) (page->data + pageOffset), copy);
+		total += copy;
+
+		bool partial = page->validBytes < G_PAGE_SIZE;
+		_filesystemPageCacheRelease(page);
+		if(partial)
+			break;
+	}
+
+	if(prefetchStart < prefetchEnd)
+		_filesystemPageCachePrefetch(node, delegate, prefetchStart, prefetchEnd, fileLength);
+
+	*outRead = total;
+	return G_FS_READ_SUCCESSFUL;
+}
+
+void filesystemPageCacheInvalidate(g_fs_node* node, uint64_t offset)
+{
+	mutexAcquire(&pageCacheLock);
+
+	g_fs_cached_node* cachedNode = hashmapGet<g_fs_virt_id, g_fs_cached_node*>(pageCacheNodes, node->id, nullptr);
+	if(cachedNode)
+	{
+		cachedNode->generation = pageCacheNextGeneration++;
+
+		uint32_t firstIndex = offset / G_PAGE_SIZE;
+		for(uint32_t index = firstIndex; index <= cachedNode->highestIndex; index++)
+		{
+			g_fs_cached_page* page = hashmapGet<uint64_t, g_fs_cached_page*>(pageCachePages, G_PAGE_CACHE_KEY(node->id, index), nullptr);
+			if(page)
+				_filesystemPageCacheRemove(page);
+		}
+
+		if(firstIndex == 0)
+		{
+			hashmapRemove(pageCacheNodes, node->id);
+			heapFree(cachedNode);
+		}
+		else
+		{
+			if(firstIndex <= cachedNode->highestIndex)
+				cachedNode->highestIndex = firstIndex - 1;
+			if(cachedNode->readaheadEnd > firstIndex)
+				cachedNode->readaheadEnd = firstIndex;
+		}
+	}
+
+	mutexRelease(&pageCacheLock);
+}
+
+uint32_t filesystemPageCacheReclaim(uint32_t pages)
+{
+	if(!pageCacheInitialized || !systemIsReady())
+		return 0;
+
+	// Evicting takes the cache and heap locks, so an allocation made while any lock
+	// is held (for example by the heap or a range pool) must not reclaim
+	if(taskingGetLocal()->lockCount > 0)
+		return 0;
+
+	mutexAcquire(&pageCacheLock);
+
+	uint32_t freed = 0;
+	while(freed < pages && _filesystemPageCacheEvictOne())
+		freed++;
+
+	mutexRelease(&pageCacheLock);
+	return freed;
+}
+
+g_fs_page_cache_statistics filesystemPageCacheGetStatistics()
+{
+	mutexAcquire(&pageCacheLock);
+	g_fs_page_cache_statistics statistics = pageCacheStatistics;
+	mutexRelease(&pageCacheLock);
+	return statistics;
+}
@@ -0,0 +1,126 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_FILESYSTEM_PAGECACHE__
+#define __KERNEL_FILESYSTEM_PAGECACHE__
+
+#include "ghost/fs.h"
+#include "kernel/filesystem/filesystem.hpp"
+#include "kernel/memory/paging.hpp"
+
+/**
+ * Upper limit of pages held by the cache. Also bounds the amount of kernel
+ * virtual address space that is used for cached pages.
+ */
+#define G_PAGE_CACHE_MAXIMUM_PAGES 8192
+
+/**
+ * Number of physical pages that the cache leaves free for the rest of the system.
+ * When less pages are available, least recently used pages are evicted first.
+ */
+#define G_PAGE_CACHE_MINIMUM_FREE_PAGES 1024
+
+/**
+ * Number of pages that are reclaimed at once when a physical allocation fails.
+ */
+#define G_PAGE_CACHE_RECLAIM_BATCH 64
+
+/**
+ * Readahead window bounds in pages. The window starts at the minimum once
+ * sequential access is detected and doubles on each further sequential read.
+ */
+#define G_PAGE_CACHE_READAHEAD_MINIMUM 4
+#define G_PAGE_CACHE_READAHEAD_MAXIMUM 32
+
+/**
+ * A page of file content held in the cache.
+ */
+struct g_fs_cached_page
+{
+	g_fs_virt_id nodeId;
+	uint32_t index;
+
+	g_virtual_address data;
+	uint32_t validBytes;
+
+	int references;
+	bool invalidated;
+
+	g_fs_cached_page* lruPrevious;
+	g_fs_cached_page* lruNext;
+};
+
+/**
+ * Per-node access tracking for readahead.
+ */
+struct g_fs_cached_node
+{
+	uint32_t generation;
+
+	bool accessed;
+	uint32_t lastIndex;
+	uint32_t readaheadEnd;
+	uint32_t window;
+	uint32_t highestIndex;
+};
+
+/**
+ * Counters of the page cache.
+ */
+struct g_fs_page_cache_statistics
+{
+	uint32_t cachedPages;
+	uint32_t hits;
+	uint32_t misses;
+	uint32_t readaheadPages;
+	uint32_t evictions;
+};
+
+/**
+ * Initializes the page cache.
+ */
+void filesystemPageCacheInitialize();
+
+/**
+ * Reads from a node through the page cache. Missing pages are filled by reading
+ * from the delegate, sequential access additionally prefetches following pages.
+ */
+g_fs_read_status filesystemPageCacheRead(g_fs_node* node, g_fs_delegate* delegate, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead);
+
+/**
+ * Drops all cached pages of the node that contain data at or after the offset.
+ * When dropping from the start, the readahead tracking of the node is freed too.
+ */
+void filesystemPageCacheInvalidate(g_fs_node* node, uint64_t offset = 0);
+
+/**
+ * Evicts up to the given number of unused pages from the cache to give physical
+ * memory back to the system. Does nothing if the calling processor holds any mutex.
+ *
+ * @return the number of pages that were freed
+ */
+uint32_t filesystemPageCacheReclaim(uint32_t pages);
+
+/**
+ * Returns a snapshot of the page cache counters.
+ */
+g_fs_page_cache_statistics filesystemPageCacheGetStatistics();
+
+#endif
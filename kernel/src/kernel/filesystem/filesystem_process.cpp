@@ -22,11 +22,11 @@
 #include "kernel/memory/memory.hpp"
 #include "shared/logger/logger.hpp"
 
-static g_hashmap<g_pid, g_filesystem_process*>* filesystemProcessInfo;
+static g_concurrent_hashmap<g_pid, g_filesystem_process*>* filesystemProcessInfo;
 
 void filesystemProcessInitialize()
 {
-	filesystemProcessInfo = hashmapCreateNumeric<g_pid, g_filesystem_process*>(128);
+	filesystemProcessInfo = concurrentHashmapCreate<g_pid, g_filesystem_process*>();
 }
 
 void filesystemProcessCreate(g_pid pid)
@@ -35,14 +35,14 @@ void filesystemProcessCreate(g_pid pid)
 
 	info->nextDescriptor = 3; // after stdin, stdout, stderr
 	mutexInitialize(&info->nextDescriptorLock);
-	info->descriptors = hashmapCreateNumeric<g_fd, g_file_descriptor*>(128);
+	info->descriptors = concurrentHashmapCreate<g_fd, g_file_descriptor*>();
 
-	hashmapPut(filesystemProcessInfo, pid, info);
+	concurrentHashmapPut(filesystemProcessInfo, pid, info);
 }
 
 g_fs_open_status filesystemProcessCreateDescriptor(g_pid pid, g_fs_virt_id nodeId, g_file_flag_mode flags, g_file_descriptor** outDescriptor, g_fd optionalFd)
 {
-	g_filesystem_process* info = hashmapGet<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid, 0);
+	g_filesystem_process* info = concurrentHashmapGet<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid, 0);
 	if(!info)
 	{
 		logInfo("%! tried to create file descriptor in process %i that doesn't exist", "filesystem", pid);
@@ -65,53 +65,60 @@ g_fs_open_status filesystemProcessCreateDescriptor(g_pid pid, g_fs_virt_id nodeI
 	descriptor->offset = 0;
 	descriptor->openFlags = flags;
 
-	hashmapPut<g_fd, g_file_descriptor*>(info->descriptors, descriptor->id, descriptor);
+	concurrentHashmapPut<g_fd, g_file_descriptor*>(info->descriptors, descriptor->id, descriptor);
 	*outDescriptor = descriptor;
 	return G_FS_OPEN_SUCCESSFUL;
 }
 
 g_file_descriptor* filesystemProcessGetDescriptor(g_pid pid, g_fd fd)
 {
-	g_filesystem_process* info = hashmapGet<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid, 0);
+	g_filesystem_process* info = concurrentHashmapGet<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid, 0);
 	if(!info)
 	{
 		logInfo("%! tried to create file descriptor in process %i that doesn't exist", "filesystem", pid);
 		return 0;
 	}
 
-	return hashmapGet<g_fd, g_file_descriptor*>(info->descriptors, fd, 0);
+	return concurrentHashmapGet<g_fd, g_file_descriptor*>(info->descriptors, fd, 0);
 }
 
 void filesystemProcessRemove(g_pid pid)
 {
-	g_filesystem_process* info = hashmapGet<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid, 0);
+	g_filesystem_process* info = concurrentHashmapGet<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid, 0);
 	if(!info)
 		return;
 
-	g_hashmap_iterator<g_fd, g_file_descriptor*> iter = hashmapIteratorStart<g_fd, g_file_descriptor*>(info->descriptors);
-	while(hashmapIteratorHasNext<g_fd, g_file_descriptor*>(&iter))
+	// Closing may block on a delegate, so it must not happen while the iterator
+	// holds the map lock; take one descriptor at a time instead
+	for(;;)
 	{
-		g_hashmap_entry<g_fd, g_file_descriptor*>* entry = hashmapIteratorNext<g_fd, g_file_descriptor*>(&iter);
-		filesystemClose(pid, entry->key, false);
-		heapFree(entry->value);
+		g_concurrent_hashmap_iterator<g_fd, g_file_descriptor*> iter = concurrentHashmapIteratorStart<g_fd, g_file_descriptor*>(info->descriptors);
+		bool found = concurrentHashmapIteratorHasNext<g_fd, g_file_descriptor*>(&iter);
+		g_fd fd = found ? concurrentHashmapIteratorNext<g_fd, g_file_descriptor*>(&iter)->key : G_FD_NONE;
+		concurrentHashmapIteratorEnd<g_fd, g_file_descriptor*>(&iter);
+		if(!found)
+			break;
+
+		filesystemClose(pid, fd, false);
+		filesystemProcessRemoveDescriptor(pid, fd);
 	}
-	hashmapIteratorEnd<g_fd, g_file_descriptor*>(&iter);
 
-	hashmapRemove<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid);
+	concurrentHashmapRemove<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid);
+	concurrentHashmapDestroy(info->descriptors);
 	heapFree(info);
 }
 
 void filesystemProcessRemoveDescriptor(g_pid pid, g_fd fd)
 {
-	g_filesystem_process* info = hashmapGet<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid, 0);
+	g_filesystem_process* info = concurrentHashmapGet<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid, 0);
 	if(!info)
 		return;
 
-	g_file_descriptor* descriptor = hashmapGet<g_fd, g_file_descriptor*>(info->descriptors, fd, 0);
+	g_file_descriptor* descriptor = concurrentHashmapGet<g_fd, g_file_descriptor*>(info->descriptors, fd, 0);
 	if(!descriptor)
 		return;
 
-	hashmapRemove(info->descriptors, fd);
+	concurrentHashmapRemove(info->descriptors, fd);
 	heapFree(descriptor);
 }
 
@@ -24,7 +24,7 @@
 #include "ghost/fs.h"
 #include "ghost/kernel.h"
 #include "kernel/filesystem/filesystem.hpp"
-#include "kernel/utils/hashmap.hpp"
+#include "kernel/utils/concurrent_hashmap.hpp"
 
 /**
  * Structure of a file descriptor.
@@ -44,7 +44,7 @@ struct g_filesystem_process
 {
 	g_fd nextDescriptor;
 	g_mutex nextDescriptorLock;
-	g_hashmap<g_fd, g_file_descriptor*>* descriptors;
+	g_concurrent_hashmap<g_fd, g_file_descriptor*>* descriptors;
 };
 
 /**
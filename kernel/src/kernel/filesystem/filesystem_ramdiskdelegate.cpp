@@ -72,6 +72,12 @@ g_fs_read_status filesystemRamdiskDelegateRead(g_fs_node* node, uint8_t* buffer,
 	if(!entry)
 		return G_FS_READ_ERROR;
 
+	if(offset >= entry->dataSize)
+	{
+		*outRead = 0;
+		return G_FS_READ_SUCCESSFUL;
+	}
+
 	if(offset + length > entry->dataSize)
 		length = entry->dataSize - offset;
 
@@ -80,12 +86,12 @@ g_fs_read_status filesystemRamdiskDelegateRead(g_fs_node* node, uint8_t* buffer,
 	return G_FS_READ_SUCCESSFUL;
 }
 
-g_fs_write_status filesystemRamdiskDelegateWrite(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote)
+/**
+ * Prepares the entry for writing the given range. Moves the content off the ramdisk
+ * memory if necessary, grows the buffer and zero-fills a gap behind the current end.
+ */
+void _filesystemRamdiskDelegatePrepareWrite(g_ramdisk_entry* entry, uint64_t offset, uint64_t length)
 {
-	g_ramdisk_entry* entry = ramdiskFindById(node->physicalId);
-	if(!entry)
-		return G_FS_WRITE_ERROR;
-
 	// copy data from ramdisk memory into variable memory
 	if(entry->dataOnRamdisk)
 	{
@@ -105,10 +111,9 @@ g_fs_write_status filesystemRamdiskDelegateWrite(g_fs_node* node, uint8_t* buffe
 	entry->dataOnRamdisk = false;
 
 	// expand buffer until enough space is available
-	uint32_t space;
-	while((space = entry->notOnRdBufferLength - offset) < length)
+	while(entry->notOnRdBufferLength < offset + length)
 	{
-		uint32_t buflen = entry->notOnRdBufferLength * 1.2;
+		uint32_t buflen = entry->notOnRdBufferLength * 1.2 + 32;
 		uint8_t* new_buffer = new uint8_t[buflen];
 		memoryCopy(new_buffer, entry->data, entry->dataSize);
 		heapFree(entry->data);
@@ -116,9 +121,47 @@ g_fs_write_status filesystemRamdiskDelegateWrite(g_fs_node* node, uint8_t* buffe
 		entry->notOnRdBufferLength = buflen;
 	}
 
-	// copy data
+	// fill a gap behind the current end with zeros
+	if(offset > entry->dataSize)
+		memorySetBytes(&entry->data[entry->dataSize], 0, offset - entry->dataSize);
+
+	// writing within the file must not shorten it
+	if(offset + length > entry->dataSize)
+		entry->dataSize = offset + length;
+}
+
+g_fs_write_status filesystemRamdiskDelegateWrite(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote)
+{
+	g_ramdisk_entry* entry = ramdiskFindById(node->physicalId);
+	if(!entry)
+		return G_FS_WRITE_ERROR;
+
+	_filesystemRamdiskDelegatePrepareWrite(entry, offset, length);
 	memoryCopy(&entry->data[offset], buffer, length);
-	entry->dataSize = offset + length;
+	*outWrote = length;
+
+	return G_FS_WRITE_SUCCESSFUL;
+}
+
+g_fs_write_status filesystemRamdiskDelegateWriteVector(g_fs_node* node, g_fs_iovec* vector, int count, uint64_t offset, int64_t* outWrote)
+{
+	g_ramdisk_entry* entry = ramdiskFindById(node->physicalId);
+	if(!entry)
+		return G_FS_WRITE_ERROR;
+
+	uint64_t length = 0;
+	for(int i = 0; i < count; i++)
+		length += vector[i].length;
+
+	// grow once for the whole vector, then copy the segments
+	_filesystemRamdiskDelegatePrepareWrite(entry, offset, length);
+
+	uint8_t* target = &entry->data[offset];
+	for(int i = 0; i < count; i++)
+	{
+		memoryCopy(target, vector[i].base, vector[i].length);
+		target += vector[i].length;
+	}
 	*outWrote = length;
 
 	return G_FS_WRITE_SUCCESSFUL;
@@ -178,6 +221,8 @@ g_fs_directory_refresh_status filesystemRamdiskDelegateRefreshDir(g_fs_node* dir
 	for(uint32_t i = 0; i < childCount; i++)
 	{
 		auto childEntry = ramdiskGetChildAt(dirEntry->id, i);
+		if(!childEntry)
+			break;
 
 		if(!filesystemFindExistingChild(dir, childEntry->name))
 		{
@@ -189,4 +234,15 @@ g_fs_directory_refresh_status filesystemRamdiskDelegateRefreshDir(g_fs_node* dir
 	}
 
 	return G_FS_DIRECTORY_REFRESH_SUCCESSFUL;
-}
\ No newline at end of file
+}
+
+void filesystemRamdiskDelegateUnlink(g_fs_node* file)
+{
+	// the entry must not be discovered again under its old name
+	ramdiskDetach(file->physicalId);
+}
+
+void filesystemRamdiskDelegateRemove(g_fs_node* file)
+{
+	ramdiskRemove(file->physicalId);
+}
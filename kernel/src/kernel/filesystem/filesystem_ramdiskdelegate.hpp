@@ -35,6 +35,8 @@ g_fs_read_status filesystemRamdiskDelegateRead(g_fs_node* node, uint8_t* buffer,
 
 g_fs_write_status filesystemRamdiskDelegateWrite(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote);
 
+g_fs_write_status filesystemRamdiskDelegateWriteVector(g_fs_node* node, g_fs_iovec* vector, int count, uint64_t offset, int64_t* outWrote);
+
 g_fs_length_status filesystemRamdiskDelegateGetLength(g_fs_node* node, uint64_t* outLength);
 
 g_fs_open_status filesystemRamdiskDelegateCreate(g_fs_node* parent, const char* name, g_fs_node** outFile);
@@ -43,4 +45,8 @@ g_fs_open_status filesystemRamdiskDelegateTruncate(g_fs_node* file);
 
 g_fs_directory_refresh_status filesystemRamdiskDelegateRefreshDir(g_fs_node* dir);
 
+void filesystemRamdiskDelegateUnlink(g_fs_node* file);
+
+void filesystemRamdiskDelegateRemove(g_fs_node* file);
+
 #endif
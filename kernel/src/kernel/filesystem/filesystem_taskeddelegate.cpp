@@ -0,0 +1,558 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/filesystem/filesystem_taskeddelegate.hpp"
+#include "kernel/ipc/message.hpp"
+#include "kernel/memory/heap.hpp"
+#include "kernel/memory/memory.hpp"
+#include "shared/logger/logger.hpp"
+#include "shared/utils/string.hpp"
+
+static g_mutex taskedDelegatesLock;
+static g_fs_tasked_delegate* taskedDelegates;
+
+#define G_FS_TASKED_DELEGATE_BUFFER_SIZE (G_FS_TASKED_DELEGATE_BUFFER_PAGES * G_PAGE_SIZE)
+
+void filesystemTaskedDelegateInitialize()
+{
+	mutexInitialize(&taskedDelegatesLock);
+	taskedDelegates = nullptr;
+}
+
+/**
+ * Releases a delegate that was reserved for being taken over, when the takeover failed.
+ */
+void _filesystemTaskedDelegateReleaseTakeover(g_fs_tasked_delegate* previous)
+{
+	if(!previous)
+		return;
+
+	mutexAcquire(&previous->lock);
+	previous->busy = false;
+	mutexRelease(&previous->lock);
+}
+
+g_fs_register_as_delegate_status filesystemTaskedDelegateRegister(g_task* task, const char* name, g_fs_phys_id physMountpointId,
+																  g_fs_virt_id* outMountpointId, g_address* outTransactionStorage)
+{
+	// The mountpoint of a delegate whose process has exited can be taken over
+	g_fs_node* mountFolder = filesystemGetMountFolder();
+	g_fs_node* mountpoint;
+	g_fs_tasked_delegate* previous = nullptr;
+	if(filesystemFindExistingChild(mountFolder, name, &mountpoint))
+	{
+		g_fs_delegate* existing = mountpoint->delegate;
+		if(!existing || existing->discover != filesystemTaskedDelegateDiscover)
+			return G_FS_REGISTER_AS_DELEGATE_FAILED_EXISTING;
+
+		// Nodes below the mountpoint refer to the previous delegate, so it is reused. Its buffer
+		// was freed once its last transaction ended. Until it is set up again it stays busy.
+		previous = (g_fs_tasked_delegate*) existing->data;
+		mutexAcquire(&previous->lock);
+		bool available = previous->destroyed && !previous->busy;
+		if(available)
+			previous->busy = true;
+		mutexRelease(&previous->lock);
+
+		if(!available)
+			return G_FS_REGISTER_AS_DELEGATE_FAILED_EXISTING;
+	}
+	else
+	{
+		mountpoint = nullptr;
+	}
+
+	uint32_t pages = 1 + G_FS_TASKED_DELEGATE_BUFFER_PAGES;
+	g_virtual_address kernelBase = memoryAllocateKernelRange(pages);
+	if(!kernelBase)
+	{
+		_filesystemTaskedDelegateReleaseTakeover(previous);
+		return G_FS_REGISTER_AS_DELEGATE_FAILED_DELEGATE_CREATION;
+	}
+	memorySetBytes((void*) kernelBase, 0, pages * G_PAGE_SIZE);
+
+	g_virtual_address userBase = memoryShareKernelRange(task->process, kernelBase, pages);
+	if(!userBase)
+	{
+		memoryFreeKernelRange(kernelBase);
+		_filesystemTaskedDelegateReleaseTakeover(previous);
+		return G_FS_REGISTER_AS_DELEGATE_FAILED_DELEGATE_CREATION;
+	}
+
+	if(previous)
+	{
+		mutexAcquire(&previous->lock);
+		previous->task = task->id;
+		previous->process = task->process;
+		previous->kernelBase = kernelBase;
+		previous->userBase = userBase;
+		previous->destroyed = false;
+		previous->busy = false;
+		waitQueueWake(&previous->waitersTransaction);
+		mutexRelease(&previous->lock);
+
+		mountpoint->physicalId = physMountpointId;
+		mountpoint->upToDate = false;
+
+		*outMountpointId = mountpoint->id;
+		*outTransactionStorage = userBase;
+		return G_FS_REGISTER_AS_DELEGATE_SUCCESSFUL;
+	}
+
+	g_fs_tasked_delegate* tasked = (g_fs_tasked_delegate*) heapAllocateClear(sizeof(g_fs_tasked_delegate));
+	mutexInitialize(&tasked->lock);
+	tasked->task = task->id;
+	tasked->process = task->process;
+	tasked->kernelBase = kernelBase;
+	tasked->userBase = userBase;
+
+	g_fs_delegate* delegate = filesystemCreateDelegate();
+	delegate->data = tasked;
+	delegate->discover = filesystemTaskedDelegateDiscover;
+	delegate->open = filesystemTaskedDelegateOpen;
+	delegate->read = filesystemTaskedDelegateRead;
+	delegate->write = filesystemTaskedDelegateWrite;
+	delegate->getLength = filesystemTaskedDelegateGetLength;
+	delegate->refreshDir = filesystemTaskedDelegateRefreshDir;
+	delegate->close = filesystemTaskedDelegateClose;
+
+	mountpoint = filesystemCreateNode(G_FS_NODE_TYPE_MOUNTPOINT, name);
+	mountpoint->physicalId = physMountpointId;
+	mountpoint->delegate = delegate;
+	filesystemAddChild(mountFolder, mountpoint);
+	tasked->mountpoint = mountpoint;
+
+	mutexAcquire(&taskedDelegatesLock);
+	tasked->next = taskedDelegates;
+	taskedDelegates = tasked;
+	mutexRelease(&taskedDelegatesLock);
+
+	*outMountpointId = mountpoint->id;
+	*outTransactionStorage = userBase;
+	return G_FS_REGISTER_AS_DELEGATE_SUCCESSFUL;
+}
+
+void _filesystemTaskedDelegateWakeTask(g_tid id)
+{
+	g_task* task = taskingGetById(id);
+	if(task && task->status == G_THREAD_STATUS_WAITING)
+		task->status = G_THREAD_STATUS_RUNNING;
+}
+
+void filesystemTaskedDelegateSetTransactionStatus(g_task* task, g_fs_transaction_id id, g_fs_transaction_status status)
+{
+	if(status == G_FS_TRANSACTION_WAITING)
+		return;
+
+	mutexAcquire(&taskedDelegatesLock);
+	for(g_fs_tasked_delegate* tasked = taskedDelegates; tasked; tasked = tasked->next)
+	{
+		if(tasked->process != task->process)
+			continue;
+
+		mutexAcquire(&tasked->lock);
+		if(tasked->busy && tasked->transaction == id && tasked->transactionStatus == G_FS_TRANSACTION_WAITING)
+		{
+			tasked->transactionStatus = status;
+			_filesystemTaskedDelegateWakeTask(tasked->transactionTask);
+		}
+		mutexRelease(&tasked->lock);
+	}
+	mutexRelease(&taskedDelegatesLock);
+}
+
+g_fs_create_node_status filesystemTaskedDelegateCreateNode(g_task* task, g_fs_virt_id parentId, const char* name, g_fs_node_type type,
+														   g_fs_phys_id physId, g_fs_virt_id* outCreatedId)
+{
+	g_fs_node* parent = filesystemGetNode(parentId);
+	if(!parent)
+		return G_FS_CREATE_NODE_STATUS_FAILED_NO_PARENT;
+
+	// Only allowed within the tree of a delegate of the same process
+	g_fs_delegate* delegate = filesystemFindDelegate(parent);
+	g_fs_tasked_delegate* tasked = (g_fs_tasked_delegate*) delegate->data;
+	if(delegate->discover != filesystemTaskedDelegateDiscover || tasked->process != task->process)
+		return G_FS_CREATE_NODE_STATUS_FAILED_NO_PARENT;
+
+	if(stringEquals(name, ".") || stringEquals(name, "..") || stringIndexOf(name, '/') != -1)
+		return G_FS_CREATE_NODE_STATUS_FAILED_NO_PARENT;
+
+	g_fs_node* child;
+	if(filesystemFindExistingChild(parent, name, &child))
+	{
+		child->type = type;
+		child->physicalId = physId;
+		*outCreatedId = child->id;
+		return G_FS_CREATE_NODE_STATUS_UPDATED;
+	}
+
+	child = filesystemCreateNode(type, name);
+	child->physicalId = physId;
+	filesystemAddChild(parent, child);
+	*outCreatedId = child->id;
+	return G_FS_CREATE_NODE_STATUS_CREATED;
+}
+
+void filesystemTaskedDelegateProcessRemoved(g_process* process)
+{
+	mutexAcquire(&taskedDelegatesLock);
+	for(g_fs_tasked_delegate* tasked = taskedDelegates; tasked; tasked = tasked->next)
+	{
+		if(tasked->process != process)
+			continue;
+
+		// The mapping in the process is gone with its address space
+		mutexAcquire(&tasked->lock);
+		tasked->destroyed = true;
+		tasked->process = nullptr;
+		if(tasked->busy)
+			_filesystemTaskedDelegateWakeTask(tasked->transactionTask);
+		else
+			memoryFreeKernelRange(tasked->kernelBase);
+		waitQueueWake(&tasked->waitersTransaction);
+		mutexRelease(&tasked->lock);
+	}
+	mutexRelease(&taskedDelegatesLock);
+}
+
+g_fs_tasked_delegate* _filesystemTaskedDelegateGet(g_fs_node* node)
+{
+	return (g_fs_tasked_delegate*) filesystemFindDelegate(node)->data;
+}
+
+g_fs_tasked_delegate_transaction_storage* _filesystemTaskedDelegateStorage(g_fs_tasked_delegate* tasked)
+{
+	return (g_fs_tasked_delegate_transaction_storage*) tasked->kernelBase;
+}
+
+/**
+ * Waits until the transaction storage is free and reserves it for the task.
+ */
+bool _filesystemTaskedDelegateBegin(g_fs_tasked_delegate* tasked, g_task* task)
+{
+	for(;;)
+	{
+		mutexAcquire(&tasked->lock);
+		if(tasked->destroyed)
+		{
+			mutexRelease(&tasked->lock);
+			return false;
+		}
+
+		if(!tasked->busy)
+		{
+			tasked->busy = true;
+			tasked->transactionTask = task->id;
+			mutexRelease(&tasked->lock);
+			return true;
+		}
+
+		waitQueueAdd(&tasked->waitersTransaction, task->id);
+		task->status = G_THREAD_STATUS_WAITING;
+		mutexRelease(&tasked->lock);
+		taskingYield();
+	}
+}
+
+void _filesystemTaskedDelegateEnd(g_fs_tasked_delegate* tasked)
+{
+	mutexAcquire(&tasked->lock);
+	tasked->busy = false;
+	if(tasked->destroyed)
+		memoryFreeKernelRange(tasked->kernelBase);
+	else
+		waitQueueWake(&tasked->waitersTransaction);
+	mutexRelease(&tasked->lock);
+}
+
+/**
+ * Sends the request that was prepared in the transaction storage to the delegate task
+ * and waits until the delegate has finished it.
+ */
+bool _filesystemTaskedDelegateRequest(g_fs_tasked_delegate* tasked, g_task* task, g_fs_tasked_delegate_request_type type)
+{
+	g_fs_tasked_delegate_request request;
+	request.type = type;
+
+	for(;;)
+	{
+		mutexAcquire(&tasked->lock);
+		request.transaction = ++tasked->transaction;
+		tasked->transactionStatus = G_FS_TRANSACTION_WAITING;
+		mutexRelease(&tasked->lock);
+
+		if(!taskingGetById(tasked->task) ||
+		   messageSend(task->id, tasked->task, &request, sizeof(request), G_MESSAGE_TRANSACTION_NONE) != G_MESSAGE_SEND_STATUS_SUCCESSFUL)
+		{
+			logInfo("%! failed to send request to delegate task %i", "fs", tasked->task);
+			return false;
+		}
+
+		g_fs_transaction_status status;
+		for(;;)
+		{
+			mutexAcquire(&tasked->lock);
+			status = tasked->transactionStatus;
+			if(status != G_FS_TRANSACTION_WAITING || tasked->destroyed)
+			{
+				mutexRelease(&tasked->lock);
+				break;
+			}
+
+			task->status = G_THREAD_STATUS_WAITING;
+			mutexRelease(&tasked->lock);
+			taskingYield();
+		}
+
+		if(tasked->destroyed)
+			return false;
+		if(status != G_FS_TRANSACTION_REPEAT)
+			return true;
+	}
+}
+
+g_fs_open_status filesystemTaskedDelegateDiscover(g_fs_node* parent, const char* name, g_fs_node** outChild)
+{
+	g_task* task = taskingGetCurrentTask();
+	g_fs_tasked_delegate* tasked = _filesystemTaskedDelegateGet(parent);
+	if(stringLength(name) >= G_FILENAME_MAX)
+		return G_FS_OPEN_NOT_FOUND;
+
+	if(!_filesystemTaskedDelegateBegin(tasked, task))
+		return G_FS_OPEN_ERROR;
+
+	g_fs_tasked_delegate_transaction_storage_discovery* discovery = &_filesystemTaskedDelegateStorage(tasked)->discovery;
+	discovery->parent_phys_fs_id = parent->physicalId;
+	discovery->parent_virt_fs_id = parent->id;
+	stringCopy(discovery->name, name);
+	discovery->result_status = G_FS_DISCOVERY_ERROR;
+
+	g_fs_open_status status = G_FS_OPEN_ERROR;
+	if(_filesystemTaskedDelegateRequest(tasked, task, G_FS_TASKED_DELEGATE_REQUEST_TYPE_DISCOVER))
+	{
+		// The delegate creates the node while handling the request
+		if(discovery->result_status == G_FS_DISCOVERY_SUCCESSFUL)
+			status = filesystemFindExistingChild(parent, name, outChild) ? G_FS_OPEN_SUCCESSFUL : G_FS_OPEN_NOT_FOUND;
+		else if(discovery->result_status == G_FS_DISCOVERY_NOT_FOUND)
+			status = G_FS_OPEN_NOT_FOUND;
+	}
+
+	_filesystemTaskedDelegateEnd(tasked);
+	return status;
+}
+
+g_fs_open_status filesystemTaskedDelegateOpen(g_fs_node* node, g_file_flag_mode flags)
+{
+	g_task* task = taskingGetCurrentTask();
+	g_fs_tasked_delegate* tasked = _filesystemTaskedDelegateGet(node);
+	if(!_filesystemTaskedDelegateBegin(tasked, task))
+		return G_FS_OPEN_ERROR;
+
+	g_fs_tasked_delegate_transaction_storage_open* open = &_filesystemTaskedDelegateStorage(tasked)->open;
+	open->phys_fs_id = node->physicalId;
+	stringCopy(open->name, node->name);
+	open->flags = flags;
+	open->result_status = G_FS_OPEN_ERROR;
+
+	g_fs_open_status status = G_FS_OPEN_ERROR;
+	if(_filesystemTaskedDelegateRequest(tasked, task, G_FS_TASKED_DELEGATE_REQUEST_TYPE_OPEN))
+		status = open->result_status;
+
+	_filesystemTaskedDelegateEnd(tasked);
+	return status;
+}
+
+g_fs_read_status filesystemTaskedDelegateRead(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead)
+{
+	g_task* task = taskingGetCurrentTask();
+	g_fs_tasked_delegate* tasked = _filesystemTaskedDelegateGet(node);
+	if(!_filesystemTaskedDelegateBegin(tasked, task))
+		return G_FS_READ_ERROR;
+
+	g_fs_tasked_delegate_transaction_storage_read* read = &_filesystemTaskedDelegateStorage(tasked)->read;
+	uint8_t* data = (uint8_t*) (tasked->kernelBase + G_PAGE_SIZE);
+
+	// Larger reads are split, a short read from the delegate ends the transfer
+	g_fs_read_status status = G_FS_READ_SUCCESSFUL;
+	uint64_t total = 0;
+	while(total < length)
+	{
+		uint64_t chunk = length - total;
+		if(chunk > G_FS_TASKED_DELEGATE_BUFFER_SIZE)
+			chunk = G_FS_TASKED_DELEGATE_BUFFER_SIZE;
+
+		read->phys_fs_id = node->physicalId;
+		read->mapped_buffer = (void*) (tasked->userBase + G_PAGE_SIZE);
+		read->offset = offset + total;
+		read->length = chunk;
+		read->mapping_start = tasked->userBase + G_PAGE_SIZE;
+		read->mapping_pages = G_FS_TASKED_DELEGATE_BUFFER_PAGES;
+		read->result_read = 0;
+		read->result_status = G_FS_READ_ERROR;
+
+		if(!_filesystemTaskedDelegateRequest(tasked, task, G_FS_TASKED_DELEGATE_REQUEST_TYPE_READ))
+		{
+			status = G_FS_READ_ERROR;
+			break;
+		}
+
+		status = read->result_status;
+		int64_t result = read->result_read;
+		if(status != G_FS_READ_SUCCESSFUL)
+			break;
+		if(result < 0 || (uint64_t) result > chunk)
+		{
+			status = G_FS_READ_ERROR;
+			break;
+		}
+
+		memoryCopy(buffer + total, data, result);
+		total += result;
+		if((uint64_t) result < chunk)
+			break;
+	}
+
+	_filesystemTaskedDelegateEnd(tasked);
+
+	if(total > 0)
+		status = G_FS_READ_SUCCESSFUL;
+	*outRead = total;
+	return status;
+}
+
+g_fs_write_status filesystemTaskedDelegateWrite(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote)
+{
+	g_task* task = taskingGetCurrentTask();
+	g_fs_tasked_delegate* tasked = _filesystemTaskedDelegateGet(node);
+	if(!_filesystemTaskedDelegateBegin(tasked, task))
+		return G_FS_WRITE_ERROR;
+
+	g_fs_tasked_delegate_transaction_storage_write* write = &_filesystemTaskedDelegateStorage(tasked)->write;
+	uint8_t* data = (uint8_t*) (tasked->kernelBase + G_PAGE_SIZE);
+
+	g_fs_write_status status = G_FS_WRITE_SUCCESSFUL;
+	uint64_t total = 0;
+	while(total < length)
+	{
+		uint64_t chunk = length - total;
+		if(chunk > G_FS_TASKED_DELEGATE_BUFFER_SIZE)
+			chunk = G_FS_TASKED_DELEGATE_BUFFER_SIZE;
+
+		memoryCopy(data, buffer + total, chunk);
+		write->phys_fs_id = node->physicalId;
+		write->mapped_buffer = (void*) (tasked->userBase + G_PAGE_SIZE);
+		write->offset = offset + total;
+		write->length = chunk;
+		write->mapping_start = tasked->userBase + G_PAGE_SIZE;
+		write->mapping_pages = G_FS_TASKED_DELEGATE_BUFFER_PAGES;
+		write->result_write = 0;
+		write->result_status = G_FS_WRITE_ERROR;
+
+		if(!_filesystemTaskedDelegateRequest(tasked, task, G_FS_TASKED_DELEGATE_REQUEST_TYPE_WRITE))
+		{
+			status = G_FS_WRITE_ERROR;
+			break;
+		}
+
+		status = write->result_status;
+		int64_t result = write->result_write;
+		if(status != G_FS_WRITE_SUCCESSFUL)
+			break;
+		if(result < 0 || (uint64_t) result > chunk)
+		{
+			status = G_FS_WRITE_ERROR;
+			break;
+		}
+
+		total += result;
+		if((uint64_t) result < chunk)
+			break;
+	}
+
+	_filesystemTaskedDelegateEnd(tasked);
+
+	if(total > 0)
+		status = G_FS_WRITE_SUCCESSFUL;
+	*outWrote = total;
+	return status;
+}
+
+g_fs_length_status filesystemTaskedDelegateGetLength(g_fs_node* node, uint64_t* outLength)
+{
+	g_task* task = taskingGetCurrentTask();
+	g_fs_tasked_delegate* tasked = _filesystemTaskedDelegateGet(node);
+	if(!_filesystemTaskedDelegateBegin(tasked, task))
+		return G_FS_LENGTH_ERROR;
+
+	g_fs_tasked_delegate_transaction_storage_get_length* getLength = &_filesystemTaskedDelegateStorage(tasked)->get_length;
+	getLength->phys_fs_id = node->physicalId;
+	getLength->result_length = 0;
+	getLength->result_status = G_FS_LENGTH_ERROR;
+
+	g_fs_length_status status = G_FS_LENGTH_ERROR;
+	if(_filesystemTaskedDelegateRequest(tasked, task, G_FS_TASKED_DELEGATE_REQUEST_TYPE_GET_LENGTH))
+	{
+		status = getLength->result_status;
+		*outLength = getLength->result_length;
+	}
+
+	_filesystemTaskedDelegateEnd(tasked);
+	return status;
+}
+
+g_fs_directory_refresh_status filesystemTaskedDelegateRefreshDir(g_fs_node* node)
+{
+	g_task* task = taskingGetCurrentTask();
+	g_fs_tasked_delegate* tasked = _filesystemTaskedDelegateGet(node);
+	if(!_filesystemTaskedDelegateBegin(tasked, task))
+		return G_FS_DIRECTORY_REFRESH_ERROR;
+
+	g_fs_tasked_delegate_transaction_storage_directory_refresh* refresh = &_filesystemTaskedDelegateStorage(tasked)->directory_refresh;
+	refresh->parent_phys_fs_id = node->physicalId;
+	refresh->parent_virt_fs_id = node->id;
+	refresh->result_status = G_FS_DIRECTORY_REFRESH_ERROR;
+
+	// The delegate creates the children while handling the request
+	g_fs_directory_refresh_status status = G_FS_DIRECTORY_REFRESH_ERROR;
+	if(_filesystemTaskedDelegateRequest(tasked, task, G_FS_TASKED_DELEGATE_REQUEST_TYPE_READ_DIRECTORY))
+		status = refresh->result_status;
+
+	_filesystemTaskedDelegateEnd(tasked);
+	return status;
+}
+
+g_fs_close_status filesystemTaskedDelegateClose(g_fs_node* node, g_file_flag_mode openFlags)
+{
+	g_task* task = taskingGetCurrentTask();
+	g_fs_tasked_delegate* tasked = _filesystemTaskedDelegateGet(node);
+	if(!_filesystemTaskedDelegateBegin(tasked, task))
+		return G_FS_CLOSE_ERROR;
+
+	g_fs_tasked_delegate_transaction_storage_close* close = &_filesystemTaskedDelegateStorage(tasked)->close;
+	close->phys_fs_id = node->physicalId;
+	close->result_status = G_FS_CLOSE_ERROR;
+
+	g_fs_close_status status = G_FS_CLOSE_ERROR;
+	if(_filesystemTaskedDelegateRequest(tasked, task, G_FS_TASKED_DELEGATE_REQUEST_TYPE_CLOSE))
+		status = close->result_status;
+
+	_filesystemTaskedDelegateEnd(tasked);
+	return status;
+}
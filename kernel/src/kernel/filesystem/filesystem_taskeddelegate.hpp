@@ -0,0 +1,105 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_FILESYSTEM_TASKED_DELEGATE__
+#define __KERNEL_FILESYSTEM_TASKED_DELEGATE__
+
+#include "ghost/fs.h"
+#include "kernel/filesystem/filesystem.hpp"
+#include "kernel/tasking/tasking.hpp"
+#include "kernel/utils/wait_queue.hpp"
+#include "shared/system/mutex.hpp"
+
+/**
+ * Number of pages of the data buffer that follows the transaction storage.
+ */
+#define G_FS_TASKED_DELEGATE_BUFFER_PAGES 16
+
+/**
+ * A file system delegate that is implemented by a userspace task. Requests are
+ * forwarded to the task one transaction at a time through a memory area that is
+ * shared with its process.
+ */
+struct g_fs_tasked_delegate
+{
+	g_mutex lock;
+
+	g_tid task;
+	g_process* process;
+	g_fs_node* mountpoint;
+	bool destroyed;
+
+	/**
+	 * The first page contains the transaction storage, followed by the data buffer.
+	 */
+	g_virtual_address kernelBase;
+	g_virtual_address userBase;
+
+	bool busy;
+	g_tid transactionTask;
+	g_fs_transaction_id transaction;
+	g_fs_transaction_status transactionStatus;
+	g_wait_queue_entry* waitersTransaction;
+
+	g_fs_tasked_delegate* next;
+};
+
+/**
+ * Initializes the list of tasked delegates.
+ */
+void filesystemTaskedDelegateInitialize();
+
+/**
+ * Creates a mountpoint with the given name and makes the task its delegate.
+ */
+g_fs_register_as_delegate_status filesystemTaskedDelegateRegister(g_task* task, const char* name, g_fs_phys_id physMountpointId,
+																  g_fs_virt_id* outMountpointId, g_address* outTransactionStorage);
+
+/**
+ * Called by the delegate task to finish or repeat a transaction.
+ */
+void filesystemTaskedDelegateSetTransactionStatus(g_task* task, g_fs_transaction_id id, g_fs_transaction_status status);
+
+/**
+ * Creates or updates a node below a mountpoint of a delegate of the process of the task.
+ */
+g_fs_create_node_status filesystemTaskedDelegateCreateNode(g_task* task, g_fs_virt_id parentId, const char* name, g_fs_node_type type,
+														   g_fs_phys_id physId, g_fs_virt_id* outCreatedId);
+
+/**
+ * Called when a process is destroyed. Fails all transactions of its delegates.
+ */
+void filesystemTaskedDelegateProcessRemoved(g_process* process);
+
+g_fs_open_status filesystemTaskedDelegateDiscover(g_fs_node* parent, const char* name, g_fs_node** outChild);
+
+g_fs_open_status filesystemTaskedDelegateOpen(g_fs_node* node, g_file_flag_mode flags);
+
+g_fs_read_status filesystemTaskedDelegateRead(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead);
+
+g_fs_write_status filesystemTaskedDelegateWrite(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote);
+
+g_fs_length_status filesystemTaskedDelegateGetLength(g_fs_node* node, uint64_t* outLength);
+
+g_fs_directory_refresh_status filesystemTaskedDelegateRefreshDir(g_fs_node* node);
+
+g_fs_close_status filesystemTaskedDelegateClose(g_fs_node* node, g_file_flag_mode openFlags);
+
+#endif
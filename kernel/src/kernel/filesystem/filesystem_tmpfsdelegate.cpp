@@ -0,0 +1,404 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/filesystem/filesystem_tmpfsdelegate.hpp"
+#include "kernel/memory/heap.hpp"
+#include "kernel/memory/memory.hpp"
+#include "kernel/system/command_line.hpp"
+#include "kernel/utils/hashmap.hpp"
+#include "shared/logger/logger.hpp"
+#include "shared/utils/string.hpp"
+
+/**
+ * Largest supported file size, keeps the page index within 32 bits.
+ */
+#define G_FS_TMPFS_MAXIMUM_FILE_SIZE 0x100000000ULL
+
+static g_mutex tmpfsLock;
+static g_fs_phys_id tmpfsNextId;
+static g_hashmap<g_fs_phys_id, g_fs_tmpfs_file*>* tmpfsFiles;
+
+/**
+ * All file pages are taken from a window of kernel virtual address space that is
+ * reserved up front. Free pages of the window are kept on a stack.
+ */
+static g_mutex tmpfsPagesLock;
+static g_virtual_address tmpfsWindow;
+static uint32_t tmpfsWindowPages;
+static uint32_t* tmpfsFreePages;
+static uint32_t tmpfsFreePageCount;
+
+void filesystemTmpfsDelegateInitialize(uint32_t limit)
+{
+	mutexInitialize(&tmpfsLock);
+	tmpfsNextId = 0;
+	tmpfsFiles = hashmapCreateNumeric<g_fs_phys_id, g_fs_tmpfs_file*>(128);
+
+	mutexInitialize(&tmpfsPagesLock);
+	tmpfsWindowPages = G_PAGE_ALIGN_UP(limit) / G_PAGE_SIZE;
+	tmpfsWindow = addressRangePoolAllocate(memoryVirtualRangePool, tmpfsWindowPages);
+	if(!tmpfsWindow)
+	{
+		logWarn("%! failed to reserve %i pages of address space, tmpfs is not usable", "tmpfs", tmpfsWindowPages);
+		tmpfsWindowPages = 0;
+	}
+
+	// lowest pages are on top of the stack
+	tmpfsFreePages = (uint32_t*) heapAllocate(sizeof(uint32_t) * (tmpfsWindowPages ? tmpfsWindowPages : 1));
+	tmpfsFreePageCount = tmpfsWindowPages;
+	for(uint32_t i = 0; i < tmpfsWindowPages; i++)
+		tmpfsFreePages[i] = tmpfsWindowPages - 1 - i;
+}
+
+uint32_t filesystemTmpfsDelegateGetConfiguredLimit()
+{
+	char value[16];
+	if(!commandLineGet("tmpfs-size", value, sizeof(value)))
+		return G_FS_TMPFS_DEFAULT_LIMIT;
+
+	uint32_t kilobytes = 0;
+	for(char* c = value; *c; c++)
+	{
+		if(*c < '0' || *c > '9' || kilobytes > G_FS_TMPFS_MAXIMUM_LIMIT / 1024)
+		{
+			logWarn("%! invalid size '%s', using the default limit", "tmpfs", value);
+			return G_FS_TMPFS_DEFAULT_LIMIT;
+		}
+		kilobytes = kilobytes * 10 + (*c - '0');
+	}
+
+	uint32_t limit = kilobytes > G_FS_TMPFS_MAXIMUM_LIMIT / 1024 ? G_FS_TMPFS_MAXIMUM_LIMIT : kilobytes * 1024;
+	logInfo("%! limited to %i KiB", "tmpfs", limit / 1024);
+	return limit;
+}
+
+void filesystemTmpfsDelegateGetUsage(uint32_t* outUsed, uint32_t* outLimit)
+{
+	mutexAcquire(&tmpfsPagesLock);
+	*outUsed = (tmpfsWindowPages - tmpfsFreePageCount) * G_PAGE_SIZE;
+	*outLimit = tmpfsWindowPages * G_PAGE_SIZE;
+	mutexRelease(&tmpfsPagesLock);
+}
+
+/**
+ * Takes a page from the window and backs it with physical memory. Returns null
+ * if the limit is reached or no physical memory is left.
+ */
+g_virtual_address _filesystemTmpfsAllocatePage()
+{
+	mutexAcquire(&tmpfsPagesLock);
+	if(tmpfsFreePageCount == 0)
+	{
+		mutexRelease(&tmpfsPagesLock);
+		return 0;
+	}
+	uint32_t index = tmpfsFreePages[--tmpfsFreePageCount];
+	mutexRelease(&tmpfsPagesLock);
+
+	g_physical_address physical = memoryPhysicalAllocate();
+	if(!physical)
+	{
+		mutexAcquire(&tmpfsPagesLock);
+		tmpfsFreePages[tmpfsFreePageCount++] = index;
+		mutexRelease(&tmpfsPagesLock);
+		return 0;
+	}
+
+	g_virtual_address page = tmpfsWindow + index * G_PAGE_SIZE;
+	pagingMapPage(page, physical, DEFAULT_KERNEL_TABLE_FLAGS, DEFAULT_KERNEL_PAGE_FLAGS);
+	return page;
+}
+
+void _filesystemTmpfsFreePage(g_virtual_address page)
+{
+	g_physical_address physical = pagingVirtualToPhysical(page);
+	pagingUnmapPage(page);
+	memoryPhysicalFree(physical);
+
+	mutexAcquire(&tmpfsPagesLock);
+	tmpfsFreePages[tmpfsFreePageCount++] = (page - tmpfsWindow) / G_PAGE_SIZE;
+	mutexRelease(&tmpfsPagesLock);
+}
+
+/**
+ * Returns the slot in the page map of the file for the page at the given index. If create
+ * is set, missing tables are added, otherwise null is returned for pages of missing tables.
+ */
+g_virtual_address* _filesystemTmpfsGetSlot(g_fs_tmpfs_file* file, uint32_t index, bool create)
+{
+	uint32_t table = index / G_FS_TMPFS_TABLE_ENTRIES;
+	if(table >= file->tableCount)
+	{
+		if(!create)
+			return nullptr;
+
+		// grow geometrically so that appending stays constant time
+		uint32_t tableCount = file->tableCount ? file->tableCount * 2 : 1;
+		if(tableCount <= table)
+			tableCount = table + 1;
+
+		g_virtual_address** tables = (g_virtual_address**) heapAllocateClear(sizeof(g_virtual_address*) * tableCount);
+		if(file->tables)
+		{
+			memoryCopy(tables, file->tables, sizeof(g_virtual_address*) * file->tableCount);
+			heapFree(file->tables);
+		}
+		file->tables = tables;
+		file->tableCount = tableCount;
+	}
+
+	if(!file->tables[table])
+	{
+		if(!create)
+			return nullptr;
+		file->tables[table] = (g_virtual_address*) heapAllocateClear(sizeof(g_virtual_address) * G_FS_TMPFS_TABLE_ENTRIES);
+	}
+
+	return &file->tables[table][index % G_FS_TMPFS_TABLE_ENTRIES];
+}
+
+/**
+ * Frees all pages and the page map of the file.
+ */
+void _filesystemTmpfsClear(g_fs_tmpfs_file* file)
+{
+	for(uint32_t t = 0; t < file->tableCount; t++)
+	{
+		g_virtual_address* table = file->tables[t];
+		if(!table)
+			continue;
+
+		for(uint32_t i = 0; i < G_FS_TMPFS_TABLE_ENTRIES; i++)
+		{
+			if(table[i])
+				_filesystemTmpfsFreePage(table[i]);
+		}
+		heapFree(table);
+	}
+
+	if(file->tables)
+		heapFree(file->tables);
+	file->tables = nullptr;
+	file->tableCount = 0;
+	file->length = 0;
+}
+
+g_fs_tmpfs_file* _filesystemTmpfsGetFile(g_fs_node* node)
+{
+	mutexAcquire(&tmpfsLock);
+	g_fs_tmpfs_file* file = hashmapGet<g_fs_phys_id, g_fs_tmpfs_file*>(tmpfsFiles, node->physicalId, nullptr);
+	mutexRelease(&tmpfsLock);
+	return file;
+}
+
+g_fs_open_status filesystemTmpfsDelegateOpen(g_fs_node* node, g_file_flag_mode flags)
+{
+	if(!_filesystemTmpfsGetFile(node))
+		return G_FS_OPEN_ERROR;
+	return G_FS_OPEN_SUCCESSFUL;
+}
+
+g_fs_close_status filesystemTmpfsDelegateClose(g_fs_node* node, g_file_flag_mode openFlags)
+{
+	return G_FS_CLOSE_SUCCESSFUL;
+}
+
+g_fs_open_status filesystemTmpfsDelegateDiscover(g_fs_node* parent, const char* name, g_fs_node** outNode)
+{
+	// all files exist as nodes
+	*outNode = nullptr;
+	return G_FS_OPEN_NOT_FOUND;
+}
+
+g_fs_read_status filesystemTmpfsDelegateRead(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead)
+{
+	g_fs_tmpfs_file* file = _filesystemTmpfsGetFile(node);
+	if(!file)
+		return G_FS_READ_ERROR;
+
+	// The buffer may fault when touched, so it is only accessed while the file is not locked
+	uint8_t* bounce = (uint8_t*) heapAllocate(G_PAGE_SIZE);
+
+	uint64_t done = 0;
+	while(done < length)
+	{
+		uint64_t position = offset + done;
+		uint32_t inPage = position % G_PAGE_SIZE;
+		uint64_t chunk = G_PAGE_SIZE - inPage;
+		if(chunk > length - done)
+			chunk = length - done;
+
+		mutexAcquire(&file->lock);
+		if(position >= file->length)
+		{
+			mutexRelease(&file->lock);
+			break;
+		}
+		if(chunk > file->length - position)
+			chunk = file->length - position;
+
+		g_virtual_address* slot = _filesystemTmpfsGetSlot(file, position / G_PAGE_SIZE, false);
+		if(slot && *slot)
+			memoryCopy(bounce, (uint8_t*) *slot + inPage, chunk);
+		else
+			memorySetBytes(bounce, 0, chunk);
+		mutexRelease(&file->lock);
+
+		memoryCopy(buffer + done, bounce, chunk);
+		done += chunk;
+	}
+
+	heapFree(bounce);
+
+	*outRead = done;
+	return G_FS_READ_SUCCESSFUL;
+}
+
+g_fs_write_status filesystemTmpfsDelegateWrite(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote)
+{
+	g_fs_tmpfs_file* file = _filesystemTmpfsGetFile(node);
+	if(!file)
+		return G_FS_WRITE_ERROR;
+
+	if(offset >= G_FS_TMPFS_MAXIMUM_FILE_SIZE)
+		return G_FS_WRITE_ERROR;
+	if(offset + length > G_FS_TMPFS_MAXIMUM_FILE_SIZE)
+		length = G_FS_TMPFS_MAXIMUM_FILE_SIZE - offset;
+
+	// The buffer may fault when touched, so it is only accessed while the file is not locked
+	uint8_t* bounce = (uint8_t*) heapAllocate(G_PAGE_SIZE);
+
+	g_fs_write_status status = G_FS_WRITE_SUCCESSFUL;
+	uint64_t done = 0;
+	while(done < length)
+	{
+		uint64_t position = offset + done;
+		uint32_t index = position / G_PAGE_SIZE;
+		uint32_t inPage = position % G_PAGE_SIZE;
+		uint64_t chunk = G_PAGE_SIZE - inPage;
+		if(chunk > length - done)
+			chunk = length - done;
+
+		memoryCopy(bounce, buffer + done, chunk);
+
+		mutexAcquire(&file->lock);
+		g_virtual_address* slot = _filesystemTmpfsGetSlot(file, index, true);
+		if(!*slot)
+		{
+			// Pages are allocated without holding the lock, another writer may fill the slot meanwhile
+			mutexRelease(&file->lock);
+			g_virtual_address page = _filesystemTmpfsAllocatePage();
+			if(!page)
+			{
+				status = G_FS_WRITE_NO_SPACE;
+				break;
+			}
+			if(chunk < G_PAGE_SIZE)
+				memorySetBytes((void*) page, 0, G_PAGE_SIZE);
+
+			mutexAcquire(&file->lock);
+			slot = _filesystemTmpfsGetSlot(file, index, true);
+			if(*slot)
+				_filesystemTmpfsFreePage(page);
+			else
+				*slot = page;
+		}
+
+		memoryCopy((uint8_t*) *slot + inPage, bounce, chunk);
+		if(position + chunk > file->length)
+			file->length = position + chunk;
+		mutexRelease(&file->lock);
+
+		done += chunk;
+	}
+
+	heapFree(bounce);
+
+	// partial writes succeed, the error is reported on the next write
+	if(done > 0)
+		status = G_FS_WRITE_SUCCESSFUL;
+	*outWrote = done;
+	return status;
+}
+
+g_fs_length_status filesystemTmpfsDelegateGetLength(g_fs_node* node, uint64_t* outLength)
+{
+	g_fs_tmpfs_file* file = _filesystemTmpfsGetFile(node);
+	if(!file)
+		return G_FS_LENGTH_ERROR;
+
+	mutexAcquire(&file->lock);
+	*outLength = file->length;
+	mutexRelease(&file->lock);
+	return G_FS_LENGTH_SUCCESSFUL;
+}
+
+g_fs_open_status filesystemTmpfsDelegateCreate(g_fs_node* parent, const char* name, g_fs_node** outFile)
+{
+	if(parent->type != G_FS_NODE_TYPE_MOUNTPOINT && parent->type != G_FS_NODE_TYPE_FOLDER)
+		return G_FS_OPEN_ERROR;
+
+	g_fs_tmpfs_file* file = (g_fs_tmpfs_file*) heapAllocateClear(sizeof(g_fs_tmpfs_file));
+	mutexInitialize(&file->lock);
+
+	mutexAcquire(&tmpfsLock);
+	g_fs_phys_id id = tmpfsNextId++;
+	hashmapPut<g_fs_phys_id, g_fs_tmpfs_file*>(tmpfsFiles, id, file);
+	mutexRelease(&tmpfsLock);
+
+	g_fs_node* node = filesystemCreateNode(G_FS_NODE_TYPE_FILE, name);
+	node->physicalId = id;
+	filesystemAddChild(parent, node);
+	*outFile = node;
+	return G_FS_OPEN_SUCCESSFUL;
+}
+
+g_fs_open_status filesystemTmpfsDelegateTruncate(g_fs_node* node)
+{
+	g_fs_tmpfs_file* file = _filesystemTmpfsGetFile(node);
+	if(!file)
+		return G_FS_OPEN_ERROR;
+
+	mutexAcquire(&file->lock);
+	_filesystemTmpfsClear(file);
+	mutexRelease(&file->lock);
+	return G_FS_OPEN_SUCCESSFUL;
+}
+
+g_fs_directory_refresh_status filesystemTmpfsDelegateRefreshDir(g_fs_node* dir)
+{
+	// all files exist as nodes
+	return G_FS_DIRECTORY_REFRESH_SUCCESSFUL;
+}
+
+void filesystemTmpfsDelegateRemove(g_fs_node* node)
+{
+	mutexAcquire(&tmpfsLock);
+	g_fs_tmpfs_file* file = hashmapGet<g_fs_phys_id, g_fs_tmpfs_file*>(tmpfsFiles, node->physicalId, nullptr);
+	if(file)
+		hashmapRemove(tmpfsFiles, node->physicalId);
+	mutexRelease(&tmpfsLock);
+
+	if(!file)
+		return;
+
+	_filesystemTmpfsClear(file);
+	heapFree(file);
+}
@@ -0,0 +1,95 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_FILESYSTEM_TMPFS_DELEGATE__
+#define __KERNEL_FILESYSTEM_TMPFS_DELEGATE__
+
+#include "ghost/fs.h"
+#include "kernel/filesystem/filesystem.hpp"
+#include "kernel/memory/paging.hpp"
+#include "shared/system/mutex.hpp"
+
+/**
+ * Maximum number of bytes of file content that the tmpfs holds, unless a different
+ * limit is given with the "tmpfs-size=<KiB>" command line option. The same amount of
+ * kernel virtual address space is reserved for it on initialization.
+ */
+#define G_FS_TMPFS_DEFAULT_LIMIT 0x2000000
+
+/**
+ * Largest limit that may be configured, bounded by the kernel virtual address space.
+ */
+#define G_FS_TMPFS_MAXIMUM_LIMIT 0x10000000
+
+/**
+ * Number of pages referenced by one table of a file page map.
+ */
+#define G_FS_TMPFS_TABLE_ENTRIES 256
+
+/**
+ * A file on the tmpfs. Its content is kept in pages that are looked up through a two-level
+ * page map, a table covers {G_FS_TMPFS_TABLE_ENTRIES} pages of the file. Pages that were
+ * never written are holes and read as zeroes.
+ */
+struct g_fs_tmpfs_file
+{
+	g_mutex lock;
+	uint64_t length;
+
+	g_virtual_address** tables;
+	uint32_t tableCount;
+};
+
+/**
+ * Reserves the memory for the tmpfs. Content of all files together can use up to limit bytes.
+ */
+void filesystemTmpfsDelegateInitialize(uint32_t limit);
+
+/**
+ * Returns the limit configured on the command line, or {G_FS_TMPFS_DEFAULT_LIMIT}.
+ */
+uint32_t filesystemTmpfsDelegateGetConfiguredLimit();
+
+/**
+ * Returns the number of bytes in use by file content and the limit.
+ */
+void filesystemTmpfsDelegateGetUsage(uint32_t* outUsed, uint32_t* outLimit);
+
+g_fs_open_status filesystemTmpfsDelegateOpen(g_fs_node* node, g_file_flag_mode flags);
+
+g_fs_close_status filesystemTmpfsDelegateClose(g_fs_node* node, g_file_flag_mode openFlags);
+
+g_fs_open_status filesystemTmpfsDelegateDiscover(g_fs_node* parent, const char* name, g_fs_node** outNode);
+
+g_fs_read_status filesystemTmpfsDelegateRead(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outRead);
+
+g_fs_write_status filesystemTmpfsDelegateWrite(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote);
+
+g_fs_length_status filesystemTmpfsDelegateGetLength(g_fs_node* node, uint64_t* outLength);
+
+g_fs_open_status filesystemTmpfsDelegateCreate(g_fs_node* parent, const char* name, g_fs_node** outFile);
+
+g_fs_open_status filesystemTmpfsDelegateTruncate(g_fs_node* file);
+
+g_fs_directory_refresh_status filesystemTmpfsDelegateRefreshDir(g_fs_node* dir);
+
+void filesystemTmpfsDelegateRemove(g_fs_node* node);
+
+#endif
@@ -24,10 +24,16 @@
 #include "kernel/memory/paging.hpp"
 #include "shared/memory/memory.hpp"
 #include "shared/panic.hpp"
+#include "shared/system/mutex.hpp"
 #include "shared/utils/string.hpp"
 
 g_ramdisk* ramdiskMain = 0;
 
+/**
+ * Protects the entry list, which is modified when files are created or removed.
+ */
+static g_mutex ramdiskLock;
+
 void ramdiskLoadFromModule(g_multiboot_module* module)
 {
 	if(ramdiskMain)
@@ -48,6 +54,7 @@ void ramdiskLoadFromModule(g_multiboot_module* module)
 	module->moduleEnd = newLocation + (module->moduleEnd - module->moduleStart);
 	module->moduleStart = newLocation;
 
+	mutexInitialize(&ramdiskLock);
 	ramdiskMain = (g_ramdisk*) heapAllocate(sizeof(g_ramdisk));
 	ramdiskParseContents(module);
 	logInfo("%! module loaded: %i MB", "ramdisk", (module->moduleEnd - module->moduleStart) / 1024 / 1024);
@@ -137,17 +144,18 @@ void ramdiskParseContents(g_multiboot_module* module)
 
 g_ramdisk_entry* ramdiskFindChild(g_ramdisk_entry* parent, const char* childName)
 {
-
+	mutexAcquire(&ramdiskLock);
 	g_ramdisk_entry* current = ramdiskMain->firstEntry;
 	while(current)
 	{
 		if(current->parentid == parent->id && stringEquals(current->name, childName))
-			return current;
+			break;
 
 		current = current->next;
 	}
+	mutexRelease(&ramdiskLock);
 
-	return 0;
+	return current;
 }
 
 g_ramdisk_entry* ramdiskFindById(g_ramdisk_id id)
@@ -159,6 +167,7 @@ g_ramdisk_entry* ramdiskFindById(g_ramdisk_id id)
 		return ramdiskMain->root;
 	}
 
+	mutexAcquire(&ramdiskLock);
 	g_ramdisk_entry* currentNode = ramdiskMain->firstEntry;
 	while(currentNode != 0)
 	{
@@ -170,6 +179,7 @@ g_ramdisk_entry* ramdiskFindById(g_ramdisk_id id)
 
 		currentNode = currentNode->next;
 	}
+	mutexRelease(&ramdiskLock);
 
 	return foundNode;
 }
@@ -204,6 +214,8 @@ g_ramdisk_entry* ramdiskFindRelative(g_ramdisk_entry* node, const char* path)
 			childpath[slashPos] = 0;
 
 			currentNode = ramdiskFindChild(currentNode, childpath);
+			if(!currentNode)
+				break;
 		}
 
 		uint32_t len = stringLength(buf) - (slashPos + 1);
@@ -217,6 +229,7 @@ uint32_t ramdiskGetChildCount(g_ramdisk_id id)
 {
 	uint32_t count = 0;
 
+	mutexAcquire(&ramdiskLock);
 	g_ramdisk_entry* currentNode = ramdiskMain->firstEntry;
 	while(currentNode != 0)
 	{
@@ -226,28 +239,30 @@ uint32_t ramdiskGetChildCount(g_ramdisk_id id)
 		}
 		currentNode = currentNode->next;
 	}
+	mutexRelease(&ramdiskLock);
 
 	return count;
 }
 
 g_ramdisk_entry* ramdiskGetChildAt(g_ramdisk_id id, uint32_t index)
 {
-
 	uint32_t pos = 0;
 
+	mutexAcquire(&ramdiskLock);
 	g_ramdisk_entry* currentNode = ramdiskMain->firstEntry;
 	while(currentNode)
 	{
 		if(currentNode->parentid == id)
 		{
 			if(pos == index)
-				return currentNode;
+				break;
 			++pos;
 		}
 		currentNode = currentNode->next;
 	}
+	mutexRelease(&ramdiskLock);
 
-	return 0;
+	return currentNode;
 }
 
 g_ramdisk_entry* ramdiskGetRoot()
@@ -258,15 +273,12 @@ g_ramdisk_entry* ramdiskGetRoot()
 g_ramdisk_entry* ramdiskCreateFile(g_ramdisk_entry* parent, const char* filename)
 {
 	g_ramdisk_entry* entry = (g_ramdisk_entry*) heapAllocate(sizeof(g_ramdisk_entry));
-	entry->next = ramdiskMain->firstEntry;
-	ramdiskMain->firstEntry = entry;
 
 	int namelen = stringLength(filename);
 	entry->name = (char*) heapAllocate(sizeof(char) * (namelen + 1));
 	stringCopy(entry->name, filename);
 
 	entry->type = G_RAMDISK_ENTRY_TYPE_FILE;
-	entry->id = ramdiskMain->nextUnusedId++;
 	entry->parentid = parent->id;
 
 	entry->data = nullptr;
@@ -274,5 +286,47 @@ g_ramdisk_entry* ramdiskCreateFile(g_ramdisk_entry* parent, const char* filename
 	entry->dataOnRamdisk = false;
 	entry->notOnRdBufferLength = 0;
 
+	mutexAcquire(&ramdiskLock);
+	entry->id = ramdiskMain->nextUnusedId++;
+	entry->next = ramdiskMain->firstEntry;
+	ramdiskMain->firstEntry = entry;
+	mutexRelease(&ramdiskLock);
+
 	return entry;
 }
+
+void ramdiskDetach(g_ramdisk_id id)
+{
+	g_ramdisk_entry* entry = ramdiskFindById(id);
+	if(entry)
+		entry->parentid = G_RAMDISK_DETACHED_PARENT;
+}
+
+void ramdiskRemove(g_ramdisk_id id)
+{
+	mutexAcquire(&ramdiskLock);
+	g_ramdisk_entry* previous = nullptr;
+	g_ramdisk_entry* entry = ramdiskMain->firstEntry;
+	while(entry && entry->id != id)
+	{
+		previous = entry;
+		entry = entry->next;
+	}
+
+	if(entry)
+	{
+		if(previous)
+			previous->next = entry->next;
+		else
+			ramdiskMain->firstEntry = entry->next;
+	}
+	mutexRelease(&ramdiskLock);
+
+	if(!entry)
+		return;
+
+	if(!entry->dataOnRamdisk && entry->data)
+		heapFree(entry->data);
+	heapFree(entry->name);
+	heapFree(entry);
+}
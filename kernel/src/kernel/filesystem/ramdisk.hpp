@@ -27,6 +27,11 @@
 #include "kernel/filesystem/ramdisk_entry.hpp"
 #include "shared/multiboot/multiboot.hpp"
 
+/**
+ * Parent id of entries that were detached from their folder.
+ */
+#define G_RAMDISK_DETACHED_PARENT ((g_ramdisk_id) -1)
+
 struct g_ramdisk
 {
 	g_ramdisk_entry* firstEntry;
@@ -108,4 +113,14 @@ g_ramdisk_entry* ramdiskGetRoot();
  */
 g_ramdisk_entry* ramdiskCreateFile(g_ramdisk_entry* parent, const char* filename);
 
+/**
+ * Detaches the entry with "id" from its folder, so it is no longer found as a child.
+ */
+void ramdiskDetach(g_ramdisk_id id);
+
+/**
+ * Removes the entry with "id" from the ramdisk and frees its memory.
+ */
+void ramdiskRemove(g_ramdisk_id id);
+
 #endif
@@ -19,13 +19,15 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "kernel/ipc/message.hpp"
+#include "kernel/debug/trace.hpp"
 #include "kernel/memory/memory.hpp"
 #include "kernel/tasking/tasking.hpp"
-#include "kernel/utils/hashmap.hpp"
+#include "kernel/utils/concurrent_hashmap.hpp"
 
 #include "shared/logger/logger.hpp"
 
-static g_hashmap<g_tid, g_message_queue*>* messageQueues = 0;
+static g_concurrent_hashmap<g_tid, g_message_queue*>* messageQueues = 0;
+static g_message_statistics messageStatistics;
 
 void _messageRemoveFromQueue(g_message_queue* queue, g_message_header* message);
 void _messageAddToQueueTail(g_message_queue* queue, g_message_header* message);
@@ -34,7 +36,7 @@ g_message_queue* _messageGetQueue(g_tid task);
 
 void messageInitialize()
 {
-	messageQueues = hashmapCreateNumeric<g_tid, g_message_queue*>(64);
+	messageQueues = concurrentHashmapCreate<g_tid, g_message_queue*>();
 }
 
 g_message_send_status messageSend(g_tid sender, g_tid receiver, void* content, uint32_t length, g_message_transaction tx)
@@ -64,6 +66,10 @@ g_message_send_status messageSend(g_tid sender, g_tid receiver, void* content, u
 		_messageAddToQueueTail(queue, message);
 		_messageWakeWaitingReceiver(queue);
 		status = G_MESSAGE_SEND_STATUS_SUCCESSFUL;
+
+		G_TRACE(G_TRACE_EVENT_MESSAGE_SEND, receiver, length);
+		__sync_fetch_and_add(&messageStatistics.sent, 1);
+		__sync_fetch_and_add(&messageStatistics.bytes, length);
 	}
 
 	mutexRelease(&queue->lock);
@@ -72,17 +78,9 @@ g_message_send_status messageSend(g_tid sender, g_tid receiver, void* content, u
 
 g_message_receive_status messageReceive(g_tid receiver, g_message_header* out, uint32_t max, g_message_transaction tx)
 {
-	auto receiverEntry = hashmapGetEntry(messageQueues, receiver);
-
-	g_message_queue* queue;
-	if(receiverEntry)
-	{
-		queue = receiverEntry->value;
-	}
-	else
-	{
+	g_message_queue* queue = concurrentHashmapGet(messageQueues, receiver, (g_message_queue*) 0);
+	if(!queue)
 		return G_MESSAGE_RECEIVE_STATUS_QUEUE_EMPTY;
-	}
 
 	mutexAcquire(&queue->lock);
 
@@ -110,6 +108,9 @@ g_message_receive_status messageReceive(g_tid receiver, g_message_header* out, u
 			heapFree(message);
 			waitQueueWake(&queue->waitersSend);
 			status = G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL;
+
+			G_TRACE(G_TRACE_EVENT_MESSAGE_RECEIVE, out->sender, out->length);
+			__sync_fetch_and_add(&messageStatistics.received, 1);
 		}
 	}
 	else
@@ -123,11 +124,10 @@ g_message_receive_status messageReceive(g_tid receiver, g_message_header* out, u
 
 void messageTaskRemoved(g_tid task)
 {
-	auto receiverEntry = hashmapGetEntry(messageQueues, task);
-	if(!receiverEntry)
+	g_message_queue* queue = concurrentHashmapGet(messageQueues, task, (g_message_queue*) 0);
+	if(!queue)
 		return;
 
-	g_message_queue* queue = receiverEntry->value;
 	mutexAcquire(&queue->lock);
 
 	g_message_header* head = queue->head;
@@ -140,7 +140,7 @@ void messageTaskRemoved(g_tid task)
 
 	mutexRelease(&queue->lock);
 
-	hashmapRemove(messageQueues, task);
+	concurrentHashmapRemove(messageQueues, task);
 	heapFree(queue);
 }
 
@@ -205,23 +205,26 @@ void _messageAddToQueueTail(g_message_queue* queue, g_message_header* message)
 
 g_message_queue* _messageGetQueue(g_tid receiver)
 {
-	auto entry = hashmapGetEntry(messageQueues, receiver);
-
-	g_message_queue* queue;
-	if(entry)
-	{
-		queue = entry->value;
-	}
-	else
-	{
-		queue = (g_message_queue*) heapAllocate(sizeof(g_message_queue));
-		mutexInitialize(&queue->lock);
-		queue->task = receiver;
-		queue->size = 0;
-		queue->head = nullptr;
-		queue->tail = nullptr;
-		queue->waitersSend = nullptr;
-		hashmapPut(messageQueues, receiver, queue);
-	}
+	g_message_queue* queue = concurrentHashmapGet(messageQueues, receiver, (g_message_queue*) 0);
+	if(queue)
+		return queue;
+
+	g_message_queue* created = (g_message_queue*) heapAllocate(sizeof(g_message_queue));
+	mutexInitialize(&created->lock);
+	created->task = receiver;
+	created->size = 0;
+	created->head = nullptr;
+	created->tail = nullptr;
+	created->waitersSend = nullptr;
+
+	// Another sender might have created the queue in the meantime
+	queue = concurrentHashmapPutIfAbsent(messageQueues, receiver, created);
+	if(queue != created)
+		heapFree(created);
 	return queue;
-}
\ No newline at end of file
+}
+
+g_message_statistics messageGetStatistics()
+{
+	return messageStatistics;
+}
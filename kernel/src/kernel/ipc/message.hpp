@@ -36,6 +36,16 @@ struct g_message_queue
 	g_wait_queue_entry* waitersSend;
 };
 
+/**
+ * Counters of the messaging system.
+ */
+struct g_message_statistics
+{
+	uint32_t sent;
+	uint32_t received;
+	uint64_t bytes;
+};
+
 /**
  * Initializes basic structures required for messaging.
  */
@@ -56,6 +66,11 @@ g_message_receive_status messageReceive(g_tid receiver, g_message_header* out, u
  */
 void messageTaskRemoved(g_tid task);
 
+/**
+ * Returns a snapshot of the messaging counters.
+ */
+g_message_statistics messageGetStatistics();
+
 void messageWaitForSend(g_tid sender, g_tid receiver);
 void messageUnwaitForSend(g_tid sender, g_tid receiver);
 void messageWaitForReceive(g_tid receiver);
@@ -20,20 +20,21 @@
 
 #include "kernel/ipc/pipes.hpp"
 #include "kernel/memory/memory.hpp"
-#include "kernel/utils/hashmap.hpp"
+#include "kernel/utils/concurrent_hashmap.hpp"
 
 #include "shared/logger/logger.hpp"
 
 static g_fs_phys_id pipeNextId;
 static g_mutex pipeNextIdLock;
-static g_hashmap<g_fs_phys_id, g_pipeline*>* pipeMap;
+static g_concurrent_hashmap<g_fs_phys_id, g_pipeline*>* pipeMap;
+static g_pipe_statistics pipeStatistics;
 
 void pipeInitialize()
 {
 	mutexInitialize(&pipeNextIdLock);
 	pipeNextId = 0;
 
-	pipeMap = hashmapCreateNumeric<g_fs_phys_id, g_pipeline*>(128);
+	pipeMap = concurrentHashmapCreate<g_fs_phys_id, g_pipeline*>();
 }
 
 g_fs_pipe_status pipeCreate(g_fs_phys_id* outPipeId)
@@ -47,7 +48,7 @@ g_fs_pipe_status pipeCreate(g_fs_phys_id* outPipeId)
 	pipe->writePosition = pipe->buffer;
 
 	g_fs_phys_id pipeId = pipeGetNextId();
-	hashmapPut<g_fs_phys_id, g_pipeline*>(pipeMap, pipeId, pipe);
+	concurrentHashmapPut<g_fs_phys_id, g_pipeline*>(pipeMap, pipeId, pipe);
 	*outPipeId = pipeId;
 
 	return G_FS_PIPE_SUCCESSFUL;
@@ -55,9 +56,9 @@ g_fs_pipe_status pipeCreate(g_fs_phys_id* outPipeId)
 
 void pipeDeleteInternal(g_fs_phys_id pipeId, g_pipeline* pipe)
 {
+	concurrentHashmapRemove(pipeMap, pipeId);
 	memoryFreeKernelRange((g_virtual_address) pipe->buffer);
 	heapFree(pipe);
-	hashmapRemove(pipeMap, pipeId);
 
 	logDebug("%! deleted pipe %i", "pipe", pipeId);
 }
@@ -72,7 +73,7 @@ g_fs_phys_id pipeGetNextId()
 
 g_pipeline* pipeGetById(g_fs_phys_id pipeId)
 {
-	return hashmapGet<g_fs_phys_id, g_pipeline*>(pipeMap, pipeId, 0);
+	return concurrentHashmapGet<g_fs_phys_id, g_pipeline*>(pipeMap, pipeId, 0);
 }
 
 void pipeAddReference(g_fs_phys_id pipeId, g_file_flag_mode flags)
@@ -169,6 +170,9 @@ g_fs_read_status pipeRead(g_fs_phys_id pipeId, uint8_t* buffer, uint64_t offset,
 		*outRead = length;
 		status = G_FS_READ_SUCCESSFUL;
 		waitQueueWake(&pipe->waitersWrite);
+
+		__sync_fetch_and_add(&pipeStatistics.reads, 1);
+		__sync_fetch_and_add(&pipeStatistics.bytesRead, length);
 	}
 	else
 	{
@@ -220,6 +224,9 @@ g_fs_write_status pipeWrite(g_fs_phys_id pipeId, uint8_t* buffer, uint64_t offse
 
 		status = G_FS_WRITE_SUCCESSFUL;
 		waitQueueWake(&pipe->waitersRead);
+
+		__sync_fetch_and_add(&pipeStatistics.writes, 1);
+		__sync_fetch_and_add(&pipeStatistics.bytesWritten, length);
 	}
 	else
 	{
@@ -277,3 +284,8 @@ void pipeWaitForWrite(g_tid task, g_fs_phys_id pipeId)
 	waitQueueAdd(&pipe->waitersWrite, task);
 	mutexRelease(&pipe->lock);
 }
+
+g_pipe_statistics pipeGetStatistics()
+{
+	return pipeStatistics;
+}
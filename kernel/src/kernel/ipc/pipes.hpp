@@ -54,6 +54,17 @@ struct g_pipeline
 	g_wait_queue_entry* waitersWrite;
 };
 
+/**
+ * Counters of all pipe operations.
+ */
+struct g_pipe_statistics
+{
+	uint32_t reads;
+	uint32_t writes;
+	uint64_t bytesRead;
+	uint64_t bytesWritten;
+};
+
 /**
  * Initializes the pipes.
  */
@@ -100,4 +111,9 @@ void pipeDeleteInternal(g_fs_phys_id pipeId, g_pipeline* pipe);
 void pipeWaitForRead(g_tid task, g_fs_phys_id pipeId);
 void pipeWaitForWrite(g_tid task, g_fs_phys_id pipeId);
 
+/**
+ * Returns a snapshot of the pipe counters.
+ */
+g_pipe_statistics pipeGetStatistics();
+
 #endif
@@ -20,37 +20,66 @@
 
 #include "kernel/kernel.hpp"
 #include "kernel/calls/syscall.hpp"
+#include "kernel/debug/boot_phases.hpp"
+#include "kernel/debug/profiler.hpp"
+#include "kernel/debug/trace.hpp"
 #include "kernel/filesystem/filesystem.hpp"
 #include "kernel/filesystem/ramdisk.hpp"
 #include "kernel/ipc/message.hpp"
 #include "kernel/ipc/pipes.hpp"
 #include "kernel/logger/kernel_logger.hpp"
+#include "kernel/logger/logger_ring.hpp"
 #include "kernel/memory/memory.hpp"
 #include "kernel/system/interrupts/interrupts.hpp"
+#include "kernel/system/command_line.hpp"
 #include "kernel/system/system.hpp"
 #include "kernel/tasking/atoms.hpp"
 #include "kernel/tasking/clock.hpp"
 #include "kernel/tasking/tasking.hpp"
+#include "kernel/tasking/tasking_directory.hpp"
 #include "shared/panic.hpp"
 #include "shared/setup_information.hpp"
 #include "shared/system/mutex.hpp"
+#include "shared/utils/string.hpp"
 #include "shared/video/console_video.hpp"
 #include "shared/video/pretty_boot.hpp"
 
 static g_mutex bootstrapCoreLock;
-static g_mutex applicationCoreLock;
+
+/**
+ * System services that are started on boot. Each service is spawned by its own
+ * thread once the services it depends on have registered, so independent services
+ * are loaded in parallel.
+ */
+static g_kernel_service kernelServices[] = {
+	{"ps2driver", "/applications/ps2driver.bin", "", G_SECURITY_LEVEL_DRIVER, {}},
+	{"vbedriver", "/applications/vbedriver.bin", "", G_SECURITY_LEVEL_DRIVER, {}},
+	// {"terminal", "/applications/terminal.bin", "--headless", G_SECURITY_LEVEL_DRIVER, {}},
+	{"windowserver", "/applications/windowserver.bin", "", G_SECURITY_LEVEL_APPLICATION, {"ps2driver", "vbedriver"}}};
+static const uint32_t kernelServiceCount = sizeof(kernelServices) / sizeof(g_kernel_service);
+static volatile uint32_t kernelServicesNext = 0;
+static volatile uint32_t kernelServicesDone = 0;
 
 extern "C" void kernelMain(g_setup_information* setupInformation)
 {
+	bootPhasesInitialize();
+
 	if(G_PRETTY_BOOT)
 		prettyBootEnable(false);
 	else
 		consoleVideoClear();
 
+	int phase = bootPhaseBegin("logger");
 	kernelLoggerInitialize(setupInformation);
+	bootPhaseEnd(phase);
 
+	phase = bootPhaseBegin("memory");
 	memoryInitialize(setupInformation);
+	bootPhaseEnd(phase);
+
+	commandLineInitialize(setupInformation->multibootInformation);
 
+	phase = bootPhaseBegin("ramdisk");
 	g_multiboot_module* ramdiskModule = multibootFindModule(setupInformation->multibootInformation, "/boot/ramdisk");
 	if(!ramdiskModule)
 	{
@@ -58,6 +87,7 @@ extern "C" void kernelMain(g_setup_information* setupInformation)
 		panic("%! ramdisk not found (did you supply enough memory?)", "kern");
 	}
 	ramdiskLoadFromModule(ramdiskModule);
+	bootPhaseEnd(phase);
 
 	g_address initialPdPhys = setupInformation->initialPageDirectoryPhysical;
 	memoryUnmapSetupMemory();
@@ -69,26 +99,48 @@ extern "C" void kernelMain(g_setup_information* setupInformation)
 void kernelRunBootstrapCore(g_physical_address initialPdPhys)
 {
 	mutexInitialize(&bootstrapCoreLock);
-	mutexInitialize(&applicationCoreLock);
 
 	mutexAcquire(&bootstrapCoreLock);
 
+	int phase = bootPhaseBegin("system");
 	systemInitializeBsp(initialPdPhys);
+	bootPhaseEnd(phase);
+
+	phase = bootPhaseBegin("filesystem");
 	filesystemInitialize();
+	bootPhaseEnd(phase);
+
+	phase = bootPhaseBegin("ipc");
 	pipeInitialize();
 	messageInitialize();
 	atomicInitialize();
 	clockInitialize();
+	bootPhaseEnd(phase);
 
-	taskingInitializeBsp();
-	syscallRegisterAll();
+	phase = bootPhaseBegin("diagnostics");
+	traceInitialize();
+	profilerInitialize();
+	loggerRingInitialize();
+	bootPhaseEnd(phase);
 
-	taskingAssign(taskingGetLocal(), taskingCreateTask((g_virtual_address) kernelInitializationThread, taskingCreateProcess(), G_SECURITY_LEVEL_KERNEL));
+	phase = bootPhaseBegin("tasking");
+	taskingInitializeBsp();
+	bootPhaseEnd(phase);
 
+	// Application cores only depend on the global state set up so far, let them
+	// initialize while the rest is done here
 	logInfo("%! starting on %i cores", "kernel", processorGetNumberOfProcessors());
+	int coresPhase = bootPhaseBegin("application-cores");
 	mutexRelease(&bootstrapCoreLock);
 
+	phase = bootPhaseBegin("syscalls");
+	loggerRingStartDrain();
+	syscallRegisterAll();
+	taskingAssign(taskingGetLocal(), taskingCreateTask((g_virtual_address) kernelInitializationThread, taskingCreateProcess(), G_SECURITY_LEVEL_KERNEL));
+	bootPhaseEnd(phase);
+
 	systemWaitForApplicationCores();
+	bootPhaseEnd(coresPhase);
 
 	systemMarkReady();
 	interruptsEnable();
@@ -101,13 +153,12 @@ void kernelRunApplicationCore()
 	mutexAcquire(&bootstrapCoreLock);
 	mutexRelease(&bootstrapCoreLock);
 
-	mutexAcquire(&applicationCoreLock);
-
+	int phase = bootPhaseBegin("ap");
 	systemInitializeAp();
 	taskingInitializeAp();
+	bootPhaseEnd(phase);
 
 	systemMarkApplicationCoreReady();
-	mutexRelease(&applicationCoreLock);
 
 	systemWaitForApplicationCores();
 
@@ -140,18 +191,93 @@ void kernelSpawnService(const char* path, const char* args, g_security_level sec
 	}
 }
 
+void kernelSleep(uint32_t milliseconds)
+{
+	g_task* task = taskingGetCurrentTask();
+	clockWaitForTime(task->id, clockGetLocal()->time + milliseconds);
+	task->status = G_THREAD_STATUS_WAITING;
+	taskingYield();
+}
+
+bool kernelWaitForIdentifier(const char* identifier, uint32_t timeout)
+{
+	uint64_t deadline = clockGetLocal()->time + timeout;
+	while(taskingDirectoryGet(identifier) == G_TID_NONE)
+	{
+		if(clockGetLocal()->time >= deadline)
+			return false;
+		kernelSleep(G_KERNEL_SERVICE_POLL_INTERVAL);
+	}
+	return true;
+}
+
+void kernelServiceThread()
+{
+	g_kernel_service* service = &kernelServices[__sync_fetch_and_add(&kernelServicesNext, 1)];
+
+	for(int i = 0; i < G_KERNEL_SERVICE_MAX_DEPENDENCIES && service->dependencies[i]; i++)
+	{
+		if(!kernelWaitForIdentifier(service->dependencies[i], G_KERNEL_SERVICE_DEPENDENCY_TIMEOUT))
+			logWarn("%! %s did not register in time, starting %s anyway", "init", service->dependencies[i], service->name);
+	}
+
+	int phase = bootPhaseBegin(service->name);
+	kernelSpawnService(service->path, service->args, service->securityLevel);
+	bootPhaseEnd(phase);
+
+	__sync_fetch_and_add(&kernelServicesDone, 1);
+	taskingExit();
+}
+
 void kernelInitializationThread()
 {
 	logInfo("%! loading system services", "init");
 
 	G_PRETTY_BOOT_STATUS_P(40);
-	kernelSpawnService("/applications/ps2driver.bin", "", G_SECURITY_LEVEL_DRIVER);
-	G_PRETTY_BOOT_STATUS_P(60);
-	kernelSpawnService("/applications/vbedriver.bin", "", G_SECURITY_LEVEL_DRIVER);
+	for(uint32_t i = 0; i < kernelServiceCount; i++)
+	{
+		g_task* task = taskingCreateTask((g_virtual_address) kernelServiceThread, taskingCreateProcess(), G_SECURITY_LEVEL_KERNEL);
+		taskingAssignBalanced(task);
+	}
 
-	G_PRETTY_BOOT_STATUS_P(80);
-	// kernelSpawnService("/applications/terminal.bin", "--headless", G_SECURITY_LEVEL_DRIVER);
-	kernelSpawnService("/applications/windowserver.bin", "", G_SECURITY_LEVEL_APPLICATION);
+	uint32_t done = 0;
+	while(done < kernelServiceCount)
+	{
+		kernelSleep(G_KERNEL_SERVICE_POLL_INTERVAL);
+		if(kernelServicesDone != done)
+		{
+			done = kernelServicesDone;
+			G_PRETTY_BOOT_STATUS_P(40 + done * 40 / kernelServiceCount);
+		}
+	}
 
+	int phase = bootPhaseBegin("desktop");
+	if(!kernelWaitForIdentifier(G_KERNEL_DESKTOP_IDENTIFIER, G_KERNEL_DESKTOP_TIMEOUT))
+		logWarn("%! desktop did not come up in time", "init");
+	bootPhaseEnd(phase);
+
+	bootPhasesFinish();
+	kernelStartBenchmark();
 	taskingExit();
 }
+
+void kernelStartBenchmark()
+{
+	char suites[G_COMMAND_LINE_MAX];
+	if(!commandLineGet("benchmark", suites, G_COMMAND_LINE_MAX))
+		return;
+
+	char repeat[16];
+	if(!commandLineGet("benchmark-repeat", repeat, sizeof(repeat)))
+		stringCopy(repeat, "1");
+
+	// The arguments are referenced by the process, so they must outlive this thread
+	static char arguments[G_COMMAND_LINE_MAX + 32];
+	int length = stringCopy(arguments, "--repeat ");
+	length += stringCopy(&arguments[length], repeat);
+	length += stringCopy(&arguments[length], " ");
+	stringCopy(&arguments[length], suites);
+
+	logInfo("%! starting benchmark runner: %s", "init", arguments);
+	kernelSpawnService(G_KERNEL_BENCHMARK_PATH, arguments, G_SECURITY_LEVEL_APPLICATION);
+}
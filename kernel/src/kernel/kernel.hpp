@@ -22,12 +22,51 @@
 #define __KERNEL__
 
 #include <ghost/types.h>
+#include <ghost/kernel.h>
 
 struct g_bitmap_page_allocator;
 struct g_setup_information;
 
 extern g_bitmap_page_allocator* kernelPhysicalAllocator;
 
+#define G_KERNEL_SERVICE_MAX_DEPENDENCIES 4
+
+/**
+ * Interval in milliseconds in which the boot threads check for registered services.
+ */
+#define G_KERNEL_SERVICE_POLL_INTERVAL 2
+
+/**
+ * Time in milliseconds that a service waits for its dependencies to register.
+ */
+#define G_KERNEL_SERVICE_DEPENDENCY_TIMEOUT 10000
+
+/**
+ * Identifier that the window server registers once it starts rendering; the
+ * boot is finished when it appears.
+ */
+#define G_KERNEL_DESKTOP_IDENTIFIER "windowserver/renderer"
+#define G_KERNEL_DESKTOP_TIMEOUT 30000
+
+/**
+ * Benchmark runner that is started after boot when the command line contains
+ * "benchmark=<suites>", optionally repeated with "benchmark-repeat=<count>".
+ */
+#define G_KERNEL_BENCHMARK_PATH "/applications/benchmark.bin"
+
+/**
+ * A system service that is spawned on boot. The dependencies are the task
+ * identifiers that must be registered before the service is spawned.
+ */
+struct g_kernel_service
+{
+	const char* name;
+	const char* path;
+	const char* args;
+	g_security_level securityLevel;
+	const char* dependencies[G_KERNEL_SERVICE_MAX_DEPENDENCIES];
+};
+
 /**
  * Main entry point of the kernel. The loader calls this function on the
  * bootstrap processor. The setup information structure contains information
@@ -47,6 +86,34 @@ void kernelRunBootstrapCore(g_physical_address initialPdPhys);
  */
 void kernelInitializationThread();
 
+/**
+ * Spawns the next service from the boot service list once its dependencies are
+ * registered. One of these threads is started for each service.
+ */
+void kernelServiceThread();
+
+/**
+ * Spawns the executable at the given path as a new process.
+ */
+void kernelSpawnService(const char* path, const char* args, g_security_level securityLevel);
+
+/**
+ * Starts the benchmark runner if it was requested on the command line.
+ */
+void kernelStartBenchmark();
+
+/**
+ * Waits until a task has registered with the given identifier.
+ *
+ * @return false if the timeout in milliseconds has elapsed before
+ */
+bool kernelWaitForIdentifier(const char* identifier, uint32_t timeout);
+
+/**
+ * Puts the current kernel thread to sleep.
+ */
+void kernelSleep(uint32_t milliseconds);
+
 /**
  * This function is started by the SMP implementation.
  */
@@ -19,6 +19,7 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "shared/logger/logger.hpp"
+#include "kernel/logger/logger_ring.hpp"
 #include "kernel/system/interrupts/interrupts.hpp"
 #include "kernel/system/smp.hpp"
 #include "shared/system/mutex.hpp"
@@ -30,31 +31,33 @@ g_spinlock loggerLock = 0;
 
 void loggerPrintLocked(const char* message, ...)
 {
-	INTERRUPTS_PAUSE;
-	G_SPINLOCK_ACQUIRE(loggerLock);
-
 	va_list valist;
 	va_start(valist, message);
-	loggerPrintFormatted(message, valist);
+	if(!loggerRingWrite(message, valist, false))
+	{
+		INTERRUPTS_PAUSE;
+		G_SPINLOCK_ACQUIRE(loggerLock);
+		loggerPrintFormatted(message, valist);
+		G_SPINLOCK_RELEASE(loggerLock);
+		INTERRUPTS_RESUME;
+	}
 	va_end(valist);
-
-	G_SPINLOCK_RELEASE(loggerLock);
-	INTERRUPTS_RESUME;
 }
 
 void loggerPrintlnLocked(const char* message, ...)
 {
-	INTERRUPTS_PAUSE;
-	G_SPINLOCK_ACQUIRE(loggerLock);
-
 	va_list valist;
 	va_start(valist, message);
-	loggerPrintFormatted(message, valist);
+	if(!loggerRingWrite(message, valist, true))
+	{
+		INTERRUPTS_PAUSE;
+		G_SPINLOCK_ACQUIRE(loggerLock);
+		loggerPrintFormatted(message, valist);
+		loggerPrintCharacter('\n');
+		G_SPINLOCK_RELEASE(loggerLock);
+		INTERRUPTS_RESUME;
+	}
 	va_end(valist);
-	loggerPrintCharacter('\n');
-
-	G_SPINLOCK_RELEASE(loggerLock);
-	INTERRUPTS_RESUME;
 }
 
 void loggerPrintUnlocked(const char* message, ...)
@@ -0,0 +1,211 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/logger/logger_ring.hpp"
+#include "kernel/memory/heap.hpp"
+#include "kernel/memory/memory.hpp"
+#include "kernel/system/interrupts/interrupts.hpp"
+#include "kernel/system/processor/processor.hpp"
+#include "kernel/tasking/clock.hpp"
+#include "kernel/tasking/tasking.hpp"
+#include "shared/logger/logger.hpp"
+#include "shared/system/spinlock.hpp"
+
+extern g_spinlock loggerLock;
+
+static g_logger_ring* loggerRings = nullptr;
+static uint32_t loggerRingCount = 0;
+static volatile bool loggerRingEnabled = false;
+static volatile bool loggerRingDraining = false;
+static g_spinlock loggerRingFlushLock = 0;
+
+static uint32_t loggerRingSequence = 0;
+static g_logger_ring_statistics loggerRingStatistics;
+
+/**
+ * Entry of the drain thread, prints the queued messages in intervals.
+ */
+static void _loggerRingDrainThread();
+
+/**
+ * Finds the ring that holds the oldest queued message.
+ */
+static g_logger_ring* _loggerRingFindOldest();
+
+/**
+ * Prints the queued messages, the caller must be the only consumer.
+ */
+static void _loggerRingPrintQueued(bool lock);
+
+void loggerRingInitialize()
+{
+	loggerRingCount = processorGetNumberOfProcessors();
+	loggerRings = (g_logger_ring*) heapAllocateClear(sizeof(g_logger_ring) * loggerRingCount);
+
+	uint32_t pages = G_PAGE_ALIGN_UP(sizeof(g_logger_entry) * G_LOGGER_RING_ENTRIES) / G_PAGE_SIZE;
+	for(uint32_t i = 0; i < loggerRingCount; i++)
+	{
+		loggerRings[i].head = 0;
+		loggerRings[i].tail = 0;
+		loggerRings[i].entries = (g_logger_entry*) memoryAllocateKernelRange(pages);
+		if(!loggerRings[i].entries)
+		{
+			logWarn("%! failed to allocate ring for processor %i, logging synchronously", "logger", i);
+			loggerRingCount = 0;
+			return;
+		}
+	}
+}
+
+void loggerRingStartDrain()
+{
+	if(loggerRingCount == 0)
+		return;
+
+	g_process* process = taskingCreateProcess();
+	g_task* task = taskingCreateTask((g_virtual_address) _loggerRingDrainThread, process, G_SECURITY_LEVEL_KERNEL);
+	task->type = G_TASK_TYPE_VITAL;
+	taskingAssign(taskingGetLocal(), task);
+}
+
+void _loggerRingDrainThread()
+{
+	g_task* task = taskingGetCurrentTask();
+	logInfo("%! queueing messages, drained by task %i", "logger", task->id);
+	loggerRingDraining = true;
+	loggerRingEnabled = true;
+
+	for(;;)
+	{
+		loggerRingFlush();
+
+		clockWaitForTime(task->id, clockGetLocal()->time + G_LOGGER_DRAIN_INTERVAL);
+		task->status = G_THREAD_STATUS_WAITING;
+		taskingYield();
+	}
+}
+
+void loggerRingSetEnabled(bool enabled)
+{
+	if(!loggerRingDraining)
+		return;
+
+	loggerRingEnabled = enabled;
+	if(!enabled)
+		loggerRingFlush();
+}
+
+bool loggerRingIsEnabled()
+{
+	return loggerRingEnabled;
+}
+
+bool loggerRingWrite(const char* message, va_list valist, bool newline)
+{
+	if(!loggerRingEnabled)
+		return false;
+
+	// Interrupts on this processor are the only other writers of the ring
+	INTERRUPTS_PAUSE;
+	g_logger_ring* ring = &loggerRings[processorGetCurrentId()];
+	uint32_t head = ring->head;
+	if(head - ring->tail >= G_LOGGER_RING_ENTRIES)
+	{
+		__sync_fetch_and_add(&loggerRingStatistics.dropped, 1);
+	}
+	else
+	{
+		g_logger_entry* entry = &ring->entries[head & (G_LOGGER_RING_ENTRIES - 1)];
+		entry->sequence = __sync_fetch_and_add(&loggerRingSequence, 1);
+		entry->length = loggerFormat(entry->text, G_LOGGER_ENTRY_LENGTH, message, valist);
+		entry->newline = newline;
+
+		// Publish the entry only after it is completely written
+		__sync_synchronize();
+		ring->head = head + 1;
+		__sync_fetch_and_add(&loggerRingStatistics.messages, 1);
+	}
+	INTERRUPTS_RESUME;
+	return true;
+}
+
+g_logger_ring* _loggerRingFindOldest()
+{
+	g_logger_ring* oldest = nullptr;
+	uint32_t oldestSequence = 0;
+	for(uint32_t i = 0; i < loggerRingCount; i++)
+	{
+		g_logger_ring* ring = &loggerRings[i];
+		if(ring->tail == ring->head)
+			continue;
+
+		uint32_t sequence = ring->entries[ring->tail & (G_LOGGER_RING_ENTRIES - 1)].sequence;
+		if(!oldest || (int32_t) (sequence - oldestSequence) < 0)
+		{
+			oldest = ring;
+			oldestSequence = sequence;
+		}
+	}
+	return oldest;
+}
+
+void loggerRingFlush()
+{
+	G_SPINLOCK_ACQUIRE(loggerRingFlushLock);
+	_loggerRingPrintQueued(true);
+	G_SPINLOCK_RELEASE(loggerRingFlushLock);
+}
+
+void loggerRingFlushForPanic()
+{
+	loggerRingEnabled = false;
+	_loggerRingPrintQueued(false);
+}
+
+void _loggerRingPrintQueued(bool lock)
+{
+	g_logger_ring* ring;
+	while((ring = _loggerRingFindOldest()) != nullptr)
+	{
+		g_logger_entry* entry = &ring->entries[ring->tail & (G_LOGGER_RING_ENTRIES - 1)];
+
+		// Each message is printed as a whole, direct prints can only come in between
+		INTERRUPTS_PAUSE;
+		if(lock)
+			G_SPINLOCK_ACQUIRE(loggerLock);
+		loggerPrintPlain(entry->text);
+		if(entry->newline)
+			loggerPrintCharacter('\n');
+		if(lock)
+			G_SPINLOCK_RELEASE(loggerLock);
+		INTERRUPTS_RESUME;
+
+		__sync_synchronize();
+		ring->tail = ring->tail + 1;
+	}
+}
+
+g_logger_ring_statistics loggerRingGetStatistics()
+{
+	g_logger_ring_statistics statistics;
+	statistics.messages = __sync_fetch_and_add(&loggerRingStatistics.messages, 0);
+	statistics.dropped = __sync_fetch_and_add(&loggerRingStatistics.dropped, 0);
+	return statistics;
+}
@@ -0,0 +1,118 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+#ifndef __KERNEL_LOGGER_RING__
+#define __KERNEL_LOGGER_RING__
+
+#include "ghost/stdint.h"
+#include <stdarg.h>
+
+/**
+ * Number of entries in the ring of each processor, must be a power of two.
+ */
+#define G_LOGGER_RING_ENTRIES 256
+
+/**
+ * Maximum length of a single formatted message, longer ones are cut off.
+ */
+#define G_LOGGER_ENTRY_LENGTH 248
+
+/**
+ * Time in milliseconds the drain thread sleeps when the rings are empty.
+ */
+#define G_LOGGER_DRAIN_INTERVAL 10
+
+/**
+ * A formatted message. The sequence number is taken from a global counter so
+ * that the drain thread can print the messages of all processors in order.
+ */
+struct g_logger_entry
+{
+	uint32_t sequence;
+	uint16_t length;
+	bool newline;
+	char text[G_LOGGER_ENTRY_LENGTH];
+};
+
+/**
+ * Ring of messages of a single processor. Only the owning processor writes
+ * entries and advances the head, only the drain thread advances the tail.
+ */
+struct g_logger_ring
+{
+	volatile uint32_t head;
+	volatile uint32_t tail;
+	g_logger_entry* entries;
+};
+
+struct g_logger_ring_statistics
+{
+	uint32_t messages;
+	uint32_t dropped;
+};
+
+/**
+ * Allocates the rings for all processors.
+ */
+void loggerRingInitialize();
+
+/**
+ * Creates the thread that drains the rings to the log outputs. Messages are
+ * queued once it runs.
+ */
+void loggerRingStartDrain();
+
+/**
+ * Enables or disables queueing; when disabling, the queued messages are printed.
+ * Has no effect before the drain thread runs.
+ */
+void loggerRingSetEnabled(bool enabled);
+
+/**
+ * @return whether messages are currently queued
+ */
+bool loggerRingIsEnabled();
+
+/**
+ * Formats a message into the ring of the current processor. If the ring is
+ * full, the message is dropped.
+ *
+ * @return false if the message must be printed directly instead
+ */
+bool loggerRingWrite(const char* message, va_list valist, bool newline);
+
+/**
+ * Prints and removes all queued messages.
+ */
+void loggerRingFlush();
+
+/**
+ * Stops queueing and prints the queued messages without taking any locks, so
+ * that the messages before a panic are not lost.
+ */
+void loggerRingFlushForPanic();
+
+/**
+ * @return a snapshot of the message counters
+ */
+g_logger_ring_statistics loggerRingGetStatistics();
+
+#endif
@@ -108,6 +108,11 @@ uint32_t heapGetUsedAmount()
 	return heapAmountInUse;
 }
 
+uint32_t heapGetSize()
+{
+	return heapEnd - heapStart;
+}
+
 void* operator new(size_t size)
 {
 	return heapAllocate(size);
@@ -53,4 +53,9 @@ void heapFree(void* memory);
  */
 uint32_t heapGetUsedAmount();
 
+/**
+ * Returns the number of bytes that are currently mapped for the kernel heap.
+ */
+uint32_t heapGetSize();
+
 #endif
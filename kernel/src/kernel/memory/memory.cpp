@@ -20,13 +20,16 @@
 
 #include "kernel/memory/memory.hpp"
 #include "kernel/debug/debug_interface.hpp"
+#include "kernel/debug/trace.hpp"
 #include "kernel/filesystem/filesystem.hpp"
+#include "kernel/filesystem/filesystem_pagecache.hpp"
 #include "kernel/kernel.hpp"
 #include "kernel/memory/heap.hpp"
 #include "kernel/memory/lower_heap.hpp"
 #include "kernel/memory/page_reference_tracker.hpp"
 #include "kernel/memory/paging.hpp"
 #include "kernel/tasking/task.hpp"
+#include "kernel/tasking/tasking_memory.hpp"
 
 g_address_range_pool* memoryVirtualRangePool = 0;
 
@@ -69,6 +72,11 @@ void memoryUnmapSetupMemory()
 g_physical_address memoryPhysicalAllocate(bool untracked)
 {
 	g_physical_address page = bitmapPageAllocatorAllocate(&memoryPhysicalAllocator);
+
+	// Cached pages are only reclaimed if this is not an allocation made under a lock
+	if(!page && filesystemPageCacheReclaim(G_PAGE_CACHE_RECLAIM_BATCH))
+		page = bitmapPageAllocatorAllocate(&memoryPhysicalAllocator);
+
 	if(!untracked && page)
 		pageReferenceTrackerIncrement(page);
 	return page;
@@ -113,6 +121,36 @@ void memoryFreeKernelRange(g_virtual_address address)
 	addressRangePoolFree(memoryVirtualRangePool, address);
 }
 
+g_virtual_address memoryShareKernelRange(g_process* process, g_virtual_address kernelRange, int32_t pages)
+{
+	g_virtual_address userRange = addressRangePoolAllocate(process->virtualRangePool, pages, G_PROC_VIRTUAL_RANGE_FLAG_NONE);
+	if(!userRange)
+		return 0;
+
+	for(int32_t i = 0; i < pages; i++)
+	{
+		g_physical_address phys = pagingVirtualToPhysical(kernelRange + i * G_PAGE_SIZE);
+		pagingMapPage(userRange + i * G_PAGE_SIZE, phys, DEFAULT_USER_TABLE_FLAGS, DEFAULT_USER_PAGE_FLAGS);
+		pageReferenceTrackerIncrement(phys);
+	}
+	return userRange;
+}
+
+void memoryUnshareKernelRange(g_process* process, g_virtual_address userRange, int32_t pages)
+{
+	for(int32_t i = 0; i < pages; i++)
+	{
+		g_virtual_address virt = userRange + i * G_PAGE_SIZE;
+		g_physical_address phys = pagingVirtualToPhysical(virt);
+		if(!phys)
+			continue;
+
+		pagingUnmapPage(virt);
+		memoryPhysicalFree(phys);
+	}
+	addressRangePoolFree(process->virtualRangePool, userRange);
+}
+
 void memoryOnDemandMapFile(g_process* process, g_fd file, g_offset fileOffset, g_address fileStart, g_ptrsize fileSize, g_ptrsize memorySize)
 {
 	g_memory_file_ondemand* mapping = (g_memory_file_ondemand*) heapAllocate(sizeof(g_memory_file_ondemand));
@@ -179,3 +217,256 @@ bool memoryOnDemandHandlePageFault(g_task* task, g_address accessed)
 
 	return true;
 }
+
+g_memory_map_status memoryMappingCreate(g_process* process, uint32_t length, g_memory_protection protection, g_memory_map_flags flags,
+										g_fs_node* node, uint64_t offset, g_address* outAddress)
+{
+	uint32_t pages = G_PAGE_ALIGN_UP(length) / G_PAGE_SIZE;
+	g_virtual_address base = addressRangePoolAllocate(process->virtualRangePool, pages);
+	if(!base)
+		return G_MEMORY_MAP_STATUS_NO_MEMORY;
+
+	g_memory_mapping* mapping = (g_memory_mapping*) heapAllocateClear(sizeof(g_memory_mapping));
+	mapping->base = base;
+	mapping->pages = pages;
+	mapping->protection = protection;
+	mapping->flags = flags;
+	mapping->nodeId = node ? node->id : 0;
+	mapping->offset = offset;
+	mapping->references = 1;
+	mapping->removed = false;
+
+	// The node must outlive the mapping even if it is closed and unlinked
+	if(node)
+		filesystemRetainNode(node);
+
+	mutexAcquire(&process->lock);
+	mapping->next = process->memoryMappings;
+	process->memoryMappings = mapping;
+	mutexRelease(&process->lock);
+
+	G_TRACE(G_TRACE_EVENT_MEMORY_MAP, base, pages);
+
+	*outAddress = base;
+	return G_MEMORY_MAP_STATUS_SUCCESSFUL;
+}
+
+/**
+ * Writes pages of a shared file mapping that were modified back to the file. The pages
+ * are looked up in the given page directory, or in the current address space if it is 0,
+ * and written through a temporary kernel mapping, so that a delegate may block while the
+ * address space of a dying process is not switched to.
+ */
+void _memoryMappingWriteBack(g_memory_mapping* mapping, g_physical_address directory)
+{
+	if(!(mapping->flags & G_MEMORY_MAP_SHARED) || (mapping->flags & G_MEMORY_MAP_ANONYMOUS))
+		return;
+
+	g_fs_node* node = filesystemGetNode(mapping->nodeId);
+	if(!node)
+		return;
+
+	uint64_t fileLength;
+	if(filesystemGetLength(node, &fileLength) != G_FS_LENGTH_SUCCESSFUL)
+		return;
+
+	for(uint32_t i = 0; i < mapping->pages; i++)
+	{
+		uint64_t position = mapping->offset + i * G_PAGE_SIZE;
+		if(position >= fileLength)
+			break;
+
+		g_virtual_address virt = mapping->base + i * G_PAGE_SIZE;
+		g_physical_address returnDirectory = directory ? taskingMemoryTemporarySwitchTo(directory) : 0;
+		bool dirty = pagingGetPageFlags(virt) & G_PAGE_DIRTY;
+		g_physical_address physical = pagingVirtualToPhysical(virt);
+		if(directory)
+			taskingMemoryTemporarySwitchBack(returnDirectory);
+
+		if(!dirty || !physical)
+			continue;
+
+		uint64_t length = fileLength - position;
+		if(length > G_PAGE_SIZE)
+			length = G_PAGE_SIZE;
+
+		g_virtual_address temporary = addressRangePoolAllocate(memoryVirtualRangePool, 1);
+		pagingMapPage(temporary, physical, DEFAULT_KERNEL_TABLE_FLAGS, DEFAULT_KERNEL_PAGE_FLAGS);
+
+		int64_t wrote;
+		if(filesystemWrite(node, (uint8_t*) temporary, position, length, &wrote) != G_FS_WRITE_SUCCESSFUL)
+			logInfo("%! failed to write back page %h of mapping to node %i", "memory", virt, node->id);
+
+		pagingUnmapPage(temporary);
+		addressRangePoolFree(memoryVirtualRangePool, temporary);
+	}
+}
+
+/**
+ * Frees the mapping and releases the reference it holds on its node.
+ */
+void _memoryMappingFree(g_memory_mapping* mapping)
+{
+	g_fs_node* node = mapping->nodeId ? filesystemGetNode(mapping->nodeId) : nullptr;
+	if(node)
+		filesystemReleaseNode(node);
+
+	heapFree(mapping);
+}
+
+/**
+ * Releases a reference on the mapping and frees it if it was the last one of a
+ * removed mapping.
+ */
+void _memoryMappingRelease(g_process* process, g_memory_mapping* mapping)
+{
+	mutexAcquire(&process->lock);
+	bool destroy = --mapping->references == 0 && mapping->removed;
+	mutexRelease(&process->lock);
+
+	if(destroy)
+		_memoryMappingFree(mapping);
+}
+
+g_memory_map_status memoryMappingRemove(g_process* process, g_address address, uint32_t length)
+{
+	mutexAcquire(&process->lock);
+
+	g_memory_mapping* previous = nullptr;
+	g_memory_mapping* mapping = process->memoryMappings;
+	while(mapping && mapping->base != address)
+	{
+		previous = mapping;
+		mapping = mapping->next;
+	}
+
+	if(!mapping || (length && G_PAGE_ALIGN_UP(length) / G_PAGE_SIZE != mapping->pages))
+	{
+		mutexRelease(&process->lock);
+		return G_MEMORY_MAP_STATUS_INVALID_ARGUMENTS;
+	}
+
+	if(previous)
+		previous->next = mapping->next;
+	else
+		process->memoryMappings = mapping->next;
+
+	// the reference of the list is now held by the removal
+	mapping->removed = true;
+
+	mutexRelease(&process->lock);
+
+	_memoryMappingWriteBack(mapping, 0);
+
+	for(uint32_t i = 0; i < mapping->pages; i++)
+	{
+		g_virtual_address virt = mapping->base + i * G_PAGE_SIZE;
+		g_physical_address physical = pagingVirtualToPhysical(virt);
+		if(!physical)
+			continue;
+
+		pagingUnmapPage(virt);
+		memoryPhysicalFree(physical);
+	}
+
+	addressRangePoolFree(process->virtualRangePool, mapping->base);
+	_memoryMappingRelease(process, mapping);
+	return G_MEMORY_MAP_STATUS_SUCCESSFUL;
+}
+
+/**
+ * Allocates a page and fills it with the content of the mapping at the given
+ * page. The page is filled through a temporary kernel mapping, so no other
+ * thread of the process can see it before it is complete.
+ */
+g_physical_address _memoryMappingFillPage(g_memory_mapping* mapping, g_virtual_address page)
+{
+	g_physical_address physical = memoryPhysicalAllocate();
+	if(!physical)
+		return 0;
+
+	g_virtual_address temporary = addressRangePoolAllocate(memoryVirtualRangePool, 1);
+	pagingMapPage(temporary, physical, DEFAULT_KERNEL_TABLE_FLAGS, DEFAULT_KERNEL_PAGE_FLAGS);
+	memorySetBytes((void*) temporary, 0, G_PAGE_SIZE);
+
+	if(!(mapping->flags & G_MEMORY_MAP_ANONYMOUS))
+	{
+		g_fs_node* node = filesystemGetNode(mapping->nodeId);
+		if(node)
+		{
+			uint64_t position = mapping->offset + (page - mapping->base);
+			uint32_t done = 0;
+			while(done < G_PAGE_SIZE)
+			{
+				int64_t read;
+				if(filesystemRead(node, (uint8_t*) temporary + done, position + done, G_PAGE_SIZE - done, &read) != G_FS_READ_SUCCESSFUL || read <= 0)
+					break;
+				done += read;
+			}
+		}
+	}
+
+	pagingUnmapPage(temporary);
+	addressRangePoolFree(memoryVirtualRangePool, temporary);
+	return physical;
+}
+
+bool memoryMappingHandlePageFault(g_task* task, g_address accessed)
+{
+	g_process* process = task->process;
+	mutexAcquire(&process->lock);
+
+	g_memory_mapping* mapping = process->memoryMappings;
+	while(mapping && !(accessed >= mapping->base && accessed < mapping->base + mapping->pages * G_PAGE_SIZE))
+		mapping = mapping->next;
+
+	// Faults on pages that are already present are protection violations
+	g_virtual_address page = G_PAGE_ALIGN_DOWN(accessed);
+	if(!mapping || mapping->protection == G_MEMORY_PROTECTION_NONE || pagingVirtualToPhysical(page))
+	{
+		mutexRelease(&process->lock);
+		return false;
+	}
+
+	// Reading the file may block, so it happens without the lock
+	mapping->references++;
+	mutexRelease(&process->lock);
+
+	g_physical_address physical = _memoryMappingFillPage(mapping, page);
+
+	mutexAcquire(&process->lock);
+	bool handled = false;
+	if(physical && !mapping->removed)
+	{
+		// Another thread may have loaded the page in the meantime
+		if(!pagingVirtualToPhysical(page))
+		{
+			uint32_t pageFlags = G_PAGE_PRESENT | G_PAGE_USERSPACE;
+			if(mapping->protection & G_MEMORY_PROTECTION_WRITE)
+				pageFlags |= G_PAGE_READWRITE;
+			pagingMapPage(page, physical, DEFAULT_USER_TABLE_FLAGS, pageFlags);
+			physical = 0;
+		}
+		handled = true;
+	}
+	mutexRelease(&process->lock);
+
+	if(physical)
+		memoryPhysicalFree(physical);
+	_memoryMappingRelease(process, mapping);
+	return handled;
+}
+
+void memoryMappingDestroyAll(g_process* process)
+{
+	g_memory_mapping* mapping = process->memoryMappings;
+	while(mapping)
+	{
+		_memoryMappingWriteBack(mapping, process->pageDirectory);
+
+		g_memory_mapping* next = mapping->next;
+		_memoryMappingFree(mapping);
+		mapping = next;
+	}
+	process->memoryMappings = nullptr;
+}
@@ -57,6 +57,20 @@ g_virtual_address memoryAllocateKernelRange(int32_t pages);
  */
 void memoryFreeKernelRange(g_virtual_address address);
 
+/**
+ * Maps the pages of a range allocated with <memoryAllocateKernelRange> into a free
+ * range of the process, which must be the current address space. The pages stay
+ * allocated until both mappings are gone.
+ *
+ * @return the address in the process or 0 if there was no free range
+ */
+g_virtual_address memoryShareKernelRange(g_process* process, g_virtual_address kernelRange, int32_t pages);
+
+/**
+ * Unmaps a range that was shared with <memoryShareKernelRange> from the process.
+ */
+void memoryUnshareKernelRange(g_process* process, g_virtual_address userRange, int32_t pages);
+
 /**
  * Creates an on-demand mapping for a file in memory.
  */
@@ -72,4 +86,27 @@ g_memory_file_ondemand* memoryOnDemandFindMapping(g_task* task, g_address addres
  */
 bool memoryOnDemandHandlePageFault(g_task* task, g_address accessed);
 
+/**
+ * Creates a memory mapping in the process. Pages are not mapped until they are accessed.
+ * The node may be null for anonymous mappings.
+ */
+g_memory_map_status memoryMappingCreate(g_process* process, uint32_t length, g_memory_protection protection, g_memory_map_flags flags,
+										g_fs_node* node, uint64_t offset, g_address* outAddress);
+
+/**
+ * Removes the mapping that starts at the given address from the current process. If the length
+ * is not zero, it must match the mapping. Modified pages of shared file mappings are written back.
+ */
+g_memory_map_status memoryMappingRemove(g_process* process, g_address address, uint32_t length);
+
+/**
+ * Loads the accessed page of a memory mapping.
+ */
+bool memoryMappingHandlePageFault(g_task* task, g_address accessed);
+
+/**
+ * Writes back shared mappings and frees all mapping structures of a process that is being destroyed.
+ */
+void memoryMappingDestroyAll(g_process* process);
+
 #endif
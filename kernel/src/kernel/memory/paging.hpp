@@ -36,4 +36,15 @@
  */
 g_physical_address pagingVirtualToPhysical(g_virtual_address addr);
 
+/**
+ * Reads the flags of the page entry for a given virtual address in the currently
+ * mapped address space.
+ *
+ * @param addr
+ * 		the address to check
+ *
+ * @return the flags or 0 if the page is not mapped
+ */
+uint32_t pagingGetPageFlags(g_virtual_address addr);
+
 #endif
@@ -18,12 +18,14 @@
  *                                                                           *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+#include "kernel/logger/logger_ring.hpp"
 #include "kernel/system/interrupts/interrupts.hpp"
 #include "shared/logger/logger.hpp"
 
 void panic(const char* msg, ...)
 {
 	interruptsDisable();
+	loggerRingFlushForPanic();
 	logInfo("%*%! unrecoverable error on processor %i", 0x0C, "kernerr", processorGetCurrentId());
 
 	va_list valist;
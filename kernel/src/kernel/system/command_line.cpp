@@ -0,0 +1,72 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/system/command_line.hpp"
+#include "shared/logger/logger.hpp"
+#include "shared/utils/string.hpp"
+
+static char commandLine[G_COMMAND_LINE_MAX] = {0};
+
+void commandLineInitialize(g_multiboot_information* info)
+{
+	if(!(info->flags & G_MULTIBOOT_FLAGS_CMDLINE) || !info->cmdline)
+		return;
+
+	const char* source = (const char*) info->cmdline;
+	int length = 0;
+	while(source[length] && length < G_COMMAND_LINE_MAX - 1)
+	{
+		commandLine[length] = source[length];
+		length++;
+	}
+	commandLine[length] = 0;
+
+	logDebug("%! %s", "cmdline", commandLine);
+}
+
+bool commandLineGet(const char* key, char* out, int max)
+{
+	int keyLength = stringLength(key);
+	const char* pos = commandLine;
+
+	while(*pos)
+	{
+		while(*pos == ' ')
+			pos++;
+		const char* end = pos;
+		while(*end && *end != ' ')
+			end++;
+
+		if(end - pos > keyLength && pos[keyLength] == '=' && stringEquals(pos, pos + keyLength, key))
+		{
+			const char* value = pos + keyLength + 1;
+			int length = 0;
+			while(value + length < end && length < max - 1)
+			{
+				out[length] = value[length];
+				length++;
+			}
+			out[length] = 0;
+			return true;
+		}
+		pos = end;
+	}
+	return false;
+}
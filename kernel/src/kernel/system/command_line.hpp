@@ -0,0 +1,44 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_COMMAND_LINE__
+#define __KERNEL_COMMAND_LINE__
+
+#include "shared/multiboot/multiboot.hpp"
+
+#define G_COMMAND_LINE_MAX 256
+
+/**
+ * Copies the command line that the bootloader has passed. Must be called while
+ * the multiboot structures are still mapped.
+ */
+void commandLineInitialize(g_multiboot_information* info);
+
+/**
+ * Looks for an option in the form "key=value" on the command line.
+ *
+ * @param key option name
+ * @param out buffer that receives the value
+ * @param max size of the buffer
+ * @return whether the option was found
+ */
+bool commandLineGet(const char* key, char* out, int max);
+
+#endif
@@ -33,6 +33,9 @@ static bool available = false;
 static g_physical_address physicalBase = 0;
 static g_virtual_address virtualBase = 0;
 
+// All APIC timers run at the bus frequency, so the calibration of the BSP is reused
+static uint32_t timerTicksPer10ms = 0;
+
 void lapicSetup(g_physical_address address)
 {
 	physicalBase = address;
@@ -115,23 +118,30 @@ void lapicStartTimer()
 {
 	logDebug("%! starting timer", "lapic");
 
-	// Tell APIC timer to use divider 16
-	lapicWrite(APIC_REGISTER_TIMER_DIV, 0x3);
+	// Calibrate only once; this keeps the PIT out of the AP initialization
+	// so that the application cores can be initialized in parallel
+	uint32_t ticksPer10ms = timerTicksPer10ms;
+	if(ticksPer10ms == 0)
+	{
+		// Tell APIC timer to use divider 16
+		lapicWrite(APIC_REGISTER_TIMER_DIV, 0x3);
 
-	// Prepare the PIT to sleep for 10ms (10000µs)
-	pitPrepareSleep(10000);
+		// Prepare the PIT to sleep for 10ms (10000µs)
+		pitPrepareSleep(10000);
 
-	// Set APIC init counter to -1
-	lapicWrite(APIC_REGISTER_TIMER_INITCNT, 0xFFFFFFFF);
+		// Set APIC init counter to -1
+		lapicWrite(APIC_REGISTER_TIMER_INITCNT, 0xFFFFFFFF);
 
-	// Perform PIT-supported sleep
-	pitPerformSleep();
+		// Perform PIT-supported sleep
+		pitPerformSleep();
 
-	// Stop the APIC timer
-	lapicWrite(APIC_REGISTER_LVT_TIMER, APIC_LVT_INT_MASKED);
+		// Stop the APIC timer
+		lapicWrite(APIC_REGISTER_LVT_TIMER, APIC_LVT_INT_MASKED);
 
-	// Now we know how often the APIC timer has ticked in 10ms
-	uint32_t ticksPer10ms = 0xFFFFFFFF - lapicRead(APIC_REGISTER_TIMER_CURRCNT);
+		// Now we know how often the APIC timer has ticked in 10ms
+		ticksPer10ms = 0xFFFFFFFF - lapicRead(APIC_REGISTER_TIMER_CURRCNT);
+		timerTicksPer10ms = ticksPer10ms;
+	}
 
 	// Start timer as periodic on IRQ 0
 	lapicWrite(APIC_REGISTER_TIMER_DIV, 0x3);
@@ -19,6 +19,7 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "kernel/system/interrupts/exceptions.hpp"
+#include "kernel/debug/trace.hpp"
 #include "kernel/memory/memory.hpp"
 #include "kernel/memory/page_reference_tracker.hpp"
 #include "kernel/memory/paging.hpp"
@@ -136,6 +137,7 @@ void exceptionsDumpTask(g_task* task)
 bool exceptionsHandlePageFault(g_task* task)
 {
 	g_virtual_address accessed = exceptionsGetCR2();
+	G_TRACE(G_TRACE_EVENT_PAGE_FAULT, accessed, task->state->eip);
 
 	if(taskingMemoryHandleStackOverflow(task, accessed))
 		return true;
@@ -143,6 +145,9 @@ bool exceptionsHandlePageFault(g_task* task)
 	if(memoryOnDemandHandlePageFault(task, accessed))
 		return true;
 
+	if(memoryMappingHandlePageFault(task, accessed))
+		return true;
+
 	g_physical_address physPage = pagingVirtualToPhysical(G_PAGE_ALIGN_DOWN(accessed));
 	logInfo("%! task %i (core %i) EIP: %x (accessed %h, mapped page %h)", "pagefault", task->id, processorGetCurrentId(), task->state->eip, accessed, physPage);
 
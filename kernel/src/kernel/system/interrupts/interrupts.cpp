@@ -20,6 +20,8 @@
 
 #include "kernel/system/interrupts/interrupts.hpp"
 #include "kernel/calls/syscall.hpp"
+#include "kernel/debug/profiler.hpp"
+#include "kernel/debug/trace.hpp"
 #include "kernel/memory/gdt.hpp"
 #include "kernel/system/configuration.hpp"
 #include "kernel/system/interrupts/apic/ioapic.hpp"
@@ -75,6 +77,13 @@ void interruptsInitializeAp()
 extern "C" volatile g_processor_state* _interruptHandler(volatile g_processor_state* state)
 {
 	g_task* task = taskingGetCurrentTask();
+	bool userMode = (state->cs & 3) == 3 || (state->eflags & 0x20000);
+	taskingAccountTime(task, userMode);
+
+	// An exception in kernel mode (like a fault on a lazily filled user buffer within a
+	// syscall) nests in the handling of another interrupt, whose state is restored after
+	volatile g_processor_state* outerState = task ? task->state : nullptr;
+	bool nested = !userMode && state->intr < 0x20;
 
 	if(state->intr == 0x82) // Privilege downgrade for spawn
 	{
@@ -116,8 +125,14 @@ extern "C" volatile g_processor_state* _interruptHandler(volatile g_processor_st
 		else
 		{
 			uint8_t irq = state->intr - 0x20;
+			G_TRACE(G_TRACE_EVENT_IRQ_ENTER, irq, 0);
+
 			if(irq == 0) // Timer
 			{
+#if G_PROFILING
+				if(profilerEnabled)
+					profilerTick(task, state);
+#endif
 				clockUpdate();
 				taskingSchedule();
 			}
@@ -127,10 +142,19 @@ extern "C" volatile g_processor_state* _interruptHandler(volatile g_processor_st
 			}
 
 			_interruptsSendEndOfInterrupt(irq);
+			G_TRACE(G_TRACE_EVENT_IRQ_EXIT, irq, 0);
 		}
 	}
 
-	return taskingGetCurrentTask()->state;
+	// Handling time is charged as kernel time to the task that continues running
+	g_task* next = taskingGetCurrentTask();
+	taskingAccountTime(next, false);
+	taskingStateSwitchFpu(task, next);
+
+	volatile g_processor_state* result = next->state;
+	if(nested && next == task)
+		task->state = outerState;
+	return result;
 }
 
 void interruptsEnable()
@@ -31,6 +31,9 @@ static uint32_t processorsAvailable = 0;
 
 static uint32_t* apicIdToProcessorMapping = 0;
 
+static bool processorFpuStateAvailable = false;
+static uint8_t processorFpuInitialState[G_FPU_STATE_SIZE] __attribute__((aligned(G_FPU_STATE_ALIGNMENT)));
+
 void processorInitializeBsp()
 {
 	if(!processorSupportsCpuid())
@@ -38,6 +41,7 @@ void processorInitializeBsp()
 
 	processorPrintInformation();
 	processorEnableSSE();
+	processorInitializeFpuState();
 
 	if(!processorHasFeature(g_cpuid_standard_edx_feature::APIC))
 		panic("%! processor has no APIC", "cpu");
@@ -154,6 +158,41 @@ void processorCpuid(uint32_t code, uint32_t* outA, uint32_t* outB, uint32_t* out
 				 : "a"(code));
 }
 
+void processorInitializeFpuState()
+{
+	if(!processorHasFeature(g_cpuid_standard_edx_feature::FXSR) || !processorHasFeature(g_cpuid_standard_edx_feature::SSE))
+	{
+		logWarn("%! FXSAVE not supported, FPU state is not preserved on task switches", "sse");
+		return;
+	}
+
+	asm volatile("fninit");
+	processorSaveFpuState(processorFpuInitialState);
+	processorFpuStateAvailable = true;
+}
+
+bool processorHasFpuState()
+{
+	return processorFpuStateAvailable;
+}
+
+void processorSaveFpuState(uint8_t* area)
+{
+	asm volatile("fxsave (%0)" ::"r"(area)
+				 : "memory");
+}
+
+void processorRestoreFpuState(uint8_t* area)
+{
+	asm volatile("fxrstor (%0)" ::"r"(area)
+				 : "memory");
+}
+
+void processorResetFpuState(uint8_t* area)
+{
+	memoryCopy(area, processorFpuInitialState, G_FPU_STATE_SIZE);
+}
+
 void processorEnableSSE()
 {
 	if(processorHasFeature(g_cpuid_standard_edx_feature::SSE))
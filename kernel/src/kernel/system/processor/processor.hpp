@@ -227,4 +227,36 @@ void processorWriteMsr(uint32_t msr, uint32_t lo, uint32_t hi);
  */
 uint32_t processorReadEflags();
 
+/**
+ * Size and alignment of the area that FXSAVE stores the FPU and SSE registers in.
+ */
+#define G_FPU_STATE_SIZE 512
+#define G_FPU_STATE_ALIGNMENT 16
+
+/**
+ * Captures the clean FPU and SSE register state that new tasks start with. Must
+ * be called on the bootstrap processor after SSE was enabled.
+ */
+void processorInitializeFpuState();
+
+/**
+ * Whether the FPU and SSE registers can be saved with FXSAVE.
+ */
+bool processorHasFpuState();
+
+/**
+ * Saves the FPU and SSE registers to the aligned area.
+ */
+void processorSaveFpuState(uint8_t* area);
+
+/**
+ * Loads the FPU and SSE registers from the aligned area.
+ */
+void processorRestoreFpuState(uint8_t* area);
+
+/**
+ * Fills the aligned area with the clean register state.
+ */
+void processorResetFpuState(uint8_t* area);
+
 #endif
@@ -24,15 +24,17 @@
 #include "kernel/system/interrupts/apic/apic.hpp"
 #include "kernel/system/interrupts/interrupts.hpp"
 #include "kernel/system/smp.hpp"
+#include "kernel/system/timing/tsc.hpp"
 #include "shared/panic.hpp"
 
-static int applicationCoresWaiting;
+static volatile int applicationCoresWaiting;
 static bool bspInitialized = false;
 static bool systemReady = false;
 
 void systemInitializeBsp(g_physical_address initialPdPhys)
 {
 	processorInitializeBsp();
+	tscInitialize();
 
 	acpiInitialize();
 	apicDetect();
@@ -77,7 +79,7 @@ void systemWaitForReady()
 
 void systemMarkApplicationCoreReady()
 {
-	--applicationCoresWaiting;
+	__sync_fetch_and_sub(&applicationCoresWaiting, 1);
 }
 
 void systemMarkReady()
@@ -0,0 +1,86 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/system/timing/tsc.hpp"
+#include "kernel/system/processor/processor.hpp"
+#include "kernel/system/timing/pit.hpp"
+#include "shared/logger/logger.hpp"
+
+#define G_TSC_CALIBRATION_MICROS 10000
+
+bool tscAvailable = false;
+static uint32_t tscTicksPerMicrosecond = 0;
+
+/**
+ * Divides a 64 bit value by a 32 bit value. The kernel is not linked against
+ * libgcc, so this must not use the 64 bit division helpers.
+ */
+uint64_t _tscDivide(uint64_t value, uint32_t divisor)
+{
+	uint32_t high = value >> 32;
+	uint32_t low = value & 0xFFFFFFFF;
+
+	uint32_t quotientHigh = high / divisor;
+	uint32_t remainder = high % divisor;
+
+	uint32_t quotientLow;
+	asm("divl %4"
+		: "=a"(quotientLow), "=d"(remainder)
+		: "a"(low), "d"(remainder), "rm"(divisor));
+
+	return ((uint64_t) quotientHigh << 32) | quotientLow;
+}
+
+bool tscDetect()
+{
+	tscAvailable = processorHasFeature(g_cpuid_standard_edx_feature::TSC);
+	return tscAvailable;
+}
+
+void tscInitialize()
+{
+	if(!tscDetect())
+	{
+		logWarn("%! processor has no time stamp counter, CPU times will not be measured", "tsc");
+		return;
+	}
+
+	pitPrepareSleep(G_TSC_CALIBRATION_MICROS);
+	uint64_t start = tscRead();
+	pitPerformSleep();
+	uint64_t end = tscRead();
+
+	tscTicksPerMicrosecond = _tscDivide(end - start, G_TSC_CALIBRATION_MICROS);
+	if(tscTicksPerMicrosecond == 0)
+		tscTicksPerMicrosecond = 1;
+	logInfo("%! calibrated to %i ticks per microsecond", "tsc", tscTicksPerMicrosecond);
+}
+
+uint64_t tscToMicros(uint64_t ticks)
+{
+	if(tscTicksPerMicrosecond == 0)
+		return 0;
+	return _tscDivide(ticks, tscTicksPerMicrosecond);
+}
+
+uint32_t tscGetTicksPerMicrosecond()
+{
+	return tscTicksPerMicrosecond;
+}
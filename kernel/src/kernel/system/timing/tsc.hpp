@@ -0,0 +1,68 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_TSC__
+#define __KERNEL_TSC__
+
+#include "ghost/stdint.h"
+
+extern bool tscAvailable;
+
+/**
+ * Reads the time stamp counter of the current processor. Returns 0 if the
+ * processor has no time stamp counter.
+ */
+static inline uint64_t tscRead()
+{
+	if(!tscAvailable)
+		return 0;
+
+	uint32_t low;
+	uint32_t high;
+	asm volatile("rdtsc"
+				 : "=a"(low), "=d"(high));
+	return ((uint64_t) high << 32) | low;
+}
+
+/**
+ * Checks whether the time stamp counter is available. Called at kernel entry
+ * so that early boot phases can already be timestamped.
+ *
+ * @return whether the time stamp counter is available
+ */
+bool tscDetect();
+
+/**
+ * Checks whether the time stamp counter is available and calibrates it
+ * against the PIT. Must be called before the timer is started.
+ */
+void tscInitialize();
+
+/**
+ * Converts a number of time stamp counter ticks to microseconds.
+ */
+uint64_t tscToMicros(uint64_t ticks);
+
+/**
+ * @return the number of time stamp counter ticks per microsecond
+ */
+uint32_t tscGetTicksPerMicrosecond();
+
+#endif
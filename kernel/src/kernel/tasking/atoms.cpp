@@ -20,12 +20,12 @@
 
 #include "kernel/tasking/atoms.hpp"
 #include "kernel/memory/heap.hpp"
-#include "kernel/utils/hashmap.hpp"
+#include "kernel/utils/concurrent_hashmap.hpp"
 #include "shared/logger/logger.hpp"
 
 static g_atom nextAtom;
 static g_mutex fullLock;
-static g_hashmap<g_atom, g_atom_entry*>* atomMap;
+static g_concurrent_hashmap<g_atom, g_atom_entry*>* atomMap;
 
 void _atomicSetTaskWaiting(g_atom_entry* entry, g_task* task);
 void _atomicWakeWaitingTasks(g_atom_entry* entry);
@@ -34,7 +34,7 @@ void atomicInitialize()
 {
 	mutexInitialize(&fullLock);
 	nextAtom = 0;
-	atomMap = hashmapCreateNumeric<g_atom, g_atom_entry*>(128);
+	atomMap = concurrentHashmapCreate<g_atom, g_atom_entry*>();
 }
 
 g_atom atomicCreate()
@@ -48,14 +48,14 @@ g_atom atomicCreate()
 	mutexAcquire(&fullLock);
 	g_atom atom = ++nextAtom;
 	mutexRelease(&fullLock);
-	hashmapPut(atomMap, atom, entry);
+	concurrentHashmapPut(atomMap, atom, entry);
 
 	return atom;
 }
 
 bool atomicLock(g_task* task, g_atom atom, bool isTry, bool setOnFinish)
 {
-	g_atom_entry* entry = hashmapGet<g_atom, g_atom_entry*>(atomMap, atom, nullptr);
+	g_atom_entry* entry = concurrentHashmapGet<g_atom, g_atom_entry*>(atomMap, atom, nullptr);
 	if(!entry)
 	{
 		logWarn("%! task %i tried to lock unknown atom %i", "atoms", task->id, atom);
@@ -80,7 +80,7 @@ bool atomicLock(g_task* task, g_atom atom, bool isTry, bool setOnFinish)
 
 void atomicUnlock(g_atom atom)
 {
-	g_atom_entry* entry = hashmapGet<g_atom, g_atom_entry*>(atomMap, atom, nullptr);
+	g_atom_entry* entry = concurrentHashmapGet<g_atom, g_atom_entry*>(atomMap, atom, nullptr);
 	if(!entry)
 	{
 		logWarn("%! task %i tried to unlock unknown atom %i", "atoms", taskingGetCurrentTask()->id, atom);
@@ -98,10 +98,10 @@ void atomicDestroy(g_atom atom)
 	atomicUnlock(atom);
 
 	mutexAcquire(&atomMap->lock);
-	g_atom_entry* entry = hashmapGet<g_atom, g_atom_entry*>(atomMap, atom, nullptr);
+	g_atom_entry* entry = concurrentHashmapGet<g_atom, g_atom_entry*>(atomMap, atom, nullptr);
 	if(entry)
 	{
-		hashmapRemove(atomMap, atom);
+		concurrentHashmapRemove(atomMap, atom);
 		heapFree(entry);
 	}
 	mutexRelease(&atomMap->lock);
@@ -109,7 +109,7 @@ void atomicDestroy(g_atom atom)
 
 void atomicWaitForLock(g_atom atom, g_tid task)
 {
-	g_atom_entry* entry = hashmapGet<g_atom, g_atom_entry*>(atomMap, atom, nullptr);
+	g_atom_entry* entry = concurrentHashmapGet<g_atom, g_atom_entry*>(atomMap, atom, nullptr);
 	if(!entry)
 	{
 		logWarn("%! tried to add waiter for task %i to unknown atom %i", "atoms", task, atom);
@@ -128,7 +128,7 @@ void atomicWaitForLock(g_atom atom, g_tid task)
 
 void atomicUnwaitForLock(g_atom atom, g_tid task)
 {
-	g_atom_entry* entry = hashmapGet<g_atom, g_atom_entry*>(atomMap, atom, nullptr);
+	g_atom_entry* entry = concurrentHashmapGet<g_atom, g_atom_entry*>(atomMap, atom, nullptr);
 	if(!entry)
 	{
 		logWarn("%! tried to remove waiter for task %i from unknown atom %i", "atoms", task, atom);
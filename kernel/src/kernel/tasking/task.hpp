@@ -24,7 +24,9 @@
 #include "kernel/memory/address_range_pool.hpp"
 #include "kernel/system/processor/processor_state.hpp"
 #include "shared/system/mutex.hpp"
+#include <ghost/fs.h>
 #include <ghost/kernel.h>
+#include <ghost/memory.h>
 #include <ghost/system.h>
 
 struct g_process;
@@ -85,12 +87,17 @@ struct g_task
 	g_tasking_local* assignment;
 
 	/**
-	 * Number of times this task was ever scheduled.
+	 * Number of times this task was ever scheduled, yielded and called the kernel,
+	 * and the time it spent running in user and kernel mode in time stamp counter ticks.
 	 */
 	struct
 	{
 		int timesScheduled;
 		int timesYielded;
+		int syscalls;
+
+		uint64_t userTime;
+		uint64_t kernelTime;
 	} statistics;
 
 	/**
@@ -137,6 +144,16 @@ struct g_task
 		void* data;
 	} userEntry;
 
+	/**
+	 * FPU and SSE registers while the task is not running. The state is aligned within
+	 * the allocated buffer and created when the task is first switched to.
+	 */
+	struct
+	{
+		void* buffer;
+		uint8_t* state;
+	} fpu;
+
 	/**
 	 * Only filled for VM86 tasks.
 	 */
@@ -146,6 +163,11 @@ struct g_task
 	 * List of tasks that wait for this task to die.
 	 */
 	g_wait_queue_entry* waitersJoin;
+
+	/**
+	 * Number of running inspections, the task is not destroyed until these have ended.
+	 */
+	volatile uint32_t inspections;
 };
 
 /**
@@ -201,6 +223,36 @@ struct g_memory_file_ondemand
 	g_memory_file_ondemand* next;
 };
 
+/**
+ * Memory mapping created by a process, either of a file or anonymous memory.
+ */
+struct g_memory_mapping
+{
+	g_address base;
+	uint32_t pages;
+
+	g_memory_protection protection;
+	g_memory_map_flags flags;
+
+	/**
+	 * Source node and offset for file mappings
+	 */
+	g_fs_virt_id nodeId;
+	uint64_t offset;
+
+	/**
+	 * Page faults that load a page and the removal hold a reference while they
+	 * work without the process lock. A removed mapping is freed once the last
+	 * reference is released.
+	 */
+	uint32_t references;
+	bool removed;
+
+	g_memory_mapping* next;
+};
+
+struct g_fs_io_ring;
+
 /**
  * A process groups multiple tasks.
  */
@@ -260,6 +312,25 @@ struct g_process
 	 * List of on-demand file-to-memory mappings.
 	 */
 	g_memory_file_ondemand* onDemandMappings;
+
+	/**
+	 * List of memory mappings created by the process.
+	 */
+	g_memory_mapping* memoryMappings;
+
+	/**
+	 * List of asynchronous I/O rings created by the process.
+	 */
+	g_fs_io_ring* ioRings;
+
+	/**
+	 * CPU time of tasks of this process that have already exited.
+	 */
+	struct
+	{
+		uint64_t userTime;
+		uint64_t kernelTime;
+	} statistics;
 };
 
 #endif
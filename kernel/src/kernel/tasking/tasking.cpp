@@ -21,7 +21,10 @@
 #include "kernel/tasking/tasking.hpp"
 
 #include "ghost/calls/calls.h"
+#include "kernel/debug/trace.hpp"
+#include "kernel/filesystem/filesystem_ioring.hpp"
 #include "kernel/filesystem/filesystem_process.hpp"
+#include "kernel/filesystem/filesystem_taskeddelegate.hpp"
 #include "kernel/ipc/message.hpp"
 #include "kernel/memory/gdt.hpp"
 #include "kernel/memory/memory.hpp"
@@ -30,6 +33,7 @@
 #include "kernel/system/interrupts/ivt.hpp"
 #include "kernel/system/processor/processor.hpp"
 #include "kernel/system/system.hpp"
+#include "kernel/system/timing/tsc.hpp"
 #include "kernel/tasking/cleanup.hpp"
 #include "kernel/tasking/clock.hpp"
 #include "kernel/tasking/elf/elf_loader.hpp"
@@ -37,7 +41,7 @@
 #include "kernel/tasking/tasking_directory.hpp"
 #include "kernel/tasking/tasking_memory.hpp"
 #include "kernel/tasking/tasking_state.hpp"
-#include "kernel/utils/hashmap.hpp"
+#include "kernel/utils/concurrent_hashmap.hpp"
 #include "kernel/utils/wait_queue.hpp"
 #include "shared/logger/logger.hpp"
 #include "shared/panic.hpp"
@@ -46,7 +50,13 @@ static g_tasking_local* taskingLocal = 0;
 static g_mutex taskingIdLock;
 static g_tid taskingIdNext = 0;
 
-g_hashmap<g_tid, g_task*>* taskGlobalMap;
+/**
+ * Held while a task is inspected from outside. Destroying a task waits for it before
+ * tearing anything down and removes the task from the global map while holding it.
+ */
+static g_mutex taskingInspectLock;
+
+g_concurrent_hashmap<g_tid, g_task*>* taskGlobalMap;
 
 void taskingInitializeTask(g_task* task, g_process* process, g_security_level level);
 
@@ -55,6 +65,34 @@ g_tasking_local* taskingGetLocal()
 	return &taskingLocal[processorGetCurrentId()];
 }
 
+g_tasking_local* taskingGetLocalByProcessor(uint32_t processor)
+{
+	return &taskingLocal[processor];
+}
+
+void taskingAccountTime(g_task* task, bool userMode)
+{
+	g_tasking_local* local = taskingGetLocal();
+	uint64_t now = tscRead();
+	uint64_t elapsed = now - local->statistics.lastAccounting;
+	local->statistics.lastAccounting = now;
+
+	if(!task)
+		return;
+
+	if(task == local->scheduling.idleTask)
+	{
+		local->statistics.idleTime += elapsed;
+		return;
+	}
+
+	local->statistics.busyTime += elapsed;
+	if(userMode)
+		task->statistics.userTime += elapsed;
+	else
+		task->statistics.kernelTime += elapsed;
+}
+
 g_task* taskingGetCurrentTask()
 {
 	if(!systemIsReady())
@@ -79,7 +117,26 @@ g_tid taskingGetNextId()
 
 g_task* taskingGetById(g_tid id)
 {
-	return hashmapGet(taskGlobalMap, id, (g_task*) 0);
+	return concurrentHashmapGet(taskGlobalMap, id, (g_task*) 0);
+}
+
+g_task* taskingInspectById(g_tid id)
+{
+	mutexAcquire(&taskingInspectLock);
+	g_task* task = taskingGetById(id);
+	if(task && task->status == G_THREAD_STATUS_DEAD)
+		task = nullptr;
+	if(task)
+		task->inspections++;
+	mutexRelease(&taskingInspectLock);
+	return task;
+}
+
+void taskingInspectEnd(g_task* task)
+{
+	mutexAcquire(&taskingInspectLock);
+	task->inspections--;
+	mutexRelease(&taskingInspectLock);
 }
 
 /**
@@ -122,10 +179,11 @@ void taskingExit()
 void taskingInitializeBsp()
 {
 	mutexInitialize(&taskingIdLock);
+	mutexInitialize(&taskingInspectLock);
 
 	auto numProcs = processorGetNumberOfProcessors();
 	taskingLocal = (g_tasking_local*) heapAllocate(sizeof(g_tasking_local) * numProcs);
-	taskGlobalMap = hashmapCreateNumeric<g_tid, g_task*>(128);
+	taskGlobalMap = concurrentHashmapCreate<g_tid, g_task*>();
 
 	taskingInitializeLocal();
 	taskingDirectoryInitialize();
@@ -147,6 +205,10 @@ void taskingInitializeLocal()
 	local->scheduling.list = nullptr;
 	local->scheduling.idleTask = nullptr;
 
+	local->statistics.lastAccounting = tscRead();
+	local->statistics.idleTime = 0;
+	local->statistics.busyTime = 0;
+
 	mutexInitialize(&local->lock);
 
 	g_process* idle = taskingCreateProcess();
@@ -211,6 +273,9 @@ void taskingProcessRemoveFromTaskList(g_task* task)
 		entry = entry->next;
 	}
 
+	task->process->statistics.userTime += task->statistics.userTime;
+	task->process->statistics.kernelTime += task->statistics.kernelTime;
+
 	mutexRelease(&task->process->lock);
 }
 
@@ -308,7 +373,13 @@ void taskingApplySwitch()
 void taskingSchedule()
 {
 	auto local = taskingGetLocal();
+	g_task* previous = local->scheduling.current;
 	schedulerSchedule(local);
+
+	g_task* next = local->scheduling.current;
+	if(next != previous)
+		G_TRACE(G_TRACE_EVENT_SWITCH, previous ? previous->id : -1, next->id);
+
 	taskingApplySwitch();
 }
 
@@ -349,6 +420,9 @@ void taskingDestroyProcess(g_process* process)
 	if(process->object)
 		elfObjectDestroy(process->object);
 
+	memoryMappingDestroyAll(process);
+	filesystemIoRingDestroyAll(process);
+	filesystemTaskedDelegateProcessRemoved(process);
 	filesystemProcessRemove(process->id);
 
 	taskingMemoryDestroyPageDirectory(process->pageDirectory);
@@ -377,7 +451,7 @@ g_task* taskingCreateTask(g_virtual_address eip, g_process* process, g_security_
 	taskingMemoryTemporarySwitchBack(returnDirectory);
 
 	taskingProcessAddToTaskList(process, task);
-	hashmapPut(taskGlobalMap, task->id, task);
+	concurrentHashmapPut(taskGlobalMap, task->id, task);
 
 	return task;
 }
@@ -399,7 +473,7 @@ g_task* taskingCreateTaskVm86(g_process* process, uint32_t intr, g_vm86_register
 	taskingMemoryTemporarySwitchBack(returnDirectory);
 
 	taskingProcessAddToTaskList(process, task);
-	hashmapPut(taskGlobalMap, task->id, task);
+	concurrentHashmapPut(taskGlobalMap, task->id, task);
 	return task;
 }
 
@@ -408,6 +482,17 @@ void taskingDestroyTask(g_task* task)
 	if(task->status != G_THREAD_STATUS_DEAD)
 		panic("%! tried to remove a task %i that is not dead", "tasking", task->id);
 
+	// Dead tasks can not be inspected anymore, wait for the running inspections
+	for(;;)
+	{
+		mutexAcquire(&taskingInspectLock);
+		bool inspected = task->inspections > 0;
+		mutexRelease(&taskingInspectLock);
+		if(!inspected)
+			break;
+		taskingYield();
+	}
+
 	// Wake up tasks that joined this task
 	waitQueueWake(&task->waitersJoin);
 
@@ -431,9 +516,12 @@ void taskingDestroyTask(g_task* task)
 		taskingProcessKillAllTasks(task->process->id);
 
 	// Finish cleanup
-	hashmapRemove(taskGlobalMap, task->id);
+	mutexAcquire(&taskingInspectLock);
+	concurrentHashmapRemove(taskGlobalMap, task->id);
+	mutexRelease(&taskingInspectLock);
 	if(task->vm86Data)
 		heapFree(task->vm86Data);
+	taskingStateDestroyFpu(task);
 	heapFree(task);
 }
 
@@ -448,11 +536,12 @@ void taskingInitializeTask(g_task* task, g_process* process, g_security_level le
 	task->status = G_THREAD_STATUS_RUNNING;
 	task->active = false;
 	task->waitersJoin = nullptr;
+	taskingStateCreateFpu(task);
 }
 
 void taskingProcessKillAllTasks(g_pid pid)
 {
-	g_task* task = hashmapGet<g_pid, g_task*>(taskGlobalMap, pid, 0);
+	g_task* task = concurrentHashmapGet<g_pid, g_task*>(taskGlobalMap, pid, 0);
 	if(!task)
 	{
 		logInfo("%! tried to kill non-existing process %i", "tasking", pid);
@@ -22,11 +22,11 @@
 #define __KERNEL_TASKING__
 
 #include "kernel/tasking/task.hpp"
-#include "kernel/utils/hashmap.hpp"
+#include "kernel/utils/concurrent_hashmap.hpp"
 #include <ghost/kernel.h>
 #include <ghost/system.h>
 
-extern g_hashmap<g_tid, g_task*>* taskGlobalMap;
+extern g_concurrent_hashmap<g_tid, g_task*>* taskGlobalMap;
 
 struct g_schedule_entry
 {
@@ -62,6 +62,16 @@ struct g_tasking_local
 
 		g_task* idleTask;
 	} scheduling;
+
+	/**
+	 * CPU time accounting for this processor in time stamp counter ticks.
+	 */
+	struct
+	{
+		uint64_t lastAccounting;
+		uint64_t idleTime;
+		uint64_t busyTime;
+	} statistics;
 };
 
 struct g_spawn_result
@@ -76,6 +86,19 @@ struct g_spawn_result
  */
 g_tasking_local* taskingGetLocal();
 
+/**
+ * @return the tasking structure of the given processor
+ */
+g_tasking_local* taskingGetLocalByProcessor(uint32_t processor);
+
+/**
+ * Charges the time that passed since the last accounting on this processor to
+ * the given task, either as user or as kernel time. Time spent in the idle task
+ * is counted as idle time of the processor. Called on entry and exit of the
+ * interrupt handler.
+ */
+void taskingAccountTime(g_task* task, bool userMode);
+
 /**
  * @return the task that is on this processor currently running or was
  * last running when called from within a system call handler
@@ -211,6 +234,18 @@ void taskingIdleThread();
  */
 g_task* taskingGetById(g_tid id);
 
+/**
+ * Finds a task that is not dead by its id. If found, the task and its process can not
+ * be destroyed until <taskingInspectEnd> is called. Must be used when the task is
+ * inspected from another address space.
+ */
+g_task* taskingInspectById(g_tid id);
+
+/**
+ * Ends an inspection started with <taskingInspectById>.
+ */
+void taskingInspectEnd(g_task* task);
+
 /**
  * Spawns an executable. This creates a task entering <taskingSpawnEntry> where the actual
  * binary loading happens. Makes the executing task wait for the spawn to complete.
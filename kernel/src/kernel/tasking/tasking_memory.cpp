@@ -358,3 +358,64 @@ bool taskingMemoryHandleStackOverflow(g_task* task, g_virtual_address accessed)
 	pagingMapPage(accessedPage, memoryPhysicalAllocate(), tableFlags, pageFlags);
 	return true;
 }
+
+/**
+ * Counts the present user pages in the given range of the current address space.
+ */
+uint32_t _taskingMemoryCountPresentPages(g_virtual_address start, g_virtual_address end)
+{
+	uint32_t count = 0;
+	g_page_directory directory = (g_page_directory) G_RECURSIVE_PAGE_DIRECTORY_ADDRESS;
+
+	g_virtual_address address = start;
+	while(address < end)
+	{
+		uint32_t ti = G_TABLE_IN_DIRECTORY_INDEX(address);
+		if(!(directory[ti] & G_PAGE_PRESENT))
+		{
+			address = (address & ~0x3FFFFF) + 0x400000;
+			continue;
+		}
+
+		g_page_table table = G_RECURSIVE_PAGE_TABLE(ti);
+		do
+		{
+			uint32_t pi = G_PAGE_IN_TABLE_INDEX(address);
+			if((table[pi] & G_PAGE_PRESENT) && (table[pi] & G_PAGE_USERSPACE))
+				++count;
+			address += G_PAGE_SIZE;
+		} while(address < end && (address & 0x3FFFFF));
+	}
+	return count;
+}
+
+void taskingMemoryGetUsage(g_process* process, uint32_t* outResident, uint32_t* outVirtual)
+{
+	mutexAcquire(&process->lock);
+
+	uint32_t virtualPages = G_PAGE_ALIGN_UP(process->image.end - process->image.start) / G_PAGE_SIZE + process->heap.pages;
+
+	g_physical_address returnDirectory = taskingMemoryTemporarySwitchTo(process->pageDirectory);
+
+	uint32_t residentPages = _taskingMemoryCountPresentPages(G_LOWER_MEMORY_END, G_USER_MAXIMUM_HEAP_BREAK);
+
+	mutexAcquire(&process->virtualRangePool->lock);
+	g_address_range* range = process->virtualRangePool->first;
+	while(range)
+	{
+		if(range->used)
+		{
+			virtualPages += range->pages;
+			if(!(range->flags & G_PROC_VIRTUAL_RANGE_FLAG_WEAK))
+				residentPages += _taskingMemoryCountPresentPages(range->base, range->base + range->pages * G_PAGE_SIZE);
+		}
+		range = range->next;
+	}
+	mutexRelease(&process->virtualRangePool->lock);
+
+	taskingMemoryTemporarySwitchBack(returnDirectory);
+	mutexRelease(&process->lock);
+
+	*outResident = residentPages * G_PAGE_SIZE;
+	*outVirtual = virtualPages * G_PAGE_SIZE;
+}
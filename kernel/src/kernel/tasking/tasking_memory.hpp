@@ -100,4 +100,11 @@ void taskingMemoryTemporarySwitchBack(g_physical_address pageDirectory);
  */
 bool taskingMemoryHandleStackOverflow(g_task* task, g_virtual_address accessedPage);
 
+/**
+ * Calculates the memory usage of a process. The resident size is the number of bytes that
+ * are backed by physical memory, the virtual size is the number of bytes reserved in the
+ * image, heap and virtual ranges.
+ */
+void taskingMemoryGetUsage(g_process* process, uint32_t* outResident, uint32_t* outVirtual);
+
 #endif
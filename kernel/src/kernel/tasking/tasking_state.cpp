@@ -21,6 +21,7 @@
 #include "kernel/tasking/tasking_state.hpp"
 #include "kernel/memory/gdt.hpp"
 #include "kernel/system/interrupts/ivt.hpp"
+#include "kernel/system/processor/processor.hpp"
 
 void taskingStateResetVm86(g_task* task, g_vm86_registers in, uint32_t intr)
 {
@@ -85,4 +86,30 @@ void taskingStateReset(g_task* task, g_address eip, g_security_level entryLevel)
 	}
 
 	state->eip = eip;
-}
\ No newline at end of file
+}
+
+void taskingStateCreateFpu(g_task* task)
+{
+	if(!processorHasFpuState())
+		return;
+
+	task->fpu.buffer = heapAllocate(G_FPU_STATE_SIZE + G_FPU_STATE_ALIGNMENT);
+	task->fpu.state = (uint8_t*) (((g_address) task->fpu.buffer + G_FPU_STATE_ALIGNMENT - 1) & ~(G_FPU_STATE_ALIGNMENT - 1));
+	processorResetFpuState(task->fpu.state);
+}
+
+void taskingStateSwitchFpu(g_task* previous, g_task* next)
+{
+	if(previous == next || !processorHasFpuState())
+		return;
+
+	if(previous)
+		processorSaveFpuState(previous->fpu.state);
+	processorRestoreFpuState(next->fpu.state);
+}
+
+void taskingStateDestroyFpu(g_task* task)
+{
+	if(task->fpu.buffer)
+		heapFree(task->fpu.buffer);
+}
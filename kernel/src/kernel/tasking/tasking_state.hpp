@@ -27,4 +27,22 @@ void taskingStateReset(g_task* task, g_address eip, g_security_level entryLevel)
 
 void taskingStateResetVm86(g_task* task, g_vm86_registers in, uint32_t intr);
 
+/**
+ * Creates the area that the FPU and SSE registers of the task are saved to. This can
+ * not happen on the first switch, as the heap must not be used in interrupt handlers.
+ */
+void taskingStateCreateFpu(g_task* task);
+
+/**
+ * Saves the FPU and SSE registers of the previous task and loads those of the next
+ * task when the processor switches between them. The kernel itself does not use
+ * these registers, so they still belong to the previous task at this point.
+ */
+void taskingStateSwitchFpu(g_task* previous, g_task* next);
+
+/**
+ * Frees the saved FPU and SSE registers of the task.
+ */
+void taskingStateDestroyFpu(g_task* task);
+
 #endif
@@ -0,0 +1,450 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __UTILS_CONCURRENT_HASHMAP__
+#define __UTILS_CONCURRENT_HASHMAP__
+
+#include "kernel/memory/heap.hpp"
+#include "shared/system/mutex.hpp"
+
+#include <type_traits>
+
+/**
+ * Hashmap for numeric keys that is read without taking a lock.
+ *
+ * Entries are stored with open addressing and linear probing. Writers are
+ * serialized by the map lock and increment the sequence counter before and
+ * after each modification; readers retry their lookup when the counter was odd
+ * or has changed in between (seqlock). Readers only rely on the load and store
+ * ordering of x86, so a compiler barrier is enough.
+ *
+ * The table doubles once it is half full. The entries are then moved over a
+ * few at a time with each write, so no single write pays for the whole
+ * rehash. Lookups check the new table first and then the one being migrated.
+ * Tables that were replaced are not freed before the map is destroyed, since
+ * a reader might still be looking at them; they take at most as much memory
+ * as the current table.
+ */
+#define G_CONCURRENT_HASHMAP_INITIAL_CAPACITY 16
+#define G_CONCURRENT_HASHMAP_MIGRATE_BATCH 8
+
+#define G_CONCURRENT_HASHMAP_SLOT_FREE 0
+#define G_CONCURRENT_HASHMAP_SLOT_USED 1
+#define G_CONCURRENT_HASHMAP_SLOT_MOVED 2
+
+#define G_CONCURRENT_HASHMAP_BARRIER() asm volatile("" :: \
+														: "memory")
+
+template <typename K, typename V>
+struct g_concurrent_hashmap_slot
+{
+	volatile uint8_t state;
+	K key;
+	V value;
+};
+
+template <typename K, typename V>
+struct g_concurrent_hashmap_table
+{
+	uint32_t capacity;
+	g_concurrent_hashmap_slot<K, V>* slots;
+	g_concurrent_hashmap_table* nextRetired;
+};
+
+template <typename K, typename V>
+struct g_concurrent_hashmap
+{
+	g_mutex lock;
+	volatile uint32_t sequence;
+
+	g_concurrent_hashmap_table<K, V>* volatile current;
+	g_concurrent_hashmap_table<K, V>* volatile previous;
+	uint32_t migrated;
+	g_concurrent_hashmap_table<K, V>* retired;
+
+	uint32_t count;
+};
+
+template <typename K>
+uint32_t _concurrentHashmapHash(K key)
+{
+	uint64_t value = (uint64_t) key;
+	uint32_t hash = ((uint32_t) value ^ (uint32_t) (value >> 32)) * 0x9E3779B1;
+	return hash ^ (hash >> 16);
+}
+
+template <typename K, typename V>
+g_concurrent_hashmap_table<K, V>* _concurrentHashmapCreateTable(uint32_t capacity)
+{
+	auto table = (g_concurrent_hashmap_table<K, V>*) heapAllocate(sizeof(g_concurrent_hashmap_table<K, V>));
+	table->capacity = capacity;
+	table->slots = (g_concurrent_hashmap_slot<K, V>*) heapAllocateClear(sizeof(g_concurrent_hashmap_slot<K, V>) * capacity);
+	table->nextRetired = 0;
+	return table;
+}
+
+template <typename K, typename V>
+void _concurrentHashmapFreeTable(g_concurrent_hashmap_table<K, V>* table)
+{
+	heapFree(table->slots);
+	heapFree(table);
+}
+
+/**
+ * Looks for the slot of the key. The number of probes is bounded, so this
+ * terminates even if a writer changes the table concurrently.
+ */
+template <typename K, typename V>
+g_concurrent_hashmap_slot<K, V>* _concurrentHashmapFind(g_concurrent_hashmap_table<K, V>* table, K key)
+{
+	uint32_t capacity = table->capacity;
+	uint32_t mask = capacity - 1;
+	uint32_t index = _concurrentHashmapHash(key) & mask;
+	for(uint32_t probes = 0; probes < capacity; probes++)
+	{
+		auto slot = &table->slots[index];
+		uint8_t state = slot->state;
+		if(state == G_CONCURRENT_HASHMAP_SLOT_FREE)
+			return 0;
+		if(state == G_CONCURRENT_HASHMAP_SLOT_USED && slot->key == key)
+			return slot;
+		index = (index + 1) & mask;
+	}
+	return 0;
+}
+
+template <typename K, typename V>
+void _concurrentHashmapInsert(g_concurrent_hashmap_table<K, V>* table, K key, V value)
+{
+	uint32_t mask = table->capacity - 1;
+	uint32_t index = _concurrentHashmapHash(key) & mask;
+	while(table->slots[index].state == G_CONCURRENT_HASHMAP_SLOT_USED)
+		index = (index + 1) & mask;
+
+	auto slot = &table->slots[index];
+	slot->key = key;
+	slot->value = value;
+	slot->state = G_CONCURRENT_HASHMAP_SLOT_USED;
+}
+
+/**
+ * Removes the slot from the current table and shifts the following entries of
+ * the probe sequence back, so that no tombstones are needed.
+ */
+template <typename K, typename V>
+void _concurrentHashmapDelete(g_concurrent_hashmap_table<K, V>* table, g_concurrent_hashmap_slot<K, V>* slot)
+{
+	uint32_t mask = table->capacity - 1;
+	uint32_t hole = slot - table->slots;
+	uint32_t next = (hole + 1) & mask;
+	while(table->slots[next].state == G_CONCURRENT_HASHMAP_SLOT_USED)
+	{
+		uint32_t home = _concurrentHashmapHash(table->slots[next].key) & mask;
+		if(((next - home) & mask) >= ((next - hole) & mask))
+		{
+			table->slots[hole].key = table->slots[next].key;
+			table->slots[hole].value = table->slots[next].value;
+			hole = next;
+		}
+		next = (next + 1) & mask;
+	}
+	table->slots[hole].state = G_CONCURRENT_HASHMAP_SLOT_FREE;
+}
+
+template <typename K, typename V>
+void _concurrentHashmapWriteBegin(g_concurrent_hashmap<K, V>* map)
+{
+	map->sequence++;
+	G_CONCURRENT_HASHMAP_BARRIER();
+}
+
+template <typename K, typename V>
+void _concurrentHashmapWriteEnd(g_concurrent_hashmap<K, V>* map)
+{
+	G_CONCURRENT_HASHMAP_BARRIER();
+	map->sequence++;
+}
+
+/**
+ * Moves the next batch of entries from the table being migrated to the current
+ * table. Once all are moved, the old table is retired.
+ */
+template <typename K, typename V>
+void _concurrentHashmapMigrate(g_concurrent_hashmap<K, V>* map)
+{
+	auto previous = map->previous;
+	if(!previous)
+		return;
+
+	for(int i = 0; i < G_CONCURRENT_HASHMAP_MIGRATE_BATCH && map->migrated < previous->capacity; i++)
+	{
+		auto slot = &previous->slots[map->migrated++];
+		if(slot->state != G_CONCURRENT_HASHMAP_SLOT_USED)
+			continue;
+
+		_concurrentHashmapInsert(map->current, slot->key, slot->value);
+		slot->state = G_CONCURRENT_HASHMAP_SLOT_MOVED;
+	}
+
+	if(map->migrated == previous->capacity)
+	{
+		map->previous = 0;
+		previous->nextRetired = map->retired;
+		map->retired = previous;
+	}
+}
+
+template <typename K, typename V>
+void _concurrentHashmapGrowIfNeeded(g_concurrent_hashmap<K, V>* map)
+{
+	if((map->count + 1) * 2 <= map->current->capacity)
+		return;
+
+	while(map->previous)
+		_concurrentHashmapMigrate(map);
+
+	map->previous = map->current;
+	map->migrated = 0;
+	map->current = _concurrentHashmapCreateTable<K, V>(map->current->capacity * 2);
+}
+
+template <typename K, typename V, typename = typename std::enable_if<std::is_arithmetic<K>::value, K>::type>
+g_concurrent_hashmap<K, V>* concurrentHashmapCreate()
+{
+	auto map = (g_concurrent_hashmap<K, V>*) heapAllocate(sizeof(g_concurrent_hashmap<K, V>));
+	mutexInitialize(&map->lock);
+	map->sequence = 0;
+	map->current = _concurrentHashmapCreateTable<K, V>(G_CONCURRENT_HASHMAP_INITIAL_CAPACITY);
+	map->previous = 0;
+	map->migrated = 0;
+	map->retired = 0;
+	map->count = 0;
+	return map;
+}
+
+template <typename K, typename V>
+void concurrentHashmapDestroy(g_concurrent_hashmap<K, V>* map)
+{
+	_concurrentHashmapFreeTable(map->current);
+	if(map->previous)
+		_concurrentHashmapFreeTable(map->previous);
+
+	auto retired = map->retired;
+	while(retired)
+	{
+		auto next = retired->nextRetired;
+		_concurrentHashmapFreeTable(retired);
+		retired = next;
+	}
+	heapFree(map);
+}
+
+/**
+ * Looks up the value for a key without locking the map.
+ */
+template <typename K, typename V>
+V concurrentHashmapGet(g_concurrent_hashmap<K, V>* map, K key, V def)
+{
+	for(;;)
+	{
+		uint32_t sequence = map->sequence;
+		if(sequence & 1)
+		{
+			asm volatile("pause");
+			continue;
+		}
+		G_CONCURRENT_HASHMAP_BARRIER();
+
+		V value = def;
+		auto slot = _concurrentHashmapFind(map->current, key);
+		if(!slot)
+		{
+			auto previous = map->previous;
+			if(previous)
+				slot = _concurrentHashmapFind(previous, key);
+		}
+		if(slot)
+			value = slot->value;
+
+		G_CONCURRENT_HASHMAP_BARRIER();
+		if(map->sequence == sequence)
+			return value;
+	}
+}
+
+/**
+ * Inserts the value or replaces the existing value for the key.
+ */
+template <typename K, typename V>
+void concurrentHashmapPut(g_concurrent_hashmap<K, V>* map, K key, V value)
+{
+	mutexAcquire(&map->lock);
+	_concurrentHashmapWriteBegin(map);
+
+	_concurrentHashmapMigrate(map);
+
+	auto slot = _concurrentHashmapFind(map->current, key);
+	if(slot)
+	{
+		slot->value = value;
+	}
+	else
+	{
+		auto previous = map->previous ? _concurrentHashmapFind(map->previous, key) : 0;
+		if(previous)
+		{
+			previous->state = G_CONCURRENT_HASHMAP_SLOT_MOVED;
+			_concurrentHashmapInsert(map->current, key, value);
+		}
+		else
+		{
+			_concurrentHashmapGrowIfNeeded(map);
+			_concurrentHashmapInsert(map->current, key, value);
+			map->count++;
+		}
+	}
+
+	_concurrentHashmapWriteEnd(map);
+	mutexRelease(&map->lock);
+}
+
+/**
+ * Inserts the value unless the key already exists.
+ *
+ * @return the value that is stored for the key afterwards
+ */
+template <typename K, typename V>
+V concurrentHashmapPutIfAbsent(g_concurrent_hashmap<K, V>* map, K key, V value)
+{
+	mutexAcquire(&map->lock);
+
+	auto slot = _concurrentHashmapFind(map->current, key);
+	if(!slot && map->previous)
+		slot = _concurrentHashmapFind(map->previous, key);
+
+	if(slot)
+		value = slot->value;
+	else
+		concurrentHashmapPut(map, key, value);
+
+	mutexRelease(&map->lock);
+	return value;
+}
+
+template <typename K, typename V>
+void concurrentHashmapRemove(g_concurrent_hashmap<K, V>* map, K key)
+{
+	mutexAcquire(&map->lock);
+	_concurrentHashmapWriteBegin(map);
+
+	_concurrentHashmapMigrate(map);
+
+	auto slot = _concurrentHashmapFind(map->current, key);
+	if(slot)
+	{
+		_concurrentHashmapDelete(map->current, slot);
+		map->count--;
+	}
+	else if(map->previous)
+	{
+		slot = _concurrentHashmapFind(map->previous, key);
+		if(slot)
+		{
+			slot->state = G_CONCURRENT_HASHMAP_SLOT_MOVED;
+			map->count--;
+		}
+	}
+
+	_concurrentHashmapWriteEnd(map);
+	mutexRelease(&map->lock);
+}
+
+template <typename K, typename V>
+uint32_t concurrentHashmapSize(g_concurrent_hashmap<K, V>* map)
+{
+	return map->count;
+}
+
+template <typename K, typename V>
+struct g_concurrent_hashmap_iterator
+{
+	g_concurrent_hashmap<K, V>* map;
+	g_concurrent_hashmap_table<K, V>* table;
+	uint32_t position;
+};
+
+template <typename K, typename V>
+void _concurrentHashmapIteratorSkip(g_concurrent_hashmap_iterator<K, V>* iter)
+{
+	while(iter->table)
+	{
+		while(iter->position < iter->table->capacity)
+		{
+			if(iter->table->slots[iter->position].state == G_CONCURRENT_HASHMAP_SLOT_USED)
+				return;
+			iter->position++;
+		}
+
+		iter->table = iter->table == iter->map->current ? iter->map->previous : 0;
+		iter->position = 0;
+	}
+}
+
+/**
+ * Starts an iterator on the map. Writers are blocked until <concurrentHashmapIteratorEnd>
+ * is called, readers are not.
+ */
+template <typename K, typename V>
+g_concurrent_hashmap_iterator<K, V> concurrentHashmapIteratorStart(g_concurrent_hashmap<K, V>* map)
+{
+	mutexAcquire(&map->lock);
+
+	g_concurrent_hashmap_iterator<K, V> iter;
+	iter.map = map;
+	iter.table = map->current;
+	iter.position = 0;
+	_concurrentHashmapIteratorSkip(&iter);
+	return iter;
+}
+
+template <typename K, typename V>
+bool concurrentHashmapIteratorHasNext(g_concurrent_hashmap_iterator<K, V>* iter)
+{
+	return iter->table != 0;
+}
+
+template <typename K, typename V>
+g_concurrent_hashmap_slot<K, V>* concurrentHashmapIteratorNext(g_concurrent_hashmap_iterator<K, V>* iter)
+{
+	if(!iter->table)
+		return 0;
+
+	auto slot = &iter->table->slots[iter->position++];
+	_concurrentHashmapIteratorSkip(iter);
+	return slot;
+}
+
+template <typename K, typename V>
+void concurrentHashmapIteratorEnd(g_concurrent_hashmap_iterator<K, V>* iter)
+{
+	mutexRelease(&iter->map->lock);
+}
+
+#endif
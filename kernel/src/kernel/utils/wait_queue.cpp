@@ -19,10 +19,17 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "kernel/utils/wait_queue.hpp"
+#include "kernel/debug/trace.hpp"
 #include "kernel/memory/heap.hpp"
 
 void waitQueueAdd(g_wait_queue_entry** queue, g_tid task)
 {
+	for(g_wait_queue_entry* existing = *queue; existing; existing = existing->next)
+	{
+		if(existing->task == task)
+			return;
+	}
+
 	g_wait_queue_entry* waiter = (g_wait_queue_entry*) heapAllocate(sizeof(g_wait_queue_entry));
 	waiter->task = task;
 	waiter->next = *queue;
@@ -58,7 +65,10 @@ void waitQueueWake(g_wait_queue_entry** queue)
 	{
 		g_task* task = taskingGetById(waiter->task);
 		if(task && task->status == G_THREAD_STATUS_WAITING)
+		{
 			task->status = G_THREAD_STATUS_RUNNING;
+			G_TRACE(G_TRACE_EVENT_WAKE, task->id, 0);
+		}
 
 		auto next = waiter->next;
 		heapFree(waiter);
@@ -30,7 +30,7 @@ struct g_wait_queue_entry
 };
 
 /**
- * Adds a task entry to the given wait queue.
+ * Adds a task entry to the given wait queue, unless the task is already waiting in it.
  */
 void waitQueueAdd(g_wait_queue_entry** queue, g_tid task);
 
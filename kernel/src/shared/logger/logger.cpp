@@ -31,6 +31,23 @@ static const uint32_t LOGGER_HEADER_WIDTH = 10;
 static bool logSerial = false;
 static bool logVideo = G_VIDEO_LOG_BOOT;
 
+volatile g_log_level loggerLevel = G_LOG_LEVEL_DEFAULT;
+
+/**
+ * Target of the formatting functions, either the outputs or a buffer.
+ */
+struct g_logger_writer
+{
+	char* buffer;
+	uint32_t capacity;
+	uint32_t length;
+};
+
+static void _loggerWriteCharacter(g_logger_writer* writer, char c);
+static void _loggerWritePlain(g_logger_writer* writer, const char* message);
+static void _loggerWriteNumber(g_logger_writer* writer, uint32_t number, uint16_t base);
+static void _loggerWriteFormatted(g_logger_writer* writer, const char* message, va_list valist);
+
 void loggerEnableSerial(bool serial)
 {
 	logSerial = serial;
@@ -41,7 +58,29 @@ void loggerEnableVideo(bool video)
 	logVideo = video;
 }
 
-void loggerPrintFormatted(const char* message_const, va_list valist)
+void loggerSetLevel(g_log_level level)
+{
+	if(level <= G_LOG_LEVEL_NONE)
+		loggerLevel = level;
+}
+
+void loggerPrintFormatted(const char* message, va_list valist)
+{
+	_loggerWriteFormatted(nullptr, message, valist);
+}
+
+uint32_t loggerFormat(char* buffer, uint32_t capacity, const char* message, va_list valist)
+{
+	g_logger_writer writer;
+	writer.buffer = buffer;
+	writer.capacity = capacity;
+	writer.length = 0;
+	_loggerWriteFormatted(&writer, message, valist);
+	buffer[writer.length] = 0;
+	return writer.length;
+}
+
+void _loggerWriteFormatted(g_logger_writer* writer, const char* message_const, va_list valist)
 {
 	char* message = (char*) message_const;
 
@@ -52,7 +91,7 @@ void loggerPrintFormatted(const char* message_const, va_list valist)
 	{
 		if(*message != '%')
 		{
-			loggerPrintCharacter(*message);
+			_loggerWriteCharacter(writer, *message);
 			++message;
 			continue;
 		}
@@ -61,35 +100,35 @@ void loggerPrintFormatted(const char* message_const, va_list valist)
 		if(*message == 'i')
 		{ // integer
 			int32_t val = va_arg(valist, int32_t);
-			loggerPrintNumber(val, 10);
+			_loggerWriteNumber(writer, val, 10);
 		}
 		else if(*message == 'h' || *message == 'x')
 		{ // positive hex number
 			uint32_t val = va_arg(valist, uint32_t);
-			loggerPrintPlain("0x");
-			loggerPrintNumber(val, 16);
+			_loggerWritePlain(writer, "0x");
+			_loggerWriteNumber(writer, val, 16);
 		}
 		else if(*message == 'b')
 		{ // boolean
 			uint32_t val = va_arg(valist, uint32_t);
-			loggerPrintPlain("0b");
-			loggerPrintNumber(val, 2);
+			_loggerWritePlain(writer, "0b");
+			_loggerWriteNumber(writer, val, 2);
 		}
 		else if(*message == 'c')
 		{ // char
 			int val = va_arg(valist, int);
-			loggerPrintCharacter((char) val);
+			_loggerWriteCharacter(writer, (char) val);
 		}
 		else if(*message == 's')
 		{ // string
 			char* val = va_arg(valist, char*);
-			loggerPrintPlain(val);
+			_loggerWritePlain(writer, val);
 		}
 		else if(*message == '#')
 		{ // indented printing
 			for(uint32_t i = 0; i < LOGGER_HEADER_WIDTH + 3; i++)
 			{
-				loggerPrintCharacter(' ');
+				_loggerWriteCharacter(writer, ' ');
 			}
 		}
 		else if(*message == '!')
@@ -101,18 +140,21 @@ void loggerPrintFormatted(const char* message_const, va_list valist)
 			{
 				for(uint32_t i = 0; i < LOGGER_HEADER_WIDTH - headerlen; i++)
 				{
-					loggerPrintCharacter(' ');
+					_loggerWriteCharacter(writer, ' ');
 				}
 			}
 
-			consoleVideoSetColor(headerColor);
-			loggerPrintPlain(val);
-			consoleVideoSetColor(0x0F);
-			loggerPrintCharacter(' ');
+			// Colors only apply to direct output
+			if(!writer)
+				consoleVideoSetColor(headerColor);
+			_loggerWritePlain(writer, val);
+			if(!writer)
+				consoleVideoSetColor(0x0F);
+			_loggerWriteCharacter(writer, ' ');
 		}
 		else if(*message == '%')
 		{ // escaped %
-			loggerPrintCharacter(*message);
+			_loggerWriteCharacter(writer, *message);
 		}
 		else if(*message == '*')
 		{ // header color change
@@ -123,6 +165,11 @@ void loggerPrintFormatted(const char* message_const, va_list valist)
 }
 
 void loggerPrintNumber(uint32_t number, uint16_t base)
+{
+	_loggerWriteNumber(nullptr, number, base);
+}
+
+void _loggerWriteNumber(g_logger_writer* writer, uint32_t number, uint16_t base)
 {
 
 	// Remember if negative
@@ -170,17 +217,35 @@ void loggerPrintNumber(uint32_t number, uint16_t base)
 	// Print number
 	if(negative)
 	{
-		loggerPrintCharacter('-');
+		_loggerWriteCharacter(writer, '-');
 	}
-	loggerPrintPlain(buf);
+	_loggerWritePlain(writer, buf);
 }
 
-void loggerPrintPlain(const char* message_const)
+void loggerPrintPlain(const char* message)
+{
+	_loggerWritePlain(nullptr, message);
+}
+
+void _loggerWritePlain(g_logger_writer* writer, const char* message_const)
 {
 	char* message = (char*) message_const;
 	while(*message)
 	{
-		loggerPrintCharacter(*message++);
+		_loggerWriteCharacter(writer, *message++);
+	}
+}
+
+void _loggerWriteCharacter(g_logger_writer* writer, char c)
+{
+	if(!writer)
+	{
+		loggerPrintCharacter(c);
+	}
+	else if(writer->length + 1 < writer->capacity)
+	{
+		// Leaves space for the terminating null
+		writer->buffer[writer->length++] = c;
 	}
 }
 
@@ -25,13 +25,26 @@
 void bitmapPageAllocatorInitialize(g_bitmap_page_allocator* allocator, g_bitmap_header* bitmapArray)
 {
 	allocator->bitmapArray = bitmapArray;
+	allocator->totalPageCount = 0;
 	allocator->freePageCount = 0;
 
 	g_bitmap_header* bitmap = bitmapArray;
 	while(bitmap)
 	{
 		mutexInitialize(&bitmap->lock);
-		allocator->freePageCount += bitmap->entryCount * G_BITMAP_PAGES_PER_ENTRY;
+		allocator->totalPageCount += bitmap->entryCount * G_BITMAP_PAGES_PER_ENTRY;
+
+		for(uint32_t i = 0; i < bitmap->entryCount; i++)
+		{
+			if(G_BITMAP_ENTRIES(bitmap)[i] == G_BITMAP_ENTRY_FULL)
+				continue;
+
+			for(uint32_t b = 0; b < G_BITMAP_PAGES_PER_ENTRY; b++)
+			{
+				if(!G_BITMAP_IS_SET(bitmap, i, b))
+					++allocator->freePageCount;
+			}
+		}
 		bitmap = G_BITMAP_NEXT(bitmap);
 	}
 }
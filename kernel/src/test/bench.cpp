@@ -0,0 +1,238 @@
+#include "test/bench.hpp"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+// Minimum duration of a single sample, the iteration count is doubled until reached
+#define BENCH_SAMPLE_MIN_NS 5000000ull
+#define BENCH_ITERATIONS_MAX (1ull << 30)
+#define BENCH_DEFAULT_SAMPLES 15
+#define BENCH_DEFAULT_THRESHOLD 10.0
+#define BENCH_NAME_MAX 64
+
+struct bench_entry_t
+{
+	void (*bench)(bench_t*);
+	const char* name;
+	bench_entry_t* next;
+};
+
+struct bench_result_t
+{
+	char name[BENCH_NAME_MAX];
+	double median;
+	double min;
+	double mean;
+	double deviation;
+};
+
+static bench_entry_t* benchmarks = 0;
+static bench_entry_t* benchmarksLast = 0;
+
+void benchAdd(const char* name, void (*func)(bench_t*))
+{
+	// Keep declaration order so that the output is stable
+	bench_entry_t* n = (bench_entry_t*) malloc(sizeof(bench_entry_t));
+	n->bench = func;
+	n->name = name;
+	n->next = 0;
+	if(benchmarksLast)
+		benchmarksLast->next = n;
+	else
+		benchmarks = n;
+	benchmarksLast = n;
+}
+
+uint64_t benchNow()
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t) time.tv_sec * 1000000000ull + time.tv_nsec;
+}
+
+/**
+ * Runs the benchmark once and returns the nanoseconds per iteration.
+ */
+static double benchRun(bench_entry_t* entry, uint64_t iterations)
+{
+	bench_t bench;
+	bench.iterations = iterations;
+	bench.started = 0;
+	bench.elapsed = 0;
+	entry->bench(&bench);
+	return (double) bench.elapsed / iterations;
+}
+
+static int benchCompareDouble(const void* a, const void* b)
+{
+	double da = *(const double*) a;
+	double db = *(const double*) b;
+	return da < db ? -1 : (da > db ? 1 : 0);
+}
+
+static void benchMeasure(bench_entry_t* entry, int sampleCount, bench_result_t* out)
+{
+	// Find an iteration count that makes each sample long enough to be measurable
+	uint64_t iterations = 1;
+	while(iterations < BENCH_ITERATIONS_MAX && benchRun(entry, iterations) * iterations < BENCH_SAMPLE_MIN_NS)
+		iterations *= 2;
+
+	double* samples = (double*) malloc(sizeof(double) * sampleCount);
+	for(int i = 0; i < sampleCount; i++)
+		samples[i] = benchRun(entry, iterations);
+	qsort(samples, sampleCount, sizeof(double), benchCompareDouble);
+
+	double sum = 0;
+	for(int i = 0; i < sampleCount; i++)
+		sum += samples[i];
+	double mean = sum / sampleCount;
+
+	double variance = 0;
+	for(int i = 0; i < sampleCount; i++)
+		variance += (samples[i] - mean) * (samples[i] - mean);
+
+	snprintf(out->name, BENCH_NAME_MAX, "%s", entry->name);
+	out->median = (sampleCount % 2) ? samples[sampleCount / 2] : (samples[sampleCount / 2 - 1] + samples[sampleCount / 2]) / 2;
+	out->min = samples[0];
+	out->mean = mean;
+	out->deviation = sampleCount > 1 ? sqrt(variance / (sampleCount - 1)) : 0;
+	free(samples);
+}
+
+/**
+ * Looks up the median of a benchmark in a baseline file of "<name> <median>" lines.
+ */
+static bool benchBaselineGet(FILE* baseline, const char* name, double* out)
+{
+	rewind(baseline);
+
+	char lineName[BENCH_NAME_MAX];
+	double value;
+	while(fscanf(baseline, "%63s %lf", lineName, &value) == 2)
+	{
+		if(strcmp(lineName, name) == 0)
+		{
+			*out = value;
+			return true;
+		}
+	}
+	return false;
+}
+
+static void benchPinToProcessor()
+{
+#ifdef __linux__
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(0, &set);
+	sched_setaffinity(0, sizeof(set), &set);
+#endif
+}
+
+/**
+ * Runs all benchmarks that start with the filter. Results are printed as
+ * nanoseconds per iteration; with a baseline each median is compared against
+ * the stored one and a slowdown above the threshold counts as regression.
+ *
+ *   --bench [filter] [--samples n] [--save file] [--baseline file] [--threshold percent]
+ */
+int benchMain(int argc, const char** argv)
+{
+	const char* only = nullptr;
+	const char* savePath = nullptr;
+	const char* baselinePath = nullptr;
+	int sampleCount = BENCH_DEFAULT_SAMPLES;
+	double threshold = BENCH_DEFAULT_THRESHOLD;
+
+	for(int i = 0; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+			sampleCount = atoi(argv[++i]);
+		else if(strcmp(argv[i], "--save") == 0 && i + 1 < argc)
+			savePath = argv[++i];
+		else if(strcmp(argv[i], "--baseline") == 0 && i + 1 < argc)
+			baselinePath = argv[++i];
+		else if(strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+			threshold = atof(argv[++i]);
+		else
+			only = argv[i];
+	}
+	if(sampleCount < 1)
+		sampleCount = 1;
+
+	FILE* baseline = nullptr;
+	if(baselinePath)
+	{
+		baseline = fopen(baselinePath, "r");
+		if(!baseline)
+		{
+			fprintf(stderr, "failed to open baseline %s\n", baselinePath);
+			return 1;
+		}
+	}
+
+	FILE* save = nullptr;
+	if(savePath)
+	{
+		save = fopen(savePath, "w");
+		if(!save)
+		{
+			fprintf(stderr, "failed to open %s for writing\n", savePath);
+			return 1;
+		}
+	}
+
+	benchPinToProcessor();
+
+	printf("%-36s %12s %12s %12s %8s", "benchmark", "median ns", "min ns", "mean ns", "stddev");
+	if(baseline)
+		printf(" %12s %8s", "baseline ns", "change");
+	printf("\n");
+
+	int regressions = 0;
+	for(bench_entry_t* entry = benchmarks; entry; entry = entry->next)
+	{
+		if(only != nullptr && strstr(entry->name, only) != entry->name)
+			continue;
+
+		bench_result_t result;
+		benchMeasure(entry, sampleCount, &result);
+
+		double deviationPercent = result.mean > 0 ? result.deviation * 100 / result.mean : 0;
+		printf("%-36s %12.1f %12.1f %12.1f %7.1f%%", result.name, result.median, result.min, result.mean, deviationPercent);
+
+		double base;
+		if(baseline && benchBaselineGet(baseline, result.name, &base))
+		{
+			double change = base > 0 ? (result.median - base) * 100 / base : 0;
+			printf(" %12.1f %+7.1f%%", base, change);
+			if(change > threshold)
+			{
+				printf(" \e[1;31mregression\e[0m");
+				++regressions;
+			}
+		}
+		printf("\n");
+		fflush(stdout);
+
+		if(save)
+			fprintf(save, "%s %.1f\n", result.name, result.median);
+	}
+
+	if(save)
+		fclose(save);
+	if(baseline)
+		fclose(baseline);
+
+	if(regressions)
+	{
+		printf("%i benchmarks regressed by more than %.1f%%\n", regressions, threshold);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,62 @@
+#ifndef __TEST_BENCH__
+#define __TEST_BENCH__
+
+#include <stdint.h>
+
+/**
+ * State of a single benchmark run. The benchmark performs "iterations" operations
+ * and only the time between {benchStart} and {benchStop} is counted, so setup and
+ * teardown can be excluded.
+ */
+struct bench_t
+{
+	uint64_t iterations;
+	uint64_t started;
+	uint64_t elapsed;
+};
+
+void benchAdd(const char* name, void (*func)(bench_t*));
+
+int benchMain(int argc, const char** argv);
+
+/**
+ * @return a monotonic timestamp in nanoseconds
+ */
+uint64_t benchNow();
+
+static inline void benchStart(bench_t* bench)
+{
+	bench->started = benchNow();
+}
+
+static inline void benchStop(bench_t* bench)
+{
+	bench->elapsed += benchNow() - bench->started;
+}
+
+/**
+ * Keeps the compiler from optimizing away a computed value.
+ */
+template <typename T>
+static inline void benchKeep(const T& value)
+{
+	asm volatile(""
+				 :
+				 : "g"(&value)
+				 : "memory");
+}
+
+#define BENCHMARK(name, description)   \
+	void name(bench_t* bench);         \
+	class name##BenchAdder             \
+	{                                  \
+	  public:                          \
+		name##BenchAdder()             \
+		{                              \
+			benchAdd(#name, name);     \
+		}                              \
+	};                                 \
+	name##BenchAdder name##BenchAdder; \
+	void name(bench_t* bench)
+
+#endif
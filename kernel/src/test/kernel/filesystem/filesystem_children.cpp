@@ -0,0 +1,130 @@
+#include "test/test.hpp"
+#include "test/bench.hpp"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Test unit
+#include "kernel/filesystem/filesystem_children.cpp"
+#include "shared/memory/memory.cpp"
+
+static g_fs_node* childrenTestNode(uint32_t i)
+{
+	return (g_fs_node*) (uintptr_t) (i + 1);
+}
+
+static char** childrenTestFill(g_fs_node_children* children, uint32_t count)
+{
+	memset(children, 0, sizeof(g_fs_node_children));
+	char** names = (char**) malloc(sizeof(char*) * count);
+	for(uint32_t i = 0; i < count; i++)
+	{
+		names[i] = (char*) malloc(16);
+		snprintf(names[i], 16, "entry-%u", i);
+		filesystemChildrenAdd(children, childrenTestNode(i), names[i]);
+	}
+	return names;
+}
+
+TEST(filesystemChildrenFind, "Find children with and without index")
+{
+	uint32_t counts[] = {3, 8, 100};
+	for(uint32_t count : counts)
+	{
+		g_fs_node_children children;
+		char** names = childrenTestFill(&children, count);
+
+		ASSERT_EQUALS(count, children.count);
+		ASSERT_EQUALS(count >= G_FS_CHILDREN_INDEX_THRESHOLD, children.buckets != nullptr);
+		for(uint32_t i = 0; i < count; i++)
+			ASSERT_EQUALS(childrenTestNode(i), filesystemChildrenFind(&children, names[i]));
+		ASSERT_EQUALS((g_fs_node*) nullptr, filesystemChildrenFind(&children, "missing"));
+	}
+}
+
+TEST(filesystemChildrenGet, "Iterate children in insertion order")
+{
+	g_fs_node_children children;
+	childrenTestFill(&children, 50);
+
+	for(uint32_t i = 0; i < 50; i++)
+		ASSERT_EQUALS(childrenTestNode(i), filesystemChildrenGet(&children, i));
+	ASSERT_EQUALS((g_fs_node*) nullptr, filesystemChildrenGet(&children, 50));
+
+	// Random access and restarting behind the cursor
+	ASSERT_EQUALS(childrenTestNode(20), filesystemChildrenGet(&children, 20));
+	ASSERT_EQUALS(childrenTestNode(3), filesystemChildrenGet(&children, 3));
+	ASSERT_EQUALS(childrenTestNode(3), filesystemChildrenGet(&children, 3));
+
+	// Entries added while iterating are visible
+	filesystemChildrenAdd(&children, childrenTestNode(50), "late");
+	ASSERT_EQUALS(childrenTestNode(50), filesystemChildrenGet(&children, 50));
+}
+
+TEST(filesystemChildrenRemove, "Remove children with and without index")
+{
+	uint32_t counts[] = {4, 100};
+	for(uint32_t count : counts)
+	{
+		g_fs_node_children children;
+		char** names = childrenTestFill(&children, count);
+
+		// Remove every even entry and the last one
+		filesystemChildrenGet(&children, count - 1);
+		for(uint32_t i = 0; i < count; i += 2)
+			ASSERT_EQUALS(true, filesystemChildrenRemove(&children, childrenTestNode(i), names[i]));
+		ASSERT_EQUALS(true, filesystemChildrenRemove(&children, childrenTestNode(count - 1), names[count - 1]));
+		ASSERT_EQUALS(false, filesystemChildrenRemove(&children, childrenTestNode(0), names[0]));
+
+		uint32_t remaining = count / 2 - 1;
+		ASSERT_EQUALS(remaining, children.count);
+		for(uint32_t i = 0; i < count; i++)
+		{
+			bool removed = i % 2 == 0 || i == count - 1;
+			ASSERT_EQUALS(removed ? (g_fs_node*) nullptr : childrenTestNode(i), filesystemChildrenFind(&children, names[i]));
+		}
+
+		// Order of the remaining entries is kept
+		for(uint32_t i = 0; i < remaining; i++)
+			ASSERT_EQUALS(childrenTestNode(i * 2 + 1), filesystemChildrenGet(&children, i));
+		ASSERT_EQUALS((g_fs_node*) nullptr, filesystemChildrenGet(&children, remaining));
+
+		// Removed names can be added again
+		filesystemChildrenAdd(&children, childrenTestNode(0), names[0]);
+		ASSERT_EQUALS(childrenTestNode(0), filesystemChildrenFind(&children, names[0]));
+		ASSERT_EQUALS(childrenTestNode(0), filesystemChildrenGet(&children, remaining));
+	}
+}
+
+static void childrenBenchFind(bench_t* bench, uint32_t count)
+{
+	g_fs_node_children children;
+	char** names = childrenTestFill(&children, count);
+
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i++)
+		benchKeep(filesystemChildrenFind(&children, names[i % count]));
+	benchStop(bench);
+}
+
+BENCHMARK(filesystemChildrenFindSmall, "Lookup in a folder of 10 children")
+{
+	childrenBenchFind(bench, 10);
+}
+
+BENCHMARK(filesystemChildrenFindLarge, "Lookup in a folder of 10000 children")
+{
+	childrenBenchFind(bench, 10000);
+}
+
+BENCHMARK(filesystemChildrenList, "Listing a folder of 10000 children by position")
+{
+	g_fs_node_children children;
+	childrenTestFill(&children, 10000);
+
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i++)
+		benchKeep(filesystemChildrenGet(&children, i % 10000));
+	benchStop(bench);
+}
@@ -0,0 +1,205 @@
+#include "test/test.hpp"
+#include "test/bench.hpp"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+// Test unit
+#include "kernel/filesystem/ramdisk.cpp"
+
+g_address_range_pool* memoryVirtualRangePool;
+
+g_physical_address pagingVirtualToPhysical(g_virtual_address addr)
+{
+	return addr;
+}
+
+bool pagingMapPage(g_virtual_address virt, g_physical_address phys, uint32_t tableFlags, uint32_t pageFlags, bool allowOverride)
+{
+	return true;
+}
+
+#define RAMDISK_TEST_FOLDERS 8
+#define RAMDISK_TEST_FILES 16
+#define RAMDISK_TEST_FILE_SIZE 64
+
+struct ramdisk_test_image
+{
+	uint8_t* data;
+	uint32_t length;
+	uint32_t capacity;
+	uint32_t nextId;
+};
+
+static void ramdiskTestWrite(ramdisk_test_image* image, const void* data, uint32_t length)
+{
+	if(image->length + length > image->capacity)
+	{
+		image->capacity = (image->capacity + length) * 2;
+		image->data = (uint8_t*) realloc(image->data, image->capacity);
+	}
+	memcpy(image->data + image->length, data, length);
+	image->length += length;
+}
+
+static uint32_t ramdiskTestAddEntry(ramdisk_test_image* image, g_ramdisk_entry_type type, uint32_t parent, const char* name)
+{
+	uint8_t typeByte = type;
+	uint32_t id = image->nextId++;
+	uint32_t nameLength = strlen(name);
+	ramdiskTestWrite(image, &typeByte, 1);
+	ramdiskTestWrite(image, &id, 4);
+	ramdiskTestWrite(image, &parent, 4);
+	ramdiskTestWrite(image, &nameLength, 4);
+	ramdiskTestWrite(image, name, nameLength);
+
+	if(type == G_RAMDISK_ENTRY_TYPE_FILE)
+	{
+		uint8_t content[RAMDISK_TEST_FILE_SIZE];
+		memset(content, id, sizeof(content));
+		uint32_t size = sizeof(content);
+		ramdiskTestWrite(image, &size, 4);
+		ramdiskTestWrite(image, content, size);
+	}
+	return id;
+}
+
+/**
+ * Builds an image in the format of the ramdisk writer with two levels of folders
+ * below the root, each leaf folder containing some files.
+ */
+static ramdisk_test_image ramdiskTestBuildImage()
+{
+	ramdisk_test_image image;
+	image.data = nullptr;
+	image.length = 0;
+	image.capacity = 0;
+	image.nextId = 1;
+
+	char name[32];
+	for(int f = 0; f < RAMDISK_TEST_FOLDERS; f++)
+	{
+		snprintf(name, sizeof(name), "folder%i", f);
+		uint32_t folder = ramdiskTestAddEntry(&image, G_RAMDISK_ENTRY_TYPE_FOLDER, 0, name);
+
+		for(int s = 0; s < RAMDISK_TEST_FOLDERS; s++)
+		{
+			snprintf(name, sizeof(name), "sub%i", s);
+			uint32_t sub = ramdiskTestAddEntry(&image, G_RAMDISK_ENTRY_TYPE_FOLDER, folder, name);
+
+			for(int i = 0; i < RAMDISK_TEST_FILES; i++)
+			{
+				snprintf(name, sizeof(name), "file%i.bin", i);
+				ramdiskTestAddEntry(&image, G_RAMDISK_ENTRY_TYPE_FILE, sub, name);
+			}
+		}
+	}
+
+	// Multiboot modules use 32 bit addresses, so the image must be in the lower 4 GiB
+	void* low = mmap(nullptr, image.length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+	if(low == MAP_FAILED)
+		panic("failed to map ramdisk test image");
+	memcpy(low, image.data, image.length);
+	free(image.data);
+	image.data = (uint8_t*) low;
+	return image;
+}
+
+static void ramdiskTestFreeImage(ramdisk_test_image* image)
+{
+	munmap(image->data, image->length);
+}
+
+static void ramdiskTestParse(ramdisk_test_image* image)
+{
+	g_multiboot_module module;
+	module.moduleStart = (g_address) image->data;
+	module.moduleEnd = (g_address) image->data + image->length;
+
+	if(!ramdiskMain)
+		ramdiskMain = new g_ramdisk;
+	ramdiskParseContents(&module);
+}
+
+static void ramdiskTestRelease()
+{
+	g_ramdisk_entry* entry = ramdiskMain->firstEntry;
+	while(entry)
+	{
+		g_ramdisk_entry* next = entry->next;
+		delete[] entry->name;
+		delete entry;
+		entry = next;
+	}
+	delete ramdiskMain->root;
+	ramdiskMain->firstEntry = nullptr;
+	ramdiskMain->root = nullptr;
+}
+
+TEST(ramdiskParseAndFind, "Parse an image and resolve paths")
+{
+	ramdisk_test_image image = ramdiskTestBuildImage();
+	ramdiskTestParse(&image);
+
+	ASSERT_EQUALS((uint32_t) RAMDISK_TEST_FOLDERS, ramdiskGetChildCount(0));
+
+	g_ramdisk_entry* file = ramdiskFindAbsolute("/folder3/sub5/file7.bin");
+	ASSERT_NOT_EQUALS((g_ramdisk_entry*) nullptr, file);
+	ASSERT_EQUALS((g_ramdisk_entry_type) G_RAMDISK_ENTRY_TYPE_FILE, file->type);
+	ASSERT_EQUALS((uint32_t) RAMDISK_TEST_FILE_SIZE, file->dataSize);
+	ASSERT_EQUALS((uint8_t) file->id, file->data[0]);
+
+	g_ramdisk_entry* folder = ramdiskFindAbsolute("folder3/sub5");
+	ASSERT_EQUALS((uint32_t) RAMDISK_TEST_FILES, ramdiskGetChildCount(folder->id));
+	ASSERT_EQUALS(file, ramdiskFindRelative(folder, "file7.bin"));
+
+	ASSERT_EQUALS((g_ramdisk_entry*) nullptr, ramdiskFindAbsolute("/folder3/missing/file7.bin"));
+
+	ramdiskTestRelease();
+	ramdiskTestFreeImage(&image);
+}
+
+BENCHMARK(ramdiskParse, "Parse an image with about 1000 entries")
+{
+	ramdisk_test_image image = ramdiskTestBuildImage();
+
+	for(uint64_t i = 0; i < bench->iterations; i++)
+	{
+		benchStart(bench);
+		ramdiskTestParse(&image);
+		benchStop(bench);
+		ramdiskTestRelease();
+	}
+
+	ramdiskTestFreeImage(&image);
+}
+
+BENCHMARK(ramdiskFindShallow, "Resolve a path to a top-level folder")
+{
+	ramdisk_test_image image = ramdiskTestBuildImage();
+	ramdiskTestParse(&image);
+
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i++)
+		benchKeep(ramdiskFindAbsolute("/folder1"));
+	benchStop(bench);
+
+	ramdiskTestRelease();
+	ramdiskTestFreeImage(&image);
+}
+
+BENCHMARK(ramdiskFindDeep, "Resolve a path to a file at the end of the image")
+{
+	ramdisk_test_image image = ramdiskTestBuildImage();
+	ramdiskTestParse(&image);
+
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i++)
+		benchKeep(ramdiskFindAbsolute("/folder7/sub7/file15.bin"));
+	benchStop(bench);
+
+	ramdiskTestRelease();
+	ramdiskTestFreeImage(&image);
+}
@@ -0,0 +1,71 @@
+#include "test/test.hpp"
+#include "test/bench.hpp"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Test unit
+#include "kernel/memory/address_range_pool.cpp"
+
+#define RANGE_POOL_TEST_START 0x10000000
+#define RANGE_POOL_TEST_END 0x20000000
+#define RANGE_POOL_TEST_LIVE 256
+
+TEST(addressRangePoolAllocateFree, "Allocation, release and merging of ranges")
+{
+	g_address_range_pool pool;
+	addressRangePoolInitialize(&pool);
+	addressRangePoolAddRange(&pool, RANGE_POOL_TEST_START, RANGE_POOL_TEST_END);
+
+	g_address first = addressRangePoolAllocate(&pool, 4);
+	g_address second = addressRangePoolAllocate(&pool, 1);
+	ASSERT_EQUALS((g_address) RANGE_POOL_TEST_START, first);
+	ASSERT_EQUALS((g_address) RANGE_POOL_TEST_START + 4 * G_PAGE_SIZE, second);
+
+	ASSERT_EQUALS(4, addressRangePoolFree(&pool, first));
+	ASSERT_EQUALS(1, addressRangePoolFree(&pool, second));
+	ASSERT_EQUALS(-1, addressRangePoolFree(&pool, second));
+
+	// Everything is merged back into a single free range
+	g_address_range* range = addressRangePoolGetRanges(&pool);
+	ASSERT_EQUALS(false, range->used);
+	ASSERT_EQUALS((uint32_t) ((RANGE_POOL_TEST_END - RANGE_POOL_TEST_START) / G_PAGE_SIZE), range->pages);
+	ASSERT_EQUALS((g_address_range*) nullptr, range->next);
+
+	addressRangePoolDestroy(&pool);
+}
+
+BENCHMARK(addressRangePoolAllocateEmpty, "Allocate and free in an empty pool")
+{
+	g_address_range_pool pool;
+	addressRangePoolInitialize(&pool);
+	addressRangePoolAddRange(&pool, RANGE_POOL_TEST_START, RANGE_POOL_TEST_END);
+
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i++)
+		addressRangePoolFree(&pool, addressRangePoolAllocate(&pool, 1 + i % 16));
+	benchStop(bench);
+
+	addressRangePoolDestroy(&pool);
+}
+
+BENCHMARK(addressRangePoolFragmented, "Allocate and free with many live ranges")
+{
+	g_address_range_pool pool;
+	addressRangePoolInitialize(&pool);
+	addressRangePoolAddRange(&pool, RANGE_POOL_TEST_START, RANGE_POOL_TEST_END);
+
+	// Keep every second range allocated so that the free list is fragmented
+	g_address live[RANGE_POOL_TEST_LIVE];
+	for(int i = 0; i < RANGE_POOL_TEST_LIVE; i++)
+		live[i] = addressRangePoolAllocate(&pool, 1 + i % 8);
+	for(int i = 0; i < RANGE_POOL_TEST_LIVE; i += 2)
+		addressRangePoolFree(&pool, live[i]);
+
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i++)
+		addressRangePoolFree(&pool, addressRangePoolAllocate(&pool, 1 + i % 16));
+	benchStop(bench);
+
+	addressRangePoolDestroy(&pool);
+}
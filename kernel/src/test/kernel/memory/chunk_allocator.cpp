@@ -1,4 +1,5 @@
 #include "test/test.hpp"
+#include "test/bench.hpp"
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -120,3 +121,31 @@ TEST(chunkAllocatorFreeInbetween, "Free something in between")
 
 	free(testMemory);
 }
+
+#define CHUNK_BENCH_MEMORY 0x400000
+#define CHUNK_BENCH_LIVE 128
+
+BENCHMARK(chunkAllocatorAllocateFree, "Allocate and free with mixed sizes and live chunks")
+{
+	uint8_t* testMemory = malloc(CHUNK_BENCH_MEMORY);
+
+	g_chunk_allocator alloc;
+	chunkAllocatorInitialize(&alloc, (g_virtual_address) testMemory, (g_virtual_address) testMemory + CHUNK_BENCH_MEMORY);
+
+	// Keep some chunks alive so the free list has holes of different sizes
+	void* live[CHUNK_BENCH_LIVE];
+	for(int i = 0; i < CHUNK_BENCH_LIVE; i++)
+		live[i] = chunkAllocatorAllocate(&alloc, 16 + (i % 8) * 48);
+	for(int i = 0; i < CHUNK_BENCH_LIVE; i += 2)
+		chunkAllocatorFree(&alloc, live[i]);
+
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i++)
+	{
+		void* chunk = chunkAllocatorAllocate(&alloc, 16 + (i % 16) * 32);
+		chunkAllocatorFree(&alloc, chunk);
+	}
+	benchStop(bench);
+
+	free(testMemory);
+}
@@ -0,0 +1,19 @@
+#include "test/test.hpp"
+#include <stdint.h>
+#include <stdlib.h>
+
+// Kernel heap backed by the host allocator, shared by all tested units
+void* heapAllocate(uint32_t size)
+{
+	return malloc(size);
+}
+
+void* heapAllocateClear(uint32_t size)
+{
+	return calloc(1, size);
+}
+
+void heapFree(void* memory)
+{
+	free(memory);
+}
@@ -0,0 +1,200 @@
+#include "test/test.hpp"
+#include "test/bench.hpp"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "kernel/utils/concurrent_hashmap.hpp"
+#include "kernel/utils/hashmap.hpp"
+
+#define CONCURRENT_HASHMAP_TEST_ENTRIES 4096
+#define CONCURRENT_HASHMAP_STRESS_READERS 3
+#define CONCURRENT_HASHMAP_STRESS_STABLE 512
+#define CONCURRENT_HASHMAP_STRESS_ROUNDS 200
+
+TEST(concurrentHashmapPutGetRemove, "Put, get and remove while the table grows")
+{
+	auto map = concurrentHashmapCreate<int, int>();
+	for(int i = 0; i < CONCURRENT_HASHMAP_TEST_ENTRIES; i++)
+	{
+		concurrentHashmapPut(map, i, i * 3);
+
+		// Entries must stay visible while they are being migrated
+		ASSERT_EQUALS(i * 3, concurrentHashmapGet(map, i, -1));
+		ASSERT_EQUALS(i / 2 * 3, concurrentHashmapGet(map, i / 2, -1));
+	}
+	ASSERT_EQUALS((uint32_t) CONCURRENT_HASHMAP_TEST_ENTRIES, concurrentHashmapSize(map));
+
+	for(int i = 0; i < CONCURRENT_HASHMAP_TEST_ENTRIES; i++)
+		ASSERT_EQUALS(i * 3, concurrentHashmapGet(map, i, -1));
+	ASSERT_EQUALS(-1, concurrentHashmapGet(map, CONCURRENT_HASHMAP_TEST_ENTRIES, -1));
+
+	concurrentHashmapPut(map, 5, 0);
+	ASSERT_EQUALS(0, concurrentHashmapGet(map, 5, -1));
+	concurrentHashmapPut(map, 5, 15);
+	ASSERT_EQUALS((uint32_t) CONCURRENT_HASHMAP_TEST_ENTRIES, concurrentHashmapSize(map));
+
+	for(int i = 0; i < CONCURRENT_HASHMAP_TEST_ENTRIES; i += 2)
+		concurrentHashmapRemove(map, i);
+	ASSERT_EQUALS((uint32_t) CONCURRENT_HASHMAP_TEST_ENTRIES / 2, concurrentHashmapSize(map));
+	for(int i = 0; i < CONCURRENT_HASHMAP_TEST_ENTRIES; i++)
+		ASSERT_EQUALS(i % 2 ? i * 3 : -1, concurrentHashmapGet(map, i, -1));
+
+	concurrentHashmapDestroy(map);
+}
+
+TEST(concurrentHashmapIterate, "Iteration visits every entry once")
+{
+	auto map = concurrentHashmapCreate<uint64_t, int>();
+	uint64_t expected = 0;
+	for(int i = 0; i < 100; i++)
+	{
+		concurrentHashmapPut(map, (uint64_t) i << 32, i);
+		expected += i;
+	}
+
+	uint64_t sum = 0;
+	int count = 0;
+	auto iter = concurrentHashmapIteratorStart(map);
+	while(concurrentHashmapIteratorHasNext(&iter))
+	{
+		auto slot = concurrentHashmapIteratorNext(&iter);
+		ASSERT_EQUALS((uint64_t) slot->value << 32, slot->key);
+		sum += slot->value;
+		count++;
+	}
+	concurrentHashmapIteratorEnd(&iter);
+
+	ASSERT_EQUALS(100, count);
+	ASSERT_EQUALS(expected, sum);
+
+	concurrentHashmapDestroy(map);
+}
+
+TEST(concurrentHashmapPutIfAbsent, "Put if absent keeps the existing value")
+{
+	auto map = concurrentHashmapCreate<int, int>();
+	ASSERT_EQUALS(1, concurrentHashmapPutIfAbsent(map, 7, 1));
+	ASSERT_EQUALS(1, concurrentHashmapPutIfAbsent(map, 7, 2));
+	ASSERT_EQUALS(1, concurrentHashmapGet(map, 7, -1));
+	ASSERT_EQUALS((uint32_t) 1, concurrentHashmapSize(map));
+	concurrentHashmapDestroy(map);
+}
+
+static g_concurrent_hashmap<int, int>* concurrentHashmapStressMap;
+static volatile bool concurrentHashmapStressRunning;
+static volatile int concurrentHashmapStressErrors;
+
+static void* concurrentHashmapStressReader(void* arg)
+{
+	uint32_t random = (uint32_t) (uintptr_t) arg;
+	while(concurrentHashmapStressRunning)
+	{
+		random = random * 1103515245 + 12345;
+		int key = (random >> 8) % CONCURRENT_HASHMAP_STRESS_STABLE;
+		if(concurrentHashmapGet(concurrentHashmapStressMap, key, -1) != key * 7)
+			__sync_fetch_and_add(&concurrentHashmapStressErrors, 1);
+
+		int churned = CONCURRENT_HASHMAP_STRESS_STABLE + (random >> 8) % CONCURRENT_HASHMAP_TEST_ENTRIES;
+		int value = concurrentHashmapGet(concurrentHashmapStressMap, churned, -1);
+		if(value != -1 && value != churned * 7)
+			__sync_fetch_and_add(&concurrentHashmapStressErrors, 1);
+	}
+	return 0;
+}
+
+TEST(concurrentHashmapStress, "Readers see consistent values while a writer grows and shrinks the map")
+{
+	concurrentHashmapStressMap = concurrentHashmapCreate<int, int>();
+	for(int i = 0; i < CONCURRENT_HASHMAP_STRESS_STABLE; i++)
+		concurrentHashmapPut(concurrentHashmapStressMap, i, i * 7);
+
+	concurrentHashmapStressRunning = true;
+	concurrentHashmapStressErrors = 0;
+	pthread_t readers[CONCURRENT_HASHMAP_STRESS_READERS];
+	for(int i = 0; i < CONCURRENT_HASHMAP_STRESS_READERS; i++)
+		pthread_create(&readers[i], 0, concurrentHashmapStressReader, (void*) (uintptr_t) (i + 1));
+
+	// The writer is the only thread modifying the map, since mutexes are no-ops on the host
+	for(int round = 0; round < CONCURRENT_HASHMAP_STRESS_ROUNDS; round++)
+	{
+		int count = (round % 8 + 1) * CONCURRENT_HASHMAP_TEST_ENTRIES / 8;
+		for(int i = 0; i < count; i++)
+		{
+			int key = CONCURRENT_HASHMAP_STRESS_STABLE + i;
+			concurrentHashmapPut(concurrentHashmapStressMap, key, key * 7);
+			concurrentHashmapPut(concurrentHashmapStressMap, i % CONCURRENT_HASHMAP_STRESS_STABLE, i % CONCURRENT_HASHMAP_STRESS_STABLE * 7);
+		}
+		for(int i = 0; i < count; i++)
+			concurrentHashmapRemove(concurrentHashmapStressMap, CONCURRENT_HASHMAP_STRESS_STABLE + i);
+	}
+
+	concurrentHashmapStressRunning = false;
+	for(int i = 0; i < CONCURRENT_HASHMAP_STRESS_READERS; i++)
+		pthread_join(readers[i], 0);
+
+	ASSERT_EQUALS(0, (int) concurrentHashmapStressErrors);
+	ASSERT_EQUALS((uint32_t) CONCURRENT_HASHMAP_STRESS_STABLE, concurrentHashmapSize(concurrentHashmapStressMap));
+
+	concurrentHashmapDestroy(concurrentHashmapStressMap);
+}
+
+BENCHMARK(concurrentHashmapGet, "Lookup in a map with 4096 tasks")
+{
+	auto map = concurrentHashmapCreate<int, int>();
+	for(int i = 0; i < CONCURRENT_HASHMAP_TEST_ENTRIES; i++)
+		concurrentHashmapPut(map, i, i);
+
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i++)
+		benchKeep(concurrentHashmapGet(map, (int) (i % CONCURRENT_HASHMAP_TEST_ENTRIES), -1));
+	benchStop(bench);
+
+	concurrentHashmapDestroy(map);
+}
+
+BENCHMARK(concurrentHashmapGetChained, "Same lookup in the chained hashmap for comparison")
+{
+	// Same bucket count as the task map had before
+	auto map = hashmapCreateNumeric<int, int>(128);
+	for(int i = 0; i < CONCURRENT_HASHMAP_TEST_ENTRIES; i++)
+		hashmapPut(map, i, i);
+
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i++)
+		benchKeep(hashmapGet(map, (int) (i % CONCURRENT_HASHMAP_TEST_ENTRIES), -1));
+	benchStop(bench);
+
+	hashmapDestroy(map);
+}
+
+BENCHMARK(concurrentHashmapPutRemove, "Insert and remove in a map with 4096 tasks")
+{
+	auto map = concurrentHashmapCreate<int, int>();
+	for(int i = 0; i < CONCURRENT_HASHMAP_TEST_ENTRIES; i++)
+		concurrentHashmapPut(map, i, i);
+
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i++)
+	{
+		int key = CONCURRENT_HASHMAP_TEST_ENTRIES + (int) (i % CONCURRENT_HASHMAP_TEST_ENTRIES);
+		concurrentHashmapPut(map, key, key);
+		concurrentHashmapRemove(map, key);
+	}
+	benchStop(bench);
+
+	concurrentHashmapDestroy(map);
+}
+
+BENCHMARK(concurrentHashmapGrow, "Fill an empty map with 4096 entries")
+{
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations;)
+	{
+		auto map = concurrentHashmapCreate<int, int>();
+		for(int key = 0; key < CONCURRENT_HASHMAP_TEST_ENTRIES && i < bench->iterations; key++, i++)
+			concurrentHashmapPut(map, key, key);
+		concurrentHashmapDestroy(map);
+	}
+	benchStop(bench);
+}
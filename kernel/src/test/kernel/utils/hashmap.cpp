@@ -0,0 +1,124 @@
+#include "test/test.hpp"
+#include "test/bench.hpp"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Test unit
+#include "kernel/utils/hashmap_string.cpp"
+
+#define HASHMAP_TEST_ENTRIES 1024
+
+static char hashmapTestNames[HASHMAP_TEST_ENTRIES][32];
+
+static void hashmapTestFillNames()
+{
+	for(int i = 0; i < HASHMAP_TEST_ENTRIES; i++)
+		snprintf(hashmapTestNames[i], sizeof(hashmapTestNames[i]), "service/%i/worker", i);
+}
+
+TEST(hashmapNumeric, "Put, get and remove numeric keys")
+{
+	auto map = hashmapCreateNumeric<int, int>(16);
+	for(int i = 0; i < HASHMAP_TEST_ENTRIES; i++)
+		hashmapPut(map, i, i * 3);
+	ASSERT_EQUALS((uint32_t) HASHMAP_TEST_ENTRIES, hashmapSize(map));
+
+	for(int i = 0; i < HASHMAP_TEST_ENTRIES; i++)
+		ASSERT_EQUALS(i * 3, hashmapGet(map, i, -1));
+	ASSERT_EQUALS(-1, hashmapGet(map, HASHMAP_TEST_ENTRIES, -1));
+
+	for(int i = 0; i < HASHMAP_TEST_ENTRIES; i += 2)
+		hashmapRemove(map, i);
+	ASSERT_EQUALS((uint32_t) HASHMAP_TEST_ENTRIES / 2, hashmapSize(map));
+	ASSERT_EQUALS(-1, hashmapGet(map, 0, -1));
+	ASSERT_EQUALS(3, hashmapGet(map, 1, -1));
+
+	hashmapDestroy(map);
+}
+
+TEST(hashmapString, "Put and get string keys")
+{
+	hashmapTestFillNames();
+
+	auto map = hashmapCreateString<int>(64);
+	for(int i = 0; i < HASHMAP_TEST_ENTRIES; i++)
+		hashmapPut(map, (const char*) hashmapTestNames[i], i);
+
+	for(int i = 0; i < HASHMAP_TEST_ENTRIES; i++)
+		ASSERT_EQUALS(i, hashmapGet(map, (const char*) hashmapTestNames[i], -1));
+	ASSERT_EQUALS(-1, hashmapGet(map, "missing", -1));
+
+	hashmapDestroy(map);
+}
+
+BENCHMARK(hashmapGetNumeric, "Lookup in a task-sized numeric map")
+{
+	// Same bucket count as the global task map
+	auto map = hashmapCreateNumeric<int, int>(128);
+	for(int i = 0; i < HASHMAP_TEST_ENTRIES; i++)
+		hashmapPut(map, i, i);
+
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i++)
+		benchKeep(hashmapGet(map, (int) (i % HASHMAP_TEST_ENTRIES), -1));
+	benchStop(bench);
+
+	hashmapDestroy(map);
+}
+
+BENCHMARK(hashmapPutRemoveNumeric, "Insert and remove in a task-sized numeric map")
+{
+	auto map = hashmapCreateNumeric<int, int>(128);
+	for(int i = 0; i < HASHMAP_TEST_ENTRIES; i++)
+		hashmapPut(map, i, i);
+
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i++)
+	{
+		int key = HASHMAP_TEST_ENTRIES + (int) (i % HASHMAP_TEST_ENTRIES);
+		hashmapPut(map, key, key);
+		hashmapRemove(map, key);
+	}
+	benchStop(bench);
+
+	hashmapDestroy(map);
+}
+
+BENCHMARK(hashmapGetString, "Lookup in the task directory")
+{
+	hashmapTestFillNames();
+
+	// Same bucket count as the task directory
+	auto map = hashmapCreateString<int>(64);
+	for(int i = 0; i < HASHMAP_TEST_ENTRIES; i++)
+		hashmapPut(map, (const char*) hashmapTestNames[i], i);
+
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i++)
+		benchKeep(hashmapGet(map, (const char*) hashmapTestNames[i % HASHMAP_TEST_ENTRIES], -1));
+	benchStop(bench);
+
+	hashmapDestroy(map);
+}
+
+BENCHMARK(hashmapIterate, "Iteration over all entries")
+{
+	auto map = hashmapCreateNumeric<int, int>(128);
+	for(int i = 0; i < HASHMAP_TEST_ENTRIES; i++)
+		hashmapPut(map, i, i);
+
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i++)
+	{
+		int sum = 0;
+		auto it = hashmapIteratorStart(map);
+		while(hashmapIteratorHasNext(&it))
+			sum += hashmapIteratorNext(&it)->value;
+		hashmapIteratorEnd(&it);
+		benchKeep(sum);
+	}
+	benchStop(bench);
+
+	hashmapDestroy(map);
+}
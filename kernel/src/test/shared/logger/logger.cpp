@@ -0,0 +1,99 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "test/test.hpp"
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The logger header is replaced by the test mocks
+void loggerPrintCharacter(char c);
+
+// Other tests link the string utilities, so they are not included again
+#include "shared/utils/string.hpp"
+#define stringLength(str) strlen(str)
+
+// Test unit
+#include "shared/logger/logger.cpp"
+
+// Mocked outputs
+static char testLoggerOutput[BUFLEN];
+static uint32_t testLoggerOutputLength = 0;
+
+void consoleVideoPrint(char c)
+{
+	testLoggerOutput[testLoggerOutputLength++] = c;
+	testLoggerOutput[testLoggerOutputLength] = 0;
+}
+
+void consoleVideoSetColor(uint8_t color)
+{
+}
+
+void debugInterfaceWriteLogCharacter(char c)
+{
+}
+
+static uint32_t testLoggerFormat(char* buffer, uint32_t capacity, const char* message, ...)
+{
+	va_list valist;
+	va_start(valist, message);
+	uint32_t length = loggerFormat(buffer, capacity, message, valist);
+	va_end(valist);
+	return length;
+}
+
+static void testLoggerPrint(const char* message, ...)
+{
+	testLoggerOutputLength = 0;
+	testLoggerOutput[0] = 0;
+
+	va_list valist;
+	va_start(valist, message);
+	loggerPrintFormatted(message, valist);
+	va_end(valist);
+}
+
+TEST(loggerFormatMatchesOutput, "Formatting into a buffer gives the printed text")
+{
+	char buffer[BUFLEN];
+	loggerEnableVideo(true);
+
+	testLoggerPrint("%! value %i, hex %h, text %s %%", "test", -42, 0x1234, "abc");
+	uint32_t length = testLoggerFormat(buffer, BUFLEN, "%! value %i, hex %h, text %s %%", "test", -42, 0x1234, "abc");
+
+	ASSERT_EQUALS(testLoggerOutputLength, length);
+	ASSERT_EQUALS(0, strcmp(testLoggerOutput, buffer));
+	ASSERT_EQUALS(0, strcmp("      test  value -42, hex 0x00001234, text abc %", buffer));
+	return true;
+}
+
+TEST(loggerFormatTruncates, "Formatting cuts off output that does not fit")
+{
+	char buffer[8];
+	memset(buffer, 'x', sizeof(buffer));
+
+	uint32_t length = testLoggerFormat(buffer, sizeof(buffer), "%s %i", "abcdef", 12345);
+	ASSERT_EQUALS((uint32_t) 7, length);
+	ASSERT_EQUALS(0, strcmp("abcdef ", buffer));
+	return true;
+}
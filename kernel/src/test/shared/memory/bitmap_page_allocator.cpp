@@ -1,4 +1,5 @@
 #include "test/test.hpp"
+#include "test/bench.hpp"
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -94,6 +95,38 @@ TEST(bitmapPageAllocatorMultiple, "Multiple-bitmap test")
 	free(bitmapArray);
 }
 
+TEST(bitmapPageAllocatorCounts, "Only unused pages are counted as free")
+{
+	uint32_t entryCount = 16;
+	void* bitmapArray = malloc((sizeof(g_bitmap_header) + sizeof(g_bitmap_entry) * entryCount) * 1);
+
+	g_bitmap_header* bitmap1 = (g_bitmap_header*) bitmapArray;
+	bitmap1->baseAddress = 0x10000000;
+	bitmap1->entryCount = entryCount;
+	bitmap1->hasNext = false;
+	bitmap1->firstFree = 0;
+
+	g_bitmap_entry* entries1 = (g_bitmap_entry*) ((g_address) bitmap1 + sizeof(g_bitmap_header));
+	for(uint32_t i = 0; i < entryCount; i++)
+		entries1[i] = 0b11111111;
+	entries1[3] = 0b11100111;
+	entries1[9] = 0b00000000;
+
+	g_bitmap_page_allocator allocator;
+	bitmapPageAllocatorInitialize(&allocator, (g_bitmap_header*) bitmapArray);
+
+	ASSERT_EQUALS(128u, allocator.totalPageCount);
+	ASSERT_EQUALS(10u, allocator.freePageCount);
+
+	bitmapPageAllocatorAllocate(&allocator);
+	ASSERT_EQUALS(9u, allocator.freePageCount);
+
+	bitmapPageAllocatorMarkFree(&allocator, 0x10000000ul);
+	ASSERT_EQUALS(10u, allocator.freePageCount);
+
+	free(bitmapArray);
+}
+
 TEST(bitmapMacros, "Ensure macros calculate what we expect")
 {
 	{
@@ -151,3 +184,57 @@ TEST(bitmapMacros, "Ensure macros calculate what we expect")
 		ASSERT_EQUALS(0x10000lu, G_BITMAP_TO_OFFSET(2, 0));
 	}
 }
+
+#define BITMAP_BENCH_ENTRIES 32768
+#define BITMAP_BENCH_BATCH 256
+
+/**
+ * Creates a bitmap for 1 GiB where only the last "freeEntries" entries are free.
+ */
+static g_bitmap_header* bitmapBenchCreate(g_bitmap_page_allocator* allocator, uint32_t freeEntries)
+{
+	g_bitmap_header* bitmap = (g_bitmap_header*) malloc(sizeof(g_bitmap_header) + sizeof(g_bitmap_entry) * BITMAP_BENCH_ENTRIES);
+	bitmap->baseAddress = 0x10000000;
+	bitmap->entryCount = BITMAP_BENCH_ENTRIES;
+	bitmap->firstFree = 0;
+	bitmap->hasNext = false;
+
+	g_bitmap_entry* entries = G_BITMAP_ENTRIES(bitmap);
+	for(uint32_t i = 0; i < BITMAP_BENCH_ENTRIES; i++)
+		entries[i] = i < BITMAP_BENCH_ENTRIES - freeEntries ? G_BITMAP_ENTRY_FULL : 0;
+
+	bitmapPageAllocatorInitialize(allocator, bitmap);
+	return bitmap;
+}
+
+static void bitmapBenchCycle(bench_t* bench, g_bitmap_page_allocator* allocator)
+{
+	g_physical_address pages[BITMAP_BENCH_BATCH];
+
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i += BITMAP_BENCH_BATCH)
+	{
+		uint64_t batch = bench->iterations - i < BITMAP_BENCH_BATCH ? bench->iterations - i : BITMAP_BENCH_BATCH;
+		for(uint64_t p = 0; p < batch; p++)
+			pages[p] = bitmapPageAllocatorAllocate(allocator);
+		for(uint64_t p = 0; p < batch; p++)
+			bitmapPageAllocatorMarkFree(allocator, pages[p]);
+	}
+	benchStop(bench);
+}
+
+BENCHMARK(bitmapPageAllocatorEmpty, "Allocate and free pages in free memory")
+{
+	g_bitmap_page_allocator allocator;
+	g_bitmap_header* bitmap = bitmapBenchCreate(&allocator, BITMAP_BENCH_ENTRIES);
+	bitmapBenchCycle(bench, &allocator);
+	free(bitmap);
+}
+
+BENCHMARK(bitmapPageAllocatorNearlyFull, "Allocate and free pages in nearly full memory")
+{
+	g_bitmap_page_allocator allocator;
+	g_bitmap_header* bitmap = bitmapBenchCreate(&allocator, BITMAP_BENCH_ENTRIES / 16);
+	bitmapBenchCycle(bench, &allocator);
+	free(bitmap);
+}
@@ -0,0 +1,78 @@
+#include "test/test.hpp"
+#include "test/bench.hpp"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Test unit
+#include "shared/utils/string.cpp"
+#include "kernel/utils/string.cpp"
+
+static const char* stringTestPath = "/applications/windowserver/resources/fonts/default.ttf";
+
+TEST(stringSearchAndCompare, "Index, equality and hashing")
+{
+	ASSERT_EQUALS(0, stringIndexOf(stringTestPath, '/'));
+	ASSERT_EQUALS(12, stringIndexOf(stringTestPath + 1, '/'));
+	ASSERT_EQUALS(-1, stringIndexOf(stringTestPath, '?'));
+	ASSERT_EQUALS((int) strlen(stringTestPath), stringLength(stringTestPath));
+
+	char copy[128];
+	stringCopy(copy, stringTestPath);
+	ASSERT_EQUALS(true, stringEquals(copy, stringTestPath));
+	ASSERT_EQUALS(stringHash(copy), stringHash(stringTestPath));
+	copy[5] = 'X';
+	ASSERT_EQUALS(false, stringEquals(copy, stringTestPath));
+
+	char* duplicate = stringDuplicate(stringTestPath);
+	ASSERT_EQUALS(true, stringEquals(duplicate, stringTestPath));
+	heapFree(duplicate);
+}
+
+BENCHMARK(stringLengthPath, "Length of a typical path")
+{
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i++)
+		benchKeep(stringLength(stringTestPath));
+	benchStop(bench);
+}
+
+BENCHMARK(stringEqualsPath, "Comparison of two equal paths")
+{
+	char copy[128];
+	stringCopy(copy, stringTestPath);
+
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i++)
+		benchKeep(stringEquals(copy, stringTestPath));
+	benchStop(bench);
+}
+
+BENCHMARK(stringHashIdentifier, "Hash of a task identifier")
+{
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i++)
+		benchKeep(stringHash("windowserver/renderer"));
+	benchStop(bench);
+}
+
+BENCHMARK(stringIndexOfSeparator, "Search for the last separator of a path")
+{
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i++)
+		benchKeep(stringIndexOf(stringTestPath, '.'));
+	benchStop(bench);
+}
+
+BENCHMARK(stringDuplicateName, "Duplicate and free a file name")
+{
+	benchStart(bench);
+	for(uint64_t i = 0; i < bench->iterations; i++)
+	{
+		char* duplicate = stringDuplicate("default.ttf");
+		benchKeep(duplicate);
+		heapFree(duplicate);
+	}
+	benchStop(bench);
+}
@@ -1,4 +1,6 @@
 #include "test/test.hpp"
+#include "test/bench.hpp"
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -23,6 +25,9 @@ void testAdd(const char* name, bool (*func)())
 
 int main(int argc, const char** argv)
 {
+	if(argc >= 2 && strcmp(argv[1], "--bench") == 0)
+		return benchMain(argc - 2, argv + 2);
+
 	const char* only = nullptr;
 	if(argc == 2)
 	{
@@ -75,6 +75,11 @@ void _panic(int line, const char* msg, ...);
 typedef uintptr_t g_address;
 typedef g_address g_virtual_address;
 typedef g_address g_physical_address;
+typedef g_address g_offset;
+typedef g_address g_ptrsize;
+typedef uint32_t g_atom;
+typedef uint8_t g_bool;
+#define G_ADDRESS_MAX UINTPTR_MAX
 
 #define __PANIC__
 #define panic(msg...) _panic(__LINE__, msg);
@@ -6,6 +6,13 @@ fi
 . "$ROOT/ghost.sh"
 
 
+#
+# Runs the host unit tests, or the benchmarks when called with "--bench":
+#
+#   ./test.sh [filter]
+#   ./test.sh --bench [filter] [--samples n] [--save file] [--baseline file] [--threshold percent]
+#
+
 # Flags
 with CXX_FLAGS		"-I$SYSROOT/system/include -Isrc -Iinclude -Iinc -fpermissive -w"
 with CXX			g++
@@ -24,9 +31,9 @@ for file in $(find "src/test" -iname "*.cpp" -o -iname "*.c"); do
 done
 
 # Link
-g++ -o bin/test $OBJDIR/*.o
+g++ -o bin/test $OBJDIR/*.o -lm -pthread
 failOnError
 
 # Execute
-./bin/test $1
+./bin/test "$@"
 failOnError
@@ -29,6 +29,9 @@
 #include "ghost/ipc.h"
 #include "ghost/types.h"
 #include "ghost/fs.h"
+#include "ghost/ioring.h"
+#include "ghost/trace.h"
+#include "ghost/profiler.h"
 #include "ghost/calls/calls.h"
 
 #endif
@@ -67,6 +67,8 @@ __BEGIN_C
 #define G_SYSCALL_SHARE_MEMORY					55
 #define G_SYSCALL_MAP_MMIO_AREA					56
 #define G_SYSCALL_SBRK							57
+#define G_SYSCALL_MEMORY_MAP					58
+#define G_SYSCALL_MEMORY_UNMAP					59
 
 #define G_SYSCALL_SPAWN							70
 #define G_SYSCALL_CREATE_THREAD					71
@@ -96,6 +98,17 @@ __BEGIN_C
 #define G_SYSCALL_FS_OPEN_DIRECTORY				134
 #define G_SYSCALL_FS_READ_DIRECTORY				135
 #define G_SYSCALL_FS_CLOSE_DIRECTORY			136
+#define G_SYSCALL_FS_READ_AT					137
+#define G_SYSCALL_FS_WRITE_AT					138
+#define G_SYSCALL_FS_READ_VECTOR				139
+#define G_SYSCALL_FS_WRITE_VECTOR				140
+#define G_SYSCALL_IO_RING_CREATE				141
+#define G_SYSCALL_IO_RING_ENTER					142
+#define G_SYSCALL_IO_RING_DESTROY				143
+#define G_SYSCALL_FS_UNLINK						144
+#define G_SYSCALL_TRACE							145
+#define G_SYSCALL_PROFILER						146
+#define G_SYSCALL_CONFIGURE_LOG					147
 
 #define G_SYSCALL_MAX							150
 
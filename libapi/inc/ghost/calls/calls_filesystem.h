@@ -22,6 +22,7 @@
 #define GHOST_API_CALLS_FILESYSTEMCALLS
 
 #include "ghost/fs.h"
+#include "ghost/ioring.h"
 
 /**
  * @field path
@@ -100,6 +101,142 @@ typedef struct {
 	int64_t result;
 }__attribute__((packed)) g_syscall_fs_write;
 
+/**
+ * Reads from a file at the given offset without using or changing
+ * the offset of the file descriptor.
+ *
+ * @field fd
+ * 		file descriptor
+ *
+ * @field buffer
+ * 		output buffer
+ *
+ * @field length
+ * 		number of bytes to read
+ *
+ * @field offset
+ * 		absolute offset in the file
+ *
+ * @field status
+ * 		one of the {g_fs_read_status} codes
+ *
+ * @field result
+ * 		number of bytes read
+ *
+ * @security-level APPLICATION
+ */
+typedef struct {
+	g_fd fd;
+	uint8_t* buffer;
+	int64_t length;
+	uint64_t offset;
+
+	g_fs_read_status status;
+	int64_t result;
+}__attribute__((packed)) g_syscall_fs_read_at;
+
+/**
+ * Writes to a file at the given offset without using or changing
+ * the offset of the file descriptor.
+ *
+ * @field fd
+ * 		file descriptor
+ *
+ * @field buffer
+ * 		input buffer
+ *
+ * @field length
+ * 		number of bytes to write
+ *
+ * @field offset
+ * 		absolute offset in the file
+ *
+ * @field status
+ * 		one of the {g_fs_write_status} codes
+ *
+ * @field result
+ * 		number of bytes written
+ *
+ * @security-level APPLICATION
+ */
+typedef struct {
+	g_fd fd;
+	uint8_t* buffer;
+	int64_t length;
+	uint64_t offset;
+
+	g_fs_write_status status;
+	int64_t result;
+}__attribute__((packed)) g_syscall_fs_write_at;
+
+/**
+ * Reads from a file into multiple buffers with a single call.
+ *
+ * @field fd
+ * 		file descriptor
+ *
+ * @field vector
+ * 		array of segments that are filled in order
+ *
+ * @field count
+ * 		number of segments, at most {G_FS_IOVEC_MAX}
+ *
+ * @field offset
+ * 		absolute offset in the file, or -1 to read at (and advance)
+ * 		the offset of the file descriptor
+ *
+ * @field status
+ * 		one of the {g_fs_read_status} codes
+ *
+ * @field result
+ * 		total number of bytes read
+ *
+ * @security-level APPLICATION
+ */
+typedef struct {
+	g_fd fd;
+	const g_fs_iovec* vector;
+	int32_t count;
+	int64_t offset;
+
+	g_fs_read_status status;
+	int64_t result;
+}__attribute__((packed)) g_syscall_fs_read_vector;
+
+/**
+ * Writes multiple buffers to a file with a single call.
+ *
+ * @field fd
+ * 		file descriptor
+ *
+ * @field vector
+ * 		array of segments that are written in order
+ *
+ * @field count
+ * 		number of segments, at most {G_FS_IOVEC_MAX}
+ *
+ * @field offset
+ * 		absolute offset in the file, or -1 to write at (and advance)
+ * 		the offset of the file descriptor
+ *
+ * @field status
+ * 		one of the {g_fs_write_status} codes
+ *
+ * @field result
+ * 		total number of bytes written
+ *
+ * @security-level APPLICATION
+ */
+typedef struct {
+	g_fd fd;
+	const g_fs_iovec* vector;
+	int32_t count;
+	int64_t offset;
+
+	g_fs_write_status status;
+	int64_t result;
+}__attribute__((packed)) g_syscall_fs_write_vector;
+
 /**
  * @field fd
  * 		file descriptor
@@ -115,6 +252,21 @@ typedef struct {
 	g_fs_close_status status;
 }__attribute__((packed)) g_syscall_fs_close;
 
+/**
+ * @field path
+ * 		path of the file to unlink
+ *
+ * @field status
+ * 		one of the {g_fs_unlink_status} codes
+ *
+ * @security-level APPLICATION
+ */
+typedef struct {
+	const char* path;
+
+	g_fs_unlink_status status;
+}__attribute__((packed)) g_syscall_fs_unlink;
+
 /**
  * @field path
  * 		file path
@@ -428,4 +580,69 @@ typedef struct {
 	g_fs_directory_iterator* iterator;
 }__attribute__((packed)) g_syscall_fs_close_directory;
 
+/**
+ * @field entries
+ * 		number of submission entries, rounded up to a power of two
+ *
+ * @field id
+ * 		the id of the created ring
+ *
+ * @field header
+ * 		the ring memory, shared with the kernel
+ *
+ * @field status
+ * 		one of the {g_io_ring_status} codes
+ *
+ * @security-level APPLICATION
+ */
+typedef struct {
+	uint32_t entries;
+
+	g_io_ring_id id;
+	g_io_ring_header* header;
+	g_io_ring_status status;
+}__attribute__((packed)) g_syscall_io_ring_create;
+
+/**
+ * @field id
+ * 		the ring id
+ *
+ * @field wait_for
+ * 		number of completions that must be available before the call returns
+ *
+ * @field timeout
+ * 		maximum time to wait in milliseconds, or 0 to wait without limit
+ *
+ * @field status
+ * 		one of the {g_io_ring_status} codes
+ *
+ * @field completions
+ * 		number of completions that are available
+ *
+ * @security-level APPLICATION
+ */
+typedef struct {
+	g_io_ring_id id;
+	uint32_t wait_for;
+	uint32_t timeout;
+
+	g_io_ring_status status;
+	uint32_t completions;
+}__attribute__((packed)) g_syscall_io_ring_enter;
+
+/**
+ * @field id
+ * 		the ring id
+ *
+ * @field status
+ * 		one of the {g_io_ring_status} codes
+ *
+ * @security-level APPLICATION
+ */
+typedef struct {
+	g_io_ring_id id;
+
+	g_io_ring_status status;
+}__attribute__((packed)) g_syscall_io_ring_destroy;
+
 #endif
@@ -24,6 +24,8 @@
 #include "ghost/stdint.h"
 #include "ghost/kernel.h"
 #include "ghost/types.h"
+#include "ghost/memory.h"
+#include "ghost/fs.h"
 
 /**
  * @field size
@@ -140,4 +142,58 @@ typedef struct {
 	uint8_t successful;
 }__attribute__((packed)) g_syscall_sbrk;
 
+/**
+ * @field length
+ * 		the number of bytes to map
+ *
+ * @field protection
+ * 		the protection of the mapped pages
+ *
+ * @field flags
+ * 		the mapping flags
+ *
+ * @field fd
+ * 		the file to map, ignored for anonymous mappings
+ *
+ * @field offset
+ * 		the page-aligned offset in the file
+ *
+ * @field address
+ * 		the page-aligned address of the mapping or 0 on failure
+ *
+ * @field status
+ * 		one of the {g_memory_map_status} codes
+ *
+ * @security-level APPLICATION
+ */
+typedef struct {
+	uint32_t length;
+	g_memory_protection protection;
+	g_memory_map_flags flags;
+	g_fd fd;
+	uint64_t offset;
+
+	void* address;
+	g_memory_map_status status;
+}__attribute__((packed)) g_syscall_memory_map;
+
+/**
+ * @field address
+ * 		the address of a mapping created with {g_memory_map}
+ *
+ * @field length
+ * 		the length of the mapping
+ *
+ * @field status
+ * 		one of the {g_memory_map_status} codes
+ *
+ * @security-level APPLICATION
+ */
+typedef struct {
+	void* address;
+	uint32_t length;
+
+	g_memory_map_status status;
+}__attribute__((packed)) g_syscall_memory_unmap;
+
 #endif
@@ -22,6 +22,8 @@
 #define GHOST_API_CALLS_MISCCALLS
 
 #include "ghost/kernquery.h"
+#include "ghost/trace.h"
+#include "ghost/profiler.h"
 
 /**
  * @field message
@@ -39,6 +41,27 @@ typedef struct {
 	uint8_t enabled;
 }__attribute__((packed)) g_syscall_set_video_log;
 
+/**
+ * @field level
+ * 		new log level or G_LOG_CONFIGURE_KEEP
+ *
+ * @field async
+ * 		whether to log through the asynchronous rings or G_LOG_CONFIGURE_KEEP
+ *
+ * @field previousLevel
+ * 		log level before the call
+ *
+ * @field previousAsync
+ * 		asynchronous logging state before the call
+ */
+typedef struct {
+	g_log_level level;
+	uint8_t async;
+
+	g_log_level previousLevel;
+	uint8_t previousAsync;
+}__attribute__((packed)) g_syscall_configure_log;
+
 /**
  * @field test
  * 		test value
@@ -68,4 +91,94 @@ typedef struct {
 	g_kernquery_status status;
 }__attribute__((packed)) g_syscall_kernquery;
 
+/**
+ * @field command
+ * 		one of the {g_trace_command} commands
+ *
+ * @field processor
+ * 		processor to read the events of
+ *
+ * @field buffer
+ * 		buffer for the events
+ *
+ * @field capacity
+ * 		number of events that fit into the buffer
+ *
+ * @field count
+ * 		number of events that were copied
+ *
+ * @field dropped
+ * 		number of events that were overwritten since the last reset
+ *
+ * @field processors
+ * 		number of processors that have a trace ring
+ *
+ * @field ticksPerMicrosecond
+ * 		time stamp counter frequency used for the timestamps
+ *
+ * @field status
+ * 		one of the {g_trace_status} codes
+ */
+typedef struct {
+	g_trace_command command;
+	uint32_t processor;
+	g_trace_event* buffer;
+	uint32_t capacity;
+
+	uint32_t count;
+	uint32_t dropped;
+	uint32_t processors;
+	uint32_t ticksPerMicrosecond;
+	g_trace_status status;
+}__attribute__((packed)) g_syscall_trace;
+
+/**
+ * @field command
+ * 		one of the {g_profiler_command} codes
+ *
+ * @field interval
+ * 		number of timer ticks between two samples when starting
+ *
+ * @field processor
+ * 		processor to read the samples of
+ *
+ * @field process
+ * 		process to read the loaded objects of
+ *
+ * @field buffer
+ * 		buffer for the samples or modules
+ *
+ * @field capacity
+ * 		number of samples or modules that fit into the buffer
+ *
+ * @field count
+ * 		number of samples or modules that were copied
+ *
+ * @field dropped
+ * 		number of samples that were overwritten since the last reset
+ *
+ * @field processors
+ * 		number of processors that have a sample buffer
+ *
+ * @field ticksPerMicrosecond
+ * 		time stamp counter frequency used for the timestamps
+ *
+ * @field status
+ * 		one of the {g_profiler_status} codes
+ */
+typedef struct {
+	g_profiler_command command;
+	uint32_t interval;
+	uint32_t processor;
+	g_pid process;
+	void* buffer;
+	uint32_t capacity;
+
+	uint32_t count;
+	uint32_t dropped;
+	uint32_t processors;
+	uint32_t ticksPerMicrosecond;
+	g_profiler_status status;
+}__attribute__((packed)) g_syscall_profiler;
+
 #endif
@@ -41,6 +41,15 @@ typedef uint64_t g_fs_phys_id; // a physical filesystem node identifier
  */
 #define G_PATH_MAX		4096
 #define G_FILENAME_MAX	512
+#define G_FS_IOVEC_MAX	1024
+
+/**
+ * A segment of a vectored read or write
+ */
+typedef struct {
+	void* base;
+	g_ptrsize length;
+}__attribute__((packed)) g_fs_iovec;
 
 /**
  * File mode flags
@@ -135,6 +144,16 @@ typedef int g_fs_tasked_delegate_request_type;
 #define G_FS_TASKED_DELEGATE_REQUEST_TYPE_OPEN ((g_fs_tasked_delegate_request_type) 5)
 #define G_FS_TASKED_DELEGATE_REQUEST_TYPE_CLOSE ((g_fs_tasked_delegate_request_type) 6)
 
+/**
+ * Message that the kernel sends to a tasked fs delegate for each transaction. The
+ * parameters of the request are in the transaction storage; once the delegate has
+ * written the result there, it finishes the transaction with {g_fs_set_transaction_status}.
+ */
+typedef struct {
+	g_fs_tasked_delegate_request_type type;
+	g_fs_transaction_id transaction;
+}__attribute__((packed)) g_fs_tasked_delegate_request;
+
 /**
  * Status codes for the {g_fs_open} system call
  */
@@ -162,6 +181,7 @@ typedef int g_fs_write_status;
 #define G_FS_WRITE_NOT_SUPPORTED ((g_fs_write_status) 2)
 #define G_FS_WRITE_BUSY ((g_fs_write_status) 3)
 #define G_FS_WRITE_ERROR ((g_fs_write_status) 4)
+#define G_FS_WRITE_NO_SPACE ((g_fs_write_status) 5)
 
 /**
  * Status codes for the {g_fs_close} system call
@@ -172,6 +192,15 @@ typedef int g_fs_close_status;
 #define G_FS_CLOSE_BUSY ((g_fs_close_status) 2)
 #define G_FS_CLOSE_ERROR ((g_fs_close_status) 3)
 
+/**
+ * Status codes for the {g_unlink} system call
+ */
+typedef int g_fs_unlink_status;
+#define G_FS_UNLINK_SUCCESSFUL ((g_fs_unlink_status) 0)
+#define G_FS_UNLINK_NOT_FOUND ((g_fs_unlink_status) 1)
+#define G_FS_UNLINK_NOT_SUPPORTED ((g_fs_unlink_status) 2)
+#define G_FS_UNLINK_ERROR ((g_fs_unlink_status) 3)
+
 /**
  * Status codes for the {g_fs_seek} system call
  */
@@ -261,9 +290,14 @@ typedef struct {
 
 /**
  * Transaction storage structures (NOTE limited to 1 page!)
+ *
+ * For reads and writes, the data is exchanged through the buffer at "mapped_buffer",
+ * which is shared with the kernel and is at most "mapping_pages" pages large. The
+ * kernel splits larger requests into multiple transactions.
  */
 typedef struct {
 	g_fs_phys_id parent_phys_fs_id;
+	g_fs_virt_id parent_virt_fs_id;
 	char name[G_FILENAME_MAX];
 
 	g_fs_discovery_status result_status;
@@ -290,14 +324,14 @@ typedef struct {
 	int32_t mapping_pages;
 
 	int64_t result_write;
-	g_fs_read_status result_status;
+	g_fs_write_status result_status;
 } g_fs_tasked_delegate_transaction_storage_write;
 
 typedef struct {
 	g_fs_phys_id phys_fs_id;
 
 	int64_t result_length;
-	g_fs_read_status result_status;
+	g_fs_length_status result_status;
 } g_fs_tasked_delegate_transaction_storage_get_length;
 
 typedef struct {
@@ -310,6 +344,7 @@ typedef struct {
 typedef struct {
 	g_fs_phys_id phys_fs_id;
 	char name[G_FILENAME_MAX];
+	g_file_flag_mode flags;
 
 	g_fs_open_status result_status;
 } g_fs_tasked_delegate_transaction_storage_open;
@@ -320,6 +355,16 @@ typedef struct {
 	g_fs_close_status result_status;
 } g_fs_tasked_delegate_transaction_storage_close;
 
+typedef union {
+	g_fs_tasked_delegate_transaction_storage_discovery discovery;
+	g_fs_tasked_delegate_transaction_storage_read read;
+	g_fs_tasked_delegate_transaction_storage_write write;
+	g_fs_tasked_delegate_transaction_storage_get_length get_length;
+	g_fs_tasked_delegate_transaction_storage_directory_refresh directory_refresh;
+	g_fs_tasked_delegate_transaction_storage_open open;
+	g_fs_tasked_delegate_transaction_storage_close close;
+} g_fs_tasked_delegate_transaction_storage;
+
 __END_C
 
 #endif
@@ -0,0 +1,140 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GHOST_IO_RING__
+#define __GHOST_IO_RING__
+
+#include "ghost/common.h"
+#include "ghost/stdint.h"
+#include "ghost/fs.h"
+
+__BEGIN_C
+
+typedef int32_t g_io_ring_id;
+
+/**
+ * Maximum number of submission entries of a ring. The completion queue
+ * always has twice as many entries as the submission queue.
+ */
+#define G_IO_RING_MAXIMUM_ENTRIES	1024
+
+/**
+ * Operations that can be submitted
+ */
+typedef uint8_t g_io_op;
+#define G_IO_OP_NOP					((g_io_op) 0)	// completes immediately
+#define G_IO_OP_READ				((g_io_op) 1)	// reads "length" bytes from "fd" at "offset" into "buffer"
+#define G_IO_OP_WRITE				((g_io_op) 2)	// writes "length" bytes from "buffer" to "fd" at "offset"
+#define G_IO_OP_OPEN				((g_io_op) 3)	// opens the path in "buffer" with "flags", result is the fd
+#define G_IO_OP_CLOSE				((g_io_op) 4)	// closes "fd"
+#define G_IO_OP_TIMEOUT				((g_io_op) 5)	// completes after "offset" milliseconds
+
+/**
+ * Offset for reads and writes that use and advance the descriptor offset
+ */
+#define G_IO_OFFSET_CURRENT			((uint64_t) -1)
+
+/**
+ * Status of a completed operation
+ */
+typedef int32_t g_io_status;
+#define G_IO_STATUS_SUCCESSFUL		((g_io_status) 0)
+#define G_IO_STATUS_INVALID_FD		((g_io_status) 1)
+#define G_IO_STATUS_BUSY			((g_io_status) 2)	// a non-blocking node was not ready
+#define G_IO_STATUS_NOT_FOUND		((g_io_status) 3)
+#define G_IO_STATUS_ERROR			((g_io_status) 4)
+#define G_IO_STATUS_INVALID_OP		((g_io_status) 5)
+#define G_IO_STATUS_TIMED_OUT		((g_io_status) 6)	// regular result of a timeout operation
+
+/**
+ * Status codes for the ring system calls
+ */
+typedef int g_io_ring_status;
+#define G_IO_RING_STATUS_SUCCESSFUL			((g_io_ring_status) 0)
+#define G_IO_RING_STATUS_INVALID_ARGUMENTS	((g_io_ring_status) 1)
+#define G_IO_RING_STATUS_INVALID_RING		((g_io_ring_status) 2)
+#define G_IO_RING_STATUS_NO_MEMORY			((g_io_ring_status) 3)
+#define G_IO_RING_STATUS_TIMED_OUT			((g_io_ring_status) 4)
+
+/**
+ * Submission queue entry
+ */
+typedef struct {
+	g_io_op opcode;
+	uint8_t reserved[3];
+	g_fd fd;
+	void* buffer;
+	uint32_t length;
+	uint32_t flags;
+	uint64_t offset;
+	uint64_t user_data;
+}__attribute__((packed)) g_io_submission;
+
+/**
+ * Completion queue entry
+ */
+typedef struct {
+	uint64_t user_data;
+	int64_t result;
+	g_io_status status;
+	g_io_op opcode;
+	uint8_t reserved[3];
+}__attribute__((packed)) g_io_completion;
+
+/**
+ * Indices of a queue. The producer advances the tail, the consumer the head;
+ * both wrap around and are masked to get the slot of an entry.
+ */
+typedef struct {
+	volatile uint32_t head;
+	volatile uint32_t tail;
+	uint32_t mask;
+	uint32_t entries;
+}__attribute__((packed)) g_io_ring_queue;
+
+/**
+ * Header at the start of the memory shared between kernel and process. The
+ * entry arrays are located at the given offsets from the header.
+ */
+typedef struct {
+	g_io_ring_queue submission;
+	g_io_ring_queue completion;
+	uint32_t submissions_offset;
+	uint32_t completions_offset;
+}__attribute__((packed)) g_io_ring_header;
+
+/**
+ * Userspace handle of a ring
+ */
+typedef struct {
+	g_io_ring_id id;
+	g_io_ring_header* header;
+	g_io_submission* submissions;
+	g_io_completion* completions;
+
+	/**
+	 * Tail of prepared but not yet submitted entries
+	 */
+	uint32_t submission_tail;
+} g_io_ring;
+
+__END_C
+
+#endif
@@ -46,6 +46,21 @@ typedef uint8_t g_security_level;
 #define G_SECURITY_LEVEL_DRIVER 1
 #define G_SECURITY_LEVEL_APPLICATION 2
 
+/**
+ * Kernel log levels, messages below the current level are not logged
+ */
+typedef uint8_t g_log_level;
+
+#define G_LOG_LEVEL_DEBUG 0
+#define G_LOG_LEVEL_INFO 1
+#define G_LOG_LEVEL_WARN 2
+#define G_LOG_LEVEL_NONE 3
+
+/**
+ * Value for the log configuration call to leave a setting unchanged
+ */
+#define G_LOG_CONFIGURE_KEEP 0xFF
+
 /**
  * Required for thread-local storage. GS contains the index of the segment
  * which points to this structure (System V ABI for x86). With segment-relative
@@ -45,6 +45,16 @@ typedef int g_kernquery_status;
 #define G_KERNQUERY_TASK_LIST 0x601
 #define G_KERNQUERY_TASK_GET_BY_ID 0x602
 
+#define G_KERNQUERY_CPU_COUNT 0x700
+#define G_KERNQUERY_CPU_GET 0x701
+
+#define G_KERNQUERY_MEMORY_GET 0x800
+
+#define G_KERNQUERY_STATISTICS_GET 0x900
+
+#define G_KERNQUERY_BOOT_COUNT 0xA00
+#define G_KERNQUERY_BOOT_GET 0xA01
+
 /**
  * PCI
  */
@@ -95,6 +105,10 @@ typedef struct
 /**
  * Used in the {G_KERNQUERY_TASK_GET_BY_ID} query to retrieve
  * information about a specific task.
+ *
+ * The memory values are those of the process that the task belongs to; the
+ * resident size is reported in memory_used. CPU times are in microseconds, the
+ * process CPU times include all tasks of the process that ever existed.
  */
 typedef struct
 {
@@ -107,8 +121,124 @@ typedef struct
 	char source_path[G_PATH_MAX];
 
 	g_virtual_address memory_used;
+	uint32_t syscall_count;
+
+	uint32_t memory_virtual;
+	uint64_t cpu_time_user;
+	uint64_t cpu_time_kernel;
+	uint64_t process_cpu_time_user;
+	uint64_t process_cpu_time_kernel;
+	uint32_t processor;
+	g_thread_status status;
 } __attribute__((packed)) g_kernquery_task_get_data;
 
+/**
+ * Used in the {G_KERNQUERY_CPU_COUNT} query to retrieve the number
+ * of processors.
+ */
+typedef struct
+{
+	uint32_t count;
+} __attribute__((packed)) g_kernquery_cpu_count_data;
+
+/**
+ * Used in the {G_KERNQUERY_CPU_GET} query to retrieve the time that a
+ * processor spent idling and running tasks, in microseconds.
+ */
+typedef struct
+{
+	uint32_t position;
+
+	uint8_t found;
+
+	uint64_t idle_time;
+	uint64_t busy_time;
+	uint32_t task_count;
+} __attribute__((packed)) g_kernquery_cpu_get_data;
+
+/**
+ * Used in the {G_KERNQUERY_MEMORY_GET} query to retrieve the usage
+ * of physical memory, the kernel heap, the page cache and the tmpfs.
+ */
+typedef struct
+{
+	uint32_t physical_total_pages;
+	uint32_t physical_free_pages;
+
+	uint32_t heap_used;
+	uint32_t heap_size;
+
+	uint32_t page_cache_pages;
+	uint32_t page_cache_hits;
+	uint32_t page_cache_misses;
+
+	uint32_t tmpfs_used;
+	uint32_t tmpfs_limit;
+} __attribute__((packed)) g_kernquery_memory_get_data;
+
+/**
+ * Used in the {G_KERNQUERY_STATISTICS_GET} query to retrieve the counters
+ * of message, pipe, file and log operations since boot.
+ */
+typedef struct
+{
+	uint32_t messages_sent;
+	uint32_t messages_received;
+	uint64_t message_bytes;
+
+	uint32_t pipe_reads;
+	uint32_t pipe_writes;
+	uint64_t pipe_bytes_read;
+	uint64_t pipe_bytes_written;
+
+	uint32_t fs_opens;
+	uint32_t fs_closes;
+	uint32_t fs_reads;
+	uint32_t fs_writes;
+	uint64_t fs_bytes_read;
+	uint64_t fs_bytes_written;
+
+	uint32_t log_messages;
+	uint32_t log_dropped;
+} __attribute__((packed)) g_kernquery_statistics_get_data;
+
+/**
+ * Maximum length of a boot phase name, including the terminating null.
+ */
+#define G_KERNQUERY_BOOT_PHASE_NAME_MAX 32
+
+/**
+ * Used in the {G_KERNQUERY_BOOT_COUNT} query to retrieve the number of
+ * recorded boot phases. All times are in microseconds; "kernel_entry" is
+ * measured from processor reset, "total" from kernel entry until the desktop
+ * is up and is only valid once the boot is "finished".
+ */
+typedef struct
+{
+	uint32_t count;
+	uint8_t finished;
+
+	uint64_t kernel_entry;
+	uint64_t total;
+} __attribute__((packed)) g_kernquery_boot_count_data;
+
+/**
+ * Used in the {G_KERNQUERY_BOOT_GET} query to retrieve a single boot phase.
+ * The start is measured in microseconds from kernel entry.
+ */
+typedef struct
+{
+	uint32_t position;
+
+	uint8_t found;
+
+	char name[G_KERNQUERY_BOOT_PHASE_NAME_MAX];
+	uint32_t processor;
+	uint8_t finished;
+	uint64_t start;
+	uint64_t duration;
+} __attribute__((packed)) g_kernquery_boot_get_data;
+
 __END_C
 
 #endif
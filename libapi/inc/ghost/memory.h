@@ -22,6 +22,7 @@
 #define __GHOST_MEMORY__
 
 #include "ghost/common.h"
+#include "ghost/stdint.h"
 
 __BEGIN_C
 
@@ -40,6 +41,33 @@ __BEGIN_C
 #define G_TABLE_IN_DIRECTORY_INDEX(address)	((uint32_t)((address / G_PAGE_SIZE) / 1024))
 #define G_PAGE_IN_TABLE_INDEX(address)		((uint32_t)((address / G_PAGE_SIZE) % 1024))
 
+/**
+ * Protection flags of a memory mapping
+ */
+typedef uint32_t g_memory_protection;
+#define G_MEMORY_PROTECTION_NONE			((g_memory_protection) 0)
+#define G_MEMORY_PROTECTION_READ			((g_memory_protection) (1 << 0))
+#define G_MEMORY_PROTECTION_WRITE			((g_memory_protection) (1 << 1))
+#define G_MEMORY_PROTECTION_EXECUTE			((g_memory_protection) (1 << 2))
+
+/**
+ * Flags of a memory mapping
+ */
+typedef uint32_t g_memory_map_flags;
+#define G_MEMORY_MAP_SHARED					((g_memory_map_flags) (1 << 0))	// writes are carried through to the file
+#define G_MEMORY_MAP_PRIVATE				((g_memory_map_flags) (1 << 1))	// writes stay in the process
+#define G_MEMORY_MAP_ANONYMOUS				((g_memory_map_flags) (1 << 2))	// zero-filled memory without file
+
+/**
+ * Status codes for memory mapping
+ */
+typedef int g_memory_map_status;
+#define G_MEMORY_MAP_STATUS_SUCCESSFUL			((g_memory_map_status) 0)
+#define G_MEMORY_MAP_STATUS_INVALID_ARGUMENTS	((g_memory_map_status) 1)
+#define G_MEMORY_MAP_STATUS_INVALID_FD			((g_memory_map_status) 2)
+#define G_MEMORY_MAP_STATUS_ACCESS_DENIED		((g_memory_map_status) 3)
+#define G_MEMORY_MAP_STATUS_NO_MEMORY			((g_memory_map_status) 4)
+
 __END_C
 
 #endif
@@ -0,0 +1,105 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+#ifndef __GHOST_PROFILER__
+#define __GHOST_PROFILER__
+
+#include "ghost/common.h"
+#include "ghost/stdint.h"
+
+__BEGIN_C
+
+/**
+ * Maximum number of return addresses stored per sample, including the
+ * interrupted instruction pointer in the first slot.
+ */
+#define G_PROFILER_MAX_FRAMES			8
+
+/**
+ * Maximum length of a module name, including the terminating null.
+ */
+#define G_PROFILER_MODULE_NAME_MAX		128
+
+/**
+ * A single sample taken by the timer interrupt. The frames are the interrupted
+ * instruction pointer followed by the return addresses found by walking the
+ * frame pointer chain of the interrupted code.
+ */
+typedef struct
+{
+	uint64_t timestamp;
+	int32_t task;
+	int32_t process;
+	uint16_t processor;
+	uint8_t kernel;
+	uint8_t depth;
+	uint32_t frames[G_PROFILER_MAX_FRAMES];
+} __attribute__((packed)) g_profiler_sample;
+
+/**
+ * An ELF object loaded into a process. The name of the executable is its path,
+ * shared libraries are named as they were loaded from the library directory.
+ */
+typedef struct
+{
+	int32_t process;
+	uint32_t start;
+	uint32_t end;
+	uint32_t base;
+	char name[G_PROFILER_MODULE_NAME_MAX];
+} __attribute__((packed)) g_profiler_module;
+
+/**
+ * Commands for the profiler control call
+ */
+typedef uint8_t g_profiler_command;
+#define G_PROFILER_COMMAND_START		((g_profiler_command) 0)	// starts sampling every "interval" timer ticks
+#define G_PROFILER_COMMAND_STOP			((g_profiler_command) 1)	// stops sampling
+#define G_PROFILER_COMMAND_RESET		((g_profiler_command) 2)	// clears all sample buffers
+#define G_PROFILER_COMMAND_READ			((g_profiler_command) 3)	// copies the samples of one processor
+#define G_PROFILER_COMMAND_MODULES		((g_profiler_command) 4)	// copies the loaded objects of one process
+#define G_PROFILER_COMMAND_INFO			((g_profiler_command) 5)	// fills the information fields only
+
+typedef uint8_t g_profiler_status;
+#define G_PROFILER_STATUS_SUCCESSFUL	((g_profiler_status) 0)
+#define G_PROFILER_STATUS_NOT_AVAILABLE	((g_profiler_status) 1)	// kernel was built without the profiler
+#define G_PROFILER_STATUS_ERROR			((g_profiler_status) 2)
+
+/**
+ * Header of a profile dump file, followed by "module_count" modules and
+ * "sample_count" samples.
+ */
+#define G_PROFILER_DUMP_MAGIC			0x46525047	// "GPRF"
+#define G_PROFILER_DUMP_VERSION			1
+
+typedef struct
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t interval;
+	uint32_t ticks_per_microsecond;
+	uint32_t module_count;
+	uint32_t sample_count;
+} __attribute__((packed)) g_profiler_dump_header;
+
+__END_C
+
+#endif
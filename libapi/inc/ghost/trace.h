@@ -0,0 +1,89 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GHOST_TRACE__
+#define __GHOST_TRACE__
+
+#include "ghost/common.h"
+#include "ghost/stdint.h"
+
+__BEGIN_C
+
+/**
+ * Types of events recorded by the kernel tracepoints
+ */
+typedef uint16_t g_trace_event_type;
+#define G_TRACE_EVENT_SWITCH			((g_trace_event_type) 1)	// arg1: previous task, arg2: next task
+#define G_TRACE_EVENT_SYSCALL_ENTER		((g_trace_event_type) 2)	// arg1: call id
+#define G_TRACE_EVENT_SYSCALL_EXIT		((g_trace_event_type) 3)	// arg1: call id
+#define G_TRACE_EVENT_IRQ_ENTER			((g_trace_event_type) 4)	// arg1: irq
+#define G_TRACE_EVENT_IRQ_EXIT			((g_trace_event_type) 5)	// arg1: irq
+#define G_TRACE_EVENT_PAGE_FAULT		((g_trace_event_type) 6)	// arg1: accessed address, arg2: instruction pointer
+#define G_TRACE_EVENT_MESSAGE_SEND		((g_trace_event_type) 7)	// arg1: receiver, arg2: length
+#define G_TRACE_EVENT_MESSAGE_RECEIVE	((g_trace_event_type) 8)	// arg1: sender, arg2: length
+#define G_TRACE_EVENT_WAKE				((g_trace_event_type) 9)	// arg1: woken task
+#define G_TRACE_EVENT_MEMORY_MAP		((g_trace_event_type) 10)	// arg1: address, arg2: pages
+
+/**
+ * A single recorded event. The timestamp is in time stamp counter ticks
+ * of the processor that recorded the event.
+ */
+typedef struct
+{
+	uint64_t timestamp;
+	int32_t task;
+	g_trace_event_type type;
+	uint16_t processor;
+	uint32_t arg1;
+	uint32_t arg2;
+} __attribute__((packed)) g_trace_event;
+
+/**
+ * Commands for the tracing control call
+ */
+typedef uint8_t g_trace_command;
+#define G_TRACE_COMMAND_START			((g_trace_command) 0)	// starts recording
+#define G_TRACE_COMMAND_STOP			((g_trace_command) 1)	// stops recording
+#define G_TRACE_COMMAND_RESET			((g_trace_command) 2)	// clears all rings
+#define G_TRACE_COMMAND_READ			((g_trace_command) 3)	// copies the events of one processor
+#define G_TRACE_COMMAND_INFO			((g_trace_command) 4)	// fills the information fields only
+
+typedef uint8_t g_trace_status;
+#define G_TRACE_STATUS_SUCCESSFUL		((g_trace_status) 0)
+#define G_TRACE_STATUS_NOT_AVAILABLE	((g_trace_status) 1)	// kernel was built without tracing
+#define G_TRACE_STATUS_ERROR			((g_trace_status) 2)
+
+/**
+ * Header of a trace dump file, followed by "event_count" events.
+ */
+#define G_TRACE_DUMP_MAGIC				0x43525447	// "GTRC"
+#define G_TRACE_DUMP_VERSION			1
+
+typedef struct
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t ticks_per_microsecond;
+	uint32_t event_count;
+} __attribute__((packed)) g_trace_dump_header;
+
+__END_C
+
+#endif
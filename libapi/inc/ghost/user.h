@@ -24,10 +24,13 @@
 #include "ghost/calls/calls.h"
 #include "ghost/common.h"
 #include "ghost/fs.h"
+#include "ghost/ioring.h"
 #include "ghost/ipc.h"
 #include "ghost/kernel.h"
 #include "ghost/ramdisk.h"
 #include "ghost/system.h"
+#include "ghost/trace.h"
+#include "ghost/profiler.h"
 #include "ghost/types.h"
 #include <stdarg.h>
 #include <stddef.h>
@@ -197,6 +200,19 @@ g_fd g_open_fs(const char* path, g_file_flag_mode flags, g_fs_open_status* out_s
  */
 g_fs_close_status g_close(g_fd fd);
 
+/**
+ * Removes a file from its folder. The content is deleted once no file
+ * descriptor refers to it anymore.
+ *
+ * @param path
+ * 		path of the file
+ *
+ * @return one of the {g_fs_unlink_status} codes
+ *
+ * @security-level APPLICATION
+ */
+g_fs_unlink_status g_unlink(const char* path);
+
 /**
  * Retrieves the length of a file in bytes.
  *
@@ -371,6 +387,178 @@ int32_t g_read_s(g_fd fd, void* buffer, uint64_t length, g_fs_read_status* out_s
 int32_t g_write(g_fd fd, const void* buffer, uint64_t length);
 int32_t g_write_s(g_fd fd, const void* buffer, uint64_t length, g_fs_write_status* out_status);
 
+/**
+ * Reads bytes from the file at the given offset. The offset of the
+ * file descriptor is neither used nor changed.
+ *
+ * @param fd
+ * 		the file descriptor
+ * @param buffer
+ * 		the target buffer
+ * @param length
+ * 		the length in bytes
+ * @param offset
+ * 		the absolute offset in the file
+ * @param-opt out_status
+ * 		filled with one of the {g_fs_read_status} codes
+ *
+ * @return if the read was successful the length of bytes or
+ * 		zero if EOF, otherwise -1
+ *
+ * @security-level APPLICATION
+ */
+int32_t g_read_at(g_fd fd, void* buffer, uint64_t length, uint64_t offset);
+int32_t g_read_at_s(g_fd fd, void* buffer, uint64_t length, uint64_t offset, g_fs_read_status* out_status);
+
+/**
+ * Writes bytes to the file at the given offset. The offset of the
+ * file descriptor is neither used nor changed.
+ *
+ * @param fd
+ * 		the file descriptor
+ * @param buffer
+ * 		the source buffer
+ * @param length
+ * 		the length in bytes
+ * @param offset
+ * 		the absolute offset in the file
+ * @param-opt out_status
+ * 		filled with one of the {g_fs_write_status} codes
+ *
+ * @return if successful the number of bytes that were written, otherwise -1
+ *
+ * @security-level APPLICATION
+ */
+int32_t g_write_at(g_fd fd, const void* buffer, uint64_t length, uint64_t offset);
+int32_t g_write_at_s(g_fd fd, const void* buffer, uint64_t length, uint64_t offset, g_fs_write_status* out_status);
+
+/**
+ * Reads bytes from the file into multiple buffers with a single call.
+ *
+ * @param fd
+ * 		the file descriptor
+ * @param vector
+ * 		the segments to fill in order
+ * @param count
+ * 		the number of segments, at most {G_FS_IOVEC_MAX}
+ * @param-opt offset
+ * 		the absolute offset in the file, or -1 to use the offset
+ * 		of the file descriptor
+ * @param-opt out_status
+ * 		filled with one of the {g_fs_read_status} codes
+ *
+ * @return the total number of bytes read, zero if EOF, otherwise -1
+ *
+ * @security-level APPLICATION
+ */
+int32_t g_read_vector(g_fd fd, const g_fs_iovec* vector, int32_t count);
+int32_t g_read_vector_s(g_fd fd, const g_fs_iovec* vector, int32_t count, int64_t offset, g_fs_read_status* out_status);
+
+/**
+ * Writes multiple buffers to the file with a single call.
+ *
+ * @param fd
+ * 		the file descriptor
+ * @param vector
+ * 		the segments to write in order
+ * @param count
+ * 		the number of segments, at most {G_FS_IOVEC_MAX}
+ * @param-opt offset
+ * 		the absolute offset in the file, or -1 to use the offset
+ * 		of the file descriptor
+ * @param-opt out_status
+ * 		filled with one of the {g_fs_write_status} codes
+ *
+ * @return the total number of bytes written, otherwise -1
+ *
+ * @security-level APPLICATION
+ */
+int32_t g_write_vector(g_fd fd, const g_fs_iovec* vector, int32_t count);
+int32_t g_write_vector_s(g_fd fd, const g_fs_iovec* vector, int32_t count, int64_t offset, g_fs_write_status* out_status);
+
+/**
+ * Creates a ring for asynchronous I/O. Operations are prepared in the submission queue
+ * with {g_io_ring_get_submission}, handed to the kernel with {g_io_ring_submit} and
+ * executed in submission order by a kernel worker of the process. Results are posted
+ * to the completion queue.
+ *
+ * @param entries
+ * 		number of submission entries, at most {G_IO_RING_MAXIMUM_ENTRIES}
+ * @param ring
+ * 		handle that is filled with the ring information
+ *
+ * @return one of the {g_io_ring_status} codes
+ *
+ * @security-level APPLICATION
+ */
+g_io_ring_status g_io_ring_create(uint32_t entries, g_io_ring* ring);
+
+/**
+ * Returns the next free submission entry, or 0 if the queue is full. The entry
+ * is passed to the kernel with the next call to {g_io_ring_submit}.
+ *
+ * @param ring
+ * 		the ring
+ *
+ * @return the cleared submission entry
+ *
+ * @security-level APPLICATION
+ */
+g_io_submission* g_io_ring_get_submission(g_io_ring* ring);
+
+/**
+ * Publishes all prepared submissions, wakes the kernel worker and optionally
+ * waits for completions.
+ *
+ * @param ring
+ * 		the ring
+ * @param wait_for
+ * 		number of completions that must be available before returning
+ * @param-opt timeout
+ * 		maximum time to wait in milliseconds, 0 waits without limit
+ * @param-opt out_status
+ * 		filled with one of the {g_io_ring_status} codes
+ *
+ * @return the number of available completions
+ *
+ * @security-level APPLICATION
+ */
+uint32_t g_io_ring_submit(g_io_ring* ring, uint32_t wait_for);
+uint32_t g_io_ring_submit_s(g_io_ring* ring, uint32_t wait_for, uint32_t timeout, g_io_ring_status* out_status);
+
+/**
+ * Returns the oldest completion without removing it, or 0 if there is none.
+ *
+ * @param ring
+ * 		the ring
+ *
+ * @security-level APPLICATION
+ */
+g_io_completion* g_io_ring_peek_completion(g_io_ring* ring);
+
+/**
+ * Removes the oldest completion, freeing its slot for the kernel.
+ *
+ * @param ring
+ * 		the ring
+ *
+ * @security-level APPLICATION
+ */
+void g_io_ring_advance_completion(g_io_ring* ring);
+
+/**
+ * Destroys the ring. Operations that wait for a pipe or timeout are discarded
+ * without a completion.
+ *
+ * @param ring
+ * 		the ring
+ *
+ * @return one of the {g_io_ring_status} codes
+ *
+ * @security-level APPLICATION
+ */
+g_io_ring_status g_io_ring_destroy(g_io_ring* ring);
+
 /**
  * Returns the next transaction id that can be used for messaging.
  * When sending a message, a transaction can be added so that one can wait
@@ -618,6 +806,48 @@ void* g_map_mmio(void* addr, uint32_t size);
  */
 void g_unmap(void* area);
 
+/**
+ * Maps a file or anonymous memory into the address space of the current process. Pages
+ * are loaded lazily when first accessed.
+ *
+ * Private file mappings are copies of the file content, writes are not visible in the file.
+ * Shared file mappings write modified pages back to the file when they are unmapped or
+ * when the process exits; other processes see the changes only after that.
+ *
+ * @param length
+ * 		number of bytes to map
+ * @param protection
+ * 		combination of {g_memory_protection} flags
+ * @param flags
+ * 		combination of {g_memory_map_flags}, either shared or private must be set
+ * @param fd
+ * 		the file to map, ignored for anonymous mappings
+ * @param offset
+ * 		page-aligned offset within the file
+ * @param-opt out_status
+ * 		filled with one of the {g_memory_map_status} codes
+ *
+ * @return the address of the mapping or 0 if failed
+ *
+ * @security-level APPLICATION
+ */
+void* g_memory_map(uint32_t length, g_memory_protection protection, g_memory_map_flags flags, g_fd fd, uint64_t offset);
+void* g_memory_map_s(uint32_t length, g_memory_protection protection, g_memory_map_flags flags, g_fd fd, uint64_t offset, g_memory_map_status* out_status);
+
+/**
+ * Removes a mapping that was created with {g_memory_map}. Only whole mappings can be removed.
+ *
+ * @param address
+ * 		the address of the mapping
+ * @param length
+ * 		the length that was passed when mapping
+ *
+ * @return one of the {g_memory_map_status} codes
+ *
+ * @security-level APPLICATION
+ */
+g_memory_map_status g_memory_unmap(void* address, uint32_t length);
+
 /**
  * Adjusts the program heap break.
  *
@@ -678,6 +908,32 @@ void* g_lower_malloc(uint32_t size);
  */
 void g_set_video_log(uint8_t enabled);
 
+/**
+ * Sets the minimum level of kernel log messages. Messages that are not compiled
+ * into the kernel can not be enabled.
+ *
+ * @param level
+ * 		one of the G_LOG_LEVEL_* constants or G_LOG_CONFIGURE_KEEP
+ *
+ * @return the previous level
+ *
+ * @security-level DRIVER
+ */
+g_log_level g_set_log_level(g_log_level level);
+
+/**
+ * Enables or disables asynchronous logging. When enabled, log messages are queued
+ * per processor and written to the outputs by a kernel thread.
+ *
+ * @param enabled
+ * 		whether to enable asynchronous logging or G_LOG_CONFIGURE_KEEP
+ *
+ * @return whether it was enabled before
+ *
+ * @security-level DRIVER
+ */
+uint8_t g_set_log_async(uint8_t enabled);
+
 /**
  * TODO: currently returns the number of milliseconds that one
  * of the schedulers is running.
@@ -859,6 +1115,124 @@ g_open_irq_device_status g_open_irq_device(uint8_t irq, g_fd* outFd);
  */
 g_kernquery_status g_kernquery(uint16_t command, uint8_t* buffer);
 
+/**
+ * Starts, stops or resets the recording of kernel trace events.
+ *
+ * @param command
+ * 		one of G_TRACE_COMMAND_START, G_TRACE_COMMAND_STOP or G_TRACE_COMMAND_RESET
+ *
+ * @return one of the {g_trace_status} codes
+ *
+ * @security-level DRIVER
+ */
+g_trace_status g_trace_control(g_trace_command command);
+
+/**
+ * Returns the number of processors that record trace events and the number of
+ * time stamp counter ticks per microsecond used for the timestamps.
+ *
+ * @return one of the {g_trace_status} codes
+ *
+ * @security-level DRIVER
+ */
+g_trace_status g_trace_info(uint32_t* outProcessors, uint32_t* outTicksPerMicrosecond);
+
+/**
+ * Copies the most recent trace events of a processor, oldest first. Tracing should
+ * be stopped while reading, otherwise events may be overwritten during the copy.
+ *
+ * @param processor
+ * 		processor to read the events of
+ * @param buffer
+ * 		target buffer
+ * @param capacity
+ * 		number of events that fit into the buffer
+ * @param outCount
+ * 		receives the number of copied events
+ * @param outDropped
+ * 		receives the number of events that were overwritten since the last reset
+ *
+ * @return one of the {g_trace_status} codes
+ *
+ * @security-level DRIVER
+ */
+g_trace_status g_trace_read(uint32_t processor, g_trace_event* buffer, uint32_t capacity, uint32_t* outCount, uint32_t* outDropped);
+
+/**
+ * Starts the sampling profiler. Each processor takes a sample of the interrupted
+ * code every "interval" timer ticks.
+ *
+ * @param interval
+ * 		number of timer ticks between two samples
+ *
+ * @return one of the {g_profiler_status} codes
+ *
+ * @security-level DRIVER
+ */
+g_profiler_status g_profiler_start(uint32_t interval);
+
+/**
+ * Stops or resets the sampling profiler.
+ *
+ * @param command
+ * 		one of G_PROFILER_COMMAND_STOP or G_PROFILER_COMMAND_RESET
+ *
+ * @return one of the {g_profiler_status} codes
+ *
+ * @security-level DRIVER
+ */
+g_profiler_status g_profiler_control(g_profiler_command command);
+
+/**
+ * Returns the number of processors that take samples and the number of
+ * time stamp counter ticks per microsecond used for the timestamps.
+ *
+ * @return one of the {g_profiler_status} codes
+ *
+ * @security-level DRIVER
+ */
+g_profiler_status g_profiler_info(uint32_t* outProcessors, uint32_t* outTicksPerMicrosecond);
+
+/**
+ * Copies the most recent samples of a processor, oldest first. The profiler should
+ * be stopped before reading.
+ *
+ * @param processor
+ * 		processor to read the samples of
+ * @param buffer
+ * 		target buffer
+ * @param capacity
+ * 		number of samples that fit into the buffer
+ * @param outCount
+ * 		receives the number of copied samples
+ * @param outDropped
+ * 		receives the number of samples that were overwritten since the last reset
+ *
+ * @return one of the {g_profiler_status} codes
+ *
+ * @security-level DRIVER
+ */
+g_profiler_status g_profiler_read(uint32_t processor, g_profiler_sample* buffer, uint32_t capacity, uint32_t* outCount, uint32_t* outDropped);
+
+/**
+ * Copies the ELF objects that are loaded into a process, used to resolve the
+ * sampled addresses to symbols.
+ *
+ * @param process
+ * 		id of the process
+ * @param buffer
+ * 		target buffer
+ * @param capacity
+ * 		number of modules that fit into the buffer
+ * @param outCount
+ * 		receives the number of copied modules
+ *
+ * @return one of the {g_profiler_status} codes
+ *
+ * @security-level DRIVER
+ */
+g_profiler_status g_profiler_modules(g_pid process, g_profiler_module* buffer, uint32_t capacity, uint32_t* outCount);
+
 /**
  * Returns and releases the command line arguments for the executing process.
  * This buffer must have a length of at least {PROCESS_COMMAND_LINE_ARGUMENTS_BUFFER_LENGTH} bytes.
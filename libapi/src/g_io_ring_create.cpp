@@ -0,0 +1,40 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/user.h"
+
+/**
+ *
+ */
+g_io_ring_status g_io_ring_create(uint32_t entries, g_io_ring* ring) {
+
+	g_syscall_io_ring_create data;
+	data.entries = entries;
+	g_syscall(G_SYSCALL_IO_RING_CREATE, (g_address) &data);
+
+	if (data.status == G_IO_RING_STATUS_SUCCESSFUL) {
+		ring->id = data.id;
+		ring->header = data.header;
+		ring->submissions = (g_io_submission*) (((uint8_t*) data.header) + data.header->submissions_offset);
+		ring->completions = (g_io_completion*) (((uint8_t*) data.header) + data.header->completions_offset);
+		ring->submission_tail = data.header->submission.tail;
+	}
+	return data.status;
+}
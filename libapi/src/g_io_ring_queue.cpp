@@ -0,0 +1,66 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/user.h"
+
+/**
+ *
+ */
+g_io_submission* g_io_ring_get_submission(g_io_ring* ring) {
+
+	g_io_ring_queue* queue = &ring->header->submission;
+	if (ring->submission_tail - queue->head >= queue->entries) {
+		return 0;
+	}
+
+	g_io_submission* submission = &ring->submissions[ring->submission_tail & queue->mask];
+	++ring->submission_tail;
+
+	uint8_t* clear = (uint8_t*) submission;
+	for (uint32_t i = 0; i < sizeof(g_io_submission); i++) {
+		clear[i] = 0;
+	}
+	return submission;
+}
+
+/**
+ *
+ */
+g_io_completion* g_io_ring_peek_completion(g_io_ring* ring) {
+
+	g_io_ring_queue* queue = &ring->header->completion;
+	uint32_t head = queue->head;
+	if (head == queue->tail) {
+		return 0;
+	}
+
+	// read the entry only after seeing the tail
+	__sync_synchronize();
+	return &ring->completions[head & queue->mask];
+}
+
+/**
+ *
+ */
+void g_io_ring_advance_completion(g_io_ring* ring) {
+
+	__sync_synchronize();
+	ring->header->completion.head = ring->header->completion.head + 1;
+}
@@ -0,0 +1,47 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/user.h"
+
+// redirect
+uint32_t g_io_ring_submit(g_io_ring* ring, uint32_t wait_for) {
+	return g_io_ring_submit_s(ring, wait_for, 0, 0);
+}
+
+/**
+ *
+ */
+uint32_t g_io_ring_submit_s(g_io_ring* ring, uint32_t wait_for, uint32_t timeout, g_io_ring_status* out_status) {
+
+	// entries must be visible before the kernel sees the new tail
+	__sync_synchronize();
+	ring->header->submission.tail = ring->submission_tail;
+
+	g_syscall_io_ring_enter data;
+	data.id = ring->id;
+	data.wait_for = wait_for;
+	data.timeout = timeout;
+	g_syscall(G_SYSCALL_IO_RING_ENTER, (g_address) &data);
+
+	if (out_status) {
+		*out_status = data.status;
+	}
+	return data.completions;
+}
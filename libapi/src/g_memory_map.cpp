@@ -0,0 +1,44 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/user.h"
+
+// redirect
+void* g_memory_map(uint32_t length, g_memory_protection protection, g_memory_map_flags flags, g_fd fd, uint64_t offset) {
+	return g_memory_map_s(length, protection, flags, fd, offset, 0);
+}
+
+/**
+ *
+ */
+void* g_memory_map_s(uint32_t length, g_memory_protection protection, g_memory_map_flags flags, g_fd fd, uint64_t offset, g_memory_map_status* out_status) {
+
+	g_syscall_memory_map data;
+	data.length = length;
+	data.protection = protection;
+	data.flags = flags;
+	data.fd = fd;
+	data.offset = offset;
+	g_syscall(G_SYSCALL_MEMORY_MAP, (g_address) &data);
+	if (out_status) {
+		*out_status = data.status;
+	}
+	return data.address;
+}
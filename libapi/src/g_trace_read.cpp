@@ -0,0 +1,40 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/user.h"
+
+/**
+ *
+ */
+g_trace_status g_trace_read(uint32_t processor, g_trace_event* buffer, uint32_t capacity, uint32_t* outCount, uint32_t* outDropped) {
+
+	g_syscall_trace data;
+	data.command = G_TRACE_COMMAND_READ;
+	data.processor = processor;
+	data.buffer = buffer;
+	data.capacity = capacity;
+	g_syscall(G_SYSCALL_TRACE, (g_address) &data);
+
+	if(outCount)
+		*outCount = data.count;
+	if(outDropped)
+		*outDropped = data.dropped;
+	return data.status;
+}
@@ -23,6 +23,7 @@
 
 #include "ghost/common.h"
 #include "ghost/fs.h"
+#include "ghost/kernel.h"
 #include "sys/types.h"
 #include "stdint.h"
 
@@ -45,7 +46,16 @@ typedef struct FILE FILE;
  */
 struct FILE {
 	g_fd file_descriptor;
+
+	/**
+	 * Recursive stream lock. Uncontended locking only touches the counter,
+	 * the kernel atom is taken up front and is only waited on by threads
+	 * that find the lock held by another thread.
+	 */
 	g_atom lock;
+	volatile int lock_count;
+	volatile g_tid lock_owner;
+	int lock_depth;
 
 	uint8_t* buffer;
 	size_t buffer_size;
@@ -438,6 +438,15 @@ int putc(int c, FILE* stream);
  */
 int putchar(int c);
 
+/**
+ * Equivalents of <getc>, <getchar>, <putc> and <putchar> that do not lock
+ * the stream. The caller must hold the lock, see <flockfile>. (POSIX)
+ */
+int getc_unlocked(FILE* stream);
+int getchar_unlocked();
+int putc_unlocked(int c, FILE* stream);
+int putchar_unlocked(int c);
+
 /**
  * Writes the string <s> to <stdout>, not writing the
  * null-terminator, appending a new-line character. (N1548-7.21.7.9)
@@ -620,6 +629,33 @@ int fileno(FILE* stream);
  */
 FILE* fdopen(int fd, const char *mode);
 
+/**
+ * Acquires the lock of a stream. The lock is recursive and can be held
+ * around multiple operations to make them atomic. (POSIX)
+ *
+ * @param stream
+ * 		the stream to lock
+ */
+void flockfile(FILE* stream);
+
+/**
+ * Acquires the lock of a stream if it is not held by another thread. (POSIX)
+ *
+ * @param stream
+ * 		the stream to lock
+ * @return
+ * 		zero if the lock was acquired, otherwise non-zero
+ */
+int ftrylockfile(FILE* stream);
+
+/**
+ * Releases a lock acquired with <flockfile> or <ftrylockfile>. (POSIX)
+ *
+ * @param stream
+ * 		the stream to unlock
+ */
+void funlockfile(FILE* stream);
+
 /**
  * Formatted writing to the kernel log.
  *
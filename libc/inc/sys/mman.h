@@ -0,0 +1,59 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GHOST_LIBC_SYS_MMAN__
+#define __GHOST_LIBC_SYS_MMAN__
+
+#include "ghost/common.h"
+#include "ghost/memory.h"
+#include "sys/types.h"
+
+__BEGIN_C
+
+// protection flags
+#define PROT_NONE		G_MEMORY_PROTECTION_NONE
+#define PROT_READ		G_MEMORY_PROTECTION_READ
+#define PROT_WRITE		G_MEMORY_PROTECTION_WRITE
+#define PROT_EXEC		G_MEMORY_PROTECTION_EXECUTE
+
+// mapping flags
+#define MAP_SHARED		G_MEMORY_MAP_SHARED
+#define MAP_PRIVATE		G_MEMORY_MAP_PRIVATE
+#define MAP_ANONYMOUS	G_MEMORY_MAP_ANONYMOUS
+#define MAP_ANON		MAP_ANONYMOUS
+#define MAP_FIXED		(1 << 4)	// not supported, mapping fails with EINVAL
+
+#define MAP_FAILED		((void*) -1)
+
+/**
+ * Maps a file or anonymous memory into the address space. The address is only
+ * a hint and is currently ignored.
+ */
+void* mmap(void* addr, size_t length, int prot, int flags, int fd, off_t offset);
+
+/**
+ * Removes a mapping. Only whole mappings can be removed, the address must be
+ * the one returned by mmap.
+ */
+int munmap(void* addr, size_t length);
+
+__END_C
+
+#endif
@@ -0,0 +1,223 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "dlmalloc-config.h"
+#include "malloc.h"
+#include "stdint.h"
+#include "errno.h"
+#include "sys/mman.h"
+
+/**
+ * Number of arenas that threads are spread over. The first arena is the
+ * global dlmalloc heap that grows with sbrk, the others are mspaces that grow
+ * with anonymous mappings.
+ */
+#define MALLOC_ARENA_COUNT		4
+
+typedef void* mspace;
+
+// functions from dlmalloc.c
+void* dlmalloc(size_t bytes);
+void dlfree(void* mem);
+void* dlcalloc(size_t elements, size_t elem_size);
+void* dlrealloc(void* mem, size_t bytes);
+void* dlmemalign(size_t alignment, size_t bytes);
+size_t dlmalloc_usable_size(const void* mem);
+int dlmalloc_trim(size_t pad);
+mspace create_mspace(size_t capacity, int locked);
+size_t destroy_mspace(mspace msp);
+void* mspace_malloc(mspace msp, size_t bytes);
+void* mspace_calloc(mspace msp, size_t elements, size_t elem_size);
+void* mspace_memalign(mspace msp, size_t alignment, size_t bytes);
+int mspace_trim(mspace msp, size_t pad);
+
+/**
+ * Maps memory for dlmalloc. Anonymous mappings are otherwise filled lazily,
+ * so the first access to a buffer from malloc could be made by the kernel
+ * while it executes a system call. The pages are filled right away instead,
+ * like the memory of the global heap.
+ */
+void* __malloc_mmap(size_t size) {
+
+	void* memory = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (memory == MAP_FAILED) {
+		return MAP_FAILED;
+	}
+
+	for (size_t offset = 0; offset < size; offset += G_PAGE_SIZE) {
+		((volatile uint8_t*) memory)[offset] = 0;
+	}
+	return memory;
+}
+
+static mspace arenas[MALLOC_ARENA_COUNT];
+static volatile uint32_t next_arena = 0;
+
+/**
+ * Index of the arena that the executing thread allocates from, assigned
+ * round-robin on its first allocation. Zero until then, so the main thread
+ * and all threads before their first allocation use the global heap.
+ */
+static __thread uint32_t thread_arena = 0;
+static __thread int thread_arena_assigned = 0;
+
+/**
+ * Returns the mspace of the executing thread, or 0 for the global heap.
+ */
+static mspace __malloc_arena() {
+
+	if (!thread_arena_assigned) {
+		thread_arena_assigned = 1;
+		thread_arena = __sync_fetch_and_add(&next_arena, 1) % MALLOC_ARENA_COUNT;
+	}
+
+	if (thread_arena == 0) {
+		return 0;
+	}
+
+	mspace arena = arenas[thread_arena];
+	if (arena) {
+		return arena;
+	}
+
+	// create the arena, another thread might have been faster
+	arena = create_mspace(0, 1);
+	if (!arena) {
+		thread_arena = 0;
+		return 0;
+	}
+	if (!__sync_bool_compare_and_swap(&arenas[thread_arena], 0, arena)) {
+		destroy_mspace(arena);
+		arena = arenas[thread_arena];
+	}
+	return arena;
+}
+
+/**
+ *
+ */
+void* malloc(size_t size) {
+
+	mspace arena = __malloc_arena();
+	if (arena) {
+		return mspace_malloc(arena, size);
+	}
+	return dlmalloc(size);
+}
+
+/**
+ *
+ */
+void free(void* ptr) {
+
+	// the footer of the chunk tells which arena it belongs to
+	dlfree(ptr);
+}
+
+/**
+ *
+ */
+void* calloc(size_t num, size_t size) {
+
+	mspace arena = __malloc_arena();
+	if (arena) {
+		return mspace_calloc(arena, num, size);
+	}
+	return dlcalloc(num, size);
+}
+
+/**
+ *
+ */
+void* realloc(void* ptr, size_t size) {
+
+	// resizes within the arena of the chunk
+	if (ptr) {
+		return dlrealloc(ptr, size);
+	}
+	return malloc(size);
+}
+
+/**
+ *
+ */
+void* memalign(size_t alignment, size_t size) {
+
+	mspace arena = __malloc_arena();
+	if (arena) {
+		return mspace_memalign(arena, alignment, size);
+	}
+	return dlmemalign(alignment, size);
+}
+
+/**
+ *
+ */
+void* aligned_alloc(size_t alignment, size_t size) {
+
+	return memalign(alignment, size);
+}
+
+/**
+ *
+ */
+int posix_memalign(void** memptr, size_t alignment, size_t size) {
+
+	if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+		return EINVAL;
+	}
+
+	void* mem = memalign(alignment, size);
+	if (!mem) {
+		return ENOMEM;
+	}
+	*memptr = mem;
+	return 0;
+}
+
+/**
+ *
+ */
+void* valloc(size_t size) {
+
+	return memalign(4096, size);
+}
+
+/**
+ *
+ */
+size_t malloc_usable_size(void* ptr) {
+
+	return dlmalloc_usable_size(ptr);
+}
+
+/**
+ *
+ */
+int malloc_trim(size_t pad) {
+
+	int released = dlmalloc_trim(pad);
+	for (int i = 1; i < MALLOC_ARENA_COUNT; i++) {
+		if (arenas[i]) {
+			released |= mspace_trim(arenas[i], pad);
+		}
+	}
+	return released;
+}
@@ -23,14 +23,36 @@
 
 /**
  * This is the configuration header for dlmalloc.
+ *
+ * The allocation functions of the library are implemented in arena.c, which
+ * spreads threads over multiple mspaces. Footers are required to find the
+ * mspace of a chunk when it is freed by another thread.
  */
 #define USE_LOCKS			1
-#define HAVE_MMAP			0
+#define USE_DL_PREFIX		1
+#define MSPACES				1
+#define FOOTERS				1
 
-#define LACKS_SYS_MMAN_H	1
+// time() must not be called with a null pointer, derive the magic differently
+#define LACKS_TIME_H		1
+
+/**
+ * Allocations above the threshold get their own anonymous mapping that is
+ * unmapped when they are freed.
+ */
+#define HAVE_MMAP				1
+#define HAVE_MREMAP				0
+#define DEFAULT_MMAP_THRESHOLD	((size_t) 128 * 1024)
+
+/**
+ * Mappings are made through arena.c, which fills their pages right away.
+ */
+#include <stddef.h>
+void* __malloc_mmap(size_t size);
+#define MMAP(s)					__malloc_mmap(s)
+#define DIRECT_MMAP(s)			__malloc_mmap(s)
 
 // TODO try these for error-checking:
 // #define DEBUG			1
-// #define FOOTERS			1
 
 #endif
@@ -30,8 +30,8 @@
  */
 int __fclose_static(FILE* stream)
 {
+	flockfile(stream);
 	g_atom lock = stream->lock;
-	g_atomic_lock(lock);
 	int res = __fclose_static_unlocked(stream);
 	g_atomic_destroy(lock);
 	return res;
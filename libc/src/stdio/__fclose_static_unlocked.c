@@ -45,9 +45,19 @@ int __fclose_static_unlocked(FILE* stream) {
 		free(stream->buffer);
 	}
 
-	// reset contents
+	// reset contents, keeping the lock that the caller holds
+	g_atom lock = stream->lock;
+	int lock_count = stream->lock_count;
+	g_tid lock_owner = stream->lock_owner;
+	int lock_depth = stream->lock_depth;
+
 	memset(stream, 0, sizeof(FILE));
 
+	stream->lock = lock;
+	stream->lock_count = lock_count;
+	stream->lock_owner = lock_owner;
+	stream->lock_depth = lock_depth;
+
 	// remove from open file list
 	__open_file_list_remove(stream);
 
@@ -36,8 +36,10 @@ int __fdopen_static(int fd, const char* mode, FILE* file) {
 		return EOF;
 	}
 
-	// create lock
-	file->lock = g_atomic_initialize();
+	// create lock, unless the stream is reopened
+	if (file->lock == 0) {
+		__stdio_lock_initialize(file);
+	}
 
 	// set file descriptor and flags
 	file->file_descriptor = fd;
@@ -27,8 +27,8 @@
  */
 int __fflush_read(FILE* stream) {
 
-	g_atomic_lock(stream->lock);
+	flockfile(stream);
 	int res = __fflush_read_unlocked(stream);
-	g_atomic_unlock(stream->lock);
+	funlockfile(stream);
 	return res;
 }
@@ -27,8 +27,8 @@
  */
 int __fflush_write(FILE* stream) {
 
-	g_atomic_lock(stream->lock);
+	flockfile(stream);
 	int res = __fflush_write_unlocked(stream);
-	g_atomic_unlock(stream->lock);
+	funlockfile(stream);
 	return res;
 }
@@ -57,30 +57,9 @@ int __fgetc_unlocked(FILE* stream) {
 
 	// check if buffer is empty
 	if (stream->buffered_bytes_read_offset >= stream->buffered_bytes_read) {
-
-		// keep some space for ungetc-calls to avoid moving memory
-		size_t unget_space = G_FILE_UNGET_PRESERVED_SPACE;
-
-		// if buffer is too small, leave no space
-		if (unget_space >= stream->buffer_size) {
-			unget_space = 0;
-		}
-
-		// fill buffer with data
-		ssize_t read = stream->impl_read(stream->buffer + unget_space, stream->buffer_size - unget_space, stream);
-
-		if (read == 0) {
-			stream->flags |= G_FILE_FLAG_EOF;
-			return EOF;
-
-		} else if (read == -1) {
-			stream->flags |= G_FILE_FLAG_ERROR;
+		if (__fillbuf_unlocked(stream) == EOF) {
 			return EOF;
 		}
-
-		// set buffer fields
-		stream->buffered_bytes_read = unget_space + read;
-		stream->buffered_bytes_read_offset = unget_space;
 	}
 
 	return stream->buffer[stream->buffered_bytes_read_offset++];
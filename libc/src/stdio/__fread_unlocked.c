@@ -23,6 +23,30 @@
 #include "string.h"
 #include "errno.h"
 
+/**
+ * Reads directly from the stream implementation into the target memory, until
+ * either all bytes are read or end-of-file or an error occurs.
+ */
+static size_t __fread_direct(uint8_t* dest, size_t len, FILE* stream) {
+
+	size_t done = 0;
+	while (done < len) {
+		ssize_t read = stream->impl_read(dest + done, len - done, stream);
+
+		if (read == 0) {
+			stream->flags |= G_FILE_FLAG_EOF;
+			break;
+
+		} else if (read == -1) {
+			stream->flags |= G_FILE_FLAG_ERROR;
+			break;
+		}
+
+		done += read;
+	}
+	return done;
+}
+
 /**
  *
  */
@@ -47,63 +71,62 @@ size_t __fread_unlocked(const void* ptr, size_t size, size_t nmemb, FILE* stream
 		}
 	}
 
+	// if stream has no read implementation, return with error
+	if (stream->impl_read == NULL) {
+		errno = EBADF;
+		stream->flags |= G_FILE_FLAG_ERROR;
+		return EOF;
+	}
+
+	uint8_t* dest = (uint8_t*) ptr;
+	size_t total = size * nmemb;
+
 	// unbuffered files perform direct read
 	if (stream->buffer_mode == _IONBF) {
 
-		// if stream has no read implementation, return with error
-		if (stream->impl_read == NULL) {
-			errno = EBADF;
-			stream->flags |= G_FILE_FLAG_ERROR;
-			return EOF;
-		}
-
 		// set stream direction
 		stream->flags |= G_FILE_FLAG_BUFFER_DIRECTION_READ;
 
 		// remove end-of-file
 		stream->flags &= ~G_FILE_FLAG_EOF;
 
-		// perform reading
-		size_t res = 0;
-
-		size_t total = size * nmemb;
-		size_t done = 0;
-
-		while (done < total) {
-			// call read implementation
-			uint8_t* pos = &(((uint8_t*) ptr)[done]);
-			ssize_t read = stream->impl_read(pos, total - done, stream);
-
-			if (read == 0) {
-				stream->flags |= G_FILE_FLAG_EOF;
-				res = EOF;
-				break;
+		return __fread_direct(dest, total, stream) / size;
+	}
 
-			} else if (read == -1) {
-				stream->flags |= G_FILE_FLAG_ERROR;
-				res = EOF;
-				break;
-			}
+	// if the last access was a write, flush it
+	if (stream->flags & G_FILE_FLAG_BUFFER_DIRECTION_WRITE) {
+		if (__fflush_write_unlocked(stream) == EOF) {
+			return 0;
+		}
+	}
 
-			done += read;
+	// set direction
+	stream->flags &= ~G_FILE_FLAG_BUFFER_DIRECTION_WRITE;
+	stream->flags |= G_FILE_FLAG_BUFFER_DIRECTION_READ;
+
+	size_t done = 0;
+	while (done < total) {
+
+		// copy as much as possible from the buffer
+		size_t buffered = stream->buffered_bytes_read - stream->buffered_bytes_read_offset;
+		if (buffered > 0) {
+			size_t copied = total - done < buffered ? total - done : buffered;
+			memcpy(dest + done, stream->buffer + stream->buffered_bytes_read_offset, copied);
+			stream->buffered_bytes_read_offset += copied;
+			done += copied;
+			continue;
 		}
 
-		return done / size;
-	}
+		// requests that would fill the whole buffer bypass it
+		if (total - done >= stream->buffer_size) {
+			done += __fread_direct(dest + done, total - done, stream);
+			break;
+		}
 
-	// for buffered streams, get char-by-char
-	uint8_t* buffer = (uint8_t*) ptr;
-
-	for (size_t e = 0; e < nmemb; e++) {
-		size_t off = e * size;
-		for (size_t b = 0; b < size; b++) {
-			int c = __fgetc_unlocked(stream);
-			if (c == EOF) {
-				return e;
-			}
-			buffer[off + b] = (uint8_t) c;
+		if (__fillbuf_unlocked(stream) == EOF) {
+			break;
 		}
 	}
 
-	return nmemb;
+	return done / size;
 }
@@ -23,6 +23,30 @@
 #include "string.h"
 #include "errno.h"
 
+/**
+ * Writes directly to the stream implementation, until either all bytes are
+ * written or end-of-file or an error occurs.
+ */
+static size_t __fwrite_direct(const uint8_t* src, size_t len, FILE* stream) {
+
+	size_t done = 0;
+	while (done < len) {
+		ssize_t written = stream->impl_write(src + done, len - done, stream);
+
+		if (written == 0) {
+			stream->flags |= G_FILE_FLAG_EOF;
+			break;
+
+		} else if (written == -1) {
+			stream->flags |= G_FILE_FLAG_ERROR;
+			break;
+		}
+
+		done += written;
+	}
+	return done;
+}
+
 /**
  *
  */
@@ -47,54 +71,75 @@ size_t __fwrite_unlocked(const void* ptr, size_t size, size_t nmemb, FILE* strea
 		}
 	}
 
+	// if stream has no write implementation, return with error
+	if (stream->impl_write == NULL) {
+		errno = EBADF;
+		stream->flags |= G_FILE_FLAG_ERROR;
+		return EOF;
+	}
+
+	const uint8_t* src = (const uint8_t*) ptr;
+	size_t total = size * nmemb;
+
 	// unbuffered files perform direct write
 	if (stream->buffer_mode == _IONBF) {
 
-		// if stream has no write implementation, return with error
-		if (stream->impl_write == NULL) {
-			errno = EBADF;
-			stream->flags |= G_FILE_FLAG_ERROR;
-			return EOF;
-		}
-
 		// set stream direction
 		stream->flags |= G_FILE_FLAG_BUFFER_DIRECTION_WRITE;
 
 		// remove end-of-file
 		stream->flags &= ~G_FILE_FLAG_EOF;
 
-		// perform writing
-		size_t total = size * nmemb;
-		size_t done = 0;
+		return __fwrite_direct(src, total, stream) / size;
+	}
+
+	// if the last access was a read, flush it
+	if (stream->flags & G_FILE_FLAG_BUFFER_DIRECTION_READ) {
+		if (__fflush_read_unlocked(stream) == EOF) {
+			return 0;
+		}
+	}
 
-		while (done < total) {
-			// call write implementation
-			uint8_t* pos = &(((uint8_t*) ptr)[done]);
-			ssize_t written = stream->impl_write(pos, total - done, stream);
+	// set direction
+	stream->flags &= ~G_FILE_FLAG_BUFFER_DIRECTION_READ;
+	stream->flags |= G_FILE_FLAG_BUFFER_DIRECTION_WRITE;
 
-			if (written == 0) {
-				stream->flags |= G_FILE_FLAG_EOF;
-				return EOF;
+	size_t done = 0;
+	while (done < total) {
 
-			} else if (written == -1) {
-				stream->flags |= G_FILE_FLAG_ERROR;
-				return EOF;
+		// requests that would fill the whole buffer bypass it
+		if (total - done >= stream->buffer_size) {
+			if (__fflush_write_unlocked(stream) == EOF) {
+				return done / size;
 			}
+			stream->flags |= G_FILE_FLAG_BUFFER_DIRECTION_WRITE;
 
-			done += written;
+			done += __fwrite_direct(src + done, total - done, stream);
+			return done / size;
 		}
-		return done / size;
-	}
 
-	// for buffered streams, put char-by-char
-	uint8_t* buffer = (uint8_t*) ptr;
-
-	for (size_t e = 0; e < nmemb; e++) {
-		size_t off = e * size;
-		for (size_t b = 0; b < size; b++) {
-			if (__fputc_unlocked(buffer[off + b], stream) == EOF) {
-				return e;
+		// flush the buffer if it is full
+		size_t space = stream->buffer_size - stream->buffered_bytes_write;
+		if (space == 0) {
+			if (__fflush_write_unlocked(stream) == EOF) {
+				return done / size;
 			}
+			stream->flags |= G_FILE_FLAG_BUFFER_DIRECTION_WRITE;
+			continue;
+		}
+
+		// copy as much as possible into the buffer
+		size_t copied = total - done < space ? total - done : space;
+		memcpy(stream->buffer + stream->buffered_bytes_write, src + done, copied);
+		stream->buffered_bytes_write += copied;
+		done += copied;
+	}
+
+	// flush stream if its line-buffered and a newline occurs, the elements are
+	// already accepted into the buffer even if this fails
+	if (stream->buffer_mode == _IOLBF && memchr(src, '\n', total) != NULL) {
+		if (__fflush_write_unlocked(stream) == EOF) {
+			stream->flags |= G_FILE_FLAG_ERROR;
 		}
 	}
 
@@ -27,7 +27,7 @@
  */
 void clearerr(FILE* stream) {
 
-	g_atomic_lock(stream->lock);
+	flockfile(stream);
 	__clearerr_unlocked(stream);
-	g_atomic_unlock(stream->lock);
+	funlockfile(stream);
 }
@@ -41,8 +41,8 @@ int fflush(FILE* stream) {
 	}
 
 	// lock file and perform flush
-	g_atomic_lock(stream->lock);
+	flockfile(stream);
 	int res = __fflush_unlocked(stream);
-	g_atomic_unlock(stream->lock);
+	funlockfile(stream);
 	return res;
 }
@@ -28,9 +28,9 @@
  */
 int fgetc(FILE* stream) {
 
-	g_atomic_lock(stream->lock);
+	flockfile(stream);
 	int res = __fgetc_unlocked(stream);
-	g_atomic_unlock(stream->lock);
+	funlockfile(stream);
 	return res;
 }
 
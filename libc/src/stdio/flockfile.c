@@ -0,0 +1,44 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "stdio.h"
+#include "stdio_internal.h"
+
+/**
+ *
+ */
+void flockfile(FILE* stream) {
+
+	g_tid self = __stdio_thread_id();
+
+	// recursive locking by the owner
+	if (stream->lock_owner == self) {
+		stream->lock_depth++;
+		return;
+	}
+
+	// if the lock was held, wait until the owner hands it over
+	if (__sync_fetch_and_add(&stream->lock_count, 1) > 0) {
+		g_atomic_lock(stream->lock);
+	}
+
+	stream->lock_owner = self;
+	stream->lock_depth = 1;
+}
@@ -27,9 +27,9 @@
  */
 int fputc(int c, FILE* stream) {
 
-	g_atomic_lock(stream->lock);
+	flockfile(stream);
 	int result = __fputc_unlocked(c, stream);
-	g_atomic_unlock(stream->lock);
+	funlockfile(stream);
 	return result;
 }
 
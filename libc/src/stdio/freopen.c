@@ -29,7 +29,7 @@
  */
 FILE* freopen(const char* filename, const char* mode, FILE* stream) {
 
-	g_atomic_lock(stream->lock);
+	flockfile(stream);
 	FILE* res;
 	if (stream->impl_reopen) {
 		res = stream->impl_reopen(filename, mode, stream);
@@ -37,6 +37,6 @@ FILE* freopen(const char* filename, const char* mode, FILE* stream) {
 		errno = ENOTSUP;
 		res = NULL;
 	}
-	g_atomic_unlock(stream->lock);
+	funlockfile(stream);
 	return res;
 }
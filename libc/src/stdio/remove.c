@@ -27,8 +27,22 @@
  */
 int remove(const char *filename) {
 
-	klog("warning: remove(\"%s\") is not implemented", filename);
-	return 0;
+	g_fs_unlink_status stat = g_unlink(filename);
+
+	if (stat == G_FS_UNLINK_SUCCESSFUL) {
+		return 0;
+
+	} else if (stat == G_FS_UNLINK_NOT_FOUND) {
+		errno = ENOENT;
+
+	} else if (stat == G_FS_UNLINK_NOT_SUPPORTED) {
+		errno = EPERM;
+
+	} else {
+		errno = EIO;
+	}
+
+	return -1;
 }
 
 /**
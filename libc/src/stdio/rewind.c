@@ -26,8 +26,8 @@
  */
 void rewind(FILE* stream) {
 
-	g_atomic_lock(stream->lock);
+	flockfile(stream);
 	__fseeko_unlocked(stream, 0, SEEK_SET);
 	__clearerr_unlocked(stream);
-	g_atomic_unlock(stream->lock);
+	funlockfile(stream);
 }
@@ -28,9 +28,9 @@
  */
 int setvbuf(FILE* stream, char* buf, int mode, size_t size) {
 
-	g_atomic_lock(stream->lock);
+	flockfile(stream);
 	int res = __setvbuf_unlocked(stream, buf, mode, size);
-	g_atomic_unlock(stream->lock);
+	funlockfile(stream);
 	return res;
 }
 
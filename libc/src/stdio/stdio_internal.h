@@ -44,6 +44,12 @@ void __open_file_list_unlock();
 int __fclose_static(FILE* stream);
 int __fclose_static_unlocked(FILE* stream);
 
+// identifier of the executing thread, cached for stream locking
+g_tid __stdio_thread_id();
+
+// initializes the lock of a new stream
+void __stdio_lock_initialize(FILE* stream);
+
 // parses mode flags
 int __parse_mode_flags(const char* mode);
 
@@ -60,6 +66,9 @@ int __fdopen_static(int fd, const char *mode, FILE* file);
 // applies default buffering to the stream
 int __setdefbuf_unlocked(FILE* stream);
 
+// refills the empty read buffer of the stream
+int __fillbuf_unlocked(FILE* stream);
+
 size_t __fwrite_unlocked(const void* ptr, size_t size, size_t nmemb,
 		FILE* stream);
 size_t __fread_unlocked(const void* ptr, size_t size, size_t nmemb,
@@ -28,9 +28,9 @@
  */
 int ungetc(int c, FILE* stream) {
 
-	g_atomic_lock(stream->lock);
+	flockfile(stream);
 	int res = __fungetc_unlocked(c, stream);
-	g_atomic_unlock(stream->lock);
+	funlockfile(stream);
 	return res;
 }
 
@@ -27,8 +27,8 @@
  */
 int vfprintf(FILE* stream, const char* format, va_list arglist) {
 
-	g_atomic_lock(stream->lock);
+	flockfile(stream);
 	int res = __vfprintf_unlocked(stream, format, arglist);
-	g_atomic_unlock(stream->lock);
+	funlockfile(stream);
 	return res;
 }
@@ -21,18 +21,28 @@
 #include "ghost.h"
 #include "string.h"
 #include "stdint.h"
+#include "string_internal.h"
 
-/**
- *
- */
 void* memchr(const void* mem, int value, size_t num) {
 
 	__G_DEBUG_TRACE(memchr);
 
-	const uint8_t* mem8 = (uint8_t*) mem;
+	const uint8_t* mem8 = (const uint8_t*) mem;
+	uint8_t byte = (uint8_t) value;
+
+	// skip words that do not contain the byte, never reading past the end
+	uint32_t pattern = byte * __STRING_WORD_ONES;
+	while (num >= 4) {
+		uint32_t word = *(const __string_word*) mem8 ^ pattern;
+		if (__STRING_WORD_HAS_ZERO(word)) {
+			break;
+		}
+		mem8 += 4;
+		num -= 4;
+	}
 
 	while (num--) {
-		if (*mem8 == (uint8_t) value) {
+		if (*mem8 == byte) {
 			return (void*) mem8;
 		}
 		++mem8;
@@ -40,4 +50,3 @@ void* memchr(const void* mem, int value, size_t num) {
 
 	return NULL;
 }
-
@@ -21,10 +21,8 @@
 #include "string.h"
 #include "stdint.h"
 #include "ghost.h"
+#include "string_internal.h"
 
-/**
- *
- */
 int memcmp(const void* mem_a, const void* mem_b, size_t len) {
 
 	__G_DEBUG_TRACE(memcmp);
@@ -32,6 +30,13 @@ int memcmp(const void* mem_a, const void* mem_b, size_t len) {
 	const uint8_t* mem_a8 = (const uint8_t*) mem_a;
 	const uint8_t* mem_b8 = (const uint8_t*) mem_b;
 
+	// skip equal words, the differing word is then compared bytewise
+	while (len >= 4 && *(const __string_word*) mem_a8 == *(const __string_word*) mem_b8) {
+		mem_a8 += 4;
+		mem_b8 += 4;
+		len -= 4;
+	}
+
 	for (size_t i = 0; i < len; i++) {
 		if (mem_a8[i] > mem_b8[i]) {
 			return 1;
@@ -21,17 +21,72 @@
 #include "string.h"
 #include "stdint.h"
 #include "ghost.h"
+#include "string_internal.h"
 
 /**
- *
+ * Copies blocks of 64 bytes with unaligned loads and aligned stores.
+ * The destination must be 16-byte aligned.
+ */
+__attribute__((target("sse2")))
+static void memcpy_sse2_blocks(uint8_t* dest, const uint8_t* src, size_t blocks) {
+
+	while (blocks--) {
+		__asm__ __volatile__(
+			"movdqu   (%1), %%xmm0\n"
+			"movdqu 16(%1), %%xmm1\n"
+			"movdqu 32(%1), %%xmm2\n"
+			"movdqu 48(%1), %%xmm3\n"
+			"movdqa %%xmm0,   (%0)\n"
+			"movdqa %%xmm1, 16(%0)\n"
+			"movdqa %%xmm2, 32(%0)\n"
+			"movdqa %%xmm3, 48(%0)\n"
+			:: "r"(dest), "r"(src)
+			: "memory", "xmm0", "xmm1", "xmm2", "xmm3");
+		dest += 64;
+		src += 64;
+	}
+}
+
+/**
+ * Copies front to back. Because each block is read before it is written, this
+ * is also used by memmove when the destination lies below the source.
  */
 void* memcpy(void* dest, const void* src, size_t num) {
 
-	uint8_t* src_8 = (uint8_t*) src;
 	uint8_t* dest_8 = (uint8_t*) dest;
-	while (num--) {
-		*dest_8++ = *src_8++;
+	const uint8_t* src_8 = (const uint8_t*) src;
+
+	if (num < 16) {
+		while (num--) {
+			*dest_8++ = *src_8++;
+		}
+		return dest;
+	}
+
+	if (num >= __STRING_SSE2_THRESHOLD && __string_has_sse2()) {
+		size_t head = (16 - ((uintptr_t) dest_8 & 15)) & 15;
+		num -= head;
+		__asm__ __volatile__("rep movsb"
+			: "+D"(dest_8), "+S"(src_8), "+c"(head) :: "memory");
+
+		memcpy_sse2_blocks(dest_8, src_8, num / 64);
+		dest_8 += num & ~63;
+		src_8 += num & ~63;
+		num &= 63;
+
+	} else {
+		size_t head = (4 - ((uintptr_t) dest_8 & 3)) & 3;
+		num -= head;
+		__asm__ __volatile__("rep movsb"
+			: "+D"(dest_8), "+S"(src_8), "+c"(head) :: "memory");
 	}
 
+	size_t dwords = num / 4;
+	size_t bytes = num & 3;
+	__asm__ __volatile__("rep movsl"
+		: "+D"(dest_8), "+S"(src_8), "+c"(dwords) :: "memory");
+	__asm__ __volatile__("rep movsb"
+		: "+D"(dest_8), "+S"(src_8), "+c"(bytes) :: "memory");
+
 	return dest;
 }
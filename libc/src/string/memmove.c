@@ -22,28 +22,36 @@
 #include "stdint.h"
 #include "ghost.h"
 
-/**
- *
- */
 void* memmove(void* dest, const void* src, size_t num) {
 
 	__G_DEBUG_TRACE(memmove);
 
-	if (dest > src) {
-		uint8_t* src_8 = ((uint8_t*) src) + num - 1;
-		uint8_t* dest_8 = ((uint8_t*) dest) + num - 1;
-		while (num--) {
-			*dest_8-- = *src_8--;
-		}
-
-	} else {
-		uint8_t* src_8 = (uint8_t*) src;
-		uint8_t* dest_8 = (uint8_t*) dest;
-		while (num--) {
-			*dest_8++ = *src_8++;
-		}
+	uint8_t* dest_8 = (uint8_t*) dest;
+	const uint8_t* src_8 = (const uint8_t*) src;
+
+	// a forward copy is safe unless the destination starts within the source
+	if (dest_8 <= src_8 || dest_8 >= src_8 + num) {
+		return memcpy(dest, src, num);
+	}
+
+	// otherwise copy back to front, first the odd bytes at the end, then
+	// the dwords with the direction flag set
+	size_t bytes = num & 3;
+	size_t dwords = num / 4;
+	dest_8 += num;
+	src_8 += num;
+	while (bytes--) {
+		*--dest_8 = *--src_8;
+	}
+
+	if (dwords) {
+		dest_8 -= 4;
+		src_8 -= 4;
+		__asm__ __volatile__("std\n"
+			"rep movsl\n"
+			"cld"
+			: "+D"(dest_8), "+S"(src_8), "+c"(dwords) :: "memory");
 	}
 
 	return dest;
 }
-
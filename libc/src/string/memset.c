@@ -21,17 +21,68 @@
 #include "string.h"
 #include "stdint.h"
 #include "ghost.h"
+#include "string_internal.h"
 
 /**
- *
+ * Fills blocks of 64 bytes with the pattern. The memory must be 16-byte aligned.
  */
+__attribute__((target("sse2")))
+static void memset_sse2_blocks(uint8_t* mem, uint32_t pattern, size_t blocks) {
+
+	__asm__ __volatile__(
+		"movd %0, %%xmm0\n"
+		"pshufd $0, %%xmm0, %%xmm0"
+		:: "r"(pattern) : "xmm0");
+
+	while (blocks--) {
+		__asm__ __volatile__(
+			"movdqa %%xmm0,   (%0)\n"
+			"movdqa %%xmm0, 16(%0)\n"
+			"movdqa %%xmm0, 32(%0)\n"
+			"movdqa %%xmm0, 48(%0)\n"
+			:: "r"(mem) : "memory");
+		mem += 64;
+	}
+}
+
 void* memset(void* mem, int value, size_t len) {
 
 	__G_DEBUG_TRACE(memset);
 
-	uint8_t* mem8 = (uint8_t*) mem;
-	while (len--) {
-		mem8[len] = (uint8_t) value;
+	uint8_t* mem_8 = (uint8_t*) mem;
+
+	if (len < 16) {
+		while (len--) {
+			*mem_8++ = (uint8_t) value;
+		}
+		return mem;
 	}
+
+	uint32_t pattern = (uint8_t) value * __STRING_WORD_ONES;
+
+	if (len >= __STRING_SSE2_THRESHOLD && __string_has_sse2()) {
+		size_t head = (16 - ((uintptr_t) mem_8 & 15)) & 15;
+		len -= head;
+		__asm__ __volatile__("rep stosb"
+			: "+D"(mem_8), "+c"(head) : "a"(pattern) : "memory");
+
+		memset_sse2_blocks(mem_8, pattern, len / 64);
+		mem_8 += len & ~63;
+		len &= 63;
+
+	} else {
+		size_t head = (4 - ((uintptr_t) mem_8 & 3)) & 3;
+		len -= head;
+		__asm__ __volatile__("rep stosb"
+			: "+D"(mem_8), "+c"(head) : "a"(pattern) : "memory");
+	}
+
+	size_t dwords = len / 4;
+	size_t bytes = len & 3;
+	__asm__ __volatile__("rep stosl"
+		: "+D"(mem_8), "+c"(dwords) : "a"(pattern) : "memory");
+	__asm__ __volatile__("rep stosb"
+		: "+D"(mem_8), "+c"(bytes) : "a"(pattern) : "memory");
+
 	return mem;
 }
@@ -0,0 +1,50 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GHOST_LIBC_STRING_INTERNAL__
+#define __GHOST_LIBC_STRING_INTERNAL__
+
+#include "ghost.h"
+#include "stddef.h"
+#include "stdint.h"
+
+__BEGIN_C
+
+// This file describes non-standard symbols that should not be exposed by the
+// public headers and are only used internally.
+
+// copies and fills of at least this size use SSE2 if the processor has it,
+// below that the setup does not pay off compared to rep movsd/stosd
+#define __STRING_SSE2_THRESHOLD		256
+
+// word that may be used to read any memory, regardless of its declared type
+typedef uint32_t __attribute__((__may_alias__)) __string_word;
+
+// checks whether any byte of a word is zero
+#define __STRING_WORD_ONES			((uint32_t) 0x01010101)
+#define __STRING_WORD_HIGHS			((uint32_t) 0x80808080)
+#define __STRING_WORD_HAS_ZERO(w)	(((w) - __STRING_WORD_ONES) & ~(w) & __STRING_WORD_HIGHS)
+
+// whether the processor supports SSE2, detected once with CPUID
+int __string_has_sse2();
+
+__END_C
+
+#endif
@@ -20,14 +20,60 @@
 
 #include "string.h"
 #include "ghost.h"
+#include "string_internal.h"
 
+/**
+ * Returns a mask with a bit set for each zero byte in the aligned 16 bytes.
+ */
+__attribute__((target("sse2")))
+static uint32_t strlen_sse2_zeros(const char* block) {
+
+	uint32_t mask;
+	__asm__ __volatile__(
+		"pxor %%xmm1, %%xmm1\n"
+		"movdqa (%1), %%xmm0\n"
+		"pcmpeqb %%xmm1, %%xmm0\n"
+		"pmovmskb %%xmm0, %0"
+		: "=r"(mask) : "r"(block) : "xmm0", "xmm1");
+	return mask;
+}
+
+/**
+ * Aligned reads never cross a page boundary, so reading the whole word or
+ * block that contains the terminator is safe.
+ */
 size_t strlen(const char* s) {
 
 	__G_DEBUG_TRACE(strlen);
 
-	size_t len = 0;
-	while (s[len]) {
-		++len;
+	if (__string_has_sse2()) {
+		const char* block = (const char*) ((uintptr_t) s & ~15);
+		uint32_t mask = strlen_sse2_zeros(block) >> ((uintptr_t) s & 15);
+		if (mask) {
+			return __builtin_ctz(mask);
+		}
+		for (;;) {
+			block += 16;
+			mask = strlen_sse2_zeros(block);
+			if (mask) {
+				return block + __builtin_ctz(mask) - s;
+			}
+		}
+	}
+
+	const char* pos = s;
+	while ((uintptr_t) pos & 3) {
+		if (!*pos) {
+			return pos - s;
+		}
+		++pos;
+	}
+
+	while (!__STRING_WORD_HAS_ZERO(*(const __string_word*) pos)) {
+		pos += 4;
+	}
+	while (*pos) {
+		++pos;
 	}
-	return len;
+	return pos - s;
 }
@@ -0,0 +1,55 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "sys/mman.h"
+#include "ghost.h"
+#include "errno.h"
+
+/**
+ *
+ */
+void* mmap(void* addr, size_t length, int prot, int flags, int fd, off_t offset) {
+
+	if (flags & MAP_FIXED) {
+		errno = EINVAL;
+		return MAP_FAILED;
+	}
+
+	g_memory_map_status status;
+	void* result = g_memory_map_s(length, prot, flags, fd, offset, &status);
+
+	if (status == G_MEMORY_MAP_STATUS_SUCCESSFUL) {
+		return result;
+
+	} else if (status == G_MEMORY_MAP_STATUS_INVALID_FD) {
+		errno = EBADF;
+
+	} else if (status == G_MEMORY_MAP_STATUS_ACCESS_DENIED) {
+		errno = EACCES;
+
+	} else if (status == G_MEMORY_MAP_STATUS_NO_MEMORY) {
+		errno = ENOMEM;
+
+	} else {
+		errno = EINVAL;
+	}
+
+	return MAP_FAILED;
+}
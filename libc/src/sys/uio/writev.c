@@ -0,0 +1,52 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "sys/uio.h"
+#include "ghost/user.h"
+#include "errno.h"
+
+/**
+ *
+ */
+ssize_t writev(int fd, const struct iovec* iov, int iovcnt) {
+
+	if (iovcnt <= 0 || iovcnt > IOV_MAX) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	g_fs_write_status stat;
+	int32_t len = g_write_vector_s(fd, (const g_fs_iovec*) iov, iovcnt, -1, &stat);
+
+	if (stat == G_FS_WRITE_SUCCESSFUL) {
+		return len;
+
+	} else if (stat == G_FS_WRITE_INVALID_FD) {
+		errno = EBADF;
+
+	} else if (stat == G_FS_WRITE_NO_SPACE) {
+		errno = ENOSPC;
+
+	} else {
+		errno = EIO;
+	}
+
+	return -1;
+}
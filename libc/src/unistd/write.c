@@ -39,6 +39,9 @@ ssize_t write(int fd, const void* buf, size_t count) {
 	} else if (stat == G_FS_WRITE_BUSY) {
 		errno = EIO;
 
+	} else if (stat == G_FS_WRITE_NO_SPACE) {
+		errno = ENOSPC;
+
 	} else {
 		// TODO improve kernel error codes
 		errno = EIO;
@@ -1,10 +1,10 @@
 
 if [ -e $1-test.cpp ]; then
-	g++ $1-test.cpp -o $1-test
+	g++ -I../../libapi/inc -idirafter ../inc $1-test.cpp -o $1-test -pthread
 	if [ $? -ne 0 ]; then
 		exit 1
 	fi
-	./$1-test
+	./$1-test "${@:2}"
 else
 	echo "test $1 does not exist"
 fi
\ No newline at end of file
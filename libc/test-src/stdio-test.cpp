@@ -0,0 +1,546 @@
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <malloc.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+// The stdio implementation works on the libc's own FILE structure, which must
+// not clash with the one of the host C library
+#define __GHOST_LIBC_TYPES__
+#define FILE ghost_FILE
+#ifndef BUFSIZMIN
+#define BUFSIZMIN 128
+#endif
+
+#include "../src/stdio/__setvbuf_unlocked.c"
+#include "../src/stdio/__setdefbuf_unlocked.c"
+#include "../src/stdio/__fillbuf_unlocked.c"
+#include "../src/stdio/__fflush_read_unlocked.c"
+#include "../src/stdio/__fflush_write_unlocked.c"
+#include "../src/stdio/__fgetc_unlocked.c"
+#include "../src/stdio/__fputc_unlocked.c"
+#include "../src/stdio/__fungetc_unlocked.c"
+#include "../src/stdio/__fread_unlocked.c"
+#include "../src/stdio/__fwrite_unlocked.c"
+#include "../src/stdio/__stdio_thread_id.c"
+#include "../src/stdio/__stdio_lock_initialize.c"
+#include "../src/stdio/flockfile.c"
+#include "../src/stdio/ftrylockfile.c"
+#include "../src/stdio/funlockfile.c"
+
+// Atoms are simulated with binary semaphores
+static sem_t atoms[16];
+static int atom_count = 0;
+static int atom_waits = 0;
+
+g_atom g_atomic_initialize() {
+	sem_init(&atoms[atom_count], 0, 1);
+	return ++atom_count;
+}
+
+void g_atomic_lock(g_atom atom) {
+	__sync_fetch_and_add(&atom_waits, 1);
+	sem_wait(&atoms[atom - 1]);
+}
+
+void g_atomic_unlock(g_atom atom) {
+	sem_post(&atoms[atom - 1]);
+}
+
+g_tid g_get_tid() {
+	return syscall(SYS_gettid);
+}
+
+#define TEST(name) \
+	std::cout << #name << ": "; \
+	if(test_##name()) { \
+		std::cout << "success" << std::endl; \
+	} else { \
+		std::cout << "fail" << std::endl; \
+		failed = true; \
+	}
+
+/**
+ * Stream that reads from and writes to memory. The implementation calls are
+ * counted and can be limited to a maximum length per call to simulate short
+ * reads and writes.
+ */
+struct memory_stream {
+	ghost_FILE file;
+	uint8_t* data;
+	size_t size;
+	size_t position;
+	size_t max_chunk;
+	int read_calls;
+	int write_calls;
+};
+
+static ssize_t memory_read(void* buf, size_t len, ghost_FILE* file) {
+	memory_stream* stream = (memory_stream*) file;
+	stream->read_calls++;
+	if (len > stream->max_chunk) {
+		len = stream->max_chunk;
+	}
+	if (len > stream->size - stream->position) {
+		len = stream->size - stream->position;
+	}
+	memcpy(buf, stream->data + stream->position, len);
+	stream->position += len;
+	return len;
+}
+
+static ssize_t memory_write(const void* buf, size_t len, ghost_FILE* file) {
+	memory_stream* stream = (memory_stream*) file;
+	stream->write_calls++;
+	if (len > stream->max_chunk) {
+		len = stream->max_chunk;
+	}
+	if (len > stream->size - stream->position) {
+		len = stream->size - stream->position;
+	}
+	if (len == 0) {
+		return -1;
+	}
+	memcpy(stream->data + stream->position, buf, len);
+	stream->position += len;
+	return len;
+}
+
+static void memory_open(memory_stream* stream, uint8_t* data, size_t size, int mode, size_t buffer_size) {
+	memset(stream, 0, sizeof(memory_stream));
+	stream->data = data;
+	stream->size = size;
+	stream->max_chunk = (size_t) -1;
+	stream->file.flags = G_FILE_FLAG_MODE_READ | G_FILE_FLAG_MODE_WRITE;
+	stream->file.impl_read = memory_read;
+	stream->file.impl_write = memory_write;
+	__setvbuf_unlocked(&stream->file, NULL, mode, buffer_size);
+}
+
+static void memory_close(memory_stream* stream) {
+	__fflush_write_unlocked(&stream->file);
+	if (stream->file.flags & G_FILE_FLAG_BUFFER_OWNER_LIBRARY) {
+		free(stream->file.buffer);
+	}
+}
+
+static void fill_pattern(uint8_t* data, size_t size) {
+	for (size_t i = 0; i < size; i++) {
+		data[i] = (uint8_t) (i * 13 + i / 256);
+	}
+}
+
+#define DATA_SIZE (64 * 1024 + 17)
+
+static const size_t request_sizes[] = {1, 3, 64, 127, 128, 129, 1000, 4096, 8191, 8192, 8193, 20000};
+static const int request_count = sizeof(request_sizes) / sizeof(request_sizes[0]);
+
+/**
+ * Reads the whole stream with requests of varying sizes, mixed with single
+ * characters and ungetc, for different buffer sizes and short reads.
+ */
+bool test_fread_spans() {
+	static uint8_t data[DATA_SIZE];
+	static uint8_t result[DATA_SIZE];
+	fill_pattern(data, DATA_SIZE);
+
+	const size_t buffer_sizes[] = {128, 1000, BUFSIZ};
+	const size_t chunks[] = {(size_t) -1, 100, 7};
+
+	for (int b = 0; b < 3; b++) {
+		for (int c = 0; c < 3; c++) {
+			for (int r = 0; r < request_count; r++) {
+				memory_stream stream;
+				memory_open(&stream, data, DATA_SIZE, _IOFBF, buffer_sizes[b]);
+				stream.max_chunk = chunks[c];
+				memset(result, 0, DATA_SIZE);
+
+				size_t position = 0;
+				int step = 0;
+				while (position < DATA_SIZE) {
+					size_t request = request_sizes[(r + step++) % request_count];
+					if (step % 5 == 0) {
+						int ch = __fgetc_unlocked(&stream.file);
+						__fungetc_unlocked(ch, &stream.file);
+						request = 1;
+					}
+					if (request > DATA_SIZE - position) {
+						request = DATA_SIZE - position;
+					}
+
+					size_t read = __fread_unlocked(result + position, 1, request, &stream.file);
+					if (read != request) {
+						std::cout << std::endl << "\tshort read of " << read << " instead of " << request;
+						return false;
+					}
+					position += read;
+				}
+
+				if (memcmp(data, result, DATA_SIZE) != 0) {
+					std::cout << std::endl << "\twrong content with buffer " << buffer_sizes[b] << ", chunk "
+							<< chunks[c] << ", request " << request_sizes[r];
+					return false;
+				}
+				if (__fgetc_unlocked(&stream.file) != EOF || (stream.file.flags & G_FILE_FLAG_EOF) == 0) {
+					std::cout << std::endl << "\tno end-of-file";
+					return false;
+				}
+				memory_close(&stream);
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * Requests larger than the buffer must not be split into buffer refills.
+ */
+bool test_fread_bypass() {
+	static uint8_t data[DATA_SIZE];
+	static uint8_t result[DATA_SIZE];
+	fill_pattern(data, DATA_SIZE);
+
+	memory_stream stream;
+	memory_open(&stream, data, DATA_SIZE, _IOFBF, 1024);
+
+	// first a small read fills the buffer once
+	__fread_unlocked(result, 1, 10, &stream.file);
+	if (stream.read_calls != 1) {
+		return false;
+	}
+
+	// the rest is served from the buffer and then read directly
+	__fread_unlocked(result + 10, 1, 50000, &stream.file);
+	if (stream.read_calls != 2 || memcmp(data, result, 50010) != 0) {
+		std::cout << std::endl << "\texpected 2 reads, got " << stream.read_calls;
+		return false;
+	}
+	memory_close(&stream);
+	return true;
+}
+
+/**
+ * Only complete elements are counted when end-of-file is reached.
+ */
+bool test_fread_partial_element() {
+	uint8_t data[10];
+	uint32_t result[3];
+	fill_pattern(data, 10);
+
+	memory_stream stream;
+	memory_open(&stream, data, 10, _IOFBF, 128);
+	size_t read = __fread_unlocked(result, 4, 3, &stream.file);
+	if (read != 2 || (stream.file.flags & G_FILE_FLAG_EOF) == 0 || memcmp(result, data, 8) != 0) {
+		return false;
+	}
+
+	// further reads return nothing
+	read = __fread_unlocked(result, 4, 1, &stream.file);
+	memory_close(&stream);
+	return read == 0;
+}
+
+/**
+ * Writes with requests of varying sizes and checks the flushed content.
+ */
+bool test_fwrite_spans() {
+	static uint8_t data[DATA_SIZE];
+	static uint8_t result[DATA_SIZE];
+	fill_pattern(data, DATA_SIZE);
+
+	const size_t buffer_sizes[] = {128, 1000, BUFSIZ};
+	const size_t chunks[] = {(size_t) -1, 100};
+
+	for (int b = 0; b < 3; b++) {
+		for (int c = 0; c < 2; c++) {
+			for (int r = 0; r < request_count; r++) {
+				memory_stream stream;
+				memory_open(&stream, result, DATA_SIZE, _IOFBF, buffer_sizes[b]);
+				stream.max_chunk = chunks[c];
+				memset(result, 0, DATA_SIZE);
+
+				size_t position = 0;
+				int step = 0;
+				while (position < DATA_SIZE) {
+					size_t request = request_sizes[(r + step++) % request_count];
+					if (step % 5 == 0) {
+						__fputc_unlocked(data[position++], &stream.file);
+						continue;
+					}
+					if (request > DATA_SIZE - position) {
+						request = DATA_SIZE - position;
+					}
+
+					if (__fwrite_unlocked(data + position, 1, request, &stream.file) != request) {
+						return false;
+					}
+					position += request;
+				}
+				memory_close(&stream);
+
+				if (memcmp(data, result, DATA_SIZE) != 0) {
+					std::cout << std::endl << "\twrong content with buffer " << buffer_sizes[b] << ", chunk "
+							<< chunks[c] << ", request " << request_sizes[r];
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * Large writes flush what is buffered and then go directly to the stream.
+ */
+bool test_fwrite_bypass() {
+	static uint8_t data[DATA_SIZE];
+	static uint8_t result[DATA_SIZE];
+	fill_pattern(data, DATA_SIZE);
+
+	memory_stream stream;
+	memory_open(&stream, result, DATA_SIZE, _IOFBF, 1024);
+	__fwrite_unlocked(data, 1, 10, &stream.file);
+	if (stream.write_calls != 0) {
+		return false;
+	}
+
+	__fwrite_unlocked(data + 10, 1, 50000, &stream.file);
+	if (stream.write_calls != 2 || memcmp(data, result, 50010) != 0) {
+		std::cout << std::endl << "\texpected 2 writes, got " << stream.write_calls;
+		return false;
+	}
+	memory_close(&stream);
+	return true;
+}
+
+/**
+ * Line buffered streams are flushed when a newline is written.
+ */
+bool test_fwrite_line_buffered() {
+	uint8_t result[64];
+	memset(result, 0, sizeof(result));
+
+	memory_stream stream;
+	memory_open(&stream, result, sizeof(result), _IOLBF, 128);
+	__fwrite_unlocked("abc", 1, 3, &stream.file);
+	if (stream.write_calls != 0) {
+		return false;
+	}
+
+	__fwrite_unlocked("de\nf", 1, 4, &stream.file);
+	if (stream.write_calls != 1 || memcmp(result, "abcde\nf", 7) != 0) {
+		return false;
+	}
+	memory_close(&stream);
+	return true;
+}
+
+/**
+ * A failing line flush still reports the elements that were accepted.
+ */
+bool test_fwrite_line_buffered_error() {
+	uint8_t result[4];
+
+	memory_stream stream;
+	memory_open(&stream, result, sizeof(result), _IOLBF, 128);
+	size_t written = __fwrite_unlocked("abcdef\n", 1, 7, &stream.file);
+	return written == 7 && (stream.file.flags & G_FILE_FLAG_ERROR);
+}
+
+/**
+ * Writing to a full stream reports the number of complete elements.
+ */
+bool test_fwrite_error() {
+	uint8_t result[10];
+
+	memory_stream stream;
+	memory_open(&stream, result, sizeof(result), _IONBF, 0);
+	size_t written = __fwrite_unlocked("0123456789ABCDEF", 4, 4, &stream.file);
+	return written == 2 && (stream.file.flags & G_FILE_FLAG_ERROR);
+}
+
+/**
+ * A read after a write flushes the written data first.
+ */
+bool test_direction_switch() {
+	uint8_t result[256];
+	fill_pattern(result, sizeof(result));
+
+	memory_stream stream;
+	memory_open(&stream, result, sizeof(result), _IOFBF, 128);
+	__fwrite_unlocked("hello", 1, 5, &stream.file);
+
+	uint8_t read[10];
+	if (__fread_unlocked(read, 1, 10, &stream.file) != 10) {
+		return false;
+	}
+	memory_close(&stream);
+
+	uint8_t expected[256];
+	fill_pattern(expected, sizeof(expected));
+	return memcmp(result, "hello", 5) == 0 && memcmp(read, expected + 5, 10) == 0;
+}
+
+/**
+ * The lock is recursive and does not wait on the atom when uncontended.
+ */
+bool test_lock_recursive() {
+	ghost_FILE file;
+	memset(&file, 0, sizeof(file));
+	__stdio_lock_initialize(&file);
+	int waits = atom_waits;
+
+	flockfile(&file);
+	flockfile(&file);
+	if (ftrylockfile(&file) != 0 || file.lock_depth != 3) {
+		return false;
+	}
+	funlockfile(&file);
+	funlockfile(&file);
+	funlockfile(&file);
+	if (file.lock_count != 0 || file.lock_owner != G_TID_NONE) {
+		return false;
+	}
+
+	for (int i = 0; i < 1000; i++) {
+		flockfile(&file);
+		funlockfile(&file);
+	}
+	return atom_waits == waits;
+}
+
+static ghost_FILE contended_file;
+static volatile int contended_counter = 0;
+
+static void* contended_thread(void* arg) {
+	for (int i = 0; i < 100000; i++) {
+		flockfile(&contended_file);
+		if (ftrylockfile(&contended_file) != 0) {
+			return (void*) 1;
+		}
+		int value = contended_counter;
+		contended_counter = value + 1;
+		funlockfile(&contended_file);
+		funlockfile(&contended_file);
+	}
+	return NULL;
+}
+
+/**
+ * Threads that increment a counter under the lock must not lose updates, and
+ * another thread can't try-lock a held lock.
+ */
+bool test_lock_contended() {
+	memset(&contended_file, 0, sizeof(contended_file));
+	__stdio_lock_initialize(&contended_file);
+
+	pthread_t threads[4];
+	for (int i = 0; i < 4; i++) {
+		pthread_create(&threads[i], NULL, contended_thread, NULL);
+	}
+	bool failed = false;
+	for (int i = 0; i < 4; i++) {
+		void* result;
+		pthread_join(threads[i], &result);
+		failed |= result != NULL;
+	}
+	if (failed || contended_counter != 400000 || contended_file.lock_count != 0) {
+		return false;
+	}
+
+	// held by this thread, so a second thread must fail to try-lock
+	flockfile(&contended_file);
+	pthread_t other;
+	pthread_create(&other, NULL, [](void*) -> void* {
+		return (void*) (intptr_t) ftrylockfile(&contended_file);
+	}, NULL);
+	void* result;
+	pthread_join(other, &result);
+	funlockfile(&contended_file);
+	return result != NULL;
+}
+
+static double now() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/**
+ * Reads a 16 MiB memory stream with different request sizes, once with fread
+ * and once character by character like the previous implementation did, and
+ * prints the throughput in MiB/s.
+ */
+void benchmark() {
+	const size_t size = 16 * 1024 * 1024;
+	uint8_t* data = (uint8_t*) malloc(size);
+	uint8_t* target = (uint8_t*) malloc(size);
+	fill_pattern(data, size);
+
+	const size_t requests[] = {1, 16, 256, 4096, 65536, 1024 * 1024};
+	printf("%-10s %12s %12s %12s\n", "request", "fread", "fgetc-loop", "fwrite");
+
+	for (size_t i = 0; i < sizeof(requests) / sizeof(requests[0]); i++) {
+		size_t request = requests[i];
+		double results[3];
+
+		for (int mode = 0; mode < 3; mode++) {
+			memory_stream stream;
+			memory_open(&stream, mode == 2 ? target : data, size, _IOFBF, BUFSIZ);
+
+			double start = now();
+			for (size_t position = 0; position < size; position += request) {
+				if (mode == 0) {
+					__fread_unlocked(target + position, 1, request, &stream.file);
+				} else if (mode == 1) {
+					for (size_t b = 0; b < request; b++) {
+						target[position + b] = __fgetc_unlocked(&stream.file);
+					}
+				} else {
+					__fwrite_unlocked(data + position, 1, request, &stream.file);
+				}
+			}
+			memory_close(&stream);
+			results[mode] = size / (now() - start) / (1024 * 1024);
+
+			if (memcmp(data, target, size) != 0) {
+				printf("content mismatch\n");
+			}
+		}
+
+		printf("%-10zu %12.0f %12.0f %12.0f\n", request, results[0], results[1], results[2]);
+	}
+
+	free(data);
+	free(target);
+}
+
+/**
+ * Runs the tests, or the throughput benchmark with "--bench".
+ */
+int main(int argc, char** argv) {
+	if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+		benchmark();
+		return 0;
+	}
+
+	bool failed = false;
+	TEST(fread_spans);
+	TEST(fread_bypass);
+	TEST(fread_partial_element);
+	TEST(fwrite_spans);
+	TEST(fwrite_bypass);
+	TEST(fwrite_line_buffered);
+	TEST(fwrite_line_buffered_error);
+	TEST(fwrite_error);
+	TEST(direction_switch);
+	TEST(lock_recursive);
+	TEST(lock_contended);
+	return failed ? 1 : 0;
+}
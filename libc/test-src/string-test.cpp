@@ -0,0 +1,315 @@
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// The tested functions get their own names so that they don't replace the
+// ones of the host C library
+#define memcpy ghost_memcpy
+#define memmove ghost_memmove
+#define memset ghost_memset
+#define memcmp ghost_memcmp
+#define strlen ghost_strlen
+#define memchr ghost_memchr
+
+#include "../src/string/string_cpu.c"
+#include "../src/string/memcpy.c"
+#include "../src/string/memmove.c"
+#include "../src/string/memset.c"
+#include "../src/string/memcmp.c"
+#include "../src/string/strlen.c"
+#include "../src/string/memchr.c"
+
+#undef memcpy
+#undef memmove
+#undef memset
+#undef memcmp
+#undef strlen
+#undef memchr
+
+#define TEST(name) \
+	std::cout << #name << ": "; \
+	if(test_##name()) { \
+		std::cout << "success" << std::endl; \
+	} else { \
+		std::cout << "fail" << std::endl; \
+		failed = true; \
+	}
+
+#define BUFFER_SIZE 8192
+#define GUARD 0xAB
+
+static const size_t sizes[] = {0, 1, 2, 3, 4, 5, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 129,
+		255, 256, 257, 300, 511, 1000, 1024, 4095, 4096};
+static const int size_count = sizeof(sizes) / sizeof(sizes[0]);
+
+static uint8_t source[BUFFER_SIZE] __attribute__((aligned(64)));
+static uint8_t target[BUFFER_SIZE] __attribute__((aligned(64)));
+static uint8_t expected[BUFFER_SIZE] __attribute__((aligned(64)));
+
+static void fill_pattern(uint8_t* buffer, size_t len, int seed) {
+	for (size_t i = 0; i < len; i++) {
+		buffer[i] = (uint8_t) (i * 7 + seed);
+	}
+}
+
+static bool report(const char* function, size_t dest_align, size_t src_align, size_t size) {
+	std::cout << std::endl << "\t" << function << " failed for destination alignment " << dest_align
+			<< ", source alignment " << src_align << ", size " << size;
+	return false;
+}
+
+/**
+ * Every combination of alignment and size, checking that the bytes around the
+ * destination are untouched.
+ */
+bool test_memcpy() {
+	fill_pattern(source, BUFFER_SIZE, 1);
+	for (size_t dest_align = 0; dest_align < 16; dest_align++) {
+		for (size_t src_align = 0; src_align < 16; src_align++) {
+			for (int s = 0; s < size_count; s++) {
+				size_t size = sizes[s];
+				memset(target, GUARD, BUFFER_SIZE);
+				memset(expected, GUARD, BUFFER_SIZE);
+				for (size_t i = 0; i < size; i++) {
+					expected[16 + dest_align + i] = source[src_align + i];
+				}
+
+				void* result = ghost_memcpy(target + 16 + dest_align, source + src_align, size);
+				if (result != target + 16 + dest_align || memcmp(target, expected, BUFFER_SIZE) != 0) {
+					return report("memcpy", dest_align, src_align, size);
+				}
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * Overlapping moves in both directions at all distances below 64.
+ */
+bool test_memmove() {
+	for (size_t distance = 0; distance < 64; distance++) {
+		for (size_t align = 0; align < 16; align++) {
+			for (int s = 0; s < size_count; s++) {
+				size_t size = sizes[s];
+				uint8_t* start = target + 64 + align;
+
+				// forwards: destination above the source
+				fill_pattern(target, BUFFER_SIZE, 3);
+				memcpy(expected, target, BUFFER_SIZE);
+				memmove(expected + (start - target) + distance, start, size);
+				ghost_memmove(start + distance, start, size);
+				if (memcmp(target, expected, BUFFER_SIZE) != 0) {
+					return report("memmove up", align + distance, align, size);
+				}
+
+				// backwards: destination below the source
+				fill_pattern(target, BUFFER_SIZE, 5);
+				memcpy(expected, target, BUFFER_SIZE);
+				memmove(expected + (start - target) - distance, start, size);
+				ghost_memmove(start - distance, start, size);
+				if (memcmp(target, expected, BUFFER_SIZE) != 0) {
+					return report("memmove down", align - distance, align, size);
+				}
+			}
+		}
+	}
+	return true;
+}
+
+bool test_memset() {
+	for (size_t align = 0; align < 16; align++) {
+		for (int s = 0; s < size_count; s++) {
+			size_t size = sizes[s];
+			memset(target, GUARD, BUFFER_SIZE);
+			memset(expected, GUARD, BUFFER_SIZE);
+			memset(expected + 16 + align, 0x5A, size);
+
+			void* result = ghost_memset(target + 16 + align, 0x15A, size);
+			if (result != target + 16 + align || memcmp(target, expected, BUFFER_SIZE) != 0) {
+				return report("memset", align, 0, size);
+			}
+		}
+	}
+	return true;
+}
+
+static int sign(int value) {
+	return value < 0 ? -1 : (value > 0 ? 1 : 0);
+}
+
+/**
+ * A single differing byte at each position, once larger and once smaller.
+ */
+bool test_memcmp() {
+	for (size_t align = 0; align < 8; align++) {
+		for (int s = 0; s < size_count; s++) {
+			size_t size = sizes[s];
+			uint8_t* a = source + align;
+			uint8_t* b = target + 3;
+			fill_pattern(a, size, 9);
+			memcpy(b, a, size);
+			if (ghost_memcmp(a, b, size) != 0) {
+				return report("memcmp equal", align, 3, size);
+			}
+
+			for (size_t pos = 0; pos < size; pos += (size > 64 ? 13 : 1)) {
+				uint8_t original = b[pos];
+				b[pos] = original + 0x80;
+				if (sign(ghost_memcmp(a, b, size)) != sign(memcmp(a, b, size))
+						|| sign(ghost_memcmp(b, a, size)) != sign(memcmp(b, a, size))) {
+					return report("memcmp", align, 3, pos);
+				}
+				b[pos] = original;
+			}
+		}
+	}
+	return true;
+}
+
+bool test_strlen() {
+	memset(source, 'x', BUFFER_SIZE);
+	for (size_t align = 0; align < 16; align++) {
+		for (size_t len = 0; len < 300; len++) {
+			char* str = (char*) source + 64 + align;
+			str[len] = 0;
+			size_t result = ghost_strlen(str);
+			str[len] = 'x';
+			if (result != len) {
+				return report("strlen", align, 0, len);
+			}
+		}
+	}
+	return true;
+}
+
+bool test_memchr() {
+	for (size_t align = 0; align < 8; align++) {
+		for (int s = 0; s < size_count; s++) {
+			size_t size = sizes[s];
+			uint8_t* mem = source + align;
+			memset(source, 1, BUFFER_SIZE);
+
+			// a match right after the end must not be found
+			mem[size] = 0xFE;
+			if (ghost_memchr(mem, 0xFE, size) != NULL) {
+				return report("memchr outside", align, 0, size);
+			}
+
+			for (size_t pos = 0; pos < size; pos += (size > 64 ? 11 : 1)) {
+				mem[pos] = 0xFE;
+				if (ghost_memchr(mem, 0x1FE, size) != mem + pos) {
+					return report("memchr", align, 0, pos);
+				}
+				mem[pos] = 1;
+			}
+		}
+	}
+	return true;
+}
+
+static double now() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/**
+ * Byte loops like the previous implementations, to compare against.
+ */
+static void* bytewise_memcpy(void* dest, const void* src, size_t num) {
+	uint8_t* d = (uint8_t*) dest;
+	const uint8_t* s = (const uint8_t*) src;
+	while (num--) {
+		*d++ = *s++;
+	}
+	return dest;
+}
+
+static void* bytewise_memset(void* mem, int value, size_t len) {
+	uint8_t* m = (uint8_t*) mem;
+	while (len--) {
+		m[len] = (uint8_t) value;
+	}
+	return mem;
+}
+
+/**
+ * Prints the throughput of the ghost, the bytewise and the host implementation
+ * in MiB/s for some typical sizes.
+ */
+void benchmark() {
+	static const size_t bench_sizes[] = {64, 4096, 1024 * 1024};
+	uint8_t* a = (uint8_t*) malloc(1024 * 1024 + 64);
+	uint8_t* b = (uint8_t*) malloc(1024 * 1024 + 64);
+	memset(a, 1, 1024 * 1024 + 64);
+	memset(b, 1, 1024 * 1024 + 64);
+
+	printf("sse2: %s\n", __string_has_sse2() ? "yes" : "no");
+	printf("%-10s %10s %12s %12s %12s\n", "function", "size", "ghost", "bytewise", "host");
+
+	for (size_t i = 0; i < sizeof(bench_sizes) / sizeof(bench_sizes[0]); i++) {
+		size_t size = bench_sizes[i];
+		size_t rounds = (256 * 1024 * 1024) / size;
+		double results[3][3];
+
+		for (int impl = 0; impl < 3; impl++) {
+			double start = now();
+			for (size_t r = 0; r < rounds; r++) {
+				if (impl == 0) ghost_memcpy(b + 1, a, size);
+				else if (impl == 1) bytewise_memcpy(b + 1, a, size);
+				else memcpy(b + 1, a, size);
+			}
+			results[0][impl] = rounds * size / (now() - start) / (1024 * 1024);
+
+			start = now();
+			for (size_t r = 0; r < rounds; r++) {
+				if (impl == 0) ghost_memset(b, r, size);
+				else if (impl == 1) bytewise_memset(b, r, size);
+				else memset(b, r, size);
+			}
+			results[1][impl] = rounds * size / (now() - start) / (1024 * 1024);
+
+			a[size - 1] = 0;
+			start = now();
+			size_t total = 0;
+			for (size_t r = 0; r < rounds; r++) {
+				if (impl == 0) total += ghost_strlen((char*) a);
+				else if (impl == 1) { size_t l = 0; while (a[l]) l++; total += l; }
+				else total += strlen((char*) a);
+			}
+			results[2][impl] = rounds * size / (now() - start) / (1024 * 1024);
+			a[size - 1] = 1;
+			if (total == 0) printf(" ");
+		}
+
+		const char* names[] = {"memcpy", "memset", "strlen"};
+		for (int f = 0; f < 3; f++) {
+			printf("%-10s %10zu %12.0f %12.0f %12.0f\n", names[f], size, results[f][0], results[f][1], results[f][2]);
+		}
+	}
+
+	free(a);
+	free(b);
+}
+
+/**
+ * Runs the correctness tests, or the throughput benchmark with "--bench".
+ */
+int main(int argc, char** argv) {
+	if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+		benchmark();
+		return 0;
+	}
+
+	bool failed = false;
+	TEST(memcpy);
+	TEST(memmove);
+	TEST(memset);
+	TEST(memcmp);
+	TEST(strlen);
+	TEST(memchr);
+	return failed ? 1 : 0;
+}
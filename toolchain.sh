@@ -212,6 +212,22 @@ pushd tools/ramdisk-writer
 popd
 
 
+echo "Building 'trace-convert' tool"
+pushd tools/trace-convert
+
+	CC=$HOST_CXX $SH build.sh all		>>ghost-build.log 2>&1
+
+popd
+
+
+echo "Building 'profile-symbolize' tool"
+pushd tools/profile-symbolize
+
+	CC=$HOST_CXX $SH build.sh all		>>ghost-build.log 2>&1
+
+popd
+
+
 echo "Installing 'pkg-config' wrapper"
 pushd tools/pkg-config
 
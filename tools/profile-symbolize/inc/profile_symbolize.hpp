@@ -0,0 +1,167 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+#ifndef __GHOST_PROFILE_SYMBOLIZE__
+#define __GHOST_PROFILE_SYMBOLIZE__
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define VERSION_MAJOR	1
+#define	VERSION_MINOR	0
+
+/**
+ * Dump format, must match the definitions in libapi "ghost/profiler.h".
+ */
+#define PROFILE_DUMP_MAGIC				0x46525047
+#define PROFILE_DUMP_VERSION			1
+#define PROFILE_MAX_FRAMES				8
+#define PROFILE_MODULE_NAME_MAX			128
+
+#define PROFILE_SERIAL_HEADER_PREFIX	"gprofile-header:"
+#define PROFILE_SERIAL_MODULE_PREFIX	"gprofile-module:"
+#define PROFILE_SERIAL_SAMPLE_PREFIX	"gprofile:"
+
+/**
+ * Shared libraries are loaded from this directory within the system root.
+ */
+#define PROFILE_LIBRARY_DIRECTORY		"/system/lib/"
+
+struct profile_sample_t
+{
+	uint64_t timestamp;
+	int32_t task;
+	int32_t process;
+	uint16_t processor;
+	uint8_t kernel;
+	uint8_t depth;
+	uint32_t frames[PROFILE_MAX_FRAMES];
+} __attribute__((packed));
+
+struct profile_module_t
+{
+	int32_t process;
+	uint32_t start;
+	uint32_t end;
+	uint32_t base;
+	char name[PROFILE_MODULE_NAME_MAX];
+} __attribute__((packed));
+
+struct profile_dump_header_t
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t interval;
+	uint32_t ticksPerMicrosecond;
+	uint32_t moduleCount;
+	uint32_t sampleCount;
+} __attribute__((packed));
+
+/**
+ * Loaded profile, either from a binary dump or from a serial log.
+ */
+struct profile_t
+{
+	profile_dump_header_t header;
+	std::vector<profile_module_t> modules;
+	std::vector<profile_sample_t> samples;
+};
+
+bool profileLoadDump(const char* path, profile_t& profile);
+bool profileLoadSerialLog(const char* path, profile_t& profile);
+
+/**
+ * Builds the folded stack of a sample, counting the frames without a symbol.
+ */
+std::string profileSymbolizeSample(const profile_t& profile, const profile_sample_t& sample, uint32_t& unresolved);
+
+/**
+ * Minimal ELF32 structures, the host may not provide <elf.h>.
+ */
+struct elf32_header_t
+{
+	uint8_t ident[16];
+	uint16_t type;
+	uint16_t machine;
+	uint32_t version;
+	uint32_t entry;
+	uint32_t phoff;
+	uint32_t shoff;
+	uint32_t flags;
+	uint16_t ehsize;
+	uint16_t phentsize;
+	uint16_t phnum;
+	uint16_t shentsize;
+	uint16_t shnum;
+	uint16_t shstrndx;
+} __attribute__((packed));
+
+struct elf32_section_header_t
+{
+	uint32_t name;
+	uint32_t type;
+	uint32_t flags;
+	uint32_t addr;
+	uint32_t offset;
+	uint32_t size;
+	uint32_t link;
+	uint32_t info;
+	uint32_t addralign;
+	uint32_t entsize;
+} __attribute__((packed));
+
+struct elf32_symbol_t
+{
+	uint32_t name;
+	uint32_t value;
+	uint32_t size;
+	uint8_t info;
+	uint8_t other;
+	uint16_t shndx;
+} __attribute__((packed));
+
+#define ELF_SECTION_SYMTAB		2
+#define ELF_SECTION_DYNSYM		11
+#define ELF_SYMBOL_TYPE(info)	((info) & 0xF)
+#define ELF_SYMBOL_TYPE_FUNC	2
+
+/**
+ * Function symbols of an ELF file, sorted by address.
+ */
+class symbol_table_t
+{
+public:
+	bool loaded;
+	std::map<uint32_t, std::pair<uint32_t, std::string>> functions;
+
+	symbol_table_t() : loaded(false) {}
+
+	bool load(const std::string& path);
+
+	/**
+	 * Resolves an address within the file to the function containing it.
+	 */
+	bool lookup(uint32_t address, std::string& outName);
+};
+
+#endif
@@ -0,0 +1,360 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "../inc/profile_symbolize.hpp"
+
+#include <cxxabi.h>
+#include <fstream>
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+
+#define KERNEL_AREA_START	0xC0000000
+
+static std::string kernelPath;
+static std::string sysrootPath;
+static std::vector<std::string> libraryPaths;
+static std::map<std::string, symbol_table_t> symbolTables;
+
+void profileUsage(const char* program)
+{
+	std::cout << "profile-symbolize, v" << VERSION_MAJOR << "." << VERSION_MINOR << std::endl;
+	std::cout << "Symbolizes a profiler dump and writes folded stacks" << std::endl;
+	std::cout << std::endl;
+	std::cout << "usage:" << std::endl;
+	std::cout << "\t" << program << " [options] <dump file or serial log> [output]" << std::endl;
+	std::cout << std::endl;
+	std::cout << "options:" << std::endl;
+	std::cout << "\t-k <file>\tkernel ELF file" << std::endl;
+	std::cout << "\t-s <dir>\tsystem root, executables are looked up by their path within" << std::endl;
+	std::cout << "\t-l <dir>\tadditional directory to look up shared libraries in" << std::endl;
+	std::cout << std::endl;
+	std::cout << "The output is one line per distinct stack, outermost frame first, followed" << std::endl;
+	std::cout << "by the number of samples. It can be fed directly to flamegraph.pl." << std::endl;
+}
+
+/**
+ *
+ */
+int main(int argc, char** argv)
+{
+	const char* input = nullptr;
+	const char* output = nullptr;
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-k") == 0 && i + 1 < argc)
+			kernelPath = argv[++i];
+		else if(strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+			sysrootPath = argv[++i];
+		else if(strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+			libraryPaths.push_back(argv[++i]);
+		else if(!input)
+			input = argv[i];
+		else if(!output)
+			output = argv[i];
+		else
+			input = nullptr;
+	}
+	if(!input)
+	{
+		profileUsage(argv[0]);
+		return 1;
+	}
+
+	profile_t profile;
+	if(!profileLoadDump(input, profile) && !profileLoadSerialLog(input, profile))
+	{
+		std::cerr << "no profile found in " << input << std::endl;
+		return 1;
+	}
+
+	std::map<std::string, uint32_t> stacks;
+	uint32_t unresolved = 0;
+	for(auto& sample: profile.samples)
+	{
+		std::string stack = profileSymbolizeSample(profile, sample, unresolved);
+		stacks[stack]++;
+	}
+
+	std::ofstream file;
+	if(output)
+	{
+		file.open(output);
+		if(!file)
+		{
+			std::cerr << "failed to open " << output << std::endl;
+			return 1;
+		}
+	}
+	std::ostream& out = output ? file : std::cout;
+	for(auto& entry: stacks)
+		out << entry.first << " " << entry.second << std::endl;
+
+	std::cerr << "symbolized " << profile.samples.size() << " samples into " << stacks.size() << " stacks";
+	if(unresolved)
+		std::cerr << ", " << unresolved << " frames could not be resolved";
+	std::cerr << std::endl;
+	return 0;
+}
+
+bool profileLoadDump(const char* path, profile_t& profile)
+{
+	std::ifstream in(path, std::ios::binary);
+	if(!in.read((char*) &profile.header, sizeof(profile_dump_header_t)))
+		return false;
+	if(profile.header.magic != PROFILE_DUMP_MAGIC)
+		return false;
+	if(profile.header.version != PROFILE_DUMP_VERSION)
+	{
+		std::cerr << "unsupported dump version " << profile.header.version << std::endl;
+		return false;
+	}
+
+	profile.modules.resize(profile.header.moduleCount);
+	profile.samples.resize(profile.header.sampleCount);
+	if(!in.read((char*) profile.modules.data(), sizeof(profile_module_t) * profile.header.moduleCount) ||
+	   !in.read((char*) profile.samples.data(), sizeof(profile_sample_t) * profile.header.sampleCount))
+	{
+		std::cerr << "dump is truncated" << std::endl;
+		profile.samples.resize(in.gcount() / sizeof(profile_sample_t));
+	}
+	return true;
+}
+
+/**
+ * Decodes the hex string after the prefix in the line into the target.
+ */
+bool profileDecodeHex(const std::string& line, const char* prefix, void* target, size_t length)
+{
+	size_t start = line.find(prefix);
+	if(start == std::string::npos)
+		return false;
+	start += strlen(prefix);
+	if(line.size() < start + length * 2)
+		return false;
+
+	uint8_t* bytes = (uint8_t*) target;
+	for(size_t i = 0; i < length; i++)
+	{
+		std::string digits = line.substr(start + i * 2, 2);
+		bytes[i] = (uint8_t) strtoul(digits.c_str(), nullptr, 16);
+	}
+	return true;
+}
+
+bool profileLoadSerialLog(const char* path, profile_t& profile)
+{
+	std::ifstream in(path);
+	std::string line;
+	bool foundHeader = false;
+	while(std::getline(in, line))
+	{
+		if(profileDecodeHex(line, PROFILE_SERIAL_HEADER_PREFIX, &profile.header, sizeof(profile_dump_header_t)))
+		{
+			// A later dump in the same log replaces the earlier one
+			foundHeader = profile.header.magic == PROFILE_DUMP_MAGIC;
+			profile.modules.clear();
+			profile.samples.clear();
+			continue;
+		}
+		if(!foundHeader)
+			continue;
+
+		profile_module_t module;
+		profile_sample_t sample;
+		if(profileDecodeHex(line, PROFILE_SERIAL_MODULE_PREFIX, &module, sizeof(profile_module_t)))
+			profile.modules.push_back(module);
+		else if(profileDecodeHex(line, PROFILE_SERIAL_SAMPLE_PREFIX, &sample, sizeof(profile_sample_t)))
+			profile.samples.push_back(sample);
+	}
+	return foundHeader;
+}
+
+bool symbol_table_t::load(const std::string& path)
+{
+	std::ifstream in(path, std::ios::binary);
+	std::vector<char> content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	if(content.size() < sizeof(elf32_header_t))
+		return false;
+
+	elf32_header_t* header = (elf32_header_t*) content.data();
+	if(header->ident[0] != 0x7F || memcmp(header->ident + 1, "ELF", 3) != 0 || header->ident[4] != 1)
+	{
+		std::cerr << path << " is not an ELF32 file" << std::endl;
+		return false;
+	}
+	if(header->shoff + (uint64_t) header->shnum * sizeof(elf32_section_header_t) > content.size())
+		return false;
+
+	// Prefer the full symbol table, stripped files only have the dynamic one
+	elf32_section_header_t* sections = (elf32_section_header_t*) (content.data() + header->shoff);
+	elf32_section_header_t* symbols = nullptr;
+	for(uint16_t i = 0; i < header->shnum; i++)
+	{
+		if(sections[i].type == ELF_SECTION_SYMTAB || (sections[i].type == ELF_SECTION_DYNSYM && !symbols))
+			symbols = &sections[i];
+	}
+	if(!symbols || symbols->link >= header->shnum)
+		return false;
+
+	elf32_section_header_t* strings = &sections[symbols->link];
+	if(symbols->offset + symbols->size > content.size() || strings->offset + strings->size > content.size())
+		return false;
+
+	uint32_t count = symbols->size / sizeof(elf32_symbol_t);
+	elf32_symbol_t* entries = (elf32_symbol_t*) (content.data() + symbols->offset);
+	for(uint32_t i = 0; i < count; i++)
+	{
+		elf32_symbol_t& symbol = entries[i];
+		if(ELF_SYMBOL_TYPE(symbol.info) != ELF_SYMBOL_TYPE_FUNC || symbol.value == 0 || symbol.name >= strings->size)
+			continue;
+
+		std::string name(content.data() + strings->offset + symbol.name);
+		int status;
+		char* demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+		if(demangled)
+		{
+			name = demangled;
+			free(demangled);
+		}
+		functions[symbol.value] = std::make_pair((uint32_t) symbol.size, name);
+	}
+	loaded = true;
+	return true;
+}
+
+bool symbol_table_t::lookup(uint32_t address, std::string& outName)
+{
+	auto it = functions.upper_bound(address);
+	if(it == functions.begin())
+		return false;
+	--it;
+
+	uint32_t size = it->second.first;
+	if(size > 0 && address >= it->first + size)
+		return false;
+	outName = it->second.second;
+	return true;
+}
+
+/**
+ * Returns the symbols of a file, loading them on first use.
+ */
+symbol_table_t* profileGetSymbols(const std::string& path)
+{
+	auto it = symbolTables.find(path);
+	if(it != symbolTables.end())
+		return it->second.loaded ? &it->second : nullptr;
+
+	symbol_table_t& table = symbolTables[path];
+	if(!table.load(path))
+		std::cerr << "no symbols loaded from " << path << std::endl;
+	return table.loaded ? &table : nullptr;
+}
+
+/**
+ * Finds the host file of a module. The executable is named by its absolute
+ * path, libraries by their file name.
+ */
+std::string profileFindModuleFile(const profile_module_t& module)
+{
+	std::string name = module.name;
+	if(name[0] == '/')
+		return sysrootPath + name;
+
+	for(auto& directory: libraryPaths)
+	{
+		std::string candidate = directory + "/" + name;
+		if(std::ifstream(candidate))
+			return candidate;
+	}
+	return sysrootPath + PROFILE_LIBRARY_DIRECTORY + name;
+}
+
+std::string profileHex(uint32_t value)
+{
+	char buffer[16];
+	snprintf(buffer, sizeof(buffer), "0x%x", value);
+	return buffer;
+}
+
+std::string profileResolveFrame(const profile_t& profile, const profile_sample_t& sample, uint32_t address, uint32_t& unresolved)
+{
+	std::string name;
+	if(address >= KERNEL_AREA_START)
+	{
+		symbol_table_t* kernel = kernelPath.empty() ? nullptr : profileGetSymbols(kernelPath);
+		if(kernel && kernel->lookup(address, name))
+			return name + "_[k]";
+		unresolved++;
+		return profileHex(address) + "_[k]";
+	}
+
+	for(auto& module: profile.modules)
+	{
+		if(module.process != sample.process || address < module.start || address >= module.end)
+			continue;
+
+		symbol_table_t* symbols = profileGetSymbols(profileFindModuleFile(module));
+		if(symbols && symbols->lookup(address - module.base, name))
+			return name;
+
+		std::string file = module.name;
+		size_t slash = file.rfind('/');
+		unresolved++;
+		return (slash == std::string::npos ? file : file.substr(slash + 1)) + "+" + profileHex(address - module.base);
+	}
+
+	unresolved++;
+	return profileHex(address);
+}
+
+/**
+ * Names the process of a sample after its executable.
+ */
+std::string profileProcessName(const profile_t& profile, const profile_sample_t& sample)
+{
+	for(auto& module: profile.modules)
+	{
+		if(module.process == sample.process && module.name[0] == '/')
+		{
+			std::string file = module.name;
+			return file.substr(file.rfind('/') + 1);
+		}
+	}
+	return "process-" + std::to_string(sample.process);
+}
+
+std::string profileSymbolizeSample(const profile_t& profile, const profile_sample_t& sample, uint32_t& unresolved)
+{
+	std::string stack = profileProcessName(profile, sample);
+
+	// Frames are stored innermost first, folded stacks start with the outermost
+	uint8_t depth = sample.depth <= PROFILE_MAX_FRAMES ? sample.depth : PROFILE_MAX_FRAMES;
+	for(int i = depth - 1; i >= 0; i--)
+	{
+		// Return addresses point behind the call, which may already be the next function
+		uint32_t address = sample.frames[i];
+		if(i > 0)
+			address--;
+		stack += ";" + profileResolveFrame(profile, sample, address, unresolved);
+	}
+	return stack;
+}
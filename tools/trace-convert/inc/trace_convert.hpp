@@ -0,0 +1,87 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GHOST_TRACE_CONVERT__
+#define __GHOST_TRACE_CONVERT__
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define VERSION_MAJOR	1
+#define	VERSION_MINOR	0
+
+/**
+ * Dump format, must match the definitions in libapi "ghost/trace.h".
+ */
+#define TRACE_DUMP_MAGIC				0x43525447
+#define TRACE_DUMP_VERSION				1
+
+#define TRACE_EVENT_SWITCH				1
+#define TRACE_EVENT_SYSCALL_ENTER		2
+#define TRACE_EVENT_SYSCALL_EXIT		3
+#define TRACE_EVENT_IRQ_ENTER			4
+#define TRACE_EVENT_IRQ_EXIT			5
+#define TRACE_EVENT_PAGE_FAULT			6
+#define TRACE_EVENT_MESSAGE_SEND		7
+#define TRACE_EVENT_MESSAGE_RECEIVE		8
+#define TRACE_EVENT_WAKE				9
+#define TRACE_EVENT_MEMORY_MAP			10
+
+#define TRACE_SERIAL_HEADER_PREFIX		"gtrace-header:"
+#define TRACE_SERIAL_EVENT_PREFIX		"gtrace:"
+
+struct trace_event_t
+{
+	uint64_t timestamp;
+	int32_t task;
+	uint16_t type;
+	uint16_t processor;
+	uint32_t arg1;
+	uint32_t arg2;
+} __attribute__((packed));
+
+struct trace_dump_header_t
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t ticksPerMicrosecond;
+	uint32_t eventCount;
+} __attribute__((packed));
+
+/**
+ * Loaded trace, either from a binary dump or from a serial log.
+ */
+struct trace_t
+{
+	trace_dump_header_t header;
+	std::vector<trace_event_t> events;
+};
+
+bool traceLoadDump(const char* path, trace_t& trace);
+bool traceLoadSerialLog(const char* path, trace_t& trace);
+
+/**
+ * Writes the trace in the Chrome trace event format, which can be opened
+ * in chrome://tracing and in the Perfetto UI.
+ */
+void traceWriteChromeJson(trace_t& trace, std::ostream& out);
+
+#endif
@@ -0,0 +1,306 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "../inc/trace_convert.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string.h>
+
+#define TRACK_RUNNING	-1
+#define TRACK_IRQ		-2
+
+/**
+ *
+ */
+int main(int argc, char** argv)
+{
+	if(argc != 3)
+	{
+		std::cout << "trace-convert, v" << VERSION_MAJOR << "." << VERSION_MINOR << std::endl;
+		std::cout << "Converts a kernel trace to a Chrome/Perfetto JSON timeline" << std::endl;
+		std::cout << std::endl;
+		std::cout << "usage:" << std::endl;
+		std::cout << "\t" << argv[0] << " <dump file or serial log> <output.json>" << std::endl;
+		return 1;
+	}
+
+	trace_t trace;
+	if(!traceLoadDump(argv[1], trace) && !traceLoadSerialLog(argv[1], trace))
+	{
+		std::cerr << "no trace found in " << argv[1] << std::endl;
+		return 1;
+	}
+	if(trace.header.ticksPerMicrosecond == 0)
+		trace.header.ticksPerMicrosecond = 1;
+
+	std::ofstream out(argv[2]);
+	if(!out)
+	{
+		std::cerr << "failed to open " << argv[2] << std::endl;
+		return 1;
+	}
+	traceWriteChromeJson(trace, out);
+
+	std::cout << "converted " << trace.events.size() << " events" << std::endl;
+	return 0;
+}
+
+bool traceLoadDump(const char* path, trace_t& trace)
+{
+	std::ifstream in(path, std::ios::binary);
+	if(!in.read((char*) &trace.header, sizeof(trace_dump_header_t)))
+		return false;
+	if(trace.header.magic != TRACE_DUMP_MAGIC)
+		return false;
+	if(trace.header.version != TRACE_DUMP_VERSION)
+	{
+		std::cerr << "unsupported dump version " << trace.header.version << std::endl;
+		return false;
+	}
+
+	trace.events.resize(trace.header.eventCount);
+	if(!in.read((char*) trace.events.data(), sizeof(trace_event_t) * trace.header.eventCount))
+	{
+		std::cerr << "dump is truncated" << std::endl;
+		trace.events.resize(in.gcount() / sizeof(trace_event_t));
+	}
+	return true;
+}
+
+/**
+ * Decodes the hex string after the prefix in the line into the target.
+ */
+bool traceDecodeHex(const std::string& line, const char* prefix, void* target, size_t length)
+{
+	size_t start = line.find(prefix);
+	if(start == std::string::npos)
+		return false;
+	start += strlen(prefix);
+	if(line.size() < start + length * 2)
+		return false;
+
+	uint8_t* bytes = (uint8_t*) target;
+	for(size_t i = 0; i < length; i++)
+	{
+		std::string digits = line.substr(start + i * 2, 2);
+		bytes[i] = (uint8_t) strtoul(digits.c_str(), nullptr, 16);
+	}
+	return true;
+}
+
+bool traceLoadSerialLog(const char* path, trace_t& trace)
+{
+	std::ifstream in(path);
+	std::string line;
+	bool foundHeader = false;
+	while(std::getline(in, line))
+	{
+		if(traceDecodeHex(line, TRACE_SERIAL_HEADER_PREFIX, &trace.header, sizeof(trace_dump_header_t)))
+		{
+			// A later dump in the same log replaces the earlier one
+			foundHeader = trace.header.magic == TRACE_DUMP_MAGIC;
+			trace.events.clear();
+			continue;
+		}
+
+		trace_event_t event;
+		if(foundHeader && traceDecodeHex(line, TRACE_SERIAL_EVENT_PREFIX, &event, sizeof(trace_event_t)))
+			trace.events.push_back(event);
+	}
+	return foundHeader;
+}
+
+class chrome_writer_t
+{
+private:
+	std::ostream& out;
+	uint64_t base;
+	uint32_t ticksPerMicrosecond;
+	bool first;
+
+public:
+	chrome_writer_t(std::ostream& out, uint64_t base, uint32_t ticksPerMicrosecond) :
+			out(out), base(base), ticksPerMicrosecond(ticksPerMicrosecond), first(true)
+	{
+	}
+
+	double micros(uint64_t timestamp)
+	{
+		return (double) (timestamp - base) / ticksPerMicrosecond;
+	}
+
+	std::ostream& begin()
+	{
+		if(!first)
+			out << "," << std::endl;
+		first = false;
+		return out;
+	}
+
+	void metadata(const char* kind, int pid, int tid, const std::string& name)
+	{
+		begin() << "{\"name\":\"" << kind << "\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << tid
+				<< ",\"args\":{\"name\":\"" << name << "\"}}";
+	}
+
+	void complete(const std::string& name, const char* category, int pid, int tid, uint64_t start, uint64_t end, const std::string& args)
+	{
+		begin() << "{\"name\":\"" << name << "\",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << tid
+				<< ",\"ts\":" << micros(start) << ",\"dur\":" << (micros(end) - micros(start)) << ",\"args\":{" << args << "}}";
+	}
+
+	void instant(const std::string& name, const char* category, int pid, int tid, uint64_t timestamp, const std::string& args)
+	{
+		begin() << "{\"name\":\"" << name << "\",\"cat\":\"" << category << "\",\"ph\":\"i\",\"s\":\"t\",\"pid\":" << pid << ",\"tid\":" << tid
+				<< ",\"ts\":" << micros(timestamp) << ",\"args\":{" << args << "}}";
+	}
+};
+
+struct open_slice_t
+{
+	uint64_t start;
+	uint32_t id;
+	int processor;
+};
+
+std::string traceHex(uint32_t value)
+{
+	std::stringstream s;
+	s << "\"0x" << std::hex << value << "\"";
+	return s.str();
+}
+
+void traceWriteChromeJson(trace_t& trace, std::ostream& out)
+{
+	std::stable_sort(trace.events.begin(), trace.events.end(), [](const trace_event_t& a, const trace_event_t& b) {
+		return a.timestamp < b.timestamp;
+	});
+
+	uint64_t base = trace.events.empty() ? 0 : trace.events.front().timestamp;
+	uint64_t last = trace.events.empty() ? 0 : trace.events.back().timestamp;
+	chrome_writer_t writer(out, base, trace.header.ticksPerMicrosecond);
+
+	out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" << std::endl;
+
+	std::set<int> processors;
+	std::set<std::pair<int, int>> tasks;
+	std::map<int, open_slice_t> running;
+	std::map<int, std::vector<open_slice_t>> syscalls;
+	std::map<int, std::vector<open_slice_t>> irqs;
+
+	for(const trace_event_t& event : trace.events)
+	{
+		int cpu = event.processor;
+		processors.insert(cpu);
+		if(event.task >= 0)
+			tasks.insert(std::make_pair(cpu, event.task));
+
+		std::stringstream args;
+		switch(event.type)
+		{
+		case TRACE_EVENT_SWITCH:
+		{
+			auto previous = running.find(cpu);
+			if(previous != running.end())
+			{
+				writer.complete("task " + std::to_string(previous->second.id), "sched", cpu, TRACK_RUNNING, previous->second.start, event.timestamp, "");
+				running.erase(previous);
+			}
+			running[cpu] = {event.timestamp, event.arg2, cpu};
+			break;
+		}
+		case TRACE_EVENT_SYSCALL_ENTER:
+			syscalls[event.task].push_back({event.timestamp, event.arg1, cpu});
+			break;
+		case TRACE_EVENT_SYSCALL_EXIT:
+		{
+			auto& stack = syscalls[event.task];
+			if(!stack.empty() && stack.back().id == event.arg1)
+			{
+				open_slice_t slice = stack.back();
+				stack.pop_back();
+				args << "\"call\":" << slice.id;
+				writer.complete("syscall " + std::to_string(slice.id), "syscall", slice.processor, event.task, slice.start, event.timestamp, args.str());
+			}
+			break;
+		}
+		case TRACE_EVENT_IRQ_ENTER:
+			irqs[cpu].push_back({event.timestamp, event.arg1, cpu});
+			break;
+		case TRACE_EVENT_IRQ_EXIT:
+		{
+			auto& stack = irqs[cpu];
+			if(!stack.empty() && stack.back().id == event.arg1)
+			{
+				open_slice_t slice = stack.back();
+				stack.pop_back();
+				args << "\"task\":" << event.task;
+				writer.complete("irq " + std::to_string(slice.id), "irq", cpu, TRACK_IRQ, slice.start, event.timestamp, args.str());
+			}
+			break;
+		}
+		case TRACE_EVENT_PAGE_FAULT:
+			args << "\"address\":" << traceHex(event.arg1) << ",\"eip\":" << traceHex(event.arg2);
+			writer.instant("page fault", "memory", cpu, event.task, event.timestamp, args.str());
+			break;
+		case TRACE_EVENT_MEMORY_MAP:
+			args << "\"address\":" << traceHex(event.arg1) << ",\"pages\":" << event.arg2;
+			writer.instant("memory map", "memory", cpu, event.task, event.timestamp, args.str());
+			break;
+		case TRACE_EVENT_MESSAGE_SEND:
+			args << "\"receiver\":" << (int32_t) event.arg1 << ",\"length\":" << event.arg2;
+			writer.instant("message send", "ipc", cpu, event.task, event.timestamp, args.str());
+			break;
+		case TRACE_EVENT_MESSAGE_RECEIVE:
+			args << "\"sender\":" << (int32_t) event.arg1 << ",\"length\":" << event.arg2;
+			writer.instant("message receive", "ipc", cpu, event.task, event.timestamp, args.str());
+			break;
+		case TRACE_EVENT_WAKE:
+			args << "\"task\":" << (int32_t) event.arg1;
+			writer.instant("wake", "sched", cpu, event.task, event.timestamp, args.str());
+			break;
+		default:
+			args << "\"type\":" << event.type << ",\"arg1\":" << event.arg1 << ",\"arg2\":" << event.arg2;
+			writer.instant("unknown", "unknown", cpu, event.task, event.timestamp, args.str());
+			break;
+		}
+	}
+
+	// Close the tasks that were still running at the end of the trace
+	for(auto& entry : running)
+		writer.complete("task " + std::to_string(entry.second.id), "sched", entry.first, TRACK_RUNNING, entry.second.start, last, "");
+
+	for(int cpu : processors)
+	{
+		writer.metadata("process_name", cpu, 0, "CPU " + std::to_string(cpu));
+		writer.metadata("thread_name", cpu, TRACK_RUNNING, "running");
+		writer.metadata("thread_name", cpu, TRACK_IRQ, "interrupts");
+	}
+	for(auto& task : tasks)
+		writer.metadata("thread_name", task.first, task.second, "task " + std::to_string(task.second));
+
+	out << std::endl
+		<< "]}" << std::endl;
+}